@@ -3323,6 +3323,10 @@ EidosValue_SP Chromosome::ExecuteMethod_setAncestralNucleotides(EidosGlobalStrin
 			{
 				// A singleton string has been provided that contains characters other than ACGT; we will interpret it as a filesystem path for a FASTA file
 				std::string file_path = Eidos_ResolvedPath(sequence_string);
+				
+				// the file might be pending an asynchronous write, which needs to complete first
+				Eidos_WaitForAsyncFileWrites();
+				
 				std::ifstream file_stream(file_path.c_str());
 				
 				if (!file_stream.is_open())
@@ -940,6 +940,11 @@ void Community::OptimizeScriptBlock(SLiMEidosBlock *p_script_block)
 //				std::cout << "NOT OPTIMIZED:" << std::endl << "   " << base_node->token_->token_string_ << std::endl;
 		}
 	}
+	
+	// Callbacks that were not special-cased above, and that do not just return a constant, may be simple enough to compile to
+	// bytecode, which is much faster to run than interpreting the body; see eidos_bytecode.h for what the compiler handles
+	if (!p_script_block->has_cached_optimization_ && p_script_block->compound_statement_node_ && !p_script_block->compound_statement_node_->cached_return_value_)
+		p_script_block->CompileBytecode();
 }
 
 void Community::AddScriptBlock(SLiMEidosBlock *p_script_block, EidosInterpreter *p_interpreter, const EidosToken *p_error_token)
@@ -3428,6 +3433,9 @@ void Community::TabulateSLiMMemoryUsage_Community(SLiMMemoryUsage_Community *p_u
 	p_usage->eidosSymbolTablePool = MemoryUsageForSymbolTables(p_current_symbols);
 	p_usage->eidosValuePool = gEidosValuePool->MemoryUsageForAllNodes();
 	
+	// the zip append buffers are in use by the asynchronous file writer thread while it has work queued
+	Eidos_WaitForAsyncFileWrites();
+	
 	for (auto const &filebuf_pair : gEidosBufferedZipAppendData)
 		p_usage->fileBuffers += filebuf_pair.second.capacity();
 	
@@ -3611,6 +3619,14 @@ void Community::AllSpecies_TSF_Enable(void)
 		SLIM_ERRSTREAM << "// ********** Turning on tree-sequence recording without crosschecks (-TSF)." << std::endl << std::endl;
 }
 
+void Community::AllSpecies_PrepareForFork(void)
+{
+	// This is called by command-line slim just before it forks branches for the -fork option.  Anything tied to the process
+	// identity of the parent needs to be brought into memory here, so that each branch inherits its own copy.
+	for (Species *species : all_species_)
+		species->RestoreAllSpilledTreeSeqEdges();
+}
+
 
 
 
@@ -217,6 +217,20 @@ public:
 	std::vector<SLiMEidosBlock*> &AllScriptBlocks();
 	std::vector<SLiMEidosBlock*> AllScriptBlocksForSpecies(Species *p_species);
 	void OptimizeScriptBlock(SLiMEidosBlock *p_script_block);
+	
+	// Run the compiled bytecode for a callback block, if it has any and compiled execution is enabled; returns false if the
+	// block needs to be interpreted instead.  Arguments must be in the order given by SLiMEidosBlock::BytecodeParametersForType().
+	inline bool ExecuteBlockBytecode(SLiMEidosBlock *p_script_block, std::initializer_list<EidosBytecodeValue> p_arguments, EidosBytecodeValue *p_result)
+	{
+		if (!p_script_block->bytecode_ || !p_script_block->bytecode_enabled_)
+			return false;
+#ifdef SLIMGUI
+		// debug points in the block's body are reported by the interpreter, so while any are set we always interpret
+		if (debug_points_ && debug_points_->set.size())
+			return false;
+#endif
+		return p_script_block->bytecode_->Execute(p_arguments.begin(), *simulation_constants_, p_script_block->script_, p_result);
+	}
 	void AddScriptBlock(SLiMEidosBlock *p_script_block, EidosInterpreter *p_interpreter, const EidosToken *p_error_token);
 	void DeregisterScheduledScriptBlocks(void);
 	void DeregisterScheduledInteractionBlocks(void);
@@ -331,6 +345,7 @@ public:
 	
 	void AllSpecies_TSXC_Enable(void);          // forces tree-seq with crosschecks on for all species; called by the undocumented -TSXC option
 	void AllSpecies_TSF_Enable(void);           // forces tree-seq without crosschecks on for all species; called by the undocumented -TSF option
+	void AllSpecies_PrepareForFork(void);      // gets per-process state, such as tree-seq edge spill files, ready for the -fork option
 	
 	slim_tick_t tree_seq_tick_ = 0;				// the tick for the tree sequence code, incremented after generating offspring
 												// this is needed since addSubpop() in an early() event makes one gen, and then the offspring
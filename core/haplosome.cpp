@@ -3195,12 +3195,18 @@ EidosValue_SP Haplosome_Class::ExecuteMethod_outputX(EidosGlobalStringID p_metho
 		// Otherwise, output to filePath
 		std::string outfile_path = Eidos_ResolvedPath(filePath_value->StringAtIndex_NOCAST(0, nullptr));
 		bool append = append_value->LogicalAtIndex_NOCAST(0, nullptr);
+		bool async_file = Eidos_AsyncFileWritingEnabled();
 		std::ofstream outfile;
+		std::ostringstream outbuffer;
 		
-		outfile.open(outfile_path.c_str(), append ? (std::ios_base::app | std::ios_base::out) : std::ios_base::out);
+		// with asynchronous file writing, we format the output in memory and then hand it off to the writer thread
+		if (!async_file)
+			outfile.open(outfile_path.c_str(), append ? (std::ios_base::app | std::ios_base::out) : std::ios_base::out);
 		
-		if (outfile.is_open())
+		if (async_file || outfile.is_open())
 		{
+			std::ostream &out = (async_file ? (std::ostream &)outbuffer : (std::ostream &)outfile);
+			
 			switch (p_method_id)
 			{
 				case gID_outputHaplosomes:
@@ -3209,29 +3215,32 @@ EidosValue_SP Haplosome_Class::ExecuteMethod_outputX(EidosGlobalStringID p_metho
 					// BCH 2/2/2025: added the chromosome symbol in the header; it is redundant for SLiM-format output,
 					// but useful for MS and VCF; I decided to put it in all three for consistency across formats
 					// BCH 2/7/2025: changed GS/GM/GV to HS/HM/HV, for the genome -> haplosome transition
-					outfile << "#OUT: " << community.Tick() << " " << species->Cycle() << " HS " << sample_size;
+					out << "#OUT: " << community.Tick() << " " << species->Cycle() << " HS " << sample_size;
 					
 					if (chromosomes.size() > 1)
 					{
-						outfile << " " << chromosome->Type();						// chromosome type, with >1 chromosome
-						outfile << " \"" << chromosome->Symbol() << "\"";			// chromosome symbol, with >1 chromosome
+						out << " " << chromosome->Type();						// chromosome type, with >1 chromosome
+						out << " \"" << chromosome->Symbol() << "\"";			// chromosome symbol, with >1 chromosome
 					}
 					
-					outfile << " " << outfile_path << std::endl;
+					out << " " << outfile_path << std::endl;
 					
-					Haplosome::PrintHaplosomes_SLiM(outfile, haplosomes, output_object_tags);
+					Haplosome::PrintHaplosomes_SLiM(out, haplosomes, output_object_tags);
 					break;
 				case gID_outputHaplosomesToMS:
-					Haplosome::PrintHaplosomes_MS(outfile, haplosomes, *chromosome, filter_monomorphic);
+					Haplosome::PrintHaplosomes_MS(out, haplosomes, *chromosome, filter_monomorphic);
 					break;
 				case gID_outputHaplosomesToVCF:
-					Haplosome::PrintHaplosomes_VCF(outfile, haplosomes, *chromosome, group_as_individuals, output_multiallelics, simplify_nucs, output_nonnucs);
+					Haplosome::PrintHaplosomes_VCF(out, haplosomes, *chromosome, group_as_individuals, output_multiallelics, simplify_nucs, output_nonnucs);
 					break;
 				default:
 					EIDOS_TERMINATION << "ERROR (Haplosome_Class::ExecuteMethod_outputX): (internal error) unhandled case." << EidosTerminate();
 			}
 			
-			outfile.close(); 
+			if (async_file)
+				Eidos_WriteDataToFile(outfile_path, outbuffer.str(), append, false);
+			else
+				outfile.close(); 
 		}
 		else
 		{
@@ -3256,6 +3265,9 @@ EidosValue_SP Haplosome_Class::ExecuteMethod_readHaplosomesFromMS(EidosGlobalStr
 	std::string file_path = Eidos_ResolvedPath(Eidos_StripTrailingSlash(filePath_value->StringAtIndex_NOCAST(0, nullptr)));
 	MutationType *mutation_type_ptr = nullptr;
 	
+	// the file might be pending an asynchronous write, which needs to complete first
+	Eidos_WaitForAsyncFileWrites();
+	
 	if (mutationType_value->Type() != EidosValueType::kValueNULL)
 		mutation_type_ptr = SLiM_ExtractMutationTypeFromEidosValue_io(mutationType_value, 0, &community, nullptr, "ExecuteMethod_readHaplosomesFromMS()");	// this dictates the focal species
 	
@@ -3560,6 +3572,9 @@ EidosValue_SP Haplosome_Class::ExecuteMethod_readHaplosomesFromVCF(EidosGlobalSt
 	std::string file_path = Eidos_ResolvedPath(Eidos_StripTrailingSlash(filePath_value->StringAtIndex_NOCAST(0, nullptr)));
 	MutationType *default_mutation_type_ptr = nullptr;
 	
+	// the file might be pending an asynchronous write, which needs to complete first
+	Eidos_WaitForAsyncFileWrites();
+	
 	if (mutationType_value->Type() != EidosValueType::kValueNULL)
 		default_mutation_type_ptr = SLiM_ExtractMutationTypeFromEidosValue_io(mutationType_value, 0, &community, species, "readHaplosomesFromVCF()");			// SPECIES CONSISTENCY CHECK
 	
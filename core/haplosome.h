@@ -183,6 +183,7 @@ public:
 	inline __attribute__((always_inline)) Individual *OwningIndividual(void)				{ return individual_; }
 	inline __attribute__((always_inline)) const Individual *OwningIndividual(void) const 	{ return individual_; }
 	Chromosome *AssociatedChromosome(void) const;
+	inline __attribute__((always_inline)) slim_chromosome_index_t AssociatedChromosomeIndex(void) const	{ return chromosome_index_; }
 	inline __attribute__((always_inline)) slim_position_t MutrunLength(void) const			{ return mutrun_length_; }
 	
 	void NullHaplosomeAccessError(void) const __attribute__((__noreturn__)) __attribute__((cold)) __attribute__((analyzer_noreturn));		// prints an error message, a stacktrace, and exits; called only for DEBUG
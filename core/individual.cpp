@@ -131,6 +131,8 @@ Individual::~Individual(void)
 	if (haplosomes_ != hapbuffer_)
 		free(haplosomes_);
 	
+	free(mutational_fitness_stamps_);
+	
 #if DEBUG
 	haplosomes_ = nullptr;
 #endif
@@ -4045,15 +4047,24 @@ EidosValue_SP Individual_Class::ExecuteMethod_outputIndividuals(EidosGlobalStrin
 	{
 		std::string outfile_path = Eidos_ResolvedPath(filePath_value->StringAtIndex_NOCAST(0, nullptr));
 		bool append = append_value->LogicalAtIndex_NOCAST(0, nullptr);
+		bool async_file = Eidos_AsyncFileWritingEnabled();
 		std::ofstream outfile;
+		std::ostringstream outbuffer;
 		
-		outfile.open(outfile_path.c_str(), append ? (std::ios_base::app | std::ios_base::out) : std::ios_base::out);
+		// with asynchronous file writing, we format the output in memory and then hand it off to the writer thread
+		if (!async_file)
+			outfile.open(outfile_path.c_str(), append ? (std::ios_base::app | std::ios_base::out) : std::ios_base::out);
 		
-		if (outfile.is_open())
+		if (async_file || outfile.is_open())
 		{
-			Individual::PrintIndividuals_SLiM(outfile, individuals_buffer, individuals_count, *species, output_spatial_positions, output_ages, output_ancestral_nucs, output_pedigree_ids, output_object_tags, /* p_output_substitutions */ false, chromosome);
+			std::ostream &out = (async_file ? (std::ostream &)outbuffer : (std::ostream &)outfile);
+			
+			Individual::PrintIndividuals_SLiM(out, individuals_buffer, individuals_count, *species, output_spatial_positions, output_ages, output_ancestral_nucs, output_pedigree_ids, output_object_tags, /* p_output_substitutions */ false, chromosome);
 			
-			outfile.close(); 
+			if (async_file)
+				Eidos_WriteDataToFile(outfile_path, outbuffer.str(), append, false);
+			else
+				outfile.close(); 
 		}
 		else
 		{
@@ -4131,15 +4142,24 @@ EidosValue_SP Individual_Class::ExecuteMethod_outputIndividualsToVCF(EidosGlobal
 	{
 		std::string outfile_path = Eidos_ResolvedPath(filePath_value->StringAtIndex_NOCAST(0, nullptr));
 		bool append = append_value->LogicalAtIndex_NOCAST(0, nullptr);
+		bool async_file = Eidos_AsyncFileWritingEnabled();
 		std::ofstream outfile;
+		std::ostringstream outbuffer;
 		
-		outfile.open(outfile_path.c_str(), append ? (std::ios_base::app | std::ios_base::out) : std::ios_base::out);
+		// with asynchronous file writing, we format the output in memory and then hand it off to the writer thread
+		if (!async_file)
+			outfile.open(outfile_path.c_str(), append ? (std::ios_base::app | std::ios_base::out) : std::ios_base::out);
 		
-		if (outfile.is_open())
+		if (async_file || outfile.is_open())
 		{
-			Individual::PrintIndividuals_VCF(outfile, individuals_buffer, individuals_count, *species, output_multiallelics, simplify_nucs, output_nonnucs, chromosome);
+			std::ostream &out = (async_file ? (std::ostream &)outbuffer : (std::ostream &)outfile);
 			
-			outfile.close(); 
+			Individual::PrintIndividuals_VCF(out, individuals_buffer, individuals_count, *species, output_multiallelics, simplify_nucs, output_nonnucs, chromosome);
+			
+			if (async_file)
+				Eidos_WriteDataToFile(outfile_path, outbuffer.str(), append, false);
+			else
+				outfile.close(); 
 		}
 		else
 		{
@@ -4222,6 +4242,9 @@ EidosValue_SP Individual_Class::ExecuteMethod_readIndividualsFromVCF(EidosGlobal
 	bool has_initial_mutations = (gSLiM_next_mutation_id != 0);
 	MutationType *default_mutation_type_ptr = nullptr;
 	
+	// the file might be pending an asynchronous write, which needs to complete first
+	Eidos_WaitForAsyncFileWrites();
+	
 	if (mutationType_value->Type() != EidosValueType::kValueNULL)
 		default_mutation_type_ptr = SLiM_ExtractMutationTypeFromEidosValue_io(mutationType_value, 0, &community, species, "readIndividualsFromVCF()");			// SPECIES CONSISTENCY CHECK
 	
@@ -143,6 +143,16 @@ public:
 										// that confuses interpretation; note that individual_cached_fitness_OVERRIDE_ is not relevant to this
 #endif
 	
+	// Incremental fitness evaluation in nonWF models; see Subpopulation::FitnessOfParent_Incremental().  The mutational component of
+	// fitness last computed for this individual is kept along with the stamps of the mutation runs it was computed from (0 for a null
+	// haplosome), and the species' fitness_effect_change_counter_ at that time; it is reused while all of those are unchanged.  The
+	// stamp buffer is kept when the individual goes into the junkyard, so that recycled individuals do not need to reallocate it.
+	double cached_mutational_fitness_;
+	int32_t mutational_fitness_change_counter_;
+	int32_t mutational_fitness_stamp_count_ = 0;		// the number of stamps in mutational_fitness_stamps_; 0 if nothing is cached
+	int32_t mutational_fitness_stamp_capacity_ = 0;
+	int64_t *mutational_fitness_stamps_ = nullptr;		// OWNED POINTER: the mutation run stamps for cached_mutational_fitness_
+	
 	Haplosome *hapbuffer_[2];			// *(hapbuffer_[2]), an internal buffer used to avoid allocation and increase memory nonlocality
 	Haplosome **haplosomes_;			// OWNED haplosomes; can point to hapbuffer_ or to an external malloced block
 	slim_age_t age_;					// nonWF only: the age of the individual, in cycles; -1 in WF models
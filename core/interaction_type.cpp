@@ -110,6 +110,8 @@ InteractionType::InteractionType(Community &p_community, slim_objectid_t p_inter
 	if ((required_dimensionality_ == 0) && (!std::isinf(max_distance_) || (max_distance_ < 0.0)))
 		EIDOS_TERMINATION << "ERROR (InteractionType::InteractionType): initializeInteractionType() maxDistance must be INF for non-spatial interactions." << EidosTerminate();
 	
+	ChooseSpatialIndexType();
+	
 	// sex-segregation can be configured here, for historical reasons; see setConstraints() for all other constraint setting
 	if ((p_receiver_sex != IndividualSex::kUnspecified) || (p_exerter_sex != IndividualSex::kUnspecified))
 	{
@@ -217,11 +219,14 @@ void InteractionType::EvaluateSubpopulation(Subpopulation *p_subpop)
 		subpop_data->kd_root_EXERTERS_ = nullptr;
 		subpop_data->kd_node_count_EXERTERS_ = 0;
 		
+		subpop_data->cell_grid_ALL_.Free();
+		subpop_data->cell_grid_EXERTERS_.Free();
+		
 		// Free the interaction() callbacks that were cached
 		subpop_data->evaluation_interaction_callbacks_.resize(0);
 	}
 	
-	// At this point, positions_ is guaranteed to be nullptr, as are the k-d tree buffers.
+	// At this point, positions_ is guaranteed to be nullptr, as are the k-d tree and cell grid buffers.
 	// Now we mark ourselves evaluated and fill in buffers as needed.
 	subpop_data->evaluated_ = true;
 	
@@ -612,6 +617,9 @@ void InteractionType::_InvalidateData(InteractionsData &data)
 	data.kd_root_EXERTERS_ = nullptr;
 	data.kd_node_count_EXERTERS_ = 0;
 	
+	data.cell_grid_ALL_.Free();
+	data.cell_grid_EXERTERS_.Free();
+	
 	data.evaluation_interaction_callbacks_.resize(0);
 }
 
@@ -1314,6 +1322,7 @@ double InteractionType::ApplyInteractionCallbacks(Individual *p_receiver, Indivi
 			
 			// The callback is active and matches our interaction type id, so we need to execute it
 			const EidosASTNode *compound_statement_node = interaction_callback->compound_statement_node_;
+			EidosBytecodeValue bytecode_result;
 			
 			if (compound_statement_node->cached_return_value_)
 			{
@@ -1334,6 +1343,17 @@ double InteractionType::ApplyInteractionCallbacks(Individual *p_receiver, Indivi
 				// the cached value is owned by the tree, so we do not dispose of it
 				// there is also no script output to handle
 			}
+			else if (community_.ExecuteBlockBytecode(interaction_callback, {EidosBytecodeValue::Object(interaction_callback), EidosBytecodeValue::Float(p_distance), EidosBytecodeValue::Float(p_strength), EidosBytecodeValue::Object(p_receiver), EidosBytecodeValue::Object(p_exerter)}, &bytecode_result))
+			{
+				// The callback body was compiled to bytecode, and ran without needing to fall back to the interpreter
+				if (bytecode_result.type_ != EidosBytecodeValueType::kFloat)
+					EIDOS_TERMINATION << "ERROR (InteractionType::ApplyInteractionCallbacks): interaction() callbacks must provide a float singleton return value." << EidosTerminate(interaction_callback->identifier_token_);
+				
+				p_strength = bytecode_result.float_;
+				
+				if (std::isnan(p_strength) || std::isinf(p_strength) || (p_strength < 0.0))
+					EIDOS_TERMINATION << "ERROR (InteractionType::ApplyInteractionCallbacks): interaction() callbacks must return a finite value >= 0.0." << EidosTerminate(interaction_callback->identifier_token_);
+			}
 			else
 			{
 				// local variables for the callback parameters that we might need to allocate here, and thus need to free below
@@ -1417,6 +1437,16 @@ size_t InteractionType::MemoryUsageForKDTrees(void)
 		const InteractionsData &data = iter.second;
 		usage += sizeof(SLiM_kdNode) * data.kd_node_count_ALL_;
 		usage += sizeof(SLiM_kdNode) * data.kd_node_count_EXERTERS_;
+		
+		// cell grids are counted here too, since they take the place of k-d trees
+		for (const SLiM_CellGrid *grid : {&data.cell_grid_ALL_, &data.cell_grid_EXERTERS_})
+		{
+			if (grid->built_)
+			{
+				usage += sizeof(SLiM_gridPoint) * grid->point_count_;
+				usage += sizeof(uint32_t) * ((size_t)grid->cell_count_[0] * grid->cell_count_[1] * grid->cell_count_[2] + 1);
+			}
+		}
 	}
 	
 	return usage;
@@ -1466,152 +1496,137 @@ size_t InteractionType::MemoryUsageForSparseVectorPool(void)
 #pragma mark k-d tree construction
 #pragma mark -
 
-// This k-d tree code is patterned after the C code at RosettaCode.org : https://rosettacode.org/wiki/K-d_tree#C
-// It uses a Quickselect-style algorithm to select medians to produce a balanced tree
-// Each spatiality case is coded separately, for maximum speed, but they are very parallel
-
-// Some of the code below is separated by phase.  The k-d tree cycles through phase (x, y, z) as you descend,
-// and rather than passing phase as a parameter, the code has been factored into phase-specific functions
-// that are mutually recursive, for speed.  It's not a huge win, but it does help a little.
-
-// BCH 14 August 2017: NOTE that I have found that the RosettaCode.org C example code was incorrect, which
-// is disappointing.  It tried to check for duplicates of the median and terminate early, but its logic for
-// doing so was flawed and resulted in a bad tree that produced incorrect results.  This code now follows
-// the logic of the pseudocode at Wikipedia (https://en.wikipedia.org/wiki/Quickselect), which seems correct.
-// Ironically, the incorrect logic of the RosettaCode version only produced incorrect results when there
-// were duplicated values in the coordinate vector.
+// The k-d tree is stored implicitly, with no child pointers: the nodes of each subtree occupy a contiguous range of the node
+// buffer, with the root of the subtree at the middle of that range (at offset count / 2), its left subtree in the part of the
+// range below the root, and its right subtree in the part above.  Building the tree is therefore just a matter of partitioning
+// each range around its median along the splitting axis, cycling through the axes (x, y, z) as we descend; the tree is then
+// walked by tracking the start and count of each subtree.  The construction and search code is templated on spatiality.
 
-inline __attribute__((always_inline)) void swap(SLiM_kdNode *p_x, SLiM_kdNode *p_y) noexcept
-{
-	std::swap(p_x->x, p_y->x);
-	std::swap(p_x->individual_index_, p_y->individual_index_);
-}
-
-// find median for phase 0 (x)
-SLiM_kdNode *InteractionType::FindMedian_p0(SLiM_kdNode *start, SLiM_kdNode *end)
-{
-	// BCH 12/11/2022: This used to use Quickselect, but we encounterested issues with this hitting
-	// its O(n^2) worst case.  Now we use the STL std::nth_element(), which seems to do better.
-	SLiM_kdNode *mid = start + (end - start) / 2;
-	std::nth_element(start, mid, end, [](const SLiM_kdNode &i1, const SLiM_kdNode &i2) { return i1.x[0] < i2.x[0]; });
-	return mid;
-}
+// BCH 12/11/2022: This used to use Quickselect, but we encountered issues with this hitting its O(n^2) worst case.  Now we
+// use the STL std::nth_element(), which seems to do better.
 
-// find median for phase 1 (y)
-SLiM_kdNode *InteractionType::FindMedian_p1(SLiM_kdNode *start, SLiM_kdNode *end)
+struct _SLiM_kdRange
 {
-	// BCH 12/11/2022: This used to use Quickselect, but we encounterested issues with this hitting
-	// its O(n^2) worst case.  Now we use the STL std::nth_element(), which seems to do better.
-	SLiM_kdNode *mid = start + (end - start) / 2;
-	std::nth_element(start, mid, end, [](const SLiM_kdNode &i1, const SLiM_kdNode &i2) { return i1.x[1] < i2.x[1]; });
-	return mid;
-}
-
-// find median for phase 2 (z)
-SLiM_kdNode *InteractionType::FindMedian_p2(SLiM_kdNode *start, SLiM_kdNode *end)
+	SLiM_kdNode *nodes_;		// the first node of the range
+	slim_popsize_t count_;		// the number of nodes in the range
+	int phase_;					// the axis along which the range is split
+};
+typedef struct _SLiM_kdRange SLiM_kdRange;
+
+// partition a range around its median along axis p_phase; the median node ends up at the middle, as the root of the range's subtree
+static inline void PartitionKDRange(SLiM_kdNode *p_nodes, slim_popsize_t p_count, int p_phase)
 {
-	// BCH 12/11/2022: This used to use Quickselect, but we encounterested issues with this hitting
-	// its O(n^2) worst case.  Now we use the STL std::nth_element(), which seems to do better.
-	SLiM_kdNode *mid = start + (end - start) / 2;
-	std::nth_element(start, mid, end, [](const SLiM_kdNode &i1, const SLiM_kdNode &i2) { return i1.x[2] < i2.x[2]; });
-	return mid;
+	std::nth_element(p_nodes, p_nodes + p_count / 2, p_nodes + p_count, [p_phase](const SLiM_kdNode &i1, const SLiM_kdNode &i2) { return i1.x[p_phase] < i2.x[p_phase]; });
 }
 
-// make k-d tree recursively for the 1D case for phase 0 (x)
-SLiM_kdNode *InteractionType::MakeKDTree1_p0(SLiM_kdNode *t, int len)
+// make the k-d subtree for a range; we recurse on the left subtree and loop on the right
+template <const int f_spatiality>
+static void MakeKDSubtree(SLiM_kdNode *p_nodes, slim_popsize_t p_count, int p_phase)
 {
-	SLiM_kdNode *n = ((len == 1) ? t : FindMedian_p0(t, t + len));
-	
-	if (n)
+	while (p_count > 1)
 	{
-		int left_len = (int)(n - t);
-		n->left  = (left_len ? MakeKDTree1_p0(t, left_len) : 0);
+		slim_popsize_t left_count = p_count / 2;
+		int next_phase = ((p_phase + 1 < f_spatiality) ? p_phase + 1 : 0);
 		
-		int right_len = (int)(t + len - (n + 1));
-		n->right = (right_len ? MakeKDTree1_p0(n + 1, right_len) : 0);
-	}
-	return n;
-}
-
-// make k-d tree recursively for the 2D case for phase 0 (x)
-SLiM_kdNode *InteractionType::MakeKDTree2_p0(SLiM_kdNode *t, int len)
-{
-	SLiM_kdNode *n = ((len == 1) ? t : FindMedian_p0(t, t + len));
-	
-	if (n)
-	{
-		int left_len = (int)(n - t);
-		n->left  = (left_len ? MakeKDTree2_p1(t, left_len) : 0);
+		PartitionKDRange(p_nodes, p_count, p_phase);
+		MakeKDSubtree<f_spatiality>(p_nodes, left_count, next_phase);
 		
-		int right_len = (int)(t + len - (n + 1));
-		n->right = (right_len ? MakeKDTree2_p1(n + 1, right_len) : 0);
+		p_nodes += left_count + 1;
+		p_count -= left_count + 1;
+		p_phase = next_phase;
 	}
-	return n;
 }
 
-// make k-d tree recursively for the 2D case for phase 1 (y)
-SLiM_kdNode *InteractionType::MakeKDTree2_p1(SLiM_kdNode *t, int len)
-{
-	SLiM_kdNode *n = ((len == 1) ? t : FindMedian_p1(t, t + len));
-	
-	if (n)
-	{
-		int left_len = (int)(n - t);
-		n->left  = (left_len ? MakeKDTree2_p0(t, left_len) : 0);
-		
-		int right_len = (int)(t + len - (n + 1));
-		n->right = (right_len ? MakeKDTree2_p0(n + 1, right_len) : 0);
-	}
-	return n;
-}
+// the number of subtrees that the top of a k-d tree is split into, for building in parallel
+#define SLIM_KDTREE_PARALLEL_SUBTREE_COUNT	64
 
-// make k-d tree recursively for the 3D case for phase 0 (x)
-SLiM_kdNode *InteractionType::MakeKDTree3_p0(SLiM_kdNode *t, int len)
+template <const int f_spatiality>
+static void MakeKDTree(SLiM_kdNode *p_nodes, slim_popsize_t p_count)
 {
-	SLiM_kdNode *n = ((len == 1) ? t : FindMedian_p0(t, t + len));
+#ifdef _OPENMP
+	// Once a range has been partitioned, its two subtrees are independent of each other.  So we partition the top levels of the tree,
+	// a level at a time with the ranges in each level partitioned in parallel, until there are enough subtrees to keep all threads
+	// busy; then we build those subtrees in parallel.  The resulting tree does not depend on the number of threads used.
+	EIDOS_THREAD_COUNT(gEidos_OMP_threads_KDTREE_BUILD);
 	
-	if (n)
+	if ((p_count >= EIDOS_OMPMIN_KDTREE_BUILD) && (thread_count > 1))
 	{
-		int left_len = (int)(n - t);
-		n->left  = (left_len ? MakeKDTree3_p1(t, left_len) : 0);
+		std::vector<SLiM_kdRange> ranges, next_ranges;
 		
-		int right_len = (int)(t + len - (n + 1));
-		n->right = (right_len ? MakeKDTree3_p1(n + 1, right_len) : 0);
-	}
-	return n;
-}
-
-// make k-d tree recursively for the 3D case for phase 1 (y)
-SLiM_kdNode *InteractionType::MakeKDTree3_p1(SLiM_kdNode *t, int len)
-{
-	SLiM_kdNode *n = ((len == 1) ? t : FindMedian_p1(t, t + len));
-	
-	if (n)
-	{
-		int left_len = (int)(n - t);
-		n->left  = (left_len ? MakeKDTree3_p2(t, left_len) : 0);
+		ranges.emplace_back(SLiM_kdRange{p_nodes, p_count, 0});
+		
+		while (!ranges.empty() && (ranges.size() < SLIM_KDTREE_PARALLEL_SUBTREE_COUNT))
+		{
+			int64_t range_count = (int64_t)ranges.size();
+			
+#pragma omp parallel for schedule(dynamic, 1) default(none) shared(ranges, range_count) num_threads(thread_count)
+			for (int64_t range_index = 0; range_index < range_count; ++range_index)
+			{
+				SLiM_kdRange &range = ranges[range_index];
+				
+				if (range.count_ > 1)
+					PartitionKDRange(range.nodes_, range.count_, range.phase_);
+			}
+			
+			next_ranges.clear();
+			
+			for (SLiM_kdRange &range : ranges)
+			{
+				slim_popsize_t left_count = range.count_ / 2;
+				slim_popsize_t right_count = range.count_ - left_count - 1;
+				int next_phase = ((range.phase_ + 1 < f_spatiality) ? range.phase_ + 1 : 0);
+				
+				if (left_count > 0)
+					next_ranges.emplace_back(SLiM_kdRange{range.nodes_, left_count, next_phase});
+				if (right_count > 0)
+					next_ranges.emplace_back(SLiM_kdRange{range.nodes_ + left_count + 1, right_count, next_phase});
+			}
+			
+			ranges.swap(next_ranges);
+		}
+		
+		int64_t subtree_count = (int64_t)ranges.size();
+		
+#pragma omp parallel for schedule(dynamic, 1) default(none) shared(ranges, subtree_count) num_threads(thread_count)
+		for (int64_t range_index = 0; range_index < subtree_count; ++range_index)
+		{
+			SLiM_kdRange &range = ranges[range_index];
+			
+			MakeKDSubtree<f_spatiality>(range.nodes_, range.count_, range.phase_);
+		}
 		
-		int right_len = (int)(t + len - (n + 1));
-		n->right = (right_len ? MakeKDTree3_p2(n + 1, right_len) : 0);
+		return;
 	}
-	return n;
+#endif
+	
+	MakeKDSubtree<f_spatiality>(p_nodes, p_count, 0);
 }
 
-// make k-d tree recursively for the 3D case for phase 2 (z)
-SLiM_kdNode *InteractionType::MakeKDTree3_p2(SLiM_kdNode *t, int len)
+#if DEBUG
+// Check that the root of each subtree is a median along its splitting axis: nothing in its left subtree is greater than it, and nothing
+// in its right subtree is less.  Returns the number of nodes found.  This is slow, so it is used only in DEBUG builds; a bug was found in
+// the k-d tree code in 2.4.1 that would have been caught by this.
+template <const int f_spatiality>
+static slim_popsize_t CheckKDTree(const SLiM_kdNode *p_nodes, slim_popsize_t p_count, int p_phase)
 {
-	SLiM_kdNode *n = ((len == 1) ? t : FindMedian_p2(t, t + len));
+	if (p_count == 0)
+		return 0;
 	
-	if (n)
-	{
-		int left_len = (int)(n - t);
-		n->left  = (left_len ? MakeKDTree3_p0(t, left_len) : 0);
-		
-		int right_len = (int)(t + len - (n + 1));
-		n->right = (right_len ? MakeKDTree3_p0(n + 1, right_len) : 0);
-	}
-	return n;
+	slim_popsize_t left_count = p_count / 2;
+	double split = p_nodes[left_count].x[p_phase];
+	int next_phase = ((p_phase + 1 < f_spatiality) ? p_phase + 1 : 0);
+	
+	for (slim_popsize_t i = 0; i < left_count; ++i)
+		if (p_nodes[i].x[p_phase] > split)
+			EIDOS_TERMINATION << "ERROR (CheckKDTree): (internal error) the k-d tree is not correctly sorted." << EidosTerminate();
+	
+	for (slim_popsize_t i = left_count + 1; i < p_count; ++i)
+		if (p_nodes[i].x[p_phase] < split)
+			EIDOS_TERMINATION << "ERROR (CheckKDTree): (internal error) the k-d tree is not correctly sorted." << EidosTerminate();
+	
+	return 1 + CheckKDTree<f_spatiality>(p_nodes, left_count, next_phase) + CheckKDTree<f_spatiality>(p_nodes + left_count + 1, p_count - left_count - 1, next_phase);
 }
+#endif
 
 void InteractionType::CacheKDTreeNodes(Subpopulation *subpop, InteractionsData &p_subpop_data, bool p_apply_exerter_constraints, SLiM_kdNode **kd_nodes_ptr, SLiM_kdNode **kd_root_ptr, slim_popsize_t *kd_node_count_ptr)
 {
@@ -1878,27 +1893,27 @@ void InteractionType::BuildKDTree(InteractionsData &p_subpop_data, SLiM_kdNode *
 	}
 	else
 	{
-		// Now call out to recursively construct the tree
+		// Now partition the nodes into the implicit k-d tree, with its root at the middle of the node buffer
 		switch (spatiality_)
 		{
-			case 1: *kd_root_ptr = MakeKDTree1_p0(*kd_nodes_ptr, *kd_node_count_ptr);	break;
-			case 2: *kd_root_ptr = MakeKDTree2_p0(*kd_nodes_ptr, *kd_node_count_ptr);	break;
-			case 3: *kd_root_ptr = MakeKDTree3_p0(*kd_nodes_ptr, *kd_node_count_ptr);	break;
+			case 1: MakeKDTree<1>(*kd_nodes_ptr, *kd_node_count_ptr);	break;
+			case 2: MakeKDTree<2>(*kd_nodes_ptr, *kd_node_count_ptr);	break;
+			case 3: MakeKDTree<3>(*kd_nodes_ptr, *kd_node_count_ptr);	break;
 			default:
 				EIDOS_TERMINATION << "ERROR (InteractionType::BuildKDTree): (internal error) spatiality_ out of range." << EidosTerminate(nullptr);
 		}
 		
-		// Check the tree for correctness; for now I will leave this enabled in the DEBUG case,
-		// because a bug was found in the k-d tree code in 2.4.1 that would have been caught by this.
-		// Eventually, when it is clear that this code is robust, this check can be disabled.
+		*kd_root_ptr = *kd_nodes_ptr + *kd_node_count_ptr / 2;
+		
+		// Check the tree for correctness in the DEBUG case
 #if DEBUG
-		int total_tree_count = 0;
+		slim_popsize_t total_tree_count = 0;
 		
 		switch (spatiality_)
 		{
-			case 1: total_tree_count = CheckKDTree1_p0(*kd_root_ptr);	break;
-			case 2: total_tree_count = CheckKDTree2_p0(*kd_root_ptr);	break;
-			case 3: total_tree_count = CheckKDTree3_p0(*kd_root_ptr);	break;
+			case 1: total_tree_count = CheckKDTree<1>(*kd_nodes_ptr, *kd_node_count_ptr, 0);	break;
+			case 2: total_tree_count = CheckKDTree<2>(*kd_nodes_ptr, *kd_node_count_ptr, 0);	break;
+			case 3: total_tree_count = CheckKDTree<3>(*kd_nodes_ptr, *kd_node_count_ptr, 0);	break;
 			default:
 				EIDOS_TERMINATION << "ERROR (InteractionType::BuildKDTree): (internal error) spatiality_ out of range." << EidosTerminate(nullptr);
 		}
@@ -1974,622 +1989,316 @@ SLiM_kdNode *InteractionType::EnsureKDTreePresent_EXERTERS(Subpopulation *subpop
 
 
 #pragma mark -
-#pragma mark k-d tree consistency checking
+#pragma mark cell grid construction
 #pragma mark -
 
-// The general strategy is: the _pX() functions check that they are indeed a median node for all of the
-// nodes underneath the given node, for the coordinate of the given polarity.  They do this by calling
-// the pX_r() method on their left and right subtree, with their own coordinate; it recurses over the
-// subtrees.  The pX() method then makes a call on each subtree to have it check itself.  Each pX()
-// method call returns the total number of nodes found in itself and its subtrees.
+// The maximum number of cells per point in a cell grid; cells are widened beyond max_distance_ as needed to stay under
+// this, so that a few points scattered over a large area do not produce a grid consisting mostly of empty cells
+#define SLIM_CELL_GRID_MAX_CELLS_PER_POINT	4
 
-int InteractionType::CheckKDTree1_p0(SLiM_kdNode *t)
+void InteractionType::ChooseSpatialIndexType(void)
 {
-	double split = t->x[0];
-	
-	if (t->left) CheckKDTree1_p0_r(t->left, split, true);
-	if (t->right) CheckKDTree1_p0_r(t->right, split, false);
-	
-	int left_count = t->left ? CheckKDTree1_p0(t->left) : 0;
-	int right_count = t->right ? CheckKDTree1_p0(t->right) : 0;
-	
-	return left_count + right_count + 1;
-}
-
-void InteractionType::CheckKDTree1_p0_r(SLiM_kdNode *t, double split, bool isLeftSubtree)
-{
-	double x = t->x[0];
-	
-	if (isLeftSubtree) {
-		if (x > split)	EIDOS_TERMINATION << "ERROR (InteractionType::CheckKDTree1_p0_r): (internal error) the k-d tree is not correctly sorted." << EidosTerminate();
-	} else {
-		if (x < split)	EIDOS_TERMINATION << "ERROR (InteractionType::CheckKDTree1_p0_r): (internal error) the k-d tree is not correctly sorted." << EidosTerminate();
-	}
-	if (t->left) CheckKDTree1_p0_r(t->left, split, isLeftSubtree);
-	if (t->right) CheckKDTree1_p0_r(t->right, split, isLeftSubtree);
-}
-
-int InteractionType::CheckKDTree2_p0(SLiM_kdNode *t)
-{
-	double split = t->x[0];
-	
-	if (t->left) CheckKDTree2_p0_r(t->left, split, true);
-	if (t->right) CheckKDTree2_p0_r(t->right, split, false);
-	
-	int left_count = t->left ? CheckKDTree2_p1(t->left) : 0;
-	int right_count = t->right ? CheckKDTree2_p1(t->right) : 0;
-	
-	return left_count + right_count + 1;
-}
-
-void InteractionType::CheckKDTree2_p0_r(SLiM_kdNode *t, double split, bool isLeftSubtree)
-{
-	double x = t->x[0];
-	
-	if (isLeftSubtree) {
-		if (x > split)	EIDOS_TERMINATION << "ERROR (InteractionType::CheckKDTree2_p0_r): (internal error) the k-d tree is not correctly sorted." << EidosTerminate();
-	} else {
-		if (x < split)	EIDOS_TERMINATION << "ERROR (InteractionType::CheckKDTree2_p0_r): (internal error) the k-d tree is not correctly sorted." << EidosTerminate();
-	}
-	if (t->left) CheckKDTree2_p0_r(t->left, split, isLeftSubtree);
-	if (t->right) CheckKDTree2_p0_r(t->right, split, isLeftSubtree);
-}
-
-int InteractionType::CheckKDTree2_p1(SLiM_kdNode *t)
-{
-	double split = t->x[1];
-	
-	if (t->left) CheckKDTree2_p1_r(t->left, split, true);
-	if (t->right) CheckKDTree2_p1_r(t->right, split, false);
-	
-	int left_count = t->left ? CheckKDTree2_p0(t->left) : 0;
-	int right_count = t->right ? CheckKDTree2_p0(t->right) : 0;
-	
-	return left_count + right_count + 1;
-}
-
-void InteractionType::CheckKDTree2_p1_r(SLiM_kdNode *t, double split, bool isLeftSubtree)
-{
-	double x = t->x[1];
-	
-	if (isLeftSubtree) {
-		if (x > split)	EIDOS_TERMINATION << "ERROR (InteractionType::CheckKDTree2_p1_r): (internal error) the k-d tree is not correctly sorted." << EidosTerminate();
-	} else {
-		if (x < split)	EIDOS_TERMINATION << "ERROR (InteractionType::CheckKDTree2_p1_r): (internal error) the k-d tree is not correctly sorted." << EidosTerminate();
-	}
-	if (t->left) CheckKDTree2_p1_r(t->left, split, isLeftSubtree);
-	if (t->right) CheckKDTree2_p1_r(t->right, split, isLeftSubtree);
-}
-
-int InteractionType::CheckKDTree3_p0(SLiM_kdNode *t)
-{
-	double split = t->x[0];
-	
-	if (t->left) CheckKDTree3_p0_r(t->left, split, true);
-	if (t->right) CheckKDTree3_p0_r(t->right, split, false);
-	
-	int left_count = t->left ? CheckKDTree3_p1(t->left) : 0;
-	int right_count = t->right ? CheckKDTree3_p1(t->right) : 0;
-	
-	return left_count + right_count + 1;
+	// A cell grid needs cells of finite, nonzero width, so it is used only for a finite, nonzero maximum distance; otherwise a
+	// k-d tree is used.  This choice is made whenever max_distance_ changes, which cannot happen while the interaction is evaluated.
+	if (std::isfinite(max_distance_) && (max_distance_ > 0.0))
+		spatial_index_type_ = SLiMSpatialIndexType::kCellGrid;
+	else
+		spatial_index_type_ = SLiMSpatialIndexType::kKDTree;
 }
 
-void InteractionType::CheckKDTree3_p0_r(SLiM_kdNode *t, double split, bool isLeftSubtree)
+void _SLiM_CellGrid::Free(void)
 {
-	double x = t->x[0];
-	
-	if (isLeftSubtree) {
-		if (x > split)	EIDOS_TERMINATION << "ERROR (InteractionType::CheckKDTree3_p0_r): (internal error) the k-d tree is not correctly sorted." << EidosTerminate();
-	} else {
-		if (x < split)	EIDOS_TERMINATION << "ERROR (InteractionType::CheckKDTree3_p0_r): (internal error) the k-d tree is not correctly sorted." << EidosTerminate();
+	if (cell_starts_)
+	{
+		free(cell_starts_);
+		cell_starts_ = nullptr;
 	}
-	if (t->left) CheckKDTree3_p0_r(t->left, split, isLeftSubtree);
-	if (t->right) CheckKDTree3_p0_r(t->right, split, isLeftSubtree);
-}
-
-int InteractionType::CheckKDTree3_p1(SLiM_kdNode *t)
-{
-	double split = t->x[1];
-	
-	if (t->left) CheckKDTree3_p1_r(t->left, split, true);
-	if (t->right) CheckKDTree3_p1_r(t->right, split, false);
-	
-	int left_count = t->left ? CheckKDTree3_p2(t->left) : 0;
-	int right_count = t->right ? CheckKDTree3_p2(t->right) : 0;
-	
-	return left_count + right_count + 1;
-}
-
-void InteractionType::CheckKDTree3_p1_r(SLiM_kdNode *t, double split, bool isLeftSubtree)
-{
-	double x = t->x[1];
 	
-	if (isLeftSubtree) {
-		if (x > split)	EIDOS_TERMINATION << "ERROR (InteractionType::CheckKDTree3_p1_r): (internal error) the k-d tree is not correctly sorted." << EidosTerminate();
-	} else {
-		if (x < split)	EIDOS_TERMINATION << "ERROR (InteractionType::CheckKDTree3_p1_r): (internal error) the k-d tree is not correctly sorted." << EidosTerminate();
+	if (points_)
+	{
+		free(points_);
+		points_ = nullptr;
 	}
-	if (t->left) CheckKDTree3_p1_r(t->left, split, isLeftSubtree);
-	if (t->right) CheckKDTree3_p1_r(t->right, split, isLeftSubtree);
-}
-
-int InteractionType::CheckKDTree3_p2(SLiM_kdNode *t)
-{
-	double split = t->x[2];
-	
-	if (t->left) CheckKDTree3_p2_r(t->left, split, true);
-	if (t->right) CheckKDTree3_p2_r(t->right, split, false);
-	
-	int left_count = t->left ? CheckKDTree3_p0(t->left) : 0;
-	int right_count = t->right ? CheckKDTree3_p0(t->right) : 0;
 	
-	return left_count + right_count + 1;
+	built_ = false;
+	usable_ = false;
+	point_count_ = 0;
 }
 
-void InteractionType::CheckKDTree3_p2_r(SLiM_kdNode *t, double split, bool isLeftSubtree)
+// the index of the cell containing a given point, with coordinates beyond the grid (and NaN) clamped into the grid
+static inline __attribute__((always_inline)) size_t CellGridCellForPoint(const SLiM_CellGrid *p_grid, const double *p_x, int p_spatiality)
 {
-	double x = t->x[2];
+	size_t cell = 0;
 	
-	if (isLeftSubtree) {
-		if (x > split)	EIDOS_TERMINATION << "ERROR (InteractionType::CheckKDTree3_p2_r): (internal error) the k-d tree is not correctly sorted." << EidosTerminate();
-	} else {
-		if (x < split)	EIDOS_TERMINATION << "ERROR (InteractionType::CheckKDTree3_p2_r): (internal error) the k-d tree is not correctly sorted." << EidosTerminate();
+	for (int d = p_spatiality - 1; d >= 0; --d)
+	{
+		int count = p_grid->cell_count_[d];
+		double c = std::floor((p_x[d] - p_grid->origin_[d]) * p_grid->inv_cell_width_[d]);
+		int cell_d = (c >= 0.0) ? ((c < count) ? (int)c : count - 1) : 0;
+		
+		cell = cell * count + cell_d;
 	}
-	if (t->left) CheckKDTree3_p2_r(t->left, split, isLeftSubtree);
-	if (t->right) CheckKDTree3_p2_r(t->right, split, isLeftSubtree);
-}
-
-
-#pragma mark -
-#pragma mark sparse vector building
-#pragma mark -
-
-inline __attribute__((always_inline)) double dist_sq1(SLiM_kdNode *a, double *b)
-{
-#ifndef __clang_analyzer__
-	double t = a->x[0] - b[0];
 	
-	return t * t;
-#else
-	return 0.0;
-#endif
+	return cell;
 }
 
-inline __attribute__((always_inline)) double dist_sq2(SLiM_kdNode *a, double *b)
+void InteractionType::BuildCellGrid(InteractionsData &p_subpop_data, SLiM_kdNode *p_nodes, slim_popsize_t p_node_count, SLiM_CellGrid *p_grid)
 {
-#ifndef __clang_analyzer__
-	double t, d;
-	
-	t = a->x[0] - b[0];
-	d = t * t;
-	
-	t = a->x[1] - b[1];
-	d += t * t;
-	
-	return d;
-#else
-	return 0.0;
-#endif
-}
-
-inline __attribute__((always_inline)) double dist_sq3(SLiM_kdNode *a, double *b)
-{
-#ifndef __clang_analyzer__
-	double t, d;
-	
-	t = a->x[0] - b[0];
-	d = t * t;
-	
-	t = a->x[1] - b[1];
-	d += t * t;
-	
-	t = a->x[2] - b[2];
-	d += t * t;
-	
-	return d;
-#else
-	return 0.0;
-#endif
-}
-
-// add neighbors to the sparse vector in 1D
-void InteractionType::BuildSV_Presences_1(SLiM_kdNode *root, double *nd, slim_popsize_t p_focal_individual_index, SparseVector *p_sparse_vector)
-{
-	double d = dist_sq1(root, nd);
-#ifndef __clang_analyzer__
-	double dx = root->x[0] - nd[0];
-#else
-	double dx = 0.0;
-#endif
-	double dx2 = dx * dx;
-	
-	if ((d <= max_distance_sq_) && (root->individual_index_ != p_focal_individual_index))
-		p_sparse_vector->AddEntryPresence(root->individual_index_);
-	
-	if (dx > 0)
-	{
-		if (root->left)
-			BuildSV_Presences_1(root->left, nd, p_focal_individual_index, p_sparse_vector);
+	// The nodes come from CacheKDTreeNodes(), and must not have been made into a k-d tree, since BuildKDTree() replicates them
+	// for periodic boundaries; the grid handles periodicity itself, by wrapping around at query time.  The nodes are left as
+	// they are, so a k-d tree can still be built from them if the grid turns out not to be usable.
+	bool periodic[SLIM_MAX_DIMENSIONALITY] = {p_subpop_data.periodic_x_, p_subpop_data.periodic_y_, p_subpop_data.periodic_z_};
+	double bounds[SLIM_MAX_DIMENSIONALITY] = {p_subpop_data.bounds_x1_, p_subpop_data.bounds_y1_, p_subpop_data.bounds_z1_};
+	double extent[SLIM_MAX_DIMENSIONALITY] = {0.0, 0.0, 0.0};
+	
+	p_grid->Free();
+	p_grid->built_ = true;
+	
+	// Periodic dimensions run from zero to their bound, and positions are guaranteed to be within them; along non-periodic
+	// dimensions, we span the positions actually present.  Infinite coordinates cannot be gridded, so we let a k-d tree handle
+	// them; NaN coordinates, which are never within range of anything, are skipped here and will land in an arbitrary cell.
+	for (int d = 0; d < spatiality_; ++d)
+	{
+		if (periodic[d])
+		{
+			p_grid->origin_[d] = 0.0;
+			extent[d] = bounds[d];
+			continue;
+		}
 		
-		if (dx2 > max_distance_sq_) return;
+		double min_coord = std::numeric_limits<double>::infinity(), max_coord = -std::numeric_limits<double>::infinity();
 		
-		if (root->right)
-			BuildSV_Presences_1(root->right, nd, p_focal_individual_index, p_sparse_vector);
-	}
-	else
-	{
-		if (root->right)
-			BuildSV_Presences_1(root->right, nd, p_focal_individual_index, p_sparse_vector);
+		for (slim_popsize_t i = 0; i < p_node_count; ++i)
+		{
+			double x = p_nodes[i].x[d];
+			
+			if (x < min_coord) min_coord = x;
+			if (x > max_coord) max_coord = x;
+		}
 		
-		if (dx2 > max_distance_sq_) return;
+		if (min_coord > max_coord)
+		{
+			// no points (or only NaN)
+			min_coord = 0.0;
+			max_coord = 0.0;
+		}
+		else if (!std::isfinite(min_coord) || !std::isfinite(max_coord) || !std::isfinite(max_coord - min_coord))
+		{
+			return;		// leave usable_ false
+		}
 		
-		if (root->left)
-			BuildSV_Presences_1(root->left, nd, p_focal_individual_index, p_sparse_vector);
+		p_grid->origin_[d] = min_coord;
+		extent[d] = max_coord - min_coord;
 	}
-}
-
-// add neighbors to the sparse vector in 2D
-void InteractionType::BuildSV_Presences_2(SLiM_kdNode *root, double *nd, slim_popsize_t p_focal_individual_index, SparseVector *p_sparse_vector, int p_phase)
-{
-	double d = dist_sq2(root, nd);
-#ifndef __clang_analyzer__
-	double dx = root->x[p_phase] - nd[p_phase];
-#else
-	double dx = 0.0;
-#endif
-	double dx2 = dx * dx;
 	
-	if ((d <= max_distance_sq_) && (root->individual_index_ != p_focal_individual_index))
-		p_sparse_vector->AddEntryPresence(root->individual_index_);
+	// Choose the cell width: max_distance_, with a little slack so that rounding in the cell calculations can never place two
+	// points within max_distance_ of each other more than one cell apart, and then doubled as needed to limit the cell count.
+	// Along periodic dimensions the width is stretched to divide the period evenly; since max_distance_ is less than half of
+	// the period, that usually gives at least two cells, but one cell, wrapped around at query time, also works.
+	double max_cells = (double)p_node_count * SLIM_CELL_GRID_MAX_CELLS_PER_POINT + 1.0;
+	double width = max_distance_ * (1.0 + 1e-6);
+	double cell_counts[SLIM_MAX_DIMENSIONALITY] = {1.0, 1.0, 1.0};
 	
-	if (++p_phase >= 2) p_phase = 0;
-	
-	if (dx > 0)
+	while (true)
 	{
-		if (root->left)
-			BuildSV_Presences_2(root->left, nd, p_focal_individual_index, p_sparse_vector, p_phase);
-		
-		if (dx2 > max_distance_sq_) return;
+		double total_cells = 1.0;
 		
-		if (root->right)
-			BuildSV_Presences_2(root->right, nd, p_focal_individual_index, p_sparse_vector, p_phase);
-	}
-	else
-	{
-		if (root->right)
-			BuildSV_Presences_2(root->right, nd, p_focal_individual_index, p_sparse_vector, p_phase);
+		for (int d = 0; d < spatiality_; ++d)
+		{
+			if (periodic[d])
+				cell_counts[d] = std::max(1.0, std::floor(extent[d] / width));
+			else
+				cell_counts[d] = std::floor(extent[d] / width) + 1.0;
+			
+			total_cells *= cell_counts[d];
+		}
 		
-		if (dx2 > max_distance_sq_) return;
+		if (total_cells <= max_cells)
+			break;
 		
-		if (root->left)
-			BuildSV_Presences_2(root->left, nd, p_focal_individual_index, p_sparse_vector, p_phase);
+		width *= 2.0;
 	}
-}
-
-// add neighbors to the sparse vector in 3D
-void InteractionType::BuildSV_Presences_3(SLiM_kdNode *root, double *nd, slim_popsize_t p_focal_individual_index, SparseVector *p_sparse_vector, int p_phase)
-{
-	double d = dist_sq3(root, nd);
-#ifndef __clang_analyzer__
-	double dx = root->x[p_phase] - nd[p_phase];
-#else
-	double dx = 0.0;
-#endif
-	double dx2 = dx * dx;
-	
-	if ((d <= max_distance_sq_) && (root->individual_index_ != p_focal_individual_index))
-		p_sparse_vector->AddEntryPresence(root->individual_index_);
 	
-	if (++p_phase >= 3) p_phase = 0;
+	size_t total_cells = 1;
 	
-	if (dx > 0)
-	{
-		if (root->left)
-			BuildSV_Presences_3(root->left, nd, p_focal_individual_index, p_sparse_vector, p_phase);
-		
-		if (dx2 > max_distance_sq_) return;
-		
-		if (root->right)
-			BuildSV_Presences_3(root->right, nd, p_focal_individual_index, p_sparse_vector, p_phase);
-	}
-	else
+	for (int d = 0; d < SLIM_MAX_DIMENSIONALITY; ++d)
 	{
-		if (root->right)
-			BuildSV_Presences_3(root->right, nd, p_focal_individual_index, p_sparse_vector, p_phase);
+		if (d >= spatiality_)
+		{
+			p_grid->cell_count_[d] = 1;
+			p_grid->origin_[d] = 0.0;
+			p_grid->inv_cell_width_[d] = 0.0;
+			p_grid->period_[d] = 0.0;
+			continue;
+		}
 		
-		if (dx2 > max_distance_sq_) return;
+		int count = (int)cell_counts[d];
 		
-		if (root->left)
-			BuildSV_Presences_3(root->left, nd, p_focal_individual_index, p_sparse_vector, p_phase);
+		p_grid->cell_count_[d] = count;
+		p_grid->period_[d] = (periodic[d] ? extent[d] : 0.0);
+		p_grid->inv_cell_width_[d] = (periodic[d] ? count / extent[d] : 1.0 / width);
+		total_cells *= count;
 	}
-}
-
-// add neighbors to the sparse vector in 1D
-void InteractionType::BuildSV_Distances_1(SLiM_kdNode *root, double *nd, slim_popsize_t p_focal_individual_index, SparseVector *p_sparse_vector)
-{
-	double d = dist_sq1(root, nd);
-#ifndef __clang_analyzer__
-	double dx = root->x[0] - nd[0];
-#else
-	double dx = 0.0;
-#endif
-	double dx2 = dx * dx;
 	
-	if ((d <= max_distance_sq_) && (root->individual_index_ != p_focal_individual_index))
-		p_sparse_vector->AddEntryDistance(root->individual_index_, (sv_value_t)sqrt(d));
+	// Sort the points into cells with a counting sort: count the points in each cell, take a prefix sum to get the start of
+	// each cell, and then scatter the points; the points within each cell stay in individual order
+	uint32_t *cell_starts = (uint32_t *)calloc(total_cells + 1, sizeof(uint32_t));
+	SLiM_gridPoint *points = (SLiM_gridPoint *)malloc(std::max(p_node_count, 1) * sizeof(SLiM_gridPoint));
 	
-	if (dx > 0)
-	{
-		if (root->left)
-			BuildSV_Distances_1(root->left, nd, p_focal_individual_index, p_sparse_vector);
-		
-		if (dx2 > max_distance_sq_) return;
-		
-		if (root->right)
-			BuildSV_Distances_1(root->right, nd, p_focal_individual_index, p_sparse_vector);
-	}
-	else
-	{
-		if (root->right)
-			BuildSV_Distances_1(root->right, nd, p_focal_individual_index, p_sparse_vector);
-		
-		if (dx2 > max_distance_sq_) return;
-		
-		if (root->left)
-			BuildSV_Distances_1(root->left, nd, p_focal_individual_index, p_sparse_vector);
-	}
-}
-
-// add neighbors to the sparse vector in 2D
-void InteractionType::BuildSV_Distances_2(SLiM_kdNode *root, double *nd, slim_popsize_t p_focal_individual_index, SparseVector *p_sparse_vector, int p_phase)
-{
-	double d = dist_sq2(root, nd);
-#ifndef __clang_analyzer__
-	double dx = root->x[p_phase] - nd[p_phase];
-#else
-	double dx = 0.0;
-#endif
-	double dx2 = dx * dx;
+	if (!cell_starts || !points)
+		EIDOS_TERMINATION << "ERROR (InteractionType::BuildCellGrid): allocation failed; you may need to raise the memory limit for SLiM." << EidosTerminate(nullptr);
 	
-	if ((d <= max_distance_sq_) && (root->individual_index_ != p_focal_individual_index))
-		p_sparse_vector->AddEntryDistance(root->individual_index_, (sv_value_t)sqrt(d));
+	for (slim_popsize_t i = 0; i < p_node_count; ++i)
+		cell_starts[CellGridCellForPoint(p_grid, p_nodes[i].x, spatiality_) + 1]++;
 	
-	if (++p_phase >= 2) p_phase = 0;
+	for (size_t cell = 0; cell < total_cells; ++cell)
+		cell_starts[cell + 1] += cell_starts[cell];
 	
-	if (dx > 0)
-	{
-		if (root->left)
-			BuildSV_Distances_2(root->left, nd, p_focal_individual_index, p_sparse_vector, p_phase);
-		
-		if (dx2 > max_distance_sq_) return;
-		
-		if (root->right)
-			BuildSV_Distances_2(root->right, nd, p_focal_individual_index, p_sparse_vector, p_phase);
-	}
-	else
+	for (slim_popsize_t i = 0; i < p_node_count; ++i)
 	{
-		if (root->right)
-			BuildSV_Distances_2(root->right, nd, p_focal_individual_index, p_sparse_vector, p_phase);
-		
-		if (dx2 > max_distance_sq_) return;
+		const SLiM_kdNode *node = p_nodes + i;
+		SLiM_gridPoint *point = points + cell_starts[CellGridCellForPoint(p_grid, node->x, spatiality_)]++;
 		
-		if (root->left)
-			BuildSV_Distances_2(root->left, nd, p_focal_individual_index, p_sparse_vector, p_phase);
+		point->x[0] = node->x[0];
+		point->x[1] = node->x[1];
+		point->x[2] = node->x[2];
+		point->individual_index_ = node->individual_index_;
 	}
+	
+	// each cell's start has now advanced to the start of the next cell, so shift them back down
+	memmove(cell_starts + 1, cell_starts, total_cells * sizeof(uint32_t));
+	cell_starts[0] = 0;
+	
+	p_grid->cell_starts_ = cell_starts;
+	p_grid->points_ = points;
+	p_grid->point_count_ = p_node_count;
+	p_grid->usable_ = true;
 }
 
-// add neighbors to the sparse vector in 3D
-void InteractionType::BuildSV_Distances_3(SLiM_kdNode *root, double *nd, slim_popsize_t p_focal_individual_index, SparseVector *p_sparse_vector, int p_phase)
+SLiM_CellGrid *InteractionType::EnsureCellGridPresent_ALL(Subpopulation *subpop, InteractionsData &p_subpop_data)
 {
-	double d = dist_sq3(root, nd);
-#ifndef __clang_analyzer__
-	double dx = root->x[p_phase] - nd[p_phase];
-#else
-	double dx = 0.0;
-#endif
-	double dx2 = dx * dx;
-	
-	if ((d <= max_distance_sq_) && (root->individual_index_ != p_focal_individual_index))
-		p_sparse_vector->AddEntryDistance(root->individual_index_, (sv_value_t)sqrt(d));
+	if (!p_subpop_data.evaluated_)
+		EIDOS_TERMINATION << "ERROR (InteractionType::EnsureCellGridPresent_ALL): (internal error) the interaction has not been evaluated." << EidosTerminate();
 	
-	if (++p_phase >= 3) p_phase = 0;
+	if (spatiality_ == 0)
+		EIDOS_TERMINATION << "ERROR (InteractionType::EnsureCellGridPresent_ALL): (internal error) a cell grid cannot be constructed for non-spatial interactions." << EidosTerminate();
 	
-	if (dx > 0)
-	{
-		if (root->left)
-			BuildSV_Distances_3(root->left, nd, p_focal_individual_index, p_sparse_vector, p_phase);
-		
-		if (dx2 > max_distance_sq_) return;
-		
-		if (root->right)
-			BuildSV_Distances_3(root->right, nd, p_focal_individual_index, p_sparse_vector, p_phase);
-	}
-	else
+	if (!p_subpop_data.cell_grid_ALL_.built_)
 	{
-		if (root->right)
-			BuildSV_Distances_3(root->right, nd, p_focal_individual_index, p_sparse_vector, p_phase);
+		if (!p_subpop_data.kd_nodes_ALL_)
+			CacheKDTreeNodes(subpop, p_subpop_data, /* p_apply_exerter_constraints */ false, &p_subpop_data.kd_nodes_ALL_, &p_subpop_data.kd_root_ALL_, &p_subpop_data.kd_node_count_ALL_);
 		
-		if (dx2 > max_distance_sq_) return;
+		if (p_subpop_data.kd_root_ALL_)
+			EIDOS_TERMINATION << "ERROR (InteractionType::EnsureCellGridPresent_ALL): (internal error) a cell grid cannot be built after the k-d tree." << EidosTerminate();
 		
-		if (root->left)
-			BuildSV_Distances_3(root->left, nd, p_focal_individual_index, p_sparse_vector, p_phase);
+		BuildCellGrid(p_subpop_data, p_subpop_data.kd_nodes_ALL_, p_subpop_data.kd_node_count_ALL_, &p_subpop_data.cell_grid_ALL_);
 	}
+	
+	return &p_subpop_data.cell_grid_ALL_;
 }
 
-// add neighbor strengths of type "f" (SpatialKernelType::kFixed : fixed) to the sparse vector in 2D
-void InteractionType::BuildSV_Strengths_f_2(SLiM_kdNode *root, double *nd, slim_popsize_t p_focal_individual_index, SparseVector *p_sparse_vector, int p_phase)
+SLiM_CellGrid *InteractionType::EnsureCellGridPresent_EXERTERS(Subpopulation *subpop, InteractionsData &p_subpop_data)
 {
-	double d = dist_sq2(root, nd);
-#ifndef __clang_analyzer__
-	double dx = root->x[p_phase] - nd[p_phase];
-#else
-	double dx = 0.0;
-#endif
-	double dx2 = dx * dx;
+	if (!p_subpop_data.evaluated_)
+		EIDOS_TERMINATION << "ERROR (InteractionType::EnsureCellGridPresent_EXERTERS): (internal error) the interaction has not been evaluated." << EidosTerminate();
 	
-	if ((d <= max_distance_sq_) && (root->individual_index_ != p_focal_individual_index))
-	{
-		//d = sqrt(d);
-		p_sparse_vector->AddEntryStrength(root->individual_index_, (sv_value_t)if_param1_);
-	}
+	if (spatiality_ == 0)
+		EIDOS_TERMINATION << "ERROR (InteractionType::EnsureCellGridPresent_EXERTERS): (internal error) a cell grid cannot be constructed for non-spatial interactions." << EidosTerminate();
 	
-	if (++p_phase >= 2) p_phase = 0;
-	if (dx > 0) {
-		if (root->left)					BuildSV_Strengths_f_2(root->left, nd, p_focal_individual_index, p_sparse_vector, p_phase);
-		if (dx2 > max_distance_sq_)		return;
-		if (root->right)				BuildSV_Strengths_f_2(root->right, nd, p_focal_individual_index, p_sparse_vector, p_phase);
-	} else {
-		if (root->right)				BuildSV_Strengths_f_2(root->right, nd, p_focal_individual_index, p_sparse_vector, p_phase);
-		if (dx2 > max_distance_sq_)		return;
-		if (root->left)					BuildSV_Strengths_f_2(root->left, nd, p_focal_individual_index, p_sparse_vector, p_phase);
-	}
-}
-
-// add neighbor strengths of type "l" (SpatialKernelType::kLinear : linear) to the sparse vector in 2D
-void InteractionType::BuildSV_Strengths_l_2(SLiM_kdNode *root, double *nd, slim_popsize_t p_focal_individual_index, SparseVector *p_sparse_vector, int p_phase)
-{
-	double d = dist_sq2(root, nd);
-#ifndef __clang_analyzer__
-	double dx = root->x[p_phase] - nd[p_phase];
-#else
-	double dx = 0.0;
-#endif
-	double dx2 = dx * dx;
+	// Without exerter constraints, the EXERTERS grid would be the same as the ALL grid, so we just use that one
+	if (!exerter_constraints_.has_constraints_)
+		return EnsureCellGridPresent_ALL(subpop, p_subpop_data);
 	
-	if ((d <= max_distance_sq_) && (root->individual_index_ != p_focal_individual_index))
+	if (!p_subpop_data.cell_grid_EXERTERS_.built_)
 	{
-		d = sqrt(d);
-		p_sparse_vector->AddEntryStrength(root->individual_index_, (sv_value_t)(if_param1_ * (1.0 - d / max_distance_)));
+		// This follows the logic of EnsureKDTreePresent_EXERTERS(); see the comments there
+		if (!p_subpop_data.kd_nodes_EXERTERS_)
+		{
+			if (p_subpop_data.kd_constraints_raise_EXERTERS_)
+				EIDOS_TERMINATION << "ERROR (InteractionType::EnsureCellGridPresent_EXERTERS): a tag, tagL0, tagL1, tagL2, tagL3, or tagL4 constraint is set for exerters, but the corresponding property is undefined (has not been set) for a candidate exerter being queried." << EidosTerminate();
+			
+			if (exerter_constraints_.has_nonsex_constraints_)
+				EIDOS_TERMINATION << "ERROR (InteractionType::EnsureCellGridPresent_EXERTERS): (internal error) an internal error in the exerter k-d tree caching logic has occurred; please report this error." << EidosTerminate();
+			
+			CacheKDTreeNodes(subpop, p_subpop_data, /* p_apply_exerter_constraints */ true, &p_subpop_data.kd_nodes_EXERTERS_, &p_subpop_data.kd_root_EXERTERS_, &p_subpop_data.kd_node_count_EXERTERS_);
+		}
+		
+		if (p_subpop_data.kd_root_EXERTERS_)
+			EIDOS_TERMINATION << "ERROR (InteractionType::EnsureCellGridPresent_EXERTERS): (internal error) a cell grid cannot be built after the k-d tree." << EidosTerminate();
+		
+		BuildCellGrid(p_subpop_data, p_subpop_data.kd_nodes_EXERTERS_, p_subpop_data.kd_node_count_EXERTERS_, &p_subpop_data.cell_grid_EXERTERS_);
 	}
 	
-	if (++p_phase >= 2) p_phase = 0;
-	if (dx > 0) {
-		if (root->left)					BuildSV_Strengths_l_2(root->left, nd, p_focal_individual_index, p_sparse_vector, p_phase);
-		if (dx2 > max_distance_sq_)		return;
-		if (root->right)				BuildSV_Strengths_l_2(root->right, nd, p_focal_individual_index, p_sparse_vector, p_phase);
-	} else {
-		if (root->right)				BuildSV_Strengths_l_2(root->right, nd, p_focal_individual_index, p_sparse_vector, p_phase);
-		if (dx2 > max_distance_sq_)		return;
-		if (root->left)					BuildSV_Strengths_l_2(root->left, nd, p_focal_individual_index, p_sparse_vector, p_phase);
-	}
+	return &p_subpop_data.cell_grid_EXERTERS_;
 }
 
-// add neighbor strengths of type "e" (SpatialKernelType::kExponential : exponential) to the sparse vector in 2D
-void InteractionType::BuildSV_Strengths_e_2(SLiM_kdNode *root, double *nd, slim_popsize_t p_focal_individual_index, SparseVector *p_sparse_vector, int p_phase)
+SLiM_SpatialIndex InteractionType::EnsureSpatialIndexPresent_ALL(Subpopulation *subpop, InteractionsData &p_subpop_data)
 {
-	double d = dist_sq2(root, nd);
-#ifndef __clang_analyzer__
-	double dx = root->x[p_phase] - nd[p_phase];
-#else
-	double dx = 0.0;
-#endif
-	double dx2 = dx * dx;
+	SLiM_SpatialIndex index;
 	
-	if ((d <= max_distance_sq_) && (root->individual_index_ != p_focal_individual_index))
+	if (spatial_index_type_ == SLiMSpatialIndexType::kCellGrid)
 	{
-		d = sqrt(d);
-		p_sparse_vector->AddEntryStrength(root->individual_index_, (sv_value_t)(if_param1_ * exp(-if_param2_ * d)));
-	}
-	
-	if (++p_phase >= 2) p_phase = 0;
-	if (dx > 0) {
-		if (root->left)					BuildSV_Strengths_e_2(root->left, nd, p_focal_individual_index, p_sparse_vector, p_phase);
-		if (dx2 > max_distance_sq_)		return;
-		if (root->right)				BuildSV_Strengths_e_2(root->right, nd, p_focal_individual_index, p_sparse_vector, p_phase);
-	} else {
-		if (root->right)				BuildSV_Strengths_e_2(root->right, nd, p_focal_individual_index, p_sparse_vector, p_phase);
-		if (dx2 > max_distance_sq_)		return;
-		if (root->left)					BuildSV_Strengths_e_2(root->left, nd, p_focal_individual_index, p_sparse_vector, p_phase);
+		SLiM_CellGrid *grid = EnsureCellGridPresent_ALL(subpop, p_subpop_data);
+		
+		if (grid->usable_)
+		{
+			if (grid->point_count_ > 0)
+			{
+				index.cell_grid_ = grid;
+				index.node_count_ = grid->point_count_;
+			}
+			
+			return index;
+		}
+		
+		// the grid could not be used, so we fall back to a k-d tree, built from the same cached nodes
 	}
-}
-
-// add neighbor strengths of type "n" (SpatialKernelType::kNormal : normal/Gaussian) to the sparse vector in 2D
-void InteractionType::BuildSV_Strengths_n_2(SLiM_kdNode *root, double *nd, slim_popsize_t p_focal_individual_index, SparseVector *p_sparse_vector, int p_phase)
-{
-	double d = dist_sq2(root, nd);
-#ifndef __clang_analyzer__
-	double dx = root->x[p_phase] - nd[p_phase];
-#else
-	double dx = 0.0;
-#endif
-	double dx2 = dx * dx;
 	
-	if ((d <= max_distance_sq_) && (root->individual_index_ != p_focal_individual_index))
+	if (EnsureKDTreePresent_ALL(subpop, p_subpop_data))
 	{
-		//d = sqrt(d);
-		p_sparse_vector->AddEntryStrength(root->individual_index_, (sv_value_t)(if_param1_ * exp(-d / n_2param2sq_)));
+		index.kd_nodes_ = p_subpop_data.kd_nodes_ALL_;
+		index.node_count_ = p_subpop_data.kd_node_count_ALL_;
 	}
 	
-	if (++p_phase >= 2) p_phase = 0;
-	if (dx > 0) {
-		if (root->left)					BuildSV_Strengths_n_2(root->left, nd, p_focal_individual_index, p_sparse_vector, p_phase);
-		if (dx2 > max_distance_sq_)		return;
-		if (root->right)				BuildSV_Strengths_n_2(root->right, nd, p_focal_individual_index, p_sparse_vector, p_phase);
-	} else {
-		if (root->right)				BuildSV_Strengths_n_2(root->right, nd, p_focal_individual_index, p_sparse_vector, p_phase);
-		if (dx2 > max_distance_sq_)		return;
-		if (root->left)					BuildSV_Strengths_n_2(root->left, nd, p_focal_individual_index, p_sparse_vector, p_phase);
-	}
+	return index;
 }
 
-// add neighbor strengths of type "c" (SpatialKernelType::kCauchy : Cauchy) to the sparse vector in 2D
-void InteractionType::BuildSV_Strengths_c_2(SLiM_kdNode *root, double *nd, slim_popsize_t p_focal_individual_index, SparseVector *p_sparse_vector, int p_phase)
+SLiM_SpatialIndex InteractionType::EnsureSpatialIndexPresent_EXERTERS(Subpopulation *subpop, InteractionsData &p_subpop_data)
 {
-	double d = dist_sq2(root, nd);
-#ifndef __clang_analyzer__
-	double dx = root->x[p_phase] - nd[p_phase];
-#else
-	double dx = 0.0;
-#endif
-	double dx2 = dx * dx;
+	SLiM_SpatialIndex index;
 	
-	if ((d <= max_distance_sq_) && (root->individual_index_ != p_focal_individual_index))
+	if (spatial_index_type_ == SLiMSpatialIndexType::kCellGrid)
 	{
-		double temp = sqrt(d) / if_param2_;
-		p_sparse_vector->AddEntryStrength(root->individual_index_, (sv_value_t)(if_param1_ / (1.0 + temp * temp)));
-	}
-	
-	if (++p_phase >= 2) p_phase = 0;
-	if (dx > 0) {
-		if (root->left)					BuildSV_Strengths_c_2(root->left, nd, p_focal_individual_index, p_sparse_vector, p_phase);
-		if (dx2 > max_distance_sq_)		return;
-		if (root->right)				BuildSV_Strengths_c_2(root->right, nd, p_focal_individual_index, p_sparse_vector, p_phase);
-	} else {
-		if (root->right)				BuildSV_Strengths_c_2(root->right, nd, p_focal_individual_index, p_sparse_vector, p_phase);
-		if (dx2 > max_distance_sq_)		return;
-		if (root->left)					BuildSV_Strengths_c_2(root->left, nd, p_focal_individual_index, p_sparse_vector, p_phase);
+		SLiM_CellGrid *grid = EnsureCellGridPresent_EXERTERS(subpop, p_subpop_data);
+		
+		if (grid->usable_)
+		{
+			if (grid->point_count_ > 0)
+			{
+				index.cell_grid_ = grid;
+				index.node_count_ = grid->point_count_;
+			}
+			
+			return index;
+		}
+		
+		// the grid could not be used, so we fall back to a k-d tree, built from the same cached nodes
 	}
-}
-
-// add neighbor strengths of type "t" (SpatialKernelType::kStudentsT : Student's t) to the sparse vector in 2D
-void InteractionType::BuildSV_Strengths_t_2(SLiM_kdNode *root, double *nd, slim_popsize_t p_focal_individual_index, SparseVector *p_sparse_vector, int p_phase)
-{
-	double d = dist_sq2(root, nd);
-#ifndef __clang_analyzer__
-	double dx = root->x[p_phase] - nd[p_phase];
-#else
-	double dx = 0.0;
-#endif
-	double dx2 = dx * dx;
 	
-	if ((d <= max_distance_sq_) && (root->individual_index_ != p_focal_individual_index))
+	if (EnsureKDTreePresent_EXERTERS(subpop, p_subpop_data))
 	{
-		d = sqrt(d);
-		p_sparse_vector->AddEntryStrength(root->individual_index_, (sv_value_t)SpatialKernel::tdist(d, if_param1_, if_param2_, if_param3_));
+		index.kd_nodes_ = p_subpop_data.kd_nodes_EXERTERS_;
+		index.node_count_ = p_subpop_data.kd_node_count_EXERTERS_;
 	}
 	
-	if (++p_phase >= 2) p_phase = 0;
-	if (dx > 0) {
-		if (root->left)					BuildSV_Strengths_t_2(root->left, nd, p_focal_individual_index, p_sparse_vector, p_phase);
-		if (dx2 > max_distance_sq_)		return;
-		if (root->right)				BuildSV_Strengths_t_2(root->right, nd, p_focal_individual_index, p_sparse_vector, p_phase);
-	} else {
-		if (root->right)				BuildSV_Strengths_t_2(root->right, nd, p_focal_individual_index, p_sparse_vector, p_phase);
-		if (dx2 > max_distance_sq_)		return;
-		if (root->left)					BuildSV_Strengths_t_2(root->left, nd, p_focal_individual_index, p_sparse_vector, p_phase);
-	}
+	return index;
 }
 
+
+#pragma mark -
+#pragma mark sparse vector building
+#pragma mark -
+
 bool InteractionType::_CheckIndividualNonSexConstraints(Individual *p_individual, InteractionConstraints &p_constraints)
 {
 	// we do not check p_constraints.has_nonsex_constraints_; this should only be called when a constraint exists
@@ -2685,7 +2394,7 @@ bool InteractionType::_PrecheckIndividualNonSexConstraints(Individual *p_individ
 	return true;
 }
 
-void InteractionType::FillSparseVectorForReceiverPresences(SparseVector *sv, Individual *receiver, double *receiver_position, Subpopulation *exerter_subpop, SLiM_kdNode *kd_root, __attribute__((__unused__)) bool constraints_active)
+void InteractionType::FillSparseVectorForReceiverPresences(SparseVector *sv, Individual *receiver, double *receiver_position, Subpopulation *exerter_subpop, const SLiM_SpatialIndex &p_index, __attribute__((__unused__)) bool constraints_active)
 {
 #if DEBUG
 	// The caller should guarantee that the receiver and exerter species are compatible with the interaction
@@ -2720,23 +2429,21 @@ void InteractionType::FillSparseVectorForReceiverPresences(SparseVector *sv, Ind
 		EIDOS_TERMINATION << "ERROR (InteractionType::FillSparseVectorForReceiverPresences): (internal error) the receiver is a new juvenile." << EidosTerminate();
 #endif
 	
-	// if the root is nullptr, the tree is empty and we have no results
-	if (kd_root)
+	// if the index is empty, we have no results
+	if (!p_index.IsEmpty())
 	{
 		// Figure out what index in the exerter subpopulation, if any, needs to be excluded so self-interaction is zero
 		slim_popsize_t excluded_index = (exerter_subpop == receiver->subpopulation_) ? receiver->index_ : -1;
 		
 		// Without a specified exerter sex, we can add each exerter with no sex test
-		if (spatiality_ == 2)		BuildSV_Presences_2(kd_root, receiver_position, excluded_index, sv, 0);
-		else if (spatiality_ == 1)	BuildSV_Presences_1(kd_root, receiver_position, excluded_index, sv);
-		else if (spatiality_ == 3)	BuildSV_Presences_3(kd_root, receiver_position, excluded_index, sv, 0);
+		BuildSV_Presences(p_index, receiver_position, excluded_index, sv);
 	}
 	
 	// After building the sparse vector above, we mark it finished
 	sv->Finished();
 }
 
-void InteractionType::FillSparseVectorForReceiverDistances(SparseVector *sv, Individual *receiver, double *receiver_position, Subpopulation *exerter_subpop, SLiM_kdNode *kd_root, __attribute__((__unused__)) bool constraints_active)
+void InteractionType::FillSparseVectorForReceiverDistances(SparseVector *sv, Individual *receiver, double *receiver_position, Subpopulation *exerter_subpop, const SLiM_SpatialIndex &p_index, __attribute__((__unused__)) bool constraints_active)
 {
 #if DEBUG
 	// The caller should guarantee that the receiver and exerter species are compatible with the interaction
@@ -2771,22 +2478,20 @@ void InteractionType::FillSparseVectorForReceiverDistances(SparseVector *sv, Ind
 		EIDOS_TERMINATION << "ERROR (InteractionType::FillSparseVectorForReceiverDistances): (internal error) the receiver is a new juvenile." << EidosTerminate();
 #endif
 	
-	// if the root is nullptr, the tree is empty and we have no results
-	if (kd_root)
+	// if the index is empty, we have no results
+	if (!p_index.IsEmpty())
 	{
 		// Figure out what index in the exerter subpopulation, if any, needs to be excluded so self-interaction is zero
 		slim_popsize_t excluded_index = (exerter_subpop == receiver->subpopulation_) ? receiver->index_ : -1;
 		
-		if (spatiality_ == 2)		BuildSV_Distances_2(kd_root, receiver_position, excluded_index, sv, 0);
-		else if (spatiality_ == 1)	BuildSV_Distances_1(kd_root, receiver_position, excluded_index, sv);
-		else if (spatiality_ == 3)	BuildSV_Distances_3(kd_root, receiver_position, excluded_index, sv, 0);
+		BuildSV_Distances(p_index, receiver_position, excluded_index, sv);
 	}
 	
 	// After building the sparse vector above, we mark it finished
 	sv->Finished();
 }
 
-void InteractionType::FillSparseVectorForPointDistances(SparseVector *sv, double *position, __attribute__((__unused__)) Subpopulation *exerter_subpop, SLiM_kdNode *kd_root)
+void InteractionType::FillSparseVectorForPointDistances(SparseVector *sv, double *position, __attribute__((__unused__)) Subpopulation *exerter_subpop, const SLiM_SpatialIndex &p_index)
 {
 	// This is a special version of FillSparseVectorForReceiverDistances() used for nearestNeighborsOfPoint().
 	// It searches for neighbors of a point, without using a receiver, just a point.
@@ -2803,19 +2508,15 @@ void InteractionType::FillSparseVectorForPointDistances(SparseVector *sv, double
 		EIDOS_TERMINATION << "ERROR (InteractionType::FillSparseVectorForPointDistances): (internal error) the sparse vector is not configured for distances." << EidosTerminate();
 #endif
 	
-	// if the root is nullptr, the tree is empty and we have no results
-	if (kd_root)
-	{
-		if (spatiality_ == 2)		BuildSV_Distances_2(kd_root, position, -1, sv, 0);
-		else if (spatiality_ == 1)	BuildSV_Distances_1(kd_root, position, -1, sv);
-		else if (spatiality_ == 3)	BuildSV_Distances_3(kd_root, position, -1, sv, 0);
-	}
+	// if the index is empty, we have no results
+	if (!p_index.IsEmpty())
+		BuildSV_Distances(p_index, position, -1, sv);
 	
 	// After building the sparse vector above, we mark it finished
 	sv->Finished();
 }
 
-void InteractionType::FillSparseVectorForReceiverStrengths(SparseVector *sv, Individual *receiver, double *receiver_position, Subpopulation *exerter_subpop, SLiM_kdNode *kd_root, std::vector<SLiMEidosBlock*> &interaction_callbacks)
+void InteractionType::FillSparseVectorForReceiverStrengths(SparseVector *sv, Individual *receiver, double *receiver_position, Subpopulation *exerter_subpop, const SLiM_SpatialIndex &p_index, std::vector<SLiMEidosBlock*> &interaction_callbacks)
 {
 #if DEBUG
 	// The caller should guarantee that the receiver and exerter species are compatible with the interaction
@@ -2842,55 +2543,27 @@ void InteractionType::FillSparseVectorForReceiverStrengths(SparseVector *sv, Ind
 		EIDOS_TERMINATION << "ERROR (InteractionType::FillSparseVectorForReceiverStrengths): (internal error) the receiver is a new juvenile." << EidosTerminate();
 #endif
 	
-	// if the root is nullptr, the tree is empty and we have no results
-	if (kd_root)
+	// if the index is empty, we have no results
+	if (!p_index.IsEmpty())
 	{
 		// Figure out what index in the exerter subpopulation, if any, needs to be excluded so self-interaction is zero
 		slim_popsize_t excluded_index = (exerter_subpop == receiver->subpopulation_) ? receiver->index_ : -1;
 		
-		// We special-case Fixed kernel builds directly to strength values here, for efficiency,
-		// with no callbacks and spatiality "xy". Other kernels use the two-pass path below
-		// which enables SIMD optimizations for Exponential and Normal kernels.
+		// We special-case Fixed kernel builds directly to strength values here, for efficiency, with no callbacks.
+		// Other kernels use the two-pass path below, which enables SIMD optimizations for Exponential and Normal kernels.
 		// ADK 12/16/2025: changed to only use special-case path for Fixed kernel
-		if ((interaction_callbacks.size() == 0) && (spatiality_ == 2) && (if_type_ == SpatialKernelType::kFixed))
+		if ((interaction_callbacks.size() == 0) && (if_type_ == SpatialKernelType::kFixed))
 		{
 			sv->SetDataType(SparseVectorDataType::kStrengths);
-			BuildSV_Strengths_f_2(kd_root, receiver_position, excluded_index, sv, 0);
-			sv->Finished();
-			return;
-		}
-
-		// ADK 12/16/2025: The original switch below handled all kernel types in the special-case
-		// single-pass path. Now only Fixed uses the special path above; other kernels fall
-		// through to the two-pass distance-then-transform path, enabling SIMD optimizations.
-#if 0
-		if ((interaction_callbacks.size() == 0) && (spatiality_ == 2))
-		{
-			sv->SetDataType(SparseVectorDataType::kStrengths);
-
-			switch (if_type_)
-			{
-				case SpatialKernelType::kFixed:			BuildSV_Strengths_f_2(kd_root, receiver_position, excluded_index, sv, 0); break;
-				case SpatialKernelType::kLinear:		BuildSV_Strengths_l_2(kd_root, receiver_position, excluded_index, sv, 0); break;
-				case SpatialKernelType::kExponential:	BuildSV_Strengths_e_2(kd_root, receiver_position, excluded_index, sv, 0); break;
-				case SpatialKernelType::kNormal:		BuildSV_Strengths_n_2(kd_root, receiver_position, excluded_index, sv, 0); break;
-				case SpatialKernelType::kCauchy:		BuildSV_Strengths_c_2(kd_root, receiver_position, excluded_index, sv, 0); break;
-				case SpatialKernelType::kStudentsT:		BuildSV_Strengths_t_2(kd_root, receiver_position, excluded_index, sv, 0); break;
-				default:
-					EIDOS_TERMINATION << "ERROR (InteractionType::FillSparseVectorForReceiverStrengths): (internal error) unoptimized SpatialKernelType value." << EidosTerminate();
-			}
-
+			BuildSV_Strengths_f(p_index, receiver_position, excluded_index, sv);
 			sv->Finished();
 			return;
 		}
-#endif
-
+		
 		// Set up to build distances first; this is an internal implementation detail, so we require the sparse vector set up for strengths above
 		sv->SetDataType(SparseVectorDataType::kDistances);
 		
-		if (spatiality_ == 2)		BuildSV_Distances_2(kd_root, receiver_position, excluded_index, sv, 0);
-		else if (spatiality_ == 1)	BuildSV_Distances_1(kd_root, receiver_position, excluded_index, sv);
-		else if (spatiality_ == 3)	BuildSV_Distances_3(kd_root, receiver_position, excluded_index, sv, 0);
+		BuildSV_Distances(p_index, receiver_position, excluded_index, sv);
 	}
 	
 	// After building the sparse vector above, we mark it finished
@@ -2985,374 +2658,413 @@ void InteractionType::FillSparseVectorForReceiverStrengths(SparseVector *sv, Ind
 #pragma mark k-d tree neighbor searches
 #pragma mark -
 
-// count neighbors in 1D
-int InteractionType::CountNeighbors_1(SLiM_kdNode *root, double *nd, slim_popsize_t p_focal_individual_index)
+template <const int f_spatiality>
+static inline __attribute__((always_inline)) double KDNodeDistanceSquared(const SLiM_kdNode *p_node, const double *p_point)
 {
-	int neighborCount = 0;
-	double d = dist_sq1(root, nd);
 #ifndef __clang_analyzer__
-	double dx = root->x[0] - nd[0];
-#else
-	double dx = 0.0;
-#endif
-	double dx2 = dx * dx;
+	double t = p_node->x[0] - p_point[0];
+	double d = t * t;
 	
-	if ((d <= max_distance_sq_) && (root->individual_index_ != p_focal_individual_index))
-		neighborCount++;
-	
-	if (dx > 0)
+	if (f_spatiality >= 2)
 	{
-		if (root->left)
-			neighborCount += CountNeighbors_1(root->left, nd, p_focal_individual_index);
-		
-		if (dx2 > max_distance_sq_) return neighborCount;
-		
-		if (root->right)
-			neighborCount += CountNeighbors_1(root->right, nd, p_focal_individual_index);
+		t = p_node->x[1] - p_point[1];
+		d += t * t;
 	}
-	else
+	if (f_spatiality >= 3)
 	{
-		if (root->right)
-			neighborCount += CountNeighbors_1(root->right, nd, p_focal_individual_index);
-		
-		if (dx2 > max_distance_sq_) return neighborCount;
-		
-		if (root->left)
-			neighborCount += CountNeighbors_1(root->left, nd, p_focal_individual_index);
+		t = p_node->x[2] - p_point[2];
+		d += t * t;
 	}
 	
-	return neighborCount;
-}
-
-// count neighbors in 2D
-int InteractionType::CountNeighbors_2(SLiM_kdNode *root, double *nd, slim_popsize_t p_focal_individual_index, int p_phase)
-{
-	int neighborCount = 0;
-	double d = dist_sq2(root, nd);
-#ifndef __clang_analyzer__
-	double dx = root->x[p_phase] - nd[p_phase];
+	return d;
 #else
-	double dx = 0.0;
+	return 0.0;
 #endif
-	double dx2 = dx * dx;
-	
-	if ((d <= max_distance_sq_) && (root->individual_index_ != p_focal_individual_index))
-		neighborCount++;
-	
-	if (++p_phase >= 2) p_phase = 0;
-	
-	if (dx > 0)
-	{
-		if (root->left)
-			neighborCount += CountNeighbors_2(root->left, nd, p_focal_individual_index, p_phase);
-		
-		if (dx2 > max_distance_sq_) return neighborCount;
-		
-		if (root->right)
-			neighborCount += CountNeighbors_2(root->right, nd, p_focal_individual_index, p_phase);
-	}
-	else
-	{
-		if (root->right)
-			neighborCount += CountNeighbors_2(root->right, nd, p_focal_individual_index, p_phase);
-		
-		if (dx2 > max_distance_sq_) return neighborCount;
-		
-		if (root->left)
-			neighborCount += CountNeighbors_2(root->left, nd, p_focal_individual_index, p_phase);
-	}
-	
-	return neighborCount;
 }
 
-// count neighbors in 3D
-int InteractionType::CountNeighbors_3(SLiM_kdNode *root, double *nd, slim_popsize_t p_focal_individual_index, int p_phase)
+// A subtree waiting to be searched, on the stack used by the k-d tree searches below
+struct _SLiM_kdSearchRange
 {
-	int neighborCount = 0;
-	double d = dist_sq3(root, nd);
+	slim_popsize_t start_;		// the index of the first node of the subtree
+	slim_popsize_t count_;		// the number of nodes in the subtree
+	int phase_;					// the axis along which the subtree is split
+	double split_dist_sq_;		// the squared distance from the search point to the split that put this subtree on the far side
+};
+typedef struct _SLiM_kdSearchRange SLiM_kdSearchRange;
+
+// the stack depth needed to search a k-d tree; a balanced tree only needs one entry per level, and 2^31 nodes make 32 levels
+#define SLIM_KDTREE_MAX_SEARCH_DEPTH	64
+
+template <const int f_spatiality, typename F>
+void InteractionType::VisitKDTreeNeighbors(const SLiM_kdNode *p_nodes, slim_popsize_t p_node_count, double *nd, slim_popsize_t p_focal_individual_index, F p_visitor)
+{
+	// We descend from each node into the subtree on the same side of its split as nd, pushing the subtree on the far side onto a
+	// stack if the split is within the max distance, and then pop the far subtrees back off when we reach the bottom.  That visits
+	// the nodes in the same order as the recursive search that this replaced: each node, then its near subtree, then its far subtree.
+	SLiM_kdSearchRange stack[SLIM_KDTREE_MAX_SEARCH_DEPTH];
+	int stack_size = 0;
+	slim_popsize_t start = 0, count = p_node_count;
+	int phase = 0;
+	
+	while (true)
+	{
+		while (count > 0)
+		{
+			slim_popsize_t left_count = count / 2;
+			const SLiM_kdNode *node = p_nodes + start + left_count;
+			double d = KDNodeDistanceSquared<f_spatiality>(node, nd);
 #ifndef __clang_analyzer__
-	double dx = root->x[p_phase] - nd[p_phase];
+			double dx = node->x[phase] - nd[phase];
 #else
-	double dx = 0.0;
+			double dx = 0.0;
 #endif
-	double dx2 = dx * dx;
-	
-	if ((d <= max_distance_sq_) && (root->individual_index_ != p_focal_individual_index))
-		neighborCount++;
-	
-	if (++p_phase >= 3) p_phase = 0;
-	
-	if (dx > 0)
-	{
-		if (root->left)
-			neighborCount += CountNeighbors_3(root->left, nd, p_focal_individual_index, p_phase);
-		
-		if (dx2 > max_distance_sq_) return neighborCount;
+			bool far_side_in_range = !(dx * dx > max_distance_sq_);		// written this way so NaN does not prune, as before
+			int next_phase = ((phase + 1 < f_spatiality) ? phase + 1 : 0);
+			slim_popsize_t right_start = start + left_count + 1;
+			slim_popsize_t right_count = count - left_count - 1;
+			
+			if ((d <= max_distance_sq_) && (node->individual_index_ != p_focal_individual_index))
+				p_visitor(node->individual_index_, d);
+			
+			if (dx > 0)
+			{
+				if (far_side_in_range && right_count)
+					stack[stack_size++] = SLiM_kdSearchRange{right_start, right_count, next_phase, 0.0};
+				
+				count = left_count;
+			}
+			else
+			{
+				if (far_side_in_range && left_count)
+					stack[stack_size++] = SLiM_kdSearchRange{start, left_count, next_phase, 0.0};
+				
+				start = right_start;
+				count = right_count;
+			}
+			
+			phase = next_phase;
+		}
 		
-		if (root->right)
-			neighborCount += CountNeighbors_3(root->right, nd, p_focal_individual_index, p_phase);
-	}
-	else
-	{
-		if (root->right)
-			neighborCount += CountNeighbors_3(root->right, nd, p_focal_individual_index, p_phase);
+		if (stack_size == 0)
+			break;
 		
-		if (dx2 > max_distance_sq_) return neighborCount;
+		const SLiM_kdSearchRange &far_side = stack[--stack_size];
 		
-		if (root->left)
-			neighborCount += CountNeighbors_3(root->left, nd, p_focal_individual_index, p_phase);
+		start = far_side.start_;
+		count = far_side.count_;
+		phase = far_side.phase_;
 	}
-	
-	return neighborCount;
 }
 
-// find the one best neighbor in 1D
-void InteractionType::FindNeighbors1_1(SLiM_kdNode *root, double *nd, slim_popsize_t p_focal_individual_index, SLiM_kdNode **best, double *best_dist)
+template <const int f_spatiality>
+void InteractionType::FindNearestKDTreeNeighbor(const SLiM_kdNode *p_nodes, slim_popsize_t p_node_count, double *nd, slim_popsize_t p_focal_individual_index, slim_popsize_t *p_best, double *p_best_dist)
 {
-	double d = dist_sq1(root, nd);
+	// This is like VisitKDTreeNeighbors(), except that it does not enforce the max distance; the caller does that.  Far subtrees are
+	// pruned when they are popped, with the best distance found by then, rather than when they are pushed.  Nothing is pruned until
+	// a best neighbor has been found; previously a far subtree could be skipped before then, missing the nearest neighbor.
+	SLiM_kdSearchRange stack[SLIM_KDTREE_MAX_SEARCH_DEPTH];
+	int stack_size = 0;
+	slim_popsize_t start = 0, count = p_node_count;
+	int phase = 0;
+	
+	while (true)
+	{
+		while (count > 0)
+		{
+			slim_popsize_t left_count = count / 2;
+			const SLiM_kdNode *node = p_nodes + start + left_count;
+			double d = KDNodeDistanceSquared<f_spatiality>(node, nd);
 #ifndef __clang_analyzer__
-	double dx = root->x[0] - nd[0];
+			double dx = node->x[phase] - nd[phase];
 #else
-	double dx = 0.0;
+			double dx = 0.0;
 #endif
-	double dx2 = dx * dx;
-	
-	if ((!*best || d < *best_dist) && (root->individual_index_ != p_focal_individual_index)) {
-		*best_dist = d;
-		*best = root;
-	}
-	
-	if (dx > 0)
-	{
-		if (root->left)
-			FindNeighbors1_1(root->left, nd, p_focal_individual_index, best, best_dist);
-		
-		if (dx2 >= *best_dist) return;
-		
-		if (root->right)
-			FindNeighbors1_1(root->right, nd, p_focal_individual_index, best, best_dist);
-	}
-	else
-	{
-		if (root->right)
-			FindNeighbors1_1(root->right, nd, p_focal_individual_index, best, best_dist);
+			int next_phase = ((phase + 1 < f_spatiality) ? phase + 1 : 0);
+			slim_popsize_t right_start = start + left_count + 1;
+			slim_popsize_t right_count = count - left_count - 1;
+			
+			if (((*p_best == -1) || (d < *p_best_dist)) && (node->individual_index_ != p_focal_individual_index))
+			{
+				*p_best_dist = d;
+				*p_best = node->individual_index_;
+			}
+			
+			if (dx > 0)
+			{
+				if (right_count)
+					stack[stack_size++] = SLiM_kdSearchRange{right_start, right_count, next_phase, dx * dx};
+				
+				count = left_count;
+			}
+			else
+			{
+				if (left_count)
+					stack[stack_size++] = SLiM_kdSearchRange{start, left_count, next_phase, dx * dx};
+				
+				start = right_start;
+				count = right_count;
+			}
+			
+			phase = next_phase;
+		}
 		
-		if (dx2 >= *best_dist) return;
+		// pop far subtrees until we find one that might contain something closer than the best so far
+		while (stack_size > 0)
+		{
+			const SLiM_kdSearchRange &far_side = stack[--stack_size];
+			
+			if ((*p_best != -1) && (far_side.split_dist_sq_ >= *p_best_dist))
+				continue;
+			
+			start = far_side.start_;
+			count = far_side.count_;
+			phase = far_side.phase_;
+			break;
+		}
 		
-		if (root->left)
-			FindNeighbors1_1(root->left, nd, p_focal_individual_index, best, best_dist);
+		if (count == 0)
+			break;
 	}
 }
 
-// find the one best neighbor in 2D
-void InteractionType::FindNeighbors1_2(SLiM_kdNode *root, double *nd, slim_popsize_t p_focal_individual_index, SLiM_kdNode **best, double *best_dist, int p_phase)
+
+#pragma mark -
+#pragma mark cell grid neighbor searches
+#pragma mark -
+
+// Wrap an "unwrapped" cell index along one dimension of a cell grid back into the grid, giving the coordinate offset of that image of
+// the cell; returns false if the index is outside the grid along a non-periodic dimension, or more than one period away along a periodic
+// one.  Images one period away correspond to the replicates made by BuildKDTree() for the k-d tree, with identical coordinates.
+static inline __attribute__((always_inline)) bool WrapCellGridIndex(int p_index, int p_count, double p_period, int *p_cell, double *p_offset)
 {
-	double d = dist_sq2(root, nd);
-#ifndef __clang_analyzer__
-	double dx = root->x[p_phase] - nd[p_phase];
-#else
-	double dx = 0.0;
-#endif
-	double dx2 = dx * dx;
-	
-	if ((!*best || d < *best_dist) && (root->individual_index_ != p_focal_individual_index)) {
-		*best_dist = d;
-		*best = root;
+	if ((p_index >= 0) && (p_index < p_count))
+	{
+		*p_cell = p_index;
+		*p_offset = 0.0;
+		return true;
 	}
 	
-	if (++p_phase >= 2) p_phase = 0;
+	if (p_period == 0.0)
+		return false;
 	
-	if (dx > 0)
+	if ((p_index < 0) && (p_index >= -p_count))
 	{
-		if (root->left)
-			FindNeighbors1_2(root->left, nd, p_focal_individual_index, best, best_dist, p_phase);
-		
-		if (dx2 >= *best_dist) return;
-		
-		if (root->right)
-			FindNeighbors1_2(root->right, nd, p_focal_individual_index, best, best_dist, p_phase);
+		*p_cell = p_index + p_count;
+		*p_offset = -p_period;
+		return true;
 	}
-	else
+	
+	if ((p_index >= p_count) && (p_index < 2 * p_count))
 	{
-		if (root->right)
-			FindNeighbors1_2(root->right, nd, p_focal_individual_index, best, best_dist, p_phase);
-		
-		if (dx2 >= *best_dist) return;
-		
-		if (root->left)
-			FindNeighbors1_2(root->left, nd, p_focal_individual_index, best, best_dist, p_phase);
+		*p_cell = p_index - p_count;
+		*p_offset = p_period;
+		return true;
 	}
+	
+	return false;
 }
 
-// find the one best neighbor in 3D
-void InteractionType::FindNeighbors1_3(SLiM_kdNode *root, double *nd, slim_popsize_t p_focal_individual_index, SLiM_kdNode **best, double *best_dist, int p_phase)
+template <const int f_spatiality, typename F>
+void InteractionType::VisitCellGridNeighbors(const SLiM_CellGrid *p_grid, double *nd, slim_popsize_t p_focal_individual_index, F p_visitor)
 {
-	double d = dist_sq3(root, nd);
-#ifndef __clang_analyzer__
-	double dx = root->x[p_phase] - nd[p_phase];
-#else
-	double dx = 0.0;
-#endif
-	double dx2 = dx * dx;
-	
-	if ((!*best || d < *best_dist) && (root->individual_index_ != p_focal_individual_index)) {
-		*best_dist = d;
-		*best = root;
-	}
-	
-	if (++p_phase >= 3) p_phase = 0;
+	// Find the range of cells to scan along each dimension: the cell containing nd, and its neighbors on each side.  Along periodic
+	// dimensions these are unwrapped cell indices, which may lie outside the grid; they get wrapped by WrapCellGridIndex() below.
+	int lo[SLIM_MAX_DIMENSIONALITY] = {0, 0, 0}, hi[SLIM_MAX_DIMENSIONALITY] = {0, 0, 0};
 	
-	if (dx > 0)
+	for (int d = 0; d < f_spatiality; ++d)
 	{
-		if (root->left)
-			FindNeighbors1_3(root->left, nd, p_focal_individual_index, best, best_dist, p_phase);
+		int count = p_grid->cell_count_[d];
+		double c = std::floor((nd[d] - p_grid->origin_[d]) * p_grid->inv_cell_width_[d]);
 		
-		if (dx2 >= *best_dist) return;
-		
-		if (root->right)
-			FindNeighbors1_3(root->right, nd, p_focal_individual_index, best, best_dist, p_phase);
-	}
-	else
-	{
-		if (root->right)
-			FindNeighbors1_3(root->right, nd, p_focal_individual_index, best, best_dist, p_phase);
+		// points far outside the grid have no neighbors in it; clamping them (and NaN) keeps the conversion to int safe
+		if (!(c >= -2.0))
+			c = -2.0;
+		else if (c > count + 1)
+			c = count + 1;
 		
-		if (dx2 >= *best_dist) return;
+		lo[d] = (int)c - 1;
+		hi[d] = (int)c + 1;
 		
-		if (root->left)
-			FindNeighbors1_3(root->left, nd, p_focal_individual_index, best, best_dist, p_phase);
+		if (p_grid->period_[d] == 0.0)
+		{
+			lo[d] = std::max(lo[d], 0);
+			hi[d] = std::min(hi[d], count - 1);
+		}
 	}
-}
-
-// find all neighbors in 1D
-void InteractionType::FindNeighborsA_1(SLiM_kdNode *root, double *nd, slim_popsize_t p_focal_individual_index, EidosValue_Object &p_result_vec, std::vector<Individual *> &p_individuals)
-{
-	double d = dist_sq1(root, nd);
-#ifndef __clang_analyzer__
-	double dx = root->x[0] - nd[0];
-#else
-	double dx = 0.0;
-#endif
-	double dx2 = dx * dx;
 	
-	if ((d <= max_distance_sq_) && (root->individual_index_ != p_focal_individual_index))
-		p_result_vec.push_object_element_capcheck_NORR(p_individuals[root->individual_index_]);
+	const uint32_t *cell_starts = p_grid->cell_starts_;
+	const SLiM_gridPoint *points = p_grid->points_;
+	int count_x = p_grid->cell_count_[0], count_y = p_grid->cell_count_[1], count_z = p_grid->cell_count_[2];
 	
-	if (dx > 0)
-	{
-		if (root->left)
-			FindNeighborsA_1(root->left, nd, p_focal_individual_index, p_result_vec, p_individuals);
-		
-		if (dx2 > max_distance_sq_) return;
-		
-		if (root->right)
-			FindNeighborsA_1(root->right, nd, p_focal_individual_index, p_result_vec, p_individuals);
-	}
-	else
+	for (int k = lo[2]; k <= hi[2]; ++k)
 	{
-		if (root->right)
-			FindNeighborsA_1(root->right, nd, p_focal_individual_index, p_result_vec, p_individuals);
+		int cell_z;
+		double offset_z;
 		
-		if (dx2 > max_distance_sq_) return;
+		if (!WrapCellGridIndex(k, count_z, p_grid->period_[2], &cell_z, &offset_z))
+			continue;
 		
-		if (root->left)
-			FindNeighborsA_1(root->left, nd, p_focal_individual_index, p_result_vec, p_individuals);
+		for (int j = lo[1]; j <= hi[1]; ++j)
+		{
+			int cell_y;
+			double offset_y;
+			
+			if (!WrapCellGridIndex(j, count_y, p_grid->period_[1], &cell_y, &offset_y))
+				continue;
+			
+			size_t row = ((size_t)cell_z * count_y + cell_y) * count_x;
+			
+			for (int i = lo[0]; i <= hi[0]; ++i)
+			{
+				int cell_x;
+				double offset_x;
+				
+				if (!WrapCellGridIndex(i, count_x, p_grid->period_[0], &cell_x, &offset_x))
+					continue;
+				
+				size_t cell = row + cell_x;
+				const SLiM_gridPoint *point = points + cell_starts[cell];
+				const SLiM_gridPoint *cell_end = points + cell_starts[cell + 1];
+				
+				for ( ; point < cell_end; ++point)
+				{
+					double t = (point->x[0] + offset_x) - nd[0];
+					double d = t * t;
+					
+					if (f_spatiality >= 2)
+					{
+						t = (point->x[1] + offset_y) - nd[1];
+						d += t * t;
+					}
+					if (f_spatiality >= 3)
+					{
+						t = (point->x[2] + offset_z) - nd[2];
+						d += t * t;
+					}
+					
+					if ((d <= max_distance_sq_) && (point->individual_index_ != p_focal_individual_index))
+						p_visitor(point->individual_index_, d);
+				}
+			}
+		}
 	}
 }
 
-// find all neighbors in 2D
-void InteractionType::FindNeighborsA_2(SLiM_kdNode *root, double *nd, slim_popsize_t p_focal_individual_index, EidosValue_Object &p_result_vec, std::vector<Individual *> &p_individuals, int p_phase)
+#pragma mark -
+#pragma mark spatial index neighbor searches
+#pragma mark -
+
+template <typename F>
+void InteractionType::VisitNeighbors(const SLiM_SpatialIndex &p_index, double *nd, slim_popsize_t p_focal_individual_index, F p_visitor)
 {
-	double d = dist_sq2(root, nd);
-#ifndef __clang_analyzer__
-	double dx = root->x[p_phase] - nd[p_phase];
-#else
-	double dx = 0.0;
-#endif
-	double dx2 = dx * dx;
-	
-	if ((d <= max_distance_sq_) && (root->individual_index_ != p_focal_individual_index))
-		p_result_vec.push_object_element_capcheck_NORR(p_individuals[root->individual_index_]);
-	
-	if (++p_phase >= 2) p_phase = 0;
-	
-	if (dx > 0)
+	if (p_index.cell_grid_)
 	{
-		if (root->left)
-			FindNeighborsA_2(root->left, nd, p_focal_individual_index, p_result_vec, p_individuals, p_phase);
-		
-		if (dx2 > max_distance_sq_) return;
-		
-		if (root->right)
-			FindNeighborsA_2(root->right, nd, p_focal_individual_index, p_result_vec, p_individuals, p_phase);
+		switch (spatiality_)
+		{
+			case 1: VisitCellGridNeighbors<1>(p_index.cell_grid_, nd, p_focal_individual_index, p_visitor);	break;
+			case 2: VisitCellGridNeighbors<2>(p_index.cell_grid_, nd, p_focal_individual_index, p_visitor);	break;
+			case 3: VisitCellGridNeighbors<3>(p_index.cell_grid_, nd, p_focal_individual_index, p_visitor);	break;
+			default: break;
+		}
 	}
-	else
+	else if (p_index.kd_nodes_)
 	{
-		if (root->right)
-			FindNeighborsA_2(root->right, nd, p_focal_individual_index, p_result_vec, p_individuals, p_phase);
-		
-		if (dx2 > max_distance_sq_) return;
-		
-		if (root->left)
-			FindNeighborsA_2(root->left, nd, p_focal_individual_index, p_result_vec, p_individuals, p_phase);
+		switch (spatiality_)
+		{
+			case 1: VisitKDTreeNeighbors<1>(p_index.kd_nodes_, p_index.node_count_, nd, p_focal_individual_index, p_visitor);	break;
+			case 2: VisitKDTreeNeighbors<2>(p_index.kd_nodes_, p_index.node_count_, nd, p_focal_individual_index, p_visitor);	break;
+			case 3: VisitKDTreeNeighbors<3>(p_index.kd_nodes_, p_index.node_count_, nd, p_focal_individual_index, p_visitor);	break;
+			default: break;
+		}
 	}
 }
 
-// find all neighbors in 3D
-void InteractionType::FindNeighborsA_3(SLiM_kdNode *root, double *nd, slim_popsize_t p_focal_individual_index, EidosValue_Object &p_result_vec, std::vector<Individual *> &p_individuals, int p_phase)
+// add neighbors to the sparse vector
+void InteractionType::BuildSV_Presences(const SLiM_SpatialIndex &p_index, double *nd, slim_popsize_t p_focal_individual_index, SparseVector *p_sparse_vector)
 {
-	double d = dist_sq3(root, nd);
-#ifndef __clang_analyzer__
-	double dx = root->x[p_phase] - nd[p_phase];
-#else
-	double dx = 0.0;
-#endif
-	double dx2 = dx * dx;
+	VisitNeighbors(p_index, nd, p_focal_individual_index, [p_sparse_vector](slim_popsize_t p_individual_index, double) { p_sparse_vector->AddEntryPresence(p_individual_index); });
+}
+
+// add neighbor distances to the sparse vector
+void InteractionType::BuildSV_Distances(const SLiM_SpatialIndex &p_index, double *nd, slim_popsize_t p_focal_individual_index, SparseVector *p_sparse_vector)
+{
+	VisitNeighbors(p_index, nd, p_focal_individual_index, [p_sparse_vector](slim_popsize_t p_individual_index, double p_distance_sq) { p_sparse_vector->AddEntryDistance(p_individual_index, (sv_value_t)sqrt(p_distance_sq)); });
+}
+
+// add neighbor strengths of type "f" (SpatialKernelType::kFixed : fixed) to the sparse vector
+void InteractionType::BuildSV_Strengths_f(const SLiM_SpatialIndex &p_index, double *nd, slim_popsize_t p_focal_individual_index, SparseVector *p_sparse_vector)
+{
+	sv_value_t strength = (sv_value_t)if_param1_;
 	
-	if ((d <= max_distance_sq_) && (root->individual_index_ != p_focal_individual_index))
-		p_result_vec.push_object_element_capcheck_NORR(p_individuals[root->individual_index_]);
+	VisitNeighbors(p_index, nd, p_focal_individual_index, [p_sparse_vector, strength](slim_popsize_t p_individual_index, double) { p_sparse_vector->AddEntryStrength(p_individual_index, strength); });
+}
+
+// count neighbors
+int InteractionType::CountNeighbors(const SLiM_SpatialIndex &p_index, double *nd, slim_popsize_t p_focal_individual_index)
+{
+	int neighborCount = 0;
 	
-	if (++p_phase >= 3) p_phase = 0;
+	VisitNeighbors(p_index, nd, p_focal_individual_index, [&neighborCount](slim_popsize_t, double) { neighborCount++; });
 	
-	if (dx > 0)
+	return neighborCount;
+}
+
+// find the one best neighbor; with a k-d tree this does not enforce the max distance, so the caller must
+void InteractionType::FindNeighbors1(const SLiM_SpatialIndex &p_index, double *nd, slim_popsize_t p_focal_individual_index, slim_popsize_t *best, double *best_dist)
+{
+	if (p_index.cell_grid_)
 	{
-		if (root->left)
-			FindNeighborsA_3(root->left, nd, p_focal_individual_index, p_result_vec, p_individuals, p_phase);
-		
-		if (dx2 > max_distance_sq_) return;
+		auto visitor = [best, best_dist](slim_popsize_t p_individual_index, double p_distance_sq) {
+			if ((*best == -1) || (p_distance_sq < *best_dist))
+			{
+				*best_dist = p_distance_sq;
+				*best = p_individual_index;
+			}
+		};
 		
-		if (root->right)
-			FindNeighborsA_3(root->right, nd, p_focal_individual_index, p_result_vec, p_individuals, p_phase);
+		switch (spatiality_)
+		{
+			case 1: VisitCellGridNeighbors<1>(p_index.cell_grid_, nd, p_focal_individual_index, visitor);	break;
+			case 2: VisitCellGridNeighbors<2>(p_index.cell_grid_, nd, p_focal_individual_index, visitor);	break;
+			case 3: VisitCellGridNeighbors<3>(p_index.cell_grid_, nd, p_focal_individual_index, visitor);	break;
+			default: break;
+		}
 	}
-	else
+	else if (p_index.kd_nodes_)
 	{
-		if (root->right)
-			FindNeighborsA_3(root->right, nd, p_focal_individual_index, p_result_vec, p_individuals, p_phase);
-		
-		if (dx2 > max_distance_sq_) return;
-		
-		if (root->left)
-			FindNeighborsA_3(root->left, nd, p_focal_individual_index, p_result_vec, p_individuals, p_phase);
+		switch (spatiality_)
+		{
+			case 1: FindNearestKDTreeNeighbor<1>(p_index.kd_nodes_, p_index.node_count_, nd, p_focal_individual_index, best, best_dist);	break;
+			case 2: FindNearestKDTreeNeighbor<2>(p_index.kd_nodes_, p_index.node_count_, nd, p_focal_individual_index, best, best_dist);	break;
+			case 3: FindNearestKDTreeNeighbor<3>(p_index.kd_nodes_, p_index.node_count_, nd, p_focal_individual_index, best, best_dist);	break;
+			default: break;
+		}
 	}
 }
 
+// find all neighbors
+void InteractionType::FindNeighborsA(const SLiM_SpatialIndex &p_index, double *nd, slim_popsize_t p_focal_individual_index, EidosValue_Object &p_result_vec, std::vector<Individual *> &p_individuals)
+{
+	VisitNeighbors(p_index, nd, p_focal_individual_index, [&p_result_vec, &p_individuals](slim_popsize_t p_individual_index, double) { p_result_vec.push_object_element_capcheck_NORR(p_individuals[p_individual_index]); });
+}
+
 // BCH 5/24/2023: Here used to reside FindNeighborsN_1(), FindNeighborsN_2(), and FindNeighborsN_3(),
 // used for finding a particular number of neighbors (N), greater than 1 and less than all, in 1D / 2D / 3D.
 // They were not thread-safe, and were replaced by FillSparseVectorForReceiverDistances_ALL_NEIGHBORS();
 // now (11/2/2023) that has turned into FillSparseVectorForReceiverDistances() using kd_root_ALL_, below.
 
-void InteractionType::FindNeighbors(Subpopulation *p_subpop, SLiM_kdNode *kd_root, slim_popsize_t kd_node_count, double *p_point, int p_count, EidosValue_Object &p_result_vec, Individual *p_excluded_individual, bool constraints_active)
+void InteractionType::FindNeighbors(Subpopulation *p_subpop, const SLiM_SpatialIndex &p_index, double *p_point, int p_count, EidosValue_Object &p_result_vec, Individual *p_excluded_individual, bool constraints_active)
 {
-	// If this method is passed kd_root_ALL_, from EnsureKDTreePresent_ALL(), it finds all neighbors, regardless
-	// of exerter constraints.  If it is passed kd_root_EXERTERS_, from EnsureKDTreePresent_EXERTERS(), it finds
+	// If this method is passed an index from EnsureSpatialIndexPresent_ALL(), it finds all neighbors, regardless
+	// of exerter constraints.  If it is passed an index from EnsureSpatialIndexPresent_EXERTERS(), it finds
 	// only neighbors that satisfy the exerter constraints.
 	
 	if (spatiality_ == 0)
 		EIDOS_TERMINATION << "ERROR (InteractionType::FindNeighbors): (internal error) neighbors cannot be found for non-spatial interactions." << EidosTerminate();
 	
-	// If zero neighbors are requested, or if the k-d tree root is nullptr (no nodes), return an empty result
+	// If zero neighbors are requested, or if the index is empty (no nodes), return an empty result
 	// BCH 11/2/2023: returning an empty result for !kd_root is a change in behavior; we used to throw an exception.
-	if (!kd_root || (p_count == 0))
+	if (p_index.IsEmpty() || (p_count == 0))
 		return;
 	
 	// Exclude the focal individual if and only if it is in the exerter subpopulation
@@ -3366,36 +3078,28 @@ void InteractionType::FindNeighbors(Subpopulation *p_subpop, SLiM_kdNode *kd_roo
 	if (p_count == 1)
 	{
 		// Finding a single nearest neighbor is special-cased, and does not enforce the max distance; we do that after
-		SLiM_kdNode *best = nullptr;
+		slim_popsize_t best_index = -1;
 		double best_dist = 0.0;
 		
-		switch (spatiality_)
-		{
-			case 1: FindNeighbors1_1(kd_root, p_point, focal_individual_index, &best, &best_dist);		break;
-			case 2: FindNeighbors1_2(kd_root, p_point, focal_individual_index, &best, &best_dist, 0);	break;
-			case 3: FindNeighbors1_3(kd_root, p_point, focal_individual_index, &best, &best_dist, 0);	break;
-			default:
-				EIDOS_TERMINATION << "ERROR (InteractionType::FindNeighbors): (internal error) spatiality_ out of range." << EidosTerminate(nullptr);
-		}
+		if ((spatiality_ < 1) || (spatiality_ > 3))
+			EIDOS_TERMINATION << "ERROR (InteractionType::FindNeighbors): (internal error) spatiality_ out of range." << EidosTerminate(nullptr);
+		
+		FindNeighbors1(p_index, p_point, focal_individual_index, &best_index, &best_dist);
 		
-		if (best && (best_dist <= max_distance_sq_))
+		if ((best_index != -1) && (best_dist <= max_distance_sq_))
 		{
-			Individual *best_individual = p_subpop->parent_individuals_[best->individual_index_];
+			Individual *best_individual = p_subpop->parent_individuals_[best_index];
 			
 			p_result_vec.push_object_element_NORR(best_individual);
 		}
 	}
-	else if (p_count >= kd_node_count)	// can't do (kd_node_count - 1), because the focal individual might not be among the nodes in the k-d tree
+	else if (p_count >= p_index.node_count_)	// can't do (node_count_ - 1), because the focal individual might not be among the nodes in the index
 	{
 		// Finding all neighbors within the interaction distance is special-cased
-		switch (spatiality_)
-		{
-			case 1: FindNeighborsA_1(kd_root, p_point, focal_individual_index, p_result_vec, p_subpop->parent_individuals_);		break;
-			case 2: FindNeighborsA_2(kd_root, p_point, focal_individual_index, p_result_vec, p_subpop->parent_individuals_, 0);		break;
-			case 3: FindNeighborsA_3(kd_root, p_point, focal_individual_index, p_result_vec, p_subpop->parent_individuals_, 0);		break;
-			default:
-				EIDOS_TERMINATION << "ERROR (InteractionType::FindNeighbors): (internal error) spatiality_ out of range." << EidosTerminate(nullptr);
-		}
+		if ((spatiality_ < 1) || (spatiality_ > 3))
+			EIDOS_TERMINATION << "ERROR (InteractionType::FindNeighbors): (internal error) spatiality_ out of range." << EidosTerminate(nullptr);
+		
+		FindNeighborsA(p_index, p_point, focal_individual_index, p_result_vec, p_subpop->parent_individuals_);
 	}
 	else
 	{
@@ -3406,9 +3110,9 @@ void InteractionType::FindNeighbors(Subpopulation *p_subpop, SLiM_kdNode *kd_roo
 		
 		try {
 			if (p_excluded_individual)
-				FillSparseVectorForReceiverDistances(sv, p_excluded_individual, p_point, p_subpop, kd_root, constraints_active);
+				FillSparseVectorForReceiverDistances(sv, p_excluded_individual, p_point, p_subpop, p_index, constraints_active);
 			else
-				FillSparseVectorForPointDistances(sv, p_point, p_subpop, kd_root);
+				FillSparseVectorForPointDistances(sv, p_point, p_subpop, p_index);
 			
 			uint32_t nnz;
 			const uint32_t *columns;
@@ -3580,6 +3284,9 @@ void InteractionType::SetProperty(EidosGlobalStringID p_property_id, const Eidos
 			// changing max_distance_ invalidates the cached clipped_integral_ buffer; we don't deallocate it, just invalidate it
 			clipped_integral_valid_ = false;
 			
+			// the kind of spatial index used depends upon max_distance_
+			ChooseSpatialIndexType();
+			
 			return;
 		}
 			
@@ -4334,12 +4041,12 @@ EidosValue_SP InteractionType::ExecuteMethod_drawByStrength(EidosGlobalStringID
 			// Spatial case; we use the k-d tree to get strengths for all neighbors.
 			InteractionsData &receiver_subpop_data = InteractionsDataForSubpop(data_, receiver_subpop);
 			double *receiver_position = receiver_subpop_data.positions_ + (size_t)receiver_index_in_subpop * SLIM_MAX_DIMENSIONALITY;
-			SLiM_kdNode *kd_root_EXERTERS = EnsureKDTreePresent_EXERTERS(exerter_subpop, exerter_subpop_data);
+			SLiM_SpatialIndex index_EXERTERS = EnsureSpatialIndexPresent_EXERTERS(exerter_subpop, exerter_subpop_data);
 			EidosValue_Object *result_vec = (new (gEidosValuePool->AllocateChunk()) EidosValue_Object(gSLiM_Individual_Class));
 			EidosValue_SP result_vec_SP(result_vec);
 			
 			// If there are no exerters satisfying constraints, short-circuit
-			if (!kd_root_EXERTERS)
+			if (index_EXERTERS.IsEmpty())
 				return result_vec_SP;
 			
 			if (optimize_fixed_interaction_strengths)
@@ -4348,7 +4055,7 @@ EidosValue_SP InteractionType::ExecuteMethod_drawByStrength(EidosGlobalStringID
 				SparseVector *sv = InteractionType::NewSparseVectorForExerterSubpop(exerter_subpop, SparseVectorDataType::kPresences);
 				
 				try {
-					FillSparseVectorForReceiverPresences(sv, receiver, receiver_position, exerter_subpop, kd_root_EXERTERS, /* constraints_active */ true);
+					FillSparseVectorForReceiverPresences(sv, receiver, receiver_position, exerter_subpop, index_EXERTERS, /* constraints_active */ true);
 					uint32_t nnz;
 					const uint32_t *columns;
 					
@@ -4386,7 +4093,7 @@ EidosValue_SP InteractionType::ExecuteMethod_drawByStrength(EidosGlobalStringID
 				SparseVector *sv = InteractionType::NewSparseVectorForExerterSubpop(exerter_subpop, SparseVectorDataType::kStrengths);
 				
 				try {
-					FillSparseVectorForReceiverStrengths(sv, receiver, receiver_position, exerter_subpop, kd_root_EXERTERS, exerter_subpop_data.evaluation_interaction_callbacks_);
+					FillSparseVectorForReceiverStrengths(sv, receiver, receiver_position, exerter_subpop, index_EXERTERS, exerter_subpop_data.evaluation_interaction_callbacks_);
 					uint32_t nnz;
 					const uint32_t *columns;
 					const sv_value_t *strengths;
@@ -4459,10 +4166,10 @@ EidosValue_SP InteractionType::ExecuteMethod_drawByStrength(EidosGlobalStringID
 		
 		if ((count > 0) && (exerter_subpop_size > 0))	// BCH 5/24/2023: if the exerter subpop is empty, no individuals are drawn; short-circuit
 		{
-			SLiM_kdNode *kd_root_EXERTERS = EnsureKDTreePresent_EXERTERS(exerter_subpop, exerter_subpop_data);
+			SLiM_SpatialIndex index_EXERTERS = EnsureSpatialIndexPresent_EXERTERS(exerter_subpop, exerter_subpop_data);
 			
 			// If there are no exerters satisfying constraints, short-circuit
-			if (!kd_root_EXERTERS)
+			if (index_EXERTERS.IsEmpty())
 			{
 				free(result_vectors);
 				return result_SP;
@@ -4473,7 +4180,7 @@ EidosValue_SP InteractionType::ExecuteMethod_drawByStrength(EidosGlobalStringID
 			Individual * const *receiver_data = (Individual * const *)receiver_value->ObjectData();
 			
 			EIDOS_THREAD_COUNT(gEidos_OMP_threads_DRAWBYSTRENGTH);
-#pragma omp parallel for schedule(dynamic, 16) default(none) shared(gEidos_RNG_PERTHREAD, receivers_count, receiver_subpop, exerter_subpop, receiver_subpop_data, exerter_subpop_data, kd_root_EXERTERS, optimize_fixed_interaction_strengths) firstprivate(receiver_data, result_vectors, count, exerter_subpop_size) reduction(||: saw_error_1) reduction(||: saw_error_2) reduction(||: saw_error_3) reduction(||: saw_error_4) if(!has_interaction_callbacks && (receivers_count >= EIDOS_OMPMIN_DRAWBYSTRENGTH)) num_threads(thread_count)
+#pragma omp parallel for schedule(dynamic, 16) default(none) shared(gEidos_RNG_PERTHREAD, receivers_count, receiver_subpop, exerter_subpop, receiver_subpop_data, exerter_subpop_data, index_EXERTERS, optimize_fixed_interaction_strengths) firstprivate(receiver_data, result_vectors, count, exerter_subpop_size) reduction(||: saw_error_1) reduction(||: saw_error_2) reduction(||: saw_error_3) reduction(||: saw_error_4) if(!has_interaction_callbacks && (receivers_count >= EIDOS_OMPMIN_DRAWBYSTRENGTH)) num_threads(thread_count)
 			for (int receiver_index = 0; receiver_index < receivers_count; ++receiver_index)
 			{
 				Individual *receiver = (Individual *)receiver_data[receiver_index];
@@ -4511,7 +4218,7 @@ EidosValue_SP InteractionType::ExecuteMethod_drawByStrength(EidosGlobalStringID
 					SparseVector *sv = InteractionType::NewSparseVectorForExerterSubpop(exerter_subpop, SparseVectorDataType::kPresences);
 					
 					try {
-						FillSparseVectorForReceiverPresences(sv, receiver, receiver_position, exerter_subpop, kd_root_EXERTERS, /* constraints_active */ true);
+						FillSparseVectorForReceiverPresences(sv, receiver, receiver_position, exerter_subpop, index_EXERTERS, /* constraints_active */ true);
 						uint32_t nnz;
 						const uint32_t *columns;
 						
@@ -4548,7 +4255,7 @@ EidosValue_SP InteractionType::ExecuteMethod_drawByStrength(EidosGlobalStringID
 					
 					// Under OpenMP, raises can't go past the end of the parallel region; handle things the same way when not under OpenMP for simplicity
 					try {
-						FillSparseVectorForReceiverStrengths(sv, receiver, receiver_position, exerter_subpop, kd_root_EXERTERS, exerter_subpop_data.evaluation_interaction_callbacks_);		// protected from running interaction() callbacks in parallel, above
+						FillSparseVectorForReceiverStrengths(sv, receiver, receiver_position, exerter_subpop, index_EXERTERS, exerter_subpop_data.evaluation_interaction_callbacks_);		// protected from running interaction() callbacks in parallel, above
 					} catch (...) {
 						saw_error_3 = true;
 						InteractionType::FreeSparseVector(sv);
@@ -4670,10 +4377,10 @@ EidosValue_SP InteractionType::ExecuteMethod_interactingNeighborCount(EidosGloba
 	CheckSpatialCompatibility(receiver_subpop, exerter_subpop);
 	
 	InteractionsData &exerter_subpop_data = InteractionsDataForSubpop(data_, exerter_subpop);
-	SLiM_kdNode *kd_root_EXERTERS = EnsureKDTreePresent_EXERTERS(exerter_subpop, exerter_subpop_data);
+	SLiM_SpatialIndex index_EXERTERS = EnsureSpatialIndexPresent_EXERTERS(exerter_subpop, exerter_subpop_data);
 	
 	// If there are no exerters satisfying constraints, short-circuit
-	if (!kd_root_EXERTERS)
+	if (index_EXERTERS.IsEmpty())
 	{
 		// If the exerter subpop is empty then all count values for the receivers are zero
 		if (receivers_count == 1)
@@ -4712,13 +4419,7 @@ EidosValue_SP InteractionType::ExecuteMethod_interactingNeighborCount(EidosGloba
 		slim_popsize_t focal_individual_index = (exerter_subpop == receiver_subpop) ? receiver_index_in_subpop : -1;
 		int neighborCount;
 		
-		switch (spatiality_)
-		{
-			case 1: neighborCount = CountNeighbors_1(kd_root_EXERTERS, receiver_position, focal_individual_index);			break;
-			case 2: neighborCount = CountNeighbors_2(kd_root_EXERTERS, receiver_position, focal_individual_index, 0);		break;
-			case 3: neighborCount = CountNeighbors_3(kd_root_EXERTERS, receiver_position, focal_individual_index, 0);		break;
-			default: neighborCount = 0; break;	// unsupported value
-		}
+		neighborCount = CountNeighbors(index_EXERTERS, receiver_position, focal_individual_index);
 		
 		return EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Int(neighborCount));
 	}
@@ -4728,7 +4429,7 @@ EidosValue_SP InteractionType::ExecuteMethod_interactingNeighborCount(EidosGloba
 		bool saw_error_1 = false, saw_error_2 = false, saw_error_3 = false;
 		
 		EIDOS_THREAD_COUNT(gEidos_OMP_threads_INTNEIGHCOUNT);
-#pragma omp parallel for schedule(dynamic, 16) default(none) shared(receivers_count, receiver_subpop, exerter_subpop, receiver_subpop_data, exerter_subpop_data, kd_root_EXERTERS) firstprivate(receivers_data, result_vec) reduction(||: saw_error_1) reduction(||: saw_error_2) reduction(||: saw_error_3) if(receivers_count >= EIDOS_OMPMIN_INTNEIGHCOUNT) num_threads(thread_count)
+#pragma omp parallel for schedule(dynamic, 16) default(none) shared(receivers_count, receiver_subpop, exerter_subpop, receiver_subpop_data, exerter_subpop_data, index_EXERTERS) firstprivate(receivers_data, result_vec) reduction(||: saw_error_1) reduction(||: saw_error_2) reduction(||: saw_error_3) if(receivers_count >= EIDOS_OMPMIN_INTNEIGHCOUNT) num_threads(thread_count)
 		for (int receiver_index = 0; receiver_index < receivers_count; ++receiver_index)
 		{
 			Individual *receiver = receivers_data[receiver_index];
@@ -4765,13 +4466,7 @@ EidosValue_SP InteractionType::ExecuteMethod_interactingNeighborCount(EidosGloba
 			slim_popsize_t focal_individual_index = (exerter_subpop == receiver_subpop) ? receiver_index_in_subpop : -1;
 			int neighborCount;
 			
-			switch (spatiality_)
-			{
-				case 1: neighborCount = CountNeighbors_1(kd_root_EXERTERS, receiver_position, focal_individual_index);			break;
-				case 2: neighborCount = CountNeighbors_2(kd_root_EXERTERS, receiver_position, focal_individual_index, 0);		break;
-				case 3: neighborCount = CountNeighbors_3(kd_root_EXERTERS, receiver_position, focal_individual_index, 0);		break;
-				default: neighborCount = 0; break;	// unsupported value
-			}
+			neighborCount = CountNeighbors(index_EXERTERS, receiver_position, focal_individual_index);
 			
 			result_vec->set_int_no_check(neighborCount, receiver_index);
 		}
@@ -4826,10 +4521,10 @@ EidosValue_SP InteractionType::ExecuteMethod_localPopulationDensity(EidosGlobalS
 			EIDOS_TERMINATION << "ERROR (InteractionType::ExecuteMethod_localPopulationDensity): localPopulationDensity() requires that the receiver and exerter subpopulations have identical bounds." << EidosTerminate();
 	
 	InteractionsData &exerter_subpop_data = InteractionsDataForSubpop(data_, exerter_subpop);
-	SLiM_kdNode *kd_root_EXERTERS = EnsureKDTreePresent_EXERTERS(exerter_subpop, exerter_subpop_data);
+	SLiM_SpatialIndex index_EXERTERS = EnsureSpatialIndexPresent_EXERTERS(exerter_subpop, exerter_subpop_data);
 	
 	// If there are no exerters satisfying constraints, short-circuit
-	if (!kd_root_EXERTERS)
+	if (index_EXERTERS.IsEmpty())
 	{
 		// If the exerter subpop is empty then all density values for the receivers are zero (note that we
 		// already handled the case of receivers_count == 0 above, so the receiver is not in the exerter subpop)
@@ -4888,7 +4583,7 @@ EidosValue_SP InteractionType::ExecuteMethod_localPopulationDensity(EidosGlobalS
 			SparseVector *sv = InteractionType::NewSparseVectorForExerterSubpop(exerter_subpop, SparseVectorDataType::kPresences);
 			
 			try {
-				FillSparseVectorForReceiverPresences(sv, first_receiver, receiver_position, exerter_subpop, kd_root_EXERTERS, /* constraints_active */ true);
+				FillSparseVectorForReceiverPresences(sv, first_receiver, receiver_position, exerter_subpop, index_EXERTERS, /* constraints_active */ true);
 				
 				uint32_t nnz;
 				sv->Presences(&nnz);
@@ -4907,7 +4602,7 @@ EidosValue_SP InteractionType::ExecuteMethod_localPopulationDensity(EidosGlobalS
 			SparseVector *sv = InteractionType::NewSparseVectorForExerterSubpop(exerter_subpop, SparseVectorDataType::kStrengths);
 			
 			try {
-				FillSparseVectorForReceiverStrengths(sv, first_receiver, receiver_position, exerter_subpop, kd_root_EXERTERS, exerter_subpop_data.evaluation_interaction_callbacks_);		// singleton case, not parallel
+				FillSparseVectorForReceiverStrengths(sv, first_receiver, receiver_position, exerter_subpop, index_EXERTERS, exerter_subpop_data.evaluation_interaction_callbacks_);		// singleton case, not parallel
 				
 				// Get the sparse vector data
 				uint32_t nnz;
@@ -4944,7 +4639,7 @@ EidosValue_SP InteractionType::ExecuteMethod_localPopulationDensity(EidosGlobalS
 		bool saw_error_1 = false, saw_error_2 = false, saw_error_3 = false, saw_error_4 = false;
 		
 		EIDOS_THREAD_COUNT(gEidos_OMP_threads_LOCALPOPDENSITY);
-#pragma omp parallel for schedule(dynamic, 16) default(none) shared(receivers_count, receiver_subpop, exerter_subpop, receiver_subpop_data, exerter_subpop_data, kd_root_EXERTERS, strength_for_zero_distance, clipped_integrals_data, optimize_fixed_interaction_strengths) firstprivate(receivers_data, result_vec) reduction(||: saw_error_1) reduction(||: saw_error_2) reduction(||: saw_error_3) reduction(||: saw_error_4) if(!has_interaction_callbacks && (receivers_count >= EIDOS_OMPMIN_LOCALPOPDENSITY)) num_threads(thread_count)
+#pragma omp parallel for schedule(dynamic, 16) default(none) shared(receivers_count, receiver_subpop, exerter_subpop, receiver_subpop_data, exerter_subpop_data, index_EXERTERS, strength_for_zero_distance, clipped_integrals_data, optimize_fixed_interaction_strengths) firstprivate(receivers_data, result_vec) reduction(||: saw_error_1) reduction(||: saw_error_2) reduction(||: saw_error_3) reduction(||: saw_error_4) if(!has_interaction_callbacks && (receivers_count >= EIDOS_OMPMIN_LOCALPOPDENSITY)) num_threads(thread_count)
 		for (int receiver_index = 0; receiver_index < receivers_count; ++receiver_index)
 		{
 			Individual *receiver = receivers_data[receiver_index];
@@ -4986,7 +4681,7 @@ EidosValue_SP InteractionType::ExecuteMethod_localPopulationDensity(EidosGlobalS
 				sv = InteractionType::NewSparseVectorForExerterSubpop(exerter_subpop, SparseVectorDataType::kPresences);
 				
 				try {
-					FillSparseVectorForReceiverPresences(sv, receiver, receiver_position, exerter_subpop, kd_root_EXERTERS, /* constraints_active */ true);
+					FillSparseVectorForReceiverPresences(sv, receiver, receiver_position, exerter_subpop, index_EXERTERS, /* constraints_active */ true);
 					
 					uint32_t nnz;
 					sv->Presences(&nnz);
@@ -5003,7 +4698,7 @@ EidosValue_SP InteractionType::ExecuteMethod_localPopulationDensity(EidosGlobalS
 				sv = InteractionType::NewSparseVectorForExerterSubpop(exerter_subpop, SparseVectorDataType::kStrengths);
 				
 				try {
-					FillSparseVectorForReceiverStrengths(sv, receiver, receiver_position, exerter_subpop, kd_root_EXERTERS, exerter_subpop_data.evaluation_interaction_callbacks_);		// we do not allow interaction() callbacks, so this should not raise
+					FillSparseVectorForReceiverStrengths(sv, receiver, receiver_position, exerter_subpop, index_EXERTERS, exerter_subpop_data.evaluation_interaction_callbacks_);		// we do not allow interaction() callbacks, so this should not raise
 					
 					// Get the sparse vector data
 					uint32_t nnz;
@@ -5101,10 +4796,10 @@ EidosValue_SP InteractionType::ExecuteMethod_interactionDistance(EidosGlobalStri
 	{
 		// NULL means return distances from individuals1 (which must be singleton) to all individuals in the subpopulation
 		// We initialize the return vector to INFINITY, and fill in non-infinite values from the sparse vector
-		SLiM_kdNode *kd_root_EXERTERS = EnsureKDTreePresent_EXERTERS(exerter_subpop, exerter_subpop_data);
+		SLiM_SpatialIndex index_EXERTERS = EnsureSpatialIndexPresent_EXERTERS(exerter_subpop, exerter_subpop_data);
 		
 		// If the k-d tree has no qualifying exerters, we return all infinity
-		if (!kd_root_EXERTERS)
+		if (index_EXERTERS.IsEmpty())
 			goto returnAllInfinity;
 		
 		SparseVector *sv = InteractionType::NewSparseVectorForExerterSubpop(exerter_subpop, SparseVectorDataType::kDistances);
@@ -5113,7 +4808,7 @@ EidosValue_SP InteractionType::ExecuteMethod_interactionDistance(EidosGlobalStri
 		const sv_value_t *distances;
 		
 		try {
-			FillSparseVectorForReceiverDistances(sv, receiver, receiver_position, exerter_subpop, kd_root_EXERTERS, /* constraints_active */ true);
+			FillSparseVectorForReceiverDistances(sv, receiver, receiver_position, exerter_subpop, index_EXERTERS, /* constraints_active */ true);
 			distances = sv->Distances(&nnz, &columns);
 			
 			EidosValue_Float *result_vec = (new (gEidosValuePool->AllocateChunk()) EidosValue_Float())->resize_no_initialize(exerters_count);
@@ -5292,14 +4987,14 @@ EidosValue_SP InteractionType::ExecuteMethod_nearestInteractingNeighbors(EidosGl
 		// Find the neighbors
 		double *receiver_position = receiver_subpop_data.positions_ + (size_t)receiver_index_in_subpop * SLIM_MAX_DIMENSIONALITY;
 		InteractionsData &exerter_subpop_data = InteractionsDataForSubpop(data_, exerter_subpop);
-		SLiM_kdNode *kd_root_EXERTERS = EnsureKDTreePresent_EXERTERS(exerter_subpop, exerter_subpop_data);
+		SLiM_SpatialIndex index_EXERTERS = EnsureSpatialIndexPresent_EXERTERS(exerter_subpop, exerter_subpop_data);
 		
 		EidosValue_Object *result_vec = (new (gEidosValuePool->AllocateChunk()) EidosValue_Object(gSLiM_Individual_Class));
 		
 		if (count < exerter_subpop_size)		// reserve only if we are finding fewer than every possible neighbor
 			result_vec->reserve((int)count);
 		
-		FindNeighbors(exerter_subpop, kd_root_EXERTERS, exerter_subpop_data.kd_node_count_EXERTERS_, receiver_position, (int)count, *result_vec, receiver, /* constraints_active */ true);
+		FindNeighbors(exerter_subpop, index_EXERTERS, receiver_position, (int)count, *result_vec, receiver, /* constraints_active */ true);
 		
 		return EidosValue_SP(result_vec);
 	}
@@ -5330,10 +5025,10 @@ EidosValue_SP InteractionType::ExecuteMethod_nearestInteractingNeighbors(EidosGl
 			bool saw_error_1 = false, saw_error_2 = false, saw_error_3 = false;
 			
 			InteractionsData &exerter_subpop_data = InteractionsDataForSubpop(data_, exerter_subpop);
-			SLiM_kdNode *kd_root_EXERTERS = EnsureKDTreePresent_EXERTERS(exerter_subpop, exerter_subpop_data);
+			SLiM_SpatialIndex index_EXERTERS = EnsureSpatialIndexPresent_EXERTERS(exerter_subpop, exerter_subpop_data);
 			
 			EIDOS_THREAD_COUNT(gEidos_OMP_threads_NEARESTINTNEIGH);
-#pragma omp parallel for schedule(dynamic, 16) default(none) shared(receivers_count, receiver_subpop, exerter_subpop, receiver_subpop_data, exerter_subpop_data, kd_root_EXERTERS) firstprivate(receiver_data, result_vectors, count, exerter_subpop_size) reduction(||: saw_error_1) reduction(||: saw_error_2) reduction(||: saw_error_3) if(receivers_count >= EIDOS_OMPMIN_NEARESTINTNEIGH) num_threads(thread_count)
+#pragma omp parallel for schedule(dynamic, 16) default(none) shared(receivers_count, receiver_subpop, exerter_subpop, receiver_subpop_data, exerter_subpop_data, index_EXERTERS) firstprivate(receiver_data, result_vectors, count, exerter_subpop_size) reduction(||: saw_error_1) reduction(||: saw_error_2) reduction(||: saw_error_3) if(receivers_count >= EIDOS_OMPMIN_NEARESTINTNEIGH) num_threads(thread_count)
 			for (int receiver_index = 0; receiver_index < receivers_count; ++receiver_index)
 			{
 				Individual *receiver = receiver_data[receiver_index];
@@ -5369,7 +5064,7 @@ EidosValue_SP InteractionType::ExecuteMethod_nearestInteractingNeighbors(EidosGl
 				if (count < exerter_subpop_size)		// reserve only if we are finding fewer than every possible neighbor
 					result_vec->reserve((int)count);
 				
-				FindNeighbors(exerter_subpop, kd_root_EXERTERS, exerter_subpop_data.kd_node_count_EXERTERS_, receiver_position, (int)count, *result_vec, receiver, /* constraints_active */ true);
+				FindNeighbors(exerter_subpop, index_EXERTERS, receiver_position, (int)count, *result_vec, receiver, /* constraints_active */ true);
 			}
 			
 			// deferred raises, for OpenMP compatibility
@@ -5482,14 +5177,14 @@ EidosValue_SP InteractionType::ExecuteMethod_nearestNeighbors(EidosGlobalStringI
 		// Find the neighbors
 		double *receiver_position = receiver_subpop_data.positions_ + (size_t)receiver_index_in_subpop * SLIM_MAX_DIMENSIONALITY;
 		InteractionsData &exerter_subpop_data = InteractionsDataForSubpop(data_, exerter_subpop);
-		SLiM_kdNode *kd_root_ALL = EnsureKDTreePresent_ALL(exerter_subpop, exerter_subpop_data);
+		SLiM_SpatialIndex index_ALL = EnsureSpatialIndexPresent_ALL(exerter_subpop, exerter_subpop_data);
 		
 		EidosValue_Object *result_vec = (new (gEidosValuePool->AllocateChunk()) EidosValue_Object(gSLiM_Individual_Class));
 		
 		if (count < exerter_subpop_size)		// reserve only if we are finding fewer than every possible neighbor
 			result_vec->reserve((int)count);
 		
-		FindNeighbors(exerter_subpop, kd_root_ALL, exerter_subpop_data.kd_node_count_ALL_, receiver_position, (int)count, *result_vec, receiver, /* constraints_active */ false);
+		FindNeighbors(exerter_subpop, index_ALL, receiver_position, (int)count, *result_vec, receiver, /* constraints_active */ false);
 		
 		return EidosValue_SP(result_vec);
 	}
@@ -5520,10 +5215,10 @@ EidosValue_SP InteractionType::ExecuteMethod_nearestNeighbors(EidosGlobalStringI
 			bool saw_error_1 = false, saw_error_2 = false;
 			
 			InteractionsData &exerter_subpop_data = InteractionsDataForSubpop(data_, exerter_subpop);
-			SLiM_kdNode *kd_root_ALL = EnsureKDTreePresent_ALL(exerter_subpop, exerter_subpop_data);
+			SLiM_SpatialIndex index_ALL = EnsureSpatialIndexPresent_ALL(exerter_subpop, exerter_subpop_data);
 			
 			EIDOS_THREAD_COUNT(gEidos_OMP_threads_NEARESTNEIGH);
-#pragma omp parallel for schedule(dynamic, 16) default(none) shared(receivers_count, receiver_subpop, exerter_subpop, receiver_subpop_data, exerter_subpop_data, kd_root_ALL) firstprivate(receiver_data, result_vectors, count, exerter_subpop_size) reduction(||: saw_error_1) reduction(||: saw_error_2) if(receivers_count >= EIDOS_OMPMIN_NEARESTNEIGH) num_threads(thread_count)
+#pragma omp parallel for schedule(dynamic, 16) default(none) shared(receivers_count, receiver_subpop, exerter_subpop, receiver_subpop_data, exerter_subpop_data, index_ALL) firstprivate(receiver_data, result_vectors, count, exerter_subpop_size) reduction(||: saw_error_1) reduction(||: saw_error_2) if(receivers_count >= EIDOS_OMPMIN_NEARESTNEIGH) num_threads(thread_count)
 			for (int receiver_index = 0; receiver_index < receivers_count; ++receiver_index)
 			{
 				Individual *receiver = receiver_data[receiver_index];
@@ -5549,7 +5244,7 @@ EidosValue_SP InteractionType::ExecuteMethod_nearestNeighbors(EidosGlobalStringI
 				if (count < exerter_subpop_size)		// reserve only if we are finding fewer than every possible neighbor
 					result_vec->reserve((int)count);
 				
-				FindNeighbors(exerter_subpop, kd_root_ALL, exerter_subpop_data.kd_node_count_ALL_, receiver_position, (int)count, *result_vec, receiver, /* constraints_active */ false);
+				FindNeighbors(exerter_subpop, index_ALL, receiver_position, (int)count, *result_vec, receiver, /* constraints_active */ false);
 			}
 			
 			// deferred raises, for OpenMP compatibility
@@ -5583,7 +5278,7 @@ EidosValue_SP InteractionType::ExecuteMethod_nearestNeighborsOfPoint(EidosGlobal
 	CheckSpeciesCompatibility_Generic(exerter_species);
 	
 	InteractionsData &exerter_subpop_data = InteractionsDataForSubpop(data_, exerter_subpop);
-	SLiM_kdNode *kd_root_ALL = EnsureKDTreePresent_ALL(exerter_subpop, exerter_subpop_data);
+	SLiM_SpatialIndex index_ALL = EnsureSpatialIndexPresent_ALL(exerter_subpop, exerter_subpop_data);
 	
 	// Check the point
 	if (point_value->Count() != spatiality_)
@@ -5601,8 +5296,8 @@ EidosValue_SP InteractionType::ExecuteMethod_nearestNeighborsOfPoint(EidosGlobal
 	if (count < 0)
 		EIDOS_TERMINATION << "ERROR (InteractionType::ExecuteMethod_nearestNeighborsOfPoint): nearestNeighborsOfPoint() requires count >= 0." << EidosTerminate();
 	
-	if (count > exerter_subpop_data.kd_node_count_ALL_)
-		count = exerter_subpop_data.kd_node_count_ALL_;
+	if (count > index_ALL.node_count_)
+		count = index_ALL.node_count_;
 	
 	if (count == 0)
 		return EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Object(gSLiM_Individual_Class));
@@ -5613,7 +5308,7 @@ EidosValue_SP InteractionType::ExecuteMethod_nearestNeighborsOfPoint(EidosGlobal
 	if (count < exerter_subpop_size)		// reserve only if we are finding fewer than every possible neighbor
 		result_vec->reserve((int)count);
 	
-	FindNeighbors(exerter_subpop, kd_root_ALL, exerter_subpop_data.kd_node_count_ALL_, point_array, (int)count, *result_vec, nullptr, /* constraints_active */ false);
+	FindNeighbors(exerter_subpop, index_ALL, point_array, (int)count, *result_vec, nullptr, /* constraints_active */ false);
 	
 	return EidosValue_SP(result_vec);
 }
@@ -5644,10 +5339,10 @@ EidosValue_SP InteractionType::ExecuteMethod_neighborCount(EidosGlobalStringID p
 	CheckSpatialCompatibility(receiver_subpop, exerter_subpop);
 	
 	InteractionsData &exerter_subpop_data = InteractionsDataForSubpop(data_, exerter_subpop);
-	SLiM_kdNode *kd_root_ALL = EnsureKDTreePresent_ALL(exerter_subpop, exerter_subpop_data);
+	SLiM_SpatialIndex index_ALL = EnsureSpatialIndexPresent_ALL(exerter_subpop, exerter_subpop_data);
 	
 	// If there are no individuals in the tree, short-circuit
-	if (!kd_root_ALL)
+	if (index_ALL.IsEmpty())
 	{
 		// If the exerter subpop is empty then all count values for the receivers are zero
 		if (receivers_count == 1)
@@ -5681,13 +5376,7 @@ EidosValue_SP InteractionType::ExecuteMethod_neighborCount(EidosGlobalStringID p
 		slim_popsize_t focal_individual_index = (exerter_subpop == receiver_subpop) ? receiver_index_in_subpop : -1;
 		int neighborCount;
 		
-		switch (spatiality_)
-		{
-			case 1: neighborCount = CountNeighbors_1(kd_root_ALL, receiver_position, focal_individual_index);			break;
-			case 2: neighborCount = CountNeighbors_2(kd_root_ALL, receiver_position, focal_individual_index, 0);		break;
-			case 3: neighborCount = CountNeighbors_3(kd_root_ALL, receiver_position, focal_individual_index, 0);		break;
-			default: neighborCount = 0; break;	// unsupported value
-		}
+		neighborCount = CountNeighbors(index_ALL, receiver_position, focal_individual_index);
 		
 		return EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Int(neighborCount));
 	}
@@ -5697,7 +5386,7 @@ EidosValue_SP InteractionType::ExecuteMethod_neighborCount(EidosGlobalStringID p
 		bool saw_error_1 = false, saw_error_2 = false;
 		
 		EIDOS_THREAD_COUNT(gEidos_OMP_threads_NEIGHCOUNT);
-#pragma omp parallel for schedule(dynamic, 16) default(none) shared(receivers_count, receiver_subpop, exerter_subpop, receiver_subpop_data, exerter_subpop_data, kd_root_ALL) firstprivate(receivers_data, result_vec) reduction(||: saw_error_1) reduction(||: saw_error_2) if(receivers_count >= EIDOS_OMPMIN_NEIGHCOUNT) num_threads(thread_count)
+#pragma omp parallel for schedule(dynamic, 16) default(none) shared(receivers_count, receiver_subpop, exerter_subpop, receiver_subpop_data, exerter_subpop_data, index_ALL) firstprivate(receivers_data, result_vec) reduction(||: saw_error_1) reduction(||: saw_error_2) if(receivers_count >= EIDOS_OMPMIN_NEIGHCOUNT) num_threads(thread_count)
 		for (int receiver_index = 0; receiver_index < receivers_count; ++receiver_index)
 		{
 			Individual *receiver = receivers_data[receiver_index];
@@ -5721,13 +5410,7 @@ EidosValue_SP InteractionType::ExecuteMethod_neighborCount(EidosGlobalStringID p
 			slim_popsize_t focal_individual_index = (exerter_subpop == receiver_subpop) ? receiver_index_in_subpop : -1;
 			int neighborCount;
 			
-			switch (spatiality_)
-			{
-				case 1: neighborCount = CountNeighbors_1(kd_root_ALL, receiver_position, focal_individual_index);			break;
-				case 2: neighborCount = CountNeighbors_2(kd_root_ALL, receiver_position, focal_individual_index, 0);		break;
-				case 3: neighborCount = CountNeighbors_3(kd_root_ALL, receiver_position, focal_individual_index, 0);		break;
-				default: neighborCount = 0; break;	// unsupported value
-			}
+			neighborCount = CountNeighbors(index_ALL, receiver_position, focal_individual_index);
 			
 			result_vec->set_int_no_check(neighborCount, receiver_index);
 		}
@@ -5760,9 +5443,9 @@ EidosValue_SP InteractionType::ExecuteMethod_neighborCountOfPoint(EidosGlobalStr
 	CheckSpeciesCompatibility_Generic(exerter_species);
 	
 	InteractionsData &exerter_subpop_data = InteractionsDataForSubpop(data_, exerter_subpop);
-	SLiM_kdNode *kd_root_ALL = EnsureKDTreePresent_ALL(exerter_subpop, exerter_subpop_data);
+	SLiM_SpatialIndex index_ALL = EnsureSpatialIndexPresent_ALL(exerter_subpop, exerter_subpop_data);
 
-	if (!kd_root_ALL)
+	if (index_ALL.IsEmpty())
 		return gStaticEidosValue_Integer0;
 	
 	// Check the point
@@ -5777,13 +5460,10 @@ EidosValue_SP InteractionType::ExecuteMethod_neighborCountOfPoint(EidosGlobalStr
 	// Find the neighbors
 	int neighborCount;
 	
-	switch (spatiality_)
-	{
-		case 1: neighborCount = CountNeighbors_1(kd_root_ALL, point_array, -1);			break;
-		case 2: neighborCount = CountNeighbors_2(kd_root_ALL, point_array, -1, 0);		break;
-		case 3: neighborCount = CountNeighbors_3(kd_root_ALL, point_array, -1, 0);		break;
-		default: EIDOS_TERMINATION << "ERROR (InteractionType::ExecuteMethod_neighborCountOfPoint): (internal error) unsupported spatiality" << EidosTerminate();
-	}
+	if ((spatiality_ < 1) || (spatiality_ > 3))
+		EIDOS_TERMINATION << "ERROR (InteractionType::ExecuteMethod_neighborCountOfPoint): (internal error) unsupported spatiality" << EidosTerminate();
+	
+	neighborCount = CountNeighbors(index_ALL, point_array, -1);
 	
 	return EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Int(neighborCount));
 }
@@ -6074,10 +5754,10 @@ EidosValue_SP InteractionType::ExecuteMethod_strength(EidosGlobalStringID p_meth
 		{
 			// NULL means return distances from individuals1 (which must be singleton) to all individuals in the subpopulation
 			// We initialize the return vector to 0, and fill in non-zero values from the sparse vector
-			SLiM_kdNode *kd_root_EXERTERS = (spatiality_ ? EnsureKDTreePresent_EXERTERS(exerter_subpop, exerter_subpop_data) : nullptr);
+			SLiM_SpatialIndex index_EXERTERS = EnsureSpatialIndexPresent_EXERTERS(exerter_subpop, exerter_subpop_data);
 			
 			// If the k-d tree has no qualifying exerters, we return all zeros
-			if (!kd_root_EXERTERS)
+			if (index_EXERTERS.IsEmpty())
 				goto returnAllZero;
 			
 			SparseVector *sv = InteractionType::NewSparseVectorForExerterSubpop(exerter_subpop, SparseVectorDataType::kStrengths);
@@ -6086,7 +5766,7 @@ EidosValue_SP InteractionType::ExecuteMethod_strength(EidosGlobalStringID p_meth
 			const sv_value_t *strengths;
 			
 			try {
-				FillSparseVectorForReceiverStrengths(sv, receiver, receiver_position, exerter_subpop, kd_root_EXERTERS, interaction_callbacks);
+				FillSparseVectorForReceiverStrengths(sv, receiver, receiver_position, exerter_subpop, index_EXERTERS, interaction_callbacks);
 				strengths = sv->Strengths(&nnz, &columns);
 				
 				EidosValue_Float *result_vec = (new (gEidosValuePool->AllocateChunk()) EidosValue_Float())->resize_no_initialize(exerters_count);
@@ -6342,10 +6022,10 @@ EidosValue_SP InteractionType::ExecuteMethod_totalOfNeighborStrengths(EidosGloba
 	CheckSpatialCompatibility(receiver_subpop, exerter_subpop);
 	
 	InteractionsData &exerter_subpop_data = InteractionsDataForSubpop(data_, exerter_subpop);
-	SLiM_kdNode *kd_root_EXERTERS = EnsureKDTreePresent_EXERTERS(exerter_subpop, exerter_subpop_data);
+	SLiM_SpatialIndex index_EXERTERS = EnsureSpatialIndexPresent_EXERTERS(exerter_subpop, exerter_subpop_data);
 	
 	// If there are no exerters satisfying constraints, short-circuit
-	if (!kd_root_EXERTERS)
+	if (index_EXERTERS.IsEmpty())
 	{
 		// If the exerter subpop is empty then all strength totals for the receivers are zero
 		if (receivers_count == 1)
@@ -6382,7 +6062,7 @@ EidosValue_SP InteractionType::ExecuteMethod_totalOfNeighborStrengths(EidosGloba
 		SparseVector *sv = InteractionType::NewSparseVectorForExerterSubpop(exerter_subpop, SparseVectorDataType::kStrengths);
 		
 		try {
-			FillSparseVectorForReceiverStrengths(sv, receiver, receiver_position, exerter_subpop, kd_root_EXERTERS, exerter_subpop_data.evaluation_interaction_callbacks_);		// singleton case, not parallel
+			FillSparseVectorForReceiverStrengths(sv, receiver, receiver_position, exerter_subpop, index_EXERTERS, exerter_subpop_data.evaluation_interaction_callbacks_);		// singleton case, not parallel
 		} catch (...) {
 			InteractionType::FreeSparseVector(sv);
 			throw;
@@ -6414,7 +6094,7 @@ EidosValue_SP InteractionType::ExecuteMethod_totalOfNeighborStrengths(EidosGloba
 		bool saw_error_1 = false, saw_error_2 = false, saw_error_3 = false, saw_error_4 = false;
 		
 		EIDOS_THREAD_COUNT(gEidos_OMP_threads_TOTNEIGHSTRENGTH);
-#pragma omp parallel for schedule(dynamic, 16) default(none) shared(receivers_count, receiver_subpop, exerter_subpop, receiver_subpop_data, exerter_subpop_data, kd_root_EXERTERS) firstprivate(receivers_data, result_vec) reduction(||: saw_error_1) reduction(||: saw_error_2) reduction(||: saw_error_3) reduction(||: saw_error_4) if(!has_interaction_callbacks && (receivers_count >= EIDOS_OMPMIN_TOTNEIGHSTRENGTH)) num_threads(thread_count)
+#pragma omp parallel for schedule(dynamic, 16) default(none) shared(receivers_count, receiver_subpop, exerter_subpop, receiver_subpop_data, exerter_subpop_data, index_EXERTERS) firstprivate(receivers_data, result_vec) reduction(||: saw_error_1) reduction(||: saw_error_2) reduction(||: saw_error_3) reduction(||: saw_error_4) if(!has_interaction_callbacks && (receivers_count >= EIDOS_OMPMIN_TOTNEIGHSTRENGTH)) num_threads(thread_count)
 		for (int receiver_index = 0; receiver_index < receivers_count; ++receiver_index)
 		{
 			Individual *receiver = receivers_data[receiver_index];
@@ -6451,7 +6131,7 @@ EidosValue_SP InteractionType::ExecuteMethod_totalOfNeighborStrengths(EidosGloba
 			
 			// Under OpenMP, raises can't go past the end of the parallel region; handle things the same way when not under OpenMP for simplicity
 			try {
-				FillSparseVectorForReceiverStrengths(sv, receiver, receiver_position, exerter_subpop, kd_root_EXERTERS, exerter_subpop_data.evaluation_interaction_callbacks_);		// protected from running interaction() callbacks in parallel, above
+				FillSparseVectorForReceiverStrengths(sv, receiver, receiver_position, exerter_subpop, index_EXERTERS, exerter_subpop_data.evaluation_interaction_callbacks_);		// protected from running interaction() callbacks in parallel, above
 			} catch (...) {
 				saw_error_3 = true;
 				InteractionType::FreeSparseVector(sv);
@@ -6596,6 +6276,8 @@ _InteractionsData::_InteractionsData(_InteractionsData&& p_source) noexcept
 	kd_nodes_EXERTERS_ = p_source.kd_nodes_EXERTERS_;
 	kd_root_EXERTERS_ = p_source.kd_root_EXERTERS_;
 	kd_node_count_EXERTERS_ = p_source.kd_node_count_EXERTERS_;
+	cell_grid_ALL_ = p_source.cell_grid_ALL_;
+	cell_grid_EXERTERS_ = p_source.cell_grid_EXERTERS_;
 	
 	p_source.evaluated_ = false;
 	p_source.evaluation_interaction_callbacks_.resize(0);
@@ -6614,6 +6296,8 @@ _InteractionsData::_InteractionsData(_InteractionsData&& p_source) noexcept
 	p_source.kd_nodes_EXERTERS_ = nullptr;
 	p_source.kd_root_EXERTERS_ = nullptr;
 	p_source.kd_node_count_EXERTERS_ = 0;
+	p_source.cell_grid_ALL_ = SLiM_CellGrid();
+	p_source.cell_grid_EXERTERS_ = SLiM_CellGrid();
 }
 
 _InteractionsData& _InteractionsData::operator=(_InteractionsData&& p_source) noexcept
@@ -6631,6 +6315,9 @@ _InteractionsData& _InteractionsData::operator=(_InteractionsData&& p_source) no
 		if (kd_nodes_EXERTERS_)
 			free(kd_nodes_EXERTERS_);
 		
+		cell_grid_ALL_.Free();
+		cell_grid_EXERTERS_.Free();
+		
 		evaluated_ = p_source.evaluated_;
 		evaluation_interaction_callbacks_.swap(p_source.evaluation_interaction_callbacks_);
 		individual_count_ = p_source.individual_count_;
@@ -6648,6 +6335,8 @@ _InteractionsData& _InteractionsData::operator=(_InteractionsData&& p_source) no
 		kd_nodes_EXERTERS_ = p_source.kd_nodes_EXERTERS_;
 		kd_root_EXERTERS_ = p_source.kd_root_EXERTERS_;
 		kd_node_count_EXERTERS_ = p_source.kd_node_count_EXERTERS_;
+		cell_grid_ALL_ = p_source.cell_grid_ALL_;
+		cell_grid_EXERTERS_ = p_source.cell_grid_EXERTERS_;
 		
 		p_source.evaluated_ = false;
 		p_source.evaluation_interaction_callbacks_.resize(0);
@@ -6666,6 +6355,8 @@ _InteractionsData& _InteractionsData::operator=(_InteractionsData&& p_source) no
 		p_source.kd_nodes_EXERTERS_ = nullptr;
 		p_source.kd_root_EXERTERS_ = nullptr;
 		p_source.kd_node_count_EXERTERS_ = 0;
+		p_source.cell_grid_ALL_ = SLiM_CellGrid();
+		p_source.cell_grid_EXERTERS_ = SLiM_CellGrid();
 	}
 	
 	return *this;
@@ -6709,6 +6400,9 @@ _InteractionsData::~_InteractionsData(void)
 	kd_root_EXERTERS_ = nullptr;
 	kd_node_count_EXERTERS_ = 0;
 	
+	cell_grid_ALL_.Free();
+	cell_grid_EXERTERS_.Free();
+	
 	// Unnecessary since it's about to be destroyed anyway
 	//evaluation_interaction_callbacks_.resize(0);
 }
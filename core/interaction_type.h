@@ -62,10 +62,52 @@ struct _SLiM_kdNode
 {
 	double x[SLIM_MAX_DIMENSIONALITY];		// the coordinates of the individual
 	slim_popsize_t individual_index_;		// the index of the individual in its subpopulation, and into positions_
-	struct _SLiM_kdNode *left;				// the index of the KDNode for the left side
-	struct _SLiM_kdNode *right;				// the index of the KDNode for the right side
 };
-typedef struct _SLiM_kdNode SLiM_kdNode;
+typedef struct _SLiM_kdNode SLiM_kdNode;		// the tree structure is implicit in the order of the nodes; see MakeKDTree()
+
+// For interactions with a finite maximum distance, a uniform grid of cells is used instead of a k-d tree; see BuildCellGrid().
+// Each cell is at least max_distance_ wide, so all neighbors of a point lie in the 3^d cells around the cell containing it, and
+// the points are sorted by cell with a counting sort, so each cell's points are contiguous.  Periodic dimensions wrap around.
+struct _SLiM_gridPoint
+{
+	double x[SLIM_MAX_DIMENSIONALITY];		// the coordinates of the individual
+	slim_popsize_t individual_index_;		// the index of the individual in its subpopulation, and into positions_
+};
+typedef struct _SLiM_gridPoint SLiM_gridPoint;
+
+struct _SLiM_CellGrid
+{
+	bool built_ = false;									// true once BuildCellGrid() has been called
+	bool usable_ = false;									// false if the points cannot be gridded (non-finite coordinates); a k-d tree is used instead
+	int cell_count_[SLIM_MAX_DIMENSIONALITY] = {1, 1, 1};	// the number of cells along each dimension; 1 beyond the spatiality
+	double origin_[SLIM_MAX_DIMENSIONALITY] = {0, 0, 0};	// the lower edge of the first cell along each dimension
+	double inv_cell_width_[SLIM_MAX_DIMENSIONALITY] = {0, 0, 0};	// the reciprocal of the width of a cell along each dimension
+	double period_[SLIM_MAX_DIMENSIONALITY] = {0, 0, 0};	// the spatial extent along each periodic dimension, or 0.0 if not periodic
+	slim_popsize_t point_count_ = 0;						// the number of points in the grid
+	uint32_t *cell_starts_ = nullptr;						// one entry per cell plus one; cell c holds points [cell_starts_[c], cell_starts_[c + 1])
+	SLiM_gridPoint *points_ = nullptr;						// point_count_ entries, sorted by cell
+	
+	void Free(void);
+};
+typedef struct _SLiM_CellGrid SLiM_CellGrid;
+
+// The spatial index that a query uses to find the individuals near a point, from EnsureSpatialIndexPresent_ALL() or
+// EnsureSpatialIndexPresent_EXERTERS(): either a k-d tree or a cell grid.  Both pointers are nullptr if the index is empty.
+struct _SLiM_SpatialIndex
+{
+	SLiM_kdNode *kd_nodes_ = nullptr;		// the nodes of the k-d tree, if a k-d tree is used; the root is at kd_nodes_[node_count_ / 2]
+	SLiM_CellGrid *cell_grid_ = nullptr;	// the cell grid, if a cell grid is used
+	slim_popsize_t node_count_ = 0;			// the number of entries in the index; may be a multiple of the individual count for a periodic k-d tree
+	
+	inline __attribute__((always_inline)) bool IsEmpty(void) const { return (!kd_nodes_ && !cell_grid_); }
+};
+typedef struct _SLiM_SpatialIndex SLiM_SpatialIndex;
+
+// The kind of spatial index used by an InteractionType; see InteractionType::ChooseSpatialIndexType()
+enum class SLiMSpatialIndexType : uint8_t {
+	kKDTree = 0,
+	kCellGrid
+};
 
 struct _InteractionsData
 {
@@ -119,6 +161,13 @@ struct _InteractionsData
 	slim_popsize_t kd_node_count_EXERTERS_ = 0;		// the number of entries in the k-d tree; may be greater than individual_count_ due to periodicity
 	bool kd_constraints_raise_EXERTERS_ = false;	// an exerter tree cannot be constructed due to constraints; see EvaluateSubpopulation() for discussion
 	
+	// Cell grids are used in place of the k-d trees above when the interaction has a finite maximum distance.  They are built
+	// on demand from the nodes cached by CacheKDTreeNodes(), before those nodes are made into a tree, so the same individuals
+	// are indexed, with exerter constraints applied at the same time.  If there are no exerter constraints, the EXERTERS grid
+	// is not used; EnsureCellGridPresent_EXERTERS() returns the ALL grid instead.
+	SLiM_CellGrid cell_grid_ALL_;
+	SLiM_CellGrid cell_grid_EXERTERS_;
+	
 	_InteractionsData(const _InteractionsData&) = delete;					// no copying
 	_InteractionsData& operator=(const _InteractionsData&) = delete;		// no copying
 	_InteractionsData(_InteractionsData&&) noexcept;						// move constructor, for std::map compatibility
@@ -177,6 +226,7 @@ private:
 	bool reciprocal_;							// if true, interaction strengths A->B == B->A; NOW UNUSED
 	double max_distance_;						// the maximum distance, beyond which interaction strength is assumed to be zero
 	double max_distance_sq_;					// the maximum distance squared, cached for speed
+	SLiMSpatialIndexType spatial_index_type_;	// the kind of spatial index used to find neighbors, chosen from max_distance_
 	
 	InteractionConstraints receiver_constraints_;	// constraints on who can be a receiver
 	InteractionConstraints exerter_constraints_;	// constraints on who can be an exerter
@@ -223,20 +273,10 @@ private:
 	double CalculateStrengthNoCallbacks(double p_distance);
 	double CalculateStrengthWithCallbacks(double p_distance, Individual *p_receiver, Individual *p_exerter, std::vector<SLiMEidosBlock*> &p_interaction_callbacks);
 	
-	SLiM_kdNode *FindMedian_p0(SLiM_kdNode *start, SLiM_kdNode *end);
-	SLiM_kdNode *FindMedian_p1(SLiM_kdNode *start, SLiM_kdNode *end);
-	SLiM_kdNode *FindMedian_p2(SLiM_kdNode *start, SLiM_kdNode *end);
-	SLiM_kdNode *MakeKDTree1_p0(SLiM_kdNode *t, int len);
-	SLiM_kdNode *MakeKDTree2_p0(SLiM_kdNode *t, int len);
-	SLiM_kdNode *MakeKDTree2_p1(SLiM_kdNode *t, int len);
-	SLiM_kdNode *MakeKDTree3_p0(SLiM_kdNode *t, int len);
-	SLiM_kdNode *MakeKDTree3_p1(SLiM_kdNode *t, int len);
-	SLiM_kdNode *MakeKDTree3_p2(SLiM_kdNode *t, int len);
-	
 	// Setting up the k-d trees now proceeds in several steps.  CacheKDTreeNodes() allocates the k-d tree buffers and copies positions and indices in, but does not
-	// set up the left/right pointers -- it doesn't actually make the tree.  It is called at evaluate() time to set up the EXERTERS tree if exerter constraints
+	// sort the nodes into tree order -- it doesn't actually make the tree.  It is called at evaluate() time to set up the EXERTERS tree if exerter constraints
 	// are set up, so that those constraints get applied to the state of the model at snapshot time.  For all other cases, it is called on demand when the tree
-	// is needed.  BuildKDTree() takes the structure set up by CacheKDTreeNodes() and actually builds the tree structure recursively; it is called on demand when
+	// is needed.  BuildKDTree() takes the structure set up by CacheKDTreeNodes() and actually builds the tree structure in place; it is called on demand when
 	// the tree is needed.  EnsureKDTreePresent_ALL() and EnsureKDTreePresent_EXERTERS() are called when the corresponding k-d tree is actually needed, and it
 	// triggers caching and building of the tree as needed.  They return a pointer to the tree root, which is all that is needed to use the tree for queries.
 	// BEWARE!  Note that the EnsureKDTreePresent_X() methods will return nullptr if the requested tree contains zero nodes!  This needs to be checked!
@@ -245,48 +285,38 @@ private:
 	SLiM_kdNode *EnsureKDTreePresent_ALL(Subpopulation *subpop, InteractionsData &p_subpop_data);
 	SLiM_kdNode *EnsureKDTreePresent_EXERTERS(Subpopulation *subpop, InteractionsData &p_subpop_data);
 	
-	int CheckKDTree1_p0(SLiM_kdNode *t);
-	void CheckKDTree1_p0_r(SLiM_kdNode *t, double split, bool isLeftSubtree);
-	int CheckKDTree2_p0(SLiM_kdNode *t);
-	void CheckKDTree2_p0_r(SLiM_kdNode *t, double split, bool isLeftSubtree);
-	int CheckKDTree2_p1(SLiM_kdNode *t);
-	void CheckKDTree2_p1_r(SLiM_kdNode *t, double split, bool isLeftSubtree);
-	int CheckKDTree3_p0(SLiM_kdNode *t);
-	void CheckKDTree3_p0_r(SLiM_kdNode *t, double split, bool isLeftSubtree);
-	int CheckKDTree3_p1(SLiM_kdNode *t);
-	void CheckKDTree3_p1_r(SLiM_kdNode *t, double split, bool isLeftSubtree);
-	int CheckKDTree3_p2(SLiM_kdNode *t);
-	void CheckKDTree3_p2_r(SLiM_kdNode *t, double split, bool isLeftSubtree);
-	
-	void BuildSV_Presences_1(SLiM_kdNode *root, double *nd, slim_popsize_t p_focal_individual_index, SparseVector *p_sparse_vector);
-	void BuildSV_Presences_2(SLiM_kdNode *root, double *nd, slim_popsize_t p_focal_individual_index, SparseVector *p_sparse_vector, int p_phase);
-	void BuildSV_Presences_3(SLiM_kdNode *root, double *nd, slim_popsize_t p_focal_individual_index, SparseVector *p_sparse_vector, int p_phase);
-	
-	void BuildSV_Distances_1(SLiM_kdNode *root, double *nd, slim_popsize_t p_focal_individual_index, SparseVector *p_sparse_vector);
-	void BuildSV_Distances_2(SLiM_kdNode *root, double *nd, slim_popsize_t p_focal_individual_index, SparseVector *p_sparse_vector, int p_phase);
-	void BuildSV_Distances_3(SLiM_kdNode *root, double *nd, slim_popsize_t p_focal_individual_index, SparseVector *p_sparse_vector, int p_phase);
-	
-	void BuildSV_Strengths_f_2(SLiM_kdNode *root, double *nd, slim_popsize_t p_focal_individual_index, SparseVector *p_sparse_vector, int p_phase);
-	void BuildSV_Strengths_l_2(SLiM_kdNode *root, double *nd, slim_popsize_t p_focal_individual_index, SparseVector *p_sparse_vector, int p_phase);
-	void BuildSV_Strengths_e_2(SLiM_kdNode *root, double *nd, slim_popsize_t p_focal_individual_index, SparseVector *p_sparse_vector, int p_phase);
-	void BuildSV_Strengths_n_2(SLiM_kdNode *root, double *nd, slim_popsize_t p_focal_individual_index, SparseVector *p_sparse_vector, int p_phase);
-	void BuildSV_Strengths_c_2(SLiM_kdNode *root, double *nd, slim_popsize_t p_focal_individual_index, SparseVector *p_sparse_vector, int p_phase);
-	void BuildSV_Strengths_t_2(SLiM_kdNode *root, double *nd, slim_popsize_t p_focal_individual_index, SparseVector *p_sparse_vector, int p_phase);
-	
-	int CountNeighbors_1(SLiM_kdNode *root, double *nd, slim_popsize_t p_focal_individual_index);
-	int CountNeighbors_2(SLiM_kdNode *root, double *nd, slim_popsize_t p_focal_individual_index, int p_phase);
-	int CountNeighbors_3(SLiM_kdNode *root, double *nd, slim_popsize_t p_focal_individual_index, int p_phase);
-	
-	void FindNeighbors1_1(SLiM_kdNode *root, double *nd, slim_popsize_t p_focal_individual_index, SLiM_kdNode **best, double *best_dist);
-	void FindNeighbors1_2(SLiM_kdNode *root, double *nd, slim_popsize_t p_focal_individual_index, SLiM_kdNode **best, double *best_dist, int p_phase);
-	void FindNeighbors1_3(SLiM_kdNode *root, double *nd, slim_popsize_t p_focal_individual_index, SLiM_kdNode **best, double *best_dist, int p_phase);
-	void FindNeighborsA_1(SLiM_kdNode *root, double *nd, slim_popsize_t p_focal_individual_index, EidosValue_Object &p_result_vec, std::vector<Individual *> &p_individuals);
-	void FindNeighborsA_2(SLiM_kdNode *root, double *nd, slim_popsize_t p_focal_individual_index, EidosValue_Object &p_result_vec, std::vector<Individual *> &p_individuals, int p_phase);
-	void FindNeighborsA_3(SLiM_kdNode *root, double *nd, slim_popsize_t p_focal_individual_index, EidosValue_Object &p_result_vec, std::vector<Individual *> &p_individuals, int p_phase);
-	void FindNeighborsN_1(SLiM_kdNode *root, double *nd, slim_popsize_t p_focal_individual_index, int p_count, SLiM_kdNode **best, double *best_dist);
-	void FindNeighborsN_2(SLiM_kdNode *root, double *nd, slim_popsize_t p_focal_individual_index, int p_count, SLiM_kdNode **best, double *best_dist, int p_phase);
-	void FindNeighborsN_3(SLiM_kdNode *root, double *nd, slim_popsize_t p_focal_individual_index, int p_count, SLiM_kdNode **best, double *best_dist, int p_phase);
-	void FindNeighbors(Subpopulation *p_subpop, SLiM_kdNode *kd_root, slim_popsize_t kd_node_count, double *p_point, int p_count, EidosValue_Object &p_result_vec, Individual *p_excluded_individual, bool constraints_active);
+	// Cell grids are the alternative to k-d trees for interactions with a finite maximum distance.  BuildCellGrid() makes a grid from the nodes cached
+	// by CacheKDTreeNodes(), and EnsureCellGridPresent_ALL() and EnsureCellGridPresent_EXERTERS() cache and build as needed, like the k-d tree methods.
+	// EnsureSpatialIndexPresent_ALL() and EnsureSpatialIndexPresent_EXERTERS() return whichever index spatial_index_type_ calls for; queries should use
+	// them, rather than using the k-d tree or cell grid methods directly.  The returned index is empty if it contains zero individuals.
+	void ChooseSpatialIndexType(void);
+	void BuildCellGrid(InteractionsData &p_subpop_data, SLiM_kdNode *p_nodes, slim_popsize_t p_node_count, SLiM_CellGrid *p_grid);
+	SLiM_CellGrid *EnsureCellGridPresent_ALL(Subpopulation *subpop, InteractionsData &p_subpop_data);
+	SLiM_CellGrid *EnsureCellGridPresent_EXERTERS(Subpopulation *subpop, InteractionsData &p_subpop_data);
+	SLiM_SpatialIndex EnsureSpatialIndexPresent_ALL(Subpopulation *subpop, InteractionsData &p_subpop_data);
+	SLiM_SpatialIndex EnsureSpatialIndexPresent_EXERTERS(Subpopulation *subpop, InteractionsData &p_subpop_data);
+	
+	// k-d tree queries; VisitKDTreeNeighbors() calls p_visitor(individual_index, distance_sq) for each node within max_distance_ of nd, other than
+	// p_focal_individual_index, while FindNearestKDTreeNeighbor() finds the nearest node regardless of max_distance_ (the caller must check it)
+	template <const int f_spatiality, typename F>
+	void VisitKDTreeNeighbors(const SLiM_kdNode *p_nodes, slim_popsize_t p_node_count, double *nd, slim_popsize_t p_focal_individual_index, F p_visitor);
+	template <const int f_spatiality>
+	void FindNearestKDTreeNeighbor(const SLiM_kdNode *p_nodes, slim_popsize_t p_node_count, double *nd, slim_popsize_t p_focal_individual_index, slim_popsize_t *p_best, double *p_best_dist);
+	
+	// Cell grid queries, the counterpart of VisitKDTreeNeighbors()
+	template <const int f_spatiality, typename F>
+	void VisitCellGridNeighbors(const SLiM_CellGrid *p_grid, double *nd, slim_popsize_t p_focal_individual_index, F p_visitor);
+	
+	// Spatial index queries, which use whichever of the methods above the index calls for
+	template <typename F>
+	void VisitNeighbors(const SLiM_SpatialIndex &p_index, double *nd, slim_popsize_t p_focal_individual_index, F p_visitor);
+	void BuildSV_Presences(const SLiM_SpatialIndex &p_index, double *nd, slim_popsize_t p_focal_individual_index, SparseVector *p_sparse_vector);
+	void BuildSV_Distances(const SLiM_SpatialIndex &p_index, double *nd, slim_popsize_t p_focal_individual_index, SparseVector *p_sparse_vector);
+	void BuildSV_Strengths_f(const SLiM_SpatialIndex &p_index, double *nd, slim_popsize_t p_focal_individual_index, SparseVector *p_sparse_vector);
+	int CountNeighbors(const SLiM_SpatialIndex &p_index, double *nd, slim_popsize_t p_focal_individual_index);
+	void FindNeighbors1(const SLiM_SpatialIndex &p_index, double *nd, slim_popsize_t p_focal_individual_index, slim_popsize_t *best, double *best_dist);
+	void FindNeighborsA(const SLiM_SpatialIndex &p_index, double *nd, slim_popsize_t p_focal_individual_index, EidosValue_Object &p_result_vec, std::vector<Individual *> &p_individuals);
+	void FindNeighbors(Subpopulation *p_subpop, const SLiM_SpatialIndex &p_index, double *p_point, int p_count, EidosValue_Object &p_result_vec, Individual *p_excluded_individual, bool constraints_active);
 	
 	// this is a malloced 1D/2D/3D buffer, depending on our spatiality, that contains clipped integral values
 	// for distances, for a focal individual, from 0 to max_distance_ to the nearest edge in each dimension
@@ -366,10 +396,10 @@ private:
 #endif
 	}
 	
-	void FillSparseVectorForReceiverPresences(SparseVector *sv, Individual *receiver, double *receiver_position, Subpopulation *exerter_subpop, SLiM_kdNode *kd_root, bool constraints_active);
-	void FillSparseVectorForReceiverDistances(SparseVector *sv, Individual *receiver, double *receiver_position, Subpopulation *exerter_subpop, SLiM_kdNode *kd_root, bool constraints_active);
-	void FillSparseVectorForPointDistances(SparseVector *sv, double *position, Subpopulation *exerter_subpop, SLiM_kdNode *kd_root);
-	void FillSparseVectorForReceiverStrengths(SparseVector *sv, Individual *receiver, double *receiver_position, Subpopulation *exerter_subpop, SLiM_kdNode *kd_root, std::vector<SLiMEidosBlock*> &interaction_callbacks);
+	void FillSparseVectorForReceiverPresences(SparseVector *sv, Individual *receiver, double *receiver_position, Subpopulation *exerter_subpop, const SLiM_SpatialIndex &p_index, bool constraints_active);
+	void FillSparseVectorForReceiverDistances(SparseVector *sv, Individual *receiver, double *receiver_position, Subpopulation *exerter_subpop, const SLiM_SpatialIndex &p_index, bool constraints_active);
+	void FillSparseVectorForPointDistances(SparseVector *sv, double *position, Subpopulation *exerter_subpop, const SLiM_SpatialIndex &p_index);
+	void FillSparseVectorForReceiverStrengths(SparseVector *sv, Individual *receiver, double *receiver_position, Subpopulation *exerter_subpop, const SLiM_SpatialIndex &p_index, std::vector<SLiMEidosBlock*> &interaction_callbacks);
 	
 public:
 	
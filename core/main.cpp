@@ -32,6 +32,8 @@
 #include <string>
 #include <vector>
 #include <cstdio>
+#include <cstring>
+#include <cerrno>
 #include <stdlib.h>
 #include <stdio.h>
 #include <unistd.h>
@@ -40,6 +42,10 @@
 #include <algorithm>
 #include <sys/stat.h>
 
+#ifndef _WIN32
+#include <sys/wait.h>
+#endif
+
 #include "community.h"
 #include "species.h"
 #include "eidos_globals.h"
@@ -108,7 +114,7 @@ static void PrintUsageAndDie(bool p_print_header, bool p_print_full_usage)
 	
 	SLIM_OUTSTREAM << "usage: slim -v[ersion] | -u[sage] | -h[elp] | -testEidos | -testSLiM |" << std::endl;
 	SLIM_OUTSTREAM << "   [-l[ong] [<l>]] [-s[eed] <seed>] [-t[ime]] [-m[em]] [-M[emhist]] [-x]" << std::endl;
-	SLIM_OUTSTREAM << "   [-d[efine] <def>] [-c[heck]] [-p[rogress]] ";
+	SLIM_OUTSTREAM << "   [-d[efine] <def>] [-c[heck]] [-p[rogress]] [-asyncIO] [-fork <t> <n>] ";
 #ifdef _OPENMP
 	// Some flags are visible only for a parallel build
 	// FIXME: these might not fit on the same line as other things
@@ -136,6 +142,8 @@ static void PrintUsageAndDie(bool p_print_header, bool p_print_full_usage)
 		SLIM_OUTSTREAM << "   -M[emhist]         : print a histogram of SLiM's memory usage" << std::endl;
 		SLIM_OUTSTREAM << "   -p[rogress]        : show a progress bar in the terminal as SLiM runs" << std::endl;
 		SLIM_OUTSTREAM << "   -x                 : disable SLiM's runtime safety/consistency checks" << std::endl;
+		SLIM_OUTSTREAM << "   -asyncIO           : write output files on a background thread" << std::endl;
+		SLIM_OUTSTREAM << "   -fork <t> <n>      : after tick <t>, fork <n> reseeded branches of the run" << std::endl;
 		SLIM_OUTSTREAM << "   -d[efine] <def>    : define an Eidos constant, such as \"mu=1e-7\"" << std::endl;
 		SLIM_OUTSTREAM << "   -c[heck]           : check the input script's syntax, without executing it" << std::endl;
 #ifdef _OPENMP
@@ -186,6 +194,92 @@ static void test_exit(int test_result)
 	exit(test_result);
 }
 
+#ifndef _WIN32
+// This implements the -fork command-line option.  At the end of the fork tick, the process forks p_branch_count children, each
+// of which reseeds its RNG and continues the simulation independently; they share the parent's memory copy-on-write, so a long
+// burn-in is run once and then shared, rather than re-run or reloaded by each replicate.  The seeds for the branches are drawn
+// from the parent's RNG, so a given initial seed always produces the same set of branches; a branch can tell which it is with
+// getSeed().  In each child, the return value is the branch index, 0 to p_branch_count - 1.  The parent does not continue the
+// simulation; it waits for all of its children to finish, and its return value is -1 if they all exited successfully, -2 if not.
+static int ForkBranches(Community *p_community, int p_branch_count, bool p_async_io)
+{
+	// Draw the seeds for the branches before forking, so that they are reproducible and distinct
+	Eidos_RNG_State *rng_state = EIDOS_STATE_RNG(omp_get_thread_num());
+	std::vector<unsigned long int> branch_seeds;
+	
+	while ((int)branch_seeds.size() < p_branch_count)
+	{
+		unsigned long int seed = (unsigned long int)(Eidos_rng_uniform_uint64(rng_state->pcg64_rng_) & INT64_MAX);
+		
+		if ((seed != 0) && (std::find(branch_seeds.begin(), branch_seeds.end(), seed) == branch_seeds.end()))
+			branch_seeds.emplace_back(seed);
+	}
+	
+	// Get everything written out, and shut down the asynchronous writer thread, since threads do not survive a fork;
+	// anything still buffered when we fork would otherwise be written out once by every branch
+	p_community->AllSpecies_PrepareForFork();
+	
+	if (!Eidos_FlushFiles())
+		exit(EXIT_FAILURE);
+	Eidos_SetAsyncFileWriting(false);
+	
+	std::cout.flush();
+	std::cerr.flush();
+	fflush(nullptr);
+	
+	std::vector<pid_t> child_pids;
+	
+	for (int branch_index = 0; branch_index < p_branch_count; ++branch_index)
+	{
+		pid_t pid = fork();
+		
+		if (pid == 0)
+		{
+			// We are a branch; reseed and continue the simulation
+			Eidos_SetRNGSeed(branch_seeds[branch_index]);
+			
+			if (p_async_io)
+				Eidos_SetAsyncFileWriting(true);
+			
+			if (SLiM_verbosity_level >= 1)
+				SLIM_OUTSTREAM << "// Branch " << (branch_index + 1) << " of " << p_branch_count << ", random seed:\n" << branch_seeds[branch_index] << "\n" << std::endl;
+			
+			return branch_index;
+		}
+		
+		if (pid < 0)
+		{
+			// We could not fork; the branches already started will run to completion, but we report failure
+			SLIM_ERRSTREAM << std::endl << "ERROR (main): fork() failed for branch " << (branch_index + 1) << " of " << p_branch_count << " (" << strerror(errno) << ")." << std::endl;
+			break;
+		}
+		
+		child_pids.emplace_back(pid);
+	}
+	
+	bool all_succeeded = ((int)child_pids.size() == p_branch_count);
+	
+	for (pid_t child_pid : child_pids)
+	{
+		int status;
+		
+		while (waitpid(child_pid, &status, 0) < 0)
+		{
+			if (errno != EINTR)
+			{
+				status = -1;
+				break;
+			}
+		}
+		
+		if ((status == -1) || !WIFEXITED(status) || (WEXITSTATUS(status) != EXIT_SUCCESS))
+			all_succeeded = false;
+	}
+	
+	return (all_succeeded ? -1 : -2);
+}
+#endif
+
 int main(int argc, char *argv[])	// FIXME: clang-tidy flags this with bugprone-exception-escape, which is probably true
 {
 	// parse command-line arguments
@@ -193,8 +287,10 @@ int main(int argc, char *argv[])	// FIXME: clang-tidy flags this with bugprone-e
 	unsigned long int *override_seed_ptr = nullptr;			// by default, a seed is generated or supplied in the input file
 	const char *input_file = nullptr;
 	bool keep_time = false, keep_mem = false, keep_mem_hist = false, skip_checks = false;
-	bool tree_seq_checks = false, tree_seq_force = false, show_progress = false, check_script = false;
+	bool tree_seq_checks = false, tree_seq_force = false, show_progress = false, check_script = false, async_io = false;
 	std::vector<std::string> defined_constants;
+	slim_tick_t fork_tick = 0;
+	int fork_branch_count = 0;								// 0 means no forking; see -fork
 	
 #ifdef _OPENMP
 	long max_thread_count = omp_get_max_threads();
@@ -339,6 +435,48 @@ int main(int argc, char *argv[])	// FIXME: clang-tidy flags this with bugprone-e
 			continue;
 		}
 		
+		// -asyncIO: write files on a background thread, overlapping disk I/O with the simulation
+		if (strcmp(arg, "--asyncIO") == 0 || strcmp(arg, "-asyncIO") == 0)
+		{
+			async_io = true;
+			
+			continue;
+		}
+		
+		// -fork <t> <n>: at the end of tick <t>, fork <n> branches that continue the run independently with new seeds
+		if (strcmp(arg, "--fork") == 0 || strcmp(arg, "-fork") == 0)
+		{
+			if (arg_index + 2 >= argc)
+				PrintUsageAndDie(false, true);
+			
+			long tick = strtol(argv[++arg_index], NULL, 10);
+			long count = strtol(argv[++arg_index], NULL, 10);
+			
+			if ((tick < 0) || (tick > SLIM_MAX_TICK))
+			{
+				SLIM_OUTSTREAM << "The tick for the -fork command-line option must be in [0, " << SLIM_MAX_TICK << "]." << std::endl;
+				exit(EXIT_FAILURE);
+			}
+			if ((count < 1) || (count > 100000))
+			{
+				SLIM_OUTSTREAM << "The branch count for the -fork command-line option must be in [1, 100000]." << std::endl;
+				exit(EXIT_FAILURE);
+			}
+			
+#if defined(_WIN32)
+			SLIM_OUTSTREAM << "The -fork command-line option is not supported on Windows." << std::endl;
+			exit(EXIT_FAILURE);
+#elif defined(_OPENMP)
+			// The OpenMP runtime's worker threads do not survive fork(), and runtimes are not reliably fork-safe
+			SLIM_OUTSTREAM << "The -fork command-line option is not supported in multithreaded builds of SLiM." << std::endl;
+			exit(EXIT_FAILURE);
+#endif
+			
+			fork_tick = (slim_tick_t)tick;
+			fork_branch_count = (int)count;
+			continue;
+		}
+		
 		// -version or -v: print version information
 		if (strcmp(arg, "--version") == 0 || strcmp(arg, "-version") == 0 || strcmp(arg, "-v") == 0)
 		{
@@ -549,6 +687,8 @@ int main(int argc, char *argv[])	// FIXME: clang-tidy flags this with bugprone-e
 		tree_seq_checks = false;
 		tree_seq_force = false;
 		show_progress = false;
+		async_io = false;
+		fork_branch_count = 0;
 	}
 	
 	// announce if we are running a debug build, are skipping runtime checks, etc.
@@ -567,6 +707,14 @@ int main(int argc, char *argv[])	// FIXME: clang-tidy flags this with bugprone-e
 	if (skip_checks && (SLiM_verbosity_level >= 1))
 		SLIM_ERRSTREAM << "// ********** The -x command-line option has disabled some runtime checks" << std::endl << std::endl;
 	
+	if (async_io)
+	{
+		Eidos_SetAsyncFileWriting(true);
+		
+		if (SLiM_verbosity_level >= 2)
+			SLIM_ERRSTREAM << "// ********** The -asyncIO command-line option has enabled asynchronous file writing" << std::endl << std::endl;
+	}
+	
 	// emit defined constants in verbose mode
 	if (defined_constants.size() && (SLiM_verbosity_level >= 2))
 	{
@@ -609,6 +757,7 @@ int main(int argc, char *argv[])	// FIXME: clang-tidy flags this with bugprone-e
 	
 	Community *community = nullptr;
 	std::string model_name;
+	bool branches_failed = false;							// set if -fork was given and it, or any of its branches, failed
 	
 	if (!input_file)
 	{
@@ -720,9 +869,14 @@ int main(int argc, char *argv[])	// FIXME: clang-tidy flags this with bugprone-e
 		bool wrote_profile_report = false;
 #endif
 		
+		// For -fork, branch_index is the index of this process's branch once it has forked; -1 before that, and in the parent
+		int branch_index = -1;
+		bool forked = false;
+		
 		while (true)
 		{
 			bool tick_result;
+			slim_tick_t tick_run = community->Tick();
 			
 #if (SLIMPROFILING == 1)
 			if (!profiling_started && (community->Tick() == profile_start_tick))
@@ -766,6 +920,25 @@ int main(int argc, char *argv[])	// FIXME: clang-tidy flags this with bugprone-e
 			if (!tick_result)
 				break;
 			
+#ifndef _WIN32
+			if ((fork_branch_count > 0) && !forked && (tick_run >= fork_tick))
+			{
+				branch_index = ForkBranches(community, fork_branch_count, async_io);
+				forked = true;
+				
+				if (branch_index < 0)
+				{
+					// the parent is done once its branches are; it does not run any further itself
+					branches_failed = (branch_index == -2);
+					break;
+				}
+				
+				// only the first branch shows progress, since the branches share the terminal
+				if (branch_index > 0)
+					show_progress = false;
+			}
+#endif
+			
 			if (show_progress)
 			{
 				slim_tick_t current_tick = community->Tick();
@@ -832,6 +1005,12 @@ int main(int argc, char *argv[])	// FIXME: clang-tidy flags this with bugprone-e
 #endif
 		}
 		
+		if ((fork_branch_count > 0) && !forked)
+		{
+			SLIM_ERRSTREAM << std::endl << "ERROR (main): the simulation ended before the end of tick " << fork_tick << ", so the -fork command-line option did not fork any branches." << std::endl;
+			branches_failed = true;
+		}
+		
 #if (SLIMPROFILING == 1)
 		// We write the profile report path at end, so it doesn't get lost in the middle of the output
 		if (wrote_profile_report)
@@ -842,7 +1021,9 @@ int main(int argc, char *argv[])	// FIXME: clang-tidy flags this with bugprone-e
 #endif
 		
 		// clean up; but most of this is an unnecessary waste of time in the command-line context
+		// flushing files also waits for any pending asynchronous writes, after which the writer thread can be shut down
 		Eidos_FlushFiles();
+		Eidos_SetAsyncFileWriting(false);
 		
 #if SLIM_LEAK_CHECKING
 		delete community;
@@ -911,7 +1092,7 @@ int main(int argc, char *argv[])	// FIXME: clang-tidy flags this with bugprone-e
 		free(mem_record);
 	}
 	
-	return EXIT_SUCCESS;
+	return (branches_failed ? EXIT_FAILURE : EXIT_SUCCESS);
 }
 
 
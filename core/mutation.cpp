@@ -755,6 +755,9 @@ EidosValue_SP Mutation::ExecuteMethod_setSelectionCoeff(EidosGlobalStringID p_me
 	cached_one_plus_dom_sel_ = (slim_selcoeff_t)std::max(0.0, 1.0 + mutation_type_ptr_->dominance_coeff_ * selection_coeff_);
 	cached_one_plus_hemizygousdom_sel_ = (slim_selcoeff_t)std::max(0.0, 1.0 + mutation_type_ptr_->hemizygous_dominance_coeff_ * selection_coeff_);
 	
+	// fitness values cached by individuals may now be stale; see Subpopulation::FitnessOfParent_Incremental()
+	mutation_type_ptr_->species_.fitness_effect_change_counter_++;
+	
 	return gStaticEidosValueVOID;
 }
 
@@ -783,6 +786,9 @@ EidosValue_SP Mutation::ExecuteMethod_setMutationType(EidosGlobalStringID p_meth
 	cached_one_plus_dom_sel_ = (slim_selcoeff_t)std::max(0.0, 1.0 + mutation_type_ptr_->dominance_coeff_ * selection_coeff_);
 	cached_one_plus_hemizygousdom_sel_ = (slim_selcoeff_t)std::max(0.0, 1.0 + mutation_type_ptr_->hemizygous_dominance_coeff_ * selection_coeff_);
 	
+	// fitness values cached by individuals may now be stale; see Subpopulation::FitnessOfParent_Incremental()
+	mutation_type_ptr_->species_.fitness_effect_change_counter_++;
+	
 	return gStaticEidosValueVOID;
 }
 
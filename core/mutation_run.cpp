@@ -25,6 +25,7 @@
 
 // For doing bulk operations across all MutationRun objects; see header
 int64_t MutationRun::sOperationID = 0;
+int64_t MutationRun::sFitnessStampCounter = 0;
 
 
 MutationRun::MutationRun(void)
@@ -257,9 +258,15 @@ Mutation *MutationRun::mutation_with_type_and_position(MutationType *p_mut_type,
 
 const std::vector<Mutation *> *MutationRun::derived_mutation_ids_at_position(slim_position_t p_position) const
 {
-	THREAD_SAFETY_IN_ACTIVE_PARALLEL("MutationRun::derived_mutation_ids_at_position(): usage of statics");
-	
+	// This is called during parallel reproduction with tree-sequence recording, so the returned vector is per-thread;
+	// the caller must be done with it before calling again (RecordNewDerivedState() copies out what it needs)
+#if defined(__GNUC__) && !defined(__clang__)
+	// Work around GCC bug: https://gcc.gnu.org/bugzilla/show_bug.cgi?id=27557
+	static thread_local std::vector<Mutation *> return_vec;
+#else
 	static std::vector<Mutation *> return_vec;
+#pragma omp threadprivate (return_vec)
+#endif
 	
 	// First clear out whatever might be left over from last time
 	return_vec.resize(0);
@@ -339,6 +346,8 @@ void MutationRun::_RemoveFixedMutations(void)
 	if (haplosome_backfill_iter != nullptr)
 	{
 		mutation_count_ -= (haplosome_iter - haplosome_backfill_iter);
+		fitness_stamp_ = 0;
+		fitness_product_valid_mask_ = 0;
 		
 #if SLIM_USE_NONNEUTRAL_CACHES
 		// invalidate the nonneutral mutation cache
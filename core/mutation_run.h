@@ -95,6 +95,14 @@ typedef struct MutationRunContext {
 #define SLIM_USE_NONNEUTRAL_CACHES	1
 
 
+// The products of fitness factors that a MutationRun can cache; see MutationRun::cached_fitness_product()
+enum class MutationRunFitnessProduct : uint8_t {
+	kHomozygous = 0,		// the product of cached_one_plus_sel_, for mutations present in both haplosomes, or in a haploid chromosome
+	kHeterozygous,			// the product of cached_one_plus_dom_sel_, for mutations present in one haplosome of a diploid
+	kHemizygous				// the product of cached_one_plus_hemizygousdom_sel_, for mutations opposite a null haplosome
+};
+
+
 class MutationRun
 {
 	//	This class has its copy constructor and assignment operator disabled, to prevent accidental copying.
@@ -105,6 +113,10 @@ private:
 	// This counter is used to do that; a client wishing to perform such an operation should increment the counter and then use it
 	// in conjuction with operation_id_ below.  Note this is shared by all species.
 	static int64_t sOperationID;								// use MutationRun::GetNextOperationID() to access this
+	
+	// Incremental fitness evaluation in nonWF models identifies the contents of a run by a stamp that is never reused; see
+	// Subpopulation::FitnessOfParent_Incremental().  Stamps are assigned lazily from this counter by FitnessStamp() below.
+	static int64_t sFitnessStampCounter;
 
 private:
 
@@ -193,6 +205,19 @@ public:
 	
 	mutable int64_t operation_id_ = 0;		// used to mark the MutationRun objects that have been handled by a global operation
 	
+	// The fitness stamp of the run, or 0 if none has been assigned since the run was last changed.  It is cleared wherever the
+	// nonneutral cache is invalidated because the run is changing in place (will_modify_run(), FreeMutationRun(), and
+	// _RemoveFixedMutations()), so a given stamp always denotes the same list of mutations.  Mutable since it is a cache.
+	mutable int64_t fitness_stamp_ = 0;
+	
+	// Cached products of the fitness factors of the run's mutations, indexed by MutationRunFitnessProduct, for fitness calculation
+	// without mutationEffect() callbacks; a run shared by many haplosomes then multiplies its factors only once.  Bit i of
+	// fitness_product_valid_mask_ is set if cached_fitness_products_[i] is valid.  The mask is cleared along with fitness_stamp_
+	// when the run changes, and is ignored when fitness_product_change_counter_ does not match the species' fitness_effect_change_counter_.
+	mutable int32_t fitness_product_change_counter_ = 0;
+	mutable uint8_t fitness_product_valid_mask_ = 0;
+	mutable double cached_fitness_products_[3];
+	
 #if DEBUG
 	mutable uint32_t use_count_CHECK_ = 0;	// a checkback for use_count_
 #endif
@@ -204,6 +229,19 @@ public:
 		return ++(MutationRun::sOperationID);
 	}
 	
+	inline __attribute__((always_inline)) int64_t FitnessStamp(void) const
+	{
+		if (fitness_stamp_ == 0)
+		{
+			// When running parallel, stamps must be assigned ahead of time; see Subpopulation::FixNonNeutralCaches_OMP()
+			THREAD_SAFETY_IN_ACTIVE_PARALLEL("MutationRun::FitnessStamp(): MutationRun::sFitnessStampCounter change");
+			
+			fitness_stamp_ = ++(MutationRun::sFitnessStampCounter);
+		}
+		
+		return fitness_stamp_;
+	}
+	
 	// Allocation and disposal of MutationRun objects should go through these funnels.  The point of this architecture
 	// is to re-use the instances completely.  We don't use EidosObjectPool here because it would construct/destruct the
 	// objects, and we actually don't want that; we want the buffers in used MutationRun objects to stay allocated, for
@@ -305,6 +343,8 @@ public:
 		MutationRun *freed_run = const_cast<MutationRun *>(p_run);
 		
 		freed_run->mutation_count_ = 0;						// empty the mutation buffer
+		freed_run->fitness_stamp_ = 0;						// its contents will change when it is reused
+		freed_run->fitness_product_valid_mask_ = 0;
 		
 #if SLIM_USE_NONNEUTRAL_CACHES
 		freed_run->nonneutral_mutations_count_ = -1;		// mark the non-neutral mutation cache as invalid
@@ -377,11 +417,37 @@ public:
 	}
 	
 	inline __attribute__((always_inline)) void will_modify_run(void) {
+		fitness_stamp_ = 0;						// the contents are changing, so they need a new stamp
+		fitness_product_valid_mask_ = 0;		// and the cached fitness products become invalid
+		
 #if SLIM_USE_NONNEUTRAL_CACHES
 		nonneutral_mutations_count_ = -1;		// invalidate the nonneutral cache since the run is changing
 #endif
 	}
 	
+	inline __attribute__((always_inline)) bool cached_fitness_product(MutationRunFitnessProduct p_kind, int32_t p_fitness_effect_change_counter, double *p_product) const {
+		if ((fitness_product_change_counter_ == p_fitness_effect_change_counter) && (fitness_product_valid_mask_ & (1 << (int)p_kind)))
+		{
+			*p_product = cached_fitness_products_[(int)p_kind];
+			return true;
+		}
+		
+		return false;
+	}
+	
+	inline __attribute__((always_inline)) void cache_fitness_product(MutationRunFitnessProduct p_kind, int32_t p_fitness_effect_change_counter, double p_product) const {
+		THREAD_SAFETY_IN_ACTIVE_PARALLEL("MutationRun::cache_fitness_product()");
+		
+		if (fitness_product_change_counter_ != p_fitness_effect_change_counter)
+		{
+			fitness_product_change_counter_ = p_fitness_effect_change_counter;
+			fitness_product_valid_mask_ = 0;
+		}
+		
+		cached_fitness_products_[(int)p_kind] = p_product;
+		fitness_product_valid_mask_ |= (1 << (int)p_kind);
+	}
+	
 	inline __attribute__((always_inline)) MutationIndex const & operator[] (int p_index) const {	// [] returns a reference to a pointer to Mutation; this is the const-pointer variant
 		return mutations_[p_index];
 	}
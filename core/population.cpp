@@ -23,6 +23,7 @@
 #include <fstream>
 #include <iomanip>
 #include <algorithm>
+#include <numeric>
 #include <cmath>
 #include <utility>
 #include <unordered_map>
@@ -473,6 +474,7 @@ void Population::ResolveSurvivalPhaseMovement(void)
 			subpop->parent_individuals_.resize(subpop->parent_subpop_size_);
 			
 			subpop->cached_parent_individuals_value_.reset();
+			subpop->cached_fitness_size_ = 0;
 		}
 	}
 	
@@ -1820,7 +1822,7 @@ void Population::EvolveSubpopulation(Subpopulation &p_subpop, bool p_mate_choice
 						else if (cloning_fraction > 0)
 							number_to_clone = static_cast<slim_popsize_t>(gsl_ran_binomial(rng_gsl, cloning_fraction, (unsigned int)migrants_to_generate));
 						
-						// generate all selfed, cloned, and autogamous offspring in one shared loop
+					// generate all selfed, cloned, and autogamous offspring in one shared loop
 						slim_popsize_t migrant_count = 0;
 						
 						while (migrant_count < migrants_to_generate)
@@ -2512,67 +2514,118 @@ void Population::EvolveSubpopulation(Subpopulation &p_subpop, bool p_mate_choice
 						//std::cerr << "   before reproduction, " << actual_mutation_block_slots_remaining_PRE << " actual slots remaining (" << est_mutation_block_slots_remaining_PRE << " estimated)" << std::endl;
 						//std::cerr << "   demand for new mutations estimated at " << est_slots_needed << " (" << migrants_to_generate << " offspring, E(muts) == " << overall_mutation_rate << ")" << std::endl;
 					}
+					
+					// Tree-sequence records made in parallel go into per-thread staging buffers, and are merged into the tables
+					// in pedigree id order afterwards; this avoids locking, and makes the tables independent of thread scheduling
+					if (will_parallelize && recording_tree_sequence)
+						species_.BeginStagedTreeSeqRecording();
 #endif
 					
 					// generate all selfed, cloned, and autogamous offspring in one shared loop
 					if ((number_to_self == 0) && (number_to_clone == 0))
 					{
-						// a simple loop for the base case with no selfing, no cloning, and no callbacks; we split into two cases by sex_enabled for maximal speed
+						// The base case with no selfing, no cloning, and no callbacks is done as a batched pipeline rather than one child at a time.
+						// First we draw every parent pair into flat buffers, in a tight loop that does nothing but sample the alias tables.  Then we
+						// counting-sort the children by first parent, so that siblings are generated consecutively and reuse the same parental
+						// haplosomes and mutation runs while they are still in cache (unchanged runs are shared by pointer, not copied, in any case).
+						// Finally we generate the children in that order; each child still goes into the slot, and gets the pedigree ID, that
+						// corresponds to the order in which its parents were drawn, so the order of the child individuals remains random.
+						EIDOS_BENCHMARK_START(EidosBenchmarkType::k_WF_REPRO);
+						
+						static slim_popsize_t *batch_buffer = nullptr;
+						static int64_t batch_buffer_alloc_size = 0;
+						slim_popsize_t source_parent_count = source_subpop.parent_subpop_size_;
+						int64_t batch_buffer_size = 3 * (int64_t)migrants_to_generate + source_parent_count + 1;
+						
+						if (batch_buffer_alloc_size < batch_buffer_size)
+						{
+							batch_buffer = (slim_popsize_t *)realloc(batch_buffer, batch_buffer_size * sizeof(slim_popsize_t));		// NOLINT(*-realloc-usage) : realloc failure is a fatal error anyway
+							if (!batch_buffer)
+								EIDOS_TERMINATION << "ERROR (Population::EvolveSubpopulation): allocation failed; you may need to raise the memory limit for SLiM." << EidosTerminate(nullptr);
+							batch_buffer_alloc_size = batch_buffer_size;
+						}
+						
+						slim_popsize_t *batch_parent1 = batch_buffer;
+						slim_popsize_t *batch_parent2 = batch_parent1 + migrants_to_generate;
+						slim_popsize_t *batch_order = batch_parent2 + migrants_to_generate;
+						slim_popsize_t *batch_parent1_start = batch_order + migrants_to_generate;
+						
+						// stage 1: draw all parent pairs
 						if (sex_enabled)
 						{
-							EIDOS_BENCHMARK_START(EidosBenchmarkType::k_WF_REPRO);
-							EIDOS_THREAD_COUNT(gEidos_OMP_threads_WF_REPRO);
-#pragma omp parallel default(none) shared(gEidos_RNG_PERTHREAD, migrants_to_generate, base_child_count, base_pedigree_id, pedigrees_enabled, p_subpop, source_subpop, child_sex, prevent_incidental_selfing) if(will_parallelize) num_threads(thread_count)
+							for (slim_popsize_t migrant_count = 0; migrant_count < migrants_to_generate; migrant_count++)
 							{
-								Eidos_RNG_State *parallel_rng_state = EIDOS_STATE_RNG(omp_get_thread_num());
-								
-#pragma omp for schedule(dynamic, 1)
-								for (slim_popsize_t migrant_count = 0; migrant_count < migrants_to_generate; migrant_count++)
-								{
-									slim_popsize_t parent1 = source_subpop.DrawFemaleParentUsingFitness(parallel_rng_state);
-									slim_popsize_t parent2 = source_subpop.DrawMaleParentUsingFitness(parallel_rng_state);
-									
-									slim_popsize_t this_child_index = base_child_count + migrant_count;
-									Individual *new_child = p_subpop.child_individuals_[this_child_index];
-									new_child->migrant_ = (&source_subpop != &p_subpop);
-									
-									(p_subpop.*MungeIndividualCrossed_TEMPLATED)(new_child, base_pedigree_id + migrant_count, source_subpop.parent_individuals_[parent1], source_subpop.parent_individuals_[parent2], child_sex);
-									new_child->migrant_ = (&source_subpop != &p_subpop);
-								}
+								batch_parent1[migrant_count] = source_subpop.DrawFemaleParentUsingFitness(rng_state);
+								batch_parent2[migrant_count] = source_subpop.DrawMaleParentUsingFitness(rng_state);
 							}
-							EIDOS_BENCHMARK_END(EidosBenchmarkType::k_WF_REPRO);
-							
-							child_count += migrants_to_generate;
 						}
 						else
 						{
-							EIDOS_BENCHMARK_START(EidosBenchmarkType::k_WF_REPRO);
-							EIDOS_THREAD_COUNT(gEidos_OMP_threads_WF_REPRO);
-#pragma omp parallel default(none) shared(gEidos_RNG_PERTHREAD, migrants_to_generate, base_child_count, base_pedigree_id, pedigrees_enabled, p_subpop, source_subpop, child_sex, prevent_incidental_selfing) if(will_parallelize) num_threads(thread_count)
+							for (slim_popsize_t migrant_count = 0; migrant_count < migrants_to_generate; migrant_count++)
 							{
-								Eidos_RNG_State *parallel_rng_state = EIDOS_STATE_RNG(omp_get_thread_num());
+								slim_popsize_t parent1 = source_subpop.DrawParentUsingFitness(rng_state);
+								slim_popsize_t parent2;
 								
-#pragma omp for schedule(dynamic, 1)
-								for (slim_popsize_t migrant_count = 0; migrant_count < migrants_to_generate; migrant_count++)
-								{
-									slim_popsize_t parent1 = source_subpop.DrawParentUsingFitness(parallel_rng_state);
-									slim_popsize_t parent2;
-									
-									do
-										parent2 = source_subpop.DrawParentUsingFitness(parallel_rng_state);	// note this does not prohibit selfing!
-									while (prevent_incidental_selfing && (parent2 == parent1));
-									
-									slim_popsize_t this_child_index = base_child_count + migrant_count;
-									Individual *new_child = p_subpop.child_individuals_[this_child_index];
-									new_child->migrant_ = (&source_subpop != &p_subpop);
-									
-									(p_subpop.*MungeIndividualCrossed_TEMPLATED)(new_child, base_pedigree_id + migrant_count, source_subpop.parent_individuals_[parent1], source_subpop.parent_individuals_[parent2], child_sex);
-								}
+								do
+									parent2 = source_subpop.DrawParentUsingFitness(rng_state);	// note this does not prohibit selfing!
+								while (prevent_incidental_selfing && (parent2 == parent1));
+								
+								batch_parent1[migrant_count] = parent1;
+								batch_parent2[migrant_count] = parent2;
+							}
+						}
+						
+						// stage 2: counting-sort the children by first parent; when recording tree sequences we keep the draw order instead, since
+						// new nodes are expected to be added in pedigree ID order (see MergeStagedTreeSeqRecording()), across all chromosomes
+						if (recording_tree_sequence)
+						{
+							std::iota(batch_order, batch_order + migrants_to_generate, 0);
+						}
+						else
+						{
+							std::fill(batch_parent1_start, batch_parent1_start + source_parent_count + 1, 0);
+							
+							for (slim_popsize_t migrant_count = 0; migrant_count < migrants_to_generate; migrant_count++)
+								batch_parent1_start[batch_parent1[migrant_count] + 1]++;
+							
+							for (slim_popsize_t parent_index = 0; parent_index < source_parent_count; parent_index++)
+								batch_parent1_start[parent_index + 1] += batch_parent1_start[parent_index];
+							
+							for (slim_popsize_t migrant_count = 0; migrant_count < migrants_to_generate; migrant_count++)
+								batch_order[batch_parent1_start[batch_parent1[migrant_count]]++] = migrant_count;
+						}
+						
+						// stage 3: generate the children in sorted order
+						EIDOS_THREAD_COUNT(gEidos_OMP_threads_WF_REPRO);
+#pragma omp parallel for schedule(dynamic, 16) default(none) shared(migrants_to_generate, base_child_count, base_pedigree_id, p_subpop, source_subpop, child_sex, batch_parent1, batch_parent2, batch_order) if(will_parallelize) num_threads(thread_count)
+						for (slim_popsize_t order_index = 0; order_index < migrants_to_generate; order_index++)
+						{
+							// since the parents of upcoming children are known, prefetch their individuals, and a little later their haplosomes
+							if (order_index + 8 < migrants_to_generate)
+							{
+								slim_popsize_t ahead_count = batch_order[order_index + 8];
+								__builtin_prefetch(source_subpop.parent_individuals_[batch_parent1[ahead_count]]);
+								__builtin_prefetch(source_subpop.parent_individuals_[batch_parent2[ahead_count]]);
+							}
+							if (order_index + 4 < migrants_to_generate)
+							{
+								slim_popsize_t ahead_count = batch_order[order_index + 4];
+								Individual *ahead_parent1 = source_subpop.parent_individuals_[batch_parent1[ahead_count]];
+								Individual *ahead_parent2 = source_subpop.parent_individuals_[batch_parent2[ahead_count]];
+								__builtin_prefetch(ahead_parent1->haplosomes_[0]);
+								__builtin_prefetch(ahead_parent2->haplosomes_[0]);
 							}
-							EIDOS_BENCHMARK_END(EidosBenchmarkType::k_WF_REPRO);
 							
-							child_count += migrants_to_generate;
+							slim_popsize_t migrant_count = batch_order[order_index];
+							slim_popsize_t this_child_index = base_child_count + migrant_count;
+							Individual *new_child = p_subpop.child_individuals_[this_child_index];
+							new_child->migrant_ = (&source_subpop != &p_subpop);
+							
+							(p_subpop.*MungeIndividualCrossed_TEMPLATED)(new_child, base_pedigree_id + migrant_count, source_subpop.parent_individuals_[batch_parent1[migrant_count]], source_subpop.parent_individuals_[batch_parent2[migrant_count]], child_sex);
 						}
+						EIDOS_BENCHMARK_END(EidosBenchmarkType::k_WF_REPRO);
+						
+						child_count += migrants_to_generate;
 					}
 					else
 					{
@@ -2644,6 +2697,9 @@ void Population::EvolveSubpopulation(Subpopulation &p_subpop, bool p_mate_choice
 					}
 					
 #ifdef _OPENMP
+					if (will_parallelize && recording_tree_sequence)
+						species_.MergeStagedTreeSeqRecording();
+					
 					//if (will_parallelize)
 					//{
 					//	size_t actual_mutation_block_slots_remaining_POST = SLiMMemoryUsageForFreeMutations() / sizeof(Mutation);
@@ -2975,10 +3031,7 @@ void Population::HaplosomeCrossed(Chromosome &p_chromosome, Haplosome &p_child_h
 	
 	if (recording_tree_sequence)
 	{
-#pragma omp critical (TreeSeqNewHaplosome)
-		{
-			species_.RecordNewHaplosome(breakpoints_ptr, breakpoints_count, &p_child_haplosome, parent_haplosome_1, parent_haplosome_2);
-		}
+		species_.RecordNewHaplosome(breakpoints_ptr, breakpoints_count, &p_child_haplosome, parent_haplosome_1, parent_haplosome_2);
 	}
 	
 	// mutations are usually rare, so let's streamline the case where none occur
@@ -3271,10 +3324,7 @@ void Population::HaplosomeCrossed(Chromosome &p_chromosome, Haplosome &p_child_h
 						// TREE SEQUENCE RECORDING
 						if (recording_tree_sequence_mutations)
 						{
-#pragma omp critical (TreeSeqNewDerivedState)
-							{
-								species_.RecordNewDerivedState(&p_child_haplosome, new_mut->position_, *child_mutrun->derived_mutation_ids_at_position(new_mut->position_));
-							}
+							species_.RecordNewDerivedState(&p_child_haplosome, new_mut->position_, *child_mutrun->derived_mutation_ids_at_position(new_mut->position_));
 						}
 					}
 					else if (new_mut->state_ == MutationState::kNewMutation)	// new and needs to be disposed of
@@ -3421,10 +3471,7 @@ void Population::HaplosomeCrossed(Chromosome &p_chromosome, Haplosome &p_child_h
 										// TREE SEQUENCE RECORDING
 										if (recording_tree_sequence_mutations)
 										{
-#pragma omp critical (TreeSeqNewDerivedState)
-											{
-												species_.RecordNewDerivedState(&p_child_haplosome, new_mut->position_, *child_mutrun->derived_mutation_ids_at_position(new_mut->position_));
-											}
+											species_.RecordNewDerivedState(&p_child_haplosome, new_mut->position_, *child_mutrun->derived_mutation_ids_at_position(new_mut->position_));
 										}
 									}
 									else if (new_mut->state_ == MutationState::kNewMutation)	// new and needs to be disposed of
@@ -3475,10 +3522,7 @@ void Population::HaplosomeCrossed(Chromosome &p_chromosome, Haplosome &p_child_h
 									// TREE SEQUENCE RECORDING
 									if (recording_tree_sequence_mutations)
 									{
-#pragma omp critical (TreeSeqNewDerivedState)
-										{
-											species_.RecordNewDerivedState(&p_child_haplosome, new_mut->position_, *child_mutrun->derived_mutation_ids_at_position(new_mut->position_));
-										}
+										species_.RecordNewDerivedState(&p_child_haplosome, new_mut->position_, *child_mutrun->derived_mutation_ids_at_position(new_mut->position_));
 									}
 								}
 								else if (new_mut->state_ == MutationState::kNewMutation)	// new and needs to be disposed of
@@ -3630,10 +3674,7 @@ void Population::HaplosomeCrossed(Chromosome &p_chromosome, Haplosome &p_child_h
 							// TREE SEQUENCE RECORDING
 							if (recording_tree_sequence_mutations)
 							{
-#pragma omp critical (TreeSeqNewDerivedState)
-								{
-									species_.RecordNewDerivedState(&p_child_haplosome, new_mut->position_, *child_mutrun->derived_mutation_ids_at_position(new_mut->position_));
-								}
+								species_.RecordNewDerivedState(&p_child_haplosome, new_mut->position_, *child_mutrun->derived_mutation_ids_at_position(new_mut->position_));
 							}
 						}
 						else if (new_mut->state_ == MutationState::kNewMutation)	// new and needs to be disposed of
@@ -3733,10 +3774,7 @@ void Population::HaplosomeCloned(Chromosome &p_chromosome, Haplosome &p_child_ha
 	
 	if (recording_tree_sequence)
 	{
-#pragma omp critical (TreeSeqNewHaplosome)
-		{
-			species_.RecordNewHaplosome(nullptr, 0, &p_child_haplosome, parent_haplosome, nullptr);
-		}
+		species_.RecordNewHaplosome(nullptr, 0, &p_child_haplosome, parent_haplosome, nullptr);
 	}
 	
 	// mutations are usually rare, so let's streamline the case where none occur
@@ -3901,10 +3939,7 @@ void Population::HaplosomeCloned(Chromosome &p_chromosome, Haplosome &p_child_ha
 							// TREE SEQUENCE RECORDING
 							if (recording_tree_sequence_mutations)
 							{
-#pragma omp critical (TreeSeqNewDerivedState)
-								{
-									species_.RecordNewDerivedState(&p_child_haplosome, mutation_iter_pos, *child_run->derived_mutation_ids_at_position(mutation_iter_pos));
-								}
+								species_.RecordNewDerivedState(&p_child_haplosome, mutation_iter_pos, *child_run->derived_mutation_ids_at_position(mutation_iter_pos));
 							}
 						}
 						else if (new_mut->state_ == MutationState::kNewMutation)	// new and needs to be disposed of
@@ -4034,10 +4069,7 @@ void Population::HaplosomeRecombined(Chromosome &p_chromosome, Haplosome &p_chil
 	
 	if (recording_tree_sequence)
 	{
-#pragma omp critical (TreeSeqNewHaplosome)
-		{
-			species_.RecordNewHaplosome(breakpoints_ptr, breakpoints_count, &p_child_haplosome, parent_haplosome_1, parent_haplosome_2);
-		}
+		species_.RecordNewHaplosome(breakpoints_ptr, breakpoints_count, &p_child_haplosome, parent_haplosome_1, parent_haplosome_2);
 	}
 	
 	// mutations are usually rare, so let's streamline the case where none occur
@@ -4360,10 +4392,7 @@ void Population::HaplosomeRecombined(Chromosome &p_chromosome, Haplosome &p_chil
 									// TREE SEQUENCE RECORDING
 									if (recording_tree_sequence_mutations)
 									{
-#pragma omp critical (TreeSeqNewDerivedState)
-										{
-											species_.RecordNewDerivedState(&p_child_haplosome, new_mut->position_, *child_mutrun->derived_mutation_ids_at_position(new_mut->position_));
-										}
+										species_.RecordNewDerivedState(&p_child_haplosome, new_mut->position_, *child_mutrun->derived_mutation_ids_at_position(new_mut->position_));
 									}
 								}
 								else if (new_mut->state_ == MutationState::kNewMutation)	// new and needs to be disposed of
@@ -4414,10 +4443,7 @@ void Population::HaplosomeRecombined(Chromosome &p_chromosome, Haplosome &p_chil
 								// TREE SEQUENCE RECORDING
 								if (recording_tree_sequence_mutations)
 								{
-#pragma omp critical (TreeSeqNewDerivedState)
-									{
-										species_.RecordNewDerivedState(&p_child_haplosome, new_mut->position_, *child_mutrun->derived_mutation_ids_at_position(new_mut->position_));
-									}
+									species_.RecordNewDerivedState(&p_child_haplosome, new_mut->position_, *child_mutrun->derived_mutation_ids_at_position(new_mut->position_));
 								}
 							}
 							else if (new_mut->state_ == MutationState::kNewMutation)	// new and needs to be disposed of
@@ -4569,10 +4595,7 @@ void Population::HaplosomeRecombined(Chromosome &p_chromosome, Haplosome &p_chil
 						// TREE SEQUENCE RECORDING
 						if (recording_tree_sequence_mutations)
 						{
-#pragma omp critical (TreeSeqNewDerivedState)
-							{
-								species_.RecordNewDerivedState(&p_child_haplosome, new_mut->position_, *child_mutrun->derived_mutation_ids_at_position(new_mut->position_));
-							}
+							species_.RecordNewDerivedState(&p_child_haplosome, new_mut->position_, *child_mutrun->derived_mutation_ids_at_position(new_mut->position_));
 						}
 					}
 					else if (new_mut->state_ == MutationState::kNewMutation)	// new and needs to be disposed of
@@ -5004,10 +5027,7 @@ void Population::DoHeteroduplexRepair(std::vector<slim_position_t> &p_heterodupl
 		// Then we record the new derived state at every position that changed
 		for (slim_position_t changed_pos : repair_removals)
 		{
-#pragma omp critical (TreeSeqNewDerivedState)
-			{
-				species_.RecordNewDerivedState(p_child_haplosome, changed_pos, *p_child_haplosome->derived_mutation_ids_at_position(changed_pos));
-			}
+			species_.RecordNewDerivedState(p_child_haplosome, changed_pos, *p_child_haplosome->derived_mutation_ids_at_position(changed_pos));
 		}
 	}
 }
@@ -5209,6 +5229,8 @@ void Population::ValidateMutationFitnessCaches(void)
 		mut->cached_one_plus_dom_sel_ = (slim_selcoeff_t)std::max(0.0, 1.0 + dom_coeff * sel_coeff);
 		mut->cached_one_plus_hemizygousdom_sel_ = (slim_selcoeff_t)std::max(0.0, 1.0 + hemizygous_dom_coeff * sel_coeff);
 	}
+	
+	species_.fitness_effect_change_counter_++;
 }
 
 void Population::RecalculateFitness(slim_tick_t p_tick)
@@ -7838,6 +7860,14 @@ void Population::CheckMutationRegistry(bool p_check_haplosomes)
 	}
 }
 
+// write a column of values for PrintAllBinary(); empty columns (for fields that are not being output) write nothing
+template <typename T>
+static inline void WriteBinaryColumn(std::ostream &p_out, const std::vector<T> &p_column)
+{
+	if (p_column.size())
+		p_out.write(reinterpret_cast<const char *>(p_column.data()), (std::streamsize)(p_column.size() * sizeof(T)));
+}
+
 // print all mutations and all haplosomes to a stream in binary, for maximum reading speed
 // this is a binary version of Individual::PrintIndividuals_SLiM(), which is quite parallel
 void Population::PrintAllBinary(std::ostream &p_out, bool p_output_spatial_positions, bool p_output_ages, bool p_output_ancestral_nucs, bool p_output_pedigree_ids, bool p_output_object_tags, bool p_output_substitutions) const
@@ -7869,13 +7899,14 @@ void Population::PrintAllBinary(std::ostream &p_out, bool p_output_spatial_posit
 		p_out.write(reinterpret_cast<char *>(&endianness_tag), sizeof endianness_tag);
 		
 		// Write a format version tag
-		int32_t version_tag = 8;		// version 2 started with SLiM 2.1
+		int32_t version_tag = 9;		// version 2 started with SLiM 2.1
 										// version 3 started with SLiM 2.3
 										// version 4 started with SLiM 3.0, only when individual age is output
 										// version 5 started with SLiM 3.3, adding a "flags" field and nucleotide support
 										// version 6 started with SLiM 3.5, adding optional pedigree ID output with a new flag
 										// version 7 started with SLiM 4.0, changing generation to ticks and adding cycle
 										// version 8 started with SLiM 5.0, adding multiple chromosomes
+										// version 9 started with SLiM 5.3, writing genetic data in columnar form with shared mutation runs
 		p_out.write(reinterpret_cast<char *>(&version_tag), sizeof version_tag);
 		
 		// Write the size of a double
@@ -8094,11 +8125,23 @@ void Population::PrintAllBinary(std::ostream &p_out, bool p_output_spatial_posit
 		if (p_output_object_tags)
 			p_out.write(reinterpret_cast<const char *>(&chromosome->tag_value_), sizeof chromosome->tag_value_);
 		
-		// Find all polymorphisms
+		// Genetic data for the chromosome, in columnar form; new with version 9.  Each distinct mutation run is
+		// stored just once, however many haplosomes share it, as a list of row indices into a mutation table; each
+		// haplosome is then just a list of indices into that pool of runs.  This lets the reader construct each
+		// distinct run once, with a bulk copy, and share it among haplosomes just as we do in memory.
 		int first_haplosome_index = species_.FirstHaplosomeIndices()[chromosome_index];
 		int last_haplosome_index = species_.LastHaplosomeIndices()[chromosome_index];
-		PolymorphismMap polymorphisms;
+		int32_t mutrun_count = chromosome->mutrun_count_;
 		Mutation *mut_block_ptr = gSLiM_Mutation_Block;
+		std::vector<int32_t> mutation_rows(gSLiM_Mutation_Block_Capacity, -1);	// the mutation table row for each MutationIndex, or -1
+		std::vector<MutationIndex> row_mutations;									// the MutationIndex for each mutation table row
+		std::unordered_map<const MutationRun *, int32_t> run_pool_indices;			// the pool index for each distinct run
+		std::vector<int32_t> run_pool_run_indices;									// the mutation run index at which each pooled run is used
+		std::vector<int64_t> run_pool_offsets(1, 0);								// the start of each pooled run in run_pool_rows, plus the end
+		std::vector<int32_t> run_pool_rows;											// the mutation table rows for all pooled runs, concatenated
+		std::vector<int8_t> haplosome_null_flags;
+		std::vector<slim_usertag_t> haplosome_tags;
+		std::vector<int32_t> haplosome_runs;										// mutrun_count pool indices per haplosome; -1 for null haplosomes
 		
 		for (const std::pair<const slim_objectid_t,Subpopulation*> &subpop_pair : subpops_)			// go through all subpopulations
 		{
@@ -8110,173 +8153,127 @@ void Population::PrintAllBinary(std::ostream &p_out, bool p_output_spatial_posit
 				
 				for (int haplosome_index = first_haplosome_index; haplosome_index <= last_haplosome_index; haplosome_index++)
 				{
-					Haplosome *haplosome = haplosomes[haplosome_index];
+					const Haplosome *haplosome = haplosomes[haplosome_index];
 					
-					int mutrun_count = haplosome->mutrun_count_;
+					haplosome_null_flags.emplace_back(haplosome->IsNull() ? 1 : 0);
+					
+					if (p_output_object_tags)
+						haplosome_tags.emplace_back(haplosome->tag_value_);
+					
+					if (haplosome->IsNull())
+					{
+						haplosome_runs.insert(haplosome_runs.end(), mutrun_count, -1);
+						continue;
+					}
+					
+					if (haplosome->mutrun_count_ != mutrun_count)
+						EIDOS_TERMINATION << "ERROR (Population::PrintAllBinary): (internal error) haplosome mutation run count does not match its chromosome." << EidosTerminate();
 					
 					for (int run_index = 0; run_index < mutrun_count; ++run_index)
 					{
 						const MutationRun *mutrun = haplosome->mutruns_[run_index];
+						auto pool_iter = run_pool_indices.find(mutrun);
+						
+						if (pool_iter != run_pool_indices.end())
+						{
+							haplosome_runs.emplace_back(pool_iter->second);
+							continue;
+						}
+						
+						int32_t pool_index = (int32_t)run_pool_run_indices.size();
 						int mut_count = mutrun->size();
 						const MutationIndex *mut_ptr = mutrun->begin_pointer_const();
 						
 						for (int mut_index = 0; mut_index < mut_count; ++mut_index)
-							AddMutationToPolymorphismMap(&polymorphisms, mut_block_ptr + mut_ptr[mut_index]);
+						{
+							int32_t &row = mutation_rows[mut_ptr[mut_index]];
+							
+							if (row == -1)
+							{
+								row = (int32_t)row_mutations.size();
+								row_mutations.emplace_back(mut_ptr[mut_index]);
+							}
+							
+							run_pool_rows.emplace_back(row);
+						}
+						
+						run_pool_indices.emplace(mutrun, pool_index);
+						run_pool_run_indices.emplace_back(run_index);
+						run_pool_offsets.emplace_back((int64_t)run_pool_rows.size());
+						haplosome_runs.emplace_back(pool_index);
 					}
 				}
 			}
 		}
 		
-		// Write out the size of the mutation map, so we can allocate a vector rather than utilizing std::map when reading
-		int32_t mutation_map_size = (int32_t)polymorphisms.size();
+		// Mutations section: the mutation count, then one column per field
+		int32_t mutation_count = (int32_t)row_mutations.size();
 		
-		p_out.write(reinterpret_cast<char *>(&mutation_map_size), sizeof mutation_map_size);
+		p_out.write(reinterpret_cast<char *>(&mutation_count), sizeof mutation_count);
 		
-		// Mutations section
-		for (const PolymorphismPair &polymorphism_pair : polymorphisms)
 		{
-			const Polymorphism &polymorphism = polymorphism_pair.second;
-			const Mutation *mutation_ptr = polymorphism.mutation_ptr_;
-			const MutationType *mutation_type_ptr = mutation_ptr->mutation_type_ptr_;
-			
-			slim_polymorphismid_t polymorphism_id = polymorphism.polymorphism_id_;
-			int64_t mutation_id = mutation_ptr->mutation_id_;													// Added in version 2
-			slim_objectid_t mutation_type_id = mutation_type_ptr->mutation_type_id_;
-			slim_position_t position = mutation_ptr->position_;
-			slim_selcoeff_t selection_coeff = mutation_ptr->selection_coeff_;
-			slim_selcoeff_t dominance_coeff = mutation_type_ptr->dominance_coeff_;
-			// BCH 9/22/2021: Note that mutation_type_ptr->hemizygous_dominance_coeff_ is not saved; too edge to be bothered...
-			slim_objectid_t subpop_index = mutation_ptr->subpop_index_;
-			slim_tick_t origin_tick = mutation_ptr->origin_tick_;
-			slim_refcount_t prevalence = polymorphism.prevalence_;
-			int8_t nucleotide = mutation_ptr->nucleotide_;
-			
-			// Write a tag indicating we are starting a new mutation
-			int32_t mutation_start_tag = 0xFFFF0002;
-			
-			p_out.write(reinterpret_cast<char *>(&mutation_start_tag), sizeof mutation_start_tag);
-			
-			// Write the mutation data
-			p_out.write(reinterpret_cast<char *>(&polymorphism_id), sizeof polymorphism_id);
-			p_out.write(reinterpret_cast<char *>(&mutation_id), sizeof mutation_id);							// Added in version 2
-			p_out.write(reinterpret_cast<char *>(&mutation_type_id), sizeof mutation_type_id);
-			p_out.write(reinterpret_cast<char *>(&position), sizeof position);
-			p_out.write(reinterpret_cast<char *>(&selection_coeff), sizeof selection_coeff);
-			p_out.write(reinterpret_cast<char *>(&dominance_coeff), sizeof dominance_coeff);
-			p_out.write(reinterpret_cast<char *>(&subpop_index), sizeof subpop_index);
-			p_out.write(reinterpret_cast<char *>(&origin_tick), sizeof origin_tick);
-			p_out.write(reinterpret_cast<char *>(&prevalence), sizeof prevalence);
+			std::vector<int64_t> mutation_ids;
+			std::vector<slim_objectid_t> mutation_type_ids;
+			std::vector<slim_position_t> positions;
+			std::vector<slim_selcoeff_t> selection_coeffs;
+			std::vector<slim_selcoeff_t> dominance_coeffs;		// BCH 9/22/2021: Note that mutation_type_ptr->hemizygous_dominance_coeff_ is not saved; too edge to be bothered...
+			std::vector<slim_objectid_t> subpop_indices;
+			std::vector<slim_tick_t> origin_ticks;
+			std::vector<int8_t> nucleotides;
+			std::vector<slim_usertag_t> mutation_tags;
 			
-			if (has_nucleotides)
-				p_out.write(reinterpret_cast<char *>(&nucleotide), sizeof nucleotide);							// added in version 5
-			
-			if (p_output_object_tags)
-				p_out.write(reinterpret_cast<const char *>(&mutation_ptr->tag_value_), sizeof mutation_ptr->tag_value_);
+			for (MutationIndex mut_index : row_mutations)
+			{
+				const Mutation *mutation_ptr = mut_block_ptr + mut_index;
+				
+				mutation_ids.emplace_back(mutation_ptr->mutation_id_);
+				mutation_type_ids.emplace_back(mutation_ptr->mutation_type_ptr_->mutation_type_id_);
+				positions.emplace_back(mutation_ptr->position_);
+				selection_coeffs.emplace_back(mutation_ptr->selection_coeff_);
+				dominance_coeffs.emplace_back(mutation_ptr->mutation_type_ptr_->dominance_coeff_);
+				subpop_indices.emplace_back(mutation_ptr->subpop_index_);
+				origin_ticks.emplace_back(mutation_ptr->origin_tick_);
+				
+				if (has_nucleotides)
+					nucleotides.emplace_back(mutation_ptr->nucleotide_);
+				if (p_output_object_tags)
+					mutation_tags.emplace_back(mutation_ptr->tag_value_);
+			}
 			
-			// now will come either a mutation start tag, or a section end tag
+			WriteBinaryColumn(p_out, mutation_ids);
+			WriteBinaryColumn(p_out, mutation_type_ids);
+			WriteBinaryColumn(p_out, positions);
+			WriteBinaryColumn(p_out, selection_coeffs);
+			WriteBinaryColumn(p_out, dominance_coeffs);
+			WriteBinaryColumn(p_out, subpop_indices);
+			WriteBinaryColumn(p_out, origin_ticks);
+			WriteBinaryColumn(p_out, nucleotides);		// empty unless has_nucleotides
+			WriteBinaryColumn(p_out, mutation_tags);	// empty unless p_output_object_tags
 		}
 		
 		// Write a tag indicating the section has ended
 		p_out.write(reinterpret_cast<char *>(&section_end_tag), sizeof section_end_tag);
 		
-		// Haplosomes section
-		bool use_16_bit = (mutation_map_size <= UINT16_MAX - 1);	// 0xFFFF is reserved as the start of our various tags
+		// Mutation runs section: the run count per haplosome, the pool size, and the pooled rows count, then the pool columns
+		int32_t run_pool_size = (int32_t)run_pool_run_indices.size();
+		int64_t run_pool_rows_size = (int64_t)run_pool_rows.size();
 		
-		for (const std::pair<const slim_objectid_t,Subpopulation*> &subpop_pair : subpops_)			// go through all subpopulations
-		{
-			Subpopulation *subpop = subpop_pair.second;
-			slim_objectid_t subpop_id = subpop_pair.first + 1;	// + 1 so it doesn't ever collide with the section end tag
-			
-			for (Individual *ind : subpop->parent_individuals_)
-			{
-				Haplosome **haplosomes = ind->haplosomes_;
-				
-				for (int haplosome_index = first_haplosome_index; haplosome_index <= last_haplosome_index; haplosome_index++)
-				{
-					const Haplosome *haplosome = haplosomes[haplosome_index];
-					
-					// Write out the haplosome header; start with the subpop id + 1 to guarantee that the first 32 bits are != section_end_tag
-					p_out.write(reinterpret_cast<char *>(&subpop_id), sizeof subpop_id);	// + 1
-					
-					if (p_output_object_tags)
-						p_out.write(reinterpret_cast<const char *>(&haplosome->tag_value_), sizeof haplosome->tag_value_);
-					
-					// Write out the mutation list
-					if (haplosome->IsNull())
-					{
-						// null haplosomes get a 32-bit flag value written instead of a mutation count
-						int32_t null_haplosome_tag = 0xFFFF1000;
-						
-						p_out.write(reinterpret_cast<char *>(&null_haplosome_tag), sizeof null_haplosome_tag);
-					}
-					else
-					{
-						// write a 32-bit mutation count
-						{
-							int32_t total_mutations = haplosome->mutation_count();
-							
-							p_out.write(reinterpret_cast<char *>(&total_mutations), sizeof total_mutations);
-						}
-						
-						if (use_16_bit)
-						{
-							// Write out 16-bit mutation tags
-							int mutrun_count = haplosome->mutrun_count_;
-							
-							for (int run_index = 0; run_index < mutrun_count; ++run_index)
-							{
-								const MutationRun *mutrun = haplosome->mutruns_[run_index];
-								int mut_count = mutrun->size();
-								const MutationIndex *mut_ptr = mutrun->begin_pointer_const();
-								
-								for (int mut_index = 0; mut_index < mut_count; ++mut_index)
-								{
-									slim_polymorphismid_t polymorphism_id = FindMutationInPolymorphismMap(polymorphisms, mut_block_ptr + mut_ptr[mut_index]);
-									
-									if (polymorphism_id == -1)
-										EIDOS_TERMINATION << "ERROR (Population::PrintAllBinary): (internal error) polymorphism not found." << EidosTerminate();
-									
-									if (polymorphism_id <= UINT16_MAX - 1)
-									{
-										uint16_t id_16 = (uint16_t)polymorphism_id;
-										
-										p_out.write(reinterpret_cast<char *>(&id_16), sizeof id_16);
-									}
-									else
-									{
-										EIDOS_TERMINATION << "ERROR (Population::PrintAllBinary): (internal error) mutation id out of 16-bit bounds." << EidosTerminate();
-									}
-								}
-							}
-						}
-						else
-						{
-							// Write out 32-bit mutation tags
-							int mutrun_count = haplosome->mutrun_count_;
-							
-							for (int run_index = 0; run_index < mutrun_count; ++run_index)
-							{
-								const MutationRun *mutrun = haplosome->mutruns_[run_index];
-								int mut_count = mutrun->size();
-								const MutationIndex *mut_ptr = mutrun->begin_pointer_const();
-								
-								for (int mut_index = 0; mut_index < mut_count; ++mut_index)
-								{
-									slim_polymorphismid_t polymorphism_id = FindMutationInPolymorphismMap(polymorphisms, mut_block_ptr + mut_ptr[mut_index]);
-									
-									if (polymorphism_id == -1)
-										EIDOS_TERMINATION << "ERROR (Population::PrintAllBinary): (internal error) polymorphism not found." << EidosTerminate();
-									
-									p_out.write(reinterpret_cast<char *>(&polymorphism_id), sizeof polymorphism_id);
-								}
-							}
-						}
-						
-						// now will come either an individual index, or a section end tag
-					}
-				}
-			}
-		}
+		p_out.write(reinterpret_cast<char *>(&mutrun_count), sizeof mutrun_count);
+		p_out.write(reinterpret_cast<char *>(&run_pool_size), sizeof run_pool_size);
+		p_out.write(reinterpret_cast<char *>(&run_pool_rows_size), sizeof run_pool_rows_size);
+		
+		WriteBinaryColumn(p_out, run_pool_run_indices);
+		WriteBinaryColumn(p_out, run_pool_offsets);
+		WriteBinaryColumn(p_out, run_pool_rows);
+		
+		// Haplosomes section: the haplosome count, then the columns for the haplosomes, in individual order
+		int32_t haplosome_count = (int32_t)haplosome_null_flags.size();
+		
+		p_out.write(reinterpret_cast<char *>(&haplosome_count), sizeof haplosome_count);
+		
+		WriteBinaryColumn(p_out, haplosome_null_flags);
+		WriteBinaryColumn(p_out, haplosome_tags);		// empty unless p_output_object_tags
+		WriteBinaryColumn(p_out, haplosome_runs);
 		
 		// Write a tag indicating the haplosomes section has ended
 		p_out.write(reinterpret_cast<char *>(&section_end_tag), sizeof section_end_tag);
@@ -1318,6 +1318,9 @@ SLiMEidosBlock::SLiMEidosBlock(slim_objectid_t p_id, const std::string &p_script
 
 SLiMEidosBlock::~SLiMEidosBlock(void)
 {
+	delete bytecode_;
+	bytecode_ = nullptr;
+	
 	delete script_;
 }
 
@@ -1430,6 +1433,36 @@ void SLiMEidosBlock::ScanTreeForIdentifiersUsed(void)
 	}
 }
 
+const std::vector<EidosGlobalStringID> *SLiMEidosBlock::BytecodeParametersForType(SLiMEidosBlockType p_type)
+{
+	// Only callbacks that are called very often and that return a simple value are worth compiling; callbacks like modifyChild()
+	// and reproduction() are almost always executed for their side effects, which the bytecode compiler does not handle
+	static const std::vector<EidosGlobalStringID> mutationEffect_parameters = {gID_self, gID_mut, gID_effect, gID_individual, gID_subpop, gID_homozygous};
+	static const std::vector<EidosGlobalStringID> fitnessEffect_parameters = {gID_self, gID_individual, gID_subpop};
+	static const std::vector<EidosGlobalStringID> interaction_parameters = {gID_self, gID_distance, gID_strength, gID_receiver, gID_exerter};
+	static const std::vector<EidosGlobalStringID> survival_parameters = {gID_self, gID_individual, gID_subpop, gID_surviving, gID_fitness, gID_draw};
+	
+	switch (p_type)
+	{
+		case SLiMEidosBlockType::SLiMEidosMutationEffectCallback:	return &mutationEffect_parameters;
+		case SLiMEidosBlockType::SLiMEidosFitnessEffectCallback:	return &fitnessEffect_parameters;
+		case SLiMEidosBlockType::SLiMEidosInteractionCallback:		return &interaction_parameters;
+		case SLiMEidosBlockType::SLiMEidosSurvivalCallback:			return &survival_parameters;
+		default:													return nullptr;
+	}
+}
+
+void SLiMEidosBlock::CompileBytecode(void)
+{
+	const std::vector<EidosGlobalStringID> *parameters = BytecodeParametersForType(type_);
+	
+	delete bytecode_;
+	bytecode_ = nullptr;
+	
+	if (parameters && compound_statement_node_)
+		bytecode_ = EidosBytecodeProgram::Compile(compound_statement_node_, *parameters);
+}
+
 #ifdef SLIMGUI
 // used by SLiMgui to generate the scheduling log's output
 void SLiMEidosBlock::PrintDeclaration(std::ostream& p_out, Community *p_community)
@@ -1722,6 +1755,10 @@ EidosValue_SP SLiMEidosBlock::GetProperty(EidosGlobalStringID p_property_id)
 			// variables
 		case gID_active:
 			return EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Int(block_active_));
+		case gID_compiled:
+			return ((bytecode_ && bytecode_enabled_) ? gStaticEidosValue_LogicalT : gStaticEidosValue_LogicalF);
+		case gID_vectorized:
+			return (vectorized_ ? gStaticEidosValue_LogicalT : gStaticEidosValue_LogicalF);
 		case gID_tag:
 		{
 			slim_usertag_t tag_value = tag_value_;
@@ -1755,6 +1792,27 @@ void SLiMEidosBlock::SetProperty(EidosGlobalStringID p_property_id, const EidosV
 			return;
 		}
 	
+		case gID_compiled:
+		{
+			eidos_logical_t value = p_value.LogicalAtIndex_NOCAST(0, nullptr);
+			
+			if (value && !bytecode_)
+				EIDOS_TERMINATION << "ERROR (SLiMEidosBlock::SetProperty): property compiled cannot be set to T for this script block, because its body could not be compiled." << EidosTerminate();
+			
+			bytecode_enabled_ = value;
+			return;
+		}
+		case gID_vectorized:
+		{
+			eidos_logical_t value = p_value.LogicalAtIndex_NOCAST(0, nullptr);
+			
+			if (value && (type_ != SLiMEidosBlockType::SLiMEidosMutationEffectCallback) && (type_ != SLiMEidosBlockType::SLiMEidosFitnessEffectCallback) &&
+				(type_ != SLiMEidosBlockType::SLiMEidosSurvivalCallback) && (type_ != SLiMEidosBlockType::SLiMEidosReproductionCallback))
+				EIDOS_TERMINATION << "ERROR (SLiMEidosBlock::SetProperty): property vectorized can only be set to T for mutationEffect(), fitnessEffect(), survival(), and reproduction() callbacks." << EidosTerminate();
+			
+			vectorized_ = value;
+			return;
+		}
 		case gID_tag:
 		{
 			slim_usertag_t value = SLiMCastToUsertagTypeOrRaise(p_value.IntAtIndex_NOCAST(0, nullptr));
@@ -1791,6 +1849,7 @@ const std::vector<EidosPropertySignature_CSP> *SLiMEidosBlock_Class::Properties(
 		properties = new std::vector<EidosPropertySignature_CSP>(*super::Properties());
 		
 		properties->emplace_back((EidosPropertySignature *)(new EidosPropertySignature(gStr_active,			false,	kEidosValueMaskInt | kEidosValueMaskSingleton)));
+		properties->emplace_back((EidosPropertySignature *)(new EidosPropertySignature(gStr_compiled,		false,	kEidosValueMaskLogical | kEidosValueMaskSingleton)));
 		properties->emplace_back((EidosPropertySignature *)(new EidosPropertySignature(gStr_id,				true,	kEidosValueMaskInt | kEidosValueMaskSingleton)));
 		properties->emplace_back((EidosPropertySignature *)(new EidosPropertySignature(gEidosStr_start,		true,	kEidosValueMaskInt | kEidosValueMaskSingleton)));
 		properties->emplace_back((EidosPropertySignature *)(new EidosPropertySignature(gEidosStr_end,		true,	kEidosValueMaskInt | kEidosValueMaskSingleton)));
@@ -1799,6 +1858,7 @@ const std::vector<EidosPropertySignature_CSP> *SLiMEidosBlock_Class::Properties(
 		properties->emplace_back((EidosPropertySignature *)(new EidosPropertySignature(gStr_speciesSpec,		true,	kEidosValueMaskObject, gSLiM_Species_Class)));
 		properties->emplace_back((EidosPropertySignature *)(new EidosPropertySignature(gStr_tag,			false,	kEidosValueMaskInt | kEidosValueMaskSingleton)));
 		properties->emplace_back((EidosPropertySignature *)(new EidosPropertySignature(gStr_ticksSpec,		true,	kEidosValueMaskObject, gSLiM_Species_Class)));
+		properties->emplace_back((EidosPropertySignature *)(new EidosPropertySignature(gStr_vectorized,		false,	kEidosValueMaskLogical | kEidosValueMaskSingleton)));
 		
 		std::sort(properties->begin(), properties->end(), CompareEidosPropertySignatures);
 	}
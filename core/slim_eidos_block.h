@@ -34,6 +34,7 @@
 #include "eidos_functions.h"
 #include "eidos_type_table.h"
 #include "eidos_type_interpreter.h"
+#include "eidos_bytecode.h"
 
 #include <unordered_set>
 
@@ -209,6 +210,19 @@ public:
 	double cached_opt_C_ = 0.0;
 	double cached_opt_D_ = 0.0;
 	
+	// A compiled bytecode form of the block's body, for the callback types that support it (see CompileBytecode()); if the
+	// body could not be compiled, bytecode_ is nullptr and the body is always interpreted.  bytecode_enabled_ backs the
+	// compiled property, which allows compiled execution to be switched off per block so that results can be compared.
+	EidosBytecodeProgram *bytecode_ = nullptr;					// OWNED
+	bool bytecode_enabled_ = true;
+	
+	// If vectorized_ is true (set through the vectorized property, only for mutationEffect(), fitnessEffect(), survival(), and
+	// reproduction() callbacks), the callback is called once per subpopulation with its parameters bound as parallel vectors; see
+	// the ApplyVectorized...Callback() methods of Subpopulation.  Bodies that are constant or have a cached optimization keep the
+	// per-element path, which is faster for them.
+	bool vectorized_ = false;
+	inline bool RunsVectorized(void) const { return vectorized_ && !compound_statement_node_->cached_return_value_ && !has_cached_optimization_; }
+	
 	
 	static SLiMEidosBlockType BlockTypeForRootNode(EidosASTNode *p_root_node);		// get the block type for a node without actually constructing the block
 	
@@ -229,6 +243,11 @@ public:
 	
 	void PrintDeclaration(std::ostream& p_out, Community *p_community);
 	
+	// Compile the block's body to bytecode, if its type supports that and its body is simple enough; called by Community::OptimizeScriptBlock()
+	// The arguments passed to EidosBytecodeProgram::Execute() by each callback's call site must be in the order given by BytecodeParametersForType()
+	static const std::vector<EidosGlobalStringID> *BytecodeParametersForType(SLiMEidosBlockType p_type);
+	void CompileBytecode(void);
+	
 	//
 	// Eidos support
 	//
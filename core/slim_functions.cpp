@@ -28,6 +28,7 @@
 #include "mutation_type.h"
 #include "individual.h"
 #include "eidos_rng.h"
+#include "eidos_simd.h"
 #include "json.hpp"
 
 #include <string>
@@ -36,19 +37,12 @@
 #include <algorithm>
 
 
-extern const char *gSLiMSourceCode_calcDxy;
-extern const char *gSLiMSourceCode_calcFST;
 extern const char *gSLiMSourceCode_calcVA;
-extern const char *gSLiMSourceCode_calcLD_D;
-extern const char *gSLiMSourceCode_calcLD_Rsquared;
 extern const char *gSLiMSourceCode_calcMeanFroh;
 extern const char *gSLiMSourceCode_calcPairHeterozygosity;
 extern const char *gSLiMSourceCode_calcHeterozygosity;
-extern const char *gSLiMSourceCode_calcWattersonsTheta;
 extern const char *gSLiMSourceCode_calcInbreedingLoad;
-extern const char *gSLiMSourceCode_calcPi;
 extern const char *gSLiMSourceCode_calcSFS;
-extern const char *gSLiMSourceCode_calcTajimasD;
 
 extern const char *gSLiMSourceCode_initializeMutationRateFromFile;
 extern const char *gSLiMSourceCode_initializeRecombinationRateFromFile;
@@ -74,20 +68,20 @@ const std::vector<EidosFunctionSignature_CSP> *Community::SLiMFunctionSignatures
 		sim_func_signatures_.emplace_back((EidosFunctionSignature *)(new EidosFunctionSignature("nucleotidesToCodons", SLiM_ExecuteFunction_nucleotidesToCodons, kEidosValueMaskInt, "SLiM"))->AddIntString("sequence"));
 		sim_func_signatures_.emplace_back((EidosFunctionSignature *)(new EidosFunctionSignature("randomNucleotides", SLiM_ExecuteFunction_randomNucleotides, kEidosValueMaskInt | kEidosValueMaskString, "SLiM"))->AddInt_S("length")->AddNumeric_ON("basis", gStaticEidosValueNULL)->AddString_OS("format", EidosValue_String_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_String("string"))));
 		
-		// Population genetics utilities (implemented with Eidos code)
-		sim_func_signatures_.emplace_back((EidosFunctionSignature *)(new EidosFunctionSignature("calcDxy", gSLiMSourceCode_calcDxy, kEidosValueMaskFloat | kEidosValueMaskSingleton, "SLiM"))->AddObject("haplosomes1", gSLiM_Haplosome_Class)->AddObject("haplosomes2", gSLiM_Haplosome_Class)->AddObject_ON("muts", gSLiM_Mutation_Class, gStaticEidosValueNULL)->AddInt_OSN("start", gStaticEidosValueNULL)->AddInt_OSN("end", gStaticEidosValueNULL)->AddLogical_OS("normalize", gStaticEidosValue_LogicalF));
-		sim_func_signatures_.emplace_back((EidosFunctionSignature *)(new EidosFunctionSignature("calcFST", gSLiMSourceCode_calcFST, kEidosValueMaskFloat | kEidosValueMaskSingleton, "SLiM"))->AddObject("haplosomes1", gSLiM_Haplosome_Class)->AddObject("haplosomes2", gSLiM_Haplosome_Class)->AddObject_ON("muts", gSLiM_Mutation_Class, gStaticEidosValueNULL)->AddInt_OSN("start", gStaticEidosValueNULL)->AddInt_OSN("end", gStaticEidosValueNULL));
+		// Population genetics utilities (implemented with Eidos code, except for a few performance-critical functions implemented natively)
+		sim_func_signatures_.emplace_back((EidosFunctionSignature *)(new EidosFunctionSignature("calcDxy", SLiM_ExecuteFunction_calcDxy, kEidosValueMaskFloat | kEidosValueMaskSingleton, "SLiM"))->AddObject("haplosomes1", gSLiM_Haplosome_Class)->AddObject("haplosomes2", gSLiM_Haplosome_Class)->AddObject_ON("muts", gSLiM_Mutation_Class, gStaticEidosValueNULL)->AddInt_OSN("start", gStaticEidosValueNULL)->AddInt_OSN("end", gStaticEidosValueNULL)->AddLogical_OS("normalize", gStaticEidosValue_LogicalF));
+		sim_func_signatures_.emplace_back((EidosFunctionSignature *)(new EidosFunctionSignature("calcFST", SLiM_ExecuteFunction_calcFST, kEidosValueMaskFloat | kEidosValueMaskSingleton, "SLiM"))->AddObject("haplosomes1", gSLiM_Haplosome_Class)->AddObject("haplosomes2", gSLiM_Haplosome_Class)->AddObject_ON("muts", gSLiM_Mutation_Class, gStaticEidosValueNULL)->AddInt_OSN("start", gStaticEidosValueNULL)->AddInt_OSN("end", gStaticEidosValueNULL));
 		sim_func_signatures_.emplace_back((EidosFunctionSignature *)(new EidosFunctionSignature("calcVA", gSLiMSourceCode_calcVA, kEidosValueMaskFloat | kEidosValueMaskSingleton, "SLiM"))->AddObject("individuals", gSLiM_Individual_Class)->AddIntObject_S("mutType", gSLiM_MutationType_Class));
-		sim_func_signatures_.emplace_back((EidosFunctionSignature *)(new EidosFunctionSignature("calcLD_D", gSLiMSourceCode_calcLD_D, kEidosValueMaskFloat, "SLiM"))->AddObject_S("mut1", gSLiM_Mutation_Class)->AddObject_ON("mut2", gSLiM_Mutation_Class, gStaticEidosValueNULL)->AddObject_ON("haplosomes", gSLiM_Haplosome_Class, gStaticEidosValueNULL));
-		sim_func_signatures_.emplace_back((EidosFunctionSignature *)(new EidosFunctionSignature("calcLD_Rsquared", gSLiMSourceCode_calcLD_Rsquared, kEidosValueMaskFloat, "SLiM"))->AddObject_S("mut1", gSLiM_Mutation_Class)->AddObject_ON("mut2", gSLiM_Mutation_Class, gStaticEidosValueNULL)->AddObject_ON("haplosomes", gSLiM_Haplosome_Class, gStaticEidosValueNULL)->AddLogical_OS("squared", gStaticEidosValue_LogicalT));
+		sim_func_signatures_.emplace_back((EidosFunctionSignature *)(new EidosFunctionSignature("calcLD_D", SLiM_ExecuteFunction_calcLD_D, kEidosValueMaskFloat, "SLiM"))->AddObject("mut1", gSLiM_Mutation_Class)->AddObject_ON("mut2", gSLiM_Mutation_Class, gStaticEidosValueNULL)->AddObject_ON("haplosomes", gSLiM_Haplosome_Class, gStaticEidosValueNULL)->AddInt_OSN("maxDistance", gStaticEidosValueNULL));
+		sim_func_signatures_.emplace_back((EidosFunctionSignature *)(new EidosFunctionSignature("calcLD_Rsquared", SLiM_ExecuteFunction_calcLD_Rsquared, kEidosValueMaskFloat, "SLiM"))->AddObject("mut1", gSLiM_Mutation_Class)->AddObject_ON("mut2", gSLiM_Mutation_Class, gStaticEidosValueNULL)->AddObject_ON("haplosomes", gSLiM_Haplosome_Class, gStaticEidosValueNULL)->AddLogical_OS("squared", gStaticEidosValue_LogicalT)->AddInt_OSN("maxDistance", gStaticEidosValueNULL));
 		sim_func_signatures_.emplace_back((EidosFunctionSignature *)(new EidosFunctionSignature("calcMeanFroh", gSLiMSourceCode_calcMeanFroh, kEidosValueMaskFloat | kEidosValueMaskSingleton, "SLiM"))->AddObject("individuals", gSLiM_Individual_Class)->AddInt_OS("minimumLength", EidosValue_Int_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Int(1000000)))->AddArgWithDefault(kEidosValueMaskNULL | kEidosValueMaskInt | kEidosValueMaskString | kEidosValueMaskObject | kEidosValueMaskOptional | kEidosValueMaskSingleton, "chromosome", gSLiM_Chromosome_Class, gStaticEidosValueNULL));
 		sim_func_signatures_.emplace_back((EidosFunctionSignature *)(new EidosFunctionSignature("calcPairHeterozygosity", gSLiMSourceCode_calcPairHeterozygosity, kEidosValueMaskFloat | kEidosValueMaskSingleton, "SLiM"))->AddObject_S("haplosome1", gSLiM_Haplosome_Class)->AddObject_S("haplosome2", gSLiM_Haplosome_Class)->AddInt_OSN("start", gStaticEidosValueNULL)->AddInt_OSN("end", gStaticEidosValueNULL)->AddLogical_OS("infiniteSites", gStaticEidosValue_LogicalT));
 		sim_func_signatures_.emplace_back((EidosFunctionSignature *)(new EidosFunctionSignature("calcHeterozygosity", gSLiMSourceCode_calcHeterozygosity, kEidosValueMaskFloat | kEidosValueMaskSingleton, "SLiM"))->AddObject("haplosomes", gSLiM_Haplosome_Class)->AddObject_ON("muts", gSLiM_Mutation_Class, gStaticEidosValueNULL)->AddInt_OSN("start", gStaticEidosValueNULL)->AddInt_OSN("end", gStaticEidosValueNULL));
-		sim_func_signatures_.emplace_back((EidosFunctionSignature *)(new EidosFunctionSignature("calcWattersonsTheta", gSLiMSourceCode_calcWattersonsTheta, kEidosValueMaskFloat | kEidosValueMaskSingleton, "SLiM"))->AddObject("haplosomes", gSLiM_Haplosome_Class)->AddObject_ON("muts", gSLiM_Mutation_Class, gStaticEidosValueNULL)->AddInt_OSN("start", gStaticEidosValueNULL)->AddInt_OSN("end", gStaticEidosValueNULL));
+		sim_func_signatures_.emplace_back((EidosFunctionSignature *)(new EidosFunctionSignature("calcWattersonsTheta", SLiM_ExecuteFunction_calcWattersonsTheta, kEidosValueMaskFloat | kEidosValueMaskSingleton, "SLiM"))->AddObject("haplosomes", gSLiM_Haplosome_Class)->AddObject_ON("muts", gSLiM_Mutation_Class, gStaticEidosValueNULL)->AddInt_OSN("start", gStaticEidosValueNULL)->AddInt_OSN("end", gStaticEidosValueNULL));
 		sim_func_signatures_.emplace_back((EidosFunctionSignature *)(new EidosFunctionSignature("calcInbreedingLoad", gSLiMSourceCode_calcInbreedingLoad, kEidosValueMaskFloat | kEidosValueMaskSingleton, "SLiM"))->AddObject("haplosomes", gSLiM_Haplosome_Class)->AddIntObject_OSN("mutType", gSLiM_MutationType_Class, gStaticEidosValueNULL));
-		sim_func_signatures_.emplace_back((EidosFunctionSignature *)(new EidosFunctionSignature("calcPi", gSLiMSourceCode_calcPi, kEidosValueMaskFloat | kEidosValueMaskSingleton, "SLiM"))->AddObject("haplosomes", gSLiM_Haplosome_Class)->AddObject_ON("muts", gSLiM_Mutation_Class, gStaticEidosValueNULL)->AddInt_OSN("start", gStaticEidosValueNULL)->AddInt_OSN("end", gStaticEidosValueNULL));
+		sim_func_signatures_.emplace_back((EidosFunctionSignature *)(new EidosFunctionSignature("calcPi", SLiM_ExecuteFunction_calcPi, kEidosValueMaskFloat | kEidosValueMaskSingleton, "SLiM"))->AddObject("haplosomes", gSLiM_Haplosome_Class)->AddObject_ON("muts", gSLiM_Mutation_Class, gStaticEidosValueNULL)->AddInt_OSN("start", gStaticEidosValueNULL)->AddInt_OSN("end", gStaticEidosValueNULL));
 		sim_func_signatures_.emplace_back((EidosFunctionSignature *)(new EidosFunctionSignature("calcSFS", gSLiMSourceCode_calcSFS, kEidosValueMaskNumeric, "SLiM"))->AddInt_OSN("binCount", gStaticEidosValueNULL)->AddObject_ON("haplosomes", gSLiM_Haplosome_Class, gStaticEidosValueNULL)->AddObject_ON("muts", gSLiM_Mutation_Class, gStaticEidosValueNULL)->AddString_OS("metric", EidosValue_String_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_String("density")))->AddLogical_OS("fold", gStaticEidosValue_LogicalF));
-		sim_func_signatures_.emplace_back((EidosFunctionSignature *)(new EidosFunctionSignature("calcTajimasD", gSLiMSourceCode_calcTajimasD, kEidosValueMaskFloat | kEidosValueMaskSingleton, "SLiM"))->AddObject("haplosomes", gSLiM_Haplosome_Class)->AddObject_ON("muts", gSLiM_Mutation_Class, gStaticEidosValueNULL)->AddInt_OSN("start", gStaticEidosValueNULL)->AddInt_OSN("end", gStaticEidosValueNULL));
+		sim_func_signatures_.emplace_back((EidosFunctionSignature *)(new EidosFunctionSignature("calcTajimasD", SLiM_ExecuteFunction_calcTajimasD, kEidosValueMaskFloat | kEidosValueMaskSingleton, "SLiM"))->AddObject("haplosomes", gSLiM_Haplosome_Class)->AddObject_ON("muts", gSLiM_Mutation_Class, gStaticEidosValueNULL)->AddInt_OSN("start", gStaticEidosValueNULL)->AddInt_OSN("end", gStaticEidosValueNULL));
 		
 		// Other built-in SLiM functions
 		sim_func_signatures_.emplace_back((EidosFunctionSignature *)(new EidosFunctionSignature("summarizeIndividuals", SLiM_ExecuteFunction_summarizeIndividuals, kEidosValueMaskFloat, "SLiM"))->AddObject("individuals", gSLiM_Individual_Class)->AddInt("dim")->AddNumeric("spatialBounds")->AddString_S("operation")->AddLogicalEquiv_OSN("empty", gStaticEidosValue_Float0)->AddLogical_OS("perUnitArea", gStaticEidosValue_LogicalF)->AddString_OSN("spatiality", gStaticEidosValueNULL));
@@ -122,162 +116,10 @@ const std::vector<EidosFunctionSignature_CSP> *Community::SLiMFunctionSignatures
 #pragma mark Population genetics utilities
 #pragma mark -
 
-// These are implemented in Eidos, for transparency/modifiability.  These strings are globals mostly so the
+// These are implemented in Eidos, for transparency/modifiability; a few performance-critical functions are instead
+// implemented natively, below, after the Eidos-based functions.  These strings are globals mostly so the
 // formatting of the code looks nice in Xcode; they are used only by Community::SLiMFunctionSignatures().
 
-#pragma mark (float$)calcDxy(object<Haplosome> haplosomes1, object<Haplosome> haplosomes2, [No<Mutation> muts = NULL], [Ni$ start = NULL], [Ni$ end = NULL], [logical$ normalize = F])
-const char *gSLiMSourceCode_calcDxy = 
-R"V0G0N({
-	n1 = haplosomes1.length();
-	n2 = haplosomes2.length();
-	if (n1 == 0 | n2 == 0)
-		stop("ERROR (calcDxy): haplosomes1 and haplosomes2 must both be non-empty.");
-	
-	species = haplosomes1[0].individual.subpopulation.species;
-	if (community.allSpecies.length() > 1)
-	{
-		if (any(c(haplosomes1, haplosomes2).individual.subpopulation.species != species))
-			stop("ERROR (calcDxy): all haplosomes must belong to the same species.");
-		if (!isNULL(muts))
-			if (any(muts.mutationType.species != species))
-				stop("ERROR (calcDxy): all mutations must belong to the same species as the haplosomes.");
-	}
-	
-	chromosome = haplosomes1[0].chromosome;
-	if (species.chromosomes.length() > 1)
-	{
-		if (any(c(haplosomes1, haplosomes2).chromosome != chromosome))
-			stop("ERROR (calcDxy): all haplosomes must be associated with the same chromosome.");
-		if (!isNULL(muts))
-			if (any(muts.chromosome != chromosome))
-				stop("ERROR (calcDxy): all mutations must be associated with the same chromosome as the haplosomes.");
-	}
-	length = chromosome.length;
-	
-	if (isNULL(muts))
-		muts = species.subsetMutations(chromosome=chromosome);
-	
-	// handle windowing
-	if (!isNULL(start) & !isNULL(end))
-	{
-		if (start > end)
-			stop("ERROR (calcDxy): start must be less than or equal to end.");
-		if ((start < 0) | (end >= length))
-			stop("ERROR (calcDxy): start and end must be within the bounds of the focal chromosome");
-		length = end - start + 1;
-		mpos = muts.position;
-		muts = muts[(mpos >= start) & (mpos <= end)];
-	}
-	else if (isNULL(start) & isNULL(end))
-	{
-		start = 0;
-		end = chromosome.lastPosition;
-	}
-	else if (!isNULL(start) | !isNULL(end))
-	{
-		stop("ERROR (calcDxy): start and end must both be NULL or both be non-NULL.");
-	}
-	
-	// narrow down to mutations actually present in the haplosomes and not fixed
-	p = c(haplosomes1, haplosomes2).mutationFrequenciesInHaplosomes(muts);
-	muts = muts[(p != 0.0) & (p != 1.0)];
-	if (size(muts) == 0) // if there are no mutations segregating, Dxy = 0
-		return 0.0;
-	
-	// get the count of each mutation in the two sets of haplosomes
-	dos1 = haplosomes1.mutationCountsInHaplosomes(muts);
-	dos2 = haplosomes2.mutationCountsInHaplosomes(muts);
-	
-	// calculate counts for the "empty" positions (they are alleles too, even
-	// though they don't have mutation objects in SLiM); note the implementation
-	// assumes "infinite sites" by assuming that a given site contains only a
-	// single SLiM mutation; if multiple SLiM mutations were present, the empty
-	// count would need to account for all of them, but that is hard to do
-	dos1_empty = size(haplosomes1) - dos1;
-	dos2_empty = size(haplosomes2) - dos2;
-	
-	dos1 = c(dos1, dos1_empty);
-	dos2 = c(dos2, dos2_empty);
-	
-	// "presence of A in haplosomes1" times "absence of A in haplosomes2" +
-	//    "presence of A in haplosomes2" times "absence of A in haplosomes1"
-	diffs_per_site = dos1 * (n2 - dos2) + (n1 - dos1) * dos2;
-	diff = sum(diffs_per_site);
-	
-	// this estimates Dxy as defined by Nei, without normalization by length
-	dxy = diff / 2.0 / n1 / n2;
-	
-	if (normalize)
-		return dxy / length;
-	else
-		return dxy;
-})V0G0N";
-
-#pragma mark (float$)calcFST(object<Haplosome> haplosomes1, object<Haplosome> haplosomes2, [No<Mutation> muts = NULL], [Ni$ start = NULL], [Ni$ end = NULL])
-const char *gSLiMSourceCode_calcFST = 
-R"V0G0N({
-	if ((haplosomes1.length() == 0) | (haplosomes2.length() == 0))
-		stop("ERROR (calcFST): haplosomes1 and haplosomes2 must both be non-empty.");
-	
-	species = haplosomes1[0].individual.subpopulation.species;
-	if (community.allSpecies.length() > 1)
-	{
-		if (any(c(haplosomes1, haplosomes2).individual.subpopulation.species != species))
-			stop("ERROR (calcFST): all haplosomes must belong to the same species.");
-		if (!isNULL(muts))
-			if (any(muts.mutationType.species != species))
-				stop("ERROR (calcFST): all mutations must belong to the same species as the haplosomes.");
-	}
-	
-	chromosomes = haplosomes1[0].chromosome;
-	if (species.chromosomes.length() > 1)
-	{
-		chromosomes = sortBy(unique(haplosomes1.chromosome, preserveOrder=F), "id");
-		chromosomes2 = sortBy(unique(haplosomes2.chromosome, preserveOrder=F), "id");
-		if (!identical(chromosomes, chromosomes2))
-			stop("ERROR (calcFST): both haplosomes must be associated with the same set of chromosomes.");
-		if (!isNULL(muts))
-			if (any(match(unique(muts.chromosome), chromosomes) == -1))
-				stop("ERROR (calcFST): all mutations must be associated with the same chromosomes as the haplosomes.");
-	}
-	
-	if (isNULL(muts))
-		muts = species.subsetMutations(chromosome=chromosomes);
-	
-	// handle windowing
-	if (!isNULL(start) & !isNULL(end))
-	{
-		if (chromosomes.length() > 1)
-			stop("ERROR (calcFST): start/end cannot be specified with more than one chromosome.");
-		if (start > end)
-			stop("ERROR (calcFST): start must be less than or equal to end.");
-		if ((start < 0) | (end >= chromosomes.length))
-			stop("ERROR (calcFST): start and end must be within the bounds of the focal chromosome");
-		mpos = muts.position;
-		muts = muts[(mpos >= start) & (mpos <= end)];
-	}
-	else if (!isNULL(start) | !isNULL(end))
-	{
-		stop("ERROR (calcFST): start and end must both be NULL or both be non-NULL.");
-	}
-	
-	// do the calculation; if the FST is undefined, return NULL
-	p1_p = haplosomes1.mutationFrequenciesInHaplosomes(muts);
-	p2_p = haplosomes2.mutationFrequenciesInHaplosomes(muts);
-	mean_p = (p1_p + p2_p) / 2.0;
-	H_t = 2.0 * mean_p * (1.0 - mean_p);
-	H_s = p1_p * (1.0 - p1_p) + p2_p * (1.0 - p2_p);
-	mean_H_t = mean(H_t);
-	
-	if (isNULL(mean_H_t))	// occurs if muts is zero-length
-		return NAN;
-	if (mean_H_t == 0)		// occurs if muts is not zero-length but all frequencies are zero
-		return NAN;
-	
-	fst = 1.0 - mean(H_s) / mean_H_t;
-	return fst;
-})V0G0N";
-
 #pragma mark (float$)calcVA(object<Individual> individuals, io<MutationType>$ mutType)
 const char *gSLiMSourceCode_calcVA = 
 R"V0G0N({
@@ -303,118 +145,6 @@ R"V0G0N({
 	return var(individuals.sumOfMutationsOfType(mutType));
 })V0G0N";
 
-#pragma mark (float)calcLD_D(object<Mutation>$ mut1, [No<Mutation> mut2 = NULL], [No<Haplosome> haplosomes = NULL])
-const char *gSLiMSourceCode_calcLD_D = 
-R"V0G0N({
-	// check species
-	species = mut1.mutationType.species;
-	if (community.allSpecies.length() > 1)
-	{
-		if (!isNULL(haplosomes))
-			if (any(haplosomes.individual.subpopulation.species != species))
-				stop("ERROR (calcLD_D): all haplosomes must belong to the same species as mut1.");
-		if (!isNULL(mut2))
-			if (any(mut2.mutationType.species != species))
-				stop("ERROR (calcLD_D): all mutations must belong to the same species as mut1.");
-	}
-	
-	// check chromosome
-	chromosome = mut1.chromosome;
-	if (species.chromosomes.length() > 1)
-	{
-		if (!isNULL(haplosomes))
-			if (any(haplosomes.chromosome != chromosome))
-				stop("ERROR (calcLD_D): all haplosomes must belong to the same chromosome as mut1.");
-		if (!isNULL(mut2))
-			if (any(mut2.chromosome != chromosome))
-				stop("ERROR (calcLD_D): all mutations must belong to the same chromosome as mut1.");
-	}
-	
-	// if mut2 is NULL, calculate across all mutations for the chromosome
-	if (isNULL(mut2))
-		mut2 = species.subsetMutations(chromosome=chromosome);	// includes mut1
-	
-	// if haplosomes is NULL, calculate across all haplosomes for the chromosome
-	if (isNULL(haplosomes))
-		haplosomes = species.subpopulations.haplosomesForChromosomes(chromosome);
-	
-	if (size(haplosomes) == 0)
-		stop("ERROR (calcLD_D): haplosomes must be non-empty.");
-	
-	// get haplosomes that contain the first mutation
-	haplosomes1 = haplosomes[haplosomes.containsMutations(mut1)];
-	
-	if (size(haplosomes1) == 0)
-		return rep(0.0, size(mut2)); // D=0 if either mutation is not present
-	
-	// calculate the frequency of haplosomes that contain both mutations
-	p_12 = haplosomes1.mutationCountsInHaplosomes(mut2) / size(haplosomes);
-	
-	// calculate the frequency of each mutation across haplosomes
-	p_1 = size(haplosomes1) / size(haplosomes);
-	p_2 = haplosomes.mutationFrequenciesInHaplosomes(mut2);
-	return p_12 - p_1 * p_2;
-})V0G0N";
-
-#pragma mark (float)calcLD_Rsquared(object<Mutation>$ mut1, [No<Mutation> mut2 = NULL], [No<Haplosome> haplosomes = NULL], [logical$ squared = T])
-const char *gSLiMSourceCode_calcLD_Rsquared = 
-R"V0G0N({
-	// check species
-	species = mut1.mutationType.species;
-	if (community.allSpecies.length() > 1)
-	{
-		if (!isNULL(haplosomes))
-			if (any(haplosomes.individual.subpopulation.species != species))
-				stop("ERROR (calcLD_Rsquared): all haplosomes must belong to the same species as mut1.");
-		if (!isNULL(mut2))
-			if (any(mut2.mutationType.species != species))
-				stop("ERROR (calcLD_Rsquared): all mutations must belong to the same species as mut1.");
-	}
-	
-	// check chromosome
-	chromosome = mut1.chromosome;
-	if (species.chromosomes.length() > 1)
-	{
-		if (!isNULL(haplosomes))
-			if (any(haplosomes.chromosome != chromosome))
-				stop("ERROR (calcLD_Rsquared): all haplosomes must belong to the same chromosome as mut1.");
-		if (!isNULL(mut2))
-			if (any(mut2.chromosome != chromosome))
-				stop("ERROR (calcLD_Rsquared): all mutations must belong to the same chromosome as mut1.");
-	}
-	
-	// if mut2 is NULL, calculate across all mutations for the chromosome
-	if (isNULL(mut2))
-		mut2 = species.subsetMutations(chromosome=chromosome);	// includes mut1
-	
-	// if haplosomes is NULL, calculate across all haplosomes for the chromosome
-	if (isNULL(haplosomes))
-		haplosomes = species.subpopulations.haplosomesForChromosomes(chromosome);
-	
-	if (size(haplosomes) == 0)
-		stop("ERROR (calcLD_Rsquared): haplosomes must be non-empty.");
-	
-	// get haplosomes that contain the first mutation
-	haplosomes1 = haplosomes[haplosomes.containsMutations(mut1)];
-	
-	if (size(haplosomes1) == 0)
-		return rep(NAN, size(mut2)); // r^2 doesn't exist if either mutation is absent (0/0)
-	
-	// calculate the frequency of haplosomes that contain both mutations
-	p_12 = haplosomes1.mutationCountsInHaplosomes(mut2) / size(haplosomes);
-	
-	// calculate the frequency of each mutation across haplosomes
-	p_1 = size(haplosomes1) / size(haplosomes);
-	p_2 = haplosomes.mutationFrequenciesInHaplosomes(mut2);
-	
-	// squared=T returns r^2 between 0 and 1
-	// squared=F returns r between -1 and 1
-	if (squared)
-		return (p_12 - p_1 * p_2)^2 / (p_1 * p_2 * (1.0 - p_1) * (1.0 - p_2));
-	else
-		return (p_12 - p_1 * p_2) / sqrt(p_1 * p_2 * (1.0 - p_1) * (1.0 - p_2));
-})V0G0N";
-
 #pragma mark (float$)calcMeanFroh(object<Individual> individuals, [integer$ minimumLength = 1e6], [Niso<Chromosome>$ chromosome = NULL])
 const char *gSLiMSourceCode_calcMeanFroh = 
 R"V0G0N({
@@ -606,65 +336,6 @@ R"V0G0N({
 	return heterozygosity;
 })V0G0N";
 
-#pragma mark (float$)calcWattersonsTheta(o<Haplosome> haplosomes, [No<Mutation> muts = NULL], [Ni$ start = NULL], [Ni$ end = NULL])
-const char *gSLiMSourceCode_calcWattersonsTheta = 
-R"V0G0N({
-	if (haplosomes.length() == 0)
-		stop("ERROR (calcWattersonsTheta): haplosomes must be non-empty.");
-	
-	species = haplosomes[0].individual.subpopulation.species;
-	if (community.allSpecies.length() > 1)
-	{
-		if (any(haplosomes.individual.subpopulation.species != species))
-			stop("ERROR (calcWattersonsTheta): all haplosomes must belong to the same species.");
-		if (!isNULL(muts))
-			if (any(muts.mutationType.species != species))
-				stop("ERROR (calcWattersonsTheta): all mutations must belong to the same species as the haplosomes.");
-	}
-	
-	chromosome = haplosomes[0].chromosome;
-	if (species.chromosomes.length() > 1)
-	{
-		if (any(haplosomes.chromosome != chromosome))
-			stop("ERROR (calcWattersonsTheta): all haplosomes must be associated with the same chromosome.");
-		if (!isNULL(muts))
-			if (any(muts.chromosome != chromosome))
-				stop("ERROR (calcWattersonsTheta): all mutations must be associated with the same chromosome as the haplosomes.");
-	}
-	
-	length = chromosome.length;
-	
-	if (isNULL(muts))
-		muts = species.subsetMutations(chromosome=chromosome);
-	
-	// handle windowing
-	if (!isNULL(start) & !isNULL(end))
-	{
-		if (start > end)
-			stop("ERROR (calcWattersonsTheta): start must be less than or equal to end.");
-		if ((start < 0) | (end >= length))
-			stop("ERROR (calcWattersonsTheta): start and end must be within the bounds of the focal chromosome");
-		mpos = muts.position;
-		muts = muts[(mpos >= start) & (mpos <= end)];
-		length = end - start + 1;
-	}
-	else if (!isNULL(start) | !isNULL(end))
-	{
-		stop("ERROR (calcWattersonsTheta): start and end must both be NULL or both be non-NULL.");
-	}
-
-	// narrow down to the mutations that are actually present in the haplosomes and aren't fixed
-	p = haplosomes.mutationFrequenciesInHaplosomes(muts);
-	muts = muts[(p != 0.0) & (p != 1.0)];
-
-	// do the calculation
-	k = size(muts);
-	n = haplosomes.size();
-	a_n = sum(1 / 1:(n-1));
-	theta = (k / a_n) / length;
-	return theta;
-})V0G0N";
-
 #pragma mark (float$)calcInbreedingLoad(object<Haplosome> haplosomes, [Nio<MutationType>$ mutType = NULL])
 const char *gSLiMSourceCode_calcInbreedingLoad = 
 R"V0G0N({
@@ -728,284 +399,1015 @@ R"V0G0N({
 	return (sum(q*s) - sum(q^2*s) - 2*sum(q*(1-q)*s*h));
 })V0G0N";
 
-#pragma mark (float$)calcPi(object<Haplosome> haplosomes, [No<Mutation> muts = NULL], [Ni$ start = NULL], [Ni$ end = NULL])
-const char *gSLiMSourceCode_calcPi = 
+#pragma mark (numeric)calcSFS([Ni$ binCount = NULL], [No<Haplosome> haplosomes = NULL], [No<Mutation> muts = NULL], [string$ metric = "density"], [logical$ fold = F])
+const char *gSLiMSourceCode_calcSFS = 
 R"V0G0N({
-	if (haplosomes.length() < 2)
-		stop("ERROR (calcPi): haplosomes must contain at least two elements.");
+	// first determine the haplosomes and the species
+	if (isNULL(haplosomes)) {
+		if (community.allSpecies.length() != 1)
+			stop("ERROR (): calcSFS() can only infer the value of haplosomes in a single-species model; otherwise, you need to supply the specific haplosomes to be used.");
+		
+		species = community.allSpecies;
+		haplosomes = sim.subpopulations.haplosomesNonNull;
+	}
+	else
+	{
+		if (haplosomes.length() == 0)
+			stop("ERROR (calcSFS): haplosomes must be non-empty.");
+		
+		species = haplosomes[0].individual.subpopulation.species;
+		
+		if (community.allSpecies.length() > 1)
+		{
+			if (any(haplosomes.individual.subpopulation.species != species))
+				stop("ERROR (calcSFS): all haplosomes must belong to the same species.");
+		}
+		
+		// exclude null haplosomes silently
+		haplosomes = haplosomes[!haplosomes.isNullHaplosome];
+	}
 	
-	species = haplosomes[0].individual.subpopulation.species;
-	if (community.allSpecies.length() > 1)
+	// validate binCount
+	if (!isNULL(binCount))
+		if ((binCount <= 0) | (binCount > 100000))
+				stop("ERROR (calcSFS): binCount must be in the range [1, 100000], or NULL.");
+	
+	// if no haplosomes are supplied, we don't want to error (we want to work
+	// even when called on an empty simulation, for ease of use), so we just
+	// return zeros; note after this point haplosomes is guaranteed non-empty
+	if (haplosomes.length() == 0)
 	{
-		if (any(haplosomes.individual.subpopulation.species != species))
-			stop("ERROR (calcPi): all haplosomes must belong to the same species.");
-		if (!isNULL(muts))
-			if (any(muts.mutationType.species != species))
-				stop("ERROR (calcPi): all mutations must belong to the same species as the haplosomes.");
+		if (isNULL(binCount))
+				return integer(0);
+		return float(binCount);
 	}
 	
-	chromosome = haplosomes[0].chromosome;
-	if (species.chromosomes.length() > 1)
+	// a NULL binCount means: each haplosome is a sample, and bins should be
+	// counts, not frequency bins; with N samples, we have bins for the counts
+	// from 1 to N-1 (here we do 0 to N, we will remove the end bins downstream)
+	// note for this mode we do require that all haplosomes belong to a single
+	// chromosome; counts combined across different haplosomes are not valid
+	// in the general case.
+	binsAreSampleCounts = F;
+	if (isNULL(binCount))
 	{
+		chromosome = haplosomes[0].chromosome;
 		if (any(haplosomes.chromosome != chromosome))
-			stop("ERROR (calcPi): all haplosomes must be associated with the same chromosome.");
-		if (!isNULL(muts))
-			if (any(muts.chromosome != chromosome))
-				stop("ERROR (calcPi): all mutations must be associated with the same chromosome as the haplosomes.");
+				stop("ERROR (calcSFS): when binCount is NULL, all haplosomes must be associated with the same chromosome; counts should be within a single chromosome, since a different number of haplosomes could be present for different chromosomes.");
+		
+		binCount = haplosomes.length() + 1;		// 0 to number of haplosomes
+		binsAreSampleCounts = T;
+	}
+	
+	// apart from the case above, we do not need to require a single chromosome;
+	// we work with all mutations in the model, even if the haplosomes supplied
+	// belong to a single chromosome.  this works because mutations that are not
+	// present in any of the supplied haplosomes will have a frequency of zero
+	// (or NAN, if the mutation belongs to a different chromosome), and those
+	// will be filtered out below.
+	if (isNULL(muts))
+	{
+		muts = species.mutations;
+	}
+	else
+	{
+		if (any(muts.chromosome.species != species))
+			stop("ERROR (calcSFS): all mutations in muts must belong to the same species as the haplosomes; an SFS can be calculated only within a single species.");
+	}
+	
+	if (!binsAreSampleCounts)
+	{
+		// get the frequencies; note mutationFrequenciesInHaplosomes() is smart enough
+		// to assess the frequency of each mutation only within the haplosomes that
+		// are associated with the same chromosome as the mutation, so this should do
+		// the right thing even in multichrom models.
+		freqs = haplosomes.mutationFrequenciesInHaplosomes(muts);
+		
+		// filter out frequencies of zero or NAN; they should not influence the SFS.
+		freqs = freqs[freqs != 0.0];
+		freqs = freqs[isFinite(freqs)];
+		
+		// discretize the frequencies into the specified number of bins
+		bins = pmin(asInteger(floor(freqs * binCount)), binCount - 1);
+		
+		// tabulate the number of mutations in each frequency bin to make a histogram
+		tallies = tabulate(bins, maxbin=binCount-1);
+	}
+	else
+	{
+		// this is the "binCount=NULL" case, where each bin is an integer count
+		// we handle this separately to avoid possible float numerical error
+		counts = haplosomes.mutationCountsInHaplosomes(muts);
+		
+		// filter out counts of zero; they should not influence the SFS.
+		counts = counts[counts != 0.0];
+		
+		// tabulate the number of mutations in each count bin to make a histogram
+		tallies = tabulate(counts, maxbin=binCount-1);
+		
+		// unlike above (frequency bins), with count bins we discard the bottom
+		// and top bins; count bins span [1, N-1]; the top bin might contain fixed
+		// mutations in SLiM, but they are not empirically observable
+		if (binsAreSampleCounts)
+			tallies = tallies[1:(length(tallies)-2)];
+	}
+	
+	// "fold" the SFS if requested, combining the first and last value, and on
+	// to the center; this is often done empirically because you don't know
+	// which allele is ancestral and which is derived.  the tricky thing is
+	// what to do with the central bin, if there is an odd number of bins; we
+	// add it to itself, but the central bin could be handled other ways too,
+	// such as excluding that data point (which the user can do after).
+	if (fold & (size(tallies) >= 2))
+	{
+		midpoint = (length(tallies) - 1) / 2;
+		leftSeq = asInteger(seq(from=0, to=midpoint));
+		rightSeq = asInteger(seq(from=length(tallies)-1, to=midpoint));
+		tallies = tallies[leftSeq] + tallies[rightSeq];
+	}
+	
+	// return either counts or densities, as requested; note that you can have
+	// binsAreSampleCounts be T, and yet return density values, that is legal,
+	// and just means that you want densities for singletons, doubletons, etc.
+	if (metric == "count")
+		return tallies;
+	else if (metric == "density")
+		return tallies / sum(tallies);
+	else
+		stop("ERROR (calcSFS): unrecognized value '" + metric + "' for parameter metric.");
+})V0G0N";
+
+
+// ************************************************************************************
+//
+//	population genetics utilities (native)
+//
+#pragma mark -
+#pragma mark Population genetics utilities (native)
+#pragma mark -
+
+// These functions were formerly implemented in Eidos, like the population genetics utilities above; they are implemented
+// natively because they are often called every tick on large samples, where building the intermediate vectors involved
+// (subsetMutations(), mutationCountsInHaplosomes(), etc.) was a bottleneck.  They are intended to produce results that
+// are bit-identical to the former Eidos implementations: focal mutations are visited in the same (registry) order, and
+// arithmetic is done with the same operations in the same order, following the semantics of sum() and mean() in Eidos.
+// Where a product is added to something, the product is stored in a volatile first, to prevent the compiler from fusing
+// the two into a multiply-add instruction (we build with -mfma when available), which would round differently than Eidos.
+
+// Checks that all haplosomes belong to one species, and that the mutations (if supplied) belong to that species too
+static Species *PopGenSpeciesForHaplosomes(Haplosome * const *haplosomes, int haplosome_count, EidosValue *muts_value, const char *function_name)
+{
+	Species *species = Community::SpeciesForHaplosomesVector(haplosomes, haplosome_count);
+	
+	if (!species)
+		EIDOS_TERMINATION << "ERROR (SLiM_ExecuteFunction_" << function_name << "): all haplosomes must belong to the same species." << EidosTerminate();
+	
+	if ((muts_value->Type() != EidosValueType::kValueNULL) && (muts_value->Count() > 0))
+		if (Community::SpeciesForMutations(muts_value) != species)
+			EIDOS_TERMINATION << "ERROR (SLiM_ExecuteFunction_" << function_name << "): all mutations must belong to the same species as the haplosomes." << EidosTerminate();
+	
+	return species;
+}
+
+// Checks that all haplosomes are associated with one chromosome, and that the mutations (if supplied) are associated with it too
+static Chromosome *PopGenChromosomeForHaplosomes(Species *species, Haplosome * const *haplosomes, int haplosome_count, EidosValue *muts_value, const char *function_name)
+{
+	const std::vector<Chromosome *> &chromosomes = species->Chromosomes();
+	slim_chromosome_index_t chromosome_index = haplosomes[0]->AssociatedChromosomeIndex();
+	
+	if (chromosomes.size() > 1)
+	{
+		for (int haplosome_index = 1; haplosome_index < haplosome_count; ++haplosome_index)
+			if (haplosomes[haplosome_index]->AssociatedChromosomeIndex() != chromosome_index)
+				EIDOS_TERMINATION << "ERROR (SLiM_ExecuteFunction_" << function_name << "): all haplosomes must be associated with the same chromosome." << EidosTerminate();
+		
+		if (muts_value->Type() != EidosValueType::kValueNULL)
+		{
+			Mutation * const *mutations = (Mutation * const *)muts_value->ObjectData();
+			int mutation_count = muts_value->Count();
+			
+			for (int mutation_index = 0; mutation_index < mutation_count; ++mutation_index)
+				if (mutations[mutation_index]->chromosome_index_ != chromosome_index)
+					EIDOS_TERMINATION << "ERROR (SLiM_ExecuteFunction_" << function_name << "): all mutations must be associated with the same chromosome as the haplosomes." << EidosTerminate();
+		}
+	}
+	
+	return chromosomes[chromosome_index];
+}
+
+// Validates the start/end window parameters; returns true if a window was given, and sets the length to be used for normalization
+static bool PopGenWindowForChromosome(Chromosome *chromosome, EidosValue *start_value, EidosValue *end_value, slim_position_t *start, slim_position_t *end, int64_t *length, const char *function_name)
+{
+	bool start_null = (start_value->Type() == EidosValueType::kValueNULL);
+	bool end_null = (end_value->Type() == EidosValueType::kValueNULL);
+	
+	if (!start_null && !end_null)
+	{
+		int64_t start_int = start_value->IntAtIndex_NOCAST(0, nullptr);
+		int64_t end_int = end_value->IntAtIndex_NOCAST(0, nullptr);
+		
+		if (start_int > end_int)
+			EIDOS_TERMINATION << "ERROR (SLiM_ExecuteFunction_" << function_name << "): start must be less than or equal to end." << EidosTerminate();
+		if ((start_int < 0) || (end_int >= (int64_t)chromosome->last_position_ + 1))
+			EIDOS_TERMINATION << "ERROR (SLiM_ExecuteFunction_" << function_name << "): start and end must be within the bounds of the focal chromosome." << EidosTerminate();
+		
+		*start = (slim_position_t)start_int;
+		*end = (slim_position_t)end_int;
+		*length = end_int - start_int + 1;
+		return true;
+	}
+	else if (!start_null || !end_null)
+	{
+		EIDOS_TERMINATION << "ERROR (SLiM_ExecuteFunction_" << function_name << "): start and end must both be NULL or both be non-NULL." << EidosTerminate();
+	}
+	
+	*length = (int64_t)chromosome->last_position_ + 1;
+	return false;
+}
+
+// Gathers the focal mutations: the supplied mutations, or else all mutations in the registry that belong to an included
+// chromosome (in registry order, as subsetMutations() would return them), optionally filtered to a window of positions
+static void PopGenFocalMutations(std::vector<Mutation *> &focal_mutations, Species *species, EidosValue *muts_value, const std::vector<bool> &chromosome_included, bool windowed, slim_position_t start, slim_position_t end)
+{
+	Mutation *mut_block_ptr = gSLiM_Mutation_Block;
+	
+	focal_mutations.clear();
+	
+	if (muts_value->Type() == EidosValueType::kValueNULL)
+	{
+		int registry_size;
+		const MutationIndex *registry = species->population_.MutationRegistry(&registry_size);
+		
+		focal_mutations.reserve(registry_size);
+		
+		for (int registry_index = 0; registry_index < registry_size; ++registry_index)
+		{
+			Mutation *mut = mut_block_ptr + registry[registry_index];
+			
+			if (chromosome_included[mut->chromosome_index_])
+				focal_mutations.emplace_back(mut);
+		}
+	}
+	else
+	{
+		Mutation * const *mutations = (Mutation * const *)muts_value->ObjectData();
+		int mutation_count = muts_value->Count();
+		
+		focal_mutations.assign(mutations, mutations + mutation_count);
+	}
+	
+	if (windowed)
+		focal_mutations.erase(std::remove_if(focal_mutations.begin(), focal_mutations.end(), [start, end](Mutation *mut) { return (mut->position_ < start) || (mut->position_ > end); }), focal_mutations.end());
+}
+
+// Tallies the given haplosomes and fetches the count of each focal mutation within them; this follows the logic of
+// Population::Eidos_CountsForTalliedMutations(), so mutations that have been lost or fixed get counts of 0 or of the
+// tallied haplosome count for their chromosome.  The tallied haplosome counts for all chromosomes are also returned.
+static void PopGenCountsInHaplosomes(std::vector<slim_refcount_t> &counts, std::vector<slim_refcount_t> &tallied_counts, Species *species, Haplosome **haplosomes, int haplosome_count, const std::vector<Mutation *> &focal_mutations, const char *function_name)
+{
+	for (int haplosome_index = 0; haplosome_index < haplosome_count; ++haplosome_index)
+		if (haplosomes[haplosome_index]->IsNull())
+			EIDOS_TERMINATION << "ERROR (SLiM_ExecuteFunction_" << function_name << "): " << function_name << "() cannot be called on a null haplosome." << EidosTerminate();
+	
+	Population &population = species->population_;
+	
+	population.CheckForDeferralInHaplosomesVector(haplosomes, haplosome_count, std::string("SLiM_ExecuteFunction_") + function_name);
+	population.TallyMutationReferencesAcrossHaplosomes(haplosomes, haplosome_count);
+	
+	tallied_counts.clear();
+	for (Chromosome *chromosome : species->Chromosomes())
+		tallied_counts.emplace_back(chromosome->tallied_haplosome_count_);
+	
+	int64_t mutation_count = (int64_t)focal_mutations.size();
+	
+	counts.resize(mutation_count);
+	
+	const slim_refcount_t *refcount_block_ptr = gSLiM_Mutation_Refcounts;
+	const slim_refcount_t *tallied_counts_ptr = tallied_counts.data();
+	Mutation * const *mutations_ptr = focal_mutations.data();
+	slim_refcount_t *counts_ptr = counts.data();
+	
+	EIDOS_THREAD_COUNT(gEidos_OMP_threads_POPGEN_STATS);
+#pragma omp parallel for schedule(static) default(none) shared(mutation_count) firstprivate(refcount_block_ptr, tallied_counts_ptr, mutations_ptr, counts_ptr) if(mutation_count >= EIDOS_OMPMIN_POPGEN_STATS) num_threads(thread_count)
+	for (int64_t mutation_index = 0; mutation_index < mutation_count; ++mutation_index)
+	{
+		Mutation *mut = mutations_ptr[mutation_index];
+		int8_t mut_state = mut->state_;
+		slim_refcount_t count;
+		
+		if (mut_state == MutationState::kInRegistry)
+			count = *(refcount_block_ptr + mut->BlockIndex());
+		else if (mut_state == MutationState::kLostAndRemoved)
+			count = 0;
+		else
+			count = tallied_counts_ptr[mut->chromosome_index_];
+		
+		counts_ptr[mutation_index] = count;
+	}
+	
+	// invalidate cached mutation refcounts; refcounts have changed
+	population.InvalidateMutationReferencesCache();
+}
+
+// Sums integer values with the semantics of sum() in Eidos; the sum is kept as an integer while it fits, and spills over
+// into float upon overflow.  The result is returned as a double, since all callers immediately use it in float arithmetic.
+static double PopGenSumOfIntegers(const int64_t *values, int64_t count)
+{
+#ifdef _OPENMP
+	// In parallel builds sum() accumulates in double; integer-valued partial sums are exact up to 2^53, so order does not matter
+	double sum_d = 0;
+	
+	EIDOS_THREAD_COUNT(gEidos_OMP_threads_POPGEN_STATS);
+#pragma omp parallel for simd schedule(simd:static) default(none) shared(count) firstprivate(values) reduction(+: sum_d) if(parallel:count >= EIDOS_OMPMIN_POPGEN_STATS) num_threads(thread_count)
+	for (int64_t value_index = 0; value_index < count; ++value_index)
+		sum_d += values[value_index];
+	
+	return sum_d;
+#else
+	int64_t sum = 0;
+	double sum_d = 0;
+	
+	for (int64_t value_index = 0; value_index < count; ++value_index)
+	{
+		int64_t old_sum = sum;
+		int64_t temp = values[value_index];
+		
+		if (Eidos_add_overflow(old_sum, temp, &sum))
+		{
+			sum_d += old_sum;
+			sum = temp;
+		}
+	}
+	
+	sum_d += sum;
+	
+	return sum_d;
+#endif
+}
+
+// Sums float values with the semantics of sum() in Eidos, including its summation order
+static double PopGenSumOfFloats(const double *values, int64_t count)
+{
+	if (count == 1)
+		return values[0];
+	
+#ifdef _OPENMP
+	double sum = 0;
+	
+	EIDOS_THREAD_COUNT(gEidos_OMP_threads_SUM_FLOAT);
+#pragma omp parallel for simd schedule(simd:static) default(none) shared(count) firstprivate(values) reduction(+: sum) if(parallel:count >= EIDOS_OMPMIN_SUM_FLOAT) num_threads(thread_count)
+	for (int64_t value_index = 0; value_index < count; ++value_index)
+		sum += values[value_index];
+	
+	return sum;
+#else
+	return Eidos_SIMD::sum_float64(values, count);
+#endif
+}
+
+// Takes the mean of float values with the semantics of mean() in Eidos
+static double PopGenMeanOfFloats(const double *values, int64_t count)
+{
+	if (count == 0)
+		return std::numeric_limits<double>::quiet_NaN();
+	if (count == 1)
+		return values[0];
+	
+	return PopGenSumOfFloats(values, count) / count;
+}
+
+// Computes sum(1 / (1:(n-1))^power) for power 1 or 2, as the Eidos code did; note that for n == 1 the sequence 1:0 is (1, 0)
+static double PopGenHarmonicSum(int64_t n, int power)
+{
+	std::vector<double> terms;
+	
+	if (n - 1 >= 1)
+	{
+		terms.reserve(n - 1);
+		for (int64_t i = 1; i <= n - 1; ++i)
+			terms.emplace_back((power == 1) ? (1.0 / (double)i) : (1.0 / std::pow((double)i, 2.0)));
+	}
+	else
+	{
+		for (int64_t i = 1; i >= n - 1; --i)
+			terms.emplace_back((power == 1) ? (1.0 / (double)i) : (1.0 / std::pow((double)i, 2.0)));
+	}
+	
+	return PopGenSumOfFloats(terms.data(), (int64_t)terms.size());
+}
+
+// Shared setup for the single-sample statistics: validates the parameters, gathers the focal mutations, and gets their counts
+static void PopGenSingleSampleCounts(std::vector<slim_refcount_t> &counts, slim_refcount_t *tallied_count, int64_t *length, const std::vector<EidosValue_SP> &p_arguments, const char *function_name)
+{
+	EidosValue *haplosomes_value = p_arguments[0].get();
+	EidosValue *muts_value = p_arguments[1].get();
+	EidosValue *start_value = p_arguments[2].get();
+	EidosValue *end_value = p_arguments[3].get();
+	
+	Haplosome **haplosomes = (Haplosome **)haplosomes_value->ObjectData();
+	int haplosome_count = haplosomes_value->Count();
+	
+	Species *species = PopGenSpeciesForHaplosomes(haplosomes, haplosome_count, muts_value, function_name);
+	Chromosome *chromosome = PopGenChromosomeForHaplosomes(species, haplosomes, haplosome_count, muts_value, function_name);
+	
+	slim_position_t start = 0, end = 0;
+	bool windowed = PopGenWindowForChromosome(chromosome, start_value, end_value, &start, &end, length, function_name);
+	
+	std::vector<bool> chromosome_included(species->Chromosomes().size(), false);
+	std::vector<Mutation *> focal_mutations;
+	std::vector<slim_refcount_t> tallied_counts;
+	
+	chromosome_included[chromosome->Index()] = true;
+	
+	PopGenFocalMutations(focal_mutations, species, muts_value, chromosome_included, windowed, start, end);
+	PopGenCountsInHaplosomes(counts, tallied_counts, species, haplosomes, haplosome_count, focal_mutations, function_name);
+	
+	*tallied_count = tallied_counts[chromosome->Index()];
+}
+
+// Counts the segregating sites (those with a count neither 0 nor the tallied haplosome count) among the focal mutations
+static int64_t PopGenSegregatingCount(const std::vector<slim_refcount_t> &counts, slim_refcount_t tallied_count)
+{
+	int64_t mutation_count = (int64_t)counts.size();
+	const slim_refcount_t *counts_ptr = counts.data();
+	int64_t segregating_count = 0;
+	
+	EIDOS_THREAD_COUNT(gEidos_OMP_threads_POPGEN_STATS);
+#pragma omp parallel for simd schedule(simd:static) default(none) shared(mutation_count) firstprivate(counts_ptr, tallied_count) reduction(+: segregating_count) if(parallel:mutation_count >= EIDOS_OMPMIN_POPGEN_STATS) num_threads(thread_count)
+	for (int64_t mutation_index = 0; mutation_index < mutation_count; ++mutation_index)
+	{
+		slim_refcount_t count = counts_ptr[mutation_index];
+		
+		segregating_count += ((count != 0) && (count != tallied_count)) ? 1 : 0;
+	}
+	
+	return segregating_count;
+}
+
+// Computes pi over the focal mutations, not yet normalized by sequence length
+static double PopGenPi(const std::vector<slim_refcount_t> &counts, int64_t n)
+{
+	// Monomorphic sites contribute 0 to the number of pairwise differences, so they need not be filtered out; they
+	// cannot affect the point at which the integer sum overflows, either, so the result is identical regardless
+	int64_t mutation_count = (int64_t)counts.size();
+	const slim_refcount_t *counts_ptr = counts.data();
+	std::vector<int64_t> diffs(mutation_count);
+	int64_t *diffs_ptr = diffs.data();
+	
+	EIDOS_THREAD_COUNT(gEidos_OMP_threads_POPGEN_STATS);
+#pragma omp parallel for simd schedule(simd:static) default(none) shared(mutation_count) firstprivate(counts_ptr, diffs_ptr, n) if(parallel:mutation_count >= EIDOS_OMPMIN_POPGEN_STATS) num_threads(thread_count)
+	for (int64_t mutation_index = 0; mutation_index < mutation_count; ++mutation_index)
+	{
+		int64_t count = counts_ptr[mutation_index];
+		
+		diffs_ptr[mutation_index] = count * (n - count);
+	}
+	
+	double diffs_sum = PopGenSumOfIntegers(diffs_ptr, mutation_count);
+	
+	return diffs_sum / ((double)(n * (n - 1)) / 2.0);
+}
+
+//	(float$)calcPi(object<Haplosome> haplosomes, [No<Mutation> muts = NULL], [Ni$ start = NULL], [Ni$ end = NULL])
+EidosValue_SP SLiM_ExecuteFunction_calcPi(const std::vector<EidosValue_SP> &p_arguments, __attribute__((unused)) EidosInterpreter &p_interpreter)
+{
+	int64_t haplosome_count = p_arguments[0]->Count();
+	
+	if (haplosome_count < 2)
+		EIDOS_TERMINATION << "ERROR (SLiM_ExecuteFunction_calcPi): haplosomes must contain at least two elements." << EidosTerminate();
+	
+	std::vector<slim_refcount_t> counts;
+	slim_refcount_t tallied_count;
+	int64_t length;
+	
+	PopGenSingleSampleCounts(counts, &tallied_count, &length, p_arguments, "calcPi");
+	
+	double pi = PopGenPi(counts, haplosome_count);
+	
+	// normalize by the length of the sequence or window
+	return EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Float(pi / length));
+}
+
+//	(float$)calcWattersonsTheta(object<Haplosome> haplosomes, [No<Mutation> muts = NULL], [Ni$ start = NULL], [Ni$ end = NULL])
+EidosValue_SP SLiM_ExecuteFunction_calcWattersonsTheta(const std::vector<EidosValue_SP> &p_arguments, __attribute__((unused)) EidosInterpreter &p_interpreter)
+{
+	int64_t haplosome_count = p_arguments[0]->Count();
+	
+	if (haplosome_count == 0)
+		EIDOS_TERMINATION << "ERROR (SLiM_ExecuteFunction_calcWattersonsTheta): haplosomes must be non-empty." << EidosTerminate();
+	
+	std::vector<slim_refcount_t> counts;
+	slim_refcount_t tallied_count;
+	int64_t length;
+	
+	PopGenSingleSampleCounts(counts, &tallied_count, &length, p_arguments, "calcWattersonsTheta");
+	
+	// calculate the number of segregating sites and the harmonic number a_n
+	int64_t k = PopGenSegregatingCount(counts, tallied_count);
+	double a_n = PopGenHarmonicSum(haplosome_count, 1);
+	double theta = (double)k / a_n;
+	
+	// normalize by the length of the sequence or window
+	return EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Float(theta / length));
+}
+
+//	(float$)calcTajimasD(object<Haplosome> haplosomes, [No<Mutation> muts = NULL], [Ni$ start = NULL], [Ni$ end = NULL])
+EidosValue_SP SLiM_ExecuteFunction_calcTajimasD(const std::vector<EidosValue_SP> &p_arguments, __attribute__((unused)) EidosInterpreter &p_interpreter)
+{
+	int64_t n = p_arguments[0]->Count();
+	
+	if (n < 4)
+		EIDOS_TERMINATION << "ERROR (SLiM_ExecuteFunction_calcTajimasD): haplosomes must contain at least four elements." << EidosTerminate();
+	
+	std::vector<slim_refcount_t> counts;
+	slim_refcount_t tallied_count;
+	int64_t length;
+	
+	PopGenSingleSampleCounts(counts, &tallied_count, &length, p_arguments, "calcTajimasD");
+	
+	// the Eidos code filtered to segregating sites before calling calcPi() and calcWattersonsTheta(); the sequence
+	// length cancels out here, but we go through the same normalization to get the same rounding
+	counts.erase(std::remove_if(counts.begin(), counts.end(), [tallied_count](slim_refcount_t count) { return (count == 0) || (count == tallied_count); }), counts.end());
+	
+	int64_t k = (int64_t)counts.size();
+	double a_1 = PopGenHarmonicSum(n, 1);
+	double a_2 = PopGenHarmonicSum(n, 2);
+	double pi = PopGenPi(counts, n) / length;
+	double theta = ((double)k / a_1) / length;
+	double diff = (pi - theta) * length;
+	
+	// calculate the variance of the difference, following Tajima (1989)
+	double b_1 = (double)(n + 1) / (double)(3 * (n - 1));
+	double b_2 = (2 * (std::pow((double)n, 2.0) + n + 3)) / (double)(9 * n * (n - 1));
+	double c_1 = b_1 - 1.0 / a_1;
+	double c_2 = (b_2 - (double)(n + 2) / (a_1 * n)) + a_2 / std::pow(a_1, 2.0);
+	double e_1 = c_1 / a_1;
+	volatile double a_1_squared = std::pow(a_1, 2.0);
+	double e_2 = c_2 / (a_1_squared + a_2);
+	volatile double covar_1 = e_1 * k;
+	volatile double covar_2 = (e_2 * k) * (k - 1);
+	double covar = covar_1 + covar_2;
+	double tajima_d = diff / std::sqrt(covar);
+	
+	return EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Float(tajima_d));
+}
+
+//	(float$)calcFST(object<Haplosome> haplosomes1, object<Haplosome> haplosomes2, [No<Mutation> muts = NULL], [Ni$ start = NULL], [Ni$ end = NULL])
+EidosValue_SP SLiM_ExecuteFunction_calcFST(const std::vector<EidosValue_SP> &p_arguments, __attribute__((unused)) EidosInterpreter &p_interpreter)
+{
+	EidosValue *haplosomes1_value = p_arguments[0].get();
+	EidosValue *haplosomes2_value = p_arguments[1].get();
+	EidosValue *muts_value = p_arguments[2].get();
+	EidosValue *start_value = p_arguments[3].get();
+	EidosValue *end_value = p_arguments[4].get();
+	
+	int haplosome1_count = haplosomes1_value->Count();
+	int haplosome2_count = haplosomes2_value->Count();
+	
+	if ((haplosome1_count == 0) || (haplosome2_count == 0))
+		EIDOS_TERMINATION << "ERROR (SLiM_ExecuteFunction_calcFST): haplosomes1 and haplosomes2 must both be non-empty." << EidosTerminate();
+	
+	Haplosome **haplosomes1 = (Haplosome **)haplosomes1_value->ObjectData();
+	Haplosome **haplosomes2 = (Haplosome **)haplosomes2_value->ObjectData();
+	std::vector<Haplosome *> all_haplosomes(haplosomes1, haplosomes1 + haplosome1_count);
+	
+	all_haplosomes.insert(all_haplosomes.end(), haplosomes2, haplosomes2 + haplosome2_count);
+	
+	Species *species = PopGenSpeciesForHaplosomes(all_haplosomes.data(), (int)all_haplosomes.size(), muts_value, "calcFST");
+	const std::vector<Chromosome *> &chromosomes = species->Chromosomes();
+	std::vector<bool> chromosome_included(chromosomes.size(), false);
+	int included_count = 0;
+	
+	// unlike the other functions, calcFST() can be used across a set of chromosomes, which must be the same for both samples
+	if (chromosomes.size() > 1)
+	{
+		std::vector<bool> chromosome_included2(chromosomes.size(), false);
+		
+		for (int haplosome_index = 0; haplosome_index < haplosome1_count; ++haplosome_index)
+			chromosome_included[haplosomes1[haplosome_index]->AssociatedChromosomeIndex()] = true;
+		for (int haplosome_index = 0; haplosome_index < haplosome2_count; ++haplosome_index)
+			chromosome_included2[haplosomes2[haplosome_index]->AssociatedChromosomeIndex()] = true;
+		
+		if (chromosome_included != chromosome_included2)
+			EIDOS_TERMINATION << "ERROR (SLiM_ExecuteFunction_calcFST): both haplosomes must be associated with the same set of chromosomes." << EidosTerminate();
+		
+		if (muts_value->Type() != EidosValueType::kValueNULL)
+		{
+			Mutation * const *mutations = (Mutation * const *)muts_value->ObjectData();
+			int mutation_count = muts_value->Count();
+			
+			for (int mutation_index = 0; mutation_index < mutation_count; ++mutation_index)
+				if (!chromosome_included[mutations[mutation_index]->chromosome_index_])
+					EIDOS_TERMINATION << "ERROR (SLiM_ExecuteFunction_calcFST): all mutations must be associated with the same chromosomes as the haplosomes." << EidosTerminate();
+		}
+		
+		included_count = (int)std::count(chromosome_included.begin(), chromosome_included.end(), true);
+	}
+	else
+	{
+		chromosome_included[haplosomes1[0]->AssociatedChromosomeIndex()] = true;
+		included_count = 1;
 	}
 	
-	length = chromosome.length;
-	
-	if (isNULL(muts))
-		muts = species.subsetMutations(chromosome=chromosome);
+	// handle windowing, which is allowed only within a single chromosome
+	slim_position_t start = 0, end = 0;
+	bool windowed = false;
 	
-	// handle windowing
-	if (!isNULL(start) & !isNULL(end))
+	if ((start_value->Type() != EidosValueType::kValueNULL) && (end_value->Type() != EidosValueType::kValueNULL))
 	{
-		if (start > end)
-			stop("ERROR (calcPi): start must be less than or equal to end.");
-		if ((start < 0) | (end >= length))
-			stop("ERROR (calcPi): start and end must be within the bounds of the focal chromosome");
-		mpos = muts.position;
-		muts = muts[(mpos >= start) & (mpos <= end)];
-		length = end - start + 1;
+		if (included_count > 1)
+			EIDOS_TERMINATION << "ERROR (SLiM_ExecuteFunction_calcFST): start/end cannot be specified with more than one chromosome." << EidosTerminate();
+		
+		Chromosome *chromosome = chromosomes[std::find(chromosome_included.begin(), chromosome_included.end(), true) - chromosome_included.begin()];
+		int64_t length;
+		
+		windowed = PopGenWindowForChromosome(chromosome, start_value, end_value, &start, &end, &length, "calcFST");
 	}
-	else if (!isNULL(start) | !isNULL(end))
+	else if ((start_value->Type() != EidosValueType::kValueNULL) || (end_value->Type() != EidosValueType::kValueNULL))
 	{
-		stop("ERROR (calcPi): start and end must both be NULL or both be non-NULL.");
+		EIDOS_TERMINATION << "ERROR (SLiM_ExecuteFunction_calcFST): start and end must both be NULL or both be non-NULL." << EidosTerminate();
 	}
 	
-	// narrow down to the mutations that are actually present in the haplosomes and aren't fixed
-	p = haplosomes.mutationFrequenciesInHaplosomes(muts);
-	muts = muts[(p != 0.0) & (p != 1.0)];
+	std::vector<Mutation *> focal_mutations;
+	std::vector<slim_refcount_t> counts1, counts2, tallied_counts1, tallied_counts2;
 	
-	// do the calculation
-	// obtain counts of variant sequences for all segregating sites
-	varCount = haplosomes.mutationCountsInHaplosomes(muts);
-	// total count of sequences minus count of variant sequences equals count of invariant sequences
-	invarCount = haplosomes.size() - varCount;
-	// count of pairwise differences per site is the product of counts of both alleles
-	// (equation 1 in Korunes and Samuk 2021); this is then summed for all sites 
-	diffs = sum(varCount * invarCount);
-	// pi is the ratio of pairwise differences to number of possible combinations of the given sequences
-	pi = diffs / ((haplosomes.size() * (haplosomes.size() - 1)) / 2);
-	// pi is conventionally averaged per site (consistent with SLiM's calculation of Watterson's theta)
-	avg_pi = pi / length;
-	return avg_pi;
-})V0G0N";
-
-#pragma mark (numeric)calcSFS([Ni$ binCount = NULL], [No<Haplosome> haplosomes = NULL], [No<Mutation> muts = NULL], [string$ metric = "density"], [logical$ fold = F])
-const char *gSLiMSourceCode_calcSFS = 
-R"V0G0N({
-	// first determine the haplosomes and the species
-	if (isNULL(haplosomes)) {
-		if (community.allSpecies.length() != 1)
-			stop("ERROR (): calcSFS() can only infer the value of haplosomes in a single-species model; otherwise, you need to supply the specific haplosomes to be used.");
+	PopGenFocalMutations(focal_mutations, species, muts_value, chromosome_included, windowed, start, end);
+	PopGenCountsInHaplosomes(counts1, tallied_counts1, species, haplosomes1, haplosome1_count, focal_mutations, "calcFST");
+	PopGenCountsInHaplosomes(counts2, tallied_counts2, species, haplosomes2, haplosome2_count, focal_mutations, "calcFST");
+	
+	// calculate the mean total and within-sample heterozygosities across the focal sites; every focal mutation belongs
+	// to a chromosome that has a non-zero tallied count in both samples, so count / tallied gives exactly the frequencies
+	// that mutationFrequenciesInHaplosomes() would give, including 0.0 and 1.0 for lost and fixed mutations
+	int64_t mutation_count = (int64_t)focal_mutations.size();
+	std::vector<double> H_t(mutation_count), H_s(mutation_count);
+	
+	for (int64_t mutation_index = 0; mutation_index < mutation_count; ++mutation_index)
+	{
+		slim_chromosome_index_t chromosome_index = focal_mutations[mutation_index]->chromosome_index_;
+		double p1 = counts1[mutation_index] / (double)tallied_counts1[chromosome_index];
+		double p2 = counts2[mutation_index] / (double)tallied_counts2[chromosome_index];
+		double mean_p = (p1 + p2) / 2.0;
 		
-		species = community.allSpecies;
-		haplosomes = sim.subpopulations.haplosomesNonNull;
+		volatile double H_s_1 = p1 * (1.0 - p1);
+		volatile double H_s_2 = p2 * (1.0 - p2);
+		
+		H_t[mutation_index] = (2.0 * mean_p) * (1.0 - mean_p);
+		H_s[mutation_index] = H_s_1 + H_s_2;
 	}
-	else
+	
+	double mean_H_t = PopGenMeanOfFloats(H_t.data(), mutation_count);
+	
+	if (std::isnan(mean_H_t) || (mean_H_t == 0))
+		return gStaticEidosValue_FloatNAN;
+	
+	double mean_H_s = PopGenMeanOfFloats(H_s.data(), mutation_count);
+	double fst = 1.0 - mean_H_s / mean_H_t;
+	
+	return EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Float(fst));
+}
+
+//	(float$)calcDxy(object<Haplosome> haplosomes1, object<Haplosome> haplosomes2, [No<Mutation> muts = NULL], [Ni$ start = NULL], [Ni$ end = NULL], [l$ normalize = F])
+EidosValue_SP SLiM_ExecuteFunction_calcDxy(const std::vector<EidosValue_SP> &p_arguments, __attribute__((unused)) EidosInterpreter &p_interpreter)
+{
+	EidosValue *haplosomes1_value = p_arguments[0].get();
+	EidosValue *haplosomes2_value = p_arguments[1].get();
+	EidosValue *muts_value = p_arguments[2].get();
+	EidosValue *start_value = p_arguments[3].get();
+	EidosValue *end_value = p_arguments[4].get();
+	EidosValue *normalize_value = p_arguments[5].get();
+	
+	int64_t n1 = haplosomes1_value->Count();
+	int64_t n2 = haplosomes2_value->Count();
+	
+	if ((n1 == 0) || (n2 == 0))
+		EIDOS_TERMINATION << "ERROR (SLiM_ExecuteFunction_calcDxy): haplosomes1 and haplosomes2 must both be non-empty." << EidosTerminate();
+	
+	Haplosome **haplosomes1 = (Haplosome **)haplosomes1_value->ObjectData();
+	Haplosome **haplosomes2 = (Haplosome **)haplosomes2_value->ObjectData();
+	std::vector<Haplosome *> all_haplosomes(haplosomes1, haplosomes1 + n1);
+	
+	all_haplosomes.insert(all_haplosomes.end(), haplosomes2, haplosomes2 + n2);
+	
+	Species *species = PopGenSpeciesForHaplosomes(all_haplosomes.data(), (int)all_haplosomes.size(), muts_value, "calcDxy");
+	Chromosome *chromosome = PopGenChromosomeForHaplosomes(species, all_haplosomes.data(), (int)all_haplosomes.size(), muts_value, "calcDxy");
+	
+	slim_position_t start = 0, end = 0;
+	int64_t length;
+	bool windowed = PopGenWindowForChromosome(chromosome, start_value, end_value, &start, &end, &length, "calcDxy");
+	
+	std::vector<bool> chromosome_included(species->Chromosomes().size(), false);
+	std::vector<Mutation *> focal_mutations;
+	std::vector<slim_refcount_t> counts1, counts2, tallied_counts1, tallied_counts2;
+	
+	chromosome_included[chromosome->Index()] = true;
+	
+	PopGenFocalMutations(focal_mutations, species, muts_value, chromosome_included, windowed, start, end);
+	PopGenCountsInHaplosomes(counts1, tallied_counts1, species, haplosomes1, (int)n1, focal_mutations, "calcDxy");
+	PopGenCountsInHaplosomes(counts2, tallied_counts2, species, haplosomes2, (int)n2, focal_mutations, "calcDxy");
+	
+	// filter to sites that are segregating across the two samples combined
+	slim_refcount_t tallied_count = tallied_counts1[chromosome->Index()] + tallied_counts2[chromosome->Index()];
+	int64_t mutation_count = (int64_t)focal_mutations.size();
+	std::vector<int64_t> dos1, dos2;
+	
+	for (int64_t mutation_index = 0; mutation_index < mutation_count; ++mutation_index)
 	{
-		if (haplosomes.length() == 0)
-			stop("ERROR (calcSFS): haplosomes must be non-empty.");
-		
-		species = haplosomes[0].individual.subpopulation.species;
+		slim_refcount_t count = counts1[mutation_index] + counts2[mutation_index];
 		
-		if (community.allSpecies.length() > 1)
+		if ((count != 0) && (count != tallied_count))
 		{
-			if (any(haplosomes.individual.subpopulation.species != species))
-				stop("ERROR (calcSFS): all haplosomes must belong to the same species.");
+			dos1.emplace_back(counts1[mutation_index]);
+			dos2.emplace_back(counts2[mutation_index]);
 		}
-		
-		// exclude null haplosomes silently
-		haplosomes = haplosomes[!haplosomes.isNullHaplosome];
 	}
 	
-	// validate binCount
-	if (!isNULL(binCount))
-		if ((binCount <= 0) | (binCount > 100000))
-				stop("ERROR (calcSFS): binCount must be in the range [1, 100000], or NULL.");
+	if (dos1.size() == 0)
+		return gStaticEidosValue_Float0;
 	
-	// if no haplosomes are supplied, we don't want to error (we want to work
-	// even when called on an empty simulation, for ease of use), so we just
-	// return zeros; note after this point haplosomes is guaranteed non-empty
-	if (haplosomes.length() == 0)
-	{
-		if (isNULL(binCount))
-				return integer(0);
-		return float(binCount);
-	}
+	// count the differences between samples at each site, both for the derived alleles and for the "empty" alleles that
+	// lack each mutation, in the same order as the Eidos code concatenated them
+	int64_t site_count = (int64_t)dos1.size();
+	std::vector<int64_t> diffs(site_count * 2);
 	
-	// a NULL binCount means: each haplosome is a sample, and bins should be
-	// counts, not frequency bins; with N samples, we have bins for the counts
-	// from 1 to N-1 (here we do 0 to N, we will remove the end bins downstream)
-	// note for this mode we do require that all haplosomes belong to a single
-	// chromosome; counts combined across different haplosomes are not valid
-	// in the general case.
-	binsAreSampleCounts = F;
-	if (isNULL(binCount))
+	for (int64_t site_index = 0; site_index < site_count; ++site_index)
 	{
-		chromosome = haplosomes[0].chromosome;
-		if (any(haplosomes.chromosome != chromosome))
-				stop("ERROR (calcSFS): when binCount is NULL, all haplosomes must be associated with the same chromosome; counts should be within a single chromosome, since a different number of haplosomes could be present for different chromosomes.");
+		int64_t d1 = dos1[site_index], d2 = dos2[site_index];
+		int64_t e1 = n1 - d1, e2 = n2 - d2;
 		
-		binCount = haplosomes.length() + 1;		// 0 to number of haplosomes
-		binsAreSampleCounts = T;
+		diffs[site_index] = d1 * (n2 - d2) + (n1 - d1) * d2;
+		diffs[site_index + site_count] = e1 * (n2 - e2) + (n1 - e1) * e2;
 	}
 	
-	// apart from the case above, we do not need to require a single chromosome;
-	// we work with all mutations in the model, even if the haplosomes supplied
-	// belong to a single chromosome.  this works because mutations that are not
-	// present in any of the supplied haplosomes will have a frequency of zero
-	// (or NAN, if the mutation belongs to a different chromosome), and those
-	// will be filtered out below.
-	if (isNULL(muts))
-	{
-		muts = species.mutations;
-	}
-	else
+	double diff = PopGenSumOfIntegers(diffs.data(), site_count * 2);
+	double dxy = diff / 2.0 / n1 / n2;
+	
+	// optionally normalize by the length of the sequence or window
+	if (normalize_value->LogicalAtIndex_NOCAST(0, nullptr))
+		dxy = dxy / length;
+	
+	return EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Float(dxy));
+}
+
+
+// The engine behind calcLD_D() and calcLD_Rsquared().  Each distinct mutation of interest gets a bitset with one bit per
+// haplosome, marking the haplosomes that contain it; the bitsets are filled in a single pass over the haplosomes.  The
+// count of haplosomes containing both mut1 and mut2 is then the popcount of the intersection of their bitsets, computed
+// with Eidos_SIMD::popcount_and_uint64(), so an m1 x m2 matrix costs m1 * m2 * (n / 64) word operations.  Mutations in
+// mut2 that are not segregating follow the semantics of mutationCountsInHaplosomes(): lost mutations are in no haplosome,
+// and fixed mutations are in all of them.  The arithmetic follows the former Eidos implementation, except that D^2 is
+// computed as D * D.  If maxDistance is given, pairs more than maxDistance bases apart are not evaluated, and are NAN.
+static EidosValue_SP PopGenLinkageDisequilibrium(EidosValue *mut1_value, EidosValue *mut2_value, EidosValue *haplosomes_value, EidosValue *max_distance_value, bool calc_r, bool squared, const char *function_name)
+{
+	int mut1_count = mut1_value->Count();
+	
+	if (mut1_count == 0)
+		EIDOS_TERMINATION << "ERROR (SLiM_ExecuteFunction_" << function_name << "): mut1 must be non-empty." << EidosTerminate();
+	
+	// check species
+	Mutation * const *mutations1 = (Mutation * const *)mut1_value->ObjectData();
+	Species *species = Community::SpeciesForMutations(mut1_value);
+	
+	if (!species)
+		EIDOS_TERMINATION << "ERROR (SLiM_ExecuteFunction_" << function_name << "): all mutations in mut1 must belong to the same species." << EidosTerminate();
+	
+	if ((mut2_value->Type() != EidosValueType::kValueNULL) && (mut2_value->Count() > 0))
+		if (Community::SpeciesForMutations(mut2_value) != species)
+			EIDOS_TERMINATION << "ERROR (SLiM_ExecuteFunction_" << function_name << "): all mutations must belong to the same species as mut1." << EidosTerminate();
+	
+	Haplosome **haplosomes = nullptr;
+	int haplosome_count = 0;
+	
+	if (haplosomes_value->Type() != EidosValueType::kValueNULL)
 	{
-		if (any(muts.chromosome.species != species))
-			stop("ERROR (calcSFS): all mutations in muts must belong to the same species as the haplosomes; an SFS can be calculated only within a single species.");
+		haplosomes = (Haplosome **)haplosomes_value->ObjectData();
+		haplosome_count = haplosomes_value->Count();
+		
+		if (haplosome_count && (Community::SpeciesForHaplosomesVector(haplosomes, haplosome_count) != species))
+			EIDOS_TERMINATION << "ERROR (SLiM_ExecuteFunction_" << function_name << "): all haplosomes must belong to the same species as mut1." << EidosTerminate();
 	}
 	
-	if (!binsAreSampleCounts)
+	// check chromosome
+	slim_chromosome_index_t chromosome_index = mutations1[0]->chromosome_index_;
+	
+	if (species->Chromosomes().size() > 1)
 	{
-		// get the frequencies; note mutationFrequenciesInHaplosomes() is smart enough
-		// to assess the frequency of each mutation only within the haplosomes that
-		// are associated with the same chromosome as the mutation, so this should do
-		// the right thing even in multichrom models.
-		freqs = haplosomes.mutationFrequenciesInHaplosomes(muts);
-		
-		// filter out frequencies of zero or NAN; they should not influence the SFS.
-		freqs = freqs[freqs != 0.0];
-		freqs = freqs[isFinite(freqs)];
+		for (int mut1_index = 1; mut1_index < mut1_count; ++mut1_index)
+			if (mutations1[mut1_index]->chromosome_index_ != chromosome_index)
+				EIDOS_TERMINATION << "ERROR (SLiM_ExecuteFunction_" << function_name << "): all mutations in mut1 must belong to the same chromosome." << EidosTerminate();
 		
-		// discretize the frequencies into the specified number of bins
-		bins = pmin(asInteger(floor(freqs * binCount)), binCount - 1);
+		for (int haplosome_index = 0; haplosome_index < haplosome_count; ++haplosome_index)
+			if (haplosomes[haplosome_index]->AssociatedChromosomeIndex() != chromosome_index)
+				EIDOS_TERMINATION << "ERROR (SLiM_ExecuteFunction_" << function_name << "): all haplosomes must belong to the same chromosome as mut1." << EidosTerminate();
 		
-		// tabulate the number of mutations in each frequency bin to make a histogram
-		tallies = tabulate(bins, maxbin=binCount-1);
+		if (mut2_value->Type() != EidosValueType::kValueNULL)
+		{
+			Mutation * const *mutations2 = (Mutation * const *)mut2_value->ObjectData();
+			int mut2_count = mut2_value->Count();
+			
+			for (int mut2_index = 0; mut2_index < mut2_count; ++mut2_index)
+				if (mutations2[mut2_index]->chromosome_index_ != chromosome_index)
+					EIDOS_TERMINATION << "ERROR (SLiM_ExecuteFunction_" << function_name << "): all mutations must belong to the same chromosome as mut1." << EidosTerminate();
+		}
 	}
-	else
+	
+	// if mut2 is NULL, calculate across all mutations for the chromosome (including mut1), in registry order
+	std::vector<bool> chromosome_included(species->Chromosomes().size(), false);
+	std::vector<Mutation *> mutations2;
+	
+	chromosome_included[chromosome_index] = true;
+	
+	PopGenFocalMutations(mutations2, species, mut2_value, chromosome_included, false, 0, 0);
+	
+	// if haplosomes is NULL, calculate across all (non-null) haplosomes for the chromosome
+	EidosValue_Object_SP default_haplosomes;
+	
+	if (haplosomes_value->Type() == EidosValueType::kValueNULL)
 	{
-		// this is the "binCount=NULL" case, where each bin is an integer count
-		// we handle this separately to avoid possible float numerical error
-		counts = haplosomes.mutationCountsInHaplosomes(muts);
+		std::vector<slim_chromosome_index_t> chromosome_indices(1, chromosome_index);
 		
-		// filter out counts of zero; they should not influence the SFS.
-		counts = counts[counts != 0.0];
+		default_haplosomes = EidosValue_Object_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Object(gSLiM_Haplosome_Class));
 		
-		// tabulate the number of mutations in each count bin to make a histogram
-		tallies = tabulate(counts, maxbin=binCount-1);
+		for (auto subpop_pair : species->population_.subpops_)
+			for (Individual *individual : subpop_pair.second->parent_individuals_)
+				individual->AppendHaplosomesForChromosomes(default_haplosomes.get(), chromosome_indices, -1, false);
 		
-		// unlike above (frequency bins), with count bins we discard the bottom
-		// and top bins; count bins span [1, N-1]; the top bin might contain fixed
-		// mutations in SLiM, but they are not empirically observable
-		if (binsAreSampleCounts)
-			tallies = tallies[1:(length(tallies)-2)];
+		haplosomes = (Haplosome **)default_haplosomes->ObjectData();
+		haplosome_count = default_haplosomes->Count();
 	}
 	
-	// "fold" the SFS if requested, combining the first and last value, and on
-	// to the center; this is often done empirically because you don't know
-	// which allele is ancestral and which is derived.  the tricky thing is
-	// what to do with the central bin, if there is an odd number of bins; we
-	// add it to itself, but the central bin could be handled other ways too,
-	// such as excluding that data point (which the user can do after).
-	if (fold & (size(tallies) >= 2))
+	if (haplosome_count == 0)
+		EIDOS_TERMINATION << "ERROR (SLiM_ExecuteFunction_" << function_name << "): haplosomes must be non-empty." << EidosTerminate();
+	
+	for (int haplosome_index = 0; haplosome_index < haplosome_count; ++haplosome_index)
+		if (haplosomes[haplosome_index]->IsNull())
+			EIDOS_TERMINATION << "ERROR (SLiM_ExecuteFunction_" << function_name << "): " << function_name << "() cannot be called on a null haplosome." << EidosTerminate();
+	
+	species->population_.CheckForDeferralInHaplosomesVector(haplosomes, haplosome_count, std::string("SLiM_ExecuteFunction_") + function_name);
+	
+	int64_t max_distance = -1;
+	
+	if (max_distance_value->Type() != EidosValueType::kValueNULL)
 	{
-		midpoint = (length(tallies) - 1) / 2;
-		leftSeq = asInteger(seq(from=0, to=midpoint));
-		rightSeq = asInteger(seq(from=length(tallies)-1, to=midpoint));
-		tallies = tallies[leftSeq] + tallies[rightSeq];
+		max_distance = max_distance_value->IntAtIndex_NOCAST(0, nullptr);
+		
+		if (max_distance < 0)
+			EIDOS_TERMINATION << "ERROR (SLiM_ExecuteFunction_" << function_name << "): maxDistance must be greater than or equal to zero." << EidosTerminate();
 	}
 	
-	// return either counts or densities, as requested; note that you can have
-	// binsAreSampleCounts be T, and yet return density values, that is legal,
-	// and just means that you want densities for singletons, doubletons, etc.
-	if (metric == "count")
-		return tallies;
-	else if (metric == "density")
-		return tallies / sum(tallies);
-	else
-		stop("ERROR (calcSFS): unrecognized value '" + metric + "' for parameter metric.");
-})V0G0N";
-
-#pragma mark (float$)calcTajimasD(object<Haplosome> haplosomes, [No<Mutation> muts = NULL], [Ni$ start = NULL], [Ni$ end = NULL])
-const char *gSLiMSourceCode_calcTajimasD = 
-R"V0G0N({
-	if (haplosomes.length() < 4)
-		stop("ERROR (calcTajimasD): haplosomes must contain at least four elements.");
+	// assign a bitset slot to each distinct mutation that needs one: every mutation in mut1, and segregating mutations in mut2
+	int mut2_count = (int)mutations2.size();
+	MutationIndex max_block_index = 0;
 	
-	species = haplosomes[0].individual.subpopulation.species;
-	if (community.allSpecies.length() > 1)
+	for (int mut1_index = 0; mut1_index < mut1_count; ++mut1_index)
+		max_block_index = std::max(max_block_index, mutations1[mut1_index]->BlockIndex());
+	for (int mut2_index = 0; mut2_index < mut2_count; ++mut2_index)
+		max_block_index = std::max(max_block_index, mutations2[mut2_index]->BlockIndex());
+	
+	std::vector<int32_t> slot_for_block_index(max_block_index + 1, -1);
+	std::vector<int32_t> slots1(mut1_count), slots2(mut2_count, -1);
+	int32_t slot_count = 0;
+	
+	for (int mut1_index = 0; mut1_index < mut1_count; ++mut1_index)
 	{
-		if (any(haplosomes.individual.subpopulation.species != species))
-			stop("ERROR (calcTajimasD): all haplosomes must belong to the same species.");
-		if (!isNULL(muts))
-			if (any(muts.mutationType.species != species))
-				stop("ERROR (calcTajimasD): all mutations must belong to the same species as the haplosomes.");
+		int32_t &slot = slot_for_block_index[mutations1[mut1_index]->BlockIndex()];
+		
+		if (slot == -1)
+			slot = slot_count++;
+		slots1[mut1_index] = slot;
 	}
-	
-	chromosome = haplosomes[0].chromosome;
-	if (species.chromosomes.length() > 1)
+	for (int mut2_index = 0; mut2_index < mut2_count; ++mut2_index)
 	{
-		if (any(haplosomes.chromosome != chromosome))
-			stop("ERROR (calcTajimasD): all haplosomes must be associated with the same chromosome.");
-		if (!isNULL(muts))
-			if (any(muts.chromosome != chromosome))
-				stop("ERROR (calcTajimasD): all mutations must be associated with the same chromosome as the haplosomes.");
+		if (mutations2[mut2_index]->state_ == MutationState::kInRegistry)
+		{
+			int32_t &slot = slot_for_block_index[mutations2[mut2_index]->BlockIndex()];
+			
+			if (slot == -1)
+				slot = slot_count++;
+			slots2[mut2_index] = slot;
+		}
 	}
 	
-	length = chromosome.length;
+	// fill the bitsets in one pass over the haplosomes, and count the set bits of each
+	int64_t word_count = (haplosome_count + 63) / 64;
+	std::vector<uint64_t> bitsets(slot_count * word_count, 0);
+	std::vector<int64_t> slot_counts(slot_count);
+	uint64_t *bitsets_ptr = bitsets.data();
 	
-	if (isNULL(muts))
-		muts = species.subsetMutations(chromosome=chromosome);
+	for (int haplosome_index = 0; haplosome_index < haplosome_count; ++haplosome_index)
+	{
+		HaplosomeWalker walker(haplosomes[haplosome_index]);
+		int64_t word_index = haplosome_index / 64;
+		uint64_t bit = (uint64_t)1 << (haplosome_index % 64);
+		
+		for ( ; !walker.Finished(); walker.NextMutation())
+		{
+			MutationIndex block_index = walker.CurrentMutation()->BlockIndex();
+			
+			if (block_index <= max_block_index)
+			{
+				int32_t slot = slot_for_block_index[block_index];
+				
+				if (slot != -1)
+					bitsets_ptr[slot * word_count + word_index] |= bit;
+			}
+		}
+	}
 	
-	// handle windowing
-	if (!isNULL(start) & !isNULL(end))
+	for (int32_t slot = 0; slot < slot_count; ++slot)
 	{
-		if (start > end)
-			stop("ERROR (calcTajimasD): start must be less than or equal to end.");
-		if ((start < 0) | (end >= length))
-			stop("ERROR (calcTajimasD): start and end must be within the bounds of the focal chromosome");
-		mpos = muts.position;
-		muts = muts[(mpos >= start) & (mpos <= end)];
-		length = end - start + 1;
+		const uint64_t *bitset = bitsets_ptr + slot * word_count;
+		
+		slot_counts[slot] = Eidos_SIMD::popcount_and_uint64(bitset, bitset, word_count);
 	}
-	else if (!isNULL(start) | !isNULL(end))
+	
+	// calculate D, r, or r^2 for each pair; the result is column-major, with mut1 down the rows and mut2 across the columns
+	EidosValue_Float *float_result = (new (gEidosValuePool->AllocateChunk()) EidosValue_Float())->resize_no_initialize((size_t)mut1_count * mut2_count);
+	EidosValue_SP result_SP = EidosValue_SP(float_result);
+	double *result_data = float_result->data_mutable();
+	double n = (double)haplosome_count;
+	
+	for (int mut2_index = 0; mut2_index < mut2_count; ++mut2_index)
 	{
-		stop("ERROR (calcTajimasD): start and end must both be NULL or both be non-NULL.");
+		Mutation *mut2 = mutations2[mut2_index];
+		int32_t slot2 = slots2[mut2_index];
+		int8_t mut2_state = mut2->state_;
+		slim_position_t position2 = mut2->position_;
+		const uint64_t *bitset2 = (slot2 == -1) ? nullptr : bitsets_ptr + slot2 * word_count;
+		int64_t count2 = (slot2 != -1) ? slot_counts[slot2] : ((mut2_state == MutationState::kLostAndRemoved) ? 0 : haplosome_count);
+		double *result_column = result_data + (size_t)mut2_index * mut1_count;
+		
+		for (int mut1_index = 0; mut1_index < mut1_count; ++mut1_index)
+		{
+			if ((max_distance != -1) && (std::abs((int64_t)mutations1[mut1_index]->position_ - (int64_t)position2) > max_distance))
+			{
+				result_column[mut1_index] = std::numeric_limits<double>::quiet_NaN();
+				continue;
+			}
+			
+			int32_t slot1 = slots1[mut1_index];
+			int64_t count1 = slot_counts[slot1];
+			
+			if (count1 == 0)
+			{
+				// D=0 if either mutation is not present; r^2 doesn't exist if either mutation is absent (0/0)
+				result_column[mut1_index] = (calc_r ? std::numeric_limits<double>::quiet_NaN() : 0.0);
+				continue;
+			}
+			
+			int64_t count12;
+			
+			if (bitset2)
+				count12 = Eidos_SIMD::popcount_and_uint64(bitsets_ptr + slot1 * word_count, bitset2, word_count);
+			else
+				count12 = (mut2_state == MutationState::kLostAndRemoved) ? 0 : count1;
+			
+			double p_12 = count12 / n;
+			double p_1 = count1 / n;
+			double p_2 = count2 / n;
+			volatile double p_1_p_2 = p_1 * p_2;
+			double D = p_12 - p_1_p_2;
+			
+			if (calc_r)
+			{
+				double denominator = p_1_p_2 * (1.0 - p_1) * (1.0 - p_2);
+				
+				// squared=T returns r^2 between 0 and 1; squared=F returns r between -1 and 1
+				if (squared)
+					result_column[mut1_index] = (D * D) / denominator;
+				else
+					result_column[mut1_index] = D / sqrt(denominator);
+			}
+			else
+			{
+				result_column[mut1_index] = D;
+			}
+		}
 	}
 	
-	// narrow down to the mutations that are actually present in the haplosomes and aren't fixed
-	p = haplosomes.mutationFrequenciesInHaplosomes(muts);
-	muts = muts[(p != 0.0) & (p != 1.0)];
+	// a singleton mut1 produces a vector, as calcLD_D() and calcLD_Rsquared() always have; otherwise, a matrix
+	if ((mut1_count > 1) && (mut2_count > 0))
+	{
+		const int64_t dims[2] = {mut1_count, mut2_count};
+		
+		result_SP->SetDimensions(2, dims);
+	}
 	
-	// do the calculation
-	// Pi and Watterson's theta functions divide by sequence length so this must be undone in Tajima's D
-	// Sequence length is constant (i.e. no missing data or indels) so this can be applied equally over both metrics
-	diff = (calcPi(haplosomes, muts, start, end) - calcWattersonsTheta(haplosomes, muts, start, end)) * length;
-	// calculate standard deviation of covariance of pi and Watterson's theta
-	// note that first 3 variables defined below are sufficient for Watterson's theta calculation as well,
-	// although the calcWattersonsTheta() function is used above for proper interval handling and clarity 
-	k = size(muts);
-	n = haplosomes.size();
-	a_1 = sum(1 / 1:(n - 1));
-	a_2 = sum(1 / (1:(n - 1)) ^ 2);
-	b_1 = (n + 1) / (3 * (n - 1));
-	b_2 = 2 * (n ^ 2 + n + 3) / (9 * n * (n - 1));
-	c_1 = b_1 - 1 / a_1;
-	c_2 = b_2 - (n + 2) / (a_1 * n) + a_2 / a_1 ^ 2;
-	e_1 = c_1 / a_1;
-	e_2 = c_2 / (a_1 ^ 2 + a_2);
-	covar = e_1 * k + e_2 * k * (k - 1);
-	stdev = sqrt(covar);
-	tajima_d = diff / stdev;
-	return tajima_d;
-})V0G0N";
+	return result_SP;
+}
+
+//	(float)calcLD_D(object<Mutation> mut1, [No<Mutation> mut2 = NULL], [No<Haplosome> haplosomes = NULL], [Ni$ maxDistance = NULL])
+EidosValue_SP SLiM_ExecuteFunction_calcLD_D(const std::vector<EidosValue_SP> &p_arguments, __attribute__((unused)) EidosInterpreter &p_interpreter)
+{
+	return PopGenLinkageDisequilibrium(p_arguments[0].get(), p_arguments[1].get(), p_arguments[2].get(), p_arguments[3].get(), false, false, "calcLD_D");
+}
 
+//	(float)calcLD_Rsquared(object<Mutation> mut1, [No<Mutation> mut2 = NULL], [No<Haplosome> haplosomes = NULL], [logical$ squared = T], [Ni$ maxDistance = NULL])
+EidosValue_SP SLiM_ExecuteFunction_calcLD_Rsquared(const std::vector<EidosValue_SP> &p_arguments, __attribute__((unused)) EidosInterpreter &p_interpreter)
+{
+	bool squared = p_arguments[3]->LogicalAtIndex_NOCAST(0, nullptr);
+	
+	return PopGenLinkageDisequilibrium(p_arguments[0].get(), p_arguments[1].get(), p_arguments[2].get(), p_arguments[4].get(), true, squared, "calcLD_Rsquared");
+}
 
 // ************************************************************************************
 //
@@ -2581,6 +2983,9 @@ EidosValue_SP SLiM_ExecuteFunction_treeSeqMetadata(const std::vector<EidosValue_
 	EidosValue *filePath_value = p_arguments[0].get();
 	std::string file_path = Eidos_ResolvedPath(Eidos_StripTrailingSlash(filePath_value->StringAtIndex_NOCAST(0, nullptr)));
 	
+	// the file might be pending an asynchronous write, which needs to complete first
+	Eidos_WaitForAsyncFileWrites();
+	
 	tsk_table_collection_t temp_tables;
 	
 	int ret = tsk_table_collection_load(&temp_tables, file_path.c_str(), TSK_LOAD_SKIP_TABLES | TSK_LOAD_SKIP_REFERENCE_SEQUENCE);
@@ -1630,6 +1630,8 @@ const std::string &gStr_species = EidosRegisteredString("species", gID_species);
 const std::string &gStr_ticks = EidosRegisteredString("ticks", gID_ticks);
 const std::string &gStr_speciesSpec = EidosRegisteredString("speciesSpec", gID_speciesSpec);
 const std::string &gStr_ticksSpec = EidosRegisteredString("ticksSpec", gID_ticksSpec);
+const std::string &gStr_compiled = EidosRegisteredString("compiled", gID_compiled);
+const std::string &gStr_vectorized = EidosRegisteredString("vectorized", gID_vectorized);
 const std::string &gStr_first = EidosRegisteredString("first", gID_first);
 const std::string &gStr_early = EidosRegisteredString("early", gID_early);
 const std::string &gStr_late = EidosRegisteredString("late", gID_late);
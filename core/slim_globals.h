@@ -1204,6 +1204,8 @@ extern const std::string &gStr_species;
 extern const std::string &gStr_ticks;
 extern const std::string &gStr_speciesSpec;
 extern const std::string &gStr_ticksSpec;
+extern const std::string &gStr_compiled;
+extern const std::string &gStr_vectorized;
 extern const std::string &gStr_first;
 extern const std::string &gStr_early;
 extern const std::string &gStr_late;
@@ -1652,6 +1654,8 @@ enum _SLiMGlobalStringID : int {
 	gID_ticks,
 	gID_speciesSpec,
 	gID_ticksSpec,
+	gID_compiled,
+	gID_vectorized,
 	gID_first,
 	gID_early,
 	gID_late,
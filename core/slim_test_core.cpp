@@ -580,6 +580,53 @@ void _RunSpeciesTests(const std::string &temp_path)
 		SLiMAssertScriptSuccess(gen1_setup_p1 + "1 early() { sim.readFromPopulationFile('" + temp_path + "/slimOutputFullTest.slimbinary'); if (size(sim.subpopulations) != 3) stop(); }", __LINE__);	// legal; should wipe previous state
 	}
 	
+	// Test binary round trips with multiple chromosomes and null haplosomes; the text output before and after must match, whether or not
+	// the mutation run count of the reading model matches that of the file (which determines whether the file's runs are shared on load)
+	if (Eidos_TemporaryDirectoryExists())
+	{
+		std::string binary_roundtrip_string(R"V0G0N(
+initialize() {
+	defineConstant("MUTRUNS", *****);
+	initializeSex();
+	initializeMutationType("m1", 0.5, "f", 0.0);
+	initializeMutationType("m2", 0.5, "e", 0.02);
+	initializeGenomicElementType("g1", c(m1, m2), c(1.0, 0.1));
+	ids = 1:3;
+	types = c("A", "X", "Y");
+	for (id in ids)
+	{
+		initializeChromosome(id, 100000, types[id - 1], mutationRuns=MUTRUNS);
+		initializeGenomicElement(g1, 0, 99999);
+		initializeMutationRate(1e-6);
+		initializeRecombinationRate(1e-7);
+	}
+}
+1 early() { sim.addSubpop("p1", 50); }
+30 late() {
+	if (MUTRUNS == 8)
+	{
+		sim.outputFull(tempdir() + "slim_binary_roundtrip.slimbinary", binary=T);
+		sim.outputFull(tempdir() + "slim_binary_roundtrip_1.txt");
+	}
+	sim.readFromPopulationFile(tempdir() + "slim_binary_roundtrip.slimbinary");
+	sim.outputFull(tempdir() + "slim_binary_roundtrip_2.txt");
+	if (!identical(readFile(tempdir() + "slim_binary_roundtrip_1.txt"), readFile(tempdir() + "slim_binary_roundtrip_2.txt")))
+		stop("binary round trip mismatch with mutationRuns=" + MUTRUNS);
+	stop();
+}
+)V0G0N");
+		
+		for (std::string mutruns : {"8", "3"})
+		{
+			std::string test_string = binary_roundtrip_string;
+			
+			test_string.replace(test_string.find("*****"), 5, mutruns);
+			SLiMAssertScriptStop(test_string, __LINE__);
+		}
+		
+		SLiMAssertScriptStop(gen1_setup_highmut_p1 + "10 late() { h = p1.haplosomes; h.tag = seqLen(size(h)); m = sim.mutations; m.tag = m.id * 2; sim.outputFull('" + temp_path + "/slimOutputFullTest_TAGS.slimbinary', binary=T, objectTags=T); sim.readFromPopulationFile('" + temp_path + "/slimOutputFullTest_TAGS.slimbinary'); h = p1.haplosomes; m = sim.mutations; if (identical(h.tag, seqLen(size(h))) & identical(m.tag, m.id * 2)) stop(); }", __LINE__);
+	}
+	
 	// Test sim - (object<SLiMEidosBlock>)registerFirstEvent(Nis$ id, string$ source, [integer$ start], [integer$ end])
 	SLiMAssertScriptStop(gen1_setup_p1 + "1 early() { community.registerFirstEvent(NULL, '{ stop(); }', 2, 2); }", __LINE__);
 	SLiMAssertScriptRaise(gen1_setup_p1 + "1 early() { community.registerFirstEvent('s1', '{ stop(); }', 2, 2); } s1 early() { }", "already defined", __LINE__);
@@ -1045,6 +1092,34 @@ void _RunSubpopulationTests(void)
 	SLiMAssertScriptRaise(gen1_setup_p1 + "2 early() { identical(p1.cachedFitness(10), rep(1.0, 10)); stop(); }", "out of range", __LINE__);
 	SLiMAssertScriptRaise(gen1_setup_p1 + "2 early() { identical(p1.cachedFitness(c(-1,5)), rep(1.0, 10)); stop(); }", "out of range", __LINE__);
 	SLiMAssertScriptRaise(gen1_setup_p1 + "2 early() { identical(p1.cachedFitness(c(5,10)), rep(1.0, 10)); stop(); }", "out of range", __LINE__);
+	SLiMAssertScriptStop(nonWF_prefix + gen1_setup_p1 + "1 early() { p1.individuals.fitnessScaling = c(0.0, 1.5, 0.0, 2.0, 1.25, 0.0, 3.0, 1.0, 1.5, 0.0); } 1 late() { if (identical(p1.cachedFitness(NULL), c(1.5, 2.0, 1.25, 3.0, 1.0, 1.5)) & identical(p1.cachedFitness(c(5,0)), c(1.5, 1.5))) stop(); }", __LINE__);				// after viability selection
+	SLiMAssertScriptStop(nonWF_prefix + gen1_setup_p1 + "1 early() { p1.individuals.fitnessScaling = 1.0 + (0:9) / 4; } 1 late() { p1.individuals.tagF = p1.cachedFitness(NULL); sim.killIndividuals(p1.individuals[c(2, 5)]); f = p1.cachedFitness(NULL); if ((size(f) == 8) & identical(f, p1.individuals.tagF)) stop(); }", __LINE__);				// after killIndividuals()
+	SLiMAssertScriptStop(nonWF_prefix + gen1_setup_p1 + "1 early() { p1.individuals.fitnessScaling = 1.0 + (0:9) / 4; } 1 late() { sim.addSubpop('p2', 5); p2.individuals.tagF = 1.0; p1.individuals.tagF = p1.cachedFitness(NULL); p2.takeMigrants(p1.individuals[0:3]); if (identical(p1.cachedFitness(NULL), p1.individuals.tagF) & identical(p2.cachedFitness(NULL), p2.individuals.tagF)) stop(); }", __LINE__);				// after takeMigrants()
+	
+	// Test that fitness without callbacks (calculated by the bulk product kernels in eidos_simd.h) matches a product computed in script; the first
+	// model accumulates hundreds of mutations per haplosome, the second stacks mutations at the same positions, and the third is haploid
+	std::string fitness_check("{ f = p1.cachedFitness(NULL); ok = T; for (i in seqAlong(p1.individuals)) { h = p1.individuals[i].haplosomes; a = h[0].mutations; w = product(1 + a.selectionCoeff); "
+							  "if (size(h) == 2) { b = h[1].mutations; hom1 = h[1].containsMutations(a); hom2 = h[0].containsMutations(b); w = product(1 + a[hom1].selectionCoeff) * product(1 + a[!hom1].mutationType.dominanceCoeff * a[!hom1].selectionCoeff) * product(1 + b[!hom2].mutationType.dominanceCoeff * b[!hom2].selectionCoeff); } "
+							  "if (abs(w / f[i] - 1) > 1e-4) ok = F; } if (ok) stop(); }");
+	SLiMAssertScriptStop("initialize() { initializeMutationRate(1e-4); initializeMutationType('m1', 0.3, 'f', -0.0005); initializeMutationType('m2', 0.8, 'e', 0.0005); initializeGenomicElementType('g1', c(m1, m2), c(3, 1)); initializeGenomicElement(g1, 0, 99999); initializeRecombinationRate(1e-6); } 1 early() { sim.addSubpop('p1', 20); } 40 early() " + fitness_check, __LINE__);
+	SLiMAssertScriptStop("initialize() { initializeMutationRate(2e-3); initializeMutationType('m1', 0.3, 'f', -0.001); initializeMutationType('m2', 0.8, 'e', 0.001); initializeGenomicElementType('g1', c(m1, m2), c(3, 1)); initializeGenomicElement(g1, 0, 99); initializeRecombinationRate(1e-3); } 1 early() { sim.addSubpop('p1', 20); } 40 early() " + fitness_check, __LINE__);
+	SLiMAssertScriptStop("initialize() { initializeChromosome(1, 100000, 'H'); initializeMutationRate(1e-4); initializeMutationType('m1', 0.3, 'f', -0.0005); initializeMutationType('m2', 0.8, 'e', 0.0005); initializeGenomicElementType('g1', c(m1, m2), c(3, 1)); initializeGenomicElement(g1, 0, 99999); initializeRecombinationRate(1e-6); } 1 early() { sim.addSubpop('p1', 20); } 40 early() " + fitness_check, __LINE__);
+	
+	// mutation runs cache the products of their fitness factors; check that shared runs use them correctly, and that changes to mutation effects invalidate them
+	std::string selfing_fitness_model("initialize() { initializeMutationRate(1e-4); initializeMutationType('m1', 0.3, 'f', -0.0005); initializeMutationType('m2', 0.8, 'e', 0.0005); initializeGenomicElementType('g1', c(m1, m2), c(3, 1)); initializeGenomicElement(g1, 0, 99999); initializeRecombinationRate(1e-6); } 1 early() { sim.addSubpop('p1', 20); p1.setSelfingRate(0.9); } ");
+	SLiMAssertScriptStop(selfing_fitness_model + "40 early() " + fitness_check, __LINE__);
+	SLiMAssertScriptStop(selfing_fitness_model + "40 early() { m1.dominanceCoeff = 0.9; sim.recalculateFitness(); } 40 early() " + fitness_check, __LINE__);
+	SLiMAssertScriptStop(selfing_fitness_model + "40 early() { for (mut in sim.mutations) mut.setSelectionCoeff(mut.selectionCoeff * 3); sim.recalculateFitness(); } 40 early() " + fitness_check, __LINE__);
+	
+	// nonWF models carry the mutational component of fitness over for individuals whose mutation runs and mutation effects are unchanged; check that changes to either are seen
+	std::string nonWF_fitness_model("initialize() { initializeSLiMModelType('nonWF'); initializeMutationRate(1e-4); initializeMutationType('m1', 0.3, 'f', -0.0005); initializeMutationType('m2', 0.8, 'e', 0.0005); initializeGenomicElementType('g1', c(m1, m2), c(3, 1)); initializeGenomicElement(g1, 0, 99999); initializeRecombinationRate(1e-6); } "
+									"reproduction() { subpop.addCrossed(individual, subpop.sampleIndividuals(1)); } 1 early() { sim.addSubpop('p1', 30); } late() { if (p1.individualCount > 30) sim.killIndividuals(p1.sampleIndividuals(p1.individualCount - 30)); } ");
+	SLiMAssertScriptStop(nonWF_fitness_model + "30 late() { sim.recalculateFitness(); } 30 late() " + fitness_check, __LINE__);
+	SLiMAssertScriptStop(nonWF_fitness_model + "30 late() { sim.recalculateFitness(); for (mut in sim.mutations) mut.setSelectionCoeff(mut.selectionCoeff * 3); sim.recalculateFitness(); } 30 late() " + fitness_check, __LINE__);
+	SLiMAssertScriptStop(nonWF_fitness_model + "30 late() { sim.recalculateFitness(); sim.mutations[sim.mutations.mutationType == m1].setMutationType(m2); sim.recalculateFitness(); } 30 late() " + fitness_check, __LINE__);
+	SLiMAssertScriptStop(nonWF_fitness_model + "30 late() { sim.recalculateFitness(); m1.dominanceCoeff = 0.9; sim.recalculateFitness(); } 30 late() " + fitness_check, __LINE__);
+	SLiMAssertScriptStop(nonWF_fitness_model + "30 late() { sim.recalculateFitness(); p1.individuals[p1.individuals.age > 0].haplosomes[0].addNewMutation(m2, 0.05, 500); sim.recalculateFitness(); } 30 late() " + fitness_check, __LINE__);
+	SLiMAssertScriptStop(nonWF_fitness_model + "30 late() { sim.recalculateFitness(); h = p1.individuals[p1.individuals.age > 0].haplosomes; h.removeMutations(h.mutations[h.mutations.mutationType == m1]); sim.recalculateFitness(); } 30 late() " + fitness_check, __LINE__);
 	
 	// Test Subpopulation – (object<Individual>)sampleIndividuals(integer$ size, [logical$ replace = F], [No<Individual>$ exclude = NULL], [Ns$ sex = NULL], [Ni$ tag = NULL], [Ni$ minAge = NULL], [Ni$ maxAge = NULL], [Nl$ migrant = NULL])
 	SLiMAssertScriptStop(gen1_setup_p1 + "1 early() { if (size(p1.sampleIndividuals(0)) == 0) stop(); }", __LINE__);
@@ -2154,6 +2229,11 @@ void _RunIndividualTests(void)
 	SLiMAssertScriptStop(gen1_setup_rel + "5 early() { if (all(p1.individuals.haplosomes.haplosomePedigreeID != -1)) stop(); }", __LINE__);
 	SLiMAssertScriptStop(gen1_setup_rel + "5 early() { if (p1.individuals[0].relatedness(p1.individuals[0]) == 1.0) stop(); }", __LINE__);
 	SLiMAssertScriptStop(gen1_setup_rel + "5 early() { if (p1.individuals[0].sharedParentCount(p1.individuals[0]) == 2) stop(); }", __LINE__);
+	
+	// WF offspring are generated grouped by first parent, but they should still be placed in draw order, with ascending pedigree IDs and unsorted parents
+	SLiMAssertScriptStop(gen1_setup_rel + "5 early() { ids = p1.individuals.pedigreeID; if (all(ids[1:9] > ids[0:8])) stop(); }", __LINE__);
+	SLiMAssertScriptStop(gen1_setup_rel + "1 early() { sim.addSubpop('p2', 200); } 5 early() { p = p2.individuals.pedigreeParentIDs[seq(0, 399, by=2)]; if (!identical(p, sort(p))) stop(); }", __LINE__);
+	SLiMAssertScriptStop(gen1_setup_rel_S + "1 early() { sim.addSubpop('p2', 200); } 5 early() { f = p2.individuals[p2.individuals.sex == 'F']; p = f.pedigreeParentIDs[seq(0, 2 * size(f) - 1, by=2)]; if (!identical(p, sort(p)) & all(f.pedigreeID[1:(size(f)-1)] > f.pedigreeID[0:(size(f)-2)])) stop(); }", __LINE__);
 	// In certain inbreeding scenarios, which can happen by chance, relatedness of individuals can be 1.0 (maybe even higher?) so these tests are no good
 	//SLiMAssertScriptStop(gen1_setup_rel + "5 early() { if (p1.individuals[0].relatedness(p1.individuals[1]) < 1.0) stop(); }", __LINE__);
 	//SLiMAssertScriptStop(gen1_setup_rel + "5 early() { if (all(p1.individuals[0].relatedness(p1.individuals[1:9]) < 1.0)) stop(); }", __LINE__);
@@ -2191,6 +2271,27 @@ void _RunSLiMEidosBlockTests(void)
 	SLiMAssertScriptStop(gen1_setup_p1 + "1 early() { s1.tag = 219; if (s1.tag == 219) stop(); } s1 2:4 early() { sim = 10; } ", __LINE__);
 	SLiMAssertScriptRaise(gen1_setup_p1 + "1 early() { s1.type = 'event'; stop(); } s1 2:4 early() { sim = 10; } ", "read-only property", __LINE__);
 	
+	// Test the compiled property, and that compiled callbacks produce the same results as interpreted callbacks
+	SLiMAssertScriptStop(gen1_setup_p1 + "1 early() { if (s1.compiled) stop(); } s1 mutationEffect(m1) { x = effect * 1.5; return x; } ", __LINE__);
+	SLiMAssertScriptStop(gen1_setup_p1 + "1 early() { if (!s1.compiled) stop(); } s1 2:4 early() { x = 10; } ", __LINE__);
+	SLiMAssertScriptStop(gen1_setup_p1 + "1 early() { if (!s1.compiled) stop(); } s1 mutationEffect(m1) { return c(effect, 1.0)[0]; } ", __LINE__);
+	SLiMAssertScriptStop(gen1_setup_p1 + "1 early() { s1.compiled = F; if (!s1.compiled) { s1.compiled = T; if (s1.compiled) stop(); } } s1 fitnessEffect() { return individual.tagF; } ", __LINE__);
+	SLiMAssertScriptRaise(gen1_setup_p1 + "1 early() { s1.compiled = T; } s1 mutationEffect(m1) { return c(effect, 1.0)[0]; } ", "could not be compiled", __LINE__);
+	SLiMAssertScriptStop(gen1_setup_p1 + "1 late() { p1.individuals.tagF = runif(10); } 2 early() { sim.recalculateFitness(); f1 = p1.cachedFitness(NULL); s1.compiled = F; sim.recalculateFitness(); f2 = p1.cachedFitness(NULL); if (identical(f1, f2)) stop(); } s1 fitnessEffect() { x = individual.tagF; if (x > 0.5 & subpop == p1) return 1.0 + x * 0.1 - x % 0.3; else return sqrt(exp(-x) ^ 2); } ", __LINE__);
+	SLiMAssertScriptStop(gen1_setup_p1 + "2 early() { p1.haplosomes[0:5].addNewDrawnMutation(m1, 500); p1.haplosomes[3:8].addNewDrawnMutation(m1, 700); sim.recalculateFitness(); f1 = p1.cachedFitness(NULL); s1.compiled = F; sim.recalculateFitness(); f2 = p1.cachedFitness(NULL); if (identical(f1, f2) & !all(f1 == 1.0)) stop(); } s1 mutationEffect(m1) { if (isNULL(homozygous)) return effect; return homozygous ? 0.5 else 1.0 + mut.position / 1e4 + individual.index; } ", __LINE__);
+	SLiMAssertScriptRaise(gen1_setup_p1 + "s1 fitnessEffect() { x = 9223372036854775807; y = x + individual.index + 1; return 1.0; } 3 early() { stop(); } ", "overflow", __LINE__);
+	
+	// Test the vectorized property, and that vectorized mutationEffect() callbacks produce the same results as per-mutation callbacks
+	SLiMAssertScriptStop(gen1_setup_p1 + "1 early() { if (!s1.vectorized) { s1.vectorized = T; if (s1.vectorized) stop(); } } s1 mutationEffect(m1) { return effect; } ", __LINE__);
+	SLiMAssertScriptRaise(gen1_setup_p1 + "1 early() { s1.vectorized = T; } s1 mateChoice() { return NULL; } ", "can only be set to T", __LINE__);
+	SLiMAssertScriptRaise(gen1_setup_p1 + "1 early() { s1.vectorized = T; } s1 2:4 early() { x = 10; } ", "can only be set to T", __LINE__);
+	SLiMAssertScriptStop(gen1_setup_p1 + "1 early() { s1.vectorized = F; if (!s1.vectorized) stop(); } s1 fitnessEffect() { return 1.0; } ", __LINE__);
+	SLiMAssertScriptStop(gen1_setup_p1 + "2 early() { p1.haplosomes[0:5].addNewDrawnMutation(m1, 500); p1.haplosomes[3:8].addNewDrawnMutation(m1, 700); sim.recalculateFitness(); f1 = p1.cachedFitness(NULL); s1.vectorized = T; sim.recalculateFitness(); f2 = p1.cachedFitness(NULL); if (all(abs(f1 - f2) < 1e-12) & !all(f1 == 1.0)) stop(); } s1 mutationEffect(m1) { return ifelse(homozygous, 0.5, 1.0 + mut.position / 1e4 + individual.index * effect); } ", __LINE__);
+	SLiMAssertScriptStop(gen1_setup_p1 + "initialize() { initializeMutationType('m2', 0.2, 'f', 0.1); } 2 early() { p1.haplosomes[0:5].addNewDrawnMutation(m1, 500); p1.haplosomes[2:8].addNewDrawnMutation(m2, 500); p1.haplosomes[4:9].addNewDrawnMutation(m2, 900); sim.recalculateFitness(); f1 = p1.cachedFitness(NULL); s1.vectorized = T; sim.recalculateFitness(); f2 = p1.cachedFitness(NULL); if (all(abs(f1 - f2) < 1e-12) & !all(f1 == 1.0)) stop(); } s1 mutationEffect(m2) { return effect * ifelse(homozygous, 2.0, 1.0 + mut.position / 1e4) + individual.index / 10; } ", __LINE__);
+	SLiMAssertScriptStop(gen1_setup_p1 + "1 early() { defineGlobal('CALLS', 0); } 2 early() { p1.haplosomes.removeMutations(); p1.haplosomes[0:5].addNewDrawnMutation(m1, 500); defineGlobal('CALLS', 0); s1.vectorized = T; sim.recalculateFitness(); if ((CALLS == 1) & identical(p1.cachedFitness(NULL), c(0.5, 0.5, 0.5, 1, 1, 1, 1, 1, 1, 1))) stop(); } s1 mutationEffect(m1) { defineGlobal('CALLS', CALLS + 1); return rep(0.5, size(mut)); } ", __LINE__);
+	SLiMAssertScriptRaise(gen1_setup_p1 + "2 early() { p1.haplosomes[0:5].addNewDrawnMutation(m1, 500); s1.vectorized = T; sim.recalculateFitness(); } s1 mutationEffect(m1) { return effect[0]; } ", "one element per element of mut", __LINE__);
+	SLiMAssertScriptRaise(gen1_setup_p1 + "2 early() { p1.haplosomes[0:5].addNewDrawnMutation(m1, 500); s1.vectorized = T; sim.recalculateFitness(); } s1 mutationEffect(m1) { return effect; } mutationEffect(m1) { return effect * 2; } ", "must be the only active", __LINE__);
+	
 	// No methods on SLiMEidosBlock
 	
 	// Test user-defined functions in SLiM; there is a huge amount more that could be tested, but these get tested by EidosScribe too,
@@ -2518,6 +2619,19 @@ void _RunSLiMEidosBlockTests(void)
 	SLiMAssertScriptStop(gen1_setup_p1p2p3_nonWF_cross + "survival(p1) { if (!isNULL(individual) & !isNULL(subpop) & !isNULL(surviving) & !isNULL(fitness) & !isNULL(draw)) return T; } 10 early() { stop(); }", __LINE__);
 	SLiMAssertScriptStop(gen1_setup_p1p2p3_nonWF_clone + "survival(p1) { if (!isNULL(individual) & !isNULL(subpop) & !isNULL(surviving) & !isNULL(fitness) & !isNULL(draw)) return T; } 10 early() { stop(); }", __LINE__);
 	
+	// vectorized fitnessEffect(), survival(), and reproduction() callbacks
+	SLiMAssertScriptStop(gen1_setup_p1 + "1 late() { p1.individuals.tagF = runif(10); } 2 early() { sim.recalculateFitness(); f1 = p1.cachedFitness(NULL); s9.vectorized = T; sim.recalculateFitness(); f2 = p1.cachedFitness(NULL); if (identical(f1, f2) & !all(f1 == 1.0)) stop(); } s9 fitnessEffect() { return 1.0 + individual.tagF * 0.5; } ", __LINE__);
+	SLiMAssertScriptStop(gen1_setup_p1 + "1 early() { defineGlobal('CALLS', 0); } 1 late() { p1.individuals.tagF = runif(10); } 2 early() { defineGlobal('CALLS', 0); s9.vectorized = T; sim.recalculateFitness(); if ((CALLS == 1) & identical(p1.cachedFitness(NULL), p1.individuals.tagF * 2.0)) stop(); } s9 fitnessEffect() { defineGlobal('CALLS', CALLS + 1); return individual.tagF; } s10 fitnessEffect() { return 2.0; } ", __LINE__);
+	SLiMAssertScriptRaise(gen1_setup_p1 + "1 early() { s9.vectorized = T; } s9 fitnessEffect() { return 1.0 + individual[0].index; } ", "one element per individual", __LINE__);
+	SLiMAssertScriptStop(gen1_setup_p1p2p3_nonWF_clone + "1 early() { s9.vectorized = T; } s9 survival() { return rep(F, size(individual)); } 10 early() { if (p1.individualCount == 0) stop(); }", __LINE__);
+	SLiMAssertScriptStop(gen1_setup_p1p2p3_nonWF_clone + "1 early() { s9.vectorized = T; } s9 survival(p1) { if (size(individual) != size(fitness) | size(individual) != size(draw) | !identical(surviving, draw < fitness)) stop('mismatch'); return individual.index < 3; } 1 late() { if (p1.individualCount == 3) stop(); }", __LINE__);
+	SLiMAssertScriptStop(gen1_setup_p1p2p3_nonWF_clone + "1 early() { s9.vectorized = T; } s9 survival(p1) { return rep(p2, size(individual)); } 1 late() { if ((p1.individualCount == 0) & (p2.individualCount >= 10)) stop(); }", __LINE__);
+	SLiMAssertScriptStop(gen1_setup_p1p2p3_nonWF_clone + "1 early() { s9.vectorized = T; } s9 survival(p1) { return rep(T, size(individual)); } survival(p1) { if (!surviving) stop('mismatch'); return F; } 1 late() { if (p1.individualCount == 0) stop(); }", __LINE__);
+	SLiMAssertScriptRaise(gen1_setup_p1p2p3_nonWF_clone + "1 early() { s9.vectorized = T; } s9 survival(p1) { return surviving[0]; } 10 early() { ; }", "one element per individual", __LINE__);
+	SLiMAssertScriptStop(gen1_setup_p1p2p3_nonWF + "1 early() { defineGlobal('CALLS', 0); s9.vectorized = T; } s9 reproduction() { if (size(individual) != subpop.individualCount) stop('mismatch'); defineGlobal('CALLS', CALLS + 1); subpop.addCloned(individual[0]); } 3 early() { if (CALLS == 6) stop(); }", __LINE__);
+	SLiMAssertScriptStop(gen1_setup_p1p2p3_nonWF + "1 early() { s9.vectorized = T; } s9 reproduction(NULL, 'M') { if (all(individual.sex == 'M') & (size(individual) == size(subpop.subsetIndividuals(sex='M')))) stop(); } 3 early() { ; }", __LINE__);
+	SLiMAssertScriptRaise(gen1_setup_p1p2p3_nonWF + "1 early() { s9.vectorized = T; } s9 reproduction() { return size(individual); } 3 early() { ; }", "must not return a value", __LINE__);
+	
 	// Test tick range expressions
 	SLiMAssertScriptStop("initialize() { defineConstant('N', 5); } 1 early() {} early() { if (community.tick == 1) stop(); }", __LINE__);
 	SLiMAssertScriptStop("initialize() { defineConstant('N', 5); } 1 early() {} 1: early() { if (community.tick == 1) stop(); }", __LINE__);
@@ -34,6 +34,7 @@
 static void _RunInteractionTypeTests_Nonspatial(bool p_sex_enabled, const std::string &p_sex_segregation);
 static void _RunInteractionTypeTests_Spatial(const std::string &p_max_distance, bool p_sex_enabled, const std::string &p_sex_segregation);
 static void _RunInteractionTypeTests_LocalPopDensity(void);
+static void _RunInteractionTypeTests_SpatialIndex(void);
 static void _RunSpatialKernelValueTests(void);
 static void _RunSpatialKernelSIMDTests(void);
 
@@ -83,6 +84,7 @@ void _RunInteractionTypeTests(void)
 	_RunInteractionTypeTests_Spatial("999.0", false, "**");
 	
 	_RunInteractionTypeTests_LocalPopDensity();		// different enough to get its own call
+	_RunInteractionTypeTests_SpatialIndex();		// cell grid and k-d tree queries, checked against brute force
 
 	_RunSpatialKernelValueTests();					// test numerical correctness of kernel calculations
 	_RunSpatialKernelSIMDTests();					// C++ level tests for SIMD kernel functions
@@ -1170,6 +1172,47 @@ void _RunInteractionTypeTests_LocalPopDensity()
 	// 3D is not supported by clippedIntegral() at the moment
 }
 
+void _RunInteractionTypeTests_SpatialIndex()
+{
+	// Test InteractionType queries with a finite maxDistance, which use a cell grid instead of a k-d tree; we check them against
+	// brute-force results from distance(), with a crowded clump of individuals and with and without periodic boundaries
+	for (int i = 0; i < 6; ++i)
+	{
+		std::string spatiality, periodicity;
+		
+		switch (i)		// NOLINT(*-missing-default-case) : loop bounds
+		{
+			case 0: spatiality = "x"; periodicity = ""; break;
+			case 1: spatiality = "x"; periodicity = "x"; break;
+			case 2: spatiality = "xy"; periodicity = ""; break;
+			case 3: spatiality = "xy"; periodicity = "y"; break;
+			case 4: spatiality = "xyz"; periodicity = ""; break;
+			default: spatiality = "xyz"; periodicity = "xyz"; break;
+		}
+		
+		std::string gen1_setup_grid = "initialize() { initializeSLiMOptions(dimensionality='" + spatiality + "', periodicity='" + periodicity + "'); initializeMutationRate(1e-5); initializeMutationType('m1', 0.5, 'f', 0.0); initializeGenomicElementType('g1', m1, 1.0); initializeGenomicElement(g1, 0, 99999); initializeRecombinationRate(1e-8); initializeInteractionType('i1', '" + spatiality + "', maxDistance=0.1); initializeInteractionType('i2', '" + spatiality + "', maxDistance=0.45); } 1 early() { sim.addSubpop('p1', 200); ind = p1.individuals; ind.setSpatialPosition(p1.pointUniform(200)); ind[0:39].setSpatialPosition(p1.pointUniform(40) * 0.05); i1.evaluate(p1); i2.evaluate(p1); ";
+		
+		SLiMAssertScriptStop(gen1_setup_grid + "brute = sapply(ind, 'sum(i2.distance(applyValue, ind) <= 0.1) - 1;'); if (identical(i1.neighborCount(ind), brute) & identical(i1.interactingNeighborCount(ind), brute)) stop(); }", __LINE__);
+		SLiMAssertScriptStop(gen1_setup_grid + "for (focal in ind[0:49]) { d = i2.distance(focal, ind); d[focal.index] = INF; if (!identical(sort(i1.nearestNeighbors(focal, 200).index), which(d <= 0.1))) stop('mismatch'); n1 = i1.nearestNeighbors(focal, 1); if ((min(d) <= 0.1) ? (d[n1.index] != min(d)) else (size(n1) != 0)) stop('mismatch'); } stop(); }", __LINE__);
+		SLiMAssertScriptStop(gen1_setup_grid + "pt = p1.pointUniform(1); d = i2.distanceFromPoint(pt, ind); if ((i1.neighborCountOfPoint(pt, p1) == sum(d <= 0.1)) & identical(sort(i1.nearestNeighborsOfPoint(pt, p1, 200).index), which(d <= 0.1))) stop(); }", __LINE__);
+		SLiMAssertScriptStop(gen1_setup_grid + "if (all(abs(i1.totalOfNeighborStrengths(ind) - i1.neighborCount(ind)) < 1e-4)) stop(); }", __LINE__);
+	}
+	
+	// coordinates the grid cannot handle fall back to a k-d tree; non-periodic positions are not constrained to the bounds
+	SLiMAssertScriptStop("initialize() { initializeSLiMOptions(dimensionality='xy'); initializeMutationRate(1e-5); initializeMutationType('m1', 0.5, 'f', 0.0); initializeGenomicElementType('g1', m1, 1.0); initializeGenomicElement(g1, 0, 99999); initializeRecombinationRate(1e-8); initializeInteractionType('i1', 'xy', maxDistance=0.5); } 1 early() { sim.addSubpop('p1', 4); p1.individuals.setSpatialPosition(c(0.0, 0.0, 0.3, 0.0, INF, 0.0, 0.0, 0.4)); i1.evaluate(p1); if (identical(i1.neighborCount(p1.individuals), c(2, 2, 0, 2))) stop(); }", __LINE__);
+	SLiMAssertScriptStop("initialize() { initializeSLiMOptions(dimensionality='xy'); initializeMutationRate(1e-5); initializeMutationType('m1', 0.5, 'f', 0.0); initializeGenomicElementType('g1', m1, 1.0); initializeGenomicElement(g1, 0, 99999); initializeRecombinationRate(1e-8); initializeInteractionType('i1', 'xy', maxDistance=0.5); } 1 early() { sim.addSubpop('p1', 4); p1.individuals.setSpatialPosition(c(0.0, 0.0, 0.3, 0.0, 1e6, 0.0, 0.0, 0.4)); i1.evaluate(p1); if (identical(i1.neighborCount(p1.individuals), c(2, 2, 0, 2))) stop(); }", __LINE__);
+	
+	// With no maxDistance, queries use a k-d tree; the nearest neighbor must be found even when it lies across a split from the query point
+	for (int i = 0; i < 3; ++i)
+	{
+		std::string spatiality = (i == 0) ? "x" : ((i == 1) ? "xy" : "xyz");
+		std::string gen1_setup_kd = "initialize() { initializeSLiMOptions(dimensionality='" + spatiality + "'); initializeMutationRate(1e-5); initializeMutationType('m1', 0.5, 'f', 0.0); initializeGenomicElementType('g1', m1, 1.0); initializeGenomicElement(g1, 0, 99999); initializeRecombinationRate(1e-8); initializeInteractionType('i1', '" + spatiality + "'); } 1 early() { ";
+		
+		SLiMAssertScriptStop(gen1_setup_kd + "sim.addSubpop('p1', 2); ind = p1.individuals; ind.setSpatialPosition(c(rep(0.2, " + std::to_string(i + 1) + "), rep(0.7, " + std::to_string(i + 1) + "))); i1.evaluate(p1); if (identical(i1.nearestNeighbors(ind, 1, returnDict=T).getValue(0).index, 1) & identical(i1.nearestNeighbors(ind, 1, returnDict=T).getValue(1).index, 0)) stop(); }", __LINE__);
+		SLiMAssertScriptStop(gen1_setup_kd + "sim.addSubpop('p1', 300); ind = p1.individuals; ind.setSpatialPosition(p1.pointUniform(300)); i1.evaluate(p1); for (focal in ind[0:99]) { d = i1.distance(focal, ind); d[focal.index] = INF; n1 = i1.nearestNeighbors(focal, 1); if (d[n1.index] != min(d)) stop('mismatch'); if (!identical(sort(i1.nearestNeighbors(focal, 300).index), which(d < INF))) stop('mismatch'); } if (identical(i1.neighborCount(ind), rep(299, 300))) stop(); }", __LINE__);
+	}
+}
+
 #pragma mark Continuous space tests
 void _RunContinuousSpaceTests(void)
 {
@@ -2118,6 +2161,19 @@ void _RunTreeSeqTests(const std::string &temp_path)
 	SLiMAssertScriptStop("initialize() { initializeTreeSeq(); } " + gen1_setup_p1 + "50 early() { sim.treeSeqSimplify(); } 100 early() { stop(); }", __LINE__);
 	SLiMAssertScriptStop("initialize() { initializeTreeSeq(); } " + gen1_setup_p1 + "1: early() { sim.treeSeqSimplify(); } 100 early() { stop(); }", __LINE__);
 	
+	// repeated simplification merges new edges into the edges left sorted by the previous simplification; overlapping generations and remembered individuals exercise that, with crosschecks
+	SLiMAssertScriptStop(nonWF_prefix + "initialize() { initializeTreeSeq(runCrosschecks=T); } " + gen1_setup + "reproduction() { subpop.addCrossed(individual, subpop.sampleIndividuals(1)); } 1 early() { sim.addSubpop('p1', 20); } early() { p1.fitnessScaling = 20 / p1.individualCount; } 1: late() { sim.treeSeqRememberIndividuals(p1.sampleIndividuals(1), permanent=F); if (community.tick % 3 == 0) sim.treeSeqSimplify(); } 50 late() { stop(); }", __LINE__);
+	if (Eidos_TemporaryDirectoryExists())
+		SLiMAssertScriptStop(nonWF_prefix + "initialize() { initializeTreeSeq(runCrosschecks=T); } " + gen1_setup + "reproduction() { subpop.addCrossed(individual, subpop.sampleIndividuals(1)); } 1 early() { sim.addSubpop('p1', 20); } early() { p1.fitnessScaling = 20 / p1.individualCount; } 1: late() { if (community.tick % 3 == 0) sim.treeSeqSimplify(); } 20 late() { sim.treeSeqOutput('" + temp_path + "/SLiM_treeSeq_3.trees', simplify=F); } 30 late() { if (isNULL(sim.getValue('read'))) { sim.setValue('read', T); sim.readFromPopulationFile('" + temp_path + "/SLiM_treeSeq_3.trees'); } } 50 late() { stop(); }", __LINE__);
+	
+	// spilling edges to disk between simplifications; coalescence checks and crosschecks read the spilled edges back in
+	SLiMAssertScriptRaise("initialize() { initializeTreeSeq(spillDirectory='/slim_no_such_directory'); } " + gen1_setup_p1 + "100 early() { stop(); }", "existing directory", __LINE__);
+	if (Eidos_TemporaryDirectoryExists())
+	{
+		SLiMAssertScriptStop(nonWF_prefix + "initialize() { initializeTreeSeq(checkCoalescence=T, runCrosschecks=T, spillDirectory='" + temp_path + "'); } " + gen1_setup + "reproduction() { subpop.addCrossed(individual, subpop.sampleIndividuals(1)); } 1 early() { sim.addSubpop('p1', 20); } early() { p1.fitnessScaling = 20 / p1.individualCount; } 1: late() { sim.treeSeqRememberIndividuals(p1.sampleIndividuals(1), permanent=F); if (community.tick % 3 == 0) sim.treeSeqSimplify(); sim.treeSeqCoalesced(); } 50 late() { stop(); }", __LINE__);
+		SLiMAssertScriptStop("initialize() { initializeTreeSeq(simplificationRatio=0.0, spillDirectory='" + temp_path + "'); } " + gen1_setup_p1 + "50 late() { sim.treeSeqOutput('" + temp_path + "/SLiM_treeSeq_spill.trees', simplify=F); } 60 late() { sim.treeSeqOutput('" + temp_path + "/SLiM_treeSeq_spill.trees', simplify=T); sim.readFromPopulationFile('" + temp_path + "/SLiM_treeSeq_spill.trees'); } 100 early() { stop(); }", __LINE__);
+	}
+	
 	// treeSeqRememberIndividuals()
 	SLiMAssertScriptStop("initialize() { initializeTreeSeq(); } " + gen1_setup_p1 + "50 early() { sim.treeSeqRememberIndividuals(p1.individuals[integer(0)]); } 100 early() { sim.treeSeqSimplify(); stop(); }", __LINE__);
 	SLiMAssertScriptStop("initialize() { initializeTreeSeq(); } " + gen1_setup_p1 + "50 early() { sim.treeSeqRememberIndividuals(p1.individuals); } 100 early() { sim.treeSeqSimplify(); stop(); }", __LINE__);
@@ -2228,6 +2284,61 @@ initialize() {
 			
 			SLiMAssertScriptSuccess(test_script);
 		}
+		
+		// the same test with multiple chromosomes, including substitutions at the same position on different chromosomes;
+		// simplification and output are done across chromosomes in parallel in multithreaded builds.  The test is then
+		// repeated with edges spilled to disk, which simplifies one chromosome at a time instead
+		std::string multichrom_test_string(R"V0G0N(
+initialize() {
+	defineConstant("SEED", getSeed());
+	defineConstant("PATH", tempdir() + "slim_trees_multichrom_test");
+	initializeTreeSeq(simplificationInterval=10, runCrosschecks=T);
+	initializeSex();
+	initializeMutationType("m1", 0.5, "f", 0.0);
+	initializeGenomicElementType("g1", m1, 1.0);
+	
+	for (id in 1:5)
+	{
+		initializeChromosome(id, 10000, (id == 5) ? "X" else "A", symbol=(id == 5) ? "X" else asString(id));
+		initializeGenomicElement(g1, 0, 9999);
+		initializeMutationRate(2e-5);
+		initializeRecombinationRate(2e-5);
+	}
+}
+1 late() {
+	sim.addSubpop("p1", 20);
+	sim.setValue("iter", 0);
+}
+2: early() {
+	ind = sample(sim.subpopulations.individuals, 1);
+	sim.treeSeqRememberIndividuals(ind);
+}
+100 late() {
+	sim.treeSeqOutput(PATH, overwriteDirectory=T);
+	setSeed(SEED + 1);
+}
+200 late() {
+	s = sum(sim.mutationCounts(NULL) + sim.substitutions.size());
+	if (sim.getValue("iter") == 0)
+	{
+		sim.setValue("s", s);
+		sim.setValue("iter", 1);
+		sim.readFromPopulationFile(PATH);
+		setSeed(SEED + 1);
+	}
+	else
+	{
+		if (s != sim.getValue("s"))
+			stop("s value mismatch for multiple chromosomes (" + s + " versus " + sim.getValue("s") + "), SEED == " + SEED + ".");
+	}
+}
+)V0G0N");
+		
+		SLiMAssertScriptSuccess(multichrom_test_string, __LINE__);
+		
+		std::string spill_test_string = multichrom_test_string;
+		spill_test_string.replace(spill_test_string.find("runCrosschecks=T"), 16, "runCrosschecks=T, spillDirectory=tempdir()");
+		SLiMAssertScriptSuccess(spill_test_string, __LINE__);
 	}
 }
 
@@ -2915,15 +3026,17 @@ initialize() {
 	catn("   TajD(CHR1, muts_ch1) == " + calcTajimasD(sim.subpopulations.haplosomesForChromosomes(1), muts_ch1));
 }
 
-	Note that this section only tests for correct bounds-checking and errors and such; we do not
-	check for numerical correctness.  Doing that is tricky and not yet implemented.  FIXME
+	Note that this section mostly tests for correct bounds-checking and errors and such; we do not
+	check for numerical correctness in general.  Doing that is tricky and not yet implemented.  FIXME
+	The functions that are implemented natively are, however, checked against the Eidos code that
+	they replaced, below.
  */
 	
 	std::string base_script = "initialize() { initializeMutationType('m1', 0.5, 'n', 0.0, 0.001); initializeGenomicElementType('g1', m1, 1.0); chr = initializeChromosome(1, 5e5); initializeMutationRate(1e-7); initializeGenomicElement(g1, 0, 5e5-1); initializeRecombinationRate(1e-8); defineConstant('CHR1', chr); chr = initializeChromosome(2, 1e6); initializeMutationRate(1e-7); initializeGenomicElement(g1, 0, 1e6-1); initializeRecombinationRate(1e-8); defineConstant('CHR2', chr); } 1 late() { sim.addSubpop('p1', 50); sim.addSubpop('p2', 50); p1.setMigrationRates(p2, 0.01); p2.setMigrationRates(p1, 0.01); } 1:100 late() { h0 = p1.haplosomes[integer(0)]; h_p1_ch1 = p1.haplosomesForChromosomes(1)[0]; h_p2_ch1 = p2.haplosomesForChromosomes(1)[0]; h_p1_ch2 = p1.haplosomesForChromosomes(2)[0]; h_p2_ch2 = p2.haplosomesForChromosomes(2)[0]; muts_ch1 = sim.subsetMutations(chromosome=1); muts_ch2 = sim.subsetMutations(chromosome=2); ";
 	
-	SLiMAssertScriptRaise(base_script + "calcDxy(h0, h0); }", "must both be non-empty", __LINE__, true, /* p_error_is_in_stop */ true);
-	SLiMAssertScriptRaise(base_script + "calcDxy(p1.haplosomes, p2.haplosomes); }", "same chromosome", __LINE__, true, /* p_error_is_in_stop */ true);
-	SLiMAssertScriptRaise(base_script + "calcDxy(p1.haplosomesForChromosomes(1), p2.haplosomesForChromosomes(1), muts_ch2); }", "same chromosome", __LINE__, true, /* p_error_is_in_stop */ true);
+	SLiMAssertScriptRaise(base_script + "calcDxy(h0, h0); }", "must both be non-empty", __LINE__);
+	SLiMAssertScriptRaise(base_script + "calcDxy(p1.haplosomes, p2.haplosomes); }", "same chromosome", __LINE__);
+	SLiMAssertScriptRaise(base_script + "calcDxy(p1.haplosomesForChromosomes(1), p2.haplosomesForChromosomes(1), muts_ch2); }", "same chromosome", __LINE__);
 	SLiMAssertScriptSuccess(base_script + "calcDxy(p1.haplosomesForChromosomes(1)[0], p2.haplosomesForChromosomes(1)[0]); }", __LINE__);
 	SLiMAssertScriptSuccess(base_script + "calcDxy(p1.haplosomesForChromosomes(1), p2.haplosomesForChromosomes(1)); }", __LINE__);
 	SLiMAssertScriptSuccess(base_script + "calcDxy(p1.haplosomesForChromosomes(2), p2.haplosomesForChromosomes(2)); }", __LINE__);
@@ -2932,10 +3045,10 @@ initialize() {
 	SLiMAssertScriptSuccess(base_script + "calcDxy(p1.haplosomesForChromosomes(2), p2.haplosomesForChromosomes(2), NULL, 1e5, 2e5); }", __LINE__);
 	SLiMAssertScriptSuccess(base_script + "calcDxy(p1.haplosomesForChromosomes(1), p2.haplosomesForChromosomes(1), muts_ch1, 1e5, 2e5); }", __LINE__);
 	
-	SLiMAssertScriptRaise(base_script + "calcFST(h0, h0); }", "must both be non-empty", __LINE__, true, /* p_error_is_in_stop */ true);
+	SLiMAssertScriptRaise(base_script + "calcFST(h0, h0); }", "must both be non-empty", __LINE__);
 	SLiMAssertScriptSuccess(base_script + "calcFST(p1.haplosomes, p2.haplosomes); }", __LINE__);
-	SLiMAssertScriptRaise(base_script + "calcFST(p1.haplosomesForChromosomes(1), p2.haplosomesForChromosomes(2)); }", "same set of chromosomes", __LINE__, true, /* p_error_is_in_stop */ true);
-	SLiMAssertScriptRaise(base_script + "calcFST(p1.haplosomesForChromosomes(1), p2.haplosomesForChromosomes(1), muts_ch2); }", "same chromosome", __LINE__, true, /* p_error_is_in_stop */ true);
+	SLiMAssertScriptRaise(base_script + "calcFST(p1.haplosomesForChromosomes(1), p2.haplosomesForChromosomes(2)); }", "same set of chromosomes", __LINE__);
+	SLiMAssertScriptRaise(base_script + "calcFST(p1.haplosomesForChromosomes(1), p2.haplosomesForChromosomes(1), muts_ch2); }", "same chromosome", __LINE__);
 	SLiMAssertScriptSuccess(base_script + "calcFST(p1.haplosomesForChromosomes(1)[0], p2.haplosomesForChromosomes(1)[0]); }", __LINE__);
 	SLiMAssertScriptSuccess(base_script + "calcFST(p1.haplosomesForChromosomes(1), p2.haplosomesForChromosomes(1)); }", __LINE__);
 	SLiMAssertScriptSuccess(base_script + "calcFST(p1.haplosomesForChromosomes(2), p2.haplosomesForChromosomes(2)); }", __LINE__);
@@ -2973,10 +3086,10 @@ initialize() {
 	SLiMAssertScriptSuccess(base_script + "calcPairHeterozygosity(h_p1_ch1, h_p2_ch1, 1e5, 2e5, infiniteSites=F); }", __LINE__);
 	SLiMAssertScriptSuccess(base_script + "calcPairHeterozygosity(h_p1_ch2, h_p2_ch2, 1e5, 2e5, infiniteSites=F); }", __LINE__);
 	
-	SLiMAssertScriptRaise(base_script + "calcWattersonsTheta(h0); }", "haplosomes must be non-empty", __LINE__, true, /* p_error_is_in_stop */ true);
+	SLiMAssertScriptRaise(base_script + "calcWattersonsTheta(h0); }", "haplosomes must be non-empty", __LINE__);
 	SLiMAssertScriptSuccess(base_script + "calcWattersonsTheta(sim.subpopulations.haplosomesForChromosomes(1)[0]); }", __LINE__);
-	SLiMAssertScriptRaise(base_script + "calcWattersonsTheta(p1.haplosomes); }", "same chromosome", __LINE__, true, /* p_error_is_in_stop */ true);
-	SLiMAssertScriptRaise(base_script + "calcWattersonsTheta(sim.subpopulations.haplosomesForChromosomes(1), muts_ch2); }", "same chromosome", __LINE__, true, /* p_error_is_in_stop */ true);
+	SLiMAssertScriptRaise(base_script + "calcWattersonsTheta(p1.haplosomes); }", "same chromosome", __LINE__);
+	SLiMAssertScriptRaise(base_script + "calcWattersonsTheta(sim.subpopulations.haplosomesForChromosomes(1), muts_ch2); }", "same chromosome", __LINE__);
 	SLiMAssertScriptSuccess(base_script + "calcWattersonsTheta(sim.subpopulations.haplosomesForChromosomes(1)); }", __LINE__);
 	SLiMAssertScriptSuccess(base_script + "calcWattersonsTheta(sim.subpopulations.haplosomesForChromosomes(2)); }", __LINE__);
 	SLiMAssertScriptSuccess(base_script + "calcWattersonsTheta(sim.subpopulations.haplosomesForChromosomes(1), muts_ch1); }", __LINE__);
@@ -2993,11 +3106,11 @@ initialize() {
 	SLiMAssertScriptSuccess(base_script + "calcInbreedingLoad(sim.subpopulations.haplosomesForChromosomes(1), m1); }", __LINE__);
 	SLiMAssertScriptSuccess(base_script + "calcInbreedingLoad(sim.subpopulations.haplosomesForChromosomes(2)); }", __LINE__);
 	
-	SLiMAssertScriptRaise(base_script + "calcPi(h0); }", "haplosomes must contain at least two elements", __LINE__, true, /* p_error_is_in_stop */ true);
-	SLiMAssertScriptRaise(base_script + "calcPi(sim.subpopulations.haplosomesForChromosomes(1)[0]); }", "haplosomes must contain at least two elements", __LINE__, true, /* p_error_is_in_stop */ true);
+	SLiMAssertScriptRaise(base_script + "calcPi(h0); }", "haplosomes must contain at least two elements", __LINE__);
+	SLiMAssertScriptRaise(base_script + "calcPi(sim.subpopulations.haplosomesForChromosomes(1)[0]); }", "haplosomes must contain at least two elements", __LINE__);
 	SLiMAssertScriptSuccess(base_script + "calcPi(sim.subpopulations.haplosomesForChromosomes(1)[0:1]); }", __LINE__);
-	SLiMAssertScriptRaise(base_script + "calcPi(p1.haplosomes); }", "same chromosome", __LINE__, true, /* p_error_is_in_stop */ true);
-	SLiMAssertScriptRaise(base_script + "calcPi(sim.subpopulations.haplosomesForChromosomes(1), muts_ch2); }", "same chromosome", __LINE__, true, /* p_error_is_in_stop */ true);
+	SLiMAssertScriptRaise(base_script + "calcPi(p1.haplosomes); }", "same chromosome", __LINE__);
+	SLiMAssertScriptRaise(base_script + "calcPi(sim.subpopulations.haplosomesForChromosomes(1), muts_ch2); }", "same chromosome", __LINE__);
 	SLiMAssertScriptSuccess(base_script + "calcPi(sim.subpopulations.haplosomesForChromosomes(1)); }", __LINE__);
 	SLiMAssertScriptSuccess(base_script + "calcPi(sim.subpopulations.haplosomesForChromosomes(2)); }", __LINE__);
 	SLiMAssertScriptSuccess(base_script + "calcPi(sim.subpopulations.haplosomesForChromosomes(1), muts_ch1); }", __LINE__);
@@ -3005,13 +3118,13 @@ initialize() {
 	SLiMAssertScriptSuccess(base_script + "calcPi(sim.subpopulations.haplosomesForChromosomes(2), NULL, 1e5, 2e5); }", __LINE__);
 	SLiMAssertScriptSuccess(base_script + "calcPi(sim.subpopulations.haplosomesForChromosomes(1), muts_ch1, 1e5, 2e5); }", __LINE__);
 	
-	SLiMAssertScriptRaise(base_script + "calcTajimasD(h0); }", "haplosomes must contain at least four elements", __LINE__, true, /* p_error_is_in_stop */ true);
-	SLiMAssertScriptRaise(base_script + "calcTajimasD(sim.subpopulations.haplosomesForChromosomes(1)[0]); }", "haplosomes must contain at least four elements", __LINE__, true, /* p_error_is_in_stop */ true);
-	SLiMAssertScriptRaise(base_script + "calcTajimasD(sim.subpopulations.haplosomesForChromosomes(1)[0:1]); }", "haplosomes must contain at least four elements", __LINE__, true, /* p_error_is_in_stop */ true);
-	SLiMAssertScriptRaise(base_script + "calcTajimasD(sim.subpopulations.haplosomesForChromosomes(1)[0:2]); }", "haplosomes must contain at least four elements", __LINE__, true, /* p_error_is_in_stop */ true);
+	SLiMAssertScriptRaise(base_script + "calcTajimasD(h0); }", "haplosomes must contain at least four elements", __LINE__);
+	SLiMAssertScriptRaise(base_script + "calcTajimasD(sim.subpopulations.haplosomesForChromosomes(1)[0]); }", "haplosomes must contain at least four elements", __LINE__);
+	SLiMAssertScriptRaise(base_script + "calcTajimasD(sim.subpopulations.haplosomesForChromosomes(1)[0:1]); }", "haplosomes must contain at least four elements", __LINE__);
+	SLiMAssertScriptRaise(base_script + "calcTajimasD(sim.subpopulations.haplosomesForChromosomes(1)[0:2]); }", "haplosomes must contain at least four elements", __LINE__);
 	SLiMAssertScriptSuccess(base_script + "calcTajimasD(sim.subpopulations.haplosomesForChromosomes(1)[0:3]); }", __LINE__);
-	SLiMAssertScriptRaise(base_script + "calcTajimasD(p1.haplosomes); }", "same chromosome", __LINE__, true, /* p_error_is_in_stop */ true);
-	SLiMAssertScriptRaise(base_script + "calcTajimasD(sim.subpopulations.haplosomesForChromosomes(1), muts_ch2); }", "same chromosome", __LINE__, true, /* p_error_is_in_stop */ true);
+	SLiMAssertScriptRaise(base_script + "calcTajimasD(p1.haplosomes); }", "same chromosome", __LINE__);
+	SLiMAssertScriptRaise(base_script + "calcTajimasD(sim.subpopulations.haplosomesForChromosomes(1), muts_ch2); }", "same chromosome", __LINE__);
 	SLiMAssertScriptSuccess(base_script + "calcTajimasD(sim.subpopulations.haplosomesForChromosomes(1)); }", __LINE__);
 	SLiMAssertScriptSuccess(base_script + "calcTajimasD(sim.subpopulations.haplosomesForChromosomes(2)); }", __LINE__);
 	SLiMAssertScriptSuccess(base_script + "calcTajimasD(sim.subpopulations.haplosomesForChromosomes(1), muts_ch1); }", __LINE__);
@@ -3019,6 +3132,39 @@ initialize() {
 	SLiMAssertScriptSuccess(base_script + "calcTajimasD(sim.subpopulations.haplosomesForChromosomes(2), NULL, 1e5, 2e5); }", __LINE__);
 	SLiMAssertScriptSuccess(base_script + "calcTajimasD(sim.subpopulations.haplosomesForChromosomes(1), muts_ch1, 1e5, 2e5); }", __LINE__);
 	
+	// numerical checks of the natively implemented functions against the Eidos code they replaced, which should match exactly
+	std::string pi_script = "h = sim.subpopulations.haplosomesForChromosomes(1); m = muts_ch1; L = CHR1.length; p = h.mutationFrequenciesInHaplosomes(m); m = m[(p != 0.0) & (p != 1.0)]; c = h.mutationCountsInHaplosomes(m); n = size(h); k = size(m); pi = sum(c * (n - c)) / ((n * (n - 1)) / 2) / L; a_1 = sum(1 / 1:(n - 1)); a_2 = sum(1 / (1:(n - 1)) ^ 2); th = (k / a_1) / L; ";
+	std::string pi_window_script = "h = sim.subpopulations.haplosomesForChromosomes(2); m = muts_ch2[(muts_ch2.position >= 1e5) & (muts_ch2.position <= 2e5)]; L = 1e5 + 1; p = h.mutationFrequenciesInHaplosomes(m); m = m[(p != 0.0) & (p != 1.0)]; c = h.mutationCountsInHaplosomes(m); n = size(h); k = size(m); pi = sum(c * (n - c)) / ((n * (n - 1)) / 2) / L; a_1 = sum(1 / 1:(n - 1)); a_2 = sum(1 / (1:(n - 1)) ^ 2); th = (k / a_1) / L; ";
+	std::string tajd_script = "b_1 = (n + 1) / (3 * (n - 1)); b_2 = 2 * (n ^ 2 + n + 3) / (9 * n * (n - 1)); c_1 = b_1 - 1 / a_1; c_2 = b_2 - (n + 2) / (a_1 * n) + a_2 / a_1 ^ 2; e_1 = c_1 / a_1; e_2 = c_2 / (a_1 ^ 2 + a_2); d = ((pi - th) * L) / sqrt(e_1 * k + e_2 * k * (k - 1)); ";
+	std::string two_sample_script = "h1 = p1.haplosomesForChromosomes(1); h2 = p2.haplosomesForChromosomes(1); n1 = size(h1); n2 = size(h2); m = muts_ch1; p1_p = h1.mutationFrequenciesInHaplosomes(m); p2_p = h2.mutationFrequenciesInHaplosomes(m); mean_p = (p1_p + p2_p) / 2.0; H_t = 2.0 * mean_p * (1.0 - mean_p); H_s = p1_p * (1.0 - p1_p) + p2_p * (1.0 - p2_p); fst = NAN; if (size(m) > 0) if (mean(H_t) != 0) fst = 1.0 - mean(H_s) / mean(H_t); p = c(h1, h2).mutationFrequenciesInHaplosomes(m); m = m[(p != 0.0) & (p != 1.0)]; dos1 = h1.mutationCountsInHaplosomes(m); dos2 = h2.mutationCountsInHaplosomes(m); dos1 = c(dos1, n1 - dos1); dos2 = c(dos2, n2 - dos2); dxy = (size(m) == 0) ? 0.0 else sum(dos1 * (n2 - dos2) + (n1 - dos1) * dos2) / 2.0 / n1 / n2; ";
+	
+	SLiMAssertScriptSuccess(base_script + pi_script + "if (!identical(calcPi(h), pi)) stop(); }", __LINE__);
+	SLiMAssertScriptSuccess(base_script + pi_window_script + "if (!identical(calcPi(h, NULL, 1e5, 2e5), pi)) stop(); }", __LINE__);
+	SLiMAssertScriptSuccess(base_script + pi_script + "if (!identical(calcWattersonsTheta(h), th)) stop(); }", __LINE__);
+	SLiMAssertScriptSuccess(base_script + pi_window_script + "if (!identical(calcWattersonsTheta(h, NULL, 1e5, 2e5), th)) stop(); }", __LINE__);
+	SLiMAssertScriptSuccess(base_script + pi_script + tajd_script + "if (!identical(calcTajimasD(h), d)) stop(); }", __LINE__);
+	SLiMAssertScriptSuccess(base_script + pi_window_script + tajd_script + "if (!identical(calcTajimasD(h, NULL, 1e5, 2e5), d)) stop(); }", __LINE__);
+	SLiMAssertScriptSuccess(base_script + two_sample_script + "if (!identical(calcFST(h1, h2), fst)) stop(); }", __LINE__);
+	SLiMAssertScriptSuccess(base_script + two_sample_script + "if (!identical(calcDxy(h1, h2), dxy)) stop(); if (!identical(calcDxy(h1, h2, normalize=T), dxy / CHR1.length)) stop(); }", __LINE__);
+	
+	// (float)calcLD_D(object<Mutation> mut1, [No<Mutation> mut2 = NULL], [No<Haplosome> haplosomes = NULL], [Ni$ maxDistance = NULL])
+	// (float)calcLD_Rsquared(object<Mutation> mut1, [No<Mutation> mut2 = NULL], [No<Haplosome> haplosomes = NULL], [logical$ squared = T], [Ni$ maxDistance = NULL])
+	SLiMAssertScriptRaise(base_script + "calcLD_D(sim.mutations[integer(0)]); }", "mut1 must be non-empty", __LINE__);
+	SLiMAssertScriptRaise(base_script + "if (size(muts_ch1) & size(muts_ch2)) calcLD_D(c(muts_ch1[0], muts_ch2[0])); }", "same chromosome", __LINE__);
+	SLiMAssertScriptRaise(base_script + "if (size(muts_ch1) & size(muts_ch2)) calcLD_D(muts_ch1[0], muts_ch2); }", "same chromosome", __LINE__);
+	SLiMAssertScriptRaise(base_script + "if (size(muts_ch1)) calcLD_Rsquared(muts_ch1[0], NULL, p1.haplosomesForChromosomes(2)); }", "same chromosome", __LINE__);
+	SLiMAssertScriptRaise(base_script + "if (size(muts_ch1)) calcLD_Rsquared(muts_ch1[0], NULL, h0); }", "haplosomes must be non-empty", __LINE__);
+	SLiMAssertScriptRaise(base_script + "if (size(muts_ch1)) calcLD_Rsquared(muts_ch1[0], maxDistance=-1); }", "maxDistance must be greater than or equal to zero", __LINE__);
+	SLiMAssertScriptSuccess(base_script + "if (size(muts_ch1)) { calcLD_D(muts_ch1[0]); calcLD_D(muts_ch1[0], muts_ch1); calcLD_D(muts_ch1, NULL, p1.haplosomesForChromosomes(1)); calcLD_Rsquared(muts_ch1[0], squared=F); calcLD_Rsquared(muts_ch1, maxDistance=0); } }", __LINE__);
+	
+	// numerical checks of calcLD_D() and calcLD_Rsquared() against the Eidos code they replaced; D matches exactly, r^2 within rounding
+	std::string ld_script = "h = sim.subpopulations.haplosomesForChromosomes(1); m = muts_ch1; for (mut in m[seqLen(min(5, size(m)))]) { h1 = h[h.containsMutations(mut)]; if (size(h1) == 0) { d = rep(0.0, size(m)); r2 = rep(NAN, size(m)); } else { p_12 = h1.mutationCountsInHaplosomes(m) / size(h); p_1 = size(h1) / size(h); p_2 = h.mutationFrequenciesInHaplosomes(m); d = p_12 - p_1 * p_2; r2 = (p_12 - p_1 * p_2)^2 / (p_1 * p_2 * (1.0 - p_1) * (1.0 - p_2)); } ";
+	
+	SLiMAssertScriptSuccess(base_script + ld_script + "if (!identical(calcLD_D(mut, m, h), d)) stop(); if (!identical(calcLD_D(mut), d)) stop(); } }", __LINE__);
+	SLiMAssertScriptSuccess(base_script + ld_script + "x = calcLD_Rsquared(mut, m, h); if (!all(isNAN(x) == isNAN(r2))) stop(); if (any(abs(x - r2)[!isNAN(r2)] > 1e-12)) stop(); } }", __LINE__);
+	SLiMAssertScriptSuccess(base_script + "m = muts_ch1; if (size(m) >= 2) { mat = calcLD_D(m); if (!identical(dim(mat), c(size(m), size(m)))) stop(); for (i in seqLen(size(m))) if (!identical(drop(mat[i,]), calcLD_D(m[i]))) stop(); } }", __LINE__);
+	SLiMAssertScriptSuccess(base_script + "m = muts_ch1; if (size(m) >= 2) { pos = matrix(rep(m.position, size(m)), nrow=size(m)); dist = abs(pos - t(pos)); full = calcLD_Rsquared(m); band = calcLD_Rsquared(m, maxDistance=1e4); if (!identical(band[dist <= 1e4], full[dist <= 1e4])) stop(); if (!all(isNAN(band[dist > 1e4]))) stop(); } }", __LINE__);
+	
 	// (numeric)calcSFS([Ni$ binCount = NULL], [No<Haplosome> haplosomes = NULL], [No<Mutation> muts = NULL], [string$ metric = "density"], [logical$ fold = F])
 	SLiMAssertScriptRaise(base_script + "calcSFS(); }", "when binCount is NULL", __LINE__, true, /* p_error_is_in_stop */ true);
 	SLiMAssertScriptSuccess(base_script + "calcSFS(10); }", __LINE__);
@@ -29,6 +29,31 @@ initialize() {
 
 // ***********************************************************************************************
 
+// calcPi(), calcWattersonsTheta(), calcTajimasD(), calcFST(), calcDxy()	// EIDOS_OMPMIN_POPGEN_STATS
+
+initialize() {
+	initializeMutationRate(1e-6);
+	initializeMutationType("m1", 0.5, "f", 0.0);
+	initializeGenomicElementType("g1", m1, 1.0);
+	initializeGenomicElement(g1, 0, 99999);
+	initializeRecombinationRate(1e-8);
+}
+1 early() { sim.addSubpop("p1", 1000); sim.addSubpop("p2", 1000); p1.setMigrationRates(p2, 0.01); p2.setMigrationRates(p1, 0.01); }
+200 late() {
+	h1 = p1.haplosomes;
+	h2 = p2.haplosomes;
+	
+	a = c(calcPi(h1), calcWattersonsTheta(h1), calcTajimasD(h1), calcFST(h1, h2), calcDxy(h1, h2));
+	parallelSetNumThreads(1);
+	b = c(calcPi(h1), calcWattersonsTheta(h1), calcTajimasD(h1), calcFST(h1, h2), calcDxy(h1, h2));
+	
+	// float sums may be reduced in a different order with different thread counts, so allow a tolerance
+	if (any(abs(a - b) > abs(b) * 1e-12))
+		stop("parallel calcPi(), calcWattersonsTheta(), calcTajimasD(), calcFST(), calcDxy() failed test");
+}
+
+// ***********************************************************************************************
+
 // InteractionType -clippedIntegral() (1D x)				// EIDOS_OMPMIN_CLIPPEDINTEGRAL_1S
 
 initialize() {
@@ -257,6 +282,30 @@ initialize() {
 
 // ***********************************************************************************************
 
+// InteractionType k-d tree construction					// EIDOS_OMPMIN_KDTREE_BUILD
+
+initialize() {
+	initializeSLiMOptions(dimensionality="xyz");
+	initializeInteractionType(1, "xyz");		// no maxDistance, so a k-d tree is used
+}
+1 late() {
+	sim.addSubpop("p1", 100000);
+	p1.setSpatialBounds(c(10, 10, 10, 100, 100, 100));
+	inds = p1.individuals;
+	inds.setSpatialPosition(p1.pointUniform(p1.individualCount));
+	i1.evaluate(p1);
+	a = i1.nearestNeighbors(inds, returnDict=T);
+	
+	parallelSetNumThreads(1);
+	i1.evaluate(p1);
+	b = i1.nearestNeighbors(inds, returnDict=T);
+	
+	if (!a.identicalContents(b))
+		stop("parallel InteractionType k-d tree construction failed test");
+}
+
+// ***********************************************************************************************
+
 // InteractionType -localPopulationDensity()				// EIDOS_OMPMIN_LOCALPOPDENSITY
 
 initialize() {
@@ -1050,4 +1099,42 @@ initialize() {
 		stop("parallel InteractionType -totalOfNeighborStrengths() failed test");
 }
 
+// ***********************************************************************************************
+
+// Species -treeSeqSimplify(), -treeSeqOutput(), multiple chromosomes	// EIDOS_OMPMIN_SIMPLIFY_CHROMOSOMES, EIDOS_OMPMIN_TREESEQ_OUTPUT
+
+initialize() {
+	defineConstant("PATH", tempdir() + "slim_parallel_treeseq_test");
+	initializeTreeSeq(simplificationInterval=10);
+	initializeMutationType("m1", 0.5, "f", 0.0);
+	initializeGenomicElementType("g1", m1, 1.0);
+	
+	for (id in 1:8)
+	{
+		initializeChromosome(id, 100000, symbol=asString(id));
+		initializeGenomicElement(g1, 0, 99999);
+		initializeMutationRate(1e-7);
+		initializeRecombinationRate(1e-8);
+	}
+}
+1 early() {
+	sim.addSubpop("p1", 500);
+}
+2: early() {
+	sim.treeSeqRememberIndividuals(p1.sampleIndividuals(1));
+}
+100 late() {
+	sim.treeSeqOutput(PATH + "_a", overwriteDirectory=T);
+	parallelSetNumThreads(1);
+	sim.treeSeqOutput(PATH + "_b", overwriteDirectory=T);
+	
+	sim.readFromPopulationFile(PATH + "_a");
+	a = p1.haplosomes.mutations.id;
+	sim.readFromPopulationFile(PATH + "_b");
+	b = p1.haplosomes.mutations.id;
+	
+	if (!identical(a, b))
+		stop("parallel Species -treeSeqSimplify(), -treeSeqOutput() failed test");
+}
+
 )V0G0N"
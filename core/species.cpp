@@ -45,6 +45,10 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <unistd.h>
+#include <fcntl.h>
+#ifndef _WIN32
+#include <sys/mman.h>
+#endif
 #include <unordered_set>
 #include <unordered_map>
 #include <float.h>
@@ -707,6 +711,9 @@ void Species::_CleanAllReferencesToSpecies(EidosInterpreter *p_interpreter)
 
 slim_tick_t Species::InitializePopulationFromFile(const std::string &p_file_string, EidosInterpreter *p_interpreter, SUBPOP_REMAP_HASH &p_subpop_remap)
 {
+	// the file might be pending an asynchronous write, which needs to complete first
+	Eidos_WaitForAsyncFileWrites();
+	
 	SLiMFileFormat file_format = FormatOfPopulationFile(p_file_string);
 	
 	if (file_format == SLiMFileFormat::kFileNotFound)
@@ -776,9 +783,12 @@ slim_tick_t Species::InitializePopulationFromFile(const std::string &p_file_stri
 			// reset our tree-seq auto-simplification interval so we don't simplify immediately
 			simplify_elapsed_ = 0;
 			
-			// reset our last coalescence state; we don't know whether we're coalesced now or not
+			// reset our last coalescence state, since we don't know whether we're coalesced now or not, and our sorted edge count
 			for (TreeSeqInfo &tsinfo : treeseq_)
+			{
 				tsinfo.last_coalescence_state_ = false;
+				tsinfo.simplified_edge_count_ = 0;
+			}
 		}
 	}
 	else if (file_format == SLiMFileFormat::kFormatTskitBinary_kastore)
@@ -1440,6 +1450,78 @@ slim_tick_t Species::_InitializePopulationFromTextFile(const char *p_file, Eidos
 }
 
 #ifndef __clang_analyzer__
+// A read-only view of the contents of a file, for _InitializePopulationFromBinaryFile().  The file is mapped into
+// memory with mmap() where that is available, and read into a buffer otherwise; either way, the memory is released
+// when the object goes out of scope, including when an error is raised during reading.  data() is nullptr on failure.
+class SLiMMappedFile
+{
+private:
+	char *data_ = nullptr;
+	size_t size_ = 0;
+	bool mapped_ = false;
+	std::unique_ptr<char[]> buffer_;
+	
+public:
+	SLiMMappedFile(const SLiMMappedFile&) = delete;
+	SLiMMappedFile& operator=(const SLiMMappedFile&) = delete;
+	SLiMMappedFile(void) = delete;
+	
+	explicit SLiMMappedFile(const char *p_file)
+	{
+#ifndef _WIN32
+		int fd = open(p_file, O_RDONLY);
+		
+		if (fd >= 0)
+		{
+			struct stat file_info;
+			
+			if ((fstat(fd, &file_info) == 0) && (file_info.st_size > 0))
+			{
+				void *mapping = mmap(nullptr, (size_t)file_info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+				
+				if (mapping != MAP_FAILED)
+				{
+					madvise(mapping, (size_t)file_info.st_size, MADV_SEQUENTIAL);
+					data_ = (char *)mapping;
+					size_ = (size_t)file_info.st_size;
+					mapped_ = true;
+				}
+			}
+			
+			close(fd);
+			
+			if (mapped_)
+				return;
+		}
+#endif
+		
+		std::ifstream infile(p_file, std::ios::in | std::ios::binary);
+		
+		if (!infile.is_open() || infile.eof())
+			return;
+		
+		infile.seekg(0, std::ios_base::end);
+		size_ = infile.tellg();
+		buffer_.reset(new char[size_]);
+		
+		infile.seekg(0, std::ios_base::beg);
+		infile.read(buffer_.get(), size_);
+		data_ = buffer_.get();
+	}
+	
+	~SLiMMappedFile(void)
+	{
+#ifndef _WIN32
+		if (mapped_)
+			munmap(data_, size_);
+#endif
+	}
+	
+	// the mapping is read-only; callers must not write through this pointer
+	inline char *data(void) const { return data_; }
+	inline size_t size(void) const { return size_; }
+};
+
 slim_tick_t Species::_InitializePopulationFromBinaryFile(const char *p_file, EidosInterpreter *p_interpreter)
 {
 	THREAD_SAFETY_IN_ACTIVE_PARALLEL("Species::_InitializePopulationFromBinaryFile(): SLiM global state read");
@@ -1456,34 +1538,22 @@ slim_tick_t Species::_InitializePopulationFromBinaryFile(const char *p_file, Eid
 	bool has_object_tags = false;
 	bool has_substitutions = false;
 	
-	// Read file into buf
-	std::ifstream infile(p_file, std::ios::in | std::ios::binary);
+	// Map the file into memory; the OS pages it in as we read, and we avoid a copy of the whole file.  Where mmap()
+	// is unavailable, we read in the entire file instead; we assume we have enough memory, for now.
+	SLiMMappedFile mapped_file(p_file);
 	
-	if (!infile.is_open() || infile.eof())
+	if (!mapped_file.data())
 		EIDOS_TERMINATION << "ERROR (Species::_InitializePopulationFromBinaryFile): could not open initialization file." << EidosTerminate();
 	
-	// Determine the file length
-	infile.seekg(0, std::ios_base::end);
-	file_size = infile.tellg();
-	
-	// Read in the entire file; we assume we have enough memory, for now
-	std::unique_ptr<char[]> raii_buf(new char[file_size]);
-	char *buf = raii_buf.get();
-	
-	if (!buf)
-		EIDOS_TERMINATION << "ERROR (Species::_InitializePopulationFromBinaryFile): could not allocate input buffer." << EidosTerminate();
-	
-	char *buf_end = buf + file_size;
-	char *p = buf;
-	
-	infile.seekg(0, std::ios_base::beg);
-	infile.read(buf, file_size);
-	
-	// Close the file; we will work only with our buffer from here on
+	// We work only with the mapped buffer from here on
 	// Note that we use memcpy() to read values from the buffer, since it takes care of alignment issues
 	// for us that otherwise bother the UndefinedBehaviorSanitizer.  On platforms that don't care about
 	// alignment this should compile down to the same code; on platforms that do care, it avoids a crash.
-	infile.close();
+	file_size = mapped_file.size();
+	
+	char *buf = mapped_file.data();
+	char *buf_end = buf + file_size;
+	char *p = buf;
 	
 	int32_t section_end_tag;
 	int32_t file_version;
@@ -1510,8 +1580,8 @@ slim_tick_t Species::_InitializePopulationFromBinaryFile(const char *p_file, Eid
 			EIDOS_TERMINATION << "ERROR (Species::_InitializePopulationFromBinaryFile): file version is missing or corrupted; reading of population files older than version 8 (SLiM 5.0) is no longer supported." << EidosTerminate();
 		if (file_version < 8)
 			EIDOS_TERMINATION << "ERROR (Species::_InitializePopulationFromBinaryFile): file version " << file_version << " detected; reading of population files older than version 8 (SLiM 5.0) is no longer supported." << EidosTerminate();
-		if (file_version != 8)
-			EIDOS_TERMINATION << "ERROR (Species::_InitializePopulationFromBinaryFile): unrecognized version (" << file_version << "); the last version recognized by this version of SLiM is 8 (this file may have been generated by a more recent version of SLiM)." << EidosTerminate();
+		if (file_version > 9)
+			EIDOS_TERMINATION << "ERROR (Species::_InitializePopulationFromBinaryFile): unrecognized version (" << file_version << "); the last version recognized by this version of SLiM is 9 (this file may have been generated by a more recent version of SLiM)." << EidosTerminate();
 	}
 	
 	// Header section
@@ -1906,297 +1976,305 @@ slim_tick_t Species::_InitializePopulationFromBinaryFile(const char *p_file, Eid
 			p += sizeof(chromosome->tag_value_);
 		}
 		
-		// Read in the size of the mutation map, so we can allocate a vector rather than utilizing std::map
-		if (p + sizeof(mutation_map_size) > buf_end)
-			EIDOS_TERMINATION << "ERROR (Species::_InitializePopulationFromBinaryFile): unexpected EOF at mutation map size." << EidosTerminate();
-		else
+		// Version 9 stores the genetic data in columnar form; version 8 stores it row by row
+		if (file_version >= 9)
 		{
-			memcpy(&mutation_map_size, p, sizeof(mutation_map_size));
-			p += sizeof(mutation_map_size);
+			_InitializeChromosomeFromColumnarData(&p, buf_end, *chromosome, has_nucleotides, has_object_tags);
 		}
-		
-		// Mutations section
-		std::unique_ptr<MutationIndex[]> raii_mutations(new MutationIndex[mutation_map_size]);
-		MutationIndex *mutations = raii_mutations.get();
-		
-		if (!mutations)
-			EIDOS_TERMINATION << "ERROR (Species::_InitializePopulationFromBinaryFile): could not allocate mutations buffer." << EidosTerminate();
-		
-		while (true)
+		else
 		{
-			int32_t mutation_start_tag;
-			slim_polymorphismid_t polymorphism_id;
-			slim_mutationid_t mutation_id;
-			slim_objectid_t mutation_type_id;
-			slim_position_t position;
-			slim_selcoeff_t selection_coeff;
-			slim_selcoeff_t dominance_coeff;
-			slim_objectid_t subpop_index;
-			slim_tick_t tick;
-			slim_refcount_t prevalence;
-			int8_t nucleotide = -1;
-			
-			// If there isn't enough buffer left to read a full mutation record, we assume we are done with this section
-			int record_size = sizeof(mutation_start_tag) + sizeof(polymorphism_id) + sizeof(mutation_id) + sizeof(mutation_type_id) + sizeof(position) + sizeof(selection_coeff) + sizeof(dominance_coeff) + sizeof(subpop_index) + sizeof(tick) + sizeof(prevalence);
-			
-			if (has_nucleotides)
-				record_size += sizeof(nucleotide);
-			if (has_object_tags)
-				record_size += sizeof(slim_usertag_t);
-			
-			if (p + record_size > buf_end)
-				break;
-			
-			// If the first int32_t is not a mutation start tag, then we are done with this section
-			memcpy(&mutation_start_tag, p, sizeof(mutation_start_tag));
-			if (mutation_start_tag != (int32_t)0xFFFF0002)
-				break;
-			
-			// Otherwise, we have a mutation record; read in the rest of it
-			p += sizeof(mutation_start_tag);
-			
-			memcpy(&polymorphism_id, p, sizeof(polymorphism_id));
-			p += sizeof(polymorphism_id);
-			
-			memcpy(&mutation_id, p, sizeof(mutation_id));
-			p += sizeof(mutation_id);
-			
-			memcpy(&mutation_type_id, p, sizeof(mutation_type_id));
-			p += sizeof(mutation_type_id);
-			
-			memcpy(&position, p, sizeof(position));
-			p += sizeof(position);
-			
-			memcpy(&selection_coeff, p, sizeof(selection_coeff));
-			p += sizeof(selection_coeff);
-			
-			memcpy(&dominance_coeff, p, sizeof(dominance_coeff));
-			p += sizeof(dominance_coeff);
-			
-			memcpy(&subpop_index, p, sizeof(subpop_index));
-			p += sizeof(subpop_index);
-			
-			memcpy(&tick, p, sizeof(tick));
-			p += sizeof(tick);
-			
-			memcpy(&prevalence, p, sizeof(prevalence));
-			(void)prevalence;	// we don't use the frequency when reading the pop data back in; let the static analyzer know that's OK
-			p += sizeof(prevalence);
-			
-			if (has_nucleotides)
+			// Read in the size of the mutation map, so we can allocate a vector rather than utilizing std::map
+			if (p + sizeof(mutation_map_size) > buf_end)
+				EIDOS_TERMINATION << "ERROR (Species::_InitializePopulationFromBinaryFile): unexpected EOF at mutation map size." << EidosTerminate();
+			else
 			{
-				memcpy(&nucleotide, p, sizeof(nucleotide));
-				p += sizeof(nucleotide);
+				memcpy(&mutation_map_size, p, sizeof(mutation_map_size));
+				p += sizeof(mutation_map_size);
 			}
 			
-			// look up the mutation type from its index
-			MutationType *mutation_type_ptr = MutationTypeWithID(mutation_type_id);
-			
-			if (!mutation_type_ptr) 
-				EIDOS_TERMINATION << "ERROR (Species::_InitializePopulationFromBinaryFile): mutation type m" << mutation_type_id << " has not been defined for this species." << EidosTerminate();
-			
-			if (mutation_type_ptr->dominance_coeff_ != dominance_coeff)		// no tolerance, unlike _InitializePopulationFromTextFile(); should match exactly here since we used binary
-				EIDOS_TERMINATION << "ERROR (Species::_InitializePopulationFromBinaryFile): mutation type m" << mutation_type_id << " has dominance coefficient " << mutation_type_ptr->dominance_coeff_ << " that does not match the population file dominance coefficient of " << dominance_coeff << "." << EidosTerminate();
-			
-			// BCH 9/22/2021: Note that mutation_type_ptr->hemizygous_dominance_coeff_ is not saved, or checked here; too edge to be bothered...
-			
-			if ((nucleotide == -1) && mutation_type_ptr->nucleotide_based_)
-				EIDOS_TERMINATION << "ERROR (Species::_InitializePopulationFromBinaryFile): mutation type m" << mutation_type_id << " is nucleotide-based, but a nucleotide value for a mutation of this type was not supplied." << EidosTerminate();
-			if ((nucleotide != -1) && !mutation_type_ptr->nucleotide_based_)
-				EIDOS_TERMINATION << "ERROR (Species::_InitializePopulationFromBinaryFile): mutation type m" << mutation_type_id << " is not nucleotide-based, but a nucleotide value for a mutation of this type was supplied." << EidosTerminate();
-			
-			// construct the new mutation; NOTE THAT THE STACKING POLICY IS NOT CHECKED HERE, AS THIS IS NOT CONSIDERED THE ADDITION OF A MUTATION!
-			MutationIndex new_mut_index = SLiM_NewMutationFromBlock();
+			// Mutations section
+			std::unique_ptr<MutationIndex[]> raii_mutations(new MutationIndex[mutation_map_size]);
+			MutationIndex *mutations = raii_mutations.get();
 			
-			Mutation *new_mut = new (gSLiM_Mutation_Block + new_mut_index) Mutation(mutation_id, mutation_type_ptr, chromosome_index, position, selection_coeff, subpop_index, tick, nucleotide);
+			if (!mutations)
+				EIDOS_TERMINATION << "ERROR (Species::_InitializePopulationFromBinaryFile): could not allocate mutations buffer." << EidosTerminate();
 			
-			// read the tag value, if present
-			if (has_object_tags)
+			while (true)
 			{
-				memcpy(&new_mut->tag_value_, p, sizeof(slim_usertag_t));
-				p += sizeof(slim_usertag_t);
+				int32_t mutation_start_tag;
+				slim_polymorphismid_t polymorphism_id;
+				slim_mutationid_t mutation_id;
+				slim_objectid_t mutation_type_id;
+				slim_position_t position;
+				slim_selcoeff_t selection_coeff;
+				slim_selcoeff_t dominance_coeff;
+				slim_objectid_t subpop_index;
+				slim_tick_t tick;
+				slim_refcount_t prevalence;
+				int8_t nucleotide = -1;
+				
+				// If there isn't enough buffer left to read a full mutation record, we assume we are done with this section
+				int record_size = sizeof(mutation_start_tag) + sizeof(polymorphism_id) + sizeof(mutation_id) + sizeof(mutation_type_id) + sizeof(position) + sizeof(selection_coeff) + sizeof(dominance_coeff) + sizeof(subpop_index) + sizeof(tick) + sizeof(prevalence);
+				
+				if (has_nucleotides)
+					record_size += sizeof(nucleotide);
+				if (has_object_tags)
+					record_size += sizeof(slim_usertag_t);
+				
+				if (p + record_size > buf_end)
+					break;
+				
+				// If the first int32_t is not a mutation start tag, then we are done with this section
+				memcpy(&mutation_start_tag, p, sizeof(mutation_start_tag));
+				if (mutation_start_tag != (int32_t)0xFFFF0002)
+					break;
+				
+				// Otherwise, we have a mutation record; read in the rest of it
+				p += sizeof(mutation_start_tag);
+				
+				memcpy(&polymorphism_id, p, sizeof(polymorphism_id));
+				p += sizeof(polymorphism_id);
+				
+				memcpy(&mutation_id, p, sizeof(mutation_id));
+				p += sizeof(mutation_id);
+				
+				memcpy(&mutation_type_id, p, sizeof(mutation_type_id));
+				p += sizeof(mutation_type_id);
+				
+				memcpy(&position, p, sizeof(position));
+				p += sizeof(position);
+				
+				memcpy(&selection_coeff, p, sizeof(selection_coeff));
+				p += sizeof(selection_coeff);
+				
+				memcpy(&dominance_coeff, p, sizeof(dominance_coeff));
+				p += sizeof(dominance_coeff);
+				
+				memcpy(&subpop_index, p, sizeof(subpop_index));
+				p += sizeof(subpop_index);
+				
+				memcpy(&tick, p, sizeof(tick));
+				p += sizeof(tick);
+				
+				memcpy(&prevalence, p, sizeof(prevalence));
+				(void)prevalence;	// we don't use the frequency when reading the pop data back in; let the static analyzer know that's OK
+				p += sizeof(prevalence);
+				
+				if (has_nucleotides)
+				{
+					memcpy(&nucleotide, p, sizeof(nucleotide));
+					p += sizeof(nucleotide);
+				}
+				
+				// look up the mutation type from its index
+				MutationType *mutation_type_ptr = MutationTypeWithID(mutation_type_id);
+				
+				if (!mutation_type_ptr) 
+					EIDOS_TERMINATION << "ERROR (Species::_InitializePopulationFromBinaryFile): mutation type m" << mutation_type_id << " has not been defined for this species." << EidosTerminate();
+				
+				if (mutation_type_ptr->dominance_coeff_ != dominance_coeff)		// no tolerance, unlike _InitializePopulationFromTextFile(); should match exactly here since we used binary
+					EIDOS_TERMINATION << "ERROR (Species::_InitializePopulationFromBinaryFile): mutation type m" << mutation_type_id << " has dominance coefficient " << mutation_type_ptr->dominance_coeff_ << " that does not match the population file dominance coefficient of " << dominance_coeff << "." << EidosTerminate();
+				
+				// BCH 9/22/2021: Note that mutation_type_ptr->hemizygous_dominance_coeff_ is not saved, or checked here; too edge to be bothered...
+				
+				if ((nucleotide == -1) && mutation_type_ptr->nucleotide_based_)
+					EIDOS_TERMINATION << "ERROR (Species::_InitializePopulationFromBinaryFile): mutation type m" << mutation_type_id << " is nucleotide-based, but a nucleotide value for a mutation of this type was not supplied." << EidosTerminate();
+				if ((nucleotide != -1) && !mutation_type_ptr->nucleotide_based_)
+					EIDOS_TERMINATION << "ERROR (Species::_InitializePopulationFromBinaryFile): mutation type m" << mutation_type_id << " is not nucleotide-based, but a nucleotide value for a mutation of this type was supplied." << EidosTerminate();
+				
+				// construct the new mutation; NOTE THAT THE STACKING POLICY IS NOT CHECKED HERE, AS THIS IS NOT CONSIDERED THE ADDITION OF A MUTATION!
+				MutationIndex new_mut_index = SLiM_NewMutationFromBlock();
+				
+				Mutation *new_mut = new (gSLiM_Mutation_Block + new_mut_index) Mutation(mutation_id, mutation_type_ptr, chromosome_index, position, selection_coeff, subpop_index, tick, nucleotide);
+				
+				// read the tag value, if present
+				if (has_object_tags)
+				{
+					memcpy(&new_mut->tag_value_, p, sizeof(slim_usertag_t));
+					p += sizeof(slim_usertag_t);
+				}
+				
+				// add it to our local map, so we can find it when making haplosomes, and to the population's mutation registry
+				mutations[polymorphism_id] = new_mut_index;
+				population_.MutationRegistryAdd(new_mut);
+				
+	#ifdef SLIM_KEEP_MUTTYPE_REGISTRIES
+				if (population_.keeping_muttype_registries_)
+					EIDOS_TERMINATION << "ERROR (Species::_InitializePopulationFromBinaryFile): (internal error) separate muttype registries set up during pop load." << EidosTerminate();
+	#endif
+				
+				// all mutations seen here will be added to the simulation somewhere, so check and set pure_neutral_ and all_pure_neutral_DFE_
+				if (selection_coeff != 0.0)
+				{
+					pure_neutral_ = false;
+					mutation_type_ptr->all_pure_neutral_DFE_ = false;
+				}
 			}
 			
-			// add it to our local map, so we can find it when making haplosomes, and to the population's mutation registry
-			mutations[polymorphism_id] = new_mut_index;
-			population_.MutationRegistryAdd(new_mut);
+			population_.InvalidateMutationReferencesCache();
 			
-#ifdef SLIM_KEEP_MUTTYPE_REGISTRIES
-			if (population_.keeping_muttype_registries_)
-				EIDOS_TERMINATION << "ERROR (Species::_InitializePopulationFromBinaryFile): (internal error) separate muttype registries set up during pop load." << EidosTerminate();
-#endif
-			
-			// all mutations seen here will be added to the simulation somewhere, so check and set pure_neutral_ and all_pure_neutral_DFE_
-			if (selection_coeff != 0.0)
+			if (p + sizeof(section_end_tag) > buf_end)
+				EIDOS_TERMINATION << "ERROR (Species::_InitializePopulationFromBinaryFile): unexpected EOF after mutations." << EidosTerminate();
+			else
 			{
-				pure_neutral_ = false;
-				mutation_type_ptr->all_pure_neutral_DFE_ = false;
+				memcpy(&section_end_tag, p, sizeof(section_end_tag));
+				p += sizeof(section_end_tag);
+				
+				if (section_end_tag != (int32_t)0xFFFF0000)
+					EIDOS_TERMINATION << "ERROR (Species::_InitializePopulationFromBinaryFile): missing section end after mutations." << EidosTerminate();
 			}
-		}
-		
-		population_.InvalidateMutationReferencesCache();
-		
-		if (p + sizeof(section_end_tag) > buf_end)
-			EIDOS_TERMINATION << "ERROR (Species::_InitializePopulationFromBinaryFile): unexpected EOF after mutations." << EidosTerminate();
-		else
-		{
-			memcpy(&section_end_tag, p, sizeof(section_end_tag));
-			p += sizeof(section_end_tag);
 			
-			if (section_end_tag != (int32_t)0xFFFF0000)
-				EIDOS_TERMINATION << "ERROR (Species::_InitializePopulationFromBinaryFile): missing section end after mutations." << EidosTerminate();
-		}
-		
-		// Haplosomes section
-		Mutation *mut_block_ptr = gSLiM_Mutation_Block;
-		bool use_16_bit = (mutation_map_size <= UINT16_MAX - 1);	// 0xFFFF is reserved as the start of our various tags
-		std::unique_ptr<MutationIndex[]> raii_haplosomebuf(new MutationIndex[mutation_map_size]);	// allowing us to use emplace_back_bulk() for speed
-		MutationIndex *haplosomebuf = raii_haplosomebuf.get();
-#ifndef _OPENMP
-		MutationRunContext &mutrun_context = chromosome->ChromosomeMutationRunContextForThread(omp_get_thread_num());	// when not parallel, we have only one MutationRunContext
-#endif
-		
-		for (std::pair<const slim_objectid_t,Subpopulation*> &subpop_pair : population_.subpops_)
-		{
-			Subpopulation *subpop = subpop_pair.second;
+			// Haplosomes section
+			Mutation *mut_block_ptr = gSLiM_Mutation_Block;
+			bool use_16_bit = (mutation_map_size <= UINT16_MAX - 1);	// 0xFFFF is reserved as the start of our various tags
+			std::unique_ptr<MutationIndex[]> raii_haplosomebuf(new MutationIndex[mutation_map_size]);	// allowing us to use emplace_back_bulk() for speed
+			MutationIndex *haplosomebuf = raii_haplosomebuf.get();
+	#ifndef _OPENMP
+			MutationRunContext &mutrun_context = chromosome->ChromosomeMutationRunContextForThread(omp_get_thread_num());	// when not parallel, we have only one MutationRunContext
+	#endif
 			
-			for (Individual *ind : subpop->parent_individuals_)
+			for (std::pair<const slim_objectid_t,Subpopulation*> &subpop_pair : population_.subpops_)
 			{
-				Haplosome **haplosomes = ind->haplosomes_;
+				Subpopulation *subpop = subpop_pair.second;
 				
-				for (int haplosome_index = first_haplosome_index; haplosome_index <= last_haplosome_index; haplosome_index++)
+				for (Individual *ind : subpop->parent_individuals_)
 				{
-					Haplosome &haplosome = *haplosomes[haplosome_index];
-					slim_objectid_t subpop_id;
-					int32_t total_mutations;
-					
-					// If there isn't enough buffer left to read a full haplosome record, we have an error
-					if (p + sizeof(subpop_id) + sizeof(total_mutations) + (has_object_tags ? sizeof(slim_usertag_t) : 0) > buf_end)
-						EIDOS_TERMINATION << "ERROR (Species::_InitializePopulationFromBinaryFile): unexpected EOF in haplosome header." << EidosTerminate();
-					
-					memcpy(&subpop_id, p, sizeof(subpop_id));
-					p += sizeof(subpop_id);
-					
-					if (subpop_id != subpop_pair.first + 1)		// + 1 to avoid colliding with section_end_tag
-						EIDOS_TERMINATION << "ERROR (Species::_InitializePopulationFromBinaryFile): subpop id mismatch." << EidosTerminate();
-					
-					if (has_object_tags)
-					{
-						memcpy(&haplosome.tag_value_, p, sizeof(slim_usertag_t));
-						p += sizeof(slim_usertag_t);
-					}
+					Haplosome **haplosomes = ind->haplosomes_;
 					
-					memcpy(&total_mutations, p, sizeof(total_mutations));
-					p += sizeof(total_mutations);
-					
-					// Check the null haplosome state
-					// BCH 2/5/2025: We instantiate null haplosomes only where expect them to be, based upon
-					// the chromosome type.  For chromosome types 'A' and 'H', null haplosomes can occur anywhere;
-					// when that happens, we transform the instantiated haplosome to a null haplosome if necessary.
-					// AddSubpopulation() created the haplosomes above, before we knew which would be null.
-					if (total_mutations == (int32_t)0xFFFF1000)
+					for (int haplosome_index = first_haplosome_index; haplosome_index <= last_haplosome_index; haplosome_index++)
 					{
-						if (!haplosome.IsNull())
+						Haplosome &haplosome = *haplosomes[haplosome_index];
+						slim_objectid_t subpop_id;
+						int32_t total_mutations;
+						
+						// If there isn't enough buffer left to read a full haplosome record, we have an error
+						if (p + sizeof(subpop_id) + sizeof(total_mutations) + (has_object_tags ? sizeof(slim_usertag_t) : 0) > buf_end)
+							EIDOS_TERMINATION << "ERROR (Species::_InitializePopulationFromBinaryFile): unexpected EOF in haplosome header." << EidosTerminate();
+						
+						memcpy(&subpop_id, p, sizeof(subpop_id));
+						p += sizeof(subpop_id);
+						
+						if (subpop_id != subpop_pair.first + 1)		// + 1 to avoid colliding with section_end_tag
+							EIDOS_TERMINATION << "ERROR (Species::_InitializePopulationFromBinaryFile): subpop id mismatch." << EidosTerminate();
+						
+						if (has_object_tags)
 						{
-							if ((model_type_ == SLiMModelType::kModelTypeNonWF) && ((chromosome_type == ChromosomeType::kA_DiploidAutosome) || (chromosome_type == ChromosomeType::kH_HaploidAutosome)))
-							{
-								haplosome.MakeNull();
-								subpop->has_null_haplosomes_ = true;
-							}
-							else
-								EIDOS_TERMINATION << "ERROR (Species::_InitializePopulationFromBinaryFile): haplosome is specified as null, but the instantiated haplosome is non-null." << EidosTerminate();
+							memcpy(&haplosome.tag_value_, p, sizeof(slim_usertag_t));
+							p += sizeof(slim_usertag_t);
 						}
-					}
-					else
-					{
-						if (haplosome.IsNull())
-							EIDOS_TERMINATION << "ERROR (Species::_InitializePopulationFromBinaryFile): haplosome is specified as non-null, but the instantiated haplosome is null." << EidosTerminate();
 						
-						// Read in the mutation list
-						int32_t mutcount = 0;
+						memcpy(&total_mutations, p, sizeof(total_mutations));
+						p += sizeof(total_mutations);
 						
-						if (use_16_bit)
+						// Check the null haplosome state
+						// BCH 2/5/2025: We instantiate null haplosomes only where expect them to be, based upon
+						// the chromosome type.  For chromosome types 'A' and 'H', null haplosomes can occur anywhere;
+						// when that happens, we transform the instantiated haplosome to a null haplosome if necessary.
+						// AddSubpopulation() created the haplosomes above, before we knew which would be null.
+						if (total_mutations == (int32_t)0xFFFF1000)
 						{
-							// reading 16-bit mutation tags
-							uint16_t mutation_id;
-							
-							if (p + sizeof(mutation_id) * total_mutations > buf_end)
-								EIDOS_TERMINATION << "ERROR (Species::_InitializePopulationFromBinaryFile): unexpected EOF while reading haplosome." << EidosTerminate();
-							
-							for (; mutcount < total_mutations; ++mutcount)
+							if (!haplosome.IsNull())
 							{
-								memcpy(&mutation_id, p, sizeof(mutation_id));
-								p += sizeof(mutation_id);
-								
-								// Add mutation to haplosome
-								if (/*(mutation_id < 0) ||*/ (mutation_id >= mutation_map_size)) 
-									EIDOS_TERMINATION << "ERROR (Species::_InitializePopulationFromBinaryFile): mutation " << mutation_id << " has not been defined." << EidosTerminate();
-								
-								haplosomebuf[mutcount] = mutations[mutation_id];
+								if ((model_type_ == SLiMModelType::kModelTypeNonWF) && ((chromosome_type == ChromosomeType::kA_DiploidAutosome) || (chromosome_type == ChromosomeType::kH_HaploidAutosome)))
+								{
+									haplosome.MakeNull();
+									subpop->has_null_haplosomes_ = true;
+								}
+								else
+									EIDOS_TERMINATION << "ERROR (Species::_InitializePopulationFromBinaryFile): haplosome is specified as null, but the instantiated haplosome is non-null." << EidosTerminate();
 							}
 						}
 						else
 						{
-							// reading 32-bit mutation tags
-							int32_t mutation_id;
+							if (haplosome.IsNull())
+								EIDOS_TERMINATION << "ERROR (Species::_InitializePopulationFromBinaryFile): haplosome is specified as non-null, but the instantiated haplosome is null." << EidosTerminate();
 							
-							if (p + sizeof(mutation_id) * total_mutations > buf_end)
-								EIDOS_TERMINATION << "ERROR (Species::_InitializePopulationFromBinaryFile): unexpected EOF while reading haplosome." << EidosTerminate();
+							// Read in the mutation list
+							int32_t mutcount = 0;
 							
-							for (; mutcount < total_mutations; ++mutcount)
+							if (use_16_bit)
 							{
-								memcpy(&mutation_id, p, sizeof(mutation_id));
-								p += sizeof(mutation_id);
+								// reading 16-bit mutation tags
+								uint16_t mutation_id;
 								
-								// Add mutation to haplosome
-								if ((mutation_id < 0) || (mutation_id >= mutation_map_size)) 
-									EIDOS_TERMINATION << "ERROR (Species::_InitializePopulationFromBinaryFile): mutation " << mutation_id << " has not been defined." << EidosTerminate();
+								if (p + sizeof(mutation_id) * total_mutations > buf_end)
+									EIDOS_TERMINATION << "ERROR (Species::_InitializePopulationFromBinaryFile): unexpected EOF while reading haplosome." << EidosTerminate();
 								
-								haplosomebuf[mutcount] = mutations[mutation_id];
+								for (; mutcount < total_mutations; ++mutcount)
+								{
+									memcpy(&mutation_id, p, sizeof(mutation_id));
+									p += sizeof(mutation_id);
+									
+									// Add mutation to haplosome
+									if (/*(mutation_id < 0) ||*/ (mutation_id >= mutation_map_size)) 
+										EIDOS_TERMINATION << "ERROR (Species::_InitializePopulationFromBinaryFile): mutation " << mutation_id << " has not been defined." << EidosTerminate();
+									
+									haplosomebuf[mutcount] = mutations[mutation_id];
+								}
 							}
-						}
-						
-						slim_position_t mutrun_length_ = haplosome.mutrun_length_;
-						slim_mutrun_index_t current_mutrun_index = -1;
-						MutationRun *current_mutrun = nullptr;
-						
-						for (int mut_index = 0; mut_index < mutcount; ++mut_index)
-						{
-							MutationIndex mutation = haplosomebuf[mut_index];
-							slim_mutrun_index_t mutrun_index = (slim_mutrun_index_t)((mut_block_ptr + mutation)->position_ / mutrun_length_);
-							
-							if (mutrun_index != current_mutrun_index)
+							else
 							{
-#ifdef _OPENMP
-								// When parallel, the MutationRunContext depends upon the position in the haplosome
-								MutationRunContext &mutrun_context = chromosome.ChromosomeMutationRunContextForMutationRunIndex(mutrun_index);
-#endif
+								// reading 32-bit mutation tags
+								int32_t mutation_id;
 								
-								current_mutrun_index = mutrun_index;
+								if (p + sizeof(mutation_id) * total_mutations > buf_end)
+									EIDOS_TERMINATION << "ERROR (Species::_InitializePopulationFromBinaryFile): unexpected EOF while reading haplosome." << EidosTerminate();
 								
-								// We use WillModifyRun_UNSHARED() because we know that these runs are unshared (unless empty);
-								// we created them empty, nobody has modified them but us, and we process each haplosome separately.
-								// However, using WillModifyRun() would generally be fine since we hit this call only once
-								// per mutrun per haplosome anyway, as long as the mutations are sorted by position.
-								current_mutrun = haplosome.WillModifyRun_UNSHARED(current_mutrun_index, mutrun_context);
+								for (; mutcount < total_mutations; ++mutcount)
+								{
+									memcpy(&mutation_id, p, sizeof(mutation_id));
+									p += sizeof(mutation_id);
+									
+									// Add mutation to haplosome
+									if ((mutation_id < 0) || (mutation_id >= mutation_map_size)) 
+										EIDOS_TERMINATION << "ERROR (Species::_InitializePopulationFromBinaryFile): mutation " << mutation_id << " has not been defined." << EidosTerminate();
+									
+									haplosomebuf[mutcount] = mutations[mutation_id];
+								}
 							}
 							
-							current_mutrun->emplace_back(mutation);
+							slim_position_t mutrun_length_ = haplosome.mutrun_length_;
+							slim_mutrun_index_t current_mutrun_index = -1;
+							MutationRun *current_mutrun = nullptr;
+							
+							for (int mut_index = 0; mut_index < mutcount; ++mut_index)
+							{
+								MutationIndex mutation = haplosomebuf[mut_index];
+								slim_mutrun_index_t mutrun_index = (slim_mutrun_index_t)((mut_block_ptr + mutation)->position_ / mutrun_length_);
+								
+								if (mutrun_index != current_mutrun_index)
+								{
+	#ifdef _OPENMP
+									// When parallel, the MutationRunContext depends upon the position in the haplosome
+									MutationRunContext &mutrun_context = chromosome.ChromosomeMutationRunContextForMutationRunIndex(mutrun_index);
+	#endif
+									
+									current_mutrun_index = mutrun_index;
+									
+									// We use WillModifyRun_UNSHARED() because we know that these runs are unshared (unless empty);
+									// we created them empty, nobody has modified them but us, and we process each haplosome separately.
+									// However, using WillModifyRun() would generally be fine since we hit this call only once
+									// per mutrun per haplosome anyway, as long as the mutations are sorted by position.
+									current_mutrun = haplosome.WillModifyRun_UNSHARED(current_mutrun_index, mutrun_context);
+								}
+								
+								current_mutrun->emplace_back(mutation);
+							}
 						}
 					}
 				}
 			}
-		}
-		
-		if (p + sizeof(section_end_tag) > buf_end)
-			EIDOS_TERMINATION << "ERROR (Species::_InitializePopulationFromBinaryFile): unexpected EOF after haplosomes." << EidosTerminate();
-		else
-		{
-			memcpy(&section_end_tag, p, sizeof(section_end_tag));
-			p += sizeof(section_end_tag);
 			
-			if (section_end_tag != (int32_t)0xFFFF0000)
-				EIDOS_TERMINATION << "ERROR (Species::_InitializePopulationFromBinaryFile): missing section end after haplosomes." << EidosTerminate();
+			if (p + sizeof(section_end_tag) > buf_end)
+				EIDOS_TERMINATION << "ERROR (Species::_InitializePopulationFromBinaryFile): unexpected EOF after haplosomes." << EidosTerminate();
+			else
+			{
+				memcpy(&section_end_tag, p, sizeof(section_end_tag));
+				p += sizeof(section_end_tag);
+				
+				if (section_end_tag != (int32_t)0xFFFF0000)
+					EIDOS_TERMINATION << "ERROR (Species::_InitializePopulationFromBinaryFile): missing section end after haplosomes." << EidosTerminate();
+			}
 		}
 		
 		// Ancestral sequence section, for nucleotide-based models
@@ -2406,6 +2484,305 @@ slim_tick_t Species::_InitializePopulationFromBinaryFile(const char *p_file, Eid
 }
 #endif
 
+// read a column of p_count values for _InitializeChromosomeFromColumnarData(), advancing *p_ptr past it
+template <typename T>
+static void ReadBinaryColumn(char **p_ptr, char *p_buf_end, int64_t p_count, std::vector<T> &p_column)
+{
+	size_t byte_count = (size_t)p_count * sizeof(T);
+	
+	if ((p_count < 0) || (*p_ptr + byte_count > p_buf_end))
+		EIDOS_TERMINATION << "ERROR (Species::_InitializePopulationFromBinaryFile): unexpected EOF while reading columnar genetic data." << EidosTerminate();
+	
+	// memcpy() since the column may not be aligned; see _InitializePopulationFromBinaryFile()
+	p_column.resize((size_t)p_count);
+	
+	if (byte_count)
+		memcpy(p_column.data(), *p_ptr, byte_count);
+	
+	*p_ptr += byte_count;
+}
+
+void Species::_InitializeChromosomeFromColumnarData(char **p_ptr, char *p_buf_end, Chromosome &p_chromosome, bool p_has_nucleotides, bool p_has_object_tags)
+{
+	// This reads the genetic data for one chromosome from a version 9 binary file, as written by Population::PrintAllBinary(),
+	// which is responsible for the format.  Each distinct mutation run in the file is constructed just once, with a bulk copy,
+	// and then shared among all of the haplosomes that use it, as long as our mutation run count matches that of the file.
+	char *p = *p_ptr;
+	int32_t section_end_tag;
+	slim_chromosome_index_t chromosome_index = p_chromosome.Index();
+	ChromosomeType chromosome_type = p_chromosome.Type();
+	int first_haplosome_index = FirstHaplosomeIndices()[chromosome_index];
+	int last_haplosome_index = LastHaplosomeIndices()[chromosome_index];
+	
+	// Mutations section
+	int32_t mutation_count;
+	
+	if (p + sizeof(mutation_count) > p_buf_end)
+		EIDOS_TERMINATION << "ERROR (Species::_InitializePopulationFromBinaryFile): unexpected EOF at mutation count." << EidosTerminate();
+	
+	memcpy(&mutation_count, p, sizeof(mutation_count));
+	p += sizeof(mutation_count);
+	
+	std::vector<int64_t> mutation_ids;
+	std::vector<slim_objectid_t> mutation_type_ids;
+	std::vector<slim_position_t> positions;
+	std::vector<slim_selcoeff_t> selection_coeffs;
+	std::vector<slim_selcoeff_t> dominance_coeffs;
+	std::vector<slim_objectid_t> subpop_indices;
+	std::vector<slim_tick_t> origin_ticks;
+	std::vector<int8_t> nucleotides;
+	std::vector<slim_usertag_t> mutation_tags;
+	
+	ReadBinaryColumn(&p, p_buf_end, mutation_count, mutation_ids);
+	ReadBinaryColumn(&p, p_buf_end, mutation_count, mutation_type_ids);
+	ReadBinaryColumn(&p, p_buf_end, mutation_count, positions);
+	ReadBinaryColumn(&p, p_buf_end, mutation_count, selection_coeffs);
+	ReadBinaryColumn(&p, p_buf_end, mutation_count, dominance_coeffs);
+	ReadBinaryColumn(&p, p_buf_end, mutation_count, subpop_indices);
+	ReadBinaryColumn(&p, p_buf_end, mutation_count, origin_ticks);
+	ReadBinaryColumn(&p, p_buf_end, p_has_nucleotides ? mutation_count : 0, nucleotides);
+	ReadBinaryColumn(&p, p_buf_end, p_has_object_tags ? mutation_count : 0, mutation_tags);
+	
+	std::vector<MutationIndex> mutations(mutation_count);	// the MutationIndex for each mutation table row
+	MutationType *mutation_type_ptr = nullptr;
+	
+	for (int32_t row = 0; row < mutation_count; ++row)
+	{
+		slim_objectid_t mutation_type_id = mutation_type_ids[row];
+		slim_selcoeff_t selection_coeff = selection_coeffs[row];
+		int8_t nucleotide = (p_has_nucleotides ? nucleotides[row] : -1);
+		
+		// look up the mutation type from its index; rows of the same type tend to come in clumps
+		if (!mutation_type_ptr || (mutation_type_ptr->mutation_type_id_ != mutation_type_id))
+		{
+			mutation_type_ptr = MutationTypeWithID(mutation_type_id);
+			
+			if (!mutation_type_ptr) 
+				EIDOS_TERMINATION << "ERROR (Species::_InitializePopulationFromBinaryFile): mutation type m" << mutation_type_id << " has not been defined for this species." << EidosTerminate();
+		}
+		
+		if (mutation_type_ptr->dominance_coeff_ != dominance_coeffs[row])		// no tolerance, unlike _InitializePopulationFromTextFile(); should match exactly here since we used binary
+			EIDOS_TERMINATION << "ERROR (Species::_InitializePopulationFromBinaryFile): mutation type m" << mutation_type_id << " has dominance coefficient " << mutation_type_ptr->dominance_coeff_ << " that does not match the population file dominance coefficient of " << dominance_coeffs[row] << "." << EidosTerminate();
+		
+		if ((nucleotide == -1) && mutation_type_ptr->nucleotide_based_)
+			EIDOS_TERMINATION << "ERROR (Species::_InitializePopulationFromBinaryFile): mutation type m" << mutation_type_id << " is nucleotide-based, but a nucleotide value for a mutation of this type was not supplied." << EidosTerminate();
+		if ((nucleotide != -1) && !mutation_type_ptr->nucleotide_based_)
+			EIDOS_TERMINATION << "ERROR (Species::_InitializePopulationFromBinaryFile): mutation type m" << mutation_type_id << " is not nucleotide-based, but a nucleotide value for a mutation of this type was supplied." << EidosTerminate();
+		
+		// construct the new mutation; NOTE THAT THE STACKING POLICY IS NOT CHECKED HERE, AS THIS IS NOT CONSIDERED THE ADDITION OF A MUTATION!
+		MutationIndex new_mut_index = SLiM_NewMutationFromBlock();
+		
+		Mutation *new_mut = new (gSLiM_Mutation_Block + new_mut_index) Mutation(mutation_ids[row], mutation_type_ptr, chromosome_index, positions[row], selection_coeff, subpop_indices[row], origin_ticks[row], nucleotide);
+		
+		if (p_has_object_tags)
+			new_mut->tag_value_ = mutation_tags[row];
+		
+		mutations[row] = new_mut_index;
+		population_.MutationRegistryAdd(new_mut);
+		
+#ifdef SLIM_KEEP_MUTTYPE_REGISTRIES
+		if (population_.keeping_muttype_registries_)
+			EIDOS_TERMINATION << "ERROR (Species::_InitializePopulationFromBinaryFile): (internal error) separate muttype registries set up during pop load." << EidosTerminate();
+#endif
+		
+		// all mutations seen here will be added to the simulation somewhere, so check and set pure_neutral_ and all_pure_neutral_DFE_
+		if (selection_coeff != 0.0)
+		{
+			pure_neutral_ = false;
+			mutation_type_ptr->all_pure_neutral_DFE_ = false;
+		}
+	}
+	
+	population_.InvalidateMutationReferencesCache();
+	
+	if (p + sizeof(section_end_tag) > p_buf_end)
+		EIDOS_TERMINATION << "ERROR (Species::_InitializePopulationFromBinaryFile): unexpected EOF after mutations." << EidosTerminate();
+	
+	memcpy(&section_end_tag, p, sizeof(section_end_tag));
+	p += sizeof(section_end_tag);
+	
+	if (section_end_tag != (int32_t)0xFFFF0000)
+		EIDOS_TERMINATION << "ERROR (Species::_InitializePopulationFromBinaryFile): missing section end after mutations." << EidosTerminate();
+	
+	// Mutation runs section; the pooled rows are translated to MutationIndex values in place
+	int32_t file_mutrun_count, run_pool_size;
+	int64_t run_pool_rows_size;
+	
+	if (p + sizeof(file_mutrun_count) + sizeof(run_pool_size) + sizeof(run_pool_rows_size) > p_buf_end)
+		EIDOS_TERMINATION << "ERROR (Species::_InitializePopulationFromBinaryFile): unexpected EOF at mutation run counts." << EidosTerminate();
+	
+	memcpy(&file_mutrun_count, p, sizeof(file_mutrun_count));
+	p += sizeof(file_mutrun_count);
+	memcpy(&run_pool_size, p, sizeof(run_pool_size));
+	p += sizeof(run_pool_size);
+	memcpy(&run_pool_rows_size, p, sizeof(run_pool_rows_size));
+	p += sizeof(run_pool_rows_size);
+	
+	if ((file_mutrun_count <= 0) || (run_pool_size < 0))
+		EIDOS_TERMINATION << "ERROR (Species::_InitializePopulationFromBinaryFile): mutation run counts out of range." << EidosTerminate();
+	
+	std::vector<int32_t> run_pool_run_indices;
+	std::vector<int64_t> run_pool_offsets;
+	std::vector<MutationIndex> run_pool_mutations;
+	
+	ReadBinaryColumn(&p, p_buf_end, run_pool_size, run_pool_run_indices);
+	ReadBinaryColumn(&p, p_buf_end, (int64_t)run_pool_size + 1, run_pool_offsets);
+	ReadBinaryColumn(&p, p_buf_end, run_pool_rows_size, run_pool_mutations);
+	
+	if ((run_pool_offsets[0] != 0) || (run_pool_offsets[run_pool_size] != run_pool_rows_size))
+		EIDOS_TERMINATION << "ERROR (Species::_InitializePopulationFromBinaryFile): mutation run offsets out of range." << EidosTerminate();
+	
+	for (int32_t pool_index = 0; pool_index < run_pool_size; ++pool_index)
+		if ((run_pool_offsets[pool_index + 1] < run_pool_offsets[pool_index]) || (run_pool_run_indices[pool_index] < 0) || (run_pool_run_indices[pool_index] >= file_mutrun_count))
+			EIDOS_TERMINATION << "ERROR (Species::_InitializePopulationFromBinaryFile): mutation run pool entry out of range." << EidosTerminate();
+	
+	for (MutationIndex &pooled_mutation : run_pool_mutations)
+	{
+		if ((pooled_mutation < 0) || (pooled_mutation >= mutation_count))
+			EIDOS_TERMINATION << "ERROR (Species::_InitializePopulationFromBinaryFile): mutation " << pooled_mutation << " has not been defined." << EidosTerminate();
+		
+		pooled_mutation = mutations[pooled_mutation];
+	}
+	
+	// If our mutation run count matches the file, construct the pooled runs now, for sharing; if not (since the count
+	// can be changed by mutation run experiments, for example), the haplosomes get their mutations redistributed below
+	bool share_pooled_runs = (file_mutrun_count == p_chromosome.mutrun_count_);
+	std::vector<MutationRun *> pooled_runs;
+	
+	if (share_pooled_runs)
+	{
+		pooled_runs.resize(run_pool_size);
+		
+		for (int32_t pool_index = 0; pool_index < run_pool_size; ++pool_index)
+		{
+			slim_mutrun_index_t mutrun_index = (slim_mutrun_index_t)run_pool_run_indices[pool_index];
+			MutationRunContext &mutrun_context = p_chromosome.ChromosomeMutationRunContextForMutationRunIndex(mutrun_index);
+			MutationRun *new_run = MutationRun::NewMutationRun(mutrun_context);
+			int64_t run_start = run_pool_offsets[pool_index];
+			
+			new_run->emplace_back_bulk(run_pool_mutations.data() + run_start, (int32_t)(run_pool_offsets[pool_index + 1] - run_start));
+			pooled_runs[pool_index] = new_run;
+		}
+	}
+	
+	// Haplosomes section
+	int32_t haplosome_count;
+	
+	if (p + sizeof(haplosome_count) > p_buf_end)
+		EIDOS_TERMINATION << "ERROR (Species::_InitializePopulationFromBinaryFile): unexpected EOF at haplosome count." << EidosTerminate();
+	
+	memcpy(&haplosome_count, p, sizeof(haplosome_count));
+	p += sizeof(haplosome_count);
+	
+	std::vector<int8_t> haplosome_null_flags;
+	std::vector<slim_usertag_t> haplosome_tags;
+	std::vector<int32_t> haplosome_runs;
+	
+	ReadBinaryColumn(&p, p_buf_end, haplosome_count, haplosome_null_flags);
+	ReadBinaryColumn(&p, p_buf_end, p_has_object_tags ? haplosome_count : 0, haplosome_tags);
+	ReadBinaryColumn(&p, p_buf_end, (int64_t)haplosome_count * file_mutrun_count, haplosome_runs);
+	
+	Mutation *mut_block_ptr = gSLiM_Mutation_Block;
+	int32_t haplosome_row = 0;
+	
+	for (std::pair<const slim_objectid_t,Subpopulation*> &subpop_pair : population_.subpops_)
+	{
+		Subpopulation *subpop = subpop_pair.second;
+		
+		for (Individual *ind : subpop->parent_individuals_)
+		{
+			Haplosome **haplosomes = ind->haplosomes_;
+			
+			for (int haplosome_index = first_haplosome_index; haplosome_index <= last_haplosome_index; haplosome_index++)
+			{
+				Haplosome &haplosome = *haplosomes[haplosome_index];
+				
+				if (haplosome_row >= haplosome_count)
+					EIDOS_TERMINATION << "ERROR (Species::_InitializePopulationFromBinaryFile): haplosome count does not match the population." << EidosTerminate();
+				
+				if (p_has_object_tags)
+					haplosome.tag_value_ = haplosome_tags[haplosome_row];
+				
+				// Check the null haplosome state, as in the version 8 code in _InitializePopulationFromBinaryFile()
+				if (haplosome_null_flags[haplosome_row])
+				{
+					if (!haplosome.IsNull())
+					{
+						if ((model_type_ == SLiMModelType::kModelTypeNonWF) && ((chromosome_type == ChromosomeType::kA_DiploidAutosome) || (chromosome_type == ChromosomeType::kH_HaploidAutosome)))
+						{
+							haplosome.MakeNull();
+							subpop->has_null_haplosomes_ = true;
+						}
+						else
+							EIDOS_TERMINATION << "ERROR (Species::_InitializePopulationFromBinaryFile): haplosome is specified as null, but the instantiated haplosome is non-null." << EidosTerminate();
+					}
+				}
+				else
+				{
+					if (haplosome.IsNull())
+						EIDOS_TERMINATION << "ERROR (Species::_InitializePopulationFromBinaryFile): haplosome is specified as non-null, but the instantiated haplosome is null." << EidosTerminate();
+					
+					const int32_t *runs = haplosome_runs.data() + (size_t)haplosome_row * file_mutrun_count;
+					
+					for (int32_t run_index = 0; run_index < file_mutrun_count; ++run_index)
+						if ((runs[run_index] < 0) || (runs[run_index] >= run_pool_size))
+							EIDOS_TERMINATION << "ERROR (Species::_InitializePopulationFromBinaryFile): haplosome mutation run out of range." << EidosTerminate();
+					
+					if (share_pooled_runs)
+					{
+						for (int32_t run_index = 0; run_index < file_mutrun_count; ++run_index)
+							haplosome.mutruns_[run_index] = pooled_runs[runs[run_index]];
+					}
+					else
+					{
+						// Redistribute the mutations into our mutation runs, which have a different length from the file's
+						slim_position_t mutrun_length = haplosome.mutrun_length_;
+						slim_mutrun_index_t current_mutrun_index = -1;
+						MutationRun *current_mutrun = nullptr;
+						
+						for (int32_t run_index = 0; run_index < file_mutrun_count; ++run_index)
+						{
+							int32_t pool_index = runs[run_index];
+							
+							for (int64_t pooled_index = run_pool_offsets[pool_index]; pooled_index < run_pool_offsets[pool_index + 1]; ++pooled_index)
+							{
+								MutationIndex mutation = run_pool_mutations[pooled_index];
+								slim_mutrun_index_t mutrun_index = (slim_mutrun_index_t)((mut_block_ptr + mutation)->position_ / mutrun_length);
+								
+								if (mutrun_index != current_mutrun_index)
+								{
+									MutationRunContext &mutrun_context = p_chromosome.ChromosomeMutationRunContextForMutationRunIndex(mutrun_index);
+									
+									current_mutrun_index = mutrun_index;
+									current_mutrun = haplosome.WillModifyRun_UNSHARED(current_mutrun_index, mutrun_context);
+								}
+								
+								current_mutrun->emplace_back(mutation);
+							}
+						}
+					}
+				}
+				
+				haplosome_row++;
+			}
+		}
+	}
+	
+	if (haplosome_row != haplosome_count)
+		EIDOS_TERMINATION << "ERROR (Species::_InitializePopulationFromBinaryFile): haplosome count does not match the population." << EidosTerminate();
+	
+	if (p + sizeof(section_end_tag) > p_buf_end)
+		EIDOS_TERMINATION << "ERROR (Species::_InitializePopulationFromBinaryFile): unexpected EOF after haplosomes." << EidosTerminate();
+	
+	memcpy(&section_end_tag, p, sizeof(section_end_tag));
+	p += sizeof(section_end_tag);
+	
+	if (section_end_tag != (int32_t)0xFFFF0000)
+		EIDOS_TERMINATION << "ERROR (Species::_InitializePopulationFromBinaryFile): missing section end after haplosomes." << EidosTerminate();
+	
+	*p_ptr = p;
+}
+
 void Species::DeleteAllMutationRuns(void)
 {
 	// This traverses the free and in-use MutationRun pools and frees them all
@@ -3554,6 +3931,14 @@ void Species::SimulationHasFinished(void)
 			SLIM_OUTSTREAM << std::endl;
 		}
 	}
+	
+#ifndef SLIMGUI
+	// Remove any edge spill files; at the command line we exit without freeing the species, so FreeTreeSequence() would
+	// not get the chance.  In SLiMgui the tree sequence can still be used from the console, so we leave them until then.
+	if (recording_tree_ && tables_initialized_)
+		for (TreeSeqInfo &tsinfo : treeseq_)
+			DiscardSpilledTreeSeqEdges(tsinfo);
+#endif
 }
 
 void Species::InferInheritanceForClone(Chromosome *chromosome, Individual *parent, IndividualSex sex, Haplosome **strand1, Haplosome **strand3, const char *caller_name)
@@ -4289,9 +4674,9 @@ void Species::TabulateSLiMMemoryUsage_Species(SLiMMemoryUsage_Species *p_usage)
 	/*
 	 Subpopulation:
 	 
-	gsl_ran_discrete_t *lookup_parent_ = nullptr;			// OWNED POINTER: lookup table for drawing a parent based upon fitness
-	gsl_ran_discrete_t *lookup_female_parent_ = nullptr;	// OWNED POINTER: lookup table for drawing a female parent based upon fitness, SEX ONLY
-	gsl_ran_discrete_t *lookup_male_parent_ = nullptr;		// OWNED POINTER: lookup table for drawing a male parent based upon fitness, SEX ONLY
+	EidosAliasTable lookup_parent_;			// lookup table for drawing a parent based upon fitness
+	EidosAliasTable lookup_female_parent_;	// lookup table for drawing a female parent based upon fitness, SEX ONLY
+	EidosAliasTable lookup_male_parent_;	// lookup table for drawing a male parent based upon fitness, SEX ONLY
 
 	 */
 	
@@ -4692,6 +5077,44 @@ struct edge_plus_time {
 	double left, right;
 };
 
+// The sort order for edges: by parent time as tskit requires, then by parent, child, and left, as tsk_table_collection_sort() does
+static inline __attribute__((always_inline)) bool slim_edge_less(const edge_plus_time &lhs, const edge_plus_time &rhs)
+{
+	if (lhs.time == rhs.time) {
+		if (lhs.parent == rhs.parent) {
+			if (lhs.child == rhs.child) {
+				return lhs.left < rhs.left;
+			}
+			return lhs.child < rhs.child;
+		}
+		return lhs.parent < rhs.parent;
+	}
+	return lhs.time < rhs.time;
+}
+
+// Simplification leaves the edge table sorted, and recording only appends to it, so at the next simplification we need only
+// sort the newly appended edges and merge them into the already sorted prefix.  That turns an O(N log N) sort of the whole
+// retained history into an O(k log k) sort of the k new edges plus an O(N) merge.  The length of the prefix, as left by the
+// last simplification, is passed in through sorter->user_data.  We verify that the prefix really is in order (which is cheap
+// compared to sorting it), so if something has modified the edge table since the last simplification we just do a full sort.
+// Since the sort order is total for a valid edge table, the result is identical to that of a full sort either way.
+static tsk_size_t slim_sorted_edge_prefix(tsk_table_sorter_t *sorter, const edge_plus_time *temp_edge_data, tsk_size_t num_rows)
+{
+	if (!sorter->user_data)
+		return 0;
+	
+	tsk_size_t sorted_count = *(tsk_size_t *)sorter->user_data;
+	
+	if (sorted_count > num_rows)
+		return 0;
+	
+	for (tsk_size_t i = 1; i < sorted_count; ++i)
+		if (slim_edge_less(temp_edge_data[i], temp_edge_data[i - 1]))
+			return 0;
+	
+	return sorted_count;
+}
+
 // This parallel sorter is basically a clone of _Eidos_ParallelQuicksort_ASCENDING() in eidos_sorting.inc
 // The only difference (and the only reason we can't use that code directly) is we want to inline our comparator
 #ifdef _OPENMP
@@ -4806,20 +5229,13 @@ slim_sort_edges(tsk_table_sorter_t *sorter, tsk_size_t start)
 		temp_edge_data[i] = edge_plus_time{ node_times[edges->parent[i]], edges->parent[i], edges->child[i], edges->left[i], edges->right[i] };
 	}
 	
-	// sort with std::sort
-	std::sort(temp_edge_data, temp_edge_data + num_rows,
-			  [](const edge_plus_time &lhs, const edge_plus_time &rhs) {
-		if (lhs.time == rhs.time) {
-			if (lhs.parent == rhs.parent) {
-				if (lhs.child == rhs.child) {
-					return lhs.left < rhs.left;
-				}
-				return lhs.child < rhs.child;
-			}
-			return lhs.parent < rhs.parent;
-		}
-		return lhs.time < rhs.time;
-	});
+	// sort the edges added since the last simplification with std::sort, and merge them into the sorted prefix
+	tsk_size_t sorted_count = slim_sorted_edge_prefix(sorter, temp_edge_data, num_rows);
+	
+	std::sort(temp_edge_data + sorted_count, temp_edge_data + num_rows, slim_edge_less);
+	
+	if ((sorted_count > 0) && (sorted_count < num_rows))
+		std::inplace_merge(temp_edge_data, temp_edge_data + sorted_count, temp_edge_data + num_rows, slim_edge_less);
 	
 	// post-sort: copy the sorted temp_edge_data vector back into the edge table
 	for (std::size_t i = 0; i < num_rows; ++i)
@@ -4872,14 +5288,19 @@ slim_sort_edges_PARALLEL(tsk_table_sorter_t *sorter, tsk_size_t start)
 	// sort with std::sort when not running parallel, or if the task is small;
 	// sort in parallel for big tasks if we can; see Eidos_ParallelSort() which
 	// this is patterned after, but we want the (faster) inlined comparator...
+	// only the edges added since the last simplification get sorted, and are then
+	// merged into the sorted prefix; see slim_sorted_edge_prefix()
 	{
 		EIDOS_BENCHMARK_START(EidosBenchmarkType::k_SIMPLIFY_SORT);
 		
+		tsk_size_t sorted_count = slim_sorted_edge_prefix(sorter, temp_edge_data, num_rows);
+		std::size_t unsorted_count = num_rows - sorted_count;
+		
 #ifdef _OPENMP
-		if (num_rows >= EIDOS_OMPMIN_SIMPLIFY_SORT)
+		if (unsorted_count >= EIDOS_OMPMIN_SIMPLIFY_SORT)
 		{
 			EIDOS_THREAD_COUNT(gEidos_OMP_threads_SIMPLIFY_SORT);
-#pragma omp parallel default(none) shared(num_rows, temp_edge_data) num_threads(thread_count)
+#pragma omp parallel default(none) shared(num_rows, sorted_count, unsorted_count, temp_edge_data) num_threads(thread_count)
 			{
 				// We fall through to using std::sort when below a threshold interval size.
 				// The larger the threshold, the less time we spend thrashing tasks on small
@@ -4889,14 +5310,14 @@ slim_sort_edges_PARALLEL(tsk_table_sorter_t *sorter, tsk_size_t start)
 				// to subdivide with tasks enough that the workload is shared well, and then
 				// do the rest of the work with std::sort().  The more threads there are,
 				// the smaller we want to subdivide.
-				int64_t fallthrough = num_rows / (EIDOS_FALLTHROUGH_FACTOR * omp_get_num_threads());
+				int64_t fallthrough = unsorted_count / (EIDOS_FALLTHROUGH_FACTOR * omp_get_num_threads());
 				
 				if (fallthrough < 1000)
 					fallthrough = 1000;
 				
 #pragma omp single nowait
 				{
-					_Eidos_ParallelQuicksort_ASCENDING(temp_edge_data, 0, num_rows - 1, fallthrough);
+					_Eidos_ParallelQuicksort_ASCENDING(temp_edge_data, sorted_count, num_rows - 1, fallthrough);
 				}
 			} // End of parallel region
 			
@@ -4904,24 +5325,15 @@ slim_sort_edges_PARALLEL(tsk_table_sorter_t *sorter, tsk_size_t start)
 		}
 #endif
 		
-		std::sort(temp_edge_data, temp_edge_data + num_rows,
-				  [](const edge_plus_time &lhs, const edge_plus_time &rhs) {
-			if (lhs.time == rhs.time) {
-				if (lhs.parent == rhs.parent) {
-					if (lhs.child == rhs.child) {
-						return lhs.left < rhs.left;
-					}
-					return lhs.child < rhs.child;
-				}
-				return lhs.parent < rhs.parent;
-			}
-			return lhs.time < rhs.time;
-		});
+		std::sort(temp_edge_data + sorted_count, temp_edge_data + num_rows, slim_edge_less);
 		
 #ifdef _OPENMP
 		// If we did a parallel sort, we jump here to skip the single-threaded sort
 	didParallelSort:
 #endif
+		if ((sorted_count > 0) && (sorted_count < num_rows))
+			std::inplace_merge(temp_edge_data, temp_edge_data + sorted_count, temp_edge_data + num_rows, slim_edge_less);
+		
 		EIDOS_BENCHMARK_END(EidosBenchmarkType::k_SIMPLIFY_SORT);
 	}
 	
@@ -4946,11 +5358,66 @@ slim_sort_edges_PARALLEL(tsk_table_sorter_t *sorter, tsk_size_t start)
 }
 #endif
 
-void Species::_SimplifyTreeSequence(TreeSeqInfo &tsinfo, const std::vector<tsk_id_t> &samples)
+// Edges spilled to disk between simplifications (see SpillTreeSeqEdges()) are kept in a kastore file, one per chromosome,
+// using the same column keys that tskit uses for the edge table in a .trees file.  This reads a spill file and inserts its
+// rows at the start of p_edges, ahead of the edges recorded since the spill, remapping their node ids through p_node_id_map
+// if it is non-NULL.  It does not raise, so that it can be used inside parallel regions; on failure it returns the tskit
+// error code and sets p_error_call to the name of the failing call.
+static int slim_prepend_spilled_edges(tsk_edge_table_t *p_edges, const char *p_spill_path, tsk_size_t p_spilled_count, const tsk_id_t *p_node_id_map, const char **p_error_call)
+{
+	kastore_t store;
+	double *left, *right;
+	int32_t *parent, *child;
+	size_t left_length, right_length, parent_length, child_length;
+	
+	int ret = kastore_open(&store, p_spill_path, "r", KAS_READ_ALL);
+	if (ret != 0) { kastore_close(&store); *p_error_call = "kastore_open"; return tsk_set_kas_error(ret); }
+	
+	ret = kastore_gets_float64(&store, "edges/left", &left, &left_length);
+	if (ret == 0) ret = kastore_gets_float64(&store, "edges/right", &right, &right_length);
+	if (ret == 0) ret = kastore_gets_int32(&store, "edges/parent", &parent, &parent_length);
+	if (ret == 0) ret = kastore_gets_int32(&store, "edges/child", &child, &child_length);
+	if (ret != 0) { kastore_close(&store); *p_error_call = "kastore_gets"; return tsk_set_kas_error(ret); }
+	
+	if ((left_length != p_spilled_count) || (right_length != p_spilled_count) || (parent_length != p_spilled_count) || (child_length != p_spilled_count))
+	{
+		kastore_close(&store);
+		*p_error_call = "slim_prepend_spilled_edges";
+		return TSK_ERR_FILE_FORMAT;
+	}
+	
+	// build the combined table in a new edge table, spilled rows first, and then swap it in
+	tsk_edge_table_t combined;
+	
+	ret = tsk_edge_table_init(&combined, p_edges->options);
+	if (ret == 0) ret = tsk_edge_table_set_metadata_schema(&combined, p_edges->metadata_schema, p_edges->metadata_schema_length);
+	if (ret == 0) ret = tsk_edge_table_set_columns(&combined, p_spilled_count, left, right, parent, child, NULL, NULL);
+	kastore_close(&store);
+	if (ret != 0) { tsk_edge_table_free(&combined); *p_error_call = "tsk_edge_table_set_columns"; return ret; }
+	
+	if (p_node_id_map)
+	{
+		for (tsk_size_t k = 0; k < p_spilled_count; k++) {
+			combined.child[k] = p_node_id_map[combined.child[k]];
+			combined.parent[k] = p_node_id_map[combined.parent[k]];
+		}
+	}
+	
+	ret = tsk_edge_table_extend(&combined, p_edges, p_edges->num_rows, NULL, 0);
+	if (ret != 0) { tsk_edge_table_free(&combined); *p_error_call = "tsk_edge_table_extend"; return ret; }
+	
+	tsk_edge_table_free(p_edges);
+	*p_edges = combined;
+	return 0;
+}
+
+int Species::_SimplifyTreeSequence(TreeSeqInfo &tsinfo, const std::vector<tsk_id_t> &samples, std::string &p_error_message)
 {
 	// BEWARE!  This is an internal method, and should only be called from SimplifyAllTreeSequences()!
 	// It assumes that a variety of things will be done by the caller, and those things are not optional!
 	// With multiple chromosomes when running parallel, this will be called from inside a parallel region!
+	// For that reason it does not raise; on failure it returns the tskit error code and sets p_error_message,
+	// and the caller raises once it is back outside the parallel region.
 	
 	// sort the table collection
 	{
@@ -4970,11 +5437,13 @@ void Species::_SimplifyTreeSequence(TreeSeqInfo &tsinfo, const std::vector<tsk_i
 #else
 		// sort the tables using our own custom edge sorter, for additional speed through inlining of the comparison function
 		// see https://github.com/tskit-dev/tskit/pull/627, https://github.com/tskit-dev/tskit/pull/711
-		// FIXME for additional speed we could perhaps be smart about only sorting the portions of the edge table
-		// that need it, but the tricky thing is that all the old stuff has to be at the bottom of the table, not the top...
+		// the sorter only sorts the edges added since the last simplification, and merges them into the sorted prefix
+		// left by that simplification; the old stuff has to end up at the bottom of the table, so a merge is needed
 		tsk_table_sorter_t sorter;
 		int ret = tsk_table_sorter_init(&sorter, &tsinfo.tables_, /* flags */ flags);
-		if (ret != 0) handle_error("tsk_table_sorter_init", ret);
+		if (ret != 0) { p_error_message = std::string("tsk_table_sorter_init: ") + tsk_strerror(ret); return ret; }
+		
+		sorter.user_data = &tsinfo.simplified_edge_count_;
 		
 #ifdef _OPENMP
 		// When running multithreaded, we can parallelize the sorting work.  We do so only for single-chromosome models,
@@ -4990,19 +5459,21 @@ void Species::_SimplifyTreeSequence(TreeSeqInfo &tsinfo, const std::vector<tsk_i
 		try {
 			ret = tsk_table_sorter_run(&sorter, NULL);
 		} catch (std::exception &e) {
-			EIDOS_TERMINATION << "ERROR (Species::_SimplifyTreeSequence): (internal error) exception raised during tsk_table_sorter_run(): " << e.what() << "." << EidosTerminate();
+			tsk_table_sorter_free(&sorter);
+			p_error_message = std::string("ERROR (Species::_SimplifyTreeSequence): (internal error) exception raised during tsk_table_sorter_run(): ") + e.what() + ".";
+			return TSK_ERR_GENERIC;
 		}
-		if (ret != 0) handle_error("tsk_table_sorter_run", ret);
+		if (ret != 0) { tsk_table_sorter_free(&sorter); p_error_message = std::string("tsk_table_sorter_run: ") + tsk_strerror(ret); return ret; }
 		
-		tsk_table_sorter_free(&sorter);
-		if (ret != 0) handle_error("tsk_table_sorter_free", ret);
+		ret = tsk_table_sorter_free(&sorter);
+		if (ret != 0) { p_error_message = std::string("tsk_table_sorter_free: ") + tsk_strerror(ret); return ret; }
 #endif
 	}
 	
 	// remove redundant sites we added
 	{
 		int ret = tsk_table_collection_deduplicate_sites(&tsinfo.tables_, 0);
-		if (ret < 0) handle_error("tsk_table_collection_deduplicate_sites", ret);
+		if (ret < 0) { p_error_message = std::string("tsk_table_collection_deduplicate_sites: ") + tsk_strerror(ret); return ret; }
 	}
 	
 	// simplify
@@ -5025,13 +5496,14 @@ void Species::_SimplifyTreeSequence(TreeSeqInfo &tsinfo, const std::vector<tsk_i
 		flags |= TSK_SIMPLIFY_NO_FILTER_NODES | TSK_SIMPLIFY_NO_UPDATE_SAMPLE_FLAGS;
 		
 		int ret = tsk_table_collection_simplify(&tsinfo.tables_, samples.data(), (tsk_size_t)samples.size(), flags, NULL);
-		if (ret != 0) handle_error("tsk_table_collection_simplify", ret);
+		if (ret != 0) { p_error_message = std::string("tsk_table_collection_simplify: ") + tsk_strerror(ret); return ret; }
 		
 		EIDOS_BENCHMARK_END(EidosBenchmarkType::k_SIMPLIFY_CORE);
 	}
 	
 	// note that we leave things in a partially completed state; the nodes and individuals tables still
 	// need to be filtered!  that is the responsibility of the caller -- i.e., SimplifyAllTreeSequences().
+	return 0;
 }
 
 void Species::SimplifyAllTreeSequences(void)
@@ -5114,40 +5586,84 @@ void Species::SimplifyAllTreeSequences(void)
 	
 	WritePopulationTable(&main_tables);
 	
-	// simplify all of the tree sequences
-	// FIXME MULTICHROM: parallelize simplification here!
-	for (Chromosome *chromosome : chromosomes_)
+	// simplify all of the tree sequences; with multiple chromosomes this is done in parallel across chromosomes.
+	// Each chromosome's table collection is independent except for the shared tables, which simplification reads
+	// but does not modify (we pass TSK_SIMPLIFY_NO_FILTER_NODES, and no individual or population filtering).  We
+	// swap in the shared tables from the main tree sequence for all chromosomes before simplifying, since they are
+	// needed for simplify to work, and swap them out again afterwards; the filtering code below does not need them.
+	// Errors are recorded per chromosome and raised after the parallel region, in chromosome order.
+	int chromosome_count = (int)chromosomes_.size();
+	
+	// the node table needs to be filtered after simplification; we turn that off for simplification, so it can be parallelized.
+	// the node table is not changed by simplify, so we can allocate the buffers for filtering it now; see below.  With edge
+	// spilling, nodes referenced by edges get marked as each chromosome is simplified, since its edges are then spilled again.
+	const tsk_size_t num_nodes = main_tables.nodes.num_rows;
+	tsk_bool_t *keep_nodes = (tsk_bool_t *)calloc(num_nodes, sizeof(tsk_bool_t));	// note: cleared by calloc
+	tsk_id_t *node_id_map = (tsk_id_t *)malloc(num_nodes * sizeof(tsk_id_t));
+	
+	if (!keep_nodes || !node_id_map)
+		EIDOS_TERMINATION << "ERROR (Species::SimplifyAllTreeSequences): allocation failed; you may need to raise the memory limit for SLiM." << EidosTerminate(nullptr);
+	
+	if (edge_spill_directory_.length())
+	{
+		// When spilling edges, we simplify one chromosome at a time, so that only one chromosome's retained edges are
+		// in memory at once: read its spilled edges back in, simplify, mark the nodes its edges use, and spill again.
+		for (int chromosome_index = 0; chromosome_index < chromosome_count; ++chromosome_index)
+		{
+			TreeSeqInfo &chromosome_tsinfo = treeseq_[chromosome_index];
+			std::string simplify_error;
+			
+			RestoreSpilledTreeSeqEdges(chromosome_tsinfo);
+			
+			if (chromosome_index > 0)
+				CopySharedTablesIn(chromosome_tsinfo.tables_);
+			
+			int ret = _SimplifyTreeSequence(chromosome_tsinfo, samples, simplify_error);
+			
+			if (chromosome_index > 0)
+				DisconnectCopiedSharedTables(chromosome_tsinfo.tables_);
+			
+			if (ret != 0)
+				EIDOS_TERMINATION << simplify_error << EidosTerminate(nullptr);
+			
+			tsk_id_t *edges_child = chromosome_tsinfo.tables_.edges.child;
+			tsk_id_t *edges_parent = chromosome_tsinfo.tables_.edges.parent;
+			tsk_size_t edges_num_rows = chromosome_tsinfo.tables_.edges.num_rows;
+			
+			for (tsk_size_t k = 0; k < edges_num_rows; k++) {
+				keep_nodes[edges_child[k]] = true;
+				keep_nodes[edges_parent[k]] = true;
+			}
+			
+			SpillTreeSeqEdges(chromosome_tsinfo);
+		}
+	}
+	else
 	{
-		slim_chromosome_index_t chromosome_index = chromosome->Index();
-		TreeSeqInfo &chromosome_tsinfo = treeseq_[chromosome_index];
-		tsk_table_collection_t &chromosome_tables = chromosome_tsinfo.tables_;
+		std::vector<int> simplify_results(chromosome_count, 0);
+		std::vector<std::string> simplify_errors(chromosome_count);
 		
-		// swap in the shared tables from the main tree sequence; we need them for simplify to work, but
-		// simplify should not touch any of them, so it should be safe to simplify using them directly
-		if (chromosome_index > 0)
-			CopySharedTablesIn(chromosome_tables);
+		for (int chromosome_index = 1; chromosome_index < chromosome_count; ++chromosome_index)
+			CopySharedTablesIn(treeseq_[chromosome_index].tables_);
 		
-		// simplify
-		_SimplifyTreeSequence(chromosome_tsinfo, samples);
+		EIDOS_THREAD_COUNT(gEidos_OMP_threads_SIMPLIFY_CHROMOSOMES);
+#pragma omp parallel for schedule(dynamic, 1) default(none) shared(chromosome_count, samples, simplify_results, simplify_errors) if(chromosome_count >= EIDOS_OMPMIN_SIMPLIFY_CHROMOSOMES) num_threads(thread_count)
+		for (int chromosome_index = 0; chromosome_index < chromosome_count; ++chromosome_index)
+			simplify_results[chromosome_index] = _SimplifyTreeSequence(treeseq_[chromosome_index], samples, simplify_errors[chromosome_index]);
 		
-		// swap out the shared tables immediately after; the filtering code below does not need the shared tables
-		if (chromosome_index > 0)
-			DisconnectCopiedSharedTables(chromosome_tables);
-	}
-	
-	// the node table needs to be filtered now; we turned that off for simplification, so it could be parallelized.
-	// this code is copied from https://github.com/tskit-dev/tskit/pull/2665/files (multichrom_wright_fisher.c)
-	const tsk_size_t num_nodes = main_tables.nodes.num_rows;
+		for (int chromosome_index = 1; chromosome_index < chromosome_count; ++chromosome_index)
+			DisconnectCopiedSharedTables(treeseq_[chromosome_index].tables_);
+		
+		for (int chromosome_index = 0; chromosome_index < chromosome_count; ++chromosome_index)
+			if (simplify_results[chromosome_index] != 0)
+				EIDOS_TERMINATION << simplify_errors[chromosome_index] << EidosTerminate(nullptr);
+	}
 	
+	// filter the node table now.  this code is copied from https://github.com/tskit-dev/tskit/pull/2665/files (multichrom_wright_fisher.c)
 	if (num_nodes > 0)
 	{
 		tsk_size_t sample_count = (tsk_size_t)samples.size();
 		int ret;
-		tsk_bool_t *keep_nodes = (tsk_bool_t *)calloc(num_nodes, sizeof(tsk_bool_t));	// note: cleared by calloc
-		tsk_id_t *node_id_map = (tsk_id_t *)malloc(num_nodes * sizeof(tsk_id_t));
-		
-		if (!keep_nodes || !node_id_map)
-			EIDOS_TERMINATION << "ERROR (Species::SimplifyAllTreeSequences): allocation failed; you may need to raise the memory limit for SLiM." << EidosTerminate(nullptr);
 		
 		// mark the nodes we want to keep: samples (including remembered nodes), plus all nodes referenced by edges
 		for (tsk_size_t j = 0; j < sample_count; j++)
@@ -5196,6 +5712,10 @@ void Species::SimplifyAllTreeSequences(void)
 				edges_parent[k] = node_id_map[edges_parent[k]];
 			}
 			
+			// the edge table is now sorted, since node filtering preserves node order; the next simplification
+			// will only need to sort the edges added after this point, and merge them in
+			chromosome_tsinfo.simplified_edge_count_ = edges_num_rows;
+			
 			// remap in the mutations table also; Jerome's example didn't have mutations so it didn't do this
 			tsk_id_t *mutations_node = chromosome_tables.mutations.node;
 			tsk_size_t mutations_num_rows = chromosome_tables.mutations.num_rows;
@@ -5252,10 +5772,20 @@ void Species::SimplifyAllTreeSequences(void)
 			}
 		}
 		
-		free(keep_nodes);
-		free(node_id_map);
+		// spilled edges were written out before the node table was filtered, so their node ids still need remapping;
+		// we keep the map and apply it when they are next read back in, rather than rewriting the spill files now
+		if (edge_spill_directory_.length())
+		{
+			edge_spill_node_id_map_.assign(node_id_map, node_id_map + num_nodes);
+			
+			for (TreeSeqInfo &tsinfo : treeseq_)
+				tsinfo.spilled_edges_need_remap_ = (tsinfo.spilled_edge_count_ > 0);
+		}
 	}
 	
+	free(keep_nodes);
+	free(node_id_map);
+	
 	// the individual table needs to be filtered now; we no longer pass TSK_SIMPLIFY_FILTER_INDIVIDUALS for simplification,
 	// so it could be parallelized.  The code here is based on the node table filtering above, mutatis mutandis
 	const tsk_size_t num_individuals = main_tables.individuals.num_rows;
@@ -5361,6 +5891,15 @@ void Species::CheckCoalescenceAfterSimplification(TreeSeqInfo &tsinfo)
 	ret = tsk_table_collection_copy(&tsinfo.tables_, &tables_copy, 0);
 	if (ret < 0) handle_error("tsk_table_collection_copy", ret);
 	
+	// Edges spilled to disk need to be put back in the copy, ahead of the in-memory edges.
+	if (tsinfo.spilled_edge_count_ > 0)
+	{
+		const char *error_call = nullptr;
+		
+		ret = slim_prepend_spilled_edges(&tables_copy.edges, EdgeSpillPath(tsinfo).c_str(), tsinfo.spilled_edge_count_, tsinfo.spilled_edges_need_remap_ ? edge_spill_node_id_map_.data() : nullptr, &error_call);
+		if (ret != 0) handle_error(error_call, ret);
+	}
+	
 	// If tsinfo is not the main table collection (which has the shared tables), copy the shared tables in now.
 	// If it is the main table collection, it now has a deep copy of the population table, so it is fine.
 	if (tsinfo.chromosome_index_ > 0)
@@ -5535,6 +6074,101 @@ void Species::RecordTablePosition(void)
 		tsk_table_collection_record_num_rows(&tsinfo.tables_, &tsinfo.table_position_);
 }
 
+std::string Species::EdgeSpillPath(const TreeSeqInfo &p_tsinfo) const
+{
+	// the process id keeps concurrent runs sharing a spill directory from colliding
+	return edge_spill_directory_ + "/slim_edge_spill_" + std::to_string(getpid()) + "_" + std::to_string(species_id_) + "_" + std::to_string(p_tsinfo.chromosome_index_) + ".kas";
+}
+
+void Species::SpillTreeSeqEdges(TreeSeqInfo &p_tsinfo)
+{
+	// Write all of the (simplified, sorted) edges for a chromosome out to its spill file, and release the memory they used.
+	// Edges recorded after this point accumulate in memory as usual; the spilled edges are put back in front of them by
+	// RestoreSpilledTreeSeqEdges() for the next simplify, and are prepended to table copies made for output and checks.
+	tsk_edge_table_t &edges = p_tsinfo.tables_.edges;
+	
+	if (p_tsinfo.spilled_edge_count_ != 0)
+		EIDOS_TERMINATION << "ERROR (Species::SpillTreeSeqEdges): (internal error) edges spilled while a previous spill is outstanding." << EidosTerminate();
+	if (edges.metadata_length != 0)
+		EIDOS_TERMINATION << "ERROR (Species::SpillTreeSeqEdges): (internal error) edge metadata is not supported when spilling edges." << EidosTerminate();
+	
+	if (edges.num_rows == 0)
+		return;
+	
+	std::string spill_path = EdgeSpillPath(p_tsinfo);
+	kastore_t store;
+	
+	int ret = kastore_open(&store, spill_path.c_str(), "w", 0);
+	if (ret == 0) ret = kastore_puts_float64(&store, "edges/left", edges.left, (size_t)edges.num_rows, 0);
+	if (ret == 0) ret = kastore_puts_float64(&store, "edges/right", edges.right, (size_t)edges.num_rows, 0);
+	if (ret == 0) ret = kastore_puts_int32(&store, "edges/parent", edges.parent, (size_t)edges.num_rows, 0);
+	if (ret == 0) ret = kastore_puts_int32(&store, "edges/child", edges.child, (size_t)edges.num_rows, 0);
+	
+	int close_ret = kastore_close(&store);		// the file is written out by kastore_close()
+	if (ret == 0) ret = close_ret;
+	
+	if (ret != 0)
+		EIDOS_TERMINATION << "ERROR (Species::SpillTreeSeqEdges): could not write the edge spill file " << spill_path << " (" << kas_strerror(ret) << ")." << EidosTerminate();
+	
+	// replace the edge table with a new empty one, so its column buffers are actually freed
+	tsk_edge_table_t empty_edges;
+	
+	ret = tsk_edge_table_init(&empty_edges, edges.options);
+	if (ret != 0) handle_error("SpillTreeSeqEdges() tsk_edge_table_init", ret);
+	ret = tsk_edge_table_set_metadata_schema(&empty_edges, edges.metadata_schema, edges.metadata_schema_length);
+	if (ret != 0) handle_error("SpillTreeSeqEdges() tsk_edge_table_set_metadata_schema", ret);
+	
+	p_tsinfo.spilled_edge_count_ = edges.num_rows;
+	p_tsinfo.spilled_edges_need_remap_ = false;
+	p_tsinfo.simplified_edge_count_ = 0;
+	
+	tsk_edge_table_free(&edges);
+	edges = empty_edges;
+}
+
+void Species::RestoreSpilledTreeSeqEdges(TreeSeqInfo &p_tsinfo)
+{
+	// Read a chromosome's spilled edges back in, ahead of the edges recorded since they were spilled, and remove the spill file.
+	// This shifts the in-memory edges, so table_position_ must be re-recorded afterwards; SimplifyAllTreeSequences() does that.
+	if (p_tsinfo.spilled_edge_count_ == 0)
+		return;
+	
+	std::string spill_path = EdgeSpillPath(p_tsinfo);
+	const char *error_call = nullptr;
+	
+	int ret = slim_prepend_spilled_edges(&p_tsinfo.tables_.edges, spill_path.c_str(), p_tsinfo.spilled_edge_count_, p_tsinfo.spilled_edges_need_remap_ ? edge_spill_node_id_map_.data() : nullptr, &error_call);
+	if (ret != 0) handle_error(std::string("RestoreSpilledTreeSeqEdges() ") + error_call, ret);
+	
+	// the spilled edges were sorted by the simplify that spilled them, and remapping preserves that order
+	p_tsinfo.simplified_edge_count_ = p_tsinfo.spilled_edge_count_;
+	
+	DiscardSpilledTreeSeqEdges(p_tsinfo);
+}
+
+void Species::DiscardSpilledTreeSeqEdges(TreeSeqInfo &p_tsinfo)
+{
+	if (p_tsinfo.spilled_edge_count_ != 0)
+		remove(EdgeSpillPath(p_tsinfo).c_str());
+	
+	p_tsinfo.spilled_edge_count_ = 0;
+	p_tsinfo.spilled_edges_need_remap_ = false;
+}
+
+void Species::RestoreAllSpilledTreeSeqEdges(void)
+{
+	// Bring every chromosome's spilled edges back into memory and remove the spill files.  This is called before the process
+	// forks for -fork, since spill files are named by process id; each branch will spill again to its own files at its next
+	// simplify.  Edges recorded since the last simplify remain after the restored edges, as usual.
+	if (!recording_tree_)
+		return;
+	
+	for (TreeSeqInfo &tsinfo : treeseq_)
+	{
+		RestoreSpilledTreeSeqEdges(tsinfo);
+		tsk_table_collection_record_num_rows(&tsinfo.tables_, &tsinfo.table_position_);
+	}
+}
+
 void Species::AllocateTreeSequenceTables(void)
 {
 #if DEBUG
@@ -5572,6 +6206,9 @@ void Species::AllocateTreeSequenceTables(void)
 		tsinfo.tables_.sequence_length = (double)chromosome->last_position_ + 1;
 		tsinfo.chromosome_index_ = chromosome->Index();
 		tsinfo.last_coalescence_state_ = false;
+		tsinfo.simplified_edge_count_ = 0;
+		tsinfo.spilled_edge_count_ = 0;
+		tsinfo.spilled_edges_need_remap_ = false;
 		
 		first = false;
 	}
@@ -5593,6 +6230,15 @@ void Species::SetCurrentNewIndividual(__attribute__((unused))Individual *p_indiv
 	// but it seems to keep coming back, so I've kept the code for it...
 	//current_new_individual_ = p_individual;
 	
+	// When staging, just remember the new individual; its node table entries are made by MergeStagedTreeSeqRecording()
+	if (treeseq_staging_)
+	{
+		TreeSeqStagingBuffer &buffer = treeseq_staging_buffers_[omp_get_thread_num()];
+		
+		buffer.individuals_.emplace_back(TreeSeqStagedIndividual{p_individual, buffer.edges_.size(), buffer.null_haplosomes_.size(), buffer.derived_states_.size()});
+		return;
+	}
+	
 	// Remember the current table position so we can return to it later in RetractNewIndividual()
 	RecordTablePosition();
 	
@@ -5768,7 +6414,7 @@ void Species::RecordNewHaplosome(slim_position_t *p_breakpoints, int p_breakpoin
 	// associated chromosome
 	tsk_id_t offspringTSKID, haplosome1TSKID, haplosome2TSKID;
 	
-	offspringTSKID = p_new_haplosome->OwningIndividual()->TskitNodeIdBase() + p_new_haplosome->chromosome_subposition_;
+	offspringTSKID = p_new_haplosome->OwningIndividual()->TskitNodeIdBase() + p_new_haplosome->chromosome_subposition_;	// not yet valid when staging
 	haplosome1TSKID = p_initial_parental_haplosome->OwningIndividual()->TskitNodeIdBase() + p_initial_parental_haplosome->chromosome_subposition_;
 	if (!p_second_parental_haplosome)
 		haplosome2TSKID = haplosome1TSKID;
@@ -5779,7 +6425,9 @@ void Species::RecordNewHaplosome(slim_position_t *p_breakpoints, int p_breakpoin
 	if (p_breakpoints_count && (p_breakpoints[p_breakpoints_count - 1] > chromosome.last_position_))
 		p_breakpoints_count--;
 	
-	// add an edge for each interval between breakpoints
+	// add an edge for each interval between breakpoints; when staging, the child's node id is not yet known, so
+	// the edges are kept in this thread's staging buffer instead, for MergeStagedTreeSeqRecording()
+	TreeSeqStagingBuffer *staging_buffer = (treeseq_staging_ ? &treeseq_staging_buffers_[omp_get_thread_num()] : nullptr);
 	double left = 0.0;
 	double right;
 	bool polarity = true;
@@ -5800,16 +6448,31 @@ void Species::RecordNewHaplosome(slim_position_t *p_breakpoints, int p_breakpoin
 			EIDOS_TERMINATION << "ERROR (Species::RecordNewHaplosome): (internal error) a left==right breakpoint was passed to RecordNewHaplosome()." << EidosTerminate();
 #endif
 		
-		int ret = tsk_edge_table_add_row(&tsinfo.tables_.edges, left, right, parent, offspringTSKID, NULL, 0);
-		if (ret < 0) handle_error("tsk_edge_table_add_row", ret);
+		if (staging_buffer)
+		{
+			staging_buffer->edges_.emplace_back(TreeSeqStagedEdge{left, right, parent, p_new_haplosome});
+		}
+		else
+		{
+			int ret = tsk_edge_table_add_row(&tsinfo.tables_.edges, left, right, parent, offspringTSKID, NULL, 0);
+			if (ret < 0) handle_error("tsk_edge_table_add_row", ret);
+		}
 		
 		left = right;
 	}
 	
 	right = (double)chromosome.last_position_+1;
 	tsk_id_t parent = (tsk_id_t) (polarity ? haplosome1TSKID : haplosome2TSKID);
-	int ret = tsk_edge_table_add_row(&tsinfo.tables_.edges, left, right, parent, offspringTSKID, NULL, 0);
-	if (ret < 0) handle_error("tsk_edge_table_add_row", ret);
+	
+	if (staging_buffer)
+	{
+		staging_buffer->edges_.emplace_back(TreeSeqStagedEdge{left, right, parent, p_new_haplosome});
+	}
+	else
+	{
+		int ret = tsk_edge_table_add_row(&tsinfo.tables_.edges, left, right, parent, offspringTSKID, NULL, 0);
+		if (ret < 0) handle_error("tsk_edge_table_add_row", ret);
+	}
 }
 
 void Species::RecordNewHaplosome_NULL(Haplosome *p_new_haplosome)
@@ -5831,6 +6494,13 @@ void Species::RecordNewHaplosome_NULL(Haplosome *p_new_haplosome)
 		EIDOS_TERMINATION << "ERROR (Species::RecordNewHaplosome): (internal error) p_new_haplosome is not a null haplosome." << EidosTerminate();
 #endif
 	
+	// When staging, the node table entries to patch do not exist yet; MergeStagedTreeSeqRecording() calls us again
+	if (treeseq_staging_)
+	{
+		treeseq_staging_buffers_[omp_get_thread_num()].null_haplosomes_.emplace_back(p_new_haplosome);
+		return;
+	}
+	
 	{
 		slim_chromosome_index_t chromosome_index = p_new_haplosome->chromosome_index_;
 		Chromosome &chromosome = *chromosomes_[chromosome_index];
@@ -5882,16 +6552,22 @@ void Species::RecordNewDerivedState(const Haplosome *p_haplosome, slim_position_
 	if (p_haplosome->IsNull())
 		EIDOS_TERMINATION << "ERROR (Species::RecordNewDerivedState): new derived states cannot be recorded for null haplosomes." << EidosTerminate();
 	
-	tsk_id_t haplosomeTSKID = p_haplosome->OwningIndividual()->TskitNodeIdBase() + p_haplosome->chromosome_subposition_;
-	slim_chromosome_index_t index = p_haplosome->chromosome_index_;
-	TreeSeqInfo &tsinfo = treeseq_[index];
-
-	// Identify any previous mutations at this site in this haplosome, and add a new site.
-	// This site may already exist, but we add it anyway, and deal with that in deduplicate_sites().
-	double tsk_position = (double) p_position;
-
-	tsk_id_t site_id = tsk_site_table_add_row(&tsinfo.tables_.sites, tsk_position, NULL, 0, NULL, 0);
-	if (site_id < 0) handle_error("tsk_site_table_add_row", site_id);
+	// When staging, copy the derived state out into this thread's staging buffer; MergeStagedTreeSeqRecording() records it
+	if (treeseq_staging_)
+	{
+		TreeSeqStagingBuffer &buffer = treeseq_staging_buffers_[omp_get_thread_num()];
+		MutationMetadataRec metadata_rec;
+		
+		buffer.derived_states_.emplace_back(TreeSeqStagedDerivedState{p_haplosome, p_position, buffer.mutation_ids_.size(), p_derived_mutations.size()});
+		
+		for (Mutation *mutation : p_derived_mutations)
+		{
+			buffer.mutation_ids_.emplace_back(mutation->mutation_id_);
+			MetadataForMutation(mutation, &metadata_rec);
+			buffer.mutation_metadata_.emplace_back(metadata_rec);
+		}
+		return;
+	}
 	
 	// form derived state
 	THREAD_SAFETY_IN_ACTIVE_PARALLEL("Species::RecordNewDerivedState(): usage of statics");
@@ -5909,6 +6585,26 @@ void Species::RecordNewDerivedState(const Haplosome *p_haplosome, slim_position_
 		mutation_metadata.emplace_back(metadata_rec);
 	}
 	
+	_RecordNewDerivedState(p_haplosome, p_position, derived_mutation_ids, mutation_metadata);
+}
+
+void Species::_RecordNewDerivedState(const Haplosome *p_haplosome, slim_position_t p_position, std::vector<slim_mutationid_t> &p_derived_mutation_ids, std::vector<MutationMetadataRec> &p_mutation_metadata)
+{
+	// This does the table work for RecordNewDerivedState(), given the derived state's mutation ids and metadata; it
+	// is also used by MergeStagedTreeSeqRecording().  The fixed mutations at the position are appended to the vectors.
+	tsk_id_t haplosomeTSKID = p_haplosome->OwningIndividual()->TskitNodeIdBase() + p_haplosome->chromosome_subposition_;
+	slim_chromosome_index_t index = p_haplosome->chromosome_index_;
+	TreeSeqInfo &tsinfo = treeseq_[index];
+
+	// Identify any previous mutations at this site in this haplosome, and add a new site.
+	// This site may already exist, but we add it anyway, and deal with that in deduplicate_sites().
+	double tsk_position = (double) p_position;
+
+	tsk_id_t site_id = tsk_site_table_add_row(&tsinfo.tables_.sites, tsk_position, NULL, 0, NULL, 0);
+	if (site_id < 0) handle_error("tsk_site_table_add_row", site_id);
+	
+	MutationMetadataRec metadata_rec;
+	
 	// find and incorporate any fixed mutations at this position, which exist in all new derived states but are not included by SLiM
 	// BCH 5/14/2019: Note that this means that derived states will be recorded that look "stacked" even when those mutations would
 	// not have stacked, by the stacking policy, had they occurred in the same haplosome at the same time.  So this is a bit weird.
@@ -5922,9 +6618,13 @@ void Species::RecordNewDerivedState(const Haplosome *p_haplosome, slim_position_
 	{
 		Substitution *substitution = position_iter->second;
 		
-		derived_mutation_ids.emplace_back(substitution->mutation_id_);
+		// the multimap is keyed by position alone, so it contains fixed mutations on other chromosomes too
+		if (substitution->chromosome_index_ != p_haplosome->chromosome_index_)
+			continue;
+		
+		p_derived_mutation_ids.emplace_back(substitution->mutation_id_);
 		MetadataForSubstitution(substitution, &metadata_rec);
-		mutation_metadata.emplace_back(metadata_rec);
+		p_mutation_metadata.emplace_back(metadata_rec);
 	}
 	
 	// check for time consistency, using the shared node table in treeseq_[0]; this used to be a DEBUG check, but
@@ -5938,10 +6638,10 @@ void Species::RecordNewDerivedState(const Haplosome *p_haplosome, slim_position_
 		EIDOS_TERMINATION << "ERROR (Species::RecordNewDerivedState): a mutation is being added with an invalid timestamp, greater than the time of the tree sequence node to which it belongs.  This can happen if you use addSubpopSplit() to split a new subpop from an old subpop, and then try to add a new mutation to the old subpop in the same tick.  That would imply that descendants of the old subpop ought to possess the new mutation -- but they don't, because the new subpop was already split off.  It therefore creates an inconsistency in the tree sequence.  Either add the new mutation prior to the split, or wait until the next tick to add the new mutation at a time that is clearly post-split.  (Details: invalid derived state recorded in tick " << community_.Tick() << ", haplosome " << haplosomeTSKID << ", id " << p_haplosome->haplosome_id_ << ", with time " << time << " >= " << tsinfo0.tables_.nodes.time[haplosomeTSKID] << ")." << EidosTerminate();
 	
 	// add the mutation table row with the final derived state and metadata
-	char *derived_muts_bytes = (char *)(derived_mutation_ids.data());
-	size_t derived_state_length = derived_mutation_ids.size() * sizeof(slim_mutationid_t);
-	char *mutation_metadata_bytes = (char *)(mutation_metadata.data());
-	size_t mutation_metadata_length = mutation_metadata.size() * sizeof(MutationMetadataRec);
+	char *derived_muts_bytes = (char *)(p_derived_mutation_ids.data());
+	size_t derived_state_length = p_derived_mutation_ids.size() * sizeof(slim_mutationid_t);
+	char *mutation_metadata_bytes = (char *)(p_mutation_metadata.data());
+	size_t mutation_metadata_length = p_mutation_metadata.size() * sizeof(MutationMetadataRec);
 	
 	int ret = tsk_mutation_table_add_row(&tsinfo.tables_.mutations, site_id, haplosomeTSKID, TSK_NULL, 
 					time,
@@ -5950,6 +6650,105 @@ void Species::RecordNewDerivedState(const Haplosome *p_haplosome, slim_position_
 	if (ret < 0) handle_error("tsk_mutation_table_add_row", ret);
 }
 
+void Species::BeginStagedTreeSeqRecording(void)
+{
+#if DEBUG
+	if (!recording_tree_)
+		EIDOS_TERMINATION << "ERROR (Species::BeginStagedTreeSeqRecording): (internal error) tree sequence recording method called with recording off." << EidosTerminate();
+	if (treeseq_staging_)
+		EIDOS_TERMINATION << "ERROR (Species::BeginStagedTreeSeqRecording): (internal error) tree sequence staging is already active." << EidosTerminate();
+#endif
+	
+	// This is called before reproduction goes parallel.  Until MergeStagedTreeSeqRecording() is called, the methods
+	// above append to a per-thread staging buffer instead of touching the shared tables, so no locking is needed.
+	THREAD_SAFETY_IN_ANY_PARALLEL("Species::BeginStagedTreeSeqRecording(): buffer allocation");
+	
+	if (treeseq_staging_buffers_.size() < (size_t)gEidosMaxThreads)
+		treeseq_staging_buffers_.resize(gEidosMaxThreads);
+	
+	treeseq_staging_ = true;
+}
+
+void Species::MergeStagedTreeSeqRecording(void)
+{
+#if DEBUG
+	if (!treeseq_staging_)
+		EIDOS_TERMINATION << "ERROR (Species::MergeStagedTreeSeqRecording): (internal error) tree sequence staging is not active." << EidosTerminate();
+#endif
+	
+	// This is called after parallel reproduction has finished.  The staged individuals are replayed in order of
+	// pedigree id, which is the order in which a single-threaded run would have created them, so node ids, edges,
+	// and mutations end up exactly as they would without staging.  Each thread creates its individuals in
+	// increasing pedigree id order, so this could be a k-way merge, but a sort of the gathered ids is simpler.
+	THREAD_SAFETY_IN_ANY_PARALLEL("Species::MergeStagedTreeSeqRecording(): table modification");
+	
+	treeseq_staging_ = false;
+	
+	std::vector<std::pair<slim_pedigreeid_t, std::pair<size_t, size_t>>> merge_order;	// (pedigree id, (buffer index, individual index))
+	
+	for (size_t buffer_index = 0; buffer_index < treeseq_staging_buffers_.size(); ++buffer_index)
+	{
+		std::vector<TreeSeqStagedIndividual> &staged_individuals = treeseq_staging_buffers_[buffer_index].individuals_;
+		
+		for (size_t individual_index = 0; individual_index < staged_individuals.size(); ++individual_index)
+			merge_order.emplace_back(staged_individuals[individual_index].individual_->PedigreeID(), std::pair<size_t, size_t>(buffer_index, individual_index));
+	}
+	
+	std::sort(merge_order.begin(), merge_order.end());
+	
+	std::vector<slim_mutationid_t> derived_mutation_ids;
+	std::vector<MutationMetadataRec> mutation_metadata;
+	
+	for (auto &merge_entry : merge_order)
+	{
+		TreeSeqStagingBuffer &buffer = treeseq_staging_buffers_[merge_entry.second.first];
+		size_t individual_index = merge_entry.second.second;
+		TreeSeqStagedIndividual &staged_individual = buffer.individuals_[individual_index];
+		bool is_last = (individual_index + 1 == buffer.individuals_.size());
+		size_t edges_end = is_last ? buffer.edges_.size() : buffer.individuals_[individual_index + 1].first_edge_;
+		size_t null_haplosomes_end = is_last ? buffer.null_haplosomes_.size() : buffer.individuals_[individual_index + 1].first_null_haplosome_;
+		size_t derived_states_end = is_last ? buffer.derived_states_.size() : buffer.individuals_[individual_index + 1].first_derived_state_;
+		
+		// make the node table entries, which sets the individual's node id base
+		SetCurrentNewIndividual(staged_individual.individual_);
+		
+		for (size_t edge_index = staged_individual.first_edge_; edge_index < edges_end; ++edge_index)
+		{
+			TreeSeqStagedEdge &edge = buffer.edges_[edge_index];
+			const Haplosome *child_haplosome = edge.child_haplosome_;
+			tsk_id_t offspringTSKID = child_haplosome->OwningIndividual()->TskitNodeIdBase() + child_haplosome->chromosome_subposition_;
+			
+			int ret = tsk_edge_table_add_row(&treeseq_[child_haplosome->chromosome_index_].tables_.edges, edge.left_, edge.right_, edge.parent_, offspringTSKID, NULL, 0);
+			if (ret < 0) handle_error("tsk_edge_table_add_row", ret);
+		}
+		
+		for (size_t null_index = staged_individual.first_null_haplosome_; null_index < null_haplosomes_end; ++null_index)
+			RecordNewHaplosome_NULL(buffer.null_haplosomes_[null_index]);
+		
+		for (size_t derived_index = staged_individual.first_derived_state_; derived_index < derived_states_end; ++derived_index)
+		{
+			TreeSeqStagedDerivedState &derived_state = buffer.derived_states_[derived_index];
+			size_t first_mutation = derived_state.first_mutation_;
+			size_t last_mutation = first_mutation + derived_state.mutation_count_;
+			
+			derived_mutation_ids.assign(buffer.mutation_ids_.begin() + first_mutation, buffer.mutation_ids_.begin() + last_mutation);
+			mutation_metadata.assign(buffer.mutation_metadata_.begin() + first_mutation, buffer.mutation_metadata_.begin() + last_mutation);
+			
+			_RecordNewDerivedState(derived_state.haplosome_, derived_state.position_, derived_mutation_ids, mutation_metadata);
+		}
+	}
+	
+	for (TreeSeqStagingBuffer &buffer : treeseq_staging_buffers_)
+	{
+		buffer.individuals_.resize(0);
+		buffer.edges_.resize(0);
+		buffer.null_haplosomes_.resize(0);
+		buffer.derived_states_.resize(0);
+		buffer.mutation_ids_.resize(0);
+		buffer.mutation_metadata_.resize(0);
+	}
+}
+
 void Species::CheckAutoSimplification(void)
 {
 #if DEBUG
@@ -5989,7 +6788,7 @@ void Species::CheckAutoSimplification(void)
 			for (TreeSeqInfo &tsinfo : treeseq_)
 			{
 				old_table_size += (uint64_t)tsinfo.tables_.nodes.num_rows;
-				old_table_size += (uint64_t)tsinfo.tables_.edges.num_rows;
+				old_table_size += (uint64_t)tsinfo.tables_.edges.num_rows + (uint64_t)tsinfo.spilled_edge_count_;
 				old_table_size += (uint64_t)tsinfo.tables_.sites.num_rows;
 				old_table_size += (uint64_t)tsinfo.tables_.mutations.num_rows;
 			}
@@ -5999,7 +6798,7 @@ void Species::CheckAutoSimplification(void)
 			for (TreeSeqInfo &tsinfo : treeseq_)
 			{
 				new_table_size += (uint64_t)tsinfo.tables_.nodes.num_rows;
-				new_table_size += (uint64_t)tsinfo.tables_.edges.num_rows;
+				new_table_size += (uint64_t)tsinfo.tables_.edges.num_rows + (uint64_t)tsinfo.spilled_edge_count_;
 				new_table_size += (uint64_t)tsinfo.tables_.sites.num_rows;
 				new_table_size += (uint64_t)tsinfo.tables_.mutations.num_rows;
 			}
@@ -7381,6 +8180,45 @@ void Species::_CreateDirectoryForMultichromArchive(std::string resolved_user_pat
 		EIDOS_TERMINATION << "ERROR (Species::WriteTreeSequence): directory could not be created at path " << resolved_user_path << ", for unknown reasons." << EidosTerminate();
 }
 
+// Copies p_tables into p_output_tables (which must be zero-filled), and does the tskit-level preparation of the copy
+// for output: sorting and deduplicating sites if requested (not needed after simplification, which does those steps),
+// building the index, and computing mutation parents.  This is called inside a parallel region by WriteTreeSequence(),
+// so it does not raise; on failure it returns a tskit error code and points p_error_call at the name of the failing call.
+static int slim_copy_tables_for_output(tsk_table_collection_t *p_tables, tsk_table_collection_t *p_output_tables, bool p_sort, const char *p_spill_path, tsk_size_t p_spilled_count, const tsk_id_t *p_node_id_map, const char **p_error_call)
+{
+	int ret = tsk_table_collection_copy(p_tables, p_output_tables, 0);
+	if (ret < 0) { *p_error_call = "tsk_table_collection_copy"; return ret; }
+	
+	// Assemble the full edge table from any edges spilled to disk, followed by the in-memory edges recorded since
+	if (p_spilled_count > 0)
+	{
+		ret = slim_prepend_spilled_edges(&p_output_tables->edges, p_spill_path, p_spilled_count, p_node_id_map, p_error_call);
+		if (ret != 0) return ret;
+	}
+	
+	if (p_sort)
+	{
+		int flags = TSK_NO_CHECK_INTEGRITY;
+#if DEBUG
+		flags = 0;
+#endif
+		ret = tsk_table_collection_sort(p_output_tables, /* edge_start */ NULL, /* flags */ flags);
+		if (ret < 0) { *p_error_call = "tsk_table_collection_sort"; return ret; }
+		
+		// Remove redundant sites we added
+		ret = tsk_table_collection_deduplicate_sites(p_output_tables, 0);
+		if (ret < 0) { *p_error_call = "tsk_table_collection_deduplicate_sites"; return ret; }
+	}
+	
+	// Add in the mutation.parent information; valid tree sequences need parents, but we don't keep them while running
+	ret = tsk_table_collection_build_index(p_output_tables, 0);
+	if (ret < 0) { *p_error_call = "tsk_table_collection_build_index"; return ret; }
+	ret = tsk_table_collection_compute_mutation_parents(p_output_tables, TSK_NO_CHECK_INTEGRITY);
+	if (ret < 0) { *p_error_call = "tsk_table_collection_compute_mutation_parents"; return ret; }
+	
+	return 0;
+}
+
 void Species::WriteTreeSequence(std::string &p_recording_tree_path, bool p_simplify, bool p_include_model, EidosDictionaryUnretained *p_metadata_dict, bool p_overwrite_directory)
 {
 	int ret = 0;
@@ -7399,7 +8237,9 @@ void Species::WriteTreeSequence(std::string &p_recording_tree_path, bool p_simpl
 	if (is_multichrom)
 	{
 		// For a multichromosome archive, we need to create the directory to hold it.  This call
-		// will raise if there are any problems in doing so.
+		// will raise if there are any problems in doing so.  Pending asynchronous writes might
+		// target the directory we are about to replace, so they need to complete first.
+		Eidos_WaitForAsyncFileWrites();
 		_CreateDirectoryForMultichromArchive(resolved_user_path, p_overwrite_directory);
 	}
 	
@@ -7421,127 +8261,175 @@ void Species::WriteTreeSequence(std::string &p_recording_tree_path, bool p_simpl
 		SimplifyAllTreeSequences();
 	}
 	
-	for (Chromosome *chromosome : chromosomes_)
+	// With multiple chromosomes, the tskit-level work of output -- copying the tables, sorting them if we did not
+	// simplify, indexing them, computing mutation parents, and dumping them -- is done in parallel across chromosomes.
+	// The rest of the work consults SLiM and Eidos state, and is done serially.  Each chromosome in flight holds a
+	// complete copy of its tables, so we work in batches no larger than the TREESEQ_OUTPUT thread count; with one
+	// thread, only one copy exists at a time, as before.  Errors in parallel regions are deferred until afterwards.
+	int chromosome_count = (int)chromosomes_.size();
+	int batch_size = 1;
+	
+#ifdef _OPENMP
 	{
-		slim_chromosome_index_t chromosome_index = chromosome->Index();
-		TreeSeqInfo &chromosome_tsinfo = treeseq_[chromosome_index];
-		tsk_table_collection_t &chromosome_tables = chromosome_tsinfo.tables_;
-		
-		// Copy in the shared tables (node, individual, population) at this point, so the shared tables then get
-		// copied below; we will be modifying the tables, and don't want our modification to go into the original
-		// shared tables, which we are not allowed to change.
-		if (chromosome_index > 0)
-			CopySharedTablesIn(chromosome_tables);
-		
-		// Copy the table collection so that modifications we do for writing don't affect the original tables.
-		// Note that there's a lot of work below to clean up the individuals table and node table for saving.
-		// Those tables are shared.  We don't want to do this cleanup in the original tables, since that would
-		// modify our recording state I guess; but I think this cleanup will be the same for every chromosome,
-		// so technically we could do this work just once, I think (?), and share the processed tables across
-		// all the chromosomes.  I've chosen not to pursue that idea, because I don't see a path to doing it
-		// without increasing the high-water mark for the memory usage of this code, which is very important
-		// to keep low.  Anyhow, maybe this is unimportant since it is only overhead at save time, and is
-		// probably not a hotspot.
-		tsk_table_collection_t output_tables;
-		ret = tsk_table_collection_copy(&chromosome_tables, &output_tables, 0);
-		if (ret < 0) handle_error("tsk_table_collection_copy", ret);
-		
-		// We can unshare the shared tables in the original table collection immediately, zeroing them out.
-		if (chromosome_index > 0)
-			DisconnectCopiedSharedTables(chromosome_tables);
-		
-		// Sort and deduplicate; we don't need to do this if we simplified above, since simplification does these steps
-		if (!p_simplify)
-		{
-			int flags = TSK_NO_CHECK_INTEGRITY;
-#if DEBUG
-			flags = 0;
+		EIDOS_THREAD_COUNT(gEidos_OMP_threads_TREESEQ_OUTPUT);
+		batch_size = std::max(thread_count, 1);
+	}
 #endif
-			ret = tsk_table_collection_sort(&output_tables, /* edge_start */ NULL, /* flags */ flags);
-			if (ret < 0) handle_error("tsk_table_collection_sort", ret);
-			
-			// Remove redundant sites we added
-			ret = tsk_table_collection_deduplicate_sites(&output_tables, 0);
-			if (ret < 0) handle_error("tsk_table_collection_deduplicate_sites", ret);
-		}
-		
-		// Add in the mutation.parent information; valid tree sequences need parents, but we don't keep them while running
-		ret = tsk_table_collection_build_index(&output_tables, 0);
-		if (ret < 0) handle_error("tsk_table_collection_build_index", ret);
-		ret = tsk_table_collection_compute_mutation_parents(&output_tables, TSK_NO_CHECK_INTEGRITY);
-		if (ret < 0) handle_error("tsk_table_collection_compute_mutation_parents", ret);
+	
+	for (int batch_start = 0; batch_start < chromosome_count; batch_start += batch_size)
+	{
+		int batch_count = std::min(batch_size, chromosome_count - batch_start);
+		std::vector<tsk_table_collection_t *> batch_tables(batch_count, nullptr);
+		std::vector<std::string> batch_paths(batch_count);
+		std::vector<std::string> batch_spill_paths(batch_count);
+		std::vector<int> batch_results(batch_count, 0);
+		std::vector<const char *> batch_error_calls(batch_count, nullptr);
 		
+		for (int batch_index = 0; batch_index < batch_count; ++batch_index)
 		{
-			// Create a local hash table for pedigree IDs to individuals table indices.  If we simplified, that validated
-			// tabled_individuals_hash_ as a side effect, so we can copy that as a base; otherwise, we make one from scratch.
-			// Note that this hash table is used only for AddLiveIndividualsToIndividualsTable() below; after that we reorder
-			// the individuals table, so we'll make another hash table for AddParentsColumnForOutput(), unfortunately.
-			INDIVIDUALS_HASH local_individuals_lookup;
+			slim_chromosome_index_t chromosome_index = chromosomes_[batch_start + batch_index]->Index();
 			
-			if (p_simplify)
-				local_individuals_lookup = tabled_individuals_hash_;		// copies
-			else
-				BuildTabledIndividualsHash(&output_tables, &local_individuals_lookup);
+			// Copy in the shared tables (node, individual, population) at this point, so the shared tables then get
+			// copied below; we will be modifying the tables, and don't want our modification to go into the original
+			// shared tables, which we are not allowed to change.
+			if (chromosome_index > 0)
+				CopySharedTablesIn(treeseq_[chromosome_index].tables_);
+			
+			// Copy the table collection so that modifications we do for writing don't affect the original tables.
+			// Note that there's a lot of work below to clean up the individuals table and node table for saving.
+			// Those tables are shared.  We don't want to do this cleanup in the original tables, since that would
+			// modify our recording state I guess; but I think this cleanup will be the same for every chromosome,
+			// so technically we could do this work just once, I think (?), and share the processed tables across
+			// all the chromosomes.  I've chosen not to pursue that idea, because I don't see a path to doing it
+			// without increasing the high-water mark for the memory usage of this code, which is very important
+			// to keep low.  Anyhow, maybe this is unimportant since it is only overhead at save time, and is
+			// probably not a hotspot.
+			// The copy is allocated on the heap, so that with asynchronous file writing it can be handed off to the writer thread.
+			// It is zero-filled so that it can be freed safely even if the copy below fails.
+			batch_tables[batch_index] = (tsk_table_collection_t *)calloc(1, sizeof(tsk_table_collection_t));
 			
-			// Add information about the current cycle to the individual table; 
-			// this modifies "remembered" individuals, since information comes from the
-			// time of output, not creation
-			AddLiveIndividualsToIndividualsTable(&output_tables, &local_individuals_lookup);
+			if (!batch_tables[batch_index])
+				EIDOS_TERMINATION << "ERROR (Species::WriteTreeSequence): allocation failed; you may need to raise the memory limit for SLiM." << EidosTerminate();
+			
+			if (treeseq_[chromosome_index].spilled_edge_count_ > 0)
+				batch_spill_paths[batch_index] = EdgeSpillPath(treeseq_[chromosome_index]);
 		}
 		
-		// We need the individual table's order, for alive individuals, to match that of
-		// SLiM so that when we read back in it doesn't cause a reordering as a side effect
-		// all other individuals in the table will be retained, at the end
-		std::vector<int> individual_map;
-		
-		for (const std::pair<const slim_objectid_t,Subpopulation*> &subpop_pair : population_.subpops_)
 		{
-			Subpopulation *subpop = subpop_pair.second;
-			
-			for (Individual *individual : subpop->parent_individuals_)
+			EIDOS_THREAD_COUNT(gEidos_OMP_threads_TREESEQ_OUTPUT);
+#pragma omp parallel for schedule(dynamic, 1) default(none) shared(batch_start, batch_count, batch_tables, batch_spill_paths, batch_results, batch_error_calls, p_simplify) if(batch_count >= EIDOS_OMPMIN_TREESEQ_OUTPUT) num_threads(thread_count)
+			for (int batch_index = 0; batch_index < batch_count; ++batch_index)
 			{
-				tsk_id_t node_id = individual->TskitNodeIdBase();
-				tsk_id_t ind_id = output_tables.nodes.individual[node_id];
+				slim_chromosome_index_t chromosome_index = chromosomes_[batch_start + batch_index]->Index();
+				TreeSeqInfo &chromosome_tsinfo = treeseq_[chromosome_index];
+				const tsk_id_t *node_id_map = (chromosome_tsinfo.spilled_edges_need_remap_ ? edge_spill_node_id_map_.data() : nullptr);
 				
-				individual_map.emplace_back(ind_id);
+				batch_results[batch_index] = slim_copy_tables_for_output(&chromosome_tsinfo.tables_, batch_tables[batch_index], !p_simplify, batch_spill_paths[batch_index].c_str(), chromosome_tsinfo.spilled_edge_count_, node_id_map, &batch_error_calls[batch_index]);
 			}
 		}
 		
-		ReorderIndividualTable(&output_tables, individual_map, true);
-		
-		// Now that the table is reordered, we can build the parents column of the individuals table
-		// This requires a new pedigree id to tskid lookup table, which we construct here.
+		// We can unshare the shared tables in the original table collections immediately, zeroing them out.
+		for (int batch_index = 0; batch_index < batch_count; ++batch_index)
 		{
-			INDIVIDUALS_HASH local_individuals_lookup;
+			slim_chromosome_index_t chromosome_index = chromosomes_[batch_start + batch_index]->Index();
 			
-			BuildTabledIndividualsHash(&output_tables, &local_individuals_lookup);
-			AddParentsColumnForOutput(&output_tables, &local_individuals_lookup);
+			if (chromosome_index > 0)
+				DisconnectCopiedSharedTables(treeseq_[chromosome_index].tables_);
 		}
 		
-		// Rebase the times in the nodes to be in tskit-land; see _InstantiateSLiMObjectsFromTables() for the inverse operation
-		// BCH 4/4/2019: switched to using tree_seq_tick_ to avoid a parent/child timestamp conflict
-		// This makes sense; as far as tree-seq recording is concerned, tree_seq_tick_ is the time counter
-		slim_tick_t time_adjustment = community_.tree_seq_tick_;
-		
-		for (size_t node_index = 0; node_index < output_tables.nodes.num_rows; ++node_index)
-			output_tables.nodes.time[node_index] += time_adjustment;
-		
-		for (size_t mut_index = 0; mut_index < output_tables.mutations.num_rows; ++mut_index)
-			output_tables.mutations.time[mut_index] += time_adjustment;
-		
-		// Add a row to the Provenance table to record current state; text format does not allow newlines in the entry,
-		// so we don't prettyprint the JSON when going to text, as a quick fix that avoids quoting the newlines etc.
-		WriteProvenanceTable(&output_tables, /* p_use_newlines */ true, p_include_model, chromosome->Index());
-		
-		// Add top-level metadata and metadata schema
-		WriteTreeSequenceMetadata(&output_tables, p_metadata_dict, chromosome->Index());
-		
-		// Set the simulation time unit, in case that is useful to someone.  This is set up in initializeTreeSeq().
-		ret = tsk_table_collection_set_time_units(&output_tables, community_.treeseq_time_unit_.c_str(), community_.treeseq_time_unit_.length());
-		if (ret < 0) handle_error("tsk_table_collection_set_time_units", ret);
+		for (int batch_index = 0; batch_index < batch_count; ++batch_index)
+		{
+			if (batch_results[batch_index] < 0)
+			{
+				int error = batch_results[batch_index];
+				const char *error_call = batch_error_calls[batch_index];
+				
+				for (tsk_table_collection_t *output_tables_ptr : batch_tables)
+				{
+					tsk_table_collection_free(output_tables_ptr);
+					free(output_tables_ptr);
+				}
+				
+				handle_error(error_call, error);
+			}
+		}
 		
-		// Write out the copied tables
+		for (int batch_index = 0; batch_index < batch_count; ++batch_index)
 		{
+			Chromosome *chromosome = chromosomes_[batch_start + batch_index];
+			TreeSeqInfo &chromosome_tsinfo = treeseq_[chromosome->Index()];
+			tsk_table_collection_t *output_tables_ptr = batch_tables[batch_index];
+			tsk_table_collection_t &output_tables = *output_tables_ptr;
+			
+			{
+				// Create a local hash table for pedigree IDs to individuals table indices.  If we simplified, that validated
+				// tabled_individuals_hash_ as a side effect, so we can copy that as a base; otherwise, we make one from scratch.
+				// Note that this hash table is used only for AddLiveIndividualsToIndividualsTable() below; after that we reorder
+				// the individuals table, so we'll make another hash table for AddParentsColumnForOutput(), unfortunately.
+				INDIVIDUALS_HASH local_individuals_lookup;
+				
+				if (p_simplify)
+					local_individuals_lookup = tabled_individuals_hash_;		// copies
+				else
+					BuildTabledIndividualsHash(&output_tables, &local_individuals_lookup);
+				
+				// Add information about the current cycle to the individual table; 
+				// this modifies "remembered" individuals, since information comes from the
+				// time of output, not creation
+				AddLiveIndividualsToIndividualsTable(&output_tables, &local_individuals_lookup);
+			}
+			
+			// We need the individual table's order, for alive individuals, to match that of
+			// SLiM so that when we read back in it doesn't cause a reordering as a side effect
+			// all other individuals in the table will be retained, at the end
+			std::vector<int> individual_map;
+			
+			for (const std::pair<const slim_objectid_t,Subpopulation*> &subpop_pair : population_.subpops_)
+			{
+				Subpopulation *subpop = subpop_pair.second;
+				
+				for (Individual *individual : subpop->parent_individuals_)
+				{
+					tsk_id_t node_id = individual->TskitNodeIdBase();
+					tsk_id_t ind_id = output_tables.nodes.individual[node_id];
+					
+					individual_map.emplace_back(ind_id);
+				}
+			}
+			
+			ReorderIndividualTable(&output_tables, individual_map, true);
+			
+			// Now that the table is reordered, we can build the parents column of the individuals table
+			// This requires a new pedigree id to tskid lookup table, which we construct here.
+			{
+				INDIVIDUALS_HASH local_individuals_lookup;
+				
+				BuildTabledIndividualsHash(&output_tables, &local_individuals_lookup);
+				AddParentsColumnForOutput(&output_tables, &local_individuals_lookup);
+			}
+			
+			// Rebase the times in the nodes to be in tskit-land; see _InstantiateSLiMObjectsFromTables() for the inverse operation
+			// BCH 4/4/2019: switched to using tree_seq_tick_ to avoid a parent/child timestamp conflict
+			// This makes sense; as far as tree-seq recording is concerned, tree_seq_tick_ is the time counter
+			slim_tick_t time_adjustment = community_.tree_seq_tick_;
+			
+			for (size_t node_index = 0; node_index < output_tables.nodes.num_rows; ++node_index)
+				output_tables.nodes.time[node_index] += time_adjustment;
+			
+			for (size_t mut_index = 0; mut_index < output_tables.mutations.num_rows; ++mut_index)
+				output_tables.mutations.time[mut_index] += time_adjustment;
+			
+			// Add a row to the Provenance table to record current state; text format does not allow newlines in the entry,
+			// so we don't prettyprint the JSON when going to text, as a quick fix that avoids quoting the newlines etc.
+			WriteProvenanceTable(&output_tables, /* p_use_newlines */ true, p_include_model, chromosome->Index());
+			
+			// Add top-level metadata and metadata schema
+			WriteTreeSequenceMetadata(&output_tables, p_metadata_dict, chromosome->Index());
+			
+			// Set the simulation time unit, in case that is useful to someone.  This is set up in initializeTreeSeq().
+			ret = tsk_table_collection_set_time_units(&output_tables, community_.treeseq_time_unit_.c_str(), community_.treeseq_time_unit_.length());
+			if (ret < 0) handle_error("tsk_table_collection_set_time_units", ret);
+			
 			// derived state data must be in ASCII (or unicode) on disk, according to tskit policy
 			DerivedStatesToAscii(&output_tables);
 			
@@ -7562,20 +8450,61 @@ void Species::WriteTreeSequence(std::string &p_recording_tree_path, bool p_simpl
 			
 			// With one chromosome, we write out to resolved_user_path directly; with more than one, we
 			// created a directory at resolved_user_path above, and now we generate a generic filename
-			std::string output_path;
+			std::string &output_path = batch_paths[batch_index];
 			
 			if (chromosomes_.size() == 1)
 				output_path = resolved_user_path;
 			else
 				output_path = resolved_user_path + "/chromosome_" + chromosome->Symbol() + ".trees";
 			
-			ret = tsk_table_collection_dump(&output_tables, output_path.c_str(), 0);
-			if (ret < 0) handle_error("tsk_table_collection_dump", ret);
+			if (Eidos_AsyncFileWritingEnabled())
+			{
+				// With asynchronous file writing, the writer thread dumps the tables copy and then frees it; it is already
+				// complete and owned by nobody else, so this costs no extra memory.  The size estimate bounds the queue.
+				size_t tables_bytes = MemoryUsageForTreeSeqInfo(chromosome_tsinfo, true);
+				
+				Eidos_EnqueueFileWrite([output_tables_ptr, output_path](std::string *p_error) {
+					int dump_ret = tsk_table_collection_dump(output_tables_ptr, output_path.c_str(), 0);
+					
+					tsk_table_collection_free(output_tables_ptr);
+					free(output_tables_ptr);
+					
+					if (dump_ret < 0)
+					{
+						*p_error = std::string("tsk_table_collection_dump: ") + tsk_strerror(dump_ret);
+						return false;
+					}
+					
+					return true;
+				}, tables_bytes);
+				
+				batch_tables[batch_index] = nullptr;
+			}
+		}
+		
+		// Write out the copied tables, in parallel across chromosomes, and free them; copies handed off to the
+		// asynchronous writer above are now nullptr in batch_tables, and are skipped here
+		{
+			EIDOS_THREAD_COUNT(gEidos_OMP_threads_TREESEQ_OUTPUT);
+#pragma omp parallel for schedule(dynamic, 1) default(none) shared(batch_count, batch_tables, batch_paths, batch_results) if(batch_count >= EIDOS_OMPMIN_TREESEQ_OUTPUT) num_threads(thread_count)
+			for (int batch_index = 0; batch_index < batch_count; ++batch_index)
+			{
+				tsk_table_collection_t *output_tables_ptr = batch_tables[batch_index];
+				
+				if (output_tables_ptr)
+				{
+					batch_results[batch_index] = tsk_table_collection_dump(output_tables_ptr, batch_paths[batch_index].c_str(), 0);
+					
+					// Done with our tables copy
+					tsk_table_collection_free(output_tables_ptr);
+					free(output_tables_ptr);
+				}
+			}
 		}
 		
-		// Done with our tables copy
-		ret = tsk_table_collection_free(&output_tables);
-		if (ret < 0) handle_error("tsk_table_collection_free", ret);
+		for (int batch_index = 0; batch_index < batch_count; ++batch_index)
+			if (batch_results[batch_index] < 0)
+				handle_error("tsk_table_collection_dump", batch_results[batch_index]);
 	}
 }
 
@@ -7598,12 +8527,14 @@ void Species::FreeTreeSequence()
 			if (!first)
 				DisconnectCopiedSharedTables(tsinfo.tables_);
 			
+			DiscardSpilledTreeSeqEdges(tsinfo);
 			tsk_table_collection_free(&tsinfo.tables_);
 			first = false;
 		}
 		
 		treeseq_.resize(0);
 		
+		edge_spill_node_id_map_.clear();
 		remembered_nodes_.clear();
 		tabled_individuals_hash_.clear();
 		tables_initialized_ = false;
@@ -7801,6 +8732,17 @@ void Species::CrosscheckTreeSeqIntegrity(void)
 			ret = tsk_table_collection_copy(&chromosome_tables, tables_copy, 0);
 			if (ret != 0) handle_error("CrosscheckTreeSeqIntegrity tsk_table_collection_copy()", ret);
 			
+			// Edges spilled to disk need to be put back in the copy, ahead of the in-memory edges.
+			TreeSeqInfo &chromosome_tsinfo = treeseq_[chromosome_index];
+			
+			if (chromosome_tsinfo.spilled_edge_count_ > 0)
+			{
+				const char *error_call = nullptr;
+				
+				ret = slim_prepend_spilled_edges(&tables_copy->edges, EdgeSpillPath(chromosome_tsinfo).c_str(), chromosome_tsinfo.spilled_edge_count_, chromosome_tsinfo.spilled_edges_need_remap_ ? edge_spill_node_id_map_.data() : nullptr, &error_call);
+				if (ret != 0) handle_error(std::string("CrosscheckTreeSeqIntegrity ") + error_call, ret);
+			}
+			
 			// We can unshare the shared tables in the original table collection immediately, zeroing them out.
 			if (chromosome_index > 0)
 				DisconnectCopiedSharedTables(chromosome_tables);
@@ -7892,13 +8834,15 @@ void Species::CrosscheckTreeSeqIntegrity(void)
 				// step.  Keep in mind that some mutations may have been fixed (substituted) or lost.
 				slim_position_t variant_pos_int = (slim_position_t)variant.site.position;		// should be no loss of precision, fingers crossed
 				
-				// Get all the substitutions involved at this site, which should be present in every sample
+				// Get all the substitutions involved at this site, which should be present in every sample; the multimap is
+				// keyed by position alone, so we need to skip over substitutions on other chromosomes
 				auto substitution_range_iter = population_.treeseq_substitutions_map_.equal_range(variant_pos_int);
 				static std::vector<slim_mutationid_t> fixed_mutids;
 				
 				fixed_mutids.resize(0);
 				for (auto substitution_iter = substitution_range_iter.first; substitution_iter != substitution_range_iter.second; ++substitution_iter)
-					fixed_mutids.emplace_back(substitution_iter->second->mutation_id_);
+					if (substitution_iter->second->chromosome_index_ == chromosome_index)
+						fixed_mutids.emplace_back(substitution_iter->second->mutation_id_);
 				
 				// Check all the haplosomes against the variant's belief about this site
 				for (size_t haplosome_index = 0; haplosome_index < haplosome_count; haplosome_index++)
@@ -10151,6 +11095,7 @@ void Species::_InstantiateSLiMObjectsFromTables(EidosInterpreter *p_interpreter,
 	
 	// Reset our last coalescence state; we don't know whether we're coalesced now or not
 	p_treeseq.last_coalescence_state_ = false;
+	p_treeseq.simplified_edge_count_ = 0;
 }
 
 void Species::_InstantiateSLiMObjectsFromTables_SECONDARY(EidosInterpreter *p_interpreter, slim_tick_t p_metadata_tick, slim_tick_t p_metadata_cycle, SLiMModelType p_file_model_type, int p_file_version, SUBPOP_REMAP_HASH &p_subpop_map, TreeSeqInfo &p_treeseq)
@@ -10243,6 +11188,7 @@ void Species::_InstantiateSLiMObjectsFromTables_SECONDARY(EidosInterpreter *p_in
 	
 	// Reset our last coalescence state; we don't know whether we're coalesced now or not
 	p_treeseq.last_coalescence_state_ = false;
+	p_treeseq.simplified_edge_count_ = 0;
 }
 
 void Species::_PostInstantiationCleanup(EidosInterpreter *p_interpreter)
@@ -10364,6 +11310,9 @@ slim_tick_t Species::_InitializePopulationFromTskitBinaryFile(const char *p_file
 	
 	treeSeqInfo.chromosome_index_ = p_chromosome.Index();
 	treeSeqInfo.last_coalescence_state_ = false;
+	treeSeqInfo.simplified_edge_count_ = 0;
+	treeSeqInfo.spilled_edge_count_ = 0;
+	treeSeqInfo.spilled_edges_need_remap_ = false;
 	
 	ret = tsk_table_collection_load(&treeSeqInfo.tables_, p_file, TSK_LOAD_SKIP_REFERENCE_SEQUENCE);	// we load the ref seq ourselves; see below
 	if (ret != 0) handle_error("tsk_table_collection_load", ret);
@@ -10508,6 +11457,9 @@ slim_tick_t Species::_InitializePopulationFromTskitDirectory(std::string p_direc
 		TreeSeqInfo &treeSeqInfo = treeseq_.back();
 		treeSeqInfo.chromosome_index_ = chromosome->Index();
 		treeSeqInfo.last_coalescence_state_ = false;
+		treeSeqInfo.simplified_edge_count_ = 0;
+		treeSeqInfo.spilled_edge_count_ = 0;
+		treeSeqInfo.spilled_edges_need_remap_ = false;
 		
 		int ret = tsk_table_collection_load(&treeSeqInfo.tables_, expected_path.c_str(), TSK_LOAD_SKIP_REFERENCE_SEQUENCE);
 		if (ret != 0) handle_error("tsk_table_collection_load", ret);
@@ -219,6 +219,7 @@ private:
 	slim_tick_t InitializePopulationFromFile(const std::string &p_file_string, EidosInterpreter *p_interpreter, SUBPOP_REMAP_HASH &p_subpop_remap);	// initialize the population from the file
 	slim_tick_t _InitializePopulationFromTextFile(const char *p_file, EidosInterpreter *p_interpreter);				// initialize the population from a SLiM text file
 	slim_tick_t _InitializePopulationFromBinaryFile(const char *p_file, EidosInterpreter *p_interpreter);			// initialize the population from a SLiM binary file
+	void _InitializeChromosomeFromColumnarData(char **p_ptr, char *p_buf_end, Chromosome &p_chromosome, bool p_has_nucleotides, bool p_has_object_tags);	// read one chromosome's genetic data from a version 9 SLiM binary file
 	
 	// a "temporary graveyard" for keeping individuals that have been killed by killIndividuals(), until they can be freed
 	std::vector<Individual *> graveyard_;
@@ -315,6 +316,45 @@ private:
 	bool running_treeseq_crosschecks_ = false;	// true if crosschecks between our tree sequence tables and SLiM's data are enabled
 	int treeseq_crosschecks_interval_ = 1;		// crosschecks, if enabled, will be done every treeseq_crosschecks_interval_ cycles
 	
+	std::string edge_spill_directory_;			// if non-empty, retained edges are spilled to files in this directory between simplifications
+	std::vector<tsk_id_t> edge_spill_node_id_map_;	// the node id map from the last simplify, not yet applied to spilled edges
+	
+	// Tree-sequence records made during parallel reproduction are staged in per-thread buffers, indexed by
+	// omp_get_thread_num(), rather than being added to the tables directly; MergeStagedTreeSeqRecording() then
+	// replays them into the tables in pedigree id order, so the tables match those of a single-threaded run.
+	// Each staged individual owns the staged records that follow it in its thread's buffer, up to the next one.
+	typedef struct _TreeSeqStagedIndividual {
+		Individual *individual_;					// the new individual; its pedigree id determines the merge order
+		size_t first_edge_;							// index of its first staged edge in edges_
+		size_t first_null_haplosome_;				// index of its first staged null haplosome in null_haplosomes_
+		size_t first_derived_state_;				// index of its first staged derived state in derived_states_
+	} TreeSeqStagedIndividual;
+	
+	typedef struct _TreeSeqStagedEdge {
+		double left_, right_;						// the interval covered by the edge
+		tsk_id_t parent_;							// the parental node id, which is known at staging time
+		const Haplosome *child_haplosome_;			// the new haplosome; its node id is not known until the merge
+	} TreeSeqStagedEdge;
+	
+	typedef struct _TreeSeqStagedDerivedState {
+		const Haplosome *haplosome_;				// the haplosome that received the new derived state
+		slim_position_t position_;					// the position of the derived state
+		size_t first_mutation_;						// index of its first mutation in mutation_ids_ and mutation_metadata_
+		size_t mutation_count_;						// the number of mutations in the derived state
+	} TreeSeqStagedDerivedState;
+	
+	typedef struct _TreeSeqStagingBuffer {
+		std::vector<TreeSeqStagedIndividual> individuals_;
+		std::vector<TreeSeqStagedEdge> edges_;
+		std::vector<Haplosome *> null_haplosomes_;
+		std::vector<TreeSeqStagedDerivedState> derived_states_;
+		std::vector<slim_mutationid_t> mutation_ids_;		// copied at staging time, since mutations can change
+		std::vector<MutationMetadataRec> mutation_metadata_;
+	} TreeSeqStagingBuffer;
+	
+	bool treeseq_staging_ = false;				// if true, tree-sequence records are staged; see BeginStagedTreeSeqRecording()
+	std::vector<TreeSeqStagingBuffer> treeseq_staging_buffers_;	// one per thread; their capacity is kept across uses
+	
 	double simplification_ratio_;				// the pre:post table size ratio we target with our automatic simplification heuristic
 	int64_t simplification_interval_;			// the cycle interval between simplifications; -1 if not used (in which case the ratio is used)
 	int64_t simplify_elapsed_ = 0;				// the number of cycles elapsed since a simplification was done (automatic or otherwise)
@@ -334,6 +374,9 @@ private:
 		slim_chromosome_index_t chromosome_index_;	// this should range from 0 to N-1, following the corresponding chromosome indices
 		tsk_table_collection_t tables_;				// the table collection; the node, individual, and popultation tables are shared
 		tsk_bookmark_t table_position_;				// a bookmarked position in tables_ for retraction of a proposed child
+		tsk_size_t simplified_edge_count_;			// the number of edges, at the start of the edge table, left sorted by the last simplify
+		tsk_size_t spilled_edge_count_;				// the number of edges spilled to disk by the last simplify; they precede the in-memory edges
+		bool spilled_edges_need_remap_;				// if true, the spilled edges need node ids remapped through edge_spill_node_id_map_
 		bool last_coalescence_state_;				// have we coalesced? updated after simplify if running_coalescence_checks_==true
 	} TreeSeqInfo;
 	
@@ -375,6 +418,11 @@ public:
 	int32_t nonneutral_change_counter_ = 0;
 	int32_t last_nonneutral_regime_ = 0;		// see mutation_run.h; 1 = no mutationEffect() callbacks, 2 = only constant-effect neutral callbacks, 3 = arbitrary callbacks
 	
+	// this counter is incremented whenever the cached fitness effects of any mutation might change: any change to a selection coefficient (not only to or
+	// from zero, unlike nonneutral_change_counter_), a change of mutation type, or a recache after a dominance coefficient change.  Individuals in nonWF models
+	// keep the mutational component of their fitness across ticks only while this counter is unchanged; see Subpopulation::FitnessOfParent_Incremental().
+	int32_t fitness_effect_change_counter_ = 0;
+	
 	// this flag is set if the dominance coeff (regular or haploid) changes on any mutation type, as a signal that recaching needs to occur in Subpopulation::UpdateFitness()
 	bool any_dominance_coeff_changed_ = false;
 	
@@ -551,6 +599,9 @@ public:
 	void RecordNewHaplosome(slim_position_t *p_breakpoints, int p_breakpoints_count, Haplosome *p_new_haplosome, const Haplosome *p_initial_parental_haplosome, const Haplosome *p_second_parental_haplosome);
 	void RecordNewHaplosome_NULL(Haplosome *p_new_haplosome);
 	void RecordNewDerivedState(const Haplosome *p_haplosome, slim_position_t p_position, const std::vector<Mutation *> &p_derived_mutations);
+	void _RecordNewDerivedState(const Haplosome *p_haplosome, slim_position_t p_position, std::vector<slim_mutationid_t> &p_derived_mutation_ids, std::vector<MutationMetadataRec> &p_mutation_metadata);
+	void BeginStagedTreeSeqRecording(void);
+	void MergeStagedTreeSeqRecording(void);
 	void RetractNewIndividual(void);
 	void AddIndividualsToTable(Individual * const *p_individual, size_t p_num_individuals, tsk_table_collection_t *p_tables, INDIVIDUALS_HASH *p_individuals_hash, tsk_flags_t p_flags);
 	void AddLiveIndividualsToIndividualsTable(tsk_table_collection_t *p_tables, INDIVIDUALS_HASH *p_individuals_hash);
@@ -565,9 +616,14 @@ public:
     void ReorderIndividualTable(tsk_table_collection_t *p_tables, std::vector<int> p_individual_map, bool p_keep_unmapped);
 	void AddParentsColumnForOutput(tsk_table_collection_t *p_tables, INDIVIDUALS_HASH *p_individuals_hash);
 	void BuildTabledIndividualsHash(tsk_table_collection_t *p_tables, INDIVIDUALS_HASH *p_individuals_hash);
-	void _SimplifyTreeSequence(TreeSeqInfo &tsinfo, const std::vector<tsk_id_t> &samples);
+	int _SimplifyTreeSequence(TreeSeqInfo &tsinfo, const std::vector<tsk_id_t> &samples, std::string &p_error_message);
 	void SimplifyAllTreeSequences(void);
 	void CheckCoalescenceAfterSimplification(TreeSeqInfo &tsinfo);
+	std::string EdgeSpillPath(const TreeSeqInfo &p_tsinfo) const;
+	void SpillTreeSeqEdges(TreeSeqInfo &p_tsinfo);
+	void RestoreSpilledTreeSeqEdges(TreeSeqInfo &p_tsinfo);
+	void DiscardSpilledTreeSeqEdges(TreeSeqInfo &p_tsinfo);
+	void RestoreAllSpilledTreeSeqEdges(void);
 	void CheckAutoSimplification(void);
 	void FreeTreeSequence();
 	void RecordAllDerivedStatesFromSLiM(void);
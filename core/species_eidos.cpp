@@ -38,6 +38,7 @@
 #include <cmath>
 #include <ctime>
 #include <unordered_map>
+#include <sys/stat.h>
 
 
 //
@@ -122,6 +123,10 @@ EidosValue_SP Species::ExecuteContextFunction_initializeAncestralNucleotides(con
 			{
 				// A singleton string has been provided that contains characters other than ACGT; we will interpret it as a filesystem path for a FASTA file
 				std::string file_path = Eidos_ResolvedPath(sequence_string);
+				
+				// the file might be pending an asynchronous write, which needs to complete first
+				Eidos_WaitForAsyncFileWrites();
+				
 				std::ifstream file_stream(file_path.c_str());
 				
 				if (!file_stream.is_open())
@@ -1583,7 +1588,7 @@ EidosValue_SP Species::ExecuteContextFunction_initializeSpecies(const std::strin
 }
 
 // TREE SEQUENCE RECORDING
-//	*********************	(void)initializeTreeSeq([logical$ recordMutations = T], [Nif$ simplificationRatio = NULL], [Ni$ simplificationInterval = NULL], [logical$ checkCoalescence = F], [logical$ runCrosschecks = F], [logical$ retainCoalescentOnly = T], [Ns$ timeUnit = NULL])
+//	*********************	(void)initializeTreeSeq([logical$ recordMutations = T], [Nif$ simplificationRatio = NULL], [Ni$ simplificationInterval = NULL], [logical$ checkCoalescence = F], [logical$ runCrosschecks = F], [logical$ retainCoalescentOnly = T], [Ns$ timeUnit = NULL], [Ns$ spillDirectory = NULL])
 //
 EidosValue_SP Species::ExecuteContextFunction_initializeTreeSeq(const std::string &p_function_name, const std::vector<EidosValue_SP> &p_arguments, EidosInterpreter &p_interpreter)
 {
@@ -1595,6 +1600,7 @@ EidosValue_SP Species::ExecuteContextFunction_initializeTreeSeq(const std::strin
 	EidosValue *arg_runCrosschecks_value = p_arguments[4].get();
 	EidosValue *arg_retainCoalescentOnly_value = p_arguments[5].get();
 	EidosValue *arg_timeUnit_value = p_arguments[6].get();
+	EidosValue *arg_spillDirectory_value = p_arguments[7].get();
 	std::ostream &output_stream = p_interpreter.ExecutionOutputStream();
 	
 	if (num_treeseq_inits_ > 0)
@@ -1679,6 +1685,17 @@ EidosValue_SP Species::ExecuteContextFunction_initializeTreeSeq(const std::strin
 			EIDOS_TERMINATION << "ERROR (Species::ExecuteContextFunction_initializeTreeSeq): initializeTreeSeq() requires the timeUnit to be non-zero length, and it may not contain a quote character." << EidosTerminate();
 	}
 	
+	// Get the edge spill directory if set; it must be an existing directory
+	if (arg_spillDirectory_value->Type() != EidosValueType::kValueNULL)
+	{
+		edge_spill_directory_ = Eidos_ResolvedPath(Eidos_StripTrailingSlash(arg_spillDirectory_value->StringAtIndex_NOCAST(0, nullptr)));
+		
+		struct stat statbuf;
+		
+		if ((edge_spill_directory_.length() == 0) || (stat(edge_spill_directory_.c_str(), &statbuf) != 0) || !S_ISDIR(statbuf.st_mode))
+			EIDOS_TERMINATION << "ERROR (Species::ExecuteContextFunction_initializeTreeSeq): initializeTreeSeq() requires spillDirectory to be an existing directory." << EidosTerminate();
+	}
+	
 	if (SLiM_verbosity_level >= 1)
 	{
 		output_stream << "initializeTreeSeq(";
@@ -1732,6 +1749,13 @@ EidosValue_SP Species::ExecuteContextFunction_initializeTreeSeq(const std::strin
 			if (previous_params) output_stream << ", ";
 			output_stream << "timeUnit = '" << community_.treeseq_time_unit_ << "'";	// assumes a simple string with no quotes
 			previous_params = true;
+		}
+		
+		if (edge_spill_directory_.length())
+		{
+			if (previous_params) output_stream << ", ";
+			output_stream << "spillDirectory = '" << edge_spill_directory_ << "'";
+			previous_params = true;
 			(void)previous_params;	// dead store above is deliberate
 		}
 		
@@ -2911,7 +2935,10 @@ EidosValue_SP Species::ExecuteMethod_killIndividuals(EidosGlobalStringID p_metho
 		// this method would be invalidated anyway so this probably isn't even that much overkill in
 		// most models.
 		for (auto subpop_pair : population_.subpops_)
+		{
 			subpop_pair.second->cached_parent_individuals_value_.reset();
+			subpop_pair.second->cached_fitness_size_ = 0;
+		}
 		
 		// Invalidate interactions; we just do this for all subpops, for now, rather than trying to
 		// selectively invalidate only the subpops involved in the deaths that occurred
@@ -3167,19 +3194,26 @@ EidosValue_SP Species::ExecuteMethod_outputFixedMutations(EidosGlobalStringID p_
 	}
 	
 	std::ofstream outfile;
-	bool has_file = false;
+	std::ostringstream outbuffer;
+	bool has_file = false, async_file = false, append = false;
 	std::string outfile_path;
 	
 	if (filePath_value->Type() != EidosValueType::kValueNULL)
 	{
 		outfile_path = Eidos_ResolvedPath(filePath_value->StringAtIndex_NOCAST(0, nullptr));
-		bool append = append_value->LogicalAtIndex_NOCAST(0, nullptr);
-		
-		outfile.open(outfile_path.c_str(), append ? (std::ios_base::app | std::ios_base::out) : std::ios_base::out);
+		append = append_value->LogicalAtIndex_NOCAST(0, nullptr);
 		has_file = true;
 		
-		if (!outfile.is_open())
-			EIDOS_TERMINATION << "ERROR (Species::ExecuteMethod_outputFixedMutations): outputFixedMutations() could not open "<< outfile_path << "." << EidosTerminate();
+		// with asynchronous file writing, we format the output in memory and then hand it off to the writer thread
+		async_file = Eidos_AsyncFileWritingEnabled();
+		
+		if (!async_file)
+		{
+			outfile.open(outfile_path.c_str(), append ? (std::ios_base::app | std::ios_base::out) : std::ios_base::out);
+			
+			if (!outfile.is_open())
+				EIDOS_TERMINATION << "ERROR (Species::ExecuteMethod_outputFixedMutations): outputFixedMutations() could not open "<< outfile_path << "." << EidosTerminate();
+		}
 	}
 	else
 	{
@@ -3187,7 +3221,7 @@ EidosValue_SP Species::ExecuteMethod_outputFixedMutations(EidosGlobalStringID p_
 		Eidos_EraseProgress();
 	}
 	
-	std::ostream &out = *(has_file ? dynamic_cast<std::ostream *>(&outfile) : dynamic_cast<std::ostream *>(&output_stream));
+	std::ostream &out = *(async_file ? dynamic_cast<std::ostream *>(&outbuffer) : (has_file ? dynamic_cast<std::ostream *>(&outfile) : dynamic_cast<std::ostream *>(&output_stream)));
 	
 #if DO_MEMORY_CHECKS
 	// This method can burn a huge amount of memory and get us killed, if we have a maximum memory usage.  It's nice to
@@ -3232,7 +3266,9 @@ EidosValue_SP Species::ExecuteMethod_outputFixedMutations(EidosGlobalStringID p_
 #endif
 	}
 	
-	if (has_file)
+	if (async_file)
+		Eidos_WriteDataToFile(outfile_path, outbuffer.str(), append, false);
+	else if (has_file)
 		outfile.close(); 
 	
 	return gStaticEidosValueVOID;
@@ -3299,28 +3335,39 @@ EidosValue_SP Species::ExecuteMethod_outputFull(EidosGlobalStringID p_method_id,
 	{
 		std::string outfile_path = Eidos_ResolvedPath(filePath_value->StringAtIndex_NOCAST(0, nullptr));
 		bool append = append_value->LogicalAtIndex_NOCAST(0, nullptr);
+		bool async_file = Eidos_AsyncFileWritingEnabled();
 		std::ofstream outfile;
+		std::ostringstream outbuffer(use_binary ? (std::ios::out | std::ios::binary) : std::ios::out);
 		
 		if (use_binary && append)
 			EIDOS_TERMINATION << "ERROR (Species::ExecuteMethod_outputFull): outputFull() cannot append in binary format." << EidosTerminate();
 		
-		if (use_binary)
-			outfile.open(outfile_path.c_str(), std::ios::out | std::ios::binary);
-		else
-			outfile.open(outfile_path.c_str(), append ? (std::ios_base::app | std::ios_base::out) : std::ios_base::out);
+		// with asynchronous file writing, we format the output in memory and then hand it off to the writer thread
+		if (!async_file)
+		{
+			if (use_binary)
+				outfile.open(outfile_path.c_str(), std::ios::out | std::ios::binary);
+			else
+				outfile.open(outfile_path.c_str(), append ? (std::ios_base::app | std::ios_base::out) : std::ios_base::out);
+		}
 		
-		if (outfile.is_open())
+		if (async_file || outfile.is_open())
 		{
+			std::ostream &out = (async_file ? (std::ostream &)outbuffer : (std::ostream &)outfile);
+			
 			if (use_binary)
 			{
-				population_.PrintAllBinary(outfile, output_spatial_positions, output_ages, output_ancestral_nucs, output_pedigree_ids, output_object_tags, output_substitutions);
+				population_.PrintAllBinary(out, output_spatial_positions, output_ages, output_ancestral_nucs, output_pedigree_ids, output_object_tags, output_substitutions);
 			}
 			else
 			{
-				Individual::PrintIndividuals_SLiM(outfile, nullptr, 0, *this, output_spatial_positions, output_ages, output_ancestral_nucs, output_pedigree_ids, output_object_tags, output_substitutions, /* p_focal_chromosome */ nullptr);
+				Individual::PrintIndividuals_SLiM(out, nullptr, 0, *this, output_spatial_positions, output_ages, output_ancestral_nucs, output_pedigree_ids, output_object_tags, output_substitutions, /* p_focal_chromosome */ nullptr);
 			}
 			
-			outfile.close(); 
+			if (async_file)
+				Eidos_WriteDataToFile(outfile_path, outbuffer.str(), append, use_binary);
+			else
+				outfile.close(); 
 		}
 		else
 		{
@@ -3358,18 +3405,26 @@ EidosValue_SP Species::ExecuteMethod_outputMutations(EidosGlobalStringID p_metho
 	}
 	
 	std::ofstream outfile;
-	bool has_file = false;
+	std::ostringstream outbuffer;
+	bool has_file = false, async_file = false, append = false;
+	std::string outfile_path;
 	
 	if (filePath_value->Type() != EidosValueType::kValueNULL)
 	{
-		std::string outfile_path = Eidos_ResolvedPath(filePath_value->StringAtIndex_NOCAST(0, nullptr));
-		bool append = append_value->LogicalAtIndex_NOCAST(0, nullptr);
-		
-		outfile.open(outfile_path.c_str(), append ? (std::ios_base::app | std::ios_base::out) : std::ios_base::out);
+		outfile_path = Eidos_ResolvedPath(filePath_value->StringAtIndex_NOCAST(0, nullptr));
+		append = append_value->LogicalAtIndex_NOCAST(0, nullptr);
 		has_file = true;
 		
-		if (!outfile.is_open())
-			EIDOS_TERMINATION << "ERROR (Species::ExecuteMethod_outputMutations): outputMutations() could not open "<< outfile_path << "." << EidosTerminate();
+		// with asynchronous file writing, we format the output in memory and then hand it off to the writer thread
+		async_file = Eidos_AsyncFileWritingEnabled();
+		
+		if (!async_file)
+		{
+			outfile.open(outfile_path.c_str(), append ? (std::ios_base::app | std::ios_base::out) : std::ios_base::out);
+			
+			if (!outfile.is_open())
+				EIDOS_TERMINATION << "ERROR (Species::ExecuteMethod_outputMutations): outputMutations() could not open "<< outfile_path << "." << EidosTerminate();
+		}
 	}
 	else
 	{
@@ -3377,7 +3432,7 @@ EidosValue_SP Species::ExecuteMethod_outputMutations(EidosGlobalStringID p_metho
 		Eidos_EraseProgress();
 	}
 	
-	std::ostream &out = *(has_file ? (std::ostream *)&outfile : (std::ostream *)&output_stream);
+	std::ostream &out = *(async_file ? (std::ostream *)&outbuffer : (has_file ? (std::ostream *)&outfile : (std::ostream *)&output_stream));
 	
 	int mutations_count = mutations_value->Count();
 	Mutation *mut_block_ptr = gSLiM_Mutation_Block;
@@ -3462,7 +3517,9 @@ EidosValue_SP Species::ExecuteMethod_outputMutations(EidosGlobalStringID p_metho
 		}
 	}
 	
-	if (has_file)
+	if (async_file)
+		Eidos_WriteDataToFile(outfile_path, outbuffer.str(), append, false);
+	else if (has_file)
 		outfile.close(); 
 	
 	return gStaticEidosValueVOID;
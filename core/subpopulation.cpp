@@ -29,6 +29,7 @@
 #include "eidos_ast_node.h"
 #include "eidos_globals.h"
 #include "eidos_class_Image.h"
+#include "eidos_simd.h"
 
 #include <iostream>
 #include <fstream>
@@ -344,6 +345,7 @@ void Subpopulation::GenerateParentsToFit(slim_age_t p_initial_age, double p_sex_
 	bool recording_tree_sequence = p_record_in_treeseq && species_.RecordingTreeSequence();
 	
 	cached_parent_individuals_value_.reset();
+	cached_fitness_size_ = 0;
 	
 	if (parent_individuals_.size())
 		EIDOS_TERMINATION << "ERROR (Subpopulation::GenerateParentsToFit): (internal error) individuals already present in GenerateParentsToFit()." << EidosTerminate();
@@ -1161,7 +1163,7 @@ Subpopulation::Subpopulation(Population &p_population, slim_objectid_t p_subpopu
 		for (slim_popsize_t i = 0; i < parent_subpop_size_; i++)
 			*(fitness_buffer_ptr++) = 1.0;
 		
-		lookup_parent_ = gsl_ran_discrete_preproc(parent_subpop_size_, cached_parental_fitness_);
+		lookup_parent_.Build(cached_parental_fitness_, parent_subpop_size_);
 	}
 }
 
@@ -1223,8 +1225,8 @@ Subpopulation::Subpopulation(Population &p_population, slim_objectid_t p_subpopu
 			*(male_buffer_ptr++) = 1.0;
 		}
 		
-		lookup_female_parent_ = gsl_ran_discrete_preproc(parent_first_male_index_, cached_parental_fitness_);
-		lookup_male_parent_ = gsl_ran_discrete_preproc(num_males, cached_parental_fitness_ + parent_first_male_index_);
+		lookup_female_parent_.Build(cached_parental_fitness_, parent_first_male_index_);
+		lookup_male_parent_.Build(cached_parental_fitness_ + parent_first_male_index_, num_males);
 	}
 	
 	if (model_type_ == SLiMModelType::kModelTypeNonWF)
@@ -1246,15 +1248,6 @@ Subpopulation::~Subpopulation(void)
 {
 	//std::cout << "Subpopulation::~Subpopulation" << std::endl;
 	
-	if (lookup_parent_)
-		gsl_ran_discrete_free(lookup_parent_);
-	
-	if (lookup_female_parent_)
-		gsl_ran_discrete_free(lookup_female_parent_);
-	
-	if (lookup_male_parent_)
-		gsl_ran_discrete_free(lookup_male_parent_);
-	
 	if (cached_parental_fitness_)
 		free(cached_parental_fitness_);
 	
@@ -1367,6 +1360,9 @@ void Subpopulation::FixNonNeutralCaches_OMP(void)
 					// This will start a new task if the mutrun needs to validate
 					// its nonneutral cache.  It avoids doing so more than once.
 					mutrun->validate_nonneutral_cache(nonneutral_change_counter, nonneutral_regime);
+					
+					// Assign a fitness stamp now too, if needed, for FitnessOfParent_Incremental()
+					mutrun->FitnessStamp();
 				}
 			}
 		}
@@ -1635,6 +1631,67 @@ void Subpopulation::UpdateFitness(std::vector<SLiMEidosBlock*> &p_mutationEffect
 		}
 	}
 	
+	// In nonWF models most individuals survive from tick to tick with their haplosomes unchanged, so without mutationEffect() callbacks
+	// (which could depend upon anything at all) the mutational component of their fitness can be carried over from the last time it
+	// was calculated; FitnessOfParent_Incremental() checks that, and calls the variant chosen above only when it has to.
+	if (!mutationEffect_callbacks_exist && (model_type_ == SLiMModelType::kModelTypeNonWF))
+	{
+		incremental_fitness_function_ = FitnessOfParent_TEMPLATED;
+		FitnessOfParent_TEMPLATED = &Subpopulation::FitnessOfParent_Incremental;
+	}
+	
+	// Vectorized mutationEffect() callbacks are run here, once each for the whole subpopulation, before the per-individual loops
+	// below; the per-individual factors they produce are folded in by FitnessOfParent(), and ApplyMutationEffectCallbacks() then
+	// treats the mutations of their types as neutral.  The effect passed to a vectorized callback cannot be chained through other
+	// mutationEffect() callbacks, so a vectorized callback must be the only active mutationEffect() callback for its mutation type.
+	vectorized_mutationEffect_factors_.clear();
+	vectorized_mutationEffect_types_.clear();
+	
+	if (mutationEffect_callbacks_exist && !skip_chromosomal_fitness)
+	{
+		for (SLiMEidosBlock *mutationEffect_callback : p_mutationEffect_callbacks)
+		{
+			if (mutationEffect_callback->block_active_ && mutationEffect_callback->RunsVectorized())
+			{
+				slim_objectid_t mutation_type_id = mutationEffect_callback->mutation_type_id_;
+				MutationType *found_muttype = species_.MutationTypeWithID(mutation_type_id);
+				
+				if (!found_muttype)
+					continue;
+				
+				for (SLiMEidosBlock *other_callback : p_mutationEffect_callbacks)
+					if ((other_callback != mutationEffect_callback) && other_callback->block_active_ && ((other_callback->mutation_type_id_ == -1) || (other_callback->mutation_type_id_ == mutation_type_id)))
+						EIDOS_TERMINATION << "ERROR (Subpopulation::UpdateFitness): a vectorized mutationEffect() callback must be the only active mutationEffect() callback for its mutation type." << EidosTerminate(mutationEffect_callback->identifier_token_);
+				
+				if (vectorized_mutationEffect_factors_.size() == 0)
+					vectorized_mutationEffect_factors_.resize(parent_subpop_size_, 1.0);
+				
+				ApplyVectorizedMutationEffectCallback(mutationEffect_callback, found_muttype);
+				vectorized_mutationEffect_types_.emplace_back(found_muttype);
+			}
+		}
+	}
+	
+	// Vectorized fitnessEffect() callbacks are likewise run here, once each for the whole subpopulation; ApplyFitnessEffectCallbacks()
+	// then starts each individual from the product of their results, and skips them
+	vectorized_fitnessEffect_factors_.clear();
+	vectorized_fitnessEffect_callbacks_.clear();
+	
+	if (fitnessEffect_callbacks_exist)
+	{
+		for (SLiMEidosBlock *fitnessEffect_callback : p_fitnessEffect_callbacks)
+		{
+			if (fitnessEffect_callback->block_active_ && fitnessEffect_callback->RunsVectorized())
+			{
+				if (vectorized_fitnessEffect_factors_.size() == 0)
+					vectorized_fitnessEffect_factors_.resize(parent_subpop_size_, 1.0);
+				
+				ApplyVectorizedFitnessEffectCallback(fitnessEffect_callback);
+				vectorized_fitnessEffect_callbacks_.emplace_back(fitnessEffect_callback);
+			}
+		}
+	}
+	
 	// Mutrun experiment timing can be per-individual, per-chromosome, but that entails a lot of timing overhead.
 	// To avoid that overhead, in single-chromosome models we just time across the whole round of fitness evals
 	// instead.  Note that in this case we chose a template above for FitnessOfParent() that does not time.
@@ -1645,7 +1702,12 @@ void Subpopulation::UpdateFitness(std::vector<SLiMEidosBlock*> &p_mutationEffect
 	if (species_.DoingAnyMutationRunExperiments() && (species_.Chromosomes().size() == 1))
 		species_.Chromosomes()[0]->StartMutationRunExperimentClock();
 	
-	// calculate fitnesses in parent population and cache the values
+	// calculate fitnesses in parent population and cache the values; they are cached both in each individual and, contiguously, in
+	// cached_parental_fitness_, which is what the bulk consumers of fitness values (mate drawing, survival, cachedFitness()) read
+	EnsureCachedFitnessCapacity();
+	
+	double *fitness_column = cached_parental_fitness_;
+	
 	if (sex_enabled_)
 	{
 		// SEX ONLY
@@ -1658,7 +1720,7 @@ void Subpopulation::UpdateFitness(std::vector<SLiMEidosBlock*> &p_mutationEffect
 			{
 				EIDOS_BENCHMARK_START(EidosBenchmarkType::k_FITNESS_SEX_1);
 				EIDOS_THREAD_COUNT(gEidos_OMP_threads_FITNESS_SEX_1);
-#pragma omp parallel for schedule(static) default(none) shared(parent_subpop_size_) firstprivate(subpop_fitness_scaling) reduction(+: totalFemaleFitness) if(parent_subpop_size_ >= EIDOS_OMPMIN_FITNESS_SEX_1) num_threads(thread_count)
+#pragma omp parallel for schedule(static) default(none) shared(parent_subpop_size_) firstprivate(subpop_fitness_scaling, fitness_column) reduction(+: totalFemaleFitness) if(parent_subpop_size_ >= EIDOS_OMPMIN_FITNESS_SEX_1) num_threads(thread_count)
 				for (slim_popsize_t female_index = 0; female_index < parent_first_male_index_; female_index++)
 				{
 					double fitness = parent_individuals_[female_index]->fitness_scaling_;
@@ -1669,6 +1731,7 @@ void Subpopulation::UpdateFitness(std::vector<SLiMEidosBlock*> &p_mutationEffect
 					
 					fitness *= subpop_fitness_scaling;
 					parent_individuals_[female_index]->cached_fitness_UNSAFE_ = fitness;
+					fitness_column[female_index] = fitness;
 					totalFemaleFitness += fitness;
 				}
 				EIDOS_BENCHMARK_END(EidosBenchmarkType::k_FITNESS_SEX_1);
@@ -1693,10 +1756,11 @@ void Subpopulation::UpdateFitness(std::vector<SLiMEidosBlock*> &p_mutationEffect
 				{
 					EIDOS_BENCHMARK_START(EidosBenchmarkType::k_FITNESS_SEX_2);
 					EIDOS_THREAD_COUNT(gEidos_OMP_threads_FITNESS_SEX_2);
-#pragma omp parallel for schedule(static) default(none) shared(parent_subpop_size_) firstprivate(fitness) if(parent_subpop_size_ >= EIDOS_OMPMIN_FITNESS_SEX_2) num_threads(thread_count)
+#pragma omp parallel for schedule(static) default(none) shared(parent_subpop_size_) firstprivate(fitness, fitness_column) if(parent_subpop_size_ >= EIDOS_OMPMIN_FITNESS_SEX_2) num_threads(thread_count)
 					for (slim_popsize_t female_index = 0; female_index < parent_first_male_index_; female_index++)
 					{
 						parent_individuals_[female_index]->cached_fitness_UNSAFE_ = fitness;
+						fitness_column[female_index] = fitness;
 					}
 					EIDOS_BENCHMARK_END(EidosBenchmarkType::k_FITNESS_SEX_2);
 				}
@@ -1721,6 +1785,7 @@ void Subpopulation::UpdateFitness(std::vector<SLiMEidosBlock*> &p_mutationEffect
 					
 					fitness *= subpop_fitness_scaling;
 					parent_individuals_[female_index]->cached_fitness_UNSAFE_ = fitness;
+					fitness_column[female_index] = fitness;
 					totalFemaleFitness += fitness;
 				}
 			}
@@ -1743,6 +1808,7 @@ void Subpopulation::UpdateFitness(std::vector<SLiMEidosBlock*> &p_mutationEffect
 					
 					fitness *= subpop_fitness_scaling;
 					parent_individuals_[female_index]->cached_fitness_UNSAFE_ = fitness;
+					fitness_column[female_index] = fitness;
 					totalFemaleFitness += fitness;
 				}
 				
@@ -1768,7 +1834,7 @@ void Subpopulation::UpdateFitness(std::vector<SLiMEidosBlock*> &p_mutationEffect
 					
 					EIDOS_BENCHMARK_START(EidosBenchmarkType::k_FITNESS_SEX_3);
 					EIDOS_THREAD_COUNT(gEidos_OMP_threads_FITNESS_SEX_3);
-#pragma omp parallel for schedule(dynamic, 16) default(none) shared(parent_first_male_index_, subpop_fitness_scaling) reduction(+: totalFemaleFitness) if(parent_subpop_size_ >= EIDOS_OMPMIN_FITNESS_SEX_3) num_threads(thread_count)
+#pragma omp parallel for schedule(dynamic, 16) default(none) shared(parent_first_male_index_, subpop_fitness_scaling) firstprivate(fitness_column) reduction(+: totalFemaleFitness) if(parent_subpop_size_ >= EIDOS_OMPMIN_FITNESS_SEX_3) num_threads(thread_count)
 					for (slim_popsize_t female_index = 0; female_index < parent_first_male_index_; female_index++)
 					{
 						double fitness = parent_individuals_[female_index]->fitness_scaling_;
@@ -1791,6 +1857,7 @@ void Subpopulation::UpdateFitness(std::vector<SLiMEidosBlock*> &p_mutationEffect
 						}
 						
 						parent_individuals_[female_index]->cached_fitness_UNSAFE_ = fitness;
+						fitness_column[female_index] = fitness;
 						totalFemaleFitness += fitness;
 					}
 					EIDOS_BENCHMARK_END(EidosBenchmarkType::k_FITNESS_SEX_3);
@@ -1823,6 +1890,7 @@ void Subpopulation::UpdateFitness(std::vector<SLiMEidosBlock*> &p_mutationEffect
 						}
 						
 						parent_individuals_[female_index]->cached_fitness_UNSAFE_ = fitness;
+						fitness_column[female_index] = fitness;
 						totalFemaleFitness += fitness;
 					}
 				}
@@ -1859,6 +1927,7 @@ void Subpopulation::UpdateFitness(std::vector<SLiMEidosBlock*> &p_mutationEffect
 					}
 					
 					parent_individuals_[female_index]->cached_fitness_UNSAFE_ = fitness;
+					fitness_column[female_index] = fitness;
 					totalFemaleFitness += fitness;
 				}
 				
@@ -1877,7 +1946,7 @@ void Subpopulation::UpdateFitness(std::vector<SLiMEidosBlock*> &p_mutationEffect
 			{
 				EIDOS_BENCHMARK_START(EidosBenchmarkType::k_FITNESS_SEX_1);
 				EIDOS_THREAD_COUNT(gEidos_OMP_threads_FITNESS_SEX_1);
-#pragma omp parallel for schedule(static) default(none) shared(parent_subpop_size_) firstprivate(subpop_fitness_scaling) reduction(+: totalMaleFitness) if(parent_subpop_size_ >= EIDOS_OMPMIN_FITNESS_SEX_1) num_threads(thread_count)
+#pragma omp parallel for schedule(static) default(none) shared(parent_subpop_size_) firstprivate(subpop_fitness_scaling, fitness_column) reduction(+: totalMaleFitness) if(parent_subpop_size_ >= EIDOS_OMPMIN_FITNESS_SEX_1) num_threads(thread_count)
 				for (slim_popsize_t male_index = parent_first_male_index_; male_index < parent_subpop_size_; male_index++)
 				{
 					double fitness = parent_individuals_[male_index]->fitness_scaling_;
@@ -1888,6 +1957,7 @@ void Subpopulation::UpdateFitness(std::vector<SLiMEidosBlock*> &p_mutationEffect
 					
 					fitness *= subpop_fitness_scaling;
 					parent_individuals_[male_index]->cached_fitness_UNSAFE_ = fitness;
+					fitness_column[male_index] = fitness;
 					totalMaleFitness += fitness;
 				}
 				EIDOS_BENCHMARK_END(EidosBenchmarkType::k_FITNESS_SEX_1);
@@ -1912,10 +1982,11 @@ void Subpopulation::UpdateFitness(std::vector<SLiMEidosBlock*> &p_mutationEffect
 				{
 					EIDOS_BENCHMARK_START(EidosBenchmarkType::k_FITNESS_SEX_2);
 					EIDOS_THREAD_COUNT(gEidos_OMP_threads_FITNESS_SEX_2);
-#pragma omp parallel for schedule(static) default(none) shared(parent_subpop_size_) firstprivate(fitness) if(parent_subpop_size_ >= EIDOS_OMPMIN_FITNESS_SEX_2) num_threads(thread_count)
+#pragma omp parallel for schedule(static) default(none) shared(parent_subpop_size_) firstprivate(fitness, fitness_column) if(parent_subpop_size_ >= EIDOS_OMPMIN_FITNESS_SEX_2) num_threads(thread_count)
 					for (slim_popsize_t male_index = parent_first_male_index_; male_index < parent_subpop_size_; male_index++)
 					{
 						parent_individuals_[male_index]->cached_fitness_UNSAFE_ = fitness;
+						fitness_column[male_index] = fitness;
 					}
 					EIDOS_BENCHMARK_END(EidosBenchmarkType::k_FITNESS_SEX_2);
 				}
@@ -1941,6 +2012,7 @@ void Subpopulation::UpdateFitness(std::vector<SLiMEidosBlock*> &p_mutationEffect
 					
 					fitness *= subpop_fitness_scaling;
 					parent_individuals_[male_index]->cached_fitness_UNSAFE_ = fitness;
+					fitness_column[male_index] = fitness;
 					totalMaleFitness += fitness;
 				}
 			}
@@ -1964,6 +2036,7 @@ void Subpopulation::UpdateFitness(std::vector<SLiMEidosBlock*> &p_mutationEffect
 					
 					fitness *= subpop_fitness_scaling;
 					parent_individuals_[male_index]->cached_fitness_UNSAFE_ = fitness;
+					fitness_column[male_index] = fitness;
 					totalMaleFitness += fitness;
 				}
 				
@@ -1981,7 +2054,7 @@ void Subpopulation::UpdateFitness(std::vector<SLiMEidosBlock*> &p_mutationEffect
 					// note that we rely on the fixup of non-neutral caches done above
 					EIDOS_BENCHMARK_START(EidosBenchmarkType::k_FITNESS_SEX_3);
 					EIDOS_THREAD_COUNT(gEidos_OMP_threads_FITNESS_SEX_3);
-#pragma omp parallel for schedule(dynamic, 16) default(none) shared(parent_first_male_index_, parent_subpop_size_, subpop_fitness_scaling) reduction(+: totalMaleFitness) if(parent_subpop_size_ >= EIDOS_OMPMIN_FITNESS_SEX_3) num_threads(thread_count)
+#pragma omp parallel for schedule(dynamic, 16) default(none) shared(parent_first_male_index_, parent_subpop_size_, subpop_fitness_scaling) firstprivate(fitness_column) reduction(+: totalMaleFitness) if(parent_subpop_size_ >= EIDOS_OMPMIN_FITNESS_SEX_3) num_threads(thread_count)
 					for (slim_popsize_t male_index = parent_first_male_index_; male_index < parent_subpop_size_; male_index++)
 					{
 						double fitness = parent_individuals_[male_index]->fitness_scaling_;
@@ -2004,6 +2077,7 @@ void Subpopulation::UpdateFitness(std::vector<SLiMEidosBlock*> &p_mutationEffect
 						}
 						
 						parent_individuals_[male_index]->cached_fitness_UNSAFE_ = fitness;
+						fitness_column[male_index] = fitness;
 						totalMaleFitness += fitness;
 					}
 					EIDOS_BENCHMARK_END(EidosBenchmarkType::k_FITNESS_SEX_3);
@@ -2036,6 +2110,7 @@ void Subpopulation::UpdateFitness(std::vector<SLiMEidosBlock*> &p_mutationEffect
 						}
 						
 						parent_individuals_[male_index]->cached_fitness_UNSAFE_ = fitness;
+						fitness_column[male_index] = fitness;
 						totalMaleFitness += fitness;
 					}
 				}
@@ -2073,6 +2148,7 @@ void Subpopulation::UpdateFitness(std::vector<SLiMEidosBlock*> &p_mutationEffect
 					}
 					
 					parent_individuals_[male_index]->cached_fitness_UNSAFE_ = fitness;
+					fitness_column[male_index] = fitness;
 					totalMaleFitness += fitness;
 				}
 				
@@ -2098,7 +2174,7 @@ void Subpopulation::UpdateFitness(std::vector<SLiMEidosBlock*> &p_mutationEffect
 			{
 				EIDOS_BENCHMARK_START(EidosBenchmarkType::k_FITNESS_ASEX_1);
 				EIDOS_THREAD_COUNT(gEidos_OMP_threads_FITNESS_ASEX_1);
-#pragma omp parallel for schedule(static) default(none) shared(parent_subpop_size_) firstprivate(subpop_fitness_scaling) reduction(+: totalFitness) if(parent_subpop_size_ >= EIDOS_OMPMIN_FITNESS_ASEX_1) num_threads(thread_count)
+#pragma omp parallel for schedule(static) default(none) shared(parent_subpop_size_) firstprivate(subpop_fitness_scaling, fitness_column) reduction(+: totalFitness) if(parent_subpop_size_ >= EIDOS_OMPMIN_FITNESS_ASEX_1) num_threads(thread_count)
 				for (slim_popsize_t individual_index = 0; individual_index < parent_subpop_size_; individual_index++)
 				{
 					double fitness = parent_individuals_[individual_index]->fitness_scaling_;
@@ -2109,6 +2185,7 @@ void Subpopulation::UpdateFitness(std::vector<SLiMEidosBlock*> &p_mutationEffect
 					
 					fitness *= subpop_fitness_scaling;
 					parent_individuals_[individual_index]->cached_fitness_UNSAFE_ = fitness;
+					fitness_column[individual_index] = fitness;
 					totalFitness += fitness;
 				}
 				EIDOS_BENCHMARK_END(EidosBenchmarkType::k_FITNESS_ASEX_1);
@@ -2133,10 +2210,11 @@ void Subpopulation::UpdateFitness(std::vector<SLiMEidosBlock*> &p_mutationEffect
 				{
 					EIDOS_BENCHMARK_START(EidosBenchmarkType::k_FITNESS_ASEX_2);
 					EIDOS_THREAD_COUNT(gEidos_OMP_threads_FITNESS_ASEX_2);
-#pragma omp parallel for schedule(static) default(none) shared(parent_subpop_size_) firstprivate(fitness) if(parent_subpop_size_ >= EIDOS_OMPMIN_FITNESS_ASEX_2) num_threads(thread_count)
+#pragma omp parallel for schedule(static) default(none) shared(parent_subpop_size_) firstprivate(fitness, fitness_column) if(parent_subpop_size_ >= EIDOS_OMPMIN_FITNESS_ASEX_2) num_threads(thread_count)
 					for (slim_popsize_t individual_index = 0; individual_index < parent_subpop_size_; individual_index++)
 					{
 						parent_individuals_[individual_index]->cached_fitness_UNSAFE_ = fitness;
+						fitness_column[individual_index] = fitness;
 					}
 					EIDOS_BENCHMARK_END(EidosBenchmarkType::k_FITNESS_ASEX_2);
 				}
@@ -2162,6 +2240,7 @@ void Subpopulation::UpdateFitness(std::vector<SLiMEidosBlock*> &p_mutationEffect
 					
 					fitness *= subpop_fitness_scaling;
 					parent_individuals_[individual_index]->cached_fitness_UNSAFE_ = fitness;
+					fitness_column[individual_index] = fitness;
 					totalFitness += fitness;
 				}
 			}
@@ -2185,6 +2264,7 @@ void Subpopulation::UpdateFitness(std::vector<SLiMEidosBlock*> &p_mutationEffect
 					
 					fitness *= subpop_fitness_scaling;
 					parent_individuals_[individual_index]->cached_fitness_UNSAFE_ = fitness;
+					fitness_column[individual_index] = fitness;
 					totalFitness += fitness;
 				}
 				
@@ -2210,7 +2290,7 @@ void Subpopulation::UpdateFitness(std::vector<SLiMEidosBlock*> &p_mutationEffect
 					
 					EIDOS_BENCHMARK_START(EidosBenchmarkType::k_FITNESS_ASEX_3);
 					EIDOS_THREAD_COUNT(gEidos_OMP_threads_FITNESS_ASEX_3);
-#pragma omp parallel for schedule(dynamic, 16) default(none) shared(parent_subpop_size_, subpop_fitness_scaling) reduction(+: totalFitness) if(parent_subpop_size_ >= EIDOS_OMPMIN_FITNESS_ASEX_3) num_threads(thread_count)
+#pragma omp parallel for schedule(dynamic, 16) default(none) shared(parent_subpop_size_, subpop_fitness_scaling) firstprivate(fitness_column) reduction(+: totalFitness) if(parent_subpop_size_ >= EIDOS_OMPMIN_FITNESS_ASEX_3) num_threads(thread_count)
 					for (slim_popsize_t individual_index = 0; individual_index < parent_subpop_size_; individual_index++)
 					{
 						double fitness = parent_individuals_[individual_index]->fitness_scaling_;
@@ -2233,6 +2313,7 @@ void Subpopulation::UpdateFitness(std::vector<SLiMEidosBlock*> &p_mutationEffect
 						}
 						
 						parent_individuals_[individual_index]->cached_fitness_UNSAFE_ = fitness;
+						fitness_column[individual_index] = fitness;
 						totalFitness += fitness;
 					}
 					EIDOS_BENCHMARK_END(EidosBenchmarkType::k_FITNESS_ASEX_3);
@@ -2265,6 +2346,7 @@ void Subpopulation::UpdateFitness(std::vector<SLiMEidosBlock*> &p_mutationEffect
 						}
 						
 						parent_individuals_[individual_index]->cached_fitness_UNSAFE_ = fitness;
+						fitness_column[individual_index] = fitness;
 						totalFitness += fitness;
 					}
 				}
@@ -2301,6 +2383,7 @@ void Subpopulation::UpdateFitness(std::vector<SLiMEidosBlock*> &p_mutationEffect
 					}
 					
 					parent_individuals_[individual_index]->cached_fitness_UNSAFE_ = fitness;
+					fitness_column[individual_index] = fitness;
 					totalFitness += fitness;
 				}
 				
@@ -2323,6 +2406,9 @@ void Subpopulation::UpdateFitness(std::vector<SLiMEidosBlock*> &p_mutationEffect
 	if (species_.DoingAnyMutationRunExperiments() && (species_.Chromosomes().size() == 1))
 		species_.Chromosomes()[0]->StopMutationRunExperimentClock("UpdateFitness()");
 	
+	// in WF models with individual_cached_fitness_OVERRIDE_ set, the column is filled in by UpdateWFFitnessBuffers() instead
+	cached_fitness_size_ = parent_subpop_size_;
+	
 	if (model_type_ == SLiMModelType::kModelTypeWF)
 		UpdateWFFitnessBuffers(pure_neutral && !Individual::s_any_individual_fitness_scaling_set_);
 }
@@ -2331,26 +2417,8 @@ void Subpopulation::UpdateFitness(std::vector<SLiMEidosBlock*> &p_mutationEffect
 void Subpopulation::UpdateWFFitnessBuffers(bool p_pure_neutral)
 {
 	// This is called only by UpdateFitness(), after the fitness of all individuals has been updated, and only in WF models.
-	// It updates the cached_parental_fitness_ and cached_male_fitness_ buffers, and then generates new lookup tables for mate choice.
-	
-	// Reallocate the fitness buffers to be large enough
-	if (cached_fitness_capacity_ < parent_subpop_size_)
-	{
-		cached_parental_fitness_ = (double *)realloc(cached_parental_fitness_, sizeof(double) * parent_subpop_size_);
-		if (!cached_parental_fitness_)
-			EIDOS_TERMINATION << "ERROR (Subpopulation::UpdateWFFitnessBuffers): allocation failed; you may need to raise the memory limit for SLiM." << EidosTerminate(nullptr);
-		
-		if (sex_enabled_)
-		{
-			cached_male_fitness_ = (double *)realloc(cached_male_fitness_, sizeof(double) * parent_subpop_size_);
-			if (!cached_male_fitness_)
-				EIDOS_TERMINATION << "ERROR (Subpopulation::UpdateWFFitnessBuffers): allocation failed; you may need to raise the memory limit for SLiM." << EidosTerminate(nullptr);
-		}
-		
-		cached_fitness_capacity_ = parent_subpop_size_;
-	}
-	
-	// Set up the fitness buffers with the new information
+	// UpdateFitness() has already filled cached_parental_fitness_, unless individual_cached_fitness_OVERRIDE_ is set; we fill
+	// it in that case, set up cached_male_fitness_, and then generate new lookup tables for mate choice.
 	if (individual_cached_fitness_OVERRIDE_)
 	{
 		// This is the optimized case, where all individuals have the same fitness and it is cached at the subpop level
@@ -2376,74 +2444,85 @@ void Subpopulation::UpdateWFFitnessBuffers(bool p_pure_neutral)
 				cached_parental_fitness_[i] = universal_cached_fitness;
 		}
 	}
-	else
+	else if (sex_enabled_)
 	{
-		// This is the normal case, where cached_fitness_UNSAFE_ has the cached fitness values for each individual
-		if (sex_enabled_)
-		{
-			for (slim_popsize_t female_index = 0; female_index < parent_first_male_index_; female_index++)
-			{
-				double fitness = parent_individuals_[female_index]->cached_fitness_UNSAFE_;
-				
-				cached_parental_fitness_[female_index] = fitness;
-				cached_male_fitness_[female_index] = 0;
-			}
-			
-			for (slim_popsize_t male_index = parent_first_male_index_; male_index < parent_subpop_size_; male_index++)
-			{
-				double fitness = parent_individuals_[male_index]->cached_fitness_UNSAFE_;
-				
-				cached_parental_fitness_[male_index] = fitness;
-				cached_male_fitness_[male_index] = fitness;
-			}
-		}
-		else
-		{
-			for (slim_popsize_t i = 0; i < parent_subpop_size_; i++)
-				cached_parental_fitness_[i] = parent_individuals_[i]->cached_fitness_UNSAFE_;
-		}
+		// This is the normal case, where cached_parental_fitness_ already has the fitness values for each individual
+		EIDOS_BZERO(cached_male_fitness_, parent_first_male_index_ * sizeof(double));
+		memcpy(cached_male_fitness_ + parent_first_male_index_, cached_parental_fitness_ + parent_first_male_index_, (parent_subpop_size_ - parent_first_male_index_) * sizeof(double));
 	}
 	
-	cached_fitness_size_ = parent_subpop_size_;
-	
 	// Remake our mate-choice lookup tables
 	if (sex_enabled_)
 	{
-		// throw out the old tables
-		if (lookup_female_parent_)
+		// in pure neutral models we don't set up the alias tables; rebuilding them reuses their buffers
+		if (p_pure_neutral)
 		{
-			gsl_ran_discrete_free(lookup_female_parent_);
-			lookup_female_parent_ = nullptr;
+			lookup_female_parent_.Clear();
+			lookup_male_parent_.Clear();
 		}
-		
-		if (lookup_male_parent_)
+		else
 		{
-			gsl_ran_discrete_free(lookup_male_parent_);
-			lookup_male_parent_ = nullptr;
+			lookup_female_parent_.Build(cached_parental_fitness_, parent_first_male_index_);
+			lookup_male_parent_.Build(cached_parental_fitness_ + parent_first_male_index_, parent_subpop_size_ - parent_first_male_index_);
 		}
+	}
+	else
+	{
+		// in pure neutral models we don't set up the alias table; rebuilding it reuses its buffers
+		if (p_pure_neutral)
+			lookup_parent_.Clear();
+		else
+			lookup_parent_.Build(cached_parental_fitness_, parent_subpop_size_);
+	}
+}
+
+void Subpopulation::EnsureCachedFitnessCapacity(void)
+{
+	// Reallocate the fitness buffers to be large enough; cached_male_fitness_ is used only in sexual WF models
+	bool needs_male_buffer = (sex_enabled_ && (model_type_ == SLiMModelType::kModelTypeWF));
+	
+	if ((cached_fitness_capacity_ < parent_subpop_size_) || (needs_male_buffer && !cached_male_fitness_))
+	{
+		slim_popsize_t new_capacity = std::max(cached_fitness_capacity_, parent_subpop_size_);
 		
-		// in pure neutral models we don't set up the discrete preproc
-		if (!p_pure_neutral)
+		cached_parental_fitness_ = (double *)realloc(cached_parental_fitness_, sizeof(double) * new_capacity);
+		if (!cached_parental_fitness_)
+			EIDOS_TERMINATION << "ERROR (Subpopulation::EnsureCachedFitnessCapacity): allocation failed; you may need to raise the memory limit for SLiM." << EidosTerminate(nullptr);
+		
+		if (needs_male_buffer)
 		{
-			lookup_female_parent_ = gsl_ran_discrete_preproc(parent_first_male_index_, cached_parental_fitness_);
-			lookup_male_parent_ = gsl_ran_discrete_preproc(parent_subpop_size_ - parent_first_male_index_, cached_parental_fitness_ + parent_first_male_index_);
+			cached_male_fitness_ = (double *)realloc(cached_male_fitness_, sizeof(double) * new_capacity);
+			if (!cached_male_fitness_)
+				EIDOS_TERMINATION << "ERROR (Subpopulation::EnsureCachedFitnessCapacity): allocation failed; you may need to raise the memory limit for SLiM." << EidosTerminate(nullptr);
 		}
+		
+		cached_fitness_capacity_ = new_capacity;
 	}
-	else
+}
+
+double *Subpopulation::CachedParentalFitness(void)
+{
+	// If parent_individuals_ has changed since fitness was last calculated, the column is regathered from the individuals, which
+	// keep their own copy of their last calculated fitness; new individuals that have not had their fitness calculated have NaN
+	if (cached_fitness_size_ != parent_subpop_size_)
 	{
-		// throw out the old tables
-		if (lookup_parent_)
+		EnsureCachedFitnessCapacity();
+		
+		if (individual_cached_fitness_OVERRIDE_)
 		{
-			gsl_ran_discrete_free(lookup_parent_);
-			lookup_parent_ = nullptr;
+			for (slim_popsize_t i = 0; i < parent_subpop_size_; i++)
+				cached_parental_fitness_[i] = individual_cached_fitness_OVERRIDE_value_;
 		}
-		
-		// in pure neutral models we don't set up the discrete preproc
-		if (!p_pure_neutral)
+		else
 		{
-			lookup_parent_ = gsl_ran_discrete_preproc(parent_subpop_size_, cached_parental_fitness_);
+			for (slim_popsize_t i = 0; i < parent_subpop_size_; i++)
+				cached_parental_fitness_[i] = parent_individuals_[i]->cached_fitness_UNSAFE_;
 		}
+		
+		cached_fitness_size_ = parent_subpop_size_;
 	}
+	
+	return cached_parental_fitness_;
 }
 
 double Subpopulation::ApplyMutationEffectCallbacks(MutationIndex p_mutation, int p_homozygous, double p_computed_fitness, std::vector<SLiMEidosBlock*> &p_mutationEffect_callbacks, Individual *p_individual)
@@ -2455,7 +2534,22 @@ double Subpopulation::ApplyMutationEffectCallbacks(MutationIndex p_mutation, int
 	SLIM_PROFILE_BLOCK_START();
 #endif
 	
-	slim_objectid_t mutation_type_id = (gSLiM_Mutation_Block + p_mutation)->mutation_type_ptr_->mutation_type_id_;
+	MutationType *mutation_type = (gSLiM_Mutation_Block + p_mutation)->mutation_type_ptr_;
+	slim_objectid_t mutation_type_id = mutation_type->mutation_type_id_;
+	
+	// mutations whose effects were already folded in by a vectorized callback contribute nothing further here
+	for (MutationType *vectorized_mutation_type : vectorized_mutationEffect_types_)
+	{
+		if (vectorized_mutation_type == mutation_type)
+		{
+#if (SLIMPROFILING == 1)
+			// PROFILING
+			SLIM_PROFILE_BLOCK_END(community_.profile_callback_totals_[(int)(SLiMEidosBlockType::SLiMEidosMutationEffectCallback)]);
+#endif
+			
+			return 1.0;
+		}
+	}
 	
 	for (SLiMEidosBlock *mutationEffect_callback : p_mutationEffect_callbacks)
 	{
@@ -2496,6 +2590,7 @@ double Subpopulation::ApplyMutationEffectCallbacks(MutationIndex p_mutation, int
 				// The callback is active and matches the mutation type id of the mutation, so we need to execute it
 				// This code is similar to Population::ExecuteScript, but we set up an additional symbol table, and we use the return value
 				const EidosASTNode *compound_statement_node = mutationEffect_callback->compound_statement_node_;
+				EidosBytecodeValue bytecode_result;
 				
 				if (compound_statement_node->cached_return_value_)
 				{
@@ -2535,6 +2630,14 @@ double Subpopulation::ApplyMutationEffectCallbacks(MutationIndex p_mutation, int
 						EIDOS_TERMINATION << "ERROR (Subpopulation::ApplyMutationEffectCallbacks): (internal error) cached optimization flag mismatch" << EidosTerminate(mutationEffect_callback->identifier_token_);
 					}
 				}
+				else if (community_.ExecuteBlockBytecode(mutationEffect_callback, {EidosBytecodeValue::Object(mutationEffect_callback), EidosBytecodeValue::Object(gSLiM_Mutation_Block + p_mutation), EidosBytecodeValue::Float(p_computed_fitness), EidosBytecodeValue::Object(p_individual), EidosBytecodeValue::Object(this), ((p_homozygous == -1) ? EidosBytecodeValue::NULLValue() : EidosBytecodeValue::Logical(p_homozygous != 0))}, &bytecode_result))
+				{
+					// The callback body was compiled to bytecode, and ran without needing to fall back to the interpreter
+					if (bytecode_result.type_ != EidosBytecodeValueType::kFloat)
+						EIDOS_TERMINATION << "ERROR (Subpopulation::ApplyMutationEffectCallbacks): mutationEffect() callbacks must provide a float singleton return value." << EidosTerminate(mutationEffect_callback->identifier_token_);
+					
+					p_computed_fitness = bytecode_result.float_;
+				}
 				else
 				{
 					// local variables for the callback parameters that we might need to allocate here, and thus need to free below
@@ -2621,6 +2724,280 @@ double Subpopulation::ApplyMutationEffectCallbacks(MutationIndex p_mutation, int
 	return p_computed_fitness;
 }
 
+// Run a vectorized mutationEffect() callback once, for all mutations of p_mutation_type in all individuals of the subpopulation, and
+// multiply its results into vectorized_mutationEffect_factors_.  The callback sees mut, effect, individual, and homozygous as parallel
+// vectors with one element per (individual, mutation) pair, in which a mutation homozygous in an individual appears once, with T.  Since
+// a logical vector cannot contain NULL, homozygous is F for mutations opposite a null haplosome and on haploid chromosomes; effect still
+// reflects the hemizygous dominance coefficient where it applies, just as in the non-vectorized case.
+void Subpopulation::ApplyVectorizedMutationEffectCallback(SLiMEidosBlock *p_mutationEffect_callback, MutationType *p_mutation_type)
+{
+	THREAD_SAFETY_IN_ANY_PARALLEL("Population::ApplyVectorizedMutationEffectCallback(): running Eidos callback");
+	
+#if (SLIMPROFILING == 1)
+	// PROFILING
+	SLIM_PROFILE_BLOCK_START();
+#endif
+	
+	// First gather the (individual, mutation) pairs to be evaluated.  We read the full mutation runs rather than the nonneutral
+	// caches, since we only want mutations of one type; mutations are kept in position order, which lets us pair them up.
+	Mutation *mut_block_ptr = gSLiM_Mutation_Block;
+	std::vector<MutationIndex> pair_mutations;
+	std::vector<slim_popsize_t> pair_individuals;
+	std::vector<eidos_logical_t> pair_homozygous;
+	std::vector<double> pair_effects;
+	std::vector<MutationIndex> haplosome1_muts, haplosome2_muts;
+	
+	auto gather_haplosome = [mut_block_ptr, p_mutation_type](const Haplosome *p_haplosome, std::vector<MutationIndex> &p_muts) {
+		p_muts.clear();
+		
+		for (int run_index = 0; run_index < p_haplosome->mutrun_count_; ++run_index)
+		{
+			const MutationRun *mutrun = p_haplosome->mutruns_[run_index];
+			const MutationIndex *mut_iter = mutrun->begin_pointer_const();
+			const MutationIndex *mut_max = mutrun->end_pointer_const();
+			
+			for ( ; mut_iter != mut_max; ++mut_iter)
+				if ((mut_block_ptr + *mut_iter)->mutation_type_ptr_ == p_mutation_type)
+					p_muts.emplace_back(*mut_iter);
+		}
+	};
+	
+	auto add_pair = [&](MutationIndex p_mutindex, slim_popsize_t p_individual_index, eidos_logical_t p_homozygous, double p_effect) {
+		pair_mutations.emplace_back(p_mutindex);
+		pair_individuals.emplace_back(p_individual_index);
+		pair_homozygous.emplace_back(p_homozygous);
+		pair_effects.emplace_back(p_effect);
+	};
+	
+	auto add_haploid = [&](const Haplosome *p_haplosome, slim_popsize_t p_individual_index) {
+		gather_haplosome(p_haplosome, haplosome1_muts);
+		
+		for (MutationIndex mutindex : haplosome1_muts)
+			add_pair(mutindex, p_individual_index, false, (mut_block_ptr + mutindex)->cached_one_plus_sel_);
+	};
+	
+	for (slim_popsize_t individual_index = 0; individual_index < parent_subpop_size_; ++individual_index)
+	{
+		Individual *individual = parent_individuals_[individual_index];
+		int haplosome_index = 0;
+		
+		for (Chromosome *chromosome : species_.Chromosomes())
+		{
+			switch (chromosome->Type())
+			{
+					// diploid, possibly with one or both being null haplosomes
+				case ChromosomeType::kA_DiploidAutosome:
+				case ChromosomeType::kX_XSexChromosome:
+				case ChromosomeType::kZ_ZSexChromosome:
+				{
+					Haplosome *haplosome1 = individual->haplosomes_[haplosome_index];
+					Haplosome *haplosome2 = individual->haplosomes_[haplosome_index+1];
+					bool haplosome1_null = haplosome1->IsNull();
+					bool haplosome2_null = haplosome2->IsNull();
+					
+					if (haplosome1_null != haplosome2_null)
+					{
+						// one haplosome is null, so mutations use the hemizygous dominance coefficient
+						gather_haplosome(haplosome1_null ? haplosome2 : haplosome1, haplosome1_muts);
+						
+						for (MutationIndex mutindex : haplosome1_muts)
+							add_pair(mutindex, individual_index, false, (mut_block_ptr + mutindex)->cached_one_plus_hemizygousdom_sel_);
+					}
+					else if (!haplosome1_null)
+					{
+						// both haplosomes are modeled; walk them in parallel, matching up mutations at each shared position
+						gather_haplosome(haplosome1, haplosome1_muts);
+						gather_haplosome(haplosome2, haplosome2_muts);
+						
+						size_t count1 = haplosome1_muts.size(), count2 = haplosome2_muts.size();
+						size_t index1 = 0, index2 = 0;
+						
+						while ((index1 < count1) && (index2 < count2))
+						{
+							slim_position_t position1 = (mut_block_ptr + haplosome1_muts[index1])->position_;
+							slim_position_t position2 = (mut_block_ptr + haplosome2_muts[index2])->position_;
+							
+							if (position1 < position2)
+							{
+								MutationIndex mutindex = haplosome1_muts[index1++];
+								add_pair(mutindex, individual_index, false, (mut_block_ptr + mutindex)->cached_one_plus_dom_sel_);
+							}
+							else if (position1 > position2)
+							{
+								MutationIndex mutindex = haplosome2_muts[index2++];
+								add_pair(mutindex, individual_index, false, (mut_block_ptr + mutindex)->cached_one_plus_dom_sel_);
+							}
+							else
+							{
+								// find the extent of the mutations at this position in each haplosome
+								size_t end1 = index1, end2 = index2;
+								
+								while ((end1 < count1) && ((mut_block_ptr + haplosome1_muts[end1])->position_ == position1))
+									end1++;
+								while ((end2 < count2) && ((mut_block_ptr + haplosome2_muts[end2])->position_ == position1))
+									end2++;
+								
+								// mutations present in both haplosomes are homozygous, and are evaluated once
+								for (size_t scan1 = index1; scan1 < end1; ++scan1)
+								{
+									MutationIndex mutindex = haplosome1_muts[scan1];
+									bool homozygous = (std::find(haplosome2_muts.begin() + index2, haplosome2_muts.begin() + end2, mutindex) != haplosome2_muts.begin() + end2);
+									Mutation *mutation = mut_block_ptr + mutindex;
+									
+									add_pair(mutindex, individual_index, homozygous, homozygous ? mutation->cached_one_plus_sel_ : mutation->cached_one_plus_dom_sel_);
+								}
+								for (size_t scan2 = index2; scan2 < end2; ++scan2)
+								{
+									MutationIndex mutindex = haplosome2_muts[scan2];
+									
+									if (std::find(haplosome1_muts.begin() + index1, haplosome1_muts.begin() + end1, mutindex) == haplosome1_muts.begin() + end1)
+										add_pair(mutindex, individual_index, false, (mut_block_ptr + mutindex)->cached_one_plus_dom_sel_);
+								}
+								
+								index1 = end1;
+								index2 = end2;
+							}
+						}
+						
+						for ( ; index1 < count1; ++index1)
+							add_pair(haplosome1_muts[index1], individual_index, false, (mut_block_ptr + haplosome1_muts[index1])->cached_one_plus_dom_sel_);
+						for ( ; index2 < count2; ++index2)
+							add_pair(haplosome2_muts[index2], individual_index, false, (mut_block_ptr + haplosome2_muts[index2])->cached_one_plus_dom_sel_);
+					}
+					
+					haplosome_index += 2;
+					break;
+				}
+					
+					// haploid, possibly null
+				case ChromosomeType::kH_HaploidAutosome:
+				case ChromosomeType::kY_YSexChromosome:
+				case ChromosomeType::kW_WSexChromosome:
+				case ChromosomeType::kHF_HaploidFemaleInherited:
+				case ChromosomeType::kFL_HaploidFemaleLine:
+				case ChromosomeType::kHM_HaploidMaleInherited:
+				case ChromosomeType::kML_HaploidMaleLine:
+					add_haploid(individual->haplosomes_[haplosome_index], individual_index);
+					haplosome_index += 1;
+					break;
+					
+					// special cases: haploid but with an accompanying null
+				case ChromosomeType::kHNull_HaploidAutosomeWithNull:
+					add_haploid(individual->haplosomes_[haplosome_index], individual_index);
+					haplosome_index += 2;
+					break;
+				case ChromosomeType::kNullY_YSexChromosomeWithNull:
+					add_haploid(individual->haplosomes_[haplosome_index+1], individual_index);
+					haplosome_index += 2;
+					break;
+			}
+		}
+	}
+	
+	size_t pair_count = pair_mutations.size();
+	
+	if (pair_count)
+	{
+#if DEBUG_POINTS_ENABLED
+		// SLiMgui debugging point
+		EidosDebugPointIndent indenter;
+		
+		{
+			EidosInterpreterDebugPointsSet *debug_points = community_.DebugPoints();
+			EidosToken *decl_token = p_mutationEffect_callback->root_node_->token_;
+			
+			if (debug_points && debug_points->set.size() && (decl_token->token_line_ != -1) &&
+				(debug_points->set.find(decl_token->token_line_) != debug_points->set.end()))
+			{
+				SLIM_ERRSTREAM << EidosDebugPointIndent::Indent() << "#DEBUG mutationEffect(m" << p_mutationEffect_callback->mutation_type_id_;
+				if (p_mutationEffect_callback->subpopulation_id_ != -1)
+					SLIM_ERRSTREAM << ", p" << p_mutationEffect_callback->subpopulation_id_;
+				SLIM_ERRSTREAM << ")";
+				
+				if (p_mutationEffect_callback->block_id_ != -1)
+					SLIM_ERRSTREAM << " s" << p_mutationEffect_callback->block_id_;
+				
+				SLIM_ERRSTREAM << " (line " << (decl_token->token_line_ + 1) << community_.DebugPointInfo() << ")" << std::endl;
+				indenter.indent();
+			}
+		}
+#endif
+		
+		// We need to actually execute the script; we start a block here to manage the lifetime of the symbol table
+		{
+			EidosSymbolTable callback_symbols(EidosSymbolTableType::kContextConstantsTable, &community_.SymbolTable());
+			EidosSymbolTable client_symbols(EidosSymbolTableType::kLocalVariablesTable, &callback_symbols);
+			EidosFunctionMap &function_map = community_.FunctionMap();
+			EidosInterpreter interpreter(p_mutationEffect_callback->compound_statement_node_, client_symbols, function_map, &community_, SLIM_OUTSTREAM, SLIM_ERRSTREAM
+#ifdef SLIMGUI
+				, community_.check_infinite_loops_
+#endif
+				);
+			
+			if (p_mutationEffect_callback->contains_self_)
+				callback_symbols.InitializeConstantSymbolEntry(p_mutationEffect_callback->SelfSymbolTableEntry());		// define "self"
+			
+			// Set all of the callback's parameters, as vectors parallel to one another
+			if (p_mutationEffect_callback->contains_mut_)
+			{
+				EidosValue_Object *mut_vec = (new (gEidosValuePool->AllocateChunk()) EidosValue_Object(gSLiM_Mutation_Class))->resize_no_initialize_RR(pair_count);
+				
+				for (size_t pair_index = 0; pair_index < pair_count; ++pair_index)
+					mut_vec->set_object_element_no_check_no_previous_RR(mut_block_ptr + pair_mutations[pair_index], pair_index);
+				
+				callback_symbols.InitializeConstantSymbolEntry(gID_mut, EidosValue_SP(mut_vec));
+			}
+			if (p_mutationEffect_callback->contains_effect_)
+			{
+				EidosValue_Float *effect_vec = (new (gEidosValuePool->AllocateChunk()) EidosValue_Float())->resize_no_initialize(pair_count);
+				
+				for (size_t pair_index = 0; pair_index < pair_count; ++pair_index)
+					effect_vec->set_float_no_check(pair_effects[pair_index], pair_index);
+				
+				callback_symbols.InitializeConstantSymbolEntry(gID_effect, EidosValue_SP(effect_vec));
+			}
+			if (p_mutationEffect_callback->contains_individual_)
+			{
+				EidosValue_Object *individual_vec = (new (gEidosValuePool->AllocateChunk()) EidosValue_Object(gSLiM_Individual_Class))->resize_no_initialize(pair_count);
+				
+				for (size_t pair_index = 0; pair_index < pair_count; ++pair_index)
+					individual_vec->set_object_element_no_check_NORR(parent_individuals_[pair_individuals[pair_index]], pair_index);
+				
+				callback_symbols.InitializeConstantSymbolEntry(gID_individual, EidosValue_SP(individual_vec));
+			}
+			if (p_mutationEffect_callback->contains_subpop_)
+				callback_symbols.InitializeConstantSymbolEntry(gID_subpop, SymbolTableEntry().second);
+			if (p_mutationEffect_callback->contains_homozygous_)
+			{
+				EidosValue_Logical *homozygous_vec = (new (gEidosValuePool->AllocateChunk()) EidosValue_Logical())->resize_no_initialize(pair_count);
+				
+				for (size_t pair_index = 0; pair_index < pair_count; ++pair_index)
+					homozygous_vec->set_logical_no_check(pair_homozygous[pair_index], pair_index);
+				
+				callback_symbols.InitializeConstantSymbolEntry(gID_homozygous, EidosValue_SP(homozygous_vec));
+			}
+			
+			// Interpret the script; the result must be a float vector with one new effect per (individual, mutation) pair
+			EidosValue_SP result_SP = interpreter.EvaluateInternalBlock(p_mutationEffect_callback->script_);
+			EidosValue *result = result_SP.get();
+			
+			if ((result->Type() != EidosValueType::kValueFloat) || (result->Count() != (int)pair_count))
+				EIDOS_TERMINATION << "ERROR (Subpopulation::ApplyVectorizedMutationEffectCallback): vectorized mutationEffect() callbacks must provide a float vector return value with one element per element of mut." << EidosTerminate(p_mutationEffect_callback->identifier_token_);
+			
+			const double *result_data = result->FloatData();
+			double *factors = vectorized_mutationEffect_factors_.data();
+			
+			for (size_t pair_index = 0; pair_index < pair_count; ++pair_index)
+				factors[pair_individuals[pair_index]] *= result_data[pair_index];
+		}
+	}
+	
+#if (SLIMPROFILING == 1)
+	// PROFILING
+	SLIM_PROFILE_BLOCK_END(community_.profile_callback_totals_[(int)(SLiMEidosBlockType::SLiMEidosMutationEffectCallback)]);
+#endif
+}
+
 double Subpopulation::ApplyFitnessEffectCallbacks(std::vector<SLiMEidosBlock*> &p_fitnessEffect_callbacks, slim_popsize_t p_individual_index)
 {
 	THREAD_SAFETY_IN_ANY_PARALLEL("Population::ApplyFitnessEffectCallbacks(): running Eidos callback");
@@ -2633,8 +3010,28 @@ double Subpopulation::ApplyFitnessEffectCallbacks(std::vector<SLiMEidosBlock*> &
 	double computed_fitness = 1.0;
 	Individual *individual = parent_individuals_[p_individual_index];
 	
+	// start from the factor computed by vectorized fitnessEffect() callbacks, if any; see UpdateFitness()
+	if (vectorized_fitnessEffect_factors_.size())
+	{
+		computed_fitness = vectorized_fitnessEffect_factors_[p_individual_index];
+		
+		if (computed_fitness <= 0.0)
+		{
+#if (SLIMPROFILING == 1)
+			// PROFILING
+			SLIM_PROFILE_BLOCK_END(community_.profile_callback_totals_[(int)(SLiMEidosBlockType::SLiMEidosFitnessEffectCallback)]);
+#endif
+			
+			return 0.0;
+		}
+	}
+	
 	for (SLiMEidosBlock *fitnessEffect_callback : p_fitnessEffect_callbacks)
 	{
+		// vectorized callbacks have already been run for the whole subpopulation by UpdateFitness()
+		if (vectorized_fitnessEffect_callbacks_.size() && (std::find(vectorized_fitnessEffect_callbacks_.begin(), vectorized_fitnessEffect_callbacks_.end(), fitnessEffect_callback) != vectorized_fitnessEffect_callbacks_.end()))
+			continue;
+		
 		if (fitnessEffect_callback->block_active_)
 		{
 #if DEBUG_POINTS_ENABLED
@@ -2665,6 +3062,7 @@ double Subpopulation::ApplyFitnessEffectCallbacks(std::vector<SLiMEidosBlock*> &
 			// The callback is active, so we need to execute it
 			// This code is similar to Population::ExecuteScript, but we set up an additional symbol table, and we use the return value
 			const EidosASTNode *compound_statement_node = fitnessEffect_callback->compound_statement_node_;
+			EidosBytecodeValue bytecode_result;
 			
 			if (compound_statement_node->cached_return_value_)
 			{
@@ -2707,6 +3105,14 @@ double Subpopulation::ApplyFitnessEffectCallbacks(std::vector<SLiMEidosBlock*> &
 					EIDOS_TERMINATION << "ERROR (Subpopulation::ApplyFitnessEffectCallbacks): (internal error) cached optimization flag mismatch" << EidosTerminate(fitnessEffect_callback->identifier_token_);
 				}
 			}
+			else if (community_.ExecuteBlockBytecode(fitnessEffect_callback, {EidosBytecodeValue::Object(fitnessEffect_callback), EidosBytecodeValue::Object(individual), EidosBytecodeValue::Object(this)}, &bytecode_result))
+			{
+				// The callback body was compiled to bytecode, and ran without needing to fall back to the interpreter
+				if (bytecode_result.type_ != EidosBytecodeValueType::kFloat)
+					EIDOS_TERMINATION << "ERROR (Subpopulation::ApplyFitnessEffectCallbacks): fitnessEffect() callbacks must provide a float singleton return value." << EidosTerminate(fitnessEffect_callback->identifier_token_);
+				
+				computed_fitness *= bytecode_result.float_;
+			}
 			else
 			{
 				// We need to actually execute the script; we start a block here to manage the lifetime of the symbol table
@@ -2789,6 +3195,83 @@ double Subpopulation::ApplyFitnessEffectCallbacks(std::vector<SLiMEidosBlock*> &
 	return computed_fitness;
 }
 
+// Run a vectorized fitnessEffect() callback once for the whole subpopulation, with individual bound to all of its individuals, and
+// multiply its results, one per individual, into vectorized_fitnessEffect_factors_
+void Subpopulation::ApplyVectorizedFitnessEffectCallback(SLiMEidosBlock *p_fitnessEffect_callback)
+{
+	THREAD_SAFETY_IN_ANY_PARALLEL("Population::ApplyVectorizedFitnessEffectCallback(): running Eidos callback");
+	
+	if (parent_subpop_size_ == 0)
+		return;
+	
+#if (SLIMPROFILING == 1)
+	// PROFILING
+	SLIM_PROFILE_BLOCK_START();
+#endif
+	
+#if DEBUG_POINTS_ENABLED
+	// SLiMgui debugging point
+	EidosDebugPointIndent indenter;
+	
+	{
+		EidosInterpreterDebugPointsSet *debug_points = community_.DebugPoints();
+		EidosToken *decl_token = p_fitnessEffect_callback->root_node_->token_;
+		
+		if (debug_points && debug_points->set.size() && (decl_token->token_line_ != -1) &&
+			(debug_points->set.find(decl_token->token_line_) != debug_points->set.end()))
+		{
+			SLIM_ERRSTREAM << EidosDebugPointIndent::Indent() << "#DEBUG fitnessEffect(";
+			if (p_fitnessEffect_callback->subpopulation_id_ != -1)
+				SLIM_ERRSTREAM << "p" << p_fitnessEffect_callback->subpopulation_id_;
+			SLIM_ERRSTREAM << ")";
+			
+			if (p_fitnessEffect_callback->block_id_ != -1)
+				SLIM_ERRSTREAM << " s" << p_fitnessEffect_callback->block_id_;
+			
+			SLIM_ERRSTREAM << " (line " << (decl_token->token_line_ + 1) << community_.DebugPointInfo() << ")" << std::endl;
+			indenter.indent();
+		}
+	}
+#endif
+	
+	// We need to actually execute the script; we start a block here to manage the lifetime of the symbol table
+	{
+		EidosSymbolTable callback_symbols(EidosSymbolTableType::kContextConstantsTable, &community_.SymbolTable());
+		EidosSymbolTable client_symbols(EidosSymbolTableType::kLocalVariablesTable, &callback_symbols);
+		EidosFunctionMap &function_map = community_.FunctionMap();
+		EidosInterpreter interpreter(p_fitnessEffect_callback->compound_statement_node_, client_symbols, function_map, &community_, SLIM_OUTSTREAM, SLIM_ERRSTREAM
+#ifdef SLIMGUI
+			, community_.check_infinite_loops_
+#endif
+			);
+		
+		if (p_fitnessEffect_callback->contains_self_)
+			callback_symbols.InitializeConstantSymbolEntry(p_fitnessEffect_callback->SelfSymbolTableEntry());		// define "self"
+		if (p_fitnessEffect_callback->contains_individual_)
+			callback_symbols.InitializeConstantSymbolEntry(gID_individual, CachedParentIndividualsValue());
+		if (p_fitnessEffect_callback->contains_subpop_)
+			callback_symbols.InitializeConstantSymbolEntry(gID_subpop, SymbolTableEntry().second);
+		
+		// Interpret the script; the result must be a float vector with one fitness effect per individual
+		EidosValue_SP result_SP = interpreter.EvaluateInternalBlock(p_fitnessEffect_callback->script_);
+		EidosValue *result = result_SP.get();
+		
+		if ((result->Type() != EidosValueType::kValueFloat) || (result->Count() != parent_subpop_size_))
+			EIDOS_TERMINATION << "ERROR (Subpopulation::ApplyVectorizedFitnessEffectCallback): vectorized fitnessEffect() callbacks must provide a float vector return value with one element per individual." << EidosTerminate(p_fitnessEffect_callback->identifier_token_);
+		
+		const double *result_data = result->FloatData();
+		double *factors = vectorized_fitnessEffect_factors_.data();
+		
+		for (slim_popsize_t individual_index = 0; individual_index < parent_subpop_size_; ++individual_index)
+			factors[individual_index] *= result_data[individual_index];
+	}
+	
+#if (SLIMPROFILING == 1)
+	// PROFILING
+	SLIM_PROFILE_BLOCK_END(community_.profile_callback_totals_[(int)(SLiMEidosBlockType::SLiMEidosFitnessEffectCallback)]);
+#endif
+}
+
 // FitnessOfParent() has three templated versions, for no callbacks, a single callback, and multiple callbacks.  That
 // pattern extends downward to _Fitness_DiploidChromosome() and _Fitness_HaploidChromosome(), which is the level where
 // it actually matters; in FitnessOfParent() the template flags just get passed through.  The goal of this design is
@@ -2812,6 +3295,15 @@ double Subpopulation::FitnessOfParent(slim_popsize_t p_individual_index, std::ve
 	Individual *individual = parent_individuals_[p_individual_index];
 	int haplosome_index = 0;
 	
+	// start from the factor computed by vectorized mutationEffect() callbacks, if any; see UpdateFitness()
+	if (f_callbacks && vectorized_mutationEffect_factors_.size())
+	{
+		w = vectorized_mutationEffect_factors_[p_individual_index];
+		
+		if (w <= 0.0)
+			return 0.0;
+	}
+	
 	for (Chromosome *chromosome : species_.Chromosomes())
 	{
 		if (f_mutrunexps) chromosome->StartMutationRunExperimentClock();
@@ -2936,6 +3428,139 @@ double Subpopulation::FitnessOfParent_1CH_Haploid(slim_popsize_t p_individual_in
 	return w;
 }
 
+// Incremental fitness evaluation, used by UpdateFitness() in nonWF models without mutationEffect() callbacks.  The mutational component
+// of fitness depends only upon the mutations in the individual's haplosomes and their cached fitness effects.  The former is captured
+// by the stamps of the individual's mutation runs, which change whenever a run's contents change (see MutationRun::FitnessStamp()), the
+// latter by the species' fitness_effect_change_counter_.  If both match what was recorded when the individual's fitness was last
+// calculated, the cached value is returned; otherwise the value is calculated by incremental_fitness_function_ and recorded.  New
+// offspring start with nothing cached.  Checking the stamps touches each MutationRun object but none of the mutations inside it.
+double Subpopulation::FitnessOfParent_Incremental(slim_popsize_t p_individual_index, std::vector<SLiMEidosBlock*> &p_mutationEffect_callbacks)
+{
+	Individual *individual = parent_individuals_[p_individual_index];
+	Haplosome **haplosomes = individual->haplosomes_;
+	int32_t fitness_effect_change_counter = species_.fitness_effect_change_counter_;
+	int32_t stamp_count = individual->mutational_fitness_stamp_count_;
+	
+	if (stamp_count && (individual->mutational_fitness_change_counter_ == fitness_effect_change_counter))
+	{
+		const int64_t *stamps = individual->mutational_fitness_stamps_;
+		const int64_t *stamps_end = stamps + stamp_count;
+		bool stamps_match = true;
+		
+		for (int haplosome_index = 0; haplosome_index < haplosome_count_per_individual_; ++haplosome_index)
+		{
+			const Haplosome *haplosome = haplosomes[haplosome_index];
+			const int32_t mutrun_count = haplosome->mutrun_count_;
+			
+			if (stamps_end - stamps < std::max(mutrun_count, 1))
+			{
+				stamps_match = false;
+				break;
+			}
+			
+			if (mutrun_count == 0)
+			{
+				if (*(stamps++) != 0)
+				{
+					stamps_match = false;
+					break;
+				}
+				continue;
+			}
+			
+			for (int run_index = 0; run_index < mutrun_count; ++run_index)
+			{
+				if (*(stamps++) != haplosome->mutruns_[run_index]->FitnessStamp())
+				{
+					stamps_match = false;
+					break;
+				}
+			}
+			
+			if (!stamps_match)
+				break;
+		}
+		
+		if (stamps_match && (stamps == stamps_end))
+			return individual->cached_mutational_fitness_;
+	}
+	
+	// recalculate, and record the stamps the new value depends upon; a null haplosome is recorded as a 0 stamp
+	double w = (this->*incremental_fitness_function_)(p_individual_index, p_mutationEffect_callbacks);
+	int32_t new_stamp_count = 0;
+	
+	for (int haplosome_index = 0; haplosome_index < haplosome_count_per_individual_; ++haplosome_index)
+		new_stamp_count += std::max(haplosomes[haplosome_index]->mutrun_count_, 1);
+	
+	if (new_stamp_count > individual->mutational_fitness_stamp_capacity_)
+	{
+		individual->mutational_fitness_stamps_ = (int64_t *)realloc(individual->mutational_fitness_stamps_, new_stamp_count * sizeof(int64_t));
+		if (!individual->mutational_fitness_stamps_)
+			EIDOS_TERMINATION << "ERROR (Subpopulation::FitnessOfParent_Incremental): allocation failed; you may need to raise the memory limit for SLiM." << EidosTerminate(nullptr);
+		individual->mutational_fitness_stamp_capacity_ = new_stamp_count;
+	}
+	
+	int64_t *stamps = individual->mutational_fitness_stamps_;
+	
+	for (int haplosome_index = 0; haplosome_index < haplosome_count_per_individual_; ++haplosome_index)
+	{
+		const Haplosome *haplosome = haplosomes[haplosome_index];
+		const int32_t mutrun_count = haplosome->mutrun_count_;
+		
+		if (mutrun_count == 0)
+			*(stamps++) = 0;
+		
+		for (int run_index = 0; run_index < mutrun_count; ++run_index)
+			*(stamps++) = haplosome->mutruns_[run_index]->FitnessStamp();
+	}
+	
+	individual->cached_mutational_fitness_ = w;
+	individual->mutational_fitness_change_counter_ = fitness_effect_change_counter;
+	individual->mutational_fitness_stamp_count_ = new_stamp_count;
+	
+	return w;
+}
+
+// Without mutationEffect() callbacks, the fitness effect of a mutation run is just a product of cached factors when no merge against a
+// homologous run is needed: in a haploid chromosome, opposite a null haplosome, in a run shared by both haplosomes of a diploid (all
+// homozygous), or opposite a run with no non-neutral mutations (all heterozygous).  Each MutationRun caches those products (see
+// MutationRun::cached_fitness_product()), so a run shared by many haplosomes, as most are after UniqueMutationRuns(), multiplies its
+// factors once, with the bulk kernels in eidos_simd.h, and every other use costs a lookup.  Runs that differ still go through the
+// merge in _Fitness_DiploidChromosome(), since which mutations are homozygous depends upon the pair, not upon either run alone.
+static_assert(std::is_same<slim_selcoeff_t, float>::value, "the fitness product kernels assume that slim_selcoeff_t is float");
+
+static inline double _FitnessProduct_MutationRun(const MutationRun *p_mutrun, MutationRunFitnessProduct p_kind, const Species &p_species)
+{
+	double product;
+	
+	if (p_mutrun->cached_fitness_product(p_kind, p_species.fitness_effect_change_counter_, &product))
+		return product;
+	
+#if SLIM_USE_NONNEUTRAL_CACHES
+	const MutationIndex *mut_iter, *mut_max;
+	
+	p_mutrun->beginend_nonneutral_pointers(&mut_iter, &mut_max, p_species.nonneutral_change_counter_, p_species.last_nonneutral_regime_);
+#else
+	const MutationIndex *mut_iter = p_mutrun->begin_pointer_const();
+	const MutationIndex *mut_max = p_mutrun->end_pointer_const();
+#endif
+	
+	Mutation *mut_block_ptr = gSLiM_Mutation_Block;
+	const float *factor_base;
+	
+	switch (p_kind)
+	{
+		case MutationRunFitnessProduct::kHomozygous:	factor_base = &mut_block_ptr->cached_one_plus_sel_; break;
+		case MutationRunFitnessProduct::kHeterozygous:	factor_base = &mut_block_ptr->cached_one_plus_dom_sel_; break;
+		case MutationRunFitnessProduct::kHemizygous:	factor_base = &mut_block_ptr->cached_one_plus_hemizygousdom_sel_; break;
+	}
+	
+	product = Eidos_SIMD::gather_product_float32(factor_base, sizeof(Mutation), mut_iter, mut_max - mut_iter);
+	p_mutrun->cache_fitness_product(p_kind, p_species.fitness_effect_change_counter_, product);
+	
+	return product;
+}
+
 template <const bool f_callbacks, const bool f_singlecallback>
 double Subpopulation::_Fitness_DiploidChromosome(Haplosome *haplosome1, Haplosome *haplosome2, std::vector<SLiMEidosBlock*> &p_mutationEffect_callbacks)
 {
@@ -2977,6 +3602,14 @@ double Subpopulation::_Fitness_DiploidChromosome(Haplosome *haplosome1, Haplosom
 		{
 			const MutationRun *mutrun = haplosome->mutruns_[run_index];
 			
+			// with an unpaired chromosome, we multiply each selection coefficient by the hemizygous dominance coefficient
+			// this is for a single X chromosome in a male, for example; dosage compensation, as opposed to heterozygosity
+			if (!f_callbacks)
+			{
+				w *= _FitnessProduct_MutationRun(mutrun, MutationRunFitnessProduct::kHemizygous, species_);
+				continue;
+			}
+			
 #if SLIM_USE_NONNEUTRAL_CACHES
 			// Cache non-neutral mutations and read from the non-neutral buffers
 			const MutationIndex *haplosome_iter, *haplosome_max;
@@ -2988,8 +3621,6 @@ double Subpopulation::_Fitness_DiploidChromosome(Haplosome *haplosome1, Haplosom
 			const MutationIndex *haplosome_max = mutrun->end_pointer_const();
 #endif
 			
-			// with an unpaired chromosome, we multiply each selection coefficient by the hemizygous dominance coefficient
-			// this is for a single X chromosome in a male, for example; dosage compensation, as opposed to heterozygosity
 			while (haplosome_iter != haplosome_max)
 			{
 				MutationIndex haplosome_mutindex = *haplosome_iter++;
@@ -3021,6 +3652,13 @@ double Subpopulation::_Fitness_DiploidChromosome(Haplosome *haplosome1, Haplosom
 			const MutationRun *mutrun1 = haplosome1->mutruns_[run_index];
 			const MutationRun *mutrun2 = haplosome2->mutruns_[run_index];
 			
+			// a run shared by both haplosomes is entirely homozygous
+			if (!f_callbacks && (mutrun1 == mutrun2))
+			{
+				w *= _FitnessProduct_MutationRun(mutrun1, MutationRunFitnessProduct::kHomozygous, species_);
+				continue;
+			}
+			
 #if SLIM_USE_NONNEUTRAL_CACHES
 			// Cache non-neutral mutations and read from the non-neutral buffers
 			const MutationIndex *haplosome1_iter, *haplosome2_iter, *haplosome1_max, *haplosome2_max;
@@ -3036,6 +3674,13 @@ double Subpopulation::_Fitness_DiploidChromosome(Haplosome *haplosome1, Haplosom
 			const MutationIndex *haplosome2_max = mutrun2->end_pointer_const();
 #endif
 			
+			// a run opposite one with no (non-neutral) mutations is entirely heterozygous
+			if (!f_callbacks && ((haplosome1_iter == haplosome1_max) || (haplosome2_iter == haplosome2_max)))
+			{
+				w *= _FitnessProduct_MutationRun((haplosome1_iter == haplosome1_max) ? mutrun2 : mutrun1, MutationRunFitnessProduct::kHeterozygous, species_);
+				continue;
+			}
+			
 			// first, handle the situation before either haplosome iterator has reached the end of its haplosome, for simplicity/speed
 			if (haplosome1_iter != haplosome1_max && haplosome2_iter != haplosome2_max)
 			{
@@ -3294,6 +3939,13 @@ double Subpopulation::_Fitness_HaploidChromosome(Haplosome *haplosome, std::vect
 		{
 			const MutationRun *mutrun = haplosome->mutruns_[run_index];
 			
+			// with a haploid chromosome, we use the homozygous fitness effect
+			if (!f_callbacks)
+			{
+				w *= _FitnessProduct_MutationRun(mutrun, MutationRunFitnessProduct::kHomozygous, species_);
+				continue;
+			}
+			
 #if SLIM_USE_NONNEUTRAL_CACHES
 			// Cache non-neutral mutations and read from the non-neutral buffers
 			const MutationIndex *haplosome_iter, *haplosome_max;
@@ -3305,7 +3957,6 @@ double Subpopulation::_Fitness_HaploidChromosome(Haplosome *haplosome, std::vect
 			const MutationIndex *haplosome_max = mutrun->end_pointer_const();
 #endif
 			
-			// with a haploid chromosome, we use the homozygous fitness effect
 			while (haplosome_iter != haplosome_max)
 			{
 				MutationIndex haplosome_mutation = *haplosome_iter++;
@@ -3371,6 +4022,7 @@ void Subpopulation::SwapChildAndParentHaplosomes(void)
 	// Execute the swap of the individuals
 	child_individuals_.swap(parent_individuals_);
 	cached_parent_individuals_value_.reset();
+	cached_fitness_size_ = 0;
 	
 	// Clear out any dictionary values and color values stored in what are now the child individuals; since this is per-individual it
 	// takes a significant amount of time, so we try to minimize the overhead by doing it only when these facilities have been used
@@ -5748,6 +6400,106 @@ void Subpopulation::ApplyReproductionCallbacks(std::vector<SLiMEidosBlock*> &p_r
 #endif
 }
 
+// nonWF only:
+// Run a vectorized reproduction() callback once for the whole subpopulation, with individual bound to all of its individuals of the
+// callback's sex (if it has a sex specifier); like other reproduction() callbacks, it is called for its side effects
+void Subpopulation::ApplyVectorizedReproductionCallback(SLiMEidosBlock *p_reproduction_callback)
+{
+	THREAD_SAFETY_IN_ANY_PARALLEL("Population::ApplyVectorizedReproductionCallback(): running Eidos callback");
+	
+	// in sexual models females come before males, so the individuals of one sex are a contiguous range
+	IndividualSex sex_specificity = p_reproduction_callback->sex_specificity_;
+	slim_popsize_t first_index = 0, last_index = parent_subpop_size_;
+	
+	if (sex_enabled_ && (sex_specificity == IndividualSex::kFemale))
+		last_index = parent_first_male_index_;
+	else if (sex_enabled_ && (sex_specificity == IndividualSex::kMale))
+		first_index = parent_first_male_index_;
+	else if (sex_specificity != IndividualSex::kUnspecified)
+		return;		// a sex-specific callback in a non-sexual model matches no individuals, as in ApplyReproductionCallbacks()
+	
+	if (first_index >= last_index)
+		return;
+	
+#if (SLIMPROFILING == 1)
+	// PROFILING
+	SLIM_PROFILE_BLOCK_START();
+#endif
+	
+#if DEBUG_POINTS_ENABLED
+	// SLiMgui debugging point
+	EidosDebugPointIndent indenter;
+	
+	{
+		EidosInterpreterDebugPointsSet *debug_points = community_.DebugPoints();
+		EidosToken *decl_token = p_reproduction_callback->root_node_->token_;
+		
+		if (debug_points && debug_points->set.size() && (decl_token->token_line_ != -1) &&
+			(debug_points->set.find(decl_token->token_line_) != debug_points->set.end()))
+		{
+			SLIM_ERRSTREAM << EidosDebugPointIndent::Indent() << "#DEBUG reproduction(";
+			if ((p_reproduction_callback->subpopulation_id_ != -1) && (p_reproduction_callback->sex_specificity_ != IndividualSex::kUnspecified))
+				SLIM_ERRSTREAM << "p" << p_reproduction_callback->subpopulation_id_ << ", \"" << p_reproduction_callback->sex_specificity_ << "\"";
+			else if (p_reproduction_callback->subpopulation_id_ != -1)
+				SLIM_ERRSTREAM << "p" << p_reproduction_callback->subpopulation_id_;
+			else if (p_reproduction_callback->sex_specificity_ != IndividualSex::kUnspecified)
+				SLIM_ERRSTREAM << "NULL, \"" << p_reproduction_callback->sex_specificity_ << "\"";
+			SLIM_ERRSTREAM << ")";
+			
+			if (p_reproduction_callback->block_id_ != -1)
+				SLIM_ERRSTREAM << " s" << p_reproduction_callback->block_id_;
+			
+			SLIM_ERRSTREAM << " (line " << (decl_token->token_line_ + 1) << community_.DebugPointInfo() << ")" << std::endl;
+			indenter.indent();
+		}
+	}
+#endif
+	
+	// We need to actually execute the script; we start a block here to manage the lifetime of the symbol table
+	{
+		EidosSymbolTable callback_symbols(EidosSymbolTableType::kContextConstantsTable, &community_.SymbolTable());
+		EidosSymbolTable client_symbols(EidosSymbolTableType::kLocalVariablesTable, &callback_symbols);
+		EidosFunctionMap &function_map = community_.FunctionMap();
+		EidosInterpreter interpreter(p_reproduction_callback->compound_statement_node_, client_symbols, function_map, &community_, SLIM_OUTSTREAM, SLIM_ERRSTREAM
+#ifdef SLIMGUI
+			, community_.check_infinite_loops_
+#endif
+			);
+		
+		if (p_reproduction_callback->contains_self_)
+			callback_symbols.InitializeConstantSymbolEntry(p_reproduction_callback->SelfSymbolTableEntry());		// define "self"
+		if (p_reproduction_callback->contains_individual_)
+		{
+			if ((first_index == 0) && (last_index == parent_subpop_size_))
+			{
+				callback_symbols.InitializeConstantSymbolEntry(gID_individual, CachedParentIndividualsValue());
+			}
+			else
+			{
+				EidosValue_Object *individual_vec = (new (gEidosValuePool->AllocateChunk()) EidosValue_Object(gSLiM_Individual_Class))->resize_no_initialize(last_index - first_index);
+				
+				for (slim_popsize_t individual_index = first_index; individual_index < last_index; ++individual_index)
+					individual_vec->set_object_element_no_check_NORR(parent_individuals_[individual_index], individual_index - first_index);
+				
+				callback_symbols.InitializeConstantSymbolEntry(gID_individual, EidosValue_SP(individual_vec));
+			}
+		}
+		if (p_reproduction_callback->contains_subpop_)
+			callback_symbols.InitializeConstantSymbolEntry(gID_subpop, SymbolTableEntry().second);
+		
+		// Interpret the script; as for non-vectorized reproduction() callbacks, there must be no return value
+		EidosValue_SP result_SP = interpreter.EvaluateInternalBlock(p_reproduction_callback->script_);
+		
+		if (result_SP->Type() != EidosValueType::kValueVOID)
+			EIDOS_TERMINATION << "ERROR (Subpopulation::ApplyVectorizedReproductionCallback): reproduction() callbacks must not return a value (i.e., must return void)." << EidosTerminate(p_reproduction_callback->identifier_token_);
+	}
+	
+#if (SLIMPROFILING == 1)
+	// PROFILING
+	SLIM_PROFILE_BLOCK_END(community_.profile_callback_totals_[(int)(SLiMEidosBlockType::SLiMEidosReproductionCallback)]);
+#endif
+}
+
 // nonWF only:
 void Subpopulation::ReproduceSubpopulation(void)
 {
@@ -5755,6 +6507,31 @@ void Subpopulation::ReproduceSubpopulation(void)
 	if (registered_reproduction_callbacks_.size() == 0)
 		return;
 	
+	// vectorized reproduction() callbacks are called first, once each for the whole subpopulation; the remaining callbacks are then
+	// called for each individual in turn as usual
+	std::vector<SLiMEidosBlock*> *reproduction_callbacks = &registered_reproduction_callbacks_;
+	std::vector<SLiMEidosBlock*> per_individual_callbacks;
+	
+	for (SLiMEidosBlock *reproduction_callback : registered_reproduction_callbacks_)
+	{
+		if (reproduction_callback->RunsVectorized())
+		{
+			for (SLiMEidosBlock *callback : registered_reproduction_callbacks_)
+			{
+				if (!callback->RunsVectorized())
+					per_individual_callbacks.emplace_back(callback);
+				else if (callback->block_active_)
+					ApplyVectorizedReproductionCallback(callback);
+			}
+			
+			if (per_individual_callbacks.size() == 0)
+				return;
+			
+			reproduction_callbacks = &per_individual_callbacks;
+			break;
+		}
+	}
+	
 	if (species_.RandomizingCallbackOrder())
 	{
 		slim_popsize_t *shuffle_buf = species_.BorrowShuffleBuffer(parent_subpop_size_);
@@ -5763,7 +6540,7 @@ void Subpopulation::ReproduceSubpopulation(void)
 		{
 			slim_popsize_t individual_index = shuffle_buf[shuffle_index];
 			
-			ApplyReproductionCallbacks(registered_reproduction_callbacks_, individual_index);
+			ApplyReproductionCallbacks(*reproduction_callbacks, individual_index);
 		}
 		
 		species_.ReturnShuffleBuffer();
@@ -5771,7 +6548,7 @@ void Subpopulation::ReproduceSubpopulation(void)
 	else
 	{
 		for (int individual_index = 0; individual_index < parent_subpop_size_; ++individual_index)
-			ApplyReproductionCallbacks(registered_reproduction_callbacks_, individual_index);
+			ApplyReproductionCallbacks(*reproduction_callbacks, individual_index);
 	}
 }
 
@@ -5855,12 +6632,13 @@ void Subpopulation::MergeReproductionOffspring(void)
 	parent_subpop_size_ += new_count;
 	
 	cached_parent_individuals_value_.reset();
+	cached_fitness_size_ = 0;
 	
 	nonWF_offspring_individuals_.resize(0);
 }
 
 // nonWF only:
-bool Subpopulation::ApplySurvivalCallbacks(std::vector<SLiMEidosBlock*> &p_survival_callbacks, Individual *p_individual, double p_fitness, double p_draw, bool p_surviving)
+bool Subpopulation::ApplySurvivalCallbacks(std::vector<SLiMEidosBlock*> &p_survival_callbacks, Individual *p_individual, double p_fitness, double p_draw, bool p_surviving, Subpopulation *p_move_destination)
 {
 	THREAD_SAFETY_IN_ANY_PARALLEL("Population::ApplySurvivalCallbacks(): running Eidos callback");
 	
@@ -5869,7 +6647,7 @@ bool Subpopulation::ApplySurvivalCallbacks(std::vector<SLiMEidosBlock*> &p_survi
 	SLIM_PROFILE_BLOCK_START();
 #endif
 	
-	Subpopulation *move_destination = nullptr;
+	Subpopulation *move_destination = p_move_destination;		// a move decision already made by a vectorized survival() callback, if any
 	
 	for (SLiMEidosBlock *survival_callback : p_survival_callbacks)
 	{
@@ -5906,99 +6684,103 @@ bool Subpopulation::ApplySurvivalCallbacks(std::vector<SLiMEidosBlock*> &p_survi
 			// The callback is active, so we need to execute it
 			// This code is similar to Population::ExecuteScript, but we set up an additional symbol table, and we use the return value
 			{
-				// local variables for the callback parameters that we might need to allocate here, and thus need to free below
+				// local variables for the callback parameters that we might need to allocate here; these must outlive result_SP
 				EidosValue_Float local_fitness(p_fitness);
 				EidosValue_Float local_draw(p_draw);
+				EidosValue_SP result_SP;
+				EidosBytecodeValue bytecode_result;
 				
-				// We need to actually execute the script; we start a block here to manage the lifetime of the symbol table
+				if (community_.ExecuteBlockBytecode(survival_callback, {EidosBytecodeValue::Object(survival_callback), EidosBytecodeValue::Object(p_individual), EidosBytecodeValue::Object(this), EidosBytecodeValue::Logical(p_surviving), EidosBytecodeValue::Float(p_fitness), EidosBytecodeValue::Float(p_draw)}, &bytecode_result))
 				{
-					EidosSymbolTable callback_symbols(EidosSymbolTableType::kContextConstantsTable, &community_.SymbolTable());
-					EidosSymbolTable client_symbols(EidosSymbolTableType::kLocalVariablesTable, &callback_symbols);
-					EidosFunctionMap &function_map = community_.FunctionMap();
-					EidosInterpreter interpreter(survival_callback->compound_statement_node_, client_symbols, function_map, &community_, SLIM_OUTSTREAM, SLIM_ERRSTREAM
+					// The callback body was compiled to bytecode, and ran without needing to fall back to the interpreter
+					result_SP = bytecode_result.BoxedValue();
+				}
+				else
+				{
+					// We need to actually execute the script; we start a block here to manage the lifetime of the symbol table
+					{
+						EidosSymbolTable callback_symbols(EidosSymbolTableType::kContextConstantsTable, &community_.SymbolTable());
+						EidosSymbolTable client_symbols(EidosSymbolTableType::kLocalVariablesTable, &callback_symbols);
+						EidosFunctionMap &function_map = community_.FunctionMap();
+						EidosInterpreter interpreter(survival_callback->compound_statement_node_, client_symbols, function_map, &community_, SLIM_OUTSTREAM, SLIM_ERRSTREAM
 #ifdef SLIMGUI
-						, community_.check_infinite_loops_
+							, community_.check_infinite_loops_
 #endif
-						);
-					
-					if (survival_callback->contains_self_)
-						callback_symbols.InitializeConstantSymbolEntry(survival_callback->SelfSymbolTableEntry());		// define "self"
-					
-					// Set all of the callback's parameters; note we use InitializeConstantSymbolEntry() for speed.
-					// We can use that method because we know the lifetime of the symbol table is shorter than that of
-					// the value objects, and we know that the values we are setting here will not change (the objects
-					// referred to by the values may change, but the values themselves will not change).
-					// BCH 11/7/2025: note these symbols are now protected in SLiM_ConfigureContext()
-					if (survival_callback->contains_fitness_)
-					{
-						local_fitness.StackAllocated();		// prevent Eidos_intrusive_ptr from trying to delete this
-						callback_symbols.InitializeConstantSymbolEntry(gID_fitness, EidosValue_SP(&local_fitness));
-					}
-					if (survival_callback->contains_draw_)
-					{
-						local_draw.StackAllocated();		// prevent Eidos_intrusive_ptr from trying to delete this
-						callback_symbols.InitializeConstantSymbolEntry(gID_draw, EidosValue_SP(&local_draw));
-					}
-					if (survival_callback->contains_individual_)
-						callback_symbols.InitializeConstantSymbolEntry(gID_individual, p_individual->CachedEidosValue());
-					if (survival_callback->contains_subpop_)
-						callback_symbols.InitializeConstantSymbolEntry(gID_subpop, SymbolTableEntry().second);
-					if (survival_callback->contains_surviving_)
-						callback_symbols.InitializeConstantSymbolEntry(gID_surviving, p_surviving ? gStaticEidosValue_LogicalT : gStaticEidosValue_LogicalF);
-					
-					try
-					{
-						// Interpret the script; the result from the interpretation must be a singleton double used as a new fitness value
-						EidosValue_SP result_SP = interpreter.EvaluateInternalBlock(survival_callback->script_);
-						EidosValue *result = result_SP.get();
-						EidosValueType result_type = result->Type();
+							);
+						
+						if (survival_callback->contains_self_)
+							callback_symbols.InitializeConstantSymbolEntry(survival_callback->SelfSymbolTableEntry());		// define "self"
 						
-						if (result_type == EidosValueType::kValueNULL)
+						// Set all of the callback's parameters; note we use InitializeConstantSymbolEntry() for speed.
+						// We can use that method because we know the lifetime of the symbol table is shorter than that of
+						// the value objects, and we know that the values we are setting here will not change (the objects
+						// referred to by the values may change, but the values themselves will not change).
+						// BCH 11/7/2025: note these symbols are now protected in SLiM_ConfigureContext()
+						if (survival_callback->contains_fitness_)
 						{
-							// NULL means don't change the existing decision
+							local_fitness.StackAllocated();		// prevent Eidos_intrusive_ptr from trying to delete this
+							callback_symbols.InitializeConstantSymbolEntry(gID_fitness, EidosValue_SP(&local_fitness));
 						}
-						else if ((result_type == EidosValueType::kValueLogical) &&
-								 (result->Count() == 1))
+						if (survival_callback->contains_draw_)
 						{
-							// T or F means change the existing decision to that value
+							local_draw.StackAllocated();		// prevent Eidos_intrusive_ptr from trying to delete this
+							callback_symbols.InitializeConstantSymbolEntry(gID_draw, EidosValue_SP(&local_draw));
+						}
+						if (survival_callback->contains_individual_)
+							callback_symbols.InitializeConstantSymbolEntry(gID_individual, p_individual->CachedEidosValue());
+						if (survival_callback->contains_subpop_)
+							callback_symbols.InitializeConstantSymbolEntry(gID_subpop, SymbolTableEntry().second);
+						if (survival_callback->contains_surviving_)
+							callback_symbols.InitializeConstantSymbolEntry(gID_surviving, p_surviving ? gStaticEidosValue_LogicalT : gStaticEidosValue_LogicalF);
+						
+						// Interpret the script; the result must be NULL, T, F, or a Subpopulation, and is handled below
+						result_SP = interpreter.EvaluateInternalBlock(survival_callback->script_);
+					}
+				}
+				
+				EidosValue *result = result_SP.get();
+				EidosValueType result_type = result->Type();
+				
+				if (result_type == EidosValueType::kValueNULL)
+				{
+					// NULL means don't change the existing decision
+				}
+				else if ((result_type == EidosValueType::kValueLogical) &&
+						 (result->Count() == 1))
+				{
+					// T or F means change the existing decision to that value
 #if DEBUG
-							// this checks the value type at runtime
-							p_surviving = result->LogicalData()[0];
+					// this checks the value type at runtime
+					p_surviving = result->LogicalData()[0];
 #else
-							// unsafe cast for speed
-							p_surviving = ((EidosValue_Logical *)result)->data()[0];
+					// unsafe cast for speed
+					p_surviving = ((EidosValue_Logical *)result)->data()[0];
 #endif
-							
-							move_destination = nullptr;		// cancel a previously made move decision; T/F says "do not move"
-						}
-						else if ((result_type == EidosValueType::kValueObject) &&
-								 (result->Count() == 1) &&
-								 (((EidosValue_Object *)result)->Class() == gSLiM_Subpopulation_Class))
-						{
-							// a Subpopulation object means the individual should move to that subpop (and live); this is done in a post-pass
-							// moving to one's current subpopulation is not-moving; it is equivalent to returning T (i.e., forces survival)
-							p_surviving = true;
-							
+					
+					move_destination = nullptr;		// cancel a previously made move decision; T/F says "do not move"
+				}
+				else if ((result_type == EidosValueType::kValueObject) &&
+						 (result->Count() == 1) &&
+						 (((EidosValue_Object *)result)->Class() == gSLiM_Subpopulation_Class))
+				{
+					// a Subpopulation object means the individual should move to that subpop (and live); this is done in a post-pass
+					// moving to one's current subpopulation is not-moving; it is equivalent to returning T (i.e., forces survival)
+					p_surviving = true;
+					
 #if DEBUG
-							// this checks the value type at runtime
-							Subpopulation *destination = (Subpopulation *)result->ObjectData()[0];
+					// this checks the value type at runtime
+					Subpopulation *destination = (Subpopulation *)result->ObjectData()[0];
 #else
-							// unsafe cast for speed
-							Subpopulation *destination = (Subpopulation *)((EidosValue_Object *)result)->data()[0];
+					// unsafe cast for speed
+					Subpopulation *destination = (Subpopulation *)((EidosValue_Object *)result)->data()[0];
 #endif
-							
-							if (destination != this)
-								move_destination = destination;
-						}
-						else
-						{
-							EIDOS_TERMINATION << "ERROR (Subpopulation::ApplySurvivalCallbacks): survival() callbacks must provide a return value of NULL, T, F, or object<Subpopulation>$." << EidosTerminate(survival_callback->identifier_token_);
-						}
-					}
-					catch (...)
-					{
-						throw;
-					}
+					
+					if (destination != this)
+						move_destination = destination;
+				}
+				else
+				{
+					EIDOS_TERMINATION << "ERROR (Subpopulation::ApplySurvivalCallbacks): survival() callbacks must provide a return value of NULL, T, F, or object<Subpopulation>$." << EidosTerminate(survival_callback->identifier_token_);
 				}
 			}
 		}
@@ -6019,6 +6801,124 @@ bool Subpopulation::ApplySurvivalCallbacks(std::vector<SLiMEidosBlock*> &p_survi
 	return p_surviving;
 }
 
+// nonWF only:
+// Run a vectorized survival() callback once for the whole subpopulation, with individual, fitness, draw, and surviving bound as
+// parallel vectors; its result, NULL or a vector with one element per individual, modifies p_surviving and p_move_destinations
+void Subpopulation::ApplyVectorizedSurvivalCallback(SLiMEidosBlock *p_survival_callback, const double *p_fitness, const double *p_draw, uint8_t *p_surviving, Subpopulation **p_move_destinations)
+{
+	THREAD_SAFETY_IN_ANY_PARALLEL("Population::ApplyVectorizedSurvivalCallback(): running Eidos callback");
+	
+	if (parent_subpop_size_ == 0)
+		return;
+	
+#if (SLIMPROFILING == 1)
+	// PROFILING
+	SLIM_PROFILE_BLOCK_START();
+#endif
+	
+#if DEBUG_POINTS_ENABLED
+	// SLiMgui debugging point
+	EidosDebugPointIndent indenter;
+	
+	{
+		EidosInterpreterDebugPointsSet *debug_points = community_.DebugPoints();
+		EidosToken *decl_token = p_survival_callback->root_node_->token_;
+		
+		if (debug_points && debug_points->set.size() && (decl_token->token_line_ != -1) &&
+			(debug_points->set.find(decl_token->token_line_) != debug_points->set.end()))
+		{
+			SLIM_ERRSTREAM << EidosDebugPointIndent::Indent() << "#DEBUG survival(";
+			if (p_survival_callback->subpopulation_id_ != -1)
+				SLIM_ERRSTREAM << "p" << p_survival_callback->subpopulation_id_;
+			SLIM_ERRSTREAM << ")";
+			
+			if (p_survival_callback->block_id_ != -1)
+				SLIM_ERRSTREAM << " s" << p_survival_callback->block_id_;
+			
+			SLIM_ERRSTREAM << " (line " << (decl_token->token_line_ + 1) << community_.DebugPointInfo() << ")" << std::endl;
+			indenter.indent();
+		}
+	}
+#endif
+	
+	// We need to actually execute the script; we start a block here to manage the lifetime of the symbol table
+	{
+		slim_popsize_t subpop_size = parent_subpop_size_;
+		EidosSymbolTable callback_symbols(EidosSymbolTableType::kContextConstantsTable, &community_.SymbolTable());
+		EidosSymbolTable client_symbols(EidosSymbolTableType::kLocalVariablesTable, &callback_symbols);
+		EidosFunctionMap &function_map = community_.FunctionMap();
+		EidosInterpreter interpreter(p_survival_callback->compound_statement_node_, client_symbols, function_map, &community_, SLIM_OUTSTREAM, SLIM_ERRSTREAM
+#ifdef SLIMGUI
+			, community_.check_infinite_loops_
+#endif
+			);
+		
+		if (p_survival_callback->contains_self_)
+			callback_symbols.InitializeConstantSymbolEntry(p_survival_callback->SelfSymbolTableEntry());		// define "self"
+		if (p_survival_callback->contains_fitness_)
+			callback_symbols.InitializeConstantSymbolEntry(gID_fitness, EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Float(p_fitness, subpop_size)));
+		if (p_survival_callback->contains_draw_)
+			callback_symbols.InitializeConstantSymbolEntry(gID_draw, EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Float(p_draw, subpop_size)));
+		if (p_survival_callback->contains_individual_)
+			callback_symbols.InitializeConstantSymbolEntry(gID_individual, CachedParentIndividualsValue());
+		if (p_survival_callback->contains_subpop_)
+			callback_symbols.InitializeConstantSymbolEntry(gID_subpop, SymbolTableEntry().second);
+		if (p_survival_callback->contains_surviving_)
+		{
+			EidosValue_Logical *surviving_vec = (new (gEidosValuePool->AllocateChunk()) EidosValue_Logical())->resize_no_initialize(subpop_size);
+			
+			for (slim_popsize_t individual_index = 0; individual_index < subpop_size; ++individual_index)
+				surviving_vec->set_logical_no_check(p_surviving[individual_index] != 0, individual_index);
+			
+			callback_symbols.InitializeConstantSymbolEntry(gID_surviving, EidosValue_SP(surviving_vec));
+		}
+		
+		// Interpret the script; the result must be NULL, or a logical or object<Subpopulation> vector with one element per individual
+		EidosValue_SP result_SP = interpreter.EvaluateInternalBlock(p_survival_callback->script_);
+		EidosValue *result = result_SP.get();
+		EidosValueType result_type = result->Type();
+		
+		if (result_type == EidosValueType::kValueNULL)
+		{
+			// NULL means don't change the existing decisions
+		}
+		else if ((result_type == EidosValueType::kValueLogical) && (result->Count() == subpop_size))
+		{
+			// T or F means change the existing decision to that value, and cancel any move decision
+			const eidos_logical_t *result_data = result->LogicalData();
+			
+			for (slim_popsize_t individual_index = 0; individual_index < subpop_size; ++individual_index)
+			{
+				p_surviving[individual_index] = result_data[individual_index];
+				p_move_destinations[individual_index] = nullptr;
+			}
+		}
+		else if ((result_type == EidosValueType::kValueObject) && (result->Count() == subpop_size) &&
+				 (((EidosValue_Object *)result)->Class() == gSLiM_Subpopulation_Class))
+		{
+			// a Subpopulation object means the individual should move to that subpop (and live); moving to our own subpop is not moving
+			EidosObject * const *result_data = result->ObjectData();
+			
+			for (slim_popsize_t individual_index = 0; individual_index < subpop_size; ++individual_index)
+			{
+				Subpopulation *destination = (Subpopulation *)result_data[individual_index];
+				
+				p_surviving[individual_index] = true;
+				p_move_destinations[individual_index] = ((destination != this) ? destination : nullptr);
+			}
+		}
+		else
+		{
+			EIDOS_TERMINATION << "ERROR (Subpopulation::ApplyVectorizedSurvivalCallback): vectorized survival() callbacks must provide a return value of NULL, or a logical or object<Subpopulation> vector with one element per individual." << EidosTerminate(p_survival_callback->identifier_token_);
+		}
+	}
+	
+#if (SLIMPROFILING == 1)
+	// PROFILING
+	SLIM_PROFILE_BLOCK_END(community_.profile_callback_totals_[(int)(SLiMEidosBlockType::SLiMEidosSurvivalCallback)]);
+#endif
+}
+
 void Subpopulation::ViabilitySurvival(std::vector<SLiMEidosBlock*> &p_survival_callbacks)
 {
 	THREAD_SAFETY_IN_ANY_PARALLEL("Subpopulation::ViabilitySurvival(): usage of statics, probably many other issues");
@@ -6030,6 +6930,7 @@ void Subpopulation::ViabilitySurvival(std::vector<SLiMEidosBlock*> &p_survival_c
 	bool individuals_died = false;
 	bool pedigrees_enabled = species_.PedigreesEnabled();
 	bool no_callbacks = (p_survival_callbacks.size() == 0);
+	double *fitness_column = CachedParentalFitness();
 	
 	// We keep a global static buffer that records survival decisions
 	static uint8_t *survival_buffer = nullptr;
@@ -6056,7 +6957,7 @@ void Subpopulation::ViabilitySurvival(std::vector<SLiMEidosBlock*> &p_survival_c
 		// this is the simple case with no callbacks and thus no shuffle buffer
 		EIDOS_BENCHMARK_START(EidosBenchmarkType::k_SURVIVAL);
 		EIDOS_THREAD_COUNT(gEidos_OMP_threads_SURVIVAL);
-#pragma omp parallel default(none) shared(gEidos_RNG_PERTHREAD, survival_buffer, parent_subpop_size_) firstprivate(individual_data) if(parent_subpop_size_ >= EIDOS_OMPMIN_SURVIVAL) num_threads(thread_count)
+#pragma omp parallel default(none) shared(gEidos_RNG_PERTHREAD, survival_buffer, parent_subpop_size_) firstprivate(fitness_column) if(parent_subpop_size_ >= EIDOS_OMPMIN_SURVIVAL) num_threads(thread_count)
 		{
 			uint8_t *survival_buf_perthread = survival_buffer;
 			EidosRNG_64_bit &rng_64 = EIDOS_64BIT_RNG(omp_get_thread_num());
@@ -6064,8 +6965,7 @@ void Subpopulation::ViabilitySurvival(std::vector<SLiMEidosBlock*> &p_survival_c
 #pragma omp for schedule(dynamic, 1024) nowait
 			for (int individual_index = 0; individual_index < parent_subpop_size_; ++individual_index)
 			{
-				Individual *individual = individual_data[individual_index];
-				double fitness = individual->cached_fitness_UNSAFE_;	// never overridden in nonWF models, so this is safe with no check
+				double fitness = fitness_column[individual_index];
 				uint8_t survived;
 				
 				if (fitness <= 0.0)			survived = false;
@@ -6083,18 +6983,61 @@ void Subpopulation::ViabilitySurvival(std::vector<SLiMEidosBlock*> &p_survival_c
 		slim_popsize_t *shuffle_buf = species_.BorrowShuffleBuffer(parent_subpop_size_);
 		EidosRNG_64_bit &rng_64 = EIDOS_64BIT_RNG(omp_get_thread_num());
 		
-		for (slim_popsize_t shuffle_index = 0; shuffle_index < parent_subpop_size_; shuffle_index++)
+		// vectorized survival() callbacks are called first, once each for the whole subpopulation; the remaining callbacks are then
+		// called for each individual in turn as usual, seeing the decisions made by the vectorized callbacks
+		std::vector<SLiMEidosBlock*> vectorized_callbacks, per_individual_callbacks;
+		
+		for (SLiMEidosBlock *survival_callback : p_survival_callbacks)
 		{
-			slim_popsize_t individual_index = shuffle_buf[shuffle_index];
-			Individual *individual = individual_data[individual_index];
-			double fitness = individual->cached_fitness_UNSAFE_;	// never overridden in nonWF models, so this is safe with no check
-			double draw = Eidos_rng_uniform_doubleCO(rng_64);		// always need a draw to pass to the callback
-			uint8_t survived = (draw < fitness);
+			if (survival_callback->RunsVectorized())
+				vectorized_callbacks.emplace_back(survival_callback);
+			else
+				per_individual_callbacks.emplace_back(survival_callback);
+		}
+		
+		if (vectorized_callbacks.size() == 0)
+		{
+			for (slim_popsize_t shuffle_index = 0; shuffle_index < parent_subpop_size_; shuffle_index++)
+			{
+				slim_popsize_t individual_index = shuffle_buf[shuffle_index];
+				Individual *individual = individual_data[individual_index];
+				double fitness = fitness_column[individual_index];
+				double draw = Eidos_rng_uniform_doubleCO(rng_64);		// always need a draw to pass to the callback
+				uint8_t survived = (draw < fitness);
+				
+				// run the survival() callbacks to allow the above decision to be modified
+				survived = ApplySurvivalCallbacks(p_survival_callbacks, individual, fitness, draw, survived);
+				
+				survival_buffer[individual_index] = survived;
+			}
+		}
+		else
+		{
+			// draws are made in the same order as above, so the random number sequence is the same as without vectorization
+			std::vector<double> draws(parent_subpop_size_);
+			std::vector<Subpopulation *> move_destinations(parent_subpop_size_, nullptr);
+			
+			for (slim_popsize_t shuffle_index = 0; shuffle_index < parent_subpop_size_; shuffle_index++)
+			{
+				slim_popsize_t individual_index = shuffle_buf[shuffle_index];
+				double fitness = fitness_column[individual_index];
+				double draw = Eidos_rng_uniform_doubleCO(rng_64);
+				
+				draws[individual_index] = draw;
+				survival_buffer[individual_index] = (draw < fitness);
+			}
 			
-			// run the survival() callbacks to allow the above decision to be modified
-			survived = ApplySurvivalCallbacks(p_survival_callbacks, individual, fitness, draw, survived);
+			for (SLiMEidosBlock *survival_callback : vectorized_callbacks)
+				if (survival_callback->block_active_)
+					ApplyVectorizedSurvivalCallback(survival_callback, fitness_column, draws.data(), survival_buffer, move_destinations.data());
 			
-			survival_buffer[individual_index] = survived;
+			// this registers the final move decisions, even if there are no remaining callbacks to run
+			for (slim_popsize_t shuffle_index = 0; shuffle_index < parent_subpop_size_; shuffle_index++)
+			{
+				slim_popsize_t individual_index = shuffle_buf[shuffle_index];
+				
+				survival_buffer[individual_index] = ApplySurvivalCallbacks(per_individual_callbacks, individual_data[individual_index], fitness_column[individual_index], draws[individual_index], survival_buffer[individual_index], move_destinations[individual_index]);
+			}
 		}
 		
 		species_.ReturnShuffleBuffer();
@@ -6113,6 +7056,7 @@ void Subpopulation::ViabilitySurvival(std::vector<SLiMEidosBlock*> &p_survival_c
 			{
 				individual_data[survived_individual_index] = individual;
 				individual_data[survived_individual_index]->index_ = survived_individual_index;
+				fitness_column[survived_individual_index] = fitness_column[individual_index];
 			}
 			
 			survived_individual_index++;
@@ -6162,6 +7106,7 @@ void Subpopulation::ViabilitySurvival(std::vector<SLiMEidosBlock*> &p_survival_c
 		parent_individuals_.resize(parent_subpop_size_);
 		
 		cached_parent_individuals_value_.reset();
+		cached_fitness_size_ = parent_subpop_size_;		// the fitness column was compacted along with parent_individuals_
 	}
 }
 
@@ -6186,14 +7131,9 @@ size_t Subpopulation::MemoryUsageForParentTables(void)
 {
 	size_t usage = 0;
 	
-	if (lookup_parent_)
-		usage += lookup_parent_->K * (sizeof(size_t) + sizeof(double));
-	
-	if (lookup_female_parent_)
-		usage += lookup_female_parent_->K * (sizeof(size_t) + sizeof(double));
-	
-	if (lookup_male_parent_)
-		usage += lookup_male_parent_->K * (sizeof(size_t) + sizeof(double));
+	usage += lookup_parent_.MemoryUsage();
+	usage += lookup_female_parent_.MemoryUsage();
+	usage += lookup_male_parent_.MemoryUsage();
 	
 	return usage;
 }
@@ -6206,6 +7146,27 @@ size_t Subpopulation::MemoryUsageForParentTables(void)
 #pragma mark Eidos support
 #pragma mark -
 
+EidosValue_SP Subpopulation::CachedParentIndividualsValue(void)
+{
+	slim_popsize_t subpop_size = parent_subpop_size_;
+	
+	// Check for an outdated cache; this should never happen, so we flag it as an error
+	if (cached_parent_individuals_value_ && (cached_parent_individuals_value_->Count() != subpop_size))
+		EIDOS_TERMINATION << "ERROR (Subpopulation::CachedParentIndividualsValue): (internal error) cached_parent_individuals_value_ out of date." << EidosTerminate();
+	
+	// Build and return an EidosValue_Object with the current set of individuals in it
+	if (!cached_parent_individuals_value_)
+	{
+		EidosValue_Object *vec = (new (gEidosValuePool->AllocateChunk()) EidosValue_Object(gSLiM_Individual_Class))->reserve(subpop_size);
+		cached_parent_individuals_value_ = EidosValue_SP(vec);
+		
+		for (slim_popsize_t individual_index = 0; individual_index < subpop_size; individual_index++)
+			vec->push_object_element_no_check_NORR(parent_individuals_[individual_index]);
+	}
+	
+	return cached_parent_individuals_value_;
+}
+
 const EidosClass *Subpopulation::Class(void) const
 {
 	return gSLiM_Subpopulation_Class;
@@ -6275,23 +7236,7 @@ EidosValue_SP Subpopulation::GetProperty(EidosGlobalStringID p_property_id)
 		}
 		case gID_individuals:
 		{
-			slim_popsize_t subpop_size = parent_subpop_size_;
-			
-			// Check for an outdated cache; this should never happen, so we flag it as an error
-			if (cached_parent_individuals_value_ && (cached_parent_individuals_value_->Count() != subpop_size))
-				EIDOS_TERMINATION << "ERROR (Subpopulation::GetProperty): (internal error) cached_parent_individuals_value_ out of date." << EidosTerminate();
-			
-			// Build and return an EidosValue_Object with the current set of individuals in it
-			if (!cached_parent_individuals_value_)
-			{
-				EidosValue_Object *vec = (new (gEidosValuePool->AllocateChunk()) EidosValue_Object(gSLiM_Individual_Class))->reserve(subpop_size);
-				cached_parent_individuals_value_ = EidosValue_SP(vec);
-				
-				for (slim_popsize_t individual_index = 0; individual_index < subpop_size; individual_index++)
-					vec->push_object_element_no_check_NORR(parent_individuals_[individual_index]);
-			}
-			
-			return cached_parent_individuals_value_;
+			return CachedParentIndividualsValue();
 		}
 		case gID_immigrantSubpopIDs:
 		{
@@ -8899,7 +9844,10 @@ EidosValue_SP Subpopulation::ExecuteMethod_takeMigrants(EidosGlobalStringID p_me
 		// most models.  Note that the child haplosomes/individuals caches don't need to be thrown away,
 		// because they aren't used in nonWF models and this is a nonWF-only method.
 		for (auto subpop_pair : population_.subpops_)
+		{
 			subpop_pair.second->cached_parent_individuals_value_.reset();
+			subpop_pair.second->cached_fitness_size_ = 0;
+		}
 		
 		// Invalidate interactions; we just do this for all subpops, for now, rather than trying to
 		// selectively invalidate only the subpops involved in the migrations that occurred
@@ -11460,22 +12408,23 @@ EidosValue_SP Subpopulation::ExecuteMethod_cachedFitness(EidosGlobalStringID p_m
 	EidosValue_Float *float_return = (new (gEidosValuePool->AllocateChunk()) EidosValue_Float())->resize_no_initialize(index_count);
 	EidosValue_SP result_SP = EidosValue_SP(float_return);
 	const int64_t *indices = (do_all_indices ? nullptr : indices_value->IntData());
+	const double *fitness_column = CachedParentalFitness();
 	
-	for (slim_popsize_t value_index = 0; value_index < index_count; value_index++)
+	if (do_all_indices && (index_count > 0))
 	{
-		slim_popsize_t index = value_index;
-		
-		if (!do_all_indices)
+		memcpy(float_return->data_mutable(), fitness_column, index_count * sizeof(double));
+	}
+	else
+	{
+		for (slim_popsize_t value_index = 0; value_index < index_count; value_index++)
 		{
-			index = SLiMCastToPopsizeTypeOrRaise(indices[value_index]);
+			slim_popsize_t index = SLiMCastToPopsizeTypeOrRaise(indices[value_index]);
 			
 			if (index >= parent_subpop_size_)
 				EIDOS_TERMINATION << "ERROR (Subpopulation::ExecuteMethod_cachedFitness): cachedFitness() index " << index << " out of range." << EidosTerminate();
+			
+			float_return->set_float_no_check(fitness_column[index], value_index);
 		}
-		
-		double fitness = (individual_cached_fitness_OVERRIDE_ ? individual_cached_fitness_OVERRIDE_value_ : parent_individuals_[index]->cached_fitness_UNSAFE_);
-		
-		float_return->set_float_no_check(fitness, value_index);
 	}
 	
 	return result_SP;
@@ -12514,19 +13463,26 @@ EidosValue_SP Subpopulation::ExecuteMethod_outputXSample(EidosGlobalStringID p_m
 	
 	// Figure out the right output stream
 	std::ofstream outfile;
-	bool has_file = false;
+	std::ostringstream outbuffer;
+	bool has_file = false, async_file = false, append = false;
 	std::string outfile_path;
 	
 	if (filePath_arg->Type() != EidosValueType::kValueNULL)
 	{
 		outfile_path = Eidos_ResolvedPath(filePath_arg->StringAtIndex_NOCAST(0, nullptr));
-		bool append = append_arg->LogicalAtIndex_NOCAST(0, nullptr);
-		
-		outfile.open(outfile_path.c_str(), append ? (std::ios_base::app | std::ios_base::out) : std::ios_base::out);
+		append = append_arg->LogicalAtIndex_NOCAST(0, nullptr);
 		has_file = true;
 		
-		if (!outfile.is_open())
-			EIDOS_TERMINATION << "ERROR (Subpopulation::ExecuteMethod_outputXSample): " << EidosStringRegistry::StringForGlobalStringID(p_method_id) << "() could not open "<< outfile_path << "." << EidosTerminate();
+		// with asynchronous file writing, we format the output in memory and then hand it off to the writer thread
+		async_file = Eidos_AsyncFileWritingEnabled();
+		
+		if (!async_file)
+		{
+			outfile.open(outfile_path.c_str(), append ? (std::ios_base::app | std::ios_base::out) : std::ios_base::out);
+			
+			if (!outfile.is_open())
+				EIDOS_TERMINATION << "ERROR (Subpopulation::ExecuteMethod_outputXSample): " << EidosStringRegistry::StringForGlobalStringID(p_method_id) << "() could not open "<< outfile_path << "." << EidosTerminate();
+		}
 	}
 	else
 	{
@@ -12534,7 +13490,7 @@ EidosValue_SP Subpopulation::ExecuteMethod_outputXSample(EidosGlobalStringID p_m
 		Eidos_EraseProgress();
 	}
 	
-	std::ostream &out = *(has_file ? dynamic_cast<std::ostream *>(&outfile) : dynamic_cast<std::ostream *>(&output_stream));
+	std::ostream &out = *(async_file ? dynamic_cast<std::ostream *>(&outbuffer) : (has_file ? dynamic_cast<std::ostream *>(&outfile) : dynamic_cast<std::ostream *>(&output_stream)));
 	
 	if (!has_file || (p_method_id == gID_outputSample))
 	{
@@ -12573,7 +13529,9 @@ EidosValue_SP Subpopulation::ExecuteMethod_outputXSample(EidosGlobalStringID p_m
 	else if (p_method_id == gID_outputVCFSample)
 		population_.PrintSample_VCF(out, *this, sample_size, replace, requested_sex, *chromosome, output_multiallelics, simplify_nucs, output_nonnucs, group_as_individuals);
 	
-	if (has_file)
+	if (async_file)
+		Eidos_WriteDataToFile(outfile_path, outbuffer.str(), append, false);
+	else if (has_file)
 		outfile.close(); 
 	
 	return gStaticEidosValueVOID;
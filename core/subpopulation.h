@@ -90,9 +90,11 @@ private:
 private:
 	
 	// WF only:
-	gsl_ran_discrete_t *lookup_parent_ = nullptr;			// OWNED POINTER: lookup table for drawing a parent based upon fitness
-	gsl_ran_discrete_t *lookup_female_parent_ = nullptr;	// OWNED POINTER: lookup table for drawing a female parent based upon fitness, SEX ONLY
-	gsl_ran_discrete_t *lookup_male_parent_ = nullptr;		// OWNED POINTER: lookup table for drawing a male parent based upon fitness, SEX ONLY
+	// These are rebuilt from cached_parental_fitness_ by UpdateWFFitnessBuffers(); they are left empty in pure neutral models, in which
+	// case parents are drawn with equal probability instead.
+	EidosAliasTable lookup_parent_;			// lookup table for drawing a parent based upon fitness
+	EidosAliasTable lookup_female_parent_;	// lookup table for drawing a female parent based upon fitness, SEX ONLY
+	EidosAliasTable lookup_male_parent_;	// lookup table for drawing a male parent based upon fitness, SEX ONLY
 	
 	EidosSymbolTableEntry self_symbol_;						// for fast setup of the symbol table
 	
@@ -160,16 +162,16 @@ public:
 	std::vector<SLiMEidosBlock*> registered_mutation_callbacks_;		// NOT OWNED: valid only during EvolveSubpopulation; callbacks used when this subpop is parental
 	std::vector<SLiMEidosBlock*> registered_reproduction_callbacks_;	// nonWF only; NOT OWNED: valid only during EvolveSubpopulation; callbacks used when this subpop is parental
 	
-	// WF only:
-	// Fitness caching.  Every individual now caches its fitness internally, and that is what is used by SLiMgui and by the cachedFitness() method of Subpopulation.
-	// These fitness cache buffers are additional to that, used only in WF models.  They are used for two things.  First, as the data source for setting up our lookup
-	// objects for drawing mates by fitness; the GSL wants that data to be in the form of a single buffer.  And second, by mateChoice() callbacks, which throw around
-	// vectors of weights, and want to have default weight vectors for the non-sex and sex cases.  In nonWF models these buffers are not used, and not even set up.
-	// In WF models we could continue to use these buffers for all uses (i.e., SLiMgui and cachedFitness()), but to keep the code simple it seems better to use the
-	// caches in Individual for both WF and nonWF models where possible.
+	// Fitness caching.  Every individual caches its fitness internally, but UpdateFitness() also writes the fitness values of the parental
+	// generation contiguously into cached_parental_fitness_, indexed like parent_individuals_, so that code that streams through the fitness
+	// values of a whole subpopulation does not need to visit every Individual object.  That includes, in WF models, the alias tables
+	// for drawing mates by fitness and the default weight vectors for mateChoice() callbacks (cached_male_fitness_ is for the latter, and
+	// is only set up in sexual WF models), and in both model types, viability selection and cachedFitness().  Wherever parent_individuals_
+	// is changed, cached_fitness_size_ is set to 0 to mark the buffer as stale (alongside cached_parent_individuals_value_.reset()), and
+	// CachedParentalFitness() then regathers it from the individuals on demand.
 	double *cached_parental_fitness_ = nullptr;		// OWNED POINTER: cached in UpdateFitness()
 	double *cached_male_fitness_ = nullptr;			// OWNED POINTER: SEX ONLY: same as cached_parental_fitness_ but with 0 for all females
-	slim_popsize_t cached_fitness_size_ = 0;		// the size (number of entries used) of cached_parental_fitness_ and cached_male_fitness_
+	slim_popsize_t cached_fitness_size_ = 0;		// the size (number of entries used) of cached_parental_fitness_ and cached_male_fitness_; 0 if stale
 	slim_popsize_t cached_fitness_capacity_ = 0;	// the capacity of the malloced buffers cached_parental_fitness_ and cached_male_fitness_
 	
 	// WF only:
@@ -183,6 +185,21 @@ public:
 	bool individual_cached_fitness_OVERRIDE_ = false;
 	double individual_cached_fitness_OVERRIDE_value_;
 	
+	// Per-individual fitness factors from vectorized mutationEffect() callbacks, indexed like parent_individuals_; these are computed in
+	// UpdateFitness() before the per-individual fitness loop, and folded in by FitnessOfParent().  Empty if no vectorized callback is active.
+	// vectorized_mutationEffect_types_ holds the mutation types they were computed for, which ApplyMutationEffectCallbacks() then skips.
+	std::vector<double> vectorized_mutationEffect_factors_;
+	std::vector<MutationType *> vectorized_mutationEffect_types_;
+	
+	// The same for vectorized fitnessEffect() callbacks; ApplyFitnessEffectCallbacks() starts from these factors, and skips the callbacks
+	// in vectorized_fitnessEffect_callbacks_ since they have already been run for the whole subpopulation.
+	std::vector<double> vectorized_fitnessEffect_factors_;
+	std::vector<SLiMEidosBlock *> vectorized_fitnessEffect_callbacks_;
+	
+	// The FitnessOfParent...() variant that FitnessOfParent_Incremental() calls for individuals without a valid cached mutational fitness;
+	// set up by UpdateFitness() when it chooses incremental evaluation
+	double (Subpopulation::*incremental_fitness_function_)(slim_popsize_t p_individual_index, std::vector<SLiMEidosBlock*> &p_mutationEffect_callbacks) = nullptr;
+	
 	// SEX ONLY; the default values here are for the non-sex case
 	bool sex_enabled_ = false;										// the subpopulation needs to have easy reference to whether its individuals are sexual or not
 	
@@ -289,6 +306,7 @@ public:
 #ifdef SLIMGUI
 			back->cached_unscaled_fitness_ = p_fitness;
 #endif
+			back->mutational_fitness_stamp_count_ = 0;
 			back->age_ = p_age;
 			back->index_ = p_individual_index;
 			back->subpopulation_ = this;
@@ -371,6 +389,7 @@ public:
 	double FitnessOfParent(slim_popsize_t p_individual_index, std::vector<SLiMEidosBlock*> &p_mutationEffect_callbacks);
 	double FitnessOfParent_1CH_Diploid(slim_popsize_t p_individual_index, std::vector<SLiMEidosBlock*> &p_mutationEffect_callbacks);
 	double FitnessOfParent_1CH_Haploid(slim_popsize_t p_individual_index, std::vector<SLiMEidosBlock*> &p_mutationEffect_callbacks);
+	double FitnessOfParent_Incremental(slim_popsize_t p_individual_index, std::vector<SLiMEidosBlock*> &p_mutationEffect_callbacks);
 	
 	template <const bool f_callbacks, const bool f_singlecallback>
 	double _Fitness_HaploidChromosome(Haplosome *haplosome, std::vector<SLiMEidosBlock*> &p_mutationEffect_callbacks);
@@ -378,7 +397,9 @@ public:
 	double _Fitness_DiploidChromosome(Haplosome *haplosome1, Haplosome *haplosome2, std::vector<SLiMEidosBlock*> &p_mutationEffect_callbacks);
 	
 	double ApplyMutationEffectCallbacks(MutationIndex p_mutation, int p_homozygous, double p_computed_fitness, std::vector<SLiMEidosBlock*> &p_mutationEffect_callbacks, Individual *p_individual);
+	void ApplyVectorizedMutationEffectCallback(SLiMEidosBlock *p_mutationEffect_callback, MutationType *p_mutation_type);
 	double ApplyFitnessEffectCallbacks(std::vector<SLiMEidosBlock*> &p_fitnessEffect_callbacks, slim_popsize_t p_individual_index);
+	void ApplyVectorizedFitnessEffectCallback(SLiMEidosBlock *p_fitnessEffect_callback);
 	
 	// generate newly allocated offspring individuals from parent individuals; these methods loop over
 	// chromosomes/haplosomes, and are templated for speed, providing a set of optimized variants
@@ -420,14 +441,18 @@ public:
 	void WipeIndividualsAndHaplosomes(std::vector<Individual *> &p_individuals, slim_popsize_t p_individual_count, slim_popsize_t p_first_male);
 	void GenerateChildrenToFitWF(void);		// given the set subpop size and sex ratio, configure the child generation haplosomes and individuals to fit
 	void UpdateWFFitnessBuffers(bool p_pure_neutral);																					// update the WF model fitness buffers after UpdateFitness()
+	void EnsureCachedFitnessCapacity(void);																					// grow cached_parental_fitness_ and cached_male_fitness_ to fit the parental generation
+	double *CachedParentalFitness(void);																						// the fitness of each parental individual, by index; regathered if stale
 	void TallyLifetimeReproductiveOutput(void);
 	void SwapChildAndParentHaplosomes(void);															// switch to the next generation by swapping; the children become the parents
 
 	// nonWF only:
 	void ApplyReproductionCallbacks(std::vector<SLiMEidosBlock*> &p_reproduction_callbacks, slim_popsize_t p_individual_index);
+	void ApplyVectorizedReproductionCallback(SLiMEidosBlock *p_reproduction_callback);
 	void ReproduceSubpopulation(void);
 	void MergeReproductionOffspring(void);
-	bool ApplySurvivalCallbacks(std::vector<SLiMEidosBlock*> &p_survival_callbacks, Individual *p_individual, double p_fitness, double p_draw, bool p_surviving);
+	bool ApplySurvivalCallbacks(std::vector<SLiMEidosBlock*> &p_survival_callbacks, Individual *p_individual, double p_fitness, double p_draw, bool p_surviving, Subpopulation *p_move_destination = nullptr);
+	void ApplyVectorizedSurvivalCallback(SLiMEidosBlock *p_survival_callback, const double *p_fitness, const double *p_draw, uint8_t *p_surviving, Subpopulation **p_move_destinations);
 	void ViabilitySurvival(std::vector<SLiMEidosBlock*> &p_survival_callbacks);
 	void IncrementIndividualAges(void);
 	
@@ -441,6 +466,7 @@ public:
 	// Eidos support
 	//
 	inline EidosSymbolTableEntry &SymbolTableEntry(void) { return self_symbol_; };
+	EidosValue_SP CachedParentIndividualsValue(void);		// the value of the individuals property, cached in cached_parent_individuals_value_
 	
 	virtual const EidosClass *Class(void) const override;
 	virtual void Print(std::ostream &p_ostream) const override;
@@ -509,8 +535,8 @@ inline __attribute__((always_inline)) slim_popsize_t Subpopulation::DrawParentUs
 		EIDOS_TERMINATION << "ERROR (Subpopulation::DrawParentUsingFitness): (internal error) called on a population for which sex is enabled." << EidosTerminate();
 #endif
 	
-	if (lookup_parent_)
-		return static_cast<slim_popsize_t>(gsl_ran_discrete(&rng_state->gsl_rng_, lookup_parent_));
+	if (!lookup_parent_.IsEmpty())
+		return static_cast<slim_popsize_t>(lookup_parent_.Draw(rng_state->pcg64_rng_));
 	else
 		return static_cast<slim_popsize_t>(Eidos_rng_interval_uint32(rng_state->pcg32_rng_, parent_subpop_size_));
 }
@@ -533,8 +559,8 @@ inline __attribute__((always_inline)) slim_popsize_t Subpopulation::DrawFemalePa
 		EIDOS_TERMINATION << "ERROR (Subpopulation::DrawFemaleParentUsingFitness): (internal error) called on a population for which sex is not enabled." << EidosTerminate();
 #endif
 	
-	if (lookup_female_parent_)
-		return static_cast<slim_popsize_t>(gsl_ran_discrete(&rng_state->gsl_rng_, lookup_female_parent_));
+	if (!lookup_female_parent_.IsEmpty())
+		return static_cast<slim_popsize_t>(lookup_female_parent_.Draw(rng_state->pcg64_rng_));
 	else
 		return static_cast<slim_popsize_t>(Eidos_rng_interval_uint32(rng_state->pcg32_rng_, parent_first_male_index_));
 }
@@ -558,8 +584,8 @@ inline __attribute__((always_inline)) slim_popsize_t Subpopulation::DrawMalePare
 		EIDOS_TERMINATION << "ERROR (Subpopulation::DrawMaleParentUsingFitness): (internal error) called on a population for which sex is not enabled." << EidosTerminate();
 #endif
 	
-	if (lookup_male_parent_)
-		return static_cast<slim_popsize_t>(gsl_ran_discrete(&rng_state->gsl_rng_, lookup_male_parent_)) + parent_first_male_index_;
+	if (!lookup_male_parent_.IsEmpty())
+		return static_cast<slim_popsize_t>(lookup_male_parent_.Draw(rng_state->pcg64_rng_)) + parent_first_male_index_;
 	else
 		return static_cast<slim_popsize_t>(Eidos_rng_interval_uint32(rng_state->pcg32_rng_, parent_subpop_size_ - parent_first_male_index_) + parent_first_male_index_);
 }
@@ -94,6 +94,7 @@ else:unix: PRE_TARGETDEPS += $$OUT_PWD/../eidos_zlib/libeidos_zlib.a
 SOURCES += \
     eidos_ast_node.cpp \
     eidos_beep.cpp \
+    eidos_bytecode.cpp \
     eidos_call_signature.cpp \
     eidos_class_DataFrame.cpp \
     eidos_class_Dictionary.cpp \
@@ -134,6 +135,7 @@ SOURCES += \
 HEADERS += \
     eidos_ast_node.h \
     eidos_beep.h \
+    eidos_bytecode.h \
     eidos_call_signature.h \
 	eidos_class_DataFrame.h \
     eidos_class_Dictionary.h \
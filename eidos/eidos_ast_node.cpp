@@ -71,12 +71,47 @@ void EidosASTNode::ReplaceTokenWithToken(EidosToken *p_token)
 	token_is_owned_ = true;
 }
 
+// Operator nodes that EidosInterpreter::_EvaluateScalarNode() can evaluate, given eligible children; see _OptimizeScalarExpressions()
+static bool _IsScalarOperatorNode(const EidosASTNode *p_node)
+{
+	size_t child_count = p_node->children_.size();
+	
+	switch (p_node->token_->token_type_)
+	{
+		case EidosTokenType::kTokenPlus:
+		case EidosTokenType::kTokenMinus:
+			return ((child_count == 1) || (child_count == 2));
+		case EidosTokenType::kTokenMult:
+		case EidosTokenType::kTokenDiv:
+		case EidosTokenType::kTokenMod:
+		case EidosTokenType::kTokenExp:
+		case EidosTokenType::kTokenEq:
+		case EidosTokenType::kTokenNotEq:
+		case EidosTokenType::kTokenLt:
+		case EidosTokenType::kTokenLtEq:
+		case EidosTokenType::kTokenGt:
+		case EidosTokenType::kTokenGtEq:
+			return (child_count == 2);
+		case EidosTokenType::kTokenAnd:
+		case EidosTokenType::kTokenOr:
+			return (child_count >= 2);
+		case EidosTokenType::kTokenNot:
+			return (child_count == 1);
+		default:
+			return false;
+	}
+}
+
 void EidosASTNode::OptimizeTree(void) const
 {
 	_OptimizeConstants();		// cache values for numeric and string constants, and for return statements and constant compound statements
 	_OptimizeIdentifiers();		// cache unique IDs for identifiers using EidosStringRegistry::GlobalStringIDForString()
 	_OptimizeEvaluators();		// cache evaluator functions in cached_evaluator_ for fast node evaluation
 	_OptimizeAssignments();		// cache information about assignments that allows simple increment/decrement assignments to be accelerated
+	_OptimizeScalarExpressions();	// mark operator subtrees that EidosInterpreter can evaluate with unboxed singleton values
+	
+	if ((cached_scalar_expression_ == 1) && _IsScalarOperatorNode(this))
+		cached_scalar_expression_ = 2;
 }
 
 void EidosASTNode::_OptimizeConstants(void) const
@@ -308,6 +343,50 @@ void EidosASTNode::_OptimizeAssignments(void) const
 	}
 }
 
+void EidosASTNode::_OptimizeScalarExpressions(void) const
+{
+	// recurse down the tree; determine our children, then ourselves
+	for (auto child : children_)
+		child->_OptimizeScalarExpressions();
+	
+	// A subtree is eligible if it consists only of numeric literals, identifiers, property reads, and the operators accepted by
+	// _IsScalarOperatorNode(); none of these have side effects, so EidosInterpreter can attempt to evaluate such a subtree with
+	// unboxed singleton values and, if it meets a non-singleton or an error case, simply re-evaluate the subtree the boxed way.
+	EidosTokenType token_type = token_->token_type_;
+	bool is_operator = _IsScalarOperatorNode(this);
+	
+	cached_scalar_expression_ = 0;
+	
+	if (token_type == EidosTokenType::kTokenNumber)
+	{
+		if (cached_literal_value_)
+			cached_scalar_expression_ = 1;
+	}
+	else if (token_type == EidosTokenType::kTokenIdentifier)
+	{
+		cached_scalar_expression_ = 1;
+	}
+	else if (token_type == EidosTokenType::kTokenDot)
+	{
+		if ((children_.size() == 2) && children_[0]->cached_scalar_expression_ && (children_[1]->token_->token_type_ == EidosTokenType::kTokenIdentifier))
+			cached_scalar_expression_ = 1;
+	}
+	else if (is_operator)
+	{
+		if (std::all_of(children_.begin(), children_.end(), [](const EidosASTNode *child) { return child->cached_scalar_expression_ != 0; }))
+			cached_scalar_expression_ = 1;
+	}
+	
+	// Eligible operator subtrees below us are roots, where boxed evaluation hands off to unboxed evaluation, unless we will
+	// evaluate them unboxed ourselves; OptimizeTree() marks the topmost node, which has no parent to do so
+	if (!is_operator || !cached_scalar_expression_)
+	{
+		for (auto child : children_)
+			if ((child->cached_scalar_expression_ == 1) && _IsScalarOperatorNode(child))
+				child->cached_scalar_expression_ = 2;
+	}
+}
+
 bool EidosASTNode::HasCachedNumericValue(void) const
 {
 	if ((token_->token_type_ == EidosTokenType::kTokenNumber) && cached_literal_value_ && (cached_literal_value_->Count() == 1))
@@ -84,6 +84,8 @@ public:
 	uint8_t token_is_owned_ = false;									// if T, we own token_ because it is a virtual token that replaced a real token
 	mutable uint8_t cached_compound_assignment_ = false;				// pre-cached on assignment nodes if they are of the form "x=x+1" or "x=x-1" only
 	mutable uint8_t cached_append_assignment_ = false;					// pre-cached on assignment nodes if they are of the form "x=c(x, y)" only
+	mutable uint8_t cached_scalar_expression_ = 0;						// 1 if this subtree can be evaluated unboxed as singleton arithmetic, 2 if it is also the root of such a subtree
+	mutable uint8_t scalar_failure_count_ = 0;							// the number of times unboxed evaluation of this root has fallen back to boxed evaluation
 	
 	mutable EidosTypeSpecifier typespec_;								// only valid for type-specifier nodes inside function declarations
 	mutable bool hit_eof_in_tolerant_parse_ = false;					// only valid for compound statement nodes; used by the type-interpreter to handle scoping
@@ -118,6 +120,7 @@ public:
 	void _OptimizeIdentifiers(void) const;								// cache function signatures, global strings for methods and properties, etc.
 	void _OptimizeEvaluators(void) const;								// cache pointers to method for evaluation
 	void _OptimizeAssignments(void) const;								// detect and mark simple increment/decrement assignments on a variable
+	void _OptimizeScalarExpressions(void) const;						// detect and mark subtrees of singleton arithmetic that can be evaluated without boxing
 	
 	bool HasCachedNumericValue(void) const;
 	double CachedNumericValue(void) const;
@@ -0,0 +1,845 @@
+//
+//  eidos_bytecode.cpp
+//  Eidos
+//
+//  Created by Ben Haller on 10/18/26.
+//  Copyright (c) 2026 Benjamin C. Haller.  All rights reserved.
+//	A product of the Messer Lab, http://messerlab.org/slim/
+//
+
+//	This file is part of Eidos.
+//
+//	Eidos is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+//
+//	Eidos is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License along with Eidos.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "eidos_bytecode.h"
+#include "eidos_globals.h"
+#include "eidos_class_Object.h"
+#include "eidos_property_signature.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+
+// ************************************************************************************
+//
+//	EidosBytecodeValue
+//
+#pragma mark -
+#pragma mark EidosBytecodeValue
+#pragma mark -
+
+EidosValue_SP EidosBytecodeValue::BoxedValue(void) const
+{
+	switch (type_)
+	{
+		case EidosBytecodeValueType::kVOID:		return gStaticEidosValueVOID;
+		case EidosBytecodeValueType::kNULL:		return gStaticEidosValueNULL;
+		case EidosBytecodeValueType::kLogical:	return (logical_ ? gStaticEidosValue_LogicalT : gStaticEidosValue_LogicalF);
+		case EidosBytecodeValueType::kInt:		return EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Int(int_));
+		case EidosBytecodeValueType::kFloat:	return EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Float(float_));
+		case EidosBytecodeValueType::kObject:	return EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Object(object_, object_->Class()));
+		default:
+			EIDOS_TERMINATION << "ERROR (EidosBytecodeValue::BoxedValue): (internal error) unset value cannot be boxed." << EidosTerminate(nullptr);
+	}
+}
+
+
+// ************************************************************************************
+//
+//	EidosBytecodeCompiler
+//
+#pragma mark -
+#pragma mark EidosBytecodeCompiler
+#pragma mark -
+
+// The compiler walks the optimized AST once, emitting instructions as it goes.  Locals are assigned register slots up
+// front by a scan for assignments; temporaries are allocated above them in stack order as expressions are compiled.
+// Every _Compile method returns false if it meets something it does not handle, which abandons the whole compilation.
+class EidosBytecodeCompiler
+{
+	EidosBytecodeProgram &program_;
+	const std::vector<EidosGlobalStringID> &parameters_;
+	std::vector<EidosGlobalStringID> locals_;
+	int next_temp_ = 0;
+
+public:
+
+	EidosBytecodeCompiler(EidosBytecodeProgram &p_program, const std::vector<EidosGlobalStringID> &p_parameters) : program_(p_program), parameters_(p_parameters) { }
+
+	bool CompileBlock(const EidosASTNode *p_block_node);
+
+private:
+
+	bool _CollectLocals(const EidosASTNode *p_node);
+	int _ParameterIndex(EidosGlobalStringID p_symbol) const;
+	int _LocalIndex(EidosGlobalStringID p_symbol) const;
+
+	bool _AllocateTemp(int *p_register);
+	inline void _FreeTempsFrom(int p_register) { next_temp_ = p_register; }
+
+	inline size_t _Emit(EidosBytecodeOp p_op, int p_dst, int p_src1, int p_src2, uint32_t p_operand, const EidosToken *p_token)
+	{
+		program_.instructions_.emplace_back(EidosBytecodeInstruction{p_op, (uint8_t)p_dst, (uint8_t)p_src1, (uint8_t)p_src2, p_operand, p_token});
+		return program_.instructions_.size() - 1;
+	}
+	inline void _PatchJumpToHere(size_t p_instruction_index) { program_.instructions_[p_instruction_index].operand_ = (uint32_t)program_.instructions_.size(); }
+
+	bool _CompileStatement(const EidosASTNode *p_node);
+	bool _CompileExpression(const EidosASTNode *p_node, int p_dst);
+	bool _CompileConstant(const EidosValue *p_value, int p_dst);
+	bool _CompileCall(const EidosASTNode *p_node, int p_dst);
+};
+
+int EidosBytecodeCompiler::_ParameterIndex(EidosGlobalStringID p_symbol) const
+{
+	auto iter = std::find(parameters_.begin(), parameters_.end(), p_symbol);
+
+	return (iter == parameters_.end()) ? -1 : (int)(iter - parameters_.begin());
+}
+
+int EidosBytecodeCompiler::_LocalIndex(EidosGlobalStringID p_symbol) const
+{
+	auto iter = std::find(locals_.begin(), locals_.end(), p_symbol);
+
+	return (iter == locals_.end()) ? -1 : (int)(iter - locals_.begin());
+}
+
+bool EidosBytecodeCompiler::_AllocateTemp(int *p_register)
+{
+	if (next_temp_ >= EIDOS_BYTECODE_MAX_REGISTERS)
+		return false;
+
+	*p_register = next_temp_++;
+	program_.register_count_ = std::max(program_.register_count_, next_temp_);
+	return true;
+}
+
+bool EidosBytecodeCompiler::_CollectLocals(const EidosASTNode *p_node)
+{
+	if (p_node->token_->token_type_ == EidosTokenType::kTokenAssign)
+	{
+		// only assignment to a plain identifier is handled; assigning into a subscript or a property is not
+		if (p_node->children_.size() != 2)
+			return false;
+
+		const EidosASTNode *lvalue_node = p_node->children_[0];
+
+		if (lvalue_node->token_->token_type_ != EidosTokenType::kTokenIdentifier)
+			return false;
+
+		// parameters are defined as constants, so assigning to one is an error; leave that to the interpreter
+		EidosGlobalStringID symbol = lvalue_node->cached_stringID_;
+
+		if ((symbol == gEidosID_none) || (_ParameterIndex(symbol) != -1))
+			return false;
+
+		if (_LocalIndex(symbol) == -1)
+			locals_.emplace_back(symbol);
+	}
+
+	for (const EidosASTNode *child : p_node->children_)
+		if (!_CollectLocals(child))
+			return false;
+
+	return true;
+}
+
+bool EidosBytecodeCompiler::CompileBlock(const EidosASTNode *p_block_node)
+{
+	if (p_block_node->token_->token_type_ != EidosTokenType::kTokenLBrace)
+		return false;
+
+	if (!_CollectLocals(p_block_node))
+		return false;
+
+	if ((int)locals_.size() >= EIDOS_BYTECODE_MAX_REGISTERS)
+		return false;
+
+	program_.local_count_ = (int)locals_.size();
+	program_.register_count_ = program_.local_count_;
+	next_temp_ = program_.local_count_;
+
+	if (!_CompileStatement(p_block_node))
+		return false;
+
+	// falling off the end of a block produces VOID, like a return statement without a value
+	_Emit(EidosBytecodeOp::kReturnVoid, 0, 0, 0, 0, nullptr);
+	return true;
+}
+
+bool EidosBytecodeCompiler::_CompileStatement(const EidosASTNode *p_node)
+{
+	const std::vector<EidosASTNode *> &children = p_node->children_;
+
+	switch (p_node->token_->token_type_)
+	{
+		case EidosTokenType::kTokenLBrace:
+		{
+			for (const EidosASTNode *child : children)
+				if (!_CompileStatement(child))
+					return false;
+			return true;
+		}
+		case EidosTokenType::kTokenSemicolon:
+		{
+			return true;
+		}
+		case EidosTokenType::kTokenReturn:
+		{
+			if (children.size() == 0)
+			{
+				_Emit(EidosBytecodeOp::kReturnVoid, 0, 0, 0, 0, nullptr);
+				return true;
+			}
+
+			int value_register;
+
+			if ((children.size() != 1) || !_AllocateTemp(&value_register) || !_CompileExpression(children[0], value_register))
+				return false;
+
+			_Emit(EidosBytecodeOp::kReturn, 0, value_register, 0, 0, nullptr);
+			_FreeTempsFrom(value_register);
+			return true;
+		}
+		case EidosTokenType::kTokenIf:
+		{
+			int condition_register;
+
+			if (((children.size() != 2) && (children.size() != 3)) || !_AllocateTemp(&condition_register) || !_CompileExpression(children[0], condition_register))
+				return false;
+
+			size_t jump_to_else = _Emit(EidosBytecodeOp::kJumpIfFalse, 0, condition_register, 0, 0, children[0]->token_);
+			_FreeTempsFrom(condition_register);
+
+			if (!_CompileStatement(children[1]))
+				return false;
+
+			if (children.size() == 3)
+			{
+				size_t jump_to_end = _Emit(EidosBytecodeOp::kJump, 0, 0, 0, 0, nullptr);
+
+				_PatchJumpToHere(jump_to_else);
+
+				if (!_CompileStatement(children[2]))
+					return false;
+
+				_PatchJumpToHere(jump_to_end);
+			}
+			else
+			{
+				_PatchJumpToHere(jump_to_else);
+			}
+			return true;
+		}
+		case EidosTokenType::kTokenAssign:
+		{
+			// _CollectLocals() has already checked that this is an assignment to a plain identifier with a local slot
+			int local_register = _LocalIndex(children[0]->cached_stringID_);
+			int value_register;
+
+			if ((local_register == -1) || !_AllocateTemp(&value_register) || !_CompileExpression(children[1], value_register))
+				return false;
+
+			_Emit(EidosBytecodeOp::kStoreLocal, local_register, value_register, 0, children[0]->cached_stringID_, nullptr);
+			_FreeTempsFrom(value_register);
+			return true;
+		}
+		default:
+		{
+			// An expression statement; its value is discarded, but it must still be evaluated for the errors it might raise
+			int value_register;
+
+			if (!_AllocateTemp(&value_register) || !_CompileExpression(p_node, value_register))
+				return false;
+
+			_FreeTempsFrom(value_register);
+			return true;
+		}
+	}
+}
+
+bool EidosBytecodeCompiler::_CompileConstant(const EidosValue *p_value, int p_dst)
+{
+	EidosBytecodeValue constant;
+
+	if (!EidosBytecodeValue::UnboxValue(p_value, &constant) || (constant.type_ == EidosBytecodeValueType::kObject))
+		return false;
+
+	program_.constants_.emplace_back(constant);
+	_Emit(EidosBytecodeOp::kLoadConstant, p_dst, 0, 0, (uint32_t)(program_.constants_.size() - 1), nullptr);
+	return true;
+}
+
+bool EidosBytecodeCompiler::_CompileCall(const EidosASTNode *p_node, int p_dst)
+{
+	// Only a few simple built-in functions, called with one positional argument, are handled
+	const std::vector<EidosASTNode *> &children = p_node->children_;
+
+	if (children.size() != 2)
+		return false;
+
+	const EidosASTNode *call_name_node = children[0];
+	const EidosASTNode *argument_node = children[1];
+
+	if ((call_name_node->token_->token_type_ != EidosTokenType::kTokenIdentifier) || (argument_node->token_->token_type_ == EidosTokenType::kTokenAssign))
+		return false;
+
+	const std::string &call_name = call_name_node->token_->token_string_;
+	EidosBytecodeOp op = EidosBytecodeOp::kCallMath;
+	EidosBytecodeMathFunction function = EidosBytecodeMathFunction::kAbs;
+
+	if (call_name == "abs")			function = EidosBytecodeMathFunction::kAbs;
+	else if (call_name == "exp")	function = EidosBytecodeMathFunction::kExp;
+	else if (call_name == "log")	function = EidosBytecodeMathFunction::kLog;
+	else if (call_name == "log10")	function = EidosBytecodeMathFunction::kLog10;
+	else if (call_name == "log2")	function = EidosBytecodeMathFunction::kLog2;
+	else if (call_name == "sqrt")	function = EidosBytecodeMathFunction::kSqrt;
+	else if (call_name == "isNULL")	op = EidosBytecodeOp::kIsNULL;
+	else return false;
+
+	int argument_register;
+
+	if (!_AllocateTemp(&argument_register) || !_CompileExpression(argument_node, argument_register))
+		return false;
+
+	_Emit(op, p_dst, argument_register, 0, (uint32_t)function, nullptr);
+	_FreeTempsFrom(argument_register);
+	return true;
+}
+
+bool EidosBytecodeCompiler::_CompileExpression(const EidosASTNode *p_node, int p_dst)
+{
+	// numeric literals and built-in constants like T and PI are pre-cached by EidosASTNode::_OptimizeConstants()
+	if (p_node->cached_literal_value_)
+		return _CompileConstant(p_node->cached_literal_value_.get(), p_dst);
+
+	const std::vector<EidosASTNode *> &children = p_node->children_;
+	EidosTokenType token_type = p_node->token_->token_type_;
+	EidosBytecodeOp op;
+
+	switch (token_type)
+	{
+		case EidosTokenType::kTokenIdentifier:
+		{
+			EidosGlobalStringID symbol = p_node->cached_stringID_;
+
+			if (symbol == gEidosID_none)
+				return false;
+
+			int index = _ParameterIndex(symbol);
+
+			if (index != -1)
+			{
+				_Emit(EidosBytecodeOp::kLoadArgument, p_dst, 0, 0, (uint32_t)index, nullptr);
+				return true;
+			}
+
+			index = _LocalIndex(symbol);
+
+			if (index != -1)
+				_Emit(EidosBytecodeOp::kLoadLocal, p_dst, index, 0, symbol, nullptr);
+			else
+				_Emit(EidosBytecodeOp::kLoadGlobal, p_dst, 0, 0, symbol, nullptr);
+			return true;
+		}
+		case EidosTokenType::kTokenDot:
+		{
+			if ((children.size() != 2) || (children[1]->token_->token_type_ != EidosTokenType::kTokenIdentifier) || (children[1]->cached_stringID_ == gEidosID_none))
+				return false;
+
+			int object_register;
+
+			if (!_AllocateTemp(&object_register) || !_CompileExpression(children[0], object_register))
+				return false;
+
+			_Emit(EidosBytecodeOp::kGetProperty, p_dst, object_register, 0, children[1]->cached_stringID_, children[1]->token_);
+			_FreeTempsFrom(object_register);
+			return true;
+		}
+		case EidosTokenType::kTokenLParen:
+			return _CompileCall(p_node, p_dst);
+		case EidosTokenType::kTokenConditional:
+		{
+			int condition_register;
+
+			if ((children.size() != 3) || !_AllocateTemp(&condition_register) || !_CompileExpression(children[0], condition_register))
+				return false;
+
+			size_t jump_to_false = _Emit(EidosBytecodeOp::kJumpIfFalse, 0, condition_register, 0, 0, children[0]->token_);
+			_FreeTempsFrom(condition_register);
+
+			if (!_CompileExpression(children[1], p_dst))
+				return false;
+
+			size_t jump_to_end = _Emit(EidosBytecodeOp::kJump, 0, 0, 0, 0, nullptr);
+
+			_PatchJumpToHere(jump_to_false);
+
+			if (!_CompileExpression(children[2], p_dst))
+				return false;
+
+			_PatchJumpToHere(jump_to_end);
+			return true;
+		}
+		case EidosTokenType::kTokenAnd:
+		case EidosTokenType::kTokenOr:
+		{
+			// & and | take two or more operands; they do not short-circuit, so every operand is evaluated
+			op = ((token_type == EidosTokenType::kTokenAnd) ? EidosBytecodeOp::kAnd : EidosBytecodeOp::kOr);
+
+			int operand_register;
+
+			if ((children.size() < 2) || !_CompileExpression(children[0], p_dst))
+				return false;
+
+			for (size_t child_index = 1; child_index < children.size(); ++child_index)
+			{
+				if (!_AllocateTemp(&operand_register) || !_CompileExpression(children[child_index], operand_register))
+					return false;
+
+				_Emit(op, p_dst, p_dst, operand_register, 0, nullptr);
+				_FreeTempsFrom(operand_register);
+			}
+			return true;
+		}
+		case EidosTokenType::kTokenPlus:
+		case EidosTokenType::kTokenMinus:
+		case EidosTokenType::kTokenNot:
+		{
+			if (children.size() == 1)
+			{
+				if (token_type == EidosTokenType::kTokenPlus)			op = EidosBytecodeOp::kUnaryPlus;
+				else if (token_type == EidosTokenType::kTokenMinus)		op = EidosBytecodeOp::kNegate;
+				else													op = EidosBytecodeOp::kNot;
+
+				int operand_register;
+
+				if (!_AllocateTemp(&operand_register) || !_CompileExpression(children[0], operand_register))
+					return false;
+
+				_Emit(op, p_dst, operand_register, 0, 0, nullptr);
+				_FreeTempsFrom(operand_register);
+				return true;
+			}
+
+			if (token_type == EidosTokenType::kTokenNot)
+				return false;
+
+			op = ((token_type == EidosTokenType::kTokenPlus) ? EidosBytecodeOp::kAdd : EidosBytecodeOp::kSubtract);
+			break;
+		}
+		case EidosTokenType::kTokenMult:	op = EidosBytecodeOp::kMultiply; break;
+		case EidosTokenType::kTokenDiv:		op = EidosBytecodeOp::kDivide; break;
+		case EidosTokenType::kTokenMod:		op = EidosBytecodeOp::kModulo; break;
+		case EidosTokenType::kTokenExp:		op = EidosBytecodeOp::kPower; break;
+		case EidosTokenType::kTokenLt:		op = EidosBytecodeOp::kLess; break;
+		case EidosTokenType::kTokenLtEq:	op = EidosBytecodeOp::kLessOrEqual; break;
+		case EidosTokenType::kTokenGt:		op = EidosBytecodeOp::kGreater; break;
+		case EidosTokenType::kTokenGtEq:	op = EidosBytecodeOp::kGreaterOrEqual; break;
+		case EidosTokenType::kTokenEq:		op = EidosBytecodeOp::kEqual; break;
+		case EidosTokenType::kTokenNotEq:	op = EidosBytecodeOp::kNotEqual; break;
+		default:
+			return false;
+	}
+
+	// binary operators
+	int first_register, second_register;
+
+	if ((children.size() != 2) || !_AllocateTemp(&first_register) || !_CompileExpression(children[0], first_register) || !_AllocateTemp(&second_register) || !_CompileExpression(children[1], second_register))
+		return false;
+
+	_Emit(op, p_dst, first_register, second_register, 0, nullptr);
+	_FreeTempsFrom(first_register);
+	return true;
+}
+
+
+// ************************************************************************************
+//
+//	EidosBytecodeProgram
+//
+#pragma mark -
+#pragma mark EidosBytecodeProgram
+#pragma mark -
+
+EidosBytecodeProgram *EidosBytecodeProgram::Compile(const EidosASTNode *p_block_node, const std::vector<EidosGlobalStringID> &p_parameters)
+{
+	EidosBytecodeProgram *program = new EidosBytecodeProgram();
+	EidosBytecodeCompiler compiler(*program, p_parameters);
+
+	if (!compiler.CompileBlock(p_block_node))
+	{
+		delete program;
+		return nullptr;
+	}
+
+	return program;
+}
+
+// Convert a register to a logical as LogicalAtIndex_CAST() would; returns false for the cases where that would raise
+static inline __attribute__((always_inline)) bool _EidosBytecodeLogicalCast(const EidosBytecodeValue &p_value, eidos_logical_t *p_result)
+{
+	switch (p_value.type_)
+	{
+		case EidosBytecodeValueType::kLogical:	*p_result = p_value.logical_; return true;
+		case EidosBytecodeValueType::kInt:		*p_result = (p_value.int_ != 0); return true;
+		case EidosBytecodeValueType::kFloat:
+			if (std::isnan(p_value.float_))
+				return false;
+			*p_result = (p_value.float_ != 0.0);
+			return true;
+		default:								return false;
+	}
+}
+
+static inline __attribute__((always_inline)) bool _EidosBytecodeIsNumeric(const EidosBytecodeValue &p_value)
+{
+	return ((p_value.type_ == EidosBytecodeValueType::kInt) || (p_value.type_ == EidosBytecodeValueType::kFloat));
+}
+
+static inline __attribute__((always_inline)) double _EidosBytecodeNumeric(const EidosBytecodeValue &p_value)
+{
+	return ((p_value.type_ == EidosBytecodeValueType::kInt) ? (double)p_value.int_ : p_value.float_);
+}
+
+// Compare two registers with the type promotion rules of the comparison operators; returns false where those would raise
+// or would not produce a singleton logical, which includes ordering comparisons of objects
+static bool _EidosBytecodeCompare(EidosBytecodeOp p_op, const EidosBytecodeValue &p_first, const EidosBytecodeValue &p_second, eidos_logical_t *p_result)
+{
+	EidosBytecodeValueType first_type = p_first.type_, second_type = p_second.type_;
+
+	if ((first_type == EidosBytecodeValueType::kObject) || (second_type == EidosBytecodeValueType::kObject))
+	{
+		if ((first_type != second_type) || ((p_op != EidosBytecodeOp::kEqual) && (p_op != EidosBytecodeOp::kNotEqual)))
+			return false;
+
+		*p_result = ((p_first.object_ == p_second.object_) == (p_op == EidosBytecodeOp::kEqual));
+		return true;
+	}
+
+	if ((first_type < EidosBytecodeValueType::kLogical) || (second_type < EidosBytecodeValueType::kLogical))
+		return false;
+
+	int comparison;
+
+	if ((first_type == EidosBytecodeValueType::kFloat) || (second_type == EidosBytecodeValueType::kFloat))
+	{
+		double first = ((first_type == EidosBytecodeValueType::kLogical) ? (double)p_first.logical_ : _EidosBytecodeNumeric(p_first));
+		double second = ((second_type == EidosBytecodeValueType::kLogical) ? (double)p_second.logical_ : _EidosBytecodeNumeric(p_second));
+
+		switch (p_op)
+		{
+			case EidosBytecodeOp::kLess:			*p_result = (first < second); return true;
+			case EidosBytecodeOp::kLessOrEqual:		*p_result = (first <= second); return true;
+			case EidosBytecodeOp::kGreater:			*p_result = (first > second); return true;
+			case EidosBytecodeOp::kGreaterOrEqual:	*p_result = (first >= second); return true;
+			case EidosBytecodeOp::kEqual:			*p_result = (first == second); return true;
+			case EidosBytecodeOp::kNotEqual:		*p_result = (first != second); return true;
+			default:								return false;
+		}
+	}
+	else
+	{
+		int64_t first = ((first_type == EidosBytecodeValueType::kLogical) ? (int64_t)p_first.logical_ : p_first.int_);
+		int64_t second = ((second_type == EidosBytecodeValueType::kLogical) ? (int64_t)p_second.logical_ : p_second.int_);
+
+		comparison = (first < second) ? -1 : ((first > second) ? 1 : 0);
+	}
+
+	switch (p_op)
+	{
+		case EidosBytecodeOp::kLess:			*p_result = (comparison < 0); return true;
+		case EidosBytecodeOp::kLessOrEqual:		*p_result = (comparison <= 0); return true;
+		case EidosBytecodeOp::kGreater:			*p_result = (comparison > 0); return true;
+		case EidosBytecodeOp::kGreaterOrEqual:	*p_result = (comparison >= 0); return true;
+		case EidosBytecodeOp::kEqual:			*p_result = (comparison == 0); return true;
+		case EidosBytecodeOp::kNotEqual:		*p_result = (comparison != 0); return true;
+		default:								return false;
+	}
+}
+
+bool EidosBytecodeValue::ApplyOperator(EidosBytecodeOp p_op, const EidosBytecodeValue &p_first, const EidosBytecodeValue &p_second, EidosBytecodeValue *p_result)
+{
+	// note that p_result may alias p_first or p_second, so operands must be read before the result is written
+	switch (p_op)
+	{
+		case EidosBytecodeOp::kAdd:
+		case EidosBytecodeOp::kSubtract:
+		case EidosBytecodeOp::kMultiply:
+		{
+			if (!_EidosBytecodeIsNumeric(p_first) || !_EidosBytecodeIsNumeric(p_second))
+				return false;
+
+			if ((p_first.type_ == EidosBytecodeValueType::kInt) && (p_second.type_ == EidosBytecodeValueType::kInt))
+			{
+				int64_t result;
+				bool overflow;
+
+				if (p_op == EidosBytecodeOp::kAdd)				overflow = Eidos_add_overflow(p_first.int_, p_second.int_, &result);
+				else if (p_op == EidosBytecodeOp::kSubtract)	overflow = Eidos_sub_overflow(p_first.int_, p_second.int_, &result);
+				else											overflow = Eidos_mul_overflow(p_first.int_, p_second.int_, &result);
+
+				if (overflow)
+					return false;
+
+				*p_result = Int(result);
+			}
+			else
+			{
+				double first = _EidosBytecodeNumeric(p_first), second = _EidosBytecodeNumeric(p_second);
+
+				if (p_op == EidosBytecodeOp::kAdd)				*p_result = Float(first + second);
+				else if (p_op == EidosBytecodeOp::kSubtract)	*p_result = Float(first - second);
+				else											*p_result = Float(first * second);
+			}
+			return true;
+		}
+		case EidosBytecodeOp::kDivide:
+		case EidosBytecodeOp::kModulo:
+		case EidosBytecodeOp::kPower:
+		{
+			// these always produce float, even for integer operands
+			if (!_EidosBytecodeIsNumeric(p_first) || !_EidosBytecodeIsNumeric(p_second))
+				return false;
+
+			double first = _EidosBytecodeNumeric(p_first), second = _EidosBytecodeNumeric(p_second);
+
+			if (p_op == EidosBytecodeOp::kDivide)			*p_result = Float(first / second);
+			else if (p_op == EidosBytecodeOp::kModulo)		*p_result = Float(fmod(first, second));
+			else											*p_result = Float(pow(first, second));
+			return true;
+		}
+		case EidosBytecodeOp::kNegate:
+		{
+			if (p_first.type_ == EidosBytecodeValueType::kFloat)
+				*p_result = Float(-p_first.float_);
+			else if ((p_first.type_ == EidosBytecodeValueType::kInt) && (p_first.int_ != INT64_MIN))
+				*p_result = Int(-p_first.int_);
+			else
+				return false;
+			return true;
+		}
+		case EidosBytecodeOp::kUnaryPlus:
+		{
+			if (!_EidosBytecodeIsNumeric(p_first))
+				return false;
+			*p_result = p_first;
+			return true;
+		}
+		case EidosBytecodeOp::kLess:
+		case EidosBytecodeOp::kLessOrEqual:
+		case EidosBytecodeOp::kGreater:
+		case EidosBytecodeOp::kGreaterOrEqual:
+		case EidosBytecodeOp::kEqual:
+		case EidosBytecodeOp::kNotEqual:
+		{
+			eidos_logical_t result;
+
+			if (!_EidosBytecodeCompare(p_op, p_first, p_second, &result))
+				return false;
+			*p_result = Logical(result);
+			return true;
+		}
+		case EidosBytecodeOp::kAnd:
+		case EidosBytecodeOp::kOr:
+		{
+			eidos_logical_t first, second;
+
+			if (!_EidosBytecodeLogicalCast(p_first, &first) || !_EidosBytecodeLogicalCast(p_second, &second))
+				return false;
+			*p_result = Logical((p_op == EidosBytecodeOp::kAnd) ? (first && second) : (first || second));
+			return true;
+		}
+		case EidosBytecodeOp::kNot:
+		{
+			eidos_logical_t operand;
+
+			if (!_EidosBytecodeLogicalCast(p_first, &operand))
+				return false;
+			*p_result = Logical(!operand);
+			return true;
+		}
+		default:
+			return false;
+	}
+}
+
+// Look up a global symbol without raising; undefined symbols and unrepresentable values make the VM deoptimize
+static inline bool _EidosBytecodeLoadGlobal(const EidosSymbolTable &p_symbols, EidosGlobalStringID p_symbol, EidosBytecodeValue *p_result)
+{
+	if (!p_symbols.ContainsSymbol(p_symbol))
+		return false;
+
+	return EidosBytecodeValue::UnboxValue(p_symbols.GetValueRawOrRaiseForSymbol(p_symbol), p_result);
+}
+
+bool EidosBytecodeProgram::Execute(const EidosBytecodeValue *p_arguments, const EidosSymbolTable &p_symbols, EidosScript *p_script_for_block, EidosBytecodeValue *p_result) const
+{
+	EidosBytecodeValue registers[EIDOS_BYTECODE_MAX_REGISTERS];
+
+	for (int local_index = 0; local_index < local_count_; ++local_index)
+		registers[local_index].type_ = EidosBytecodeValueType::kUnset;
+
+	// Property getters can raise; if this block has its own script, errors need to be reported in its context
+	EidosErrorContext error_context_save = gEidosErrorContext;
+
+	if ((p_script_for_block != nullptr) && (p_script_for_block != gEidosErrorContext.currentScript))
+		gEidosErrorContext = EidosErrorContext{{-1, -1, -1, -1}, p_script_for_block};
+
+	const EidosBytecodeInstruction *instructions = instructions_.data();
+	const EidosBytecodeValue *constants = constants_.data();
+	size_t pc = 0;
+	bool completed = false;
+
+	while (true)
+	{
+		const EidosBytecodeInstruction &instruction = instructions[pc++];
+		EidosBytecodeValue &dst = registers[instruction.dst_];
+		const EidosBytecodeValue &src1 = registers[instruction.src1_];
+		const EidosBytecodeValue &src2 = registers[instruction.src2_];
+
+		switch (instruction.op_)
+		{
+			case EidosBytecodeOp::kLoadConstant:
+				dst = constants[instruction.operand_];
+				continue;
+			case EidosBytecodeOp::kLoadArgument:
+				dst = p_arguments[instruction.operand_];
+				if (dst.type_ == EidosBytecodeValueType::kUnset)
+					goto deoptimize;
+				continue;
+			case EidosBytecodeOp::kLoadLocal:
+				if (src1.type_ != EidosBytecodeValueType::kUnset)
+					dst = src1;
+				else if (!_EidosBytecodeLoadGlobal(p_symbols, instruction.operand_, &dst))
+					goto deoptimize;
+				continue;
+			case EidosBytecodeOp::kLoadGlobal:
+				if (!_EidosBytecodeLoadGlobal(p_symbols, instruction.operand_, &dst))
+					goto deoptimize;
+				continue;
+			case EidosBytecodeOp::kStoreLocal:
+				// the first assignment to a name would raise in the interpreter if the name is a constant, so check that
+				if ((dst.type_ == EidosBytecodeValueType::kUnset) && (instruction.operand_ != gEidosID_none))
+				{
+					bool is_const;
+
+					if (p_symbols.ContainsSymbol_IsConstant(instruction.operand_, &is_const) && is_const)
+						goto deoptimize;
+				}
+				dst = src1;
+				continue;
+			case EidosBytecodeOp::kGetProperty:
+			{
+				if (src1.type_ != EidosBytecodeValueType::kObject)
+					goto deoptimize;
+
+				EidosObject *object = src1.object_;
+				const EidosPropertySignature *signature = object->Class()->SignatureForProperty(instruction.operand_);
+
+				if (!signature)
+					goto deoptimize;
+
+				EidosErrorPosition error_pos_save = PushErrorPositionFromToken(instruction.token_);
+				EidosValue_SP property_value = object->GetProperty(instruction.operand_);
+				RestoreErrorPosition(error_pos_save);
+
+				// the returned value holds the only reference to a retain/release object it creates, so we cannot keep a bare pointer
+				if (!EidosBytecodeValue::UnboxValue(property_value.get(), &dst))
+					goto deoptimize;
+				if ((dst.type_ == EidosBytecodeValueType::kObject) && dst.object_->Class()->UsesRetainRelease())
+					goto deoptimize;
+				continue;
+			}
+			case EidosBytecodeOp::kAdd:
+			case EidosBytecodeOp::kSubtract:
+			case EidosBytecodeOp::kMultiply:
+			case EidosBytecodeOp::kDivide:
+			case EidosBytecodeOp::kModulo:
+			case EidosBytecodeOp::kPower:
+			case EidosBytecodeOp::kNegate:
+			case EidosBytecodeOp::kUnaryPlus:
+			case EidosBytecodeOp::kLess:
+			case EidosBytecodeOp::kLessOrEqual:
+			case EidosBytecodeOp::kGreater:
+			case EidosBytecodeOp::kGreaterOrEqual:
+			case EidosBytecodeOp::kEqual:
+			case EidosBytecodeOp::kNotEqual:
+			case EidosBytecodeOp::kAnd:
+			case EidosBytecodeOp::kOr:
+			case EidosBytecodeOp::kNot:
+				if (!EidosBytecodeValue::ApplyOperator(instruction.op_, src1, src2, &dst))
+					goto deoptimize;
+				continue;
+			case EidosBytecodeOp::kCallMath:
+			{
+				if (!_EidosBytecodeIsNumeric(src1))
+					goto deoptimize;
+
+				EidosBytecodeMathFunction function = (EidosBytecodeMathFunction)instruction.operand_;
+
+				if (function == EidosBytecodeMathFunction::kAbs)
+				{
+					// abs() preserves integer type, and raises on the most negative integer
+					if (src1.type_ == EidosBytecodeValueType::kFloat)
+						dst = EidosBytecodeValue::Float(fabs(src1.float_));
+					else if (src1.int_ != INT64_MIN)
+						dst = EidosBytecodeValue::Int(std::llabs(src1.int_));
+					else
+						goto deoptimize;
+					continue;
+				}
+
+				double operand = _EidosBytecodeNumeric(src1);
+
+				switch (function)
+				{
+					case EidosBytecodeMathFunction::kExp:	dst = EidosBytecodeValue::Float(std::exp(operand)); break;
+					case EidosBytecodeMathFunction::kLog:	dst = EidosBytecodeValue::Float(std::log(operand)); break;
+					case EidosBytecodeMathFunction::kLog10:	dst = EidosBytecodeValue::Float(std::log10(operand)); break;
+					case EidosBytecodeMathFunction::kLog2:	dst = EidosBytecodeValue::Float(std::log2(operand)); break;
+					case EidosBytecodeMathFunction::kSqrt:	dst = EidosBytecodeValue::Float(std::sqrt(operand)); break;
+					default:								goto deoptimize;
+				}
+				continue;
+			}
+			case EidosBytecodeOp::kIsNULL:
+				dst = EidosBytecodeValue::Logical(src1.type_ == EidosBytecodeValueType::kNULL);
+				continue;
+			case EidosBytecodeOp::kJump:
+				pc = instruction.operand_;
+				continue;
+			case EidosBytecodeOp::kJumpIfFalse:
+			{
+				eidos_logical_t condition;
+
+				if (!_EidosBytecodeLogicalCast(src1, &condition))
+					goto deoptimize;
+				if (!condition)
+					pc = instruction.operand_;
+				continue;
+			}
+			case EidosBytecodeOp::kReturn:
+				*p_result = src1;
+				completed = true;
+				goto finish;
+			case EidosBytecodeOp::kReturnVoid:
+				p_result->type_ = EidosBytecodeValueType::kVOID;
+				completed = true;
+				goto finish;
+		}
+	}
+
+deoptimize:
+finish:
+	gEidosErrorContext = error_context_save;
+	return completed;
+}
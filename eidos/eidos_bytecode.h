@@ -0,0 +1,229 @@
+//
+//  eidos_bytecode.h
+//  Eidos
+//
+//  Created by Ben Haller on 10/18/26.
+//  Copyright (c) 2026 Benjamin C. Haller.  All rights reserved.
+//	A product of the Messer Lab, http://messerlab.org/slim/
+//
+
+//	This file is part of Eidos.
+//
+//	Eidos is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+//
+//	Eidos is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License along with Eidos.  If not, see <http://www.gnu.org/licenses/>.
+
+/*
+
+ The class EidosBytecodeProgram is a compiled form of a small, simple Eidos block such as a callback body.  Compilation
+ lowers an optimized AST to a compact register-based bytecode, in which locals live in fixed register slots and all values
+ are unboxed singletons; a tiny VM then runs that bytecode without building symbol tables or an EidosInterpreter.
+
+ Only a conservative subset of the language is handled: singleton logical/integer/float/object values, arithmetic and
+ comparison operators, if/else and the ternary operator, assignment to simple locals, property reads, and a handful of
+ math functions.  Blocks using anything else fail to compile and are simply interpreted.  Compiled code has no side
+ effects, so whenever the VM meets a case it cannot handle exactly like the interpreter (integer overflow, a non-singleton
+ global, an undefined identifier, etc.) it "deoptimizes" by returning false, and the caller re-runs the block with the
+ interpreter from the start; that produces the same result, or the same error, as if bytecode had never been involved.
+
+ EidosBytecodeValue and ApplyOperator() are also used by EidosInterpreter, which evaluates operator subtrees with singleton
+ operands unboxed (see EidosInterpreter::_EvaluateScalarRoot()), so the two share one definition of those semantics.
+
+ */
+
+#ifndef __Eidos__eidos_bytecode__
+#define __Eidos__eidos_bytecode__
+
+#include <vector>
+#include <cstdint>
+
+#include "eidos_value.h"
+#include "eidos_symbol_table.h"
+#include "eidos_ast_node.h"
+
+
+enum class EidosBytecodeOp : uint8_t;
+
+// The type of an unboxed value held in a bytecode register
+enum class EidosBytecodeValueType : uint8_t {
+	kUnset = 0,			// an unassigned local, or an argument that is not available; never seen by operations
+	kVOID,
+	kNULL,
+	kLogical,
+	kInt,
+	kFloat,
+	kObject
+};
+
+// An unboxed singleton value; this is what bytecode registers, arguments, and results hold
+struct EidosBytecodeValue
+{
+	EidosBytecodeValueType type_;
+	union {
+		eidos_logical_t logical_;
+		int64_t int_;
+		double float_;
+		EidosObject *object_;
+	};
+
+	static inline __attribute__((always_inline)) EidosBytecodeValue Unset(void) { EidosBytecodeValue v; v.type_ = EidosBytecodeValueType::kUnset; v.int_ = 0; return v; }
+	static inline __attribute__((always_inline)) EidosBytecodeValue NULLValue(void) { EidosBytecodeValue v; v.type_ = EidosBytecodeValueType::kNULL; v.int_ = 0; return v; }
+	static inline __attribute__((always_inline)) EidosBytecodeValue Logical(eidos_logical_t p_value) { EidosBytecodeValue v; v.type_ = EidosBytecodeValueType::kLogical; v.int_ = 0; v.logical_ = p_value; return v; }
+	static inline __attribute__((always_inline)) EidosBytecodeValue Int(int64_t p_value) { EidosBytecodeValue v; v.type_ = EidosBytecodeValueType::kInt; v.int_ = p_value; return v; }
+	static inline __attribute__((always_inline)) EidosBytecodeValue Float(double p_value) { EidosBytecodeValue v; v.type_ = EidosBytecodeValueType::kFloat; v.float_ = p_value; return v; }
+	static inline __attribute__((always_inline)) EidosBytecodeValue Object(EidosObject *p_value) { EidosBytecodeValue v; v.type_ = EidosBytecodeValueType::kObject; v.object_ = p_value; return v; }
+
+	// Convert between unboxed and boxed values; UnboxValue() returns false if the value is not representable (not a
+	// singleton vector of a supported type), and BoxedValue() should not be called on kUnset
+	static inline bool UnboxValue(const EidosValue *p_value, EidosBytecodeValue *p_result);
+	EidosValue_SP BoxedValue(void) const;
+
+	// Apply one of the operators kAdd through kNot below, with the semantics of the corresponding interpreter operator on
+	// singletons; p_second is ignored for unary operators.  Returns false wherever the interpreter would raise, or would not
+	// produce a singleton, so that the caller can fall back to boxed evaluation.  Shared by the VM and EidosInterpreter.
+	static bool ApplyOperator(EidosBytecodeOp p_op, const EidosBytecodeValue &p_first, const EidosBytecodeValue &p_second, EidosBytecodeValue *p_result);
+};
+
+// This is inline, and casts to the final EidosValue subclasses so that Count() and the data accessors are not virtual calls,
+// because it is on the hot path of both the VM and the interpreter's unboxed evaluation of singleton arithmetic
+inline bool EidosBytecodeValue::UnboxValue(const EidosValue *p_value, EidosBytecodeValue *p_result)
+{
+	// matrices and arrays keep their dimensions through most operations, which we do not track, so we do not handle them
+	switch (p_value->Type())
+	{
+		case EidosValueType::kValueNULL:
+			*p_result = NULLValue();
+			return true;
+		case EidosValueType::kValueLogical:
+		{
+			const EidosValue_Logical *logical_value = static_cast<const EidosValue_Logical *>(p_value);
+
+			if ((logical_value->Count() != 1) || (logical_value->DimensionCount() != 1))
+				return false;
+			*p_result = Logical(logical_value->data()[0]);
+			return true;
+		}
+		case EidosValueType::kValueInt:
+		{
+			const EidosValue_Int *int_value = static_cast<const EidosValue_Int *>(p_value);
+
+			if ((int_value->Count() != 1) || (int_value->DimensionCount() != 1))
+				return false;
+			*p_result = Int(int_value->data()[0]);
+			return true;
+		}
+		case EidosValueType::kValueFloat:
+		{
+			const EidosValue_Float *float_value = static_cast<const EidosValue_Float *>(p_value);
+
+			if ((float_value->Count() != 1) || (float_value->DimensionCount() != 1))
+				return false;
+			*p_result = Float(float_value->data()[0]);
+			return true;
+		}
+		case EidosValueType::kValueObject:
+		{
+			const EidosValue_Object *object_value = static_cast<const EidosValue_Object *>(p_value);
+
+			if ((object_value->Count() != 1) || (object_value->DimensionCount() != 1))
+				return false;
+			*p_result = Object(object_value->data()[0]);
+			return true;
+		}
+		default:
+			return false;
+	}
+}
+
+// The operations of the VM; dst/src1/src2 are register indices, and operand_ is interpreted as noted
+enum class EidosBytecodeOp : uint8_t {
+	kLoadConstant = 0,	// dst = constants_[operand_]
+	kLoadArgument,		// dst = arguments[operand_]; deopt if unset
+	kLoadLocal,			// dst = src1 if it has been assigned, otherwise the global symbol operand_
+	kLoadGlobal,		// dst = the global symbol operand_
+	kStoreLocal,		// dst = src1; the first store to a slot checks that symbol operand_ is not a constant
+	kGetProperty,		// dst = src1.<property operand_>; token_ is blamed for errors
+	kAdd,				// dst = src1 + src2, and so forth
+	kSubtract,
+	kMultiply,
+	kDivide,
+	kModulo,
+	kPower,
+	kNegate,			// dst = -src1
+	kUnaryPlus,			// dst = +src1
+	kLess,				// dst = src1 < src2, and so forth
+	kLessOrEqual,
+	kGreater,
+	kGreaterOrEqual,
+	kEqual,
+	kNotEqual,
+	kAnd,				// dst = src1 & src2
+	kOr,				// dst = src1 | src2
+	kNot,				// dst = !src1
+	kCallMath,			// dst = f(src1), where operand_ is an EidosBytecodeMathFunction
+	kIsNULL,			// dst = isNULL(src1)
+	kJump,				// pc = operand_
+	kJumpIfFalse,		// if (!src1) pc = operand_
+	kReturn,			// return src1
+	kReturnVoid			// return VOID
+};
+
+enum class EidosBytecodeMathFunction : uint8_t {
+	kAbs = 0,
+	kExp,
+	kLog,
+	kLog10,
+	kLog2,
+	kSqrt
+};
+
+struct EidosBytecodeInstruction
+{
+	EidosBytecodeOp op_;
+	uint8_t dst_;
+	uint8_t src1_;
+	uint8_t src2_;
+	uint32_t operand_;				// a constant index, argument index, string ID, jump target, or function, depending on op_
+	const EidosToken *token_;		// NOT OWNED: the token to blame for errors, for operations that can raise
+};
+
+// The maximum number of registers (locals plus temporaries) a compiled program may use; larger blocks are not compiled
+#define EIDOS_BYTECODE_MAX_REGISTERS	64
+
+class EidosBytecodeProgram
+{
+	//	This class has its copy constructor and assignment operator disabled, to prevent accidental copying.
+
+	std::vector<EidosBytecodeInstruction> instructions_;
+	std::vector<EidosBytecodeValue> constants_;			// constant values are singletons of non-object type, so no retain is needed
+	int local_count_ = 0;								// registers [0, local_count_) are local variable slots
+	int register_count_ = 0;							// registers [local_count_, register_count_) are temporaries
+
+	friend class EidosBytecodeCompiler;
+
+	EidosBytecodeProgram(void) = default;
+
+public:
+
+	EidosBytecodeProgram(const EidosBytecodeProgram&) = delete;					// no copying
+	EidosBytecodeProgram& operator=(const EidosBytecodeProgram&) = delete;		// no copying
+	~EidosBytecodeProgram(void) = default;
+
+	// Compile an optimized compound-statement node; p_parameters gives the names of the arguments that will be passed to
+	// Execute(), in order.  Returns nullptr if the block uses anything the compiler does not handle.  The caller owns the result.
+	static EidosBytecodeProgram *Compile(const EidosASTNode *p_block_node, const std::vector<EidosGlobalStringID> &p_parameters);
+
+	// Execute the program; globals are looked up in p_symbols, and p_script_for_block is used for error context just as with
+	// EidosInterpreter::EvaluateInternalBlock().  Returns true with the block's value in p_result (which may be kVOID or
+	// kNULL), or false if execution must fall back to the interpreter.  Errors raised by property getters propagate.
+	bool Execute(const EidosBytecodeValue *p_arguments, const EidosSymbolTable &p_symbols, EidosScript *p_script_for_block, EidosBytecodeValue *p_result) const;
+
+	inline int InstructionCount(void) const { return (int)instructions_.size(); }
+};
+
+
+#endif /* __Eidos__eidos_bytecode__ */
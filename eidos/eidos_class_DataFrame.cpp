@@ -725,6 +725,9 @@ static EidosValue_SP Eidos_ExecuteFunction_readCSV(const std::vector<EidosValue_
 	std::string base_path = filePath_value->StringAtIndex_NOCAST(0, nullptr);
 	std::string file_path = Eidos_ResolvedPath(base_path);
 	
+	// wait for any pending asynchronous writes, which might be to this file
+	Eidos_WaitForAsyncFileWrites();
+	
 	std::ifstream file_stream(file_path.c_str());
 	
 	if (!file_stream.is_open())
@@ -72,6 +72,10 @@ EidosValue_SP Eidos_ExecuteFunction_deleteFile(const std::vector<EidosValue_SP>
 	std::string base_path = filePath_value->StringAtIndex_NOCAST(0, nullptr);
 	std::string file_path = Eidos_ResolvedPath(base_path);
 	
+	// if we are buffering compressed output for the file, flush it and close its gzip stream, so writes don't go to the deleted file
+	if (file_path.length())
+		Eidos_FlushFile(Eidos_AbsolutePath(base_path));
+	
 	result_SP = ((remove(file_path.c_str()) == 0) ? gStaticEidosValue_LogicalT : gStaticEidosValue_LogicalF);
 	
 	return result_SP;
@@ -88,6 +92,9 @@ EidosValue_SP Eidos_ExecuteFunction_fileExists(const std::vector<EidosValue_SP>
 	std::string base_path = filePath_value->StringAtIndex_NOCAST(0, nullptr);
 	std::string file_path = Eidos_ResolvedPath(base_path);
 	
+	// the file might be pending creation by the asynchronous file writer
+	Eidos_WaitForAsyncFileWrites();
+	
 	struct stat file_info;
 	bool path_exists = (stat(file_path.c_str(), &file_info) == 0);
 	
@@ -110,6 +117,9 @@ EidosValue_SP Eidos_ExecuteFunction_filesAtPath(const std::vector<EidosValue_SP>
 	std::string path = Eidos_ResolvedPath(base_path);
 	bool fullPaths = p_arguments[1]->LogicalAtIndex_NOCAST(0, nullptr);
 	
+	// files in the directory might be pending creation by the asynchronous file writer
+	Eidos_WaitForAsyncFileWrites();
+	
 	// this code modified from GNU: http://www.gnu.org/software/libc/manual/html_node/Simple-Directory-Lister.html#Simple-Directory-Lister
 	// I'm not sure if it works on Windows... sigh...
 	DIR *dp;
@@ -184,6 +194,9 @@ EidosValue_SP Eidos_ExecuteFunction_readFile(const std::vector<EidosValue_SP> &p
 	std::string base_path = filePath_value->StringAtIndex_NOCAST(0, nullptr);
 	std::string file_path = Eidos_ResolvedPath(base_path);
 	
+	// wait for any pending asynchronous writes, which might be to this file
+	Eidos_WaitForAsyncFileWrites();
+	
 	// read the contents in
 	std::ifstream file_stream(file_path.c_str());
 	
@@ -269,6 +282,9 @@ EidosValue_SP Eidos_ExecuteFunction_setwd(const std::vector<EidosValue_SP> &p_ar
 	std::string base_path = filePath_value->StringAtIndex_NOCAST(0, nullptr);
 	std::string final_path = Eidos_ResolvedPath(base_path);
 	
+	// pending asynchronous writes to relative paths need to complete in the old working directory
+	Eidos_WaitForAsyncFileWrites();
+	
 	errno = 0;
 	int retval = chdir(final_path.c_str());
 	
@@ -884,6 +884,8 @@ EidosValue_SP Eidos_ExecuteFunction_parallelGetTaskThreadCounts(__attribute__((u
 	objectElement->SetKeyValue_StringKeys("I_COUNT_OF_MUTS_OF_TYPE", EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Int(gEidos_OMP_threads_I_COUNT_OF_MUTS_OF_TYPE)));
 	objectElement->SetKeyValue_StringKeys("G_COUNT_OF_MUTS_OF_TYPE", EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Int(gEidos_OMP_threads_G_COUNT_OF_MUTS_OF_TYPE)));
 	objectElement->SetKeyValue_StringKeys("INDS_W_PEDIGREE_IDS", EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Int(gEidos_OMP_threads_INDS_W_PEDIGREE_IDS)));
+	objectElement->SetKeyValue_StringKeys("POPGEN_STATS", EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Int(gEidos_OMP_threads_POPGEN_STATS)));
+	objectElement->SetKeyValue_StringKeys("KDTREE_BUILD", EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Int(gEidos_OMP_threads_KDTREE_BUILD)));
 	objectElement->SetKeyValue_StringKeys("RELATEDNESS", EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Int(gEidos_OMP_threads_RELATEDNESS)));
 	objectElement->SetKeyValue_StringKeys("SAMPLE_INDIVIDUALS_1", EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Int(gEidos_OMP_threads_SAMPLE_INDIVIDUALS_1)));
 	objectElement->SetKeyValue_StringKeys("SAMPLE_INDIVIDUALS_2", EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Int(gEidos_OMP_threads_SAMPLE_INDIVIDUALS_2)));
@@ -961,6 +963,8 @@ EidosValue_SP Eidos_ExecuteFunction_parallelGetTaskThreadCounts(__attribute__((u
 	objectElement->SetKeyValue_StringKeys("SIMPLIFY_SORT_PRE", EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Int(gEidos_OMP_threads_SIMPLIFY_SORT_PRE)));
 	objectElement->SetKeyValue_StringKeys("SIMPLIFY_SORT", EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Int(gEidos_OMP_threads_SIMPLIFY_SORT)));
 	objectElement->SetKeyValue_StringKeys("SIMPLIFY_SORT_POST", EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Int(gEidos_OMP_threads_SIMPLIFY_SORT_POST)));
+	objectElement->SetKeyValue_StringKeys("SIMPLIFY_CHROMOSOMES", EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Int(gEidos_OMP_threads_SIMPLIFY_CHROMOSOMES)));
+	objectElement->SetKeyValue_StringKeys("TREESEQ_OUTPUT", EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Int(gEidos_OMP_threads_TREESEQ_OUTPUT)));
 	objectElement->SetKeyValue_StringKeys("PARENTS_CLEAR", EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Int(gEidos_OMP_threads_PARENTS_CLEAR)));
 	objectElement->SetKeyValue_StringKeys("UNIQUE_MUTRUNS", EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Int(gEidos_OMP_threads_UNIQUE_MUTRUNS)));
 	objectElement->SetKeyValue_StringKeys("SURVIVAL", EidosValue_SP(new (gEidosValuePool->AllocateChunk()) EidosValue_Int(gEidos_OMP_threads_SURVIVAL)));
@@ -1086,6 +1090,8 @@ EidosValue_SP Eidos_ExecuteFunction_parallelSetTaskThreadCounts(__attribute__((u
 						else if (key == "I_COUNT_OF_MUTS_OF_TYPE")		gEidos_OMP_threads_I_COUNT_OF_MUTS_OF_TYPE = (int)value_int64;
 						else if (key == "G_COUNT_OF_MUTS_OF_TYPE")		gEidos_OMP_threads_G_COUNT_OF_MUTS_OF_TYPE = (int)value_int64;
 						else if (key == "INDS_W_PEDIGREE_IDS")			gEidos_OMP_threads_INDS_W_PEDIGREE_IDS = (int)value_int64;
+						else if (key == "POPGEN_STATS")				gEidos_OMP_threads_POPGEN_STATS = (int)value_int64;
+						else if (key == "KDTREE_BUILD")				gEidos_OMP_threads_KDTREE_BUILD = (int)value_int64;
 						else if (key == "RELATEDNESS")					gEidos_OMP_threads_RELATEDNESS = (int)value_int64;
 						else if (key == "SAMPLE_INDIVIDUALS_1")			gEidos_OMP_threads_SAMPLE_INDIVIDUALS_1 = (int)value_int64;
 						else if (key == "SAMPLE_INDIVIDUALS_2")			gEidos_OMP_threads_SAMPLE_INDIVIDUALS_2 = (int)value_int64;
@@ -1163,6 +1169,8 @@ EidosValue_SP Eidos_ExecuteFunction_parallelSetTaskThreadCounts(__attribute__((u
 						else if (key == "SIMPLIFY_SORT_PRE")			gEidos_OMP_threads_SIMPLIFY_SORT_PRE = (int)value_int64;
 						else if (key == "SIMPLIFY_SORT")				gEidos_OMP_threads_SIMPLIFY_SORT = (int)value_int64;
 						else if (key == "SIMPLIFY_SORT_POST")			gEidos_OMP_threads_SIMPLIFY_SORT_POST = (int)value_int64;
+						else if (key == "SIMPLIFY_CHROMOSOMES")		gEidos_OMP_threads_SIMPLIFY_CHROMOSOMES = (int)value_int64;
+						else if (key == "TREESEQ_OUTPUT")				gEidos_OMP_threads_TREESEQ_OUTPUT = (int)value_int64;
 						else if (key == "PARENTS_CLEAR")				gEidos_OMP_threads_PARENTS_CLEAR = (int)value_int64;
 						else if (key == "UNIQUE_MUTRUNS")				gEidos_OMP_threads_UNIQUE_MUTRUNS = (int)value_int64;
 						else if (key == "SURVIVAL")						gEidos_OMP_threads_SURVIVAL = (int)value_int64;
@@ -1542,6 +1550,9 @@ EidosValue_SP Eidos_ExecuteFunction_system(const std::vector<EidosValue_SP> &p_a
 	if (!Eidos_TemporaryDirectoryExists())
 		EIDOS_TERMINATION << "ERROR (Eidos_ExecuteFunction_system): in function system(), the temporary directory appears not to exist or is not writeable." << EidosTerminate(nullptr);
 	
+	// the command might use files that are pending asynchronous writes, so those need to complete first
+	Eidos_WaitForAsyncFileWrites();
+	
 	EidosValue_String *command_value = (EidosValue_String *)p_arguments[0].get();
 	EidosValue_String *args_value = (EidosValue_String *)p_arguments[1].get();
 	int arg_count = args_value->Count();
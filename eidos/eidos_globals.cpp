@@ -73,6 +73,14 @@
 // for _Eidos_FlushZipBuffer()
 #include "../eidos_zlib/zlib.h"
 
+// for EidosAsyncFileWriter
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+
 // for Eidos_ColorPaletteLookup()
 #include "eidos_tinycolormap.h"
 
@@ -375,6 +383,8 @@ int gEidos_OMP_threads_CONTAINS_MARKER_MUT = EIDOS_OMP_MAX_THREADS;
 int gEidos_OMP_threads_I_COUNT_OF_MUTS_OF_TYPE = EIDOS_OMP_MAX_THREADS;
 int gEidos_OMP_threads_G_COUNT_OF_MUTS_OF_TYPE = EIDOS_OMP_MAX_THREADS;
 int gEidos_OMP_threads_INDS_W_PEDIGREE_IDS = EIDOS_OMP_MAX_THREADS;
+int gEidos_OMP_threads_POPGEN_STATS = EIDOS_OMP_MAX_THREADS;
+int gEidos_OMP_threads_KDTREE_BUILD = EIDOS_OMP_MAX_THREADS;
 int gEidos_OMP_threads_RELATEDNESS = EIDOS_OMP_MAX_THREADS;
 int gEidos_OMP_threads_SAMPLE_INDIVIDUALS_1 = EIDOS_OMP_MAX_THREADS;
 int gEidos_OMP_threads_SAMPLE_INDIVIDUALS_2 = EIDOS_OMP_MAX_THREADS;
@@ -452,6 +462,8 @@ int gEidos_OMP_threads_MIGRANT_CLEAR = EIDOS_OMP_MAX_THREADS;
 int gEidos_OMP_threads_SIMPLIFY_SORT_PRE = EIDOS_OMP_MAX_THREADS;
 int gEidos_OMP_threads_SIMPLIFY_SORT = EIDOS_OMP_MAX_THREADS;
 int gEidos_OMP_threads_SIMPLIFY_SORT_POST = EIDOS_OMP_MAX_THREADS;
+int gEidos_OMP_threads_SIMPLIFY_CHROMOSOMES = EIDOS_OMP_MAX_THREADS;
+int gEidos_OMP_threads_TREESEQ_OUTPUT = EIDOS_OMP_MAX_THREADS;
 int gEidos_OMP_threads_PARENTS_CLEAR = EIDOS_OMP_MAX_THREADS;
 int gEidos_OMP_threads_UNIQUE_MUTRUNS = EIDOS_OMP_MAX_THREADS;
 int gEidos_OMP_threads_SURVIVAL = EIDOS_OMP_MAX_THREADS;
@@ -531,6 +543,8 @@ void _Eidos_SetOpenMPThreadCounts(EidosPerTaskThreadCounts per_task_thread_count
 		gEidos_OMP_threads_I_COUNT_OF_MUTS_OF_TYPE = EIDOS_OMP_MAX_THREADS;
 		gEidos_OMP_threads_G_COUNT_OF_MUTS_OF_TYPE = EIDOS_OMP_MAX_THREADS;
 		gEidos_OMP_threads_INDS_W_PEDIGREE_IDS = EIDOS_OMP_MAX_THREADS;
+		gEidos_OMP_threads_POPGEN_STATS = EIDOS_OMP_MAX_THREADS;
+		gEidos_OMP_threads_KDTREE_BUILD = EIDOS_OMP_MAX_THREADS;
 		gEidos_OMP_threads_RELATEDNESS = EIDOS_OMP_MAX_THREADS;
 		gEidos_OMP_threads_SAMPLE_INDIVIDUALS_1 = EIDOS_OMP_MAX_THREADS;
 		gEidos_OMP_threads_SAMPLE_INDIVIDUALS_2 = EIDOS_OMP_MAX_THREADS;
@@ -608,6 +622,8 @@ void _Eidos_SetOpenMPThreadCounts(EidosPerTaskThreadCounts per_task_thread_count
 		gEidos_OMP_threads_SIMPLIFY_SORT_PRE = EIDOS_OMP_MAX_THREADS;
 		gEidos_OMP_threads_SIMPLIFY_SORT = EIDOS_OMP_MAX_THREADS;
 		gEidos_OMP_threads_SIMPLIFY_SORT_POST = EIDOS_OMP_MAX_THREADS;
+		gEidos_OMP_threads_SIMPLIFY_CHROMOSOMES = EIDOS_OMP_MAX_THREADS;
+		gEidos_OMP_threads_TREESEQ_OUTPUT = EIDOS_OMP_MAX_THREADS;
 		gEidos_OMP_threads_PARENTS_CLEAR = EIDOS_OMP_MAX_THREADS;
 		gEidos_OMP_threads_UNIQUE_MUTRUNS = EIDOS_OMP_MAX_THREADS;
 		gEidos_OMP_threads_SURVIVAL = EIDOS_OMP_MAX_THREADS;
@@ -668,6 +684,8 @@ void _Eidos_SetOpenMPThreadCounts(EidosPerTaskThreadCounts per_task_thread_count
 		gEidos_OMP_threads_I_COUNT_OF_MUTS_OF_TYPE = 16;
 		gEidos_OMP_threads_G_COUNT_OF_MUTS_OF_TYPE = 16;
 		gEidos_OMP_threads_INDS_W_PEDIGREE_IDS = 8;
+		gEidos_OMP_threads_POPGEN_STATS = 8;
+		gEidos_OMP_threads_KDTREE_BUILD = 8;
 		gEidos_OMP_threads_RELATEDNESS = 16;
 		gEidos_OMP_threads_SAMPLE_INDIVIDUALS_1 = 12;
 		gEidos_OMP_threads_SAMPLE_INDIVIDUALS_2 = 12;
@@ -745,6 +763,8 @@ void _Eidos_SetOpenMPThreadCounts(EidosPerTaskThreadCounts per_task_thread_count
 		gEidos_OMP_threads_SIMPLIFY_SORT_PRE = 8;
 		gEidos_OMP_threads_SIMPLIFY_SORT = 16;
 		gEidos_OMP_threads_SIMPLIFY_SORT_POST = 6;
+		gEidos_OMP_threads_SIMPLIFY_CHROMOSOMES = 16;
+		gEidos_OMP_threads_TREESEQ_OUTPUT = 8;
 		gEidos_OMP_threads_PARENTS_CLEAR = 16;
 		gEidos_OMP_threads_UNIQUE_MUTRUNS = 16;
 		gEidos_OMP_threads_SURVIVAL = 16;
@@ -807,6 +827,8 @@ void _Eidos_SetOpenMPThreadCounts(EidosPerTaskThreadCounts per_task_thread_count
 		gEidos_OMP_threads_I_COUNT_OF_MUTS_OF_TYPE = 40;
 		gEidos_OMP_threads_G_COUNT_OF_MUTS_OF_TYPE = 40;
 		gEidos_OMP_threads_INDS_W_PEDIGREE_IDS = 5;
+		gEidos_OMP_threads_POPGEN_STATS = 20;
+		gEidos_OMP_threads_KDTREE_BUILD = 20;
 		gEidos_OMP_threads_RELATEDNESS = 40;
 		gEidos_OMP_threads_SAMPLE_INDIVIDUALS_1 = 40;
 		gEidos_OMP_threads_SAMPLE_INDIVIDUALS_2 = 40;
@@ -884,6 +906,8 @@ void _Eidos_SetOpenMPThreadCounts(EidosPerTaskThreadCounts per_task_thread_count
 		gEidos_OMP_threads_SIMPLIFY_SORT_PRE = 20;
 		gEidos_OMP_threads_SIMPLIFY_SORT = 40;
 		gEidos_OMP_threads_SIMPLIFY_SORT_POST = 40;
+		gEidos_OMP_threads_SIMPLIFY_CHROMOSOMES = 40;
+		gEidos_OMP_threads_TREESEQ_OUTPUT = 20;
 		gEidos_OMP_threads_PARENTS_CLEAR = 40;
 		gEidos_OMP_threads_UNIQUE_MUTRUNS = 40;
 		gEidos_OMP_threads_SURVIVAL = 40;
@@ -971,6 +995,8 @@ void _Eidos_ClipOpenMPThreadCounts(void)
 	gEidos_OMP_threads_I_COUNT_OF_MUTS_OF_TYPE = std::min(gEidosMaxThreads, gEidos_OMP_threads_I_COUNT_OF_MUTS_OF_TYPE);
 	gEidos_OMP_threads_G_COUNT_OF_MUTS_OF_TYPE = std::min(gEidosMaxThreads, gEidos_OMP_threads_G_COUNT_OF_MUTS_OF_TYPE);
 	gEidos_OMP_threads_INDS_W_PEDIGREE_IDS = std::min(gEidosMaxThreads, gEidos_OMP_threads_INDS_W_PEDIGREE_IDS);
+	gEidos_OMP_threads_POPGEN_STATS = std::min(gEidosMaxThreads, gEidos_OMP_threads_POPGEN_STATS);
+	gEidos_OMP_threads_KDTREE_BUILD = std::min(gEidosMaxThreads, gEidos_OMP_threads_KDTREE_BUILD);
 	gEidos_OMP_threads_RELATEDNESS = std::min(gEidosMaxThreads, gEidos_OMP_threads_RELATEDNESS);
 	gEidos_OMP_threads_SAMPLE_INDIVIDUALS_1 = std::min(gEidosMaxThreads, gEidos_OMP_threads_SAMPLE_INDIVIDUALS_1);
 	gEidos_OMP_threads_SAMPLE_INDIVIDUALS_2 = std::min(gEidosMaxThreads, gEidos_OMP_threads_SAMPLE_INDIVIDUALS_2);
@@ -1048,6 +1074,8 @@ void _Eidos_ClipOpenMPThreadCounts(void)
 	gEidos_OMP_threads_SIMPLIFY_SORT_PRE = std::min(gEidosMaxThreads, gEidos_OMP_threads_SIMPLIFY_SORT_PRE);
 	gEidos_OMP_threads_SIMPLIFY_SORT = std::min(gEidosMaxThreads, gEidos_OMP_threads_SIMPLIFY_SORT);
 	gEidos_OMP_threads_SIMPLIFY_SORT_POST = std::min(gEidosMaxThreads, gEidos_OMP_threads_SIMPLIFY_SORT_POST);
+	gEidos_OMP_threads_SIMPLIFY_CHROMOSOMES = std::min(gEidosMaxThreads, gEidos_OMP_threads_SIMPLIFY_CHROMOSOMES);
+	gEidos_OMP_threads_TREESEQ_OUTPUT = std::min(gEidosMaxThreads, gEidos_OMP_threads_TREESEQ_OUTPUT);
 	gEidos_OMP_threads_PARENTS_CLEAR = std::min(gEidosMaxThreads, gEidos_OMP_threads_PARENTS_CLEAR);
 	gEidos_OMP_threads_UNIQUE_MUTRUNS = std::min(gEidosMaxThreads, gEidos_OMP_threads_UNIQUE_MUTRUNS);
 	gEidos_OMP_threads_SURVIVAL = std::min(gEidosMaxThreads, gEidos_OMP_threads_SURVIVAL);
@@ -2858,9 +2886,36 @@ int Eidos_mkstemps_directory(char *p_pattern, int p_suffix_len)
 // This contains all unflushed append data for zip files written by writeFile(); see Eidos_FlushFiles() below
 std::unordered_map<std::string, std::string> gEidosBufferedZipAppendData;
 
-// This flushes the bytes in outstring to the file at file_path, with gzip append
+// This contains the open gzip streams for zip files being appended to.  We used to open the file, write, and close it for each
+// flush of buffered data; but that starts a new gzip member, with a fresh compression dictionary, every time, which bloats the
+// output badly when flushes are frequent (as with LogFile's flushInterval), and pays for deflate setup and teardown each time.
+// Instead, we keep one deflate stream open per file across flushes.  A forced flush does a Z_SYNC_FLUSH, so all data written so
+// far can be decompressed, but the gzip member is only finished (with its trailer) when Eidos_FlushFile() or Eidos_FlushFiles()
+// closes the stream.  To avoid running out of file descriptors, we limit the number of streams open at once.
+static std::unordered_map<std::string, gzFile> gEidosOpenZipAppendStreams;
+
+#define EIDOS_MAX_OPEN_ZIP_STREAMS	64
+
+// This closes the open gzip stream for file_path, if there is one, finishing its gzip member
+// If an error occurs, it returns false; it should not raise
+static bool _Eidos_CloseZipStream(const std::string &file_path)
+{
+	auto stream_iter = gEidosOpenZipAppendStreams.find(file_path);
+	
+	if (stream_iter == gEidosOpenZipAppendStreams.end())
+		return true;
+	
+	int retval = gzclose_w(stream_iter->second);
+	
+	gEidosOpenZipAppendStreams.erase(stream_iter);
+	
+	return (retval == Z_OK);
+}
+
+// This flushes the bytes in outstring to the file at file_path, with gzip append, through a persistent gzip stream for the file
+// If sync_flush is true, the compressed data is pushed out to the file; otherwise zlib writes it out when its buffers fill
 // If an error occurs, it returns false; it should not raise
-bool _Eidos_FlushZipBuffer(const std::string &file_path, const std::string &outstring)
+bool _Eidos_FlushZipBuffer(const std::string &file_path, const std::string &outstring, bool sync_flush)
 {
 	THREAD_SAFETY_IN_ACTIVE_PARALLEL("_Eidos_FlushZipBuffer():  filesystem write");
 	
@@ -2868,97 +2923,113 @@ bool _Eidos_FlushZipBuffer(const std::string &file_path, const std::string &outs
 	
 	const char *outcstr = outstring.c_str();
 	size_t outcstr_length = outstring.length();
+	auto stream_iter = gEidosOpenZipAppendStreams.find(file_path);
+	gzFile gzf;
 	
-	if (outcstr_length == 0)
-		return true;
-	
-	gzFile gzf = gzopen(file_path.c_str(), "ab");
-	
-	if (!gzf)
+	if (stream_iter != gEidosOpenZipAppendStreams.end())
 	{
-		//std::cerr << "errno == " << errno << std::endl;
-		return false;
+		gzf = stream_iter->second;
+	}
+	else
+	{
+		if (outcstr_length == 0)
+			return true;
+		
+		if (gEidosOpenZipAppendStreams.size() >= EIDOS_MAX_OPEN_ZIP_STREAMS)
+		{
+			// finish an arbitrary stream to make room; appending to it later will simply start a new gzip member
+			std::string victim_path = gEidosOpenZipAppendStreams.begin()->first;
+			
+			if (!_Eidos_CloseZipStream(victim_path))
+				return false;
+		}
+		
+		gzf = gzopen(file_path.c_str(), "ab");
+		
+		if (!gzf)
+		{
+			//std::cerr << "errno == " << errno << std::endl;
+			return false;
+		}
+		
+		int retval = gzbuffer(gzf, 128*1024L);	// bigger buffer for greater speed
+		
+		if (retval == -1)
+		{
+			gzclose_w(gzf);
+			return false;
+		}
+		
+		gEidosOpenZipAppendStreams.emplace(file_path, gzf);
 	}
 	
 	// do the writing with zlib
-	int retval = gzbuffer(gzf, 128*1024L);	// bigger buffer for greater speed
-	
-	if (retval == -1)
-		return false;
-	
-	retval = gzwrite(gzf, outcstr, (unsigned)outcstr_length);
-	
-	if (retval == 0)
-		return false;
-	
-	retval = gzclose_w(gzf);
+	if (outcstr_length > 0)
+	{
+		int retval = gzwrite(gzf, outcstr, (unsigned)outcstr_length);
+		
+		if (retval == 0)
+			return false;
+	}
 	
-	if (retval != Z_OK)
-		return false;
+	if (sync_flush)
+	{
+		int retval = gzflush(gzf, Z_SYNC_FLUSH);
+		
+		if (retval != Z_OK)
+			return false;
+	}
 	
 	return true;
 }
 #endif
 
-// This flushes a given file, if it is buffering zip output
-// This raises if an error occurs
-void Eidos_FlushFile(const std::string &p_file_path)
+// This flushes a given file, if it is buffering zip output, and closes its gzip stream
+// If an error occurs, it returns false with an error message in p_error; it should not raise
+static bool _Eidos_FlushFile(const std::string &p_file_path, std::string *p_error)
 {
-	THREAD_SAFETY_IN_ACTIVE_PARALLEL("Eidos_FlushFile():  filesystem write");
-	
 #if EIDOS_BUFFER_ZIP_APPENDS
 	auto buffer_iter = gEidosBufferedZipAppendData.find(p_file_path);
 	
 	if (buffer_iter != gEidosBufferedZipAppendData.end())
 	{
-		bool result = _Eidos_FlushZipBuffer(buffer_iter->first, buffer_iter->second);
+		bool result = _Eidos_FlushZipBuffer(buffer_iter->first, buffer_iter->second, false);
 		
 		if (!result)
-			EIDOS_TERMINATION << "ERROR (Eidos_FlushFile): Flush of gzip data to file " << buffer_iter->first << " failed!" << EidosTerminate(nullptr);
+		{
+			*p_error = "ERROR (Eidos_FlushFile): Flush of gzip data to file " + p_file_path + " failed!";
+			return false;
+		}
 		
 		gEidosBufferedZipAppendData.erase(buffer_iter);
 	}
-#endif
-}
-
-// This flushes all outstanding buffered zip data to the appropriate files
-// This returns false if an error occurs
-bool Eidos_FlushFiles(void)
-{
-	THREAD_SAFETY_IN_ACTIVE_PARALLEL("Eidos_FlushFiles():  filesystem write");
-	
-#if EIDOS_BUFFER_ZIP_APPENDS
-	// Write out buffered data in gEidosBufferedZipAppendData to the appropriate files, using zlib's gzip append mode
-	bool success = true;
 	
-	for (auto &buffer_pair : gEidosBufferedZipAppendData)
+	if (!_Eidos_CloseZipStream(p_file_path))
 	{
-		bool result = _Eidos_FlushZipBuffer(buffer_pair.first, buffer_pair.second);
-		
-		if (!result)
-		{
-			// Note that we do this without a raise, because we often want to flush when we're already handling a raise,
-			// and also we want to try to flush all of our files before halting, not halt on the first flush failure.
-			// The caller should report the error to the user in some way, if this stderr log is insufficient.
-			std::cerr << std::endl << "ERROR (Eidos_FlushFiles): Flush of gzip data to file " << buffer_pair.first << " failed!" << std::endl;
-			success = false;
-		}
+		*p_error = "ERROR (Eidos_FlushFile): Flush of gzip data to file " + p_file_path + " failed!";
+		return false;
 	}
-	
-	gEidosBufferedZipAppendData.clear();
-	
-	return success;
+#else
+#pragma unused (p_file_path, p_error)
 #endif
 	
 	return true;
 }
 
-void Eidos_WriteToFile(const std::string &p_file_path, const std::vector<const std::string *> &p_contents, bool p_append, bool p_compress, EidosFileFlush p_flush_option)
+// This does the work of Eidos_WriteToFile(), on whichever thread is doing the writing
+// If an error occurs, it returns false with an error message in p_error; it should not raise
+static bool _Eidos_WriteToFile(const std::string &p_file_path, const std::vector<const std::string *> &p_contents, bool p_append, bool p_compress, EidosFileFlush p_flush_option, std::string *p_error)
 {
-	THREAD_SAFETY_IN_ACTIVE_PARALLEL("Eidos_WriteToFile():  filesystem write");
-	
 	// note that we add a newline after the last line in all cases, so that appending new content to a file produces correct line breaks
 	
+#if EIDOS_BUFFER_ZIP_APPENDS
+	// if we are about to replace the file, first flush any buffered data for it and close its gzip stream, which would otherwise
+	// continue writing into the replaced file; this also keeps writes to the file in the order they were requested
+	if (!p_append)
+		if (!_Eidos_FlushFile(p_file_path, p_error))
+			return false;
+#endif
+	
 	if (p_compress)
 	{
 		// compression using zlib; very different from the no-compression case, unfortunately, because here we use C-based APIs
@@ -2981,14 +3052,18 @@ void Eidos_WriteToFile(const std::string &p_file_path, const std::vector<const s
 			}
 			
 			// if the buffer data exceeds a (somewhat arbitrary) 128K buffer maximum, write it out and remove the buffer entry
+			// a forced flush also syncs the file's gzip stream, so that everything written so far can be decompressed
 			if ((p_flush_option == EidosFileFlush::kForceFlush) ||
 				((p_flush_option == EidosFileFlush::kDefaultFlush) && (buffer.length() > 1024L * 128L)))
 			{
-				bool result = _Eidos_FlushZipBuffer(p_file_path, buffer);
+				bool result = _Eidos_FlushZipBuffer(p_file_path, buffer, (p_flush_option == EidosFileFlush::kForceFlush));
 				gEidosBufferedZipAppendData.erase(buffer_iter);
 				
 				if (!result)
-					EIDOS_TERMINATION << "#ERROR (Eidos_WriteToFile): could not flush zip buffer to file at path " << p_file_path << "." << EidosTerminate(nullptr);
+				{
+					*p_error = "#ERROR (Eidos_WriteToFile): could not flush zip buffer to file at path " + p_file_path + ".";
+					return false;
+				}
 			}
 		}
 		else
@@ -2999,7 +3074,10 @@ void Eidos_WriteToFile(const std::string &p_file_path, const std::vector<const s
 			gzFile gzf = gzopen(p_file_path.c_str(), p_append ? "ab" : "wb");
 			
 			if (!gzf)
-				EIDOS_TERMINATION << "#ERROR (Eidos_WriteToFile): could not write to file at path " << p_file_path << "." << EidosTerminate(nullptr);
+			{
+				*p_error = "#ERROR (Eidos_WriteToFile): could not write to file at path " + p_file_path + ".";
+				return false;
+			}
 			
 			std::ostringstream outstream;
 			
@@ -3028,7 +3106,10 @@ void Eidos_WriteToFile(const std::string &p_file_path, const std::vector<const s
 			}
 			
 			if (failed)
-				EIDOS_TERMINATION << "#ERROR (Eidos_WriteToFile): encountered zlib errors while writing to file at path " << p_file_path << "." << EidosTerminate(nullptr);
+			{
+				*p_error = "#ERROR (Eidos_WriteToFile): encountered zlib errors while writing to file at path " + p_file_path + ".";
+				return false;
+			}
 		}
 	}
 	else
@@ -3037,14 +3118,374 @@ void Eidos_WriteToFile(const std::string &p_file_path, const std::vector<const s
 		std::ofstream file_stream(p_file_path.c_str(), p_append ? (std::ios_base::app | std::ios_base::out) : std::ios_base::out);
 		
 		if (!file_stream.is_open())
-			EIDOS_TERMINATION << "#ERROR (Eidos_WriteToFile): could not write to file at path " << p_file_path << "." << EidosTerminate(nullptr);
+		{
+			*p_error = "#ERROR (Eidos_WriteToFile): could not write to file at path " + p_file_path + ".";
+			return false;
+		}
 		
 		for (const std::string *content_line : p_contents)
 			file_stream << *content_line << std::endl;
 		
 		if (file_stream.bad())
-			EIDOS_TERMINATION << "#ERROR (Eidos_WriteToFile): encountered stream errors while writing to file at path " << p_file_path << "." << EidosTerminate(nullptr);
+		{
+			*p_error = "#ERROR (Eidos_WriteToFile): encountered stream errors while writing to file at path " + p_file_path + ".";
+			return false;
+		}
+	}
+	
+	return true;
+}
+
+// This writes a block of already formatted data to a file, on whichever thread is doing the writing
+// If an error occurs, it returns false with an error message in p_error; it should not raise
+static bool _Eidos_WriteDataToFile(const std::string &p_file_path, const std::string &p_data, bool p_append, bool p_binary, std::string *p_error)
+{
+#if EIDOS_BUFFER_ZIP_APPENDS
+	// as in _Eidos_WriteToFile(), finish any gzip stream for the file before replacing it
+	if (!p_append)
+		if (!_Eidos_FlushFile(p_file_path, p_error))
+			return false;
+#endif
+	
+	std::ios_base::openmode mode = std::ios_base::out;
+	
+	if (p_append)
+		mode |= std::ios_base::app;
+	if (p_binary)
+		mode |= std::ios_base::binary;
+	
+	std::ofstream file_stream(p_file_path.c_str(), mode);
+	
+	if (!file_stream.is_open())
+	{
+		*p_error = "#ERROR (Eidos_WriteDataToFile): could not write to file at path " + p_file_path + ".";
+		return false;
 	}
+	
+	file_stream.write(p_data.data(), (std::streamsize)p_data.length());
+	file_stream.close();
+	
+	if (file_stream.fail())
+	{
+		*p_error = "#ERROR (Eidos_WriteDataToFile): encountered stream errors while writing to file at path " + p_file_path + ".";
+		return false;
+	}
+	
+	return true;
+}
+
+// The background writer thread for asynchronous file writing; see Eidos_SetAsyncFileWriting().  Write jobs are queued by the
+// main thread and performed by the writer thread strictly in the order queued, so writes to a given file stay ordered, and
+// the zip append buffers and gzip streams above are only touched by the writer thread while it has work.  The queue is bounded
+// both in the number of jobs and in the number of bytes they hold, so that a producer outrunning the disk blocks rather than
+// holding an unbounded amount of formatted output in memory.  A job that fails records its error message, which is raised
+// on the main thread at the next enqueue or barrier; the remaining jobs still run, so that as much output as possible is saved.
+#define EIDOS_ASYNC_MAX_QUEUED_JOBS		1024
+#define EIDOS_ASYNC_MAX_QUEUED_BYTES	(256L * 1024L * 1024L)
+
+class EidosAsyncFileWriter
+{
+private:
+	std::thread thread_;
+	std::mutex mutex_;
+	std::condition_variable work_available_;
+	std::condition_variable work_done_;
+	std::deque<std::pair<std::function<bool(std::string *)>, size_t>> jobs_;
+	size_t queued_bytes_ = 0;
+	bool busy_ = false;
+	bool stop_ = false;
+	std::string error_;
+	
+	void Run(void);
+	
+public:
+	EidosAsyncFileWriter(const EidosAsyncFileWriter&) = delete;
+	EidosAsyncFileWriter& operator=(const EidosAsyncFileWriter&) = delete;
+	EidosAsyncFileWriter(void);
+	~EidosAsyncFileWriter(void);
+	
+	bool Enqueue(std::function<bool(std::string *)> &&p_job, size_t p_bytes, std::string *p_error);
+	bool Drain(std::string *p_error);
+};
+
+EidosAsyncFileWriter::EidosAsyncFileWriter(void)
+{
+	thread_ = std::thread(&EidosAsyncFileWriter::Run, this);
+}
+
+EidosAsyncFileWriter::~EidosAsyncFileWriter(void)
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		stop_ = true;
+	}
+	
+	work_available_.notify_one();
+	thread_.join();
+}
+
+void EidosAsyncFileWriter::Run(void)
+{
+	std::unique_lock<std::mutex> lock(mutex_);
+	
+	while (true)
+	{
+		work_available_.wait(lock, [this] { return stop_ || !jobs_.empty(); });
+		
+		if (jobs_.empty())
+			break;		// stop_ is set and all work is done
+		
+		std::function<bool(std::string *)> job = std::move(jobs_.front().first);
+		size_t job_bytes = jobs_.front().second;
+		
+		jobs_.pop_front();
+		busy_ = true;
+		lock.unlock();
+		
+		// do the write with the lock released, so the main thread can keep queueing work
+		std::string job_error;
+		bool result;
+		
+		try {
+			result = job(&job_error);
+		} catch (...) {
+			job_error = "#ERROR (EidosAsyncFileWriter): an exception was thrown while writing to a file.";
+			result = false;
+		}
+		
+		// free the job's data before reporting that its bytes have left the queue
+		job = nullptr;
+		
+		lock.lock();
+		
+		if (!result && error_.empty())
+			error_ = (job_error.length() ? job_error : "#ERROR (EidosAsyncFileWriter): an unknown error occurred while writing to a file.");
+		
+		queued_bytes_ -= job_bytes;
+		busy_ = false;
+		work_done_.notify_all();
+	}
+}
+
+// Queues a job, blocking while the queue is full; a job larger than the byte limit is accepted once the queue is empty
+// Returns false with the message from an earlier failed job, if there is one, without queueing
+bool EidosAsyncFileWriter::Enqueue(std::function<bool(std::string *)> &&p_job, size_t p_bytes, std::string *p_error)
+{
+	std::unique_lock<std::mutex> lock(mutex_);
+	
+	work_done_.wait(lock, [this, p_bytes] {
+		return (jobs_.size() < EIDOS_ASYNC_MAX_QUEUED_JOBS) && (jobs_.empty() || (queued_bytes_ + p_bytes <= (size_t)EIDOS_ASYNC_MAX_QUEUED_BYTES));
+	});
+	
+	if (error_.length())
+	{
+		std::swap(*p_error, error_);
+		error_.clear();
+		return false;
+	}
+	
+	jobs_.emplace_back(std::move(p_job), p_bytes);
+	queued_bytes_ += p_bytes;
+	lock.unlock();
+	
+	work_available_.notify_one();
+	return true;
+}
+
+// Waits until all queued jobs have completed; returns false with the message from the first failed job, if there is one
+bool EidosAsyncFileWriter::Drain(std::string *p_error)
+{
+	std::unique_lock<std::mutex> lock(mutex_);
+	
+	work_done_.wait(lock, [this] { return jobs_.empty() && !busy_; });
+	
+	if (error_.length())
+	{
+		std::swap(*p_error, error_);
+		error_.clear();
+		return false;
+	}
+	
+	return true;
+}
+
+// The writer is allocated when asynchronous writing is enabled; note that if exit() is called while it is enabled, the writer is
+// leaked deliberately, after being drained by Eidos_FlushFiles(), since joining its thread from a static destructor is unsafe
+static EidosAsyncFileWriter *gEidosAsyncFileWriter = nullptr;
+
+void Eidos_SetAsyncFileWriting(bool p_enabled)
+{
+	THREAD_SAFETY_IN_ANY_PARALLEL("Eidos_SetAsyncFileWriting(): gEidosAsyncFileWriter change");
+	
+	if (p_enabled && !gEidosAsyncFileWriter)
+	{
+		gEidosAsyncFileWriter = new EidosAsyncFileWriter();
+	}
+	else if (!p_enabled && gEidosAsyncFileWriter)
+	{
+		// drain the queue before tearing down the writer, so that errors can be raised, and then join its thread
+		std::string error;
+		bool result = gEidosAsyncFileWriter->Drain(&error);
+		
+		delete gEidosAsyncFileWriter;
+		gEidosAsyncFileWriter = nullptr;
+		
+		if (!result)
+			EIDOS_TERMINATION << error << EidosTerminate(nullptr);
+	}
+}
+
+bool Eidos_AsyncFileWritingEnabled(void)
+{
+	return (gEidosAsyncFileWriter != nullptr);
+}
+
+void Eidos_WaitForAsyncFileWrites(void)
+{
+	THREAD_SAFETY_IN_ACTIVE_PARALLEL("Eidos_WaitForAsyncFileWrites():  filesystem write");
+	
+	if (gEidosAsyncFileWriter)
+	{
+		std::string error;
+		
+		if (!gEidosAsyncFileWriter->Drain(&error))
+			EIDOS_TERMINATION << error << EidosTerminate(nullptr);
+	}
+}
+
+void Eidos_EnqueueFileWrite(std::function<bool(std::string *p_error)> &&p_job, size_t p_bytes)
+{
+	THREAD_SAFETY_IN_ACTIVE_PARALLEL("Eidos_EnqueueFileWrite():  filesystem write");
+	
+	std::string error;
+	bool result;
+	
+	if (gEidosAsyncFileWriter)
+		result = gEidosAsyncFileWriter->Enqueue(std::move(p_job), p_bytes, &error);
+	else
+		result = p_job(&error);
+	
+	if (!result)
+		EIDOS_TERMINATION << error << EidosTerminate(nullptr);
+}
+
+// This flushes a given file, if it is buffering zip output, and closes its gzip stream
+// This raises if an error occurs
+void Eidos_FlushFile(const std::string &p_file_path)
+{
+	THREAD_SAFETY_IN_ACTIVE_PARALLEL("Eidos_FlushFile():  filesystem write");
+	
+	// with asynchronous writing, wait until the writer thread is idle; after that, the zip buffers are ours to touch
+	Eidos_WaitForAsyncFileWrites();
+	
+	std::string error;
+	
+	if (!_Eidos_FlushFile(p_file_path, &error))
+		EIDOS_TERMINATION << error << EidosTerminate(nullptr);
+}
+
+// This flushes all outstanding buffered zip data to the appropriate files, and closes all gzip streams
+// This returns false if an error occurs
+bool Eidos_FlushFiles(void)
+{
+	THREAD_SAFETY_IN_ACTIVE_PARALLEL("Eidos_FlushFiles():  filesystem write");
+	
+	bool success = true;
+	
+	// First, with asynchronous writing, wait for all queued writes to complete; again, we do not raise here
+	if (gEidosAsyncFileWriter)
+	{
+		std::string error;
+		
+		if (!gEidosAsyncFileWriter->Drain(&error))
+		{
+			std::cerr << std::endl << error << std::endl;
+			success = false;
+		}
+	}
+	
+#if EIDOS_BUFFER_ZIP_APPENDS
+	// Write out buffered data in gEidosBufferedZipAppendData to the appropriate files, using zlib's gzip append mode
+	for (auto &buffer_pair : gEidosBufferedZipAppendData)
+	{
+		bool result = _Eidos_FlushZipBuffer(buffer_pair.first, buffer_pair.second, false);
+		
+		if (!result)
+		{
+			// Note that we do this without a raise, because we often want to flush when we're already handling a raise,
+			// and also we want to try to flush all of our files before halting, not halt on the first flush failure.
+			// The caller should report the error to the user in some way, if this stderr log is insufficient.
+			std::cerr << std::endl << "ERROR (Eidos_FlushFiles): Flush of gzip data to file " << buffer_pair.first << " failed!" << std::endl;
+			success = false;
+		}
+	}
+	
+	gEidosBufferedZipAppendData.clear();
+	
+	// Then close all of the open gzip streams, finishing their gzip members
+	for (auto &stream_pair : gEidosOpenZipAppendStreams)
+	{
+		if (gzclose_w(stream_pair.second) != Z_OK)
+		{
+			std::cerr << std::endl << "ERROR (Eidos_FlushFiles): Flush of gzip data to file " << stream_pair.first << " failed!" << std::endl;
+			success = false;
+		}
+	}
+	
+	gEidosOpenZipAppendStreams.clear();
+#endif
+	
+	return success;
+}
+
+void Eidos_WriteToFile(const std::string &p_file_path, const std::vector<const std::string *> &p_contents, bool p_append, bool p_compress, EidosFileFlush p_flush_option)
+{
+	THREAD_SAFETY_IN_ACTIVE_PARALLEL("Eidos_WriteToFile():  filesystem write");
+	
+	if (gEidosAsyncFileWriter)
+	{
+		// the caller's strings may not outlive this call, so the writer thread gets its own copy of the lines
+		std::shared_ptr<std::vector<std::string>> lines = std::make_shared<std::vector<std::string>>();
+		size_t bytes = 0;
+		
+		lines->reserve(p_contents.size());
+		
+		for (const std::string *content_line : p_contents)
+		{
+			lines->emplace_back(*content_line);
+			bytes += content_line->length() + 1;
+		}
+		
+		Eidos_EnqueueFileWrite([p_file_path, lines, p_append, p_compress, p_flush_option](std::string *p_error) {
+			std::vector<const std::string *> contents;
+			
+			contents.reserve(lines->size());
+			
+			for (const std::string &line : *lines)
+				contents.emplace_back(&line);
+			
+			return _Eidos_WriteToFile(p_file_path, contents, p_append, p_compress, p_flush_option, p_error);
+		}, bytes);
+	}
+	else
+	{
+		std::string error;
+		
+		if (!_Eidos_WriteToFile(p_file_path, p_contents, p_append, p_compress, p_flush_option, &error))
+			EIDOS_TERMINATION << error << EidosTerminate(nullptr);
+	}
+}
+
+void Eidos_WriteDataToFile(const std::string &p_file_path, std::string &&p_data, bool p_append, bool p_binary)
+{
+	THREAD_SAFETY_IN_ACTIVE_PARALLEL("Eidos_WriteDataToFile():  filesystem write");
+	
+	std::shared_ptr<std::string> data = std::make_shared<std::string>(std::move(p_data));
+	size_t bytes = data->length();
+	
+	Eidos_EnqueueFileWrite([p_file_path, data, p_append, p_binary](std::string *p_error) {
+		return _Eidos_WriteDataToFile(p_file_path, *data, p_append, p_binary, p_error);
+	}, bytes);
 }
 
 
@@ -32,6 +32,7 @@
 #include <numeric>
 #include <algorithm>
 #include <unordered_map>
+#include <functional>
 #include <cstdint>
 
 // Workaround for Xcode bug: when you want to debug build problems with a Release build related to profiling, uncomment this,
@@ -625,20 +626,38 @@ int Eidos_mkstemps_directory(char *p_pattern, int p_suffix_len);
 
 #if EIDOS_BUFFER_ZIP_APPENDS	// implementation details for Eidos_FlushFiles(); for internal use only
 extern std::unordered_map<std::string, std::string> gEidosBufferedZipAppendData;	// canonical absolute file path -> buffered text
-bool _Eidos_FlushZipBuffer(const std::string &p_file_path, const std::string &p_outstring);
+bool _Eidos_FlushZipBuffer(const std::string &p_file_path, const std::string &p_outstring, bool p_sync_flush);
 #endif
 
-void Eidos_FlushFile(const std::string &p_file_path);
+void Eidos_FlushFile(const std::string &p_file_path);	// Waits for pending writes, flushes buffered append data for one file, and finishes its gzip stream; raises on failure
 bool Eidos_FlushFiles(void);			// This should be called at the end of execution, or any other appropriate time, to flush buffered file append data; returns false for failure
 
 enum class EidosFileFlush {
 	kNoFlush = 0,		// no flush, no matter what
 	kDefaultFlush,		// flush if the buffer is over a threshold number of bytes
-	kForceFlush			// flush, no matter what; not recommended with compression
+	kForceFlush			// flush, no matter what; with compression this syncs the file's gzip stream, costing a little compression
 };
 
 void Eidos_WriteToFile(const std::string &p_file_path, const std::vector<const std::string *> &p_contents, bool p_append, bool p_compress, EidosFileFlush p_flush_option);
 
+// Asynchronous file writing.  When enabled, writes requested through the functions above and below are handed off to a background
+// writer thread, which performs them in the order requested, so that the main thread can get on with the simulation while output
+// goes to disk.  The queue of pending writes is bounded; when it is full, a request blocks until the writer catches up.  Errors
+// on the writer thread are raised on the main thread at the next request or barrier.  Eidos_WaitForAsyncFileWrites() is that
+// barrier: anything that reads a file that might have been written, or that needs output to be complete, must call it first.
+// Eidos_FlushFile() and Eidos_FlushFiles() include it.  This is off by default; in slim it is turned on with -asyncIO.
+void Eidos_SetAsyncFileWriting(bool p_enabled);
+bool Eidos_AsyncFileWritingEnabled(void);
+void Eidos_WaitForAsyncFileWrites(void);
+
+// Performs a write job, on the writer thread if asynchronous writing is enabled, or immediately otherwise; the job returns false
+// with an error message on failure, and must not raise or touch state that the main thread might be using.  p_bytes is the
+// amount of memory held by the job until it runs, used to bound the queue.
+void Eidos_EnqueueFileWrite(std::function<bool(std::string *p_error)> &&p_job, size_t p_bytes);
+
+// Writes pre-formatted data to a file, taking ownership of it; this is for output methods that build their output in memory
+void Eidos_WriteDataToFile(const std::string &p_file_path, std::string &&p_data, bool p_append, bool p_binary);
+
 
 // *******************************************************************************************************************
 //
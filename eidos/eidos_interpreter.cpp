@@ -2150,8 +2150,136 @@ EidosValue_SP EidosInterpreter::Evaluate_MemberRef(const EidosASTNode *p_node)
 	return result_SP;
 }
 
+// The number of times a scalar root may fall back to boxed evaluation before we stop trying; a subtree that keeps meeting
+// non-singleton operands is not going to start meeting singletons, and each failed attempt repeats some evaluation work
+#define EIDOS_SCALAR_ROOT_FAILURE_LIMIT		8
+
+bool EidosInterpreter::_EvaluateScalarRoot(const EidosASTNode *p_node, EidosValue_SP &p_result)
+{
+	// Execution logging and tolerant identifier lookup both need the boxed path, which implements them
+	if (logging_execution_ || use_custom_undefined_identifier_raise_)
+		return false;
+	
+	// Intermediate values live in EidosBytecodeValue locals on the stack as _EvaluateScalarNode() recurses; only the final
+	// result escapes, and only it is boxed.  Since eligible subtrees have no side effects, a failure can just be re-evaluated.
+	EidosBytecodeValue scalar_result;
+	
+	if (_EvaluateScalarNode(p_node, &scalar_result))
+	{
+		p_result = scalar_result.BoxedValue();
+		return true;
+	}
+	
+	if (++p_node->scalar_failure_count_ >= EIDOS_SCALAR_ROOT_FAILURE_LIMIT)
+		p_node->cached_scalar_expression_ = 1;
+	
+	return false;
+}
+
+bool EidosInterpreter::_EvaluateScalarNode(const EidosASTNode *p_node, EidosBytecodeValue *p_result)
+{
+	// Evaluation order, error positions, and errors raised by symbol lookup and property getters must match the boxed
+	// evaluators exactly; anything else that the boxed path would raise for, or that is not a singleton, returns false
+	const EidosValue_SP &literal_value = p_node->cached_literal_value_;
+	
+	if (literal_value)
+		return EidosBytecodeValue::UnboxValue(literal_value.get(), p_result);
+	
+	const std::vector<EidosASTNode *> &children = p_node->children_;
+	EidosBytecodeOp op;
+	
+	switch (p_node->token_->token_type_)
+	{
+		case EidosTokenType::kTokenIdentifier:
+			// the symbol table keeps an object value alive while we hold a bare pointer to it, since this subtree cannot assign
+			return EidosBytecodeValue::UnboxValue(Evaluate_Identifier_RAW(p_node), p_result);
+		case EidosTokenType::kTokenDot:
+		{
+			EidosBytecodeValue target;
+			
+			if (!_EvaluateScalarNode(children[0], &target) || (target.type_ != EidosBytecodeValueType::kObject))
+				return false;
+			
+			const EidosASTNode *property_node = children[1];
+			EidosGlobalStringID property_id = property_node->cached_stringID_;
+			EidosObject *object = target.object_;
+			
+			if (!object->Class()->SignatureForProperty(property_id))
+				return false;
+			
+			EidosErrorPosition error_pos_save = PushErrorPositionFromToken(property_node->token_);
+			EidosValue_SP property_value = object->GetProperty(property_id);
+			RestoreErrorPosition(error_pos_save);
+			
+			if (!EidosBytecodeValue::UnboxValue(property_value.get(), p_result))
+				return false;
+			
+			// property_value may hold the only reference to a retained object, in which case a bare pointer would dangle
+			if ((p_result->type_ == EidosBytecodeValueType::kObject) && p_result->object_->Class()->UsesRetainRelease())
+				return false;
+			
+			return true;
+		}
+		case EidosTokenType::kTokenAnd:
+		case EidosTokenType::kTokenOr:
+		{
+			// & and | take any number of operands, all of which are evaluated, left to right
+			EidosBytecodeOp logical_op = ((p_node->token_->token_type_ == EidosTokenType::kTokenAnd) ? EidosBytecodeOp::kAnd : EidosBytecodeOp::kOr);
+			
+			if (!_EvaluateScalarNode(children[0], p_result))
+				return false;
+			
+			for (size_t child_index = 1; child_index < children.size(); ++child_index)
+			{
+				EidosBytecodeValue operand;
+				
+				if (!_EvaluateScalarNode(children[child_index], &operand) || !EidosBytecodeValue::ApplyOperator(logical_op, *p_result, operand, p_result))
+					return false;
+			}
+			
+			return true;
+		}
+		case EidosTokenType::kTokenPlus:	op = ((children.size() == 1) ? EidosBytecodeOp::kUnaryPlus : EidosBytecodeOp::kAdd); break;
+		case EidosTokenType::kTokenMinus:	op = ((children.size() == 1) ? EidosBytecodeOp::kNegate : EidosBytecodeOp::kSubtract); break;
+		case EidosTokenType::kTokenMult:	op = EidosBytecodeOp::kMultiply; break;
+		case EidosTokenType::kTokenDiv:		op = EidosBytecodeOp::kDivide; break;
+		case EidosTokenType::kTokenMod:		op = EidosBytecodeOp::kModulo; break;
+		case EidosTokenType::kTokenExp:		op = EidosBytecodeOp::kPower; break;
+		case EidosTokenType::kTokenLt:		op = EidosBytecodeOp::kLess; break;
+		case EidosTokenType::kTokenLtEq:	op = EidosBytecodeOp::kLessOrEqual; break;
+		case EidosTokenType::kTokenGt:		op = EidosBytecodeOp::kGreater; break;
+		case EidosTokenType::kTokenGtEq:	op = EidosBytecodeOp::kGreaterOrEqual; break;
+		case EidosTokenType::kTokenEq:		op = EidosBytecodeOp::kEqual; break;
+		case EidosTokenType::kTokenNotEq:	op = EidosBytecodeOp::kNotEqual; break;
+		case EidosTokenType::kTokenNot:		op = EidosBytecodeOp::kNot; break;
+		default:							return false;
+	}
+	
+	EidosBytecodeValue first_operand, second_operand;
+	
+	if (!_EvaluateScalarNode(children[0], &first_operand))
+		return false;
+	
+	if (children.size() == 2)
+	{
+		if (!_EvaluateScalarNode(children[1], &second_operand))
+			return false;
+	}
+	else
+	{
+		second_operand = first_operand;
+	}
+	
+	return EidosBytecodeValue::ApplyOperator(op, first_operand, second_operand, p_result);
+}
+
 EidosValue_SP EidosInterpreter::Evaluate_Plus(const EidosASTNode *p_node)
 {
+	EidosValue_SP scalar_result_SP;
+	
+	if ((p_node->cached_scalar_expression_ == 2) && _EvaluateScalarRoot(p_node, scalar_result_SP))
+		return scalar_result_SP;
+	
 	EIDOS_ENTRY_EXECUTION_LOG("Evaluate_Plus()");
 	EIDOS_ASSERT_CHILD_RANGE("EidosInterpreter::Evaluate_Plus", 1, 2);
 	
@@ -2436,6 +2564,11 @@ EidosValue_SP EidosInterpreter::Evaluate_Plus(const EidosASTNode *p_node)
 
 EidosValue_SP EidosInterpreter::Evaluate_Minus(const EidosASTNode *p_node)
 {
+	EidosValue_SP scalar_result_SP;
+	
+	if ((p_node->cached_scalar_expression_ == 2) && _EvaluateScalarRoot(p_node, scalar_result_SP))
+		return scalar_result_SP;
+	
 	EIDOS_ENTRY_EXECUTION_LOG("Evaluate_Minus()");
 	EIDOS_ASSERT_CHILD_RANGE("EidosInterpreter::Evaluate_Minus", 1, 2);
 	
@@ -2687,6 +2820,11 @@ EidosValue_SP EidosInterpreter::Evaluate_Minus(const EidosASTNode *p_node)
 
 EidosValue_SP EidosInterpreter::Evaluate_Mod(const EidosASTNode *p_node)
 {
+	EidosValue_SP scalar_result_SP;
+	
+	if ((p_node->cached_scalar_expression_ == 2) && _EvaluateScalarRoot(p_node, scalar_result_SP))
+		return scalar_result_SP;
+	
 	EIDOS_ENTRY_EXECUTION_LOG("Evaluate_Mod()");
 	EIDOS_ASSERT_CHILD_COUNT("EidosInterpreter::Evaluate_Mod", 2);
 
@@ -2820,6 +2958,11 @@ EidosValue_SP EidosInterpreter::Evaluate_Mod(const EidosASTNode *p_node)
 
 EidosValue_SP EidosInterpreter::Evaluate_Mult(const EidosASTNode *p_node)
 {
+	EidosValue_SP scalar_result_SP;
+	
+	if ((p_node->cached_scalar_expression_ == 2) && _EvaluateScalarRoot(p_node, scalar_result_SP))
+		return scalar_result_SP;
+	
 	EIDOS_ENTRY_EXECUTION_LOG("Evaluate_Mult()");
 	EIDOS_ASSERT_CHILD_COUNT("EidosInterpreter::Evaluate_Mult", 2);
 
@@ -3000,6 +3143,11 @@ __attribute__((no_sanitize("integer-divide-by-zero")))
 #endif
 EidosValue_SP EidosInterpreter::Evaluate_Div(const EidosASTNode *p_node)
 {
+	EidosValue_SP scalar_result_SP;
+	
+	if ((p_node->cached_scalar_expression_ == 2) && _EvaluateScalarRoot(p_node, scalar_result_SP))
+		return scalar_result_SP;
+	
 	EIDOS_ENTRY_EXECUTION_LOG("Evaluate_Div()");
 	EIDOS_ASSERT_CHILD_COUNT("EidosInterpreter::Evaluate_Div", 2);
 
@@ -3173,6 +3321,11 @@ EidosValue_SP EidosInterpreter::Evaluate_Conditional(const EidosASTNode *p_node)
 
 EidosValue_SP EidosInterpreter::Evaluate_Exp(const EidosASTNode *p_node)
 {
+	EidosValue_SP scalar_result_SP;
+	
+	if ((p_node->cached_scalar_expression_ == 2) && _EvaluateScalarRoot(p_node, scalar_result_SP))
+		return scalar_result_SP;
+	
 	EIDOS_ENTRY_EXECUTION_LOG("Evaluate_Exp()");
 	EIDOS_ASSERT_CHILD_COUNT("EidosInterpreter::Evaluate_Exp", 2);
 	
@@ -3303,6 +3456,11 @@ EidosValue_SP EidosInterpreter::Evaluate_Exp(const EidosASTNode *p_node)
 
 EidosValue_SP EidosInterpreter::Evaluate_And(const EidosASTNode *p_node)
 {
+	EidosValue_SP scalar_result_SP;
+	
+	if ((p_node->cached_scalar_expression_ == 2) && _EvaluateScalarRoot(p_node, scalar_result_SP))
+		return scalar_result_SP;
+	
 	EIDOS_ENTRY_EXECUTION_LOG("Evaluate_And()");
 	EIDOS_ASSERT_CHILD_COUNT_GTEQ("EidosInterpreter::Evaluate_And", 2);
 	
@@ -3524,6 +3682,11 @@ EidosValue_SP EidosInterpreter::Evaluate_And(const EidosASTNode *p_node)
 
 EidosValue_SP EidosInterpreter::Evaluate_Or(const EidosASTNode *p_node)
 {
+	EidosValue_SP scalar_result_SP;
+	
+	if ((p_node->cached_scalar_expression_ == 2) && _EvaluateScalarRoot(p_node, scalar_result_SP))
+		return scalar_result_SP;
+	
 	EIDOS_ENTRY_EXECUTION_LOG("Evaluate_Or()");
 	EIDOS_ASSERT_CHILD_COUNT_GTEQ("EidosInterpreter::Evaluate_Or", 2);
 	
@@ -3745,6 +3908,11 @@ EidosValue_SP EidosInterpreter::Evaluate_Or(const EidosASTNode *p_node)
 
 EidosValue_SP EidosInterpreter::Evaluate_Not(const EidosASTNode *p_node)
 {
+	EidosValue_SP scalar_result_SP;
+	
+	if ((p_node->cached_scalar_expression_ == 2) && _EvaluateScalarRoot(p_node, scalar_result_SP))
+		return scalar_result_SP;
+	
 	EIDOS_ENTRY_EXECUTION_LOG("Evaluate_Not()");
 	EIDOS_ASSERT_CHILD_COUNT("EidosInterpreter::Evaluate_Not", 1);
 	
@@ -4098,6 +4266,11 @@ EidosValue_SP EidosInterpreter::Evaluate_Assign_R(const EidosASTNode *p_node)
 
 EidosValue_SP EidosInterpreter::Evaluate_Eq(const EidosASTNode *p_node)
 {
+	EidosValue_SP scalar_result_SP;
+	
+	if ((p_node->cached_scalar_expression_ == 2) && _EvaluateScalarRoot(p_node, scalar_result_SP))
+		return scalar_result_SP;
+	
 	EIDOS_ENTRY_EXECUTION_LOG("Evaluate_Eq()");
 	EIDOS_ASSERT_CHILD_COUNT("EidosInterpreter::Evaluate_Eq", 2);
 
@@ -4332,6 +4505,11 @@ EidosValue_SP EidosInterpreter::Evaluate_Eq(const EidosASTNode *p_node)
 
 EidosValue_SP EidosInterpreter::Evaluate_Lt(const EidosASTNode *p_node)
 {
+	EidosValue_SP scalar_result_SP;
+	
+	if ((p_node->cached_scalar_expression_ == 2) && _EvaluateScalarRoot(p_node, scalar_result_SP))
+		return scalar_result_SP;
+	
 	EIDOS_ENTRY_EXECUTION_LOG("Evaluate_Lt()");
 	EIDOS_ASSERT_CHILD_COUNT("EidosInterpreter::Evaluate_Lt", 2);
 
@@ -4476,6 +4654,11 @@ EidosValue_SP EidosInterpreter::Evaluate_Lt(const EidosASTNode *p_node)
 
 EidosValue_SP EidosInterpreter::Evaluate_LtEq(const EidosASTNode *p_node)
 {
+	EidosValue_SP scalar_result_SP;
+	
+	if ((p_node->cached_scalar_expression_ == 2) && _EvaluateScalarRoot(p_node, scalar_result_SP))
+		return scalar_result_SP;
+	
 	EIDOS_ENTRY_EXECUTION_LOG("Evaluate_LtEq()");
 	EIDOS_ASSERT_CHILD_COUNT("EidosInterpreter::Evaluate_LtEq", 2);
 
@@ -4620,6 +4803,11 @@ EidosValue_SP EidosInterpreter::Evaluate_LtEq(const EidosASTNode *p_node)
 
 EidosValue_SP EidosInterpreter::Evaluate_Gt(const EidosASTNode *p_node)
 {
+	EidosValue_SP scalar_result_SP;
+	
+	if ((p_node->cached_scalar_expression_ == 2) && _EvaluateScalarRoot(p_node, scalar_result_SP))
+		return scalar_result_SP;
+	
 	EIDOS_ENTRY_EXECUTION_LOG("Evaluate_Gt()");
 	EIDOS_ASSERT_CHILD_COUNT("EidosInterpreter::Evaluate_Gt", 2);
 
@@ -4764,6 +4952,11 @@ EidosValue_SP EidosInterpreter::Evaluate_Gt(const EidosASTNode *p_node)
 
 EidosValue_SP EidosInterpreter::Evaluate_GtEq(const EidosASTNode *p_node)
 {
+	EidosValue_SP scalar_result_SP;
+	
+	if ((p_node->cached_scalar_expression_ == 2) && _EvaluateScalarRoot(p_node, scalar_result_SP))
+		return scalar_result_SP;
+	
 	EIDOS_ENTRY_EXECUTION_LOG("Evaluate_GtEq()");
 	EIDOS_ASSERT_CHILD_COUNT("EidosInterpreter::Evaluate_GtEq", 2);
 
@@ -4908,6 +5101,11 @@ EidosValue_SP EidosInterpreter::Evaluate_GtEq(const EidosASTNode *p_node)
 
 EidosValue_SP EidosInterpreter::Evaluate_NotEq(const EidosASTNode *p_node)
 {
+	EidosValue_SP scalar_result_SP;
+	
+	if ((p_node->cached_scalar_expression_ == 2) && _EvaluateScalarRoot(p_node, scalar_result_SP))
+		return scalar_result_SP;
+	
 	EIDOS_ENTRY_EXECUTION_LOG("Evaluate_NotEq()");
 	EIDOS_ASSERT_CHILD_COUNT("EidosInterpreter::Evaluate_NotEq", 2);
 
@@ -37,6 +37,7 @@
 #include "eidos_functions.h"
 #include "eidos_symbol_table.h"
 #include "eidos_ast_node.h"
+#include "eidos_bytecode.h"
 
 class EidosCallSignature;
 
@@ -277,6 +278,11 @@ public:
 	void NullReturnRaiseForNode(const EidosASTNode *p_node);
 	EidosValue_SP EvaluateNode(const EidosASTNode *p_node);
 	
+	// Unboxed evaluation of singleton arithmetic, for operator subtrees marked by EidosASTNode::_OptimizeScalarExpressions();
+	// the operator evaluators try this first on root nodes, and proceed with boxed evaluation only if it returns false
+	bool _EvaluateScalarRoot(const EidosASTNode *p_node, EidosValue_SP &p_result);
+	bool _EvaluateScalarNode(const EidosASTNode *p_node, EidosBytecodeValue *p_result);
+	
 	EidosValue_SP Evaluate_NullStatement(const EidosASTNode *p_node);
 	EidosValue_SP Evaluate_CompoundStatement(const EidosASTNode *p_node);
 	EidosValue_SP Evaluate_RangeExpr(const EidosASTNode *p_node);
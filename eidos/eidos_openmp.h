@@ -308,6 +308,8 @@ private:
 #define EIDOS_OMPMIN_I_COUNT_OF_MUTS_OF_TYPE	2
 #define EIDOS_OMPMIN_G_COUNT_OF_MUTS_OF_TYPE	2
 #define EIDOS_OMPMIN_INDS_W_PEDIGREE_IDS	2000
+#define EIDOS_OMPMIN_POPGEN_STATS			2000
+#define EIDOS_OMPMIN_KDTREE_BUILD			20000
 #define EIDOS_OMPMIN_RELATEDNESS			2000
 #define EIDOS_OMPMIN_SAMPLE_INDIVIDUALS_1	2000
 #define EIDOS_OMPMIN_SAMPLE_INDIVIDUALS_2	2000
@@ -390,6 +392,8 @@ private:
 #define EIDOS_OMPMIN_SIMPLIFY_SORT_PRE		4000
 #define EIDOS_OMPMIN_SIMPLIFY_SORT			4000
 #define EIDOS_OMPMIN_SIMPLIFY_SORT_POST		4000
+#define EIDOS_OMPMIN_SIMPLIFY_CHROMOSOMES	2
+#define EIDOS_OMPMIN_TREESEQ_OUTPUT			2
 #define EIDOS_OMPMIN_SURVIVAL				10000
 
 #else
@@ -446,6 +450,8 @@ private:
 #define EIDOS_OMPMIN_I_COUNT_OF_MUTS_OF_TYPE	0
 #define EIDOS_OMPMIN_G_COUNT_OF_MUTS_OF_TYPE	0
 #define EIDOS_OMPMIN_INDS_W_PEDIGREE_IDS	0
+#define EIDOS_OMPMIN_POPGEN_STATS			0
+#define EIDOS_OMPMIN_KDTREE_BUILD			0
 #define EIDOS_OMPMIN_RELATEDNESS			0
 #define EIDOS_OMPMIN_SAMPLE_INDIVIDUALS_1	0
 #define EIDOS_OMPMIN_SAMPLE_INDIVIDUALS_2	0
@@ -528,6 +534,8 @@ private:
 #define EIDOS_OMPMIN_SIMPLIFY_SORT_PRE		0
 #define EIDOS_OMPMIN_SIMPLIFY_SORT			0
 #define EIDOS_OMPMIN_SIMPLIFY_SORT_POST		0
+#define EIDOS_OMPMIN_SIMPLIFY_CHROMOSOMES	0
+#define EIDOS_OMPMIN_TREESEQ_OUTPUT			0
 #define EIDOS_OMPMIN_SURVIVAL				0
 
 #endif
@@ -585,6 +593,8 @@ extern int gEidos_OMP_threads_CONTAINS_MARKER_MUT;
 extern int gEidos_OMP_threads_I_COUNT_OF_MUTS_OF_TYPE;
 extern int gEidos_OMP_threads_G_COUNT_OF_MUTS_OF_TYPE;
 extern int gEidos_OMP_threads_INDS_W_PEDIGREE_IDS;
+extern int gEidos_OMP_threads_POPGEN_STATS;
+extern int gEidos_OMP_threads_KDTREE_BUILD;
 extern int gEidos_OMP_threads_RELATEDNESS;
 extern int gEidos_OMP_threads_SAMPLE_INDIVIDUALS_1;
 extern int gEidos_OMP_threads_SAMPLE_INDIVIDUALS_2;
@@ -667,6 +677,8 @@ extern int gEidos_OMP_threads_MIGRANT_CLEAR;
 extern int gEidos_OMP_threads_SIMPLIFY_SORT_PRE;
 extern int gEidos_OMP_threads_SIMPLIFY_SORT;
 extern int gEidos_OMP_threads_SIMPLIFY_SORT_POST;
+extern int gEidos_OMP_threads_SIMPLIFY_CHROMOSOMES;
+extern int gEidos_OMP_threads_TREESEQ_OUTPUT;
 extern int gEidos_OMP_threads_PARENTS_CLEAR;
 extern int gEidos_OMP_threads_UNIQUE_MUTRUNS;
 extern int gEidos_OMP_threads_SURVIVAL;
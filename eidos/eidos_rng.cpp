@@ -317,38 +317,106 @@ double Eidos_FastRandomPoisson_PRECALCULATE(double p_mu)
 #endif
 
 
+// EidosAliasTable
 
+EidosAliasTable::~EidosAliasTable(void)
+{
+	free(entries_);
+	entries_ = nullptr;
+	
+	free(worklist_);
+	worklist_ = nullptr;
+}
 
+bool EidosAliasTable::Build(const double *p_weights, uint32_t p_count)
+{
+	size_ = 0;
+	
+	if (p_count == 0)
+		return false;
+	
+	double total_weight = 0.0;
+	
+	for (uint32_t index = 0; index < p_count; ++index)
+		total_weight += p_weights[index];
+	
+	if (!(total_weight > 0.0) || !std::isfinite(total_weight))
+		return false;
+	
+	if (p_count > capacity_)
+	{
+		entries_ = (EidosAliasEntry *)realloc(entries_, p_count * sizeof(EidosAliasEntry));
+		worklist_ = (uint32_t *)realloc(worklist_, p_count * sizeof(uint32_t));
+		
+		if (!entries_ || !worklist_)
+			EIDOS_TERMINATION << "ERROR (EidosAliasTable::Build): allocation failed; you may need to raise the memory limit for SLiM." << EidosTerminate(nullptr);
+		
+		capacity_ = p_count;
+	}
+	
+	// Scale the weights so that they average 1.0, keeping them in the threshold_ fields while we work.  Entries below 1.0
+	// ("small") and at or above it ("large") go on two stacks that share worklist_, smalls growing up from the bottom and
+	// larges growing down from the top; since every index is on at most one stack, they never collide.
+	double scale = p_count / total_weight;
+	uint32_t small_count = 0, large_start = p_count;
+	
+	for (uint32_t index = 0; index < p_count; ++index)
+	{
+		double scaled = p_weights[index] * scale;
+		
+		entries_[index].threshold_ = scaled;
+		entries_[index].alias_ = index;
+		
+		if (scaled < 1.0)
+			worklist_[small_count++] = index;
+		else
+			worklist_[--large_start] = index;
+	}
+	
+	// Vose's algorithm: each small entry is topped up to 1.0 by aliasing it to a large entry, which gives up the difference
+	// and may then become small itself
+	while ((small_count > 0) && (large_start < p_count))
+	{
+		uint32_t small = worklist_[--small_count];
+		uint32_t large = worklist_[large_start++];
+		
+		entries_[small].alias_ = large;
+		
+		double remainder = (entries_[large].threshold_ + entries_[small].threshold_) - 1.0;
+		
+		entries_[large].threshold_ = remainder;
+		
+		if (remainder < 1.0)
+			worklist_[small_count++] = large;
+		else
+			worklist_[--large_start] = large;
+	}
+	
+	// Whatever remains on either stack is 1.0 up to rounding error, and always returns its own index
+	while (large_start < p_count)
+		entries_[worklist_[large_start++]].threshold_ = 1.0;
+	
+	while (small_count > 0)
+		entries_[worklist_[--small_count]].threshold_ = 1.0;
+	
+	size_ = p_count;
+	return true;
+}
 
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
+double EidosAliasTable::_ProbabilityOfIndex(uint32_t p_index) const
+{
+	double probability = 0.0;
+	
+	for (uint32_t index = 0; index < size_; ++index)
+	{
+		const EidosAliasEntry &entry = entries_[index];
+		
+		if (index == p_index)
+			probability += entry.threshold_;
+		if (entry.alias_ == p_index)
+			probability += (1.0 - entry.threshold_);
+	}
+	
+	return probability / size_;
+}
 
@@ -481,6 +481,65 @@ inline __attribute__((always_inline)) bool Eidos_RandomBool(Eidos_RNG_State *rng
 }
 
 
+#pragma mark -
+#pragma mark Weighted discrete draws
+#pragma mark -
+
+// EidosAliasTable is a Walker alias table for drawing indices 0..K-1 in proportion to a vector of weights, as with
+// gsl_ran_discrete(), but without going through the GSL.  It is built with Vose's linear-time construction, and keeps
+// each entry's threshold and alias together so that a draw is one 64-bit RNG call and one table lookup.  Building does
+// not touch any RNG, and drawing only reads the table, so a built table can be shared by threads that each supply their
+// own RNG.  The buffers are reused across rebuilds, so a table that is rebuilt every tick does not reallocate.
+class EidosAliasTable
+{
+	//	This class has its copy constructor and assignment operator disabled, to prevent accidental copying.
+	
+	typedef struct {
+		double threshold_;			// the probability of returning this entry's own index, rather than alias_
+		uint32_t alias_;			// the index returned otherwise
+	} EidosAliasEntry;
+	
+	EidosAliasEntry *entries_ = nullptr;	// OWNED POINTER
+	uint32_t *worklist_ = nullptr;			// OWNED POINTER: scratch space for Build()
+	uint32_t size_ = 0;						// the number of entries; 0 if the table is empty (not built)
+	uint32_t capacity_ = 0;					// the capacity of entries_ and worklist_
+	
+public:
+	
+	EidosAliasTable(const EidosAliasTable&) = delete;					// no copying
+	EidosAliasTable& operator=(const EidosAliasTable&) = delete;		// no copying
+	EidosAliasTable(void) = default;
+	~EidosAliasTable(void);
+	
+	// Build the table for p_count weights, which must be non-negative; the table is left empty, and false is returned,
+	// if the total weight is not positive and finite
+	bool Build(const double *p_weights, uint32_t p_count);
+	void Clear(void) { size_ = 0; }
+	
+	inline __attribute__((always_inline)) bool IsEmpty(void) const { return (size_ == 0); }
+	inline __attribute__((always_inline)) uint32_t Size(void) const { return size_; }
+	inline size_t MemoryUsage(void) const { return capacity_ * (sizeof(EidosAliasEntry) + sizeof(uint32_t)); }
+	
+	// Draw an index; the integer part of u*K picks an entry and the fractional part decides between it and its alias
+	inline __attribute__((always_inline)) uint32_t Draw(EidosRNG_64_bit &rng_64) const
+	{
+#if DEBUG
+		if (size_ == 0)
+			EIDOS_TERMINATION << "ERROR (EidosAliasTable::Draw): (internal error) draw from an empty table." << EidosTerminate(nullptr);
+#endif
+		
+		double u = Eidos_rng_uniform_doubleCO(rng_64) * size_;
+		uint32_t index = (uint32_t)u;
+		const EidosAliasEntry &entry = entries_[index];
+		
+		return ((u - index) < entry.threshold_) ? index : entry.alias_;
+	}
+	
+	// The probability with which Draw() returns p_index; this sums over all entries, so it is for testing only
+	double _ProbabilityOfIndex(uint32_t p_index) const;
+};
+
+
 #endif /* defined(__Eidos__eidos_rng__) */
 
 
@@ -715,6 +715,119 @@ inline double product_float64(const double *input, int64_t count)
     return prod;
 }
 
+// ---------------------
+// Intersection popcount: sum(popcount(a & b)) over packed 64-bit words
+// ---------------------
+// Used by the bitset LD engine behind calcLD_D() / calcLD_Rsquared() in SLiM.
+// The AVX2 path uses the nibble-lookup (vpshufb) popcount with vpsadbw accumulation.
+inline int64_t popcount_and_uint64(const uint64_t *a, const uint64_t *b, int64_t count)
+{
+    int64_t total = 0;
+    int64_t i = 0;
+
+#if defined(EIDOS_HAS_AVX2)
+    const __m256i lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                            0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i low_mask = _mm256_set1_epi8(0x0f);
+    __m256i vacc = _mm256_setzero_si256();
+    for (; i + 4 <= count; i += 4)
+    {
+        __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(&a[i]));
+        __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(&b[i]));
+        __m256i v = _mm256_and_si256(va, vb);
+        __m256i lo = _mm256_and_si256(v, low_mask);
+        __m256i hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), low_mask);
+        __m256i cnt = _mm256_add_epi8(_mm256_shuffle_epi8(lookup, lo), _mm256_shuffle_epi8(lookup, hi));
+        vacc = _mm256_add_epi64(vacc, _mm256_sad_epu8(cnt, _mm256_setzero_si256()));
+    }
+    // Horizontal sum of 4 uint64 lanes
+    total += _mm256_extract_epi64(vacc, 0) + _mm256_extract_epi64(vacc, 1) +
+             _mm256_extract_epi64(vacc, 2) + _mm256_extract_epi64(vacc, 3);
+#elif defined(EIDOS_HAS_NEON)
+    uint64x2_t vacc = vdupq_n_u64(0);
+    for (; i + 2 <= count; i += 2)
+    {
+        uint8x16_t v = vreinterpretq_u8_u64(vandq_u64(vld1q_u64(&a[i]), vld1q_u64(&b[i])));
+        uint8x16_t cnt = vcntq_u8(v);
+        vacc = vaddq_u64(vacc, vpaddlq_u32(vpaddlq_u16(vpaddlq_u8(cnt))));
+    }
+    total += (int64_t)vaddvq_u64(vacc);
+#endif
+
+    // Scalar remainder (SSE4.2 builds get the POPCNT instruction here)
+    for (; i < count; i++)
+        total += __builtin_popcountll(a[i] & b[i]);
+
+    return total;
+}
+
+// ---------------------
+// Gathered products of float factors: product(base[indices]) in double precision
+// ---------------------
+// Used by fitness calculation in SLiM, where the factors are the cached (1+s) / (1+hs) values of mutations, which
+// are floats.  Factors are multiplied in double precision in four lanes (element i goes to lane i % 4 in every build,
+// so all builds give identical results), and every 64 elements the lanes are folded into a mantissa/exponent pair
+// with frexp(), so that a long product of small factors does not underflow, or crawl through denormals, part way.
+#define EIDOS_PRODUCT_BLOCK_SIZE 64
+
+inline void _fold_product_block(double p_block, double &p_mantissa, int &p_exponent)
+{
+    int block_exponent;
+
+    p_mantissa = std::frexp(p_mantissa * p_block, &block_exponent);
+    p_exponent += block_exponent;
+}
+
+// The factors are the floats at base + indices[i] * stride_bytes; in SLiM, base is a field of the first Mutation in
+// the mutation block, stride_bytes is sizeof(Mutation), and the indices are the MutationIndex values of a haplosome.
+// The AVX2 path uses 64-bit gathers, so the offsets cannot overflow however large the mutation block grows.
+inline double gather_product_float32(const float *base, int64_t stride_bytes, const int32_t *indices, int64_t count)
+{
+    double mantissa = 1.0;
+    int exponent = 0;
+    int64_t i = 0;
+    int64_t lane_count = count & ~(int64_t)3;
+
+    while (i < lane_count)
+    {
+        int64_t block_end = (lane_count - i > EIDOS_PRODUCT_BLOCK_SIZE) ? i + EIDOS_PRODUCT_BLOCK_SIZE : lane_count;
+
+#if defined(EIDOS_HAS_AVX2)
+        const __m256i vstride = _mm256_set1_epi64x(stride_bytes);
+        __m256d vprod = _mm256_set1_pd(1.0);
+        for (; i < block_end; i += 4)
+        {
+            __m256i vindex = _mm256_cvtepi32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i *>(&indices[i])));
+            __m128 v = _mm256_i64gather_ps(base, _mm256_mul_epi32(vindex, vstride), 1);
+            vprod = _mm256_mul_pd(vprod, _mm256_cvtps_pd(v));
+        }
+
+        // Fold the lanes as (l0 * l2) * (l1 * l3)
+        __m128d vlow  = _mm256_castpd256_pd128(vprod);
+        __m128d vhigh = _mm256_extractf128_pd(vprod, 1);
+        vlow = _mm_mul_pd(vlow, vhigh);
+        vlow = _mm_mul_sd(vlow, _mm_shuffle_pd(vlow, vlow, 1));
+        _fold_product_block(_mm_cvtsd_f64(vlow), mantissa, exponent);
+#else
+        const char *base_bytes = reinterpret_cast<const char *>(base);
+        double l0 = 1.0, l1 = 1.0, l2 = 1.0, l3 = 1.0;
+        for (; i < block_end; i += 4)
+        {
+            l0 *= (double)*reinterpret_cast<const float *>(base_bytes + indices[i] * stride_bytes);
+            l1 *= (double)*reinterpret_cast<const float *>(base_bytes + indices[i + 1] * stride_bytes);
+            l2 *= (double)*reinterpret_cast<const float *>(base_bytes + indices[i + 2] * stride_bytes);
+            l3 *= (double)*reinterpret_cast<const float *>(base_bytes + indices[i + 3] * stride_bytes);
+        }
+        _fold_product_block((l0 * l2) * (l1 * l3), mantissa, exponent);
+#endif
+    }
+
+    for (; i < count; i++)
+        mantissa *= (double)*reinterpret_cast<const float *>(reinterpret_cast<const char *>(base) + indices[i] * stride_bytes);
+
+    return std::ldexp(mantissa, exponent);
+}
+
 // ================================
 // Float (Single-Precision) SIMD Operations
 // ================================
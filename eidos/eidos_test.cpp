@@ -35,6 +35,7 @@
 #include <random>
 #include <ctime>
 #include <algorithm>
+#include <cmath>
 
 #if 0
 // includes for the timing code in RunEidosTests(), which is normally #if 0
@@ -320,6 +321,7 @@ int RunEidosTests(void)
 	
 	// Run tests
 	_RunFloatOutputTests();
+	_RunAliasTableTests();
 	_RunInternalFilesystemTests();
 	_RunLiteralsIdentifiersAndTokenizationTests();
 	_RunSymbolsAndVariablesTests();
@@ -347,6 +349,7 @@ int RunEidosTests(void)
 	_RunOperatorLogicalOrTests();
 	_RunOperatorLogicalNotTests();
 	_RunOperatorTernaryConditionalTests();
+	_RunOperatorScalarEvaluationTests();
 	_RunKeywordIfTests();
 	_RunKeywordDoTests();
 	_RunKeywordWhileTests();
@@ -1497,6 +1500,90 @@ void _RunFloatOutputTests(void)
 	_TestFloatOutput(125604.390423, "125604.4");	// this was the value for which I noticed the bug; it was output as "125604.0", whoops!
 }
 
+#pragma mark alias table tests
+static void _TestAliasTable(const std::vector<double> &weights, const char *label)
+{
+	// the exact probability of drawing each index should match its share of the total weight
+	EidosAliasTable table;
+	double total = 0.0;
+	
+	for (double weight : weights)
+		total += weight;
+	
+	if (!table.Build(weights.data(), (uint32_t)weights.size()) || (table.Size() != weights.size()))
+	{
+		gEidosTestFailureCount++;
+		std::cerr << "EidosAliasTable " << label << " : " << EIDOS_OUTPUT_FAILURE_TAG << " : Build() failed" << std::endl;
+		return;
+	}
+	
+	for (uint32_t index = 0; index < weights.size(); ++index)
+	{
+		double probability = table._ProbabilityOfIndex(index);
+		
+		if (std::fabs(probability - weights[index] / total) < 1e-12)
+			gEidosTestSuccessCount++;
+		else
+		{
+			gEidosTestFailureCount++;
+			std::cerr << "EidosAliasTable " << label << " : " << EIDOS_OUTPUT_FAILURE_TAG << " : probability of index " << index << " is " << probability << " (" << (weights[index] / total) << " expected)" << std::endl;
+		}
+	}
+	
+	// indices with zero weight must never be drawn, and every draw must be in range
+	EidosRNG_64_bit rng_64;
+	bool bad_draw = false;
+	
+	rng_64.seed(10);
+	
+	for (int draw = 0; draw < 10000; ++draw)
+	{
+		uint32_t index = table.Draw(rng_64);
+		
+		if ((index >= weights.size()) || (weights[index] == 0.0))
+			bad_draw = true;
+	}
+	
+	if (!bad_draw)
+		gEidosTestSuccessCount++;
+	else
+	{
+		gEidosTestFailureCount++;
+		std::cerr << "EidosAliasTable " << label << " : " << EIDOS_OUTPUT_FAILURE_TAG << " : drew an index with zero weight" << std::endl;
+	}
+}
+
+void _RunAliasTableTests(void)
+{
+	_TestAliasTable({1.0}, "single");
+	_TestAliasTable({1.0, 1.0, 1.0, 1.0}, "uniform");
+	_TestAliasTable({0.0, 1.0, 3.0, 0.0, 4.0}, "zeros");
+	_TestAliasTable({1e-9, 1.0, 1e6, 0.5, 0.5, 2.0, 0.0}, "skewed");
+	
+	{
+		std::vector<double> weights;
+		
+		for (int index = 0; index < 1000; ++index)
+			weights.emplace_back(1.0 + (index % 7) * 0.1);
+		
+		_TestAliasTable(weights, "large");
+	}
+	
+	// a table cannot be built from an empty or all-zero weight vector, and a rebuild replaces the previous table
+	EidosAliasTable table;
+	double zero_weights[3] = {0.0, 0.0, 0.0};
+	double weights[2] = {1.0, 3.0};
+	
+	if (!table.Build(zero_weights, 0) && table.IsEmpty() && table.Build(weights, 2) && !table.Build(zero_weights, 3) && table.IsEmpty() &&
+		table.Build(weights, 2) && (table.Size() == 2) && (std::fabs(table._ProbabilityOfIndex(1) - 0.75) < 1e-12))
+		gEidosTestSuccessCount++;
+	else
+	{
+		gEidosTestFailureCount++;
+		std::cerr << "EidosAliasTable rebuild : " << EIDOS_OUTPUT_FAILURE_TAG << " : incorrect result" << std::endl;
+	}
+}
+
 #pragma mark internal filesystem tests
 void _RunInternalFilesystemTests(void)
 {
@@ -75,6 +75,7 @@ extern void EidosAssertScriptRaise(const std::string &p_script_string, const int
 
 // Test subfunction prototypes
 extern void _RunFloatOutputTests(void);
+extern void _RunAliasTableTests(void);
 extern void _RunInternalFilesystemTests(void);
 extern void _RunLiteralsIdentifiersAndTokenizationTests(void);
 extern void _RunSymbolsAndVariablesTests(void);
@@ -102,6 +103,7 @@ extern void _RunOperatorLogicalAndTests(void);
 extern void _RunOperatorLogicalOrTests(void);
 extern void _RunOperatorLogicalNotTests(void);
 extern void _RunOperatorTernaryConditionalTests(void);
+extern void _RunOperatorScalarEvaluationTests(void);
 extern void _RunKeywordIfTests(void);
 extern void _RunKeywordDoTests(void);
 extern void _RunKeywordWhileTests(void);
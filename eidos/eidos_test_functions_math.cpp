@@ -1530,6 +1530,47 @@ void _RunSIMDMathTests(void)
 			std::cerr << EIDOS_OUTPUT_FAILURE_TAG << " : SIMD pow_scalar_base() test failed" << std::endl;
 		}
 	}
+	
+	// Test popcount_and_uint64 (bitset intersection counts), across lengths that exercise the vector and remainder paths
+	{
+		std::vector<uint64_t> bits_a(37), bits_b(37);
+		uint64_t state = 0x9E3779B97F4A7C15ULL;
+		
+		for (int i = 0; i < 37; i++)
+		{
+			state ^= state << 13; state ^= state >> 7; state ^= state << 17;
+			bits_a[i] = state;
+			state ^= state << 13; state ^= state >> 7; state ^= state << 17;
+			bits_b[i] = state;
+		}
+		bits_a[3] = ~(uint64_t)0;
+		bits_b[3] = ~(uint64_t)0;
+		
+		bool all_match = true;
+		for (int64_t len = 0; len <= 37; len++)
+		{
+			int64_t scalar_count = 0;
+			
+			for (int64_t i = 0; i < len; i++)
+				scalar_count += __builtin_popcountll(bits_a[i] & bits_b[i]);
+			
+			int64_t simd_count = Eidos_SIMD::popcount_and_uint64(bits_a.data(), bits_b.data(), len);
+			
+			if (simd_count != scalar_count)
+			{
+				all_match = false;
+				std::cerr << "SIMD popcount_and mismatch at length " << len << ": scalar=" << scalar_count << ", simd=" << simd_count << std::endl;
+			}
+		}
+		
+		if (all_match)
+			gEidosTestSuccessCount++;
+		else
+		{
+			gEidosTestFailureCount++;
+			std::cerr << EIDOS_OUTPUT_FAILURE_TAG << " : SIMD popcount_and_uint64() test failed" << std::endl;
+		}
+	}
 }
 
 
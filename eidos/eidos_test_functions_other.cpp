@@ -445,6 +445,18 @@ void _RunFunctionFilesystemTests(const std::string &temp_path)
 	EidosAssertScriptSuccess_L("fileExists('" + temp_path + "/EidosTest.txt.gz');", true);
 	EidosAssertScriptSuccess_L("file = writeTempFile('eidos_test_', '.txt', 'foo'); fileExists(file);", true);
 	
+	// compressed appends go through a persistent gzip stream for each file, which flushFile(), deleteFile(), and non-append writes close
+	EidosAssertScriptSuccess_L("path = '" + temp_path + "/EidosTestAppend.txt.gz'; writeFile(path, 'a', compress=T); for (i in 1:100) writeFile(path, paste(i), append=T, compress=T); flushFile(path); writeFile(path, 'b', append=T, compress=T); writeFile(path, 'c', compress=T); writeFile(path, 'd', append=T, compress=T); deleteFile(path) & !fileExists(path);", true);
+	
+	// asynchronous file writing; writes are performed by a background thread, and readers wait for pending writes to complete
+	Eidos_SetAsyncFileWriting(true);
+	EidosAssertScriptSuccess_L("path = '" + temp_path + "/EidosTestAsync.txt'; for (i in 1:50) writeFile(path, paste(i), append=(i > 1)); x = readFile(path); deleteFile(path); identical(x, asString(1:50));", true);
+	EidosAssertScriptSuccess_L("path = '" + temp_path + "/EidosTestAsync.txt.gz'; writeFile(path, 'a', compress=T); for (i in 1:100) writeFile(path, paste(i), append=T, compress=T); flushFile(path); fileExists(path) & deleteFile(path);", true);
+	std::string async_error_script = "path = '" + temp_path + "/EidosTestNoSuchDirectory/EidosTest.txt'; writeFile(path, 'a'); ";
+	EidosAssertScriptRaise(async_error_script + "flushFile(path);", (int)async_error_script.length(), "could not write to file");
+	EidosAssertScriptSuccess_L("path = '" + temp_path + "/EidosTestAsync.txt'; writeFile(path, 'a'); fileExists(path) & deleteFile(path);", true);
+	Eidos_SetAsyncFileWriting(false);
+	
 	// createDirectory() – we rely on writeTempFile() to give us a file path that isn't in use, from which we derive a directory path that also shouldn't be in use
 	EidosAssertScriptSuccess_L("file = writeTempFile('eidos_test_dir', '.txt', ''); dir = substr(file, 0, nchar(file) - 5); createDirectory(dir);", true);
 	
@@ -815,3 +815,20 @@ void _RunOperatorExpTests(void)
 
 
 
+
+#pragma mark unboxed singleton evaluation
+void _RunOperatorScalarEvaluationTests(void)
+{
+	// operator subtrees with singleton operands are evaluated unboxed, falling back to boxed evaluation for everything else; see EidosInterpreter::_EvaluateScalarRoot()
+	EidosAssertScriptSuccess_F("x = 3; y = 2.5; (x * y + 1) / 2 - x;", 1.25);
+	EidosAssertScriptSuccess_L("x = 3; y = 4; -(x * y - 2) % 7 + x ^ 2 == 6.0;", true);
+	EidosAssertScriptSuccess_L("x = 5; y = 0.0; (x > 3) & !y & (x != 4) | F;", true);
+	EidosAssertScriptSuccess_I("t = _Test(7); t._yolk * 2 + 1;", 15);
+	EidosAssertScriptSuccess_L("m = matrix(5); identical(m * 2 + 1, matrix(11));", true);
+	EidosAssertScriptSuccess_I("s = 0; for (i in 1:20) { x = (i % 2 == 0) ? 1 else 1:3; s = s + sum(x * 2 + 1); } s;", 180);
+	EidosAssertScriptRaise("x = NAN; T & x;", 11, "cannot be converted");
+	EidosAssertScriptRaise("x = 'foo'; y = 2; (y + 1) * x;", 26, "is not supported by");
+#if EIDOS_HAS_OVERFLOW_BUILTINS
+	EidosAssertScriptRaise("x = 5e18; (x * 2) + 1;", 13, "multiplication overflow");
+#endif
+}